@@ -0,0 +1,15 @@
+
+FetchContent_Declare(
+    benchmark
+    GIT_REPOSITORY "https://github.com/google/benchmark.git"
+    GIT_TAG d572f4777349d43653b21d6c2fc63020ab326db2 # v1.7.1
+    GIT_PROGRESS TRUE
+    FETCHCONTENT_UPDATES_DISCONNECTED
+)
+set(BENCHMARK_ENABLE_TESTING OFF CACHE BOOL "" FORCE)
+set(BENCHMARK_ENABLE_GTEST_TESTS OFF CACHE BOOL "" FORCE)
+set(BENCHMARK_ENABLE_INSTALL OFF CACHE BOOL "" FORCE)
+FetchContent_MakeAvailable(benchmark)
+set(folder "${DST_IDE_FOLDER}/external/benchmark/")
+set_target_properties(benchmark PROPERTIES FOLDER "${folder}")
+set_target_properties(benchmark_main PROPERTIES FOLDER "${folder}")
@@ -116,3 +116,27 @@ macro(dst_add_target_test)
         endif()
     endif()
 endmacro()
+
+macro(dst_add_target_benchmark)
+    cmake_parse_arguments(args "" "target;folder" "linkLibraries;includeDirectories;includeFiles;sourceFiles;compileDefinitions" ${ARGN})
+    if(DST_BUILD_BENCHMARKS)
+        dst_add_executable(
+            target ${args_target}.benchmark
+            folder "benchmarks/"
+            linkLibraries ${args_target} "${args_linkLibraries}" benchmark_main
+            includeDirectories "${args_includeDirectories}"
+            includeFiles "${args_includeFiles}"
+            sourceFiles "${args_sourceFiles}"
+        )
+        set(results "${CMAKE_BINARY_DIR}/benchmark-results/")
+        add_custom_target(
+            ${args_target}.benchmark.run
+            COMMAND ${CMAKE_COMMAND} -E make_directory "${results}"
+            COMMAND ${args_target}.benchmark "--benchmark_out=${results}${args_target}.json" --benchmark_out_format=json
+            DEPENDS ${args_target}.benchmark
+            USES_TERMINAL
+            VERBATIM
+        )
+        set_target_properties(${args_target}.benchmark.run PROPERTIES FOLDER "${DST_IDE_FOLDER}/benchmarks/")
+    endif()
+endmacro()
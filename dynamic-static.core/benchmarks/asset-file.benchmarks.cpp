@@ -0,0 +1,109 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#include "dynamic-static/asset-file.hpp"
+
+#include "benchmark/benchmark.h"
+
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace dst {
+namespace benchmarks {
+
+// Compares mapping an AssetFile against reading the same file into memory.
+//  Each iteration opens the file and touches one byte per 4KB page of a 64MB
+//  Section.  The file stays in the OS page cache between iterations so this
+//  measures the per load overhead of each approach rather than disk bandwidth.
+static const uint32_t DataSection { make_fourcc('D', 'A', 'T', 'A') };
+static constexpr size_t DataSize { 64 * 1024 * 1024 };
+static constexpr size_t PageSize { 4096 };
+
+struct BenchmarkFile final
+{
+    // Writes the benchmark file on first use and removes it at exit.
+    BenchmarkFile()
+    {
+        std::vector<uint8_t> data(DataSize, 1);
+        AssetFileWriter writer;
+        writer.add_section<uint8_t>(DataSection, 0, data);
+        writer.write(filePath);
+    }
+
+    ~BenchmarkFile()
+    {
+        std::filesystem::remove(filePath);
+    }
+
+    std::filesystem::path filePath { std::filesystem::temp_directory_path() / "dynamic-static.asset-file.benchmarks.dsta" };
+};
+
+static const std::filesystem::path& get_benchmark_file_path()
+{
+    static const BenchmarkFile sBenchmarkFile;
+    return sBenchmarkFile.filePath;
+}
+
+static void AssetFile_map(benchmark::State& state)
+{
+    AssetFile::CreateInfo assetFileCreateInfo { };
+    assetFileCreateInfo.filePath = get_benchmark_file_path();
+    assetFileCreateInfo.prefetch = state.range(0);
+    for (auto _ : state) {
+        AssetFile assetFile;
+        AssetFile::create(&assetFileCreateInfo, &assetFile);
+        auto data = assetFile.get_section_data<uint8_t>(DataSection);
+        size_t sum = 0;
+        for (size_t i = 0; i < data.size(); i += PageSize) {
+            sum += data[i];
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetBytesProcessed(state.iterations() * DataSize);
+}
+BENCHMARK(AssetFile_map)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+static void AssetFile_read(benchmark::State& state)
+{
+    const auto& filePath = get_benchmark_file_path();
+    for (auto _ : state) {
+        std::ifstream file(filePath, std::ios::binary);
+        std::vector<uint8_t> data(std::filesystem::file_size(filePath));
+        file.read((char*)data.data(), (std::streamsize)data.size());
+        AssetFile::validate(data);
+        size_t sum = 0;
+        for (size_t i = 0; i < data.size(); i += PageSize) {
+            sum += data[i];
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetBytesProcessed(state.iterations() * DataSize);
+}
+BENCHMARK(AssetFile_read)->Unit(benchmark::kMillisecond);
+
+} // namespace benchmarks
+} // namespace dst
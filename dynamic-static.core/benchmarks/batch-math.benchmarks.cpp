@@ -0,0 +1,213 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#include "dynamic-static/batch-math.hpp"
+
+#include "benchmark/benchmark.h"
+
+#include <array>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace dst {
+namespace benchmarks {
+
+// Each benchmark takes { count, InstructionSet } and is skipped when the
+//  InstructionSet isn't supported.
+struct Streams final
+{
+    Streams(size_t count)
+    {
+        std::mt19937 rng(0);
+        std::uniform_real_distribution<float> distribution(-1, 1);
+        for (auto& stream : floats) {
+            stream.resize(count);
+            for (auto& value : stream) {
+                value = distribution(rng) * 100;
+            }
+        }
+        for (size_t i = 0; i < count; ++i) {
+            // floats[6..9] are used as rotations and floats[3..5] as extents.
+            auto x = floats[6][i], y = floats[7][i], z = floats[8][i], w = floats[9][i];
+            auto length = std::sqrt(x * x + y * y + z * z + w * w);
+            floats[6][i] /= length;
+            floats[7][i] /= length;
+            floats[8][i] /= length;
+            floats[9][i] /= length;
+            floats[3][i] = floats[0][i] + std::abs(floats[3][i]) * 0.1f;
+            floats[4][i] = floats[1][i] + std::abs(floats[4][i]) * 0.1f;
+            floats[5][i] = floats[2][i] + std::abs(floats[5][i]) * 0.1f;
+            floats[10][i] = std::abs(floats[10][i]) * 0.1f;
+        }
+        matrices.resize(count * 16);
+        visible.resize(count);
+    }
+
+    batch::Vector3Soa<float> get_vector3s(size_t index)
+    {
+        return { floats[index].data(), floats[index + 1].data(), floats[index + 2].data() };
+    }
+
+    batch::TransformSoa<float> get_transforms()
+    {
+        return { get_vector3s(0), { floats[6].data(), floats[7].data(), floats[8].data(), floats[9].data() } };
+    }
+
+    batch::AabbSoa<float> get_aabbs()
+    {
+        return { get_vector3s(0), get_vector3s(3) };
+    }
+
+    batch::SphereSoa<float> get_spheres()
+    {
+        return { get_vector3s(0), floats[10].data() };
+    }
+
+    std::array<std::vector<float>, 11> floats;
+    std::vector<float> matrices;
+    std::vector<uint8_t> visible;
+};
+
+static const std::array<batch::Plane, 6> Planes {
+    batch::Plane { 1, 0, 0, 50 },
+    batch::Plane { -1, 0, 0, 50 },
+    batch::Plane { 0, 1, 0, 50 },
+    batch::Plane { 0, -1, 0, 50 },
+    batch::Plane { 0, 0.70710678f, 0.70710678f, 40 },
+    batch::Plane { 0, 0, -1, 60 },
+};
+
+static bool set_instruction_set(benchmark::State& state)
+{
+    auto instructionSet = (batch::InstructionSet)state.range(1);
+    if (!batch::is_supported(instructionSet)) {
+        state.SkipWithError("InstructionSet not supported");
+        return false;
+    }
+    batch::set_instruction_set(instructionSet);
+    const char* pLabels[] { "Scalar", "Sse2", "Avx2", "Neon" };
+    state.SetLabel(pLabels[state.range(1)]);
+    return true;
+}
+
+static void apply_arguments(benchmark::internal::Benchmark* pBenchmark)
+{
+    for (auto count : { 1024, 65536 }) {
+        for (auto instructionSet : { batch::InstructionSet::Scalar, batch::InstructionSet::Sse2, batch::InstructionSet::Avx2, batch::InstructionSet::Neon }) {
+            if (batch::is_supported(instructionSet)) {
+                pBenchmark->Args({ count, (int64_t)instructionSet });
+            }
+        }
+    }
+}
+
+static void BatchMath_compose_transforms(benchmark::State& state)
+{
+    if (set_instruction_set(state)) {
+        auto count = (size_t)state.range(0);
+        Streams parents(count);
+        Streams locals(count);
+        Streams results(count);
+        for (auto _ : state) {
+            batch::compose_transforms(count, parents.get_transforms(), locals.get_transforms(), results.get_transforms());
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+}
+BENCHMARK(BatchMath_compose_transforms)->Apply(apply_arguments);
+
+static void BatchMath_create_matrices(benchmark::State& state)
+{
+    if (set_instruction_set(state)) {
+        auto count = (size_t)state.range(0);
+        Streams streams(count);
+        for (auto _ : state) {
+            batch::create_matrices(count, streams.get_transforms(), streams.matrices.data());
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+}
+BENCHMARK(BatchMath_create_matrices)->Apply(apply_arguments);
+
+static void BatchMath_transform_aabbs(benchmark::State& state)
+{
+    if (set_instruction_set(state)) {
+        auto count = (size_t)state.range(0);
+        Streams streams(count);
+        Streams results(count);
+        for (auto _ : state) {
+            batch::transform_aabbs(count, streams.get_aabbs(), streams.get_transforms(), results.get_aabbs());
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+}
+BENCHMARK(BatchMath_transform_aabbs)->Apply(apply_arguments);
+
+static void BatchMath_merge_aabbs(benchmark::State& state)
+{
+    if (set_instruction_set(state)) {
+        auto count = (size_t)state.range(0);
+        Streams streams(count);
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(batch::merge_aabbs(count, streams.get_aabbs()));
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+}
+BENCHMARK(BatchMath_merge_aabbs)->Apply(apply_arguments);
+
+static void BatchMath_cull_spheres(benchmark::State& state)
+{
+    if (set_instruction_set(state)) {
+        auto count = (size_t)state.range(0);
+        Streams streams(count);
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(batch::cull_spheres(Planes, count, streams.get_spheres(), streams.visible.data()));
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+}
+BENCHMARK(BatchMath_cull_spheres)->Apply(apply_arguments);
+
+static void BatchMath_cull_aabbs(benchmark::State& state)
+{
+    if (set_instruction_set(state)) {
+        auto count = (size_t)state.range(0);
+        Streams streams(count);
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(batch::cull_aabbs(Planes, count, streams.get_aabbs(), streams.visible.data()));
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+}
+BENCHMARK(BatchMath_cull_aabbs)->Apply(apply_arguments);
+
+} // namespace benchmarks
+} // namespace dst
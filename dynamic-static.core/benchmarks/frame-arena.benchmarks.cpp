@@ -0,0 +1,90 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#include "dynamic-static/frame-arena.hpp"
+#include "dynamic-static/stack-allocator.hpp"
+
+#include "benchmark/benchmark.h"
+
+#include <memory_resource>
+#include <vector>
+
+namespace dst {
+namespace benchmarks {
+
+// Mimics a frame's worth of transient allocations, a handful of growing
+//  vectors of varying sizes that are all discarded at the end of the frame.
+static void build_transient_data(std::pmr::memory_resource* pMemoryResource, size_t vectorCount)
+{
+    std::pmr::vector<std::pmr::vector<uint32_t>> vectors(pMemoryResource);
+    vectors.reserve(vectorCount);
+    for (size_t vector_i = 0; vector_i < vectorCount; ++vector_i) {
+        auto& vector = vectors.emplace_back();
+        for (uint32_t i = 0; i < (uint32_t)(vector_i % 64) + 1; ++i) {
+            vector.push_back(i);
+        }
+    }
+    benchmark::DoNotOptimize(vectors.data());
+}
+
+static void FrameArena_new_delete(benchmark::State& state)
+{
+    for (auto _ : state) {
+        build_transient_data(std::pmr::new_delete_resource(), (size_t)state.range(0));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(FrameArena_new_delete)->Arg(256)->Arg(4096);
+
+static void FrameArena_clear(benchmark::State& state)
+{
+    FrameArena frameArena;
+    FrameArena::CreateInfo frameArenaCreateInfo { };
+    FrameArena::create(&frameArenaCreateInfo, &frameArena);
+    for (auto _ : state) {
+        build_transient_data(&frameArena, (size_t)state.range(0));
+        frameArena.clear();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(FrameArena_clear)->Arg(256)->Arg(4096);
+
+static void StackAllocator_scope(benchmark::State& state)
+{
+    StackAllocator stackAllocator;
+    StackAllocator::CreateInfo stackAllocatorCreateInfo { };
+    stackAllocatorCreateInfo.size = 4 * 1024 * 1024;
+    StackAllocator::create(&stackAllocatorCreateInfo, &stackAllocator);
+    for (auto _ : state) {
+        StackAllocator::Scope scope(stackAllocator);
+        build_transient_data(&stackAllocator, (size_t)state.range(0));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(StackAllocator_scope)->Arg(256)->Arg(4096);
+
+} // namespace benchmarks
+} // namespace dst
@@ -0,0 +1,89 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#include "dynamic-static/frame-pipeline.hpp"
+
+#include "benchmark/benchmark.h"
+
+#include <cmath>
+#include <vector>
+
+namespace dst {
+namespace benchmarks {
+
+struct FrameInput
+{
+    float deltaTime { 0 };
+};
+
+static void simulate_frame(const FrameInput& input, std::vector<float>* pTransforms)
+{
+    // Stand in for game logic and physics, writes every transform.
+    auto& transforms = *pTransforms;
+    transforms.resize(1 << 14);
+    for (size_t i = 0; i < transforms.size(); ++i) {
+        transforms[i] = std::sqrt(transforms[i] * transforms[i] + input.deltaTime + (float)i);
+    }
+}
+
+static float prepare_frame(const std::vector<float>& transforms)
+{
+    // Stand in for uniform updates and command recording, reads every transform.
+    float result = 0;
+    for (auto transform : transforms) {
+        result += std::sin(transform);
+    }
+    return result;
+}
+
+static void FramePipeline_serial(benchmark::State& state)
+{
+    std::vector<float> transforms;
+    for (auto _ : state) {
+        simulate_frame({ 1.0f / 60.0f }, &transforms);
+        benchmark::DoNotOptimize(prepare_frame(transforms));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(FramePipeline_serial)->UseRealTime();
+
+static void FramePipeline_pipelined(benchmark::State& state)
+{
+    FramePipeline<FrameInput, std::vector<float>>::CreateInfo framePipelineCreateInfo { };
+    framePipelineCreateInfo.simulate = simulate_frame;
+    FramePipeline<FrameInput, std::vector<float>> framePipeline;
+    FramePipeline<FrameInput, std::vector<float>>::create(&framePipelineCreateInfo, &framePipeline);
+    for (auto _ : state) {
+        framePipeline.submit({ 1.0f / 60.0f });
+        benchmark::DoNotOptimize(prepare_frame(framePipeline.acquire()));
+        framePipeline.release();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(FramePipeline_pipelined)->UseRealTime();
+
+} // namespace benchmarks
+} // namespace dst
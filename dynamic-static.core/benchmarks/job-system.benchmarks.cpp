@@ -0,0 +1,95 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#include "dynamic-static/job-system.hpp"
+
+#include "benchmark/benchmark.h"
+
+#include <cmath>
+#include <vector>
+
+namespace dst {
+namespace benchmarks {
+
+static void transform_range(std::vector<float>& values, size_t begin, size_t end)
+{
+    for (size_t i = begin; i < end; ++i) {
+        values[i] = std::sqrt(values[i] * values[i] + 1.0f);
+    }
+}
+
+static void JobSystem_serial_for(benchmark::State& state)
+{
+    std::vector<float> values((size_t)state.range(0), 1.0f);
+    for (auto _ : state) {
+        transform_range(values, 0, values.size());
+        benchmark::DoNotOptimize(values.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(JobSystem_serial_for)->Arg(1 << 12)->Arg(1 << 16)->Arg(1 << 20);
+
+static void JobSystem_parallel_for(benchmark::State& state)
+{
+    JobSystem jobSystem;
+    JobSystem::CreateInfo jobSystemCreateInfo { };
+    JobSystem::create(&jobSystemCreateInfo, &jobSystem);
+    std::vector<float> values((size_t)state.range(0), 1.0f);
+    for (auto _ : state) {
+        jobSystem.parallel_for(values.size(), 1024,
+            [&](size_t begin, size_t end)
+            {
+                transform_range(values, begin, end);
+            }
+        );
+        benchmark::DoNotOptimize(values.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.counters["threads"] = (double)jobSystem.get_thread_count();
+}
+BENCHMARK(JobSystem_parallel_for)->Arg(1 << 12)->Arg(1 << 16)->Arg(1 << 20)->UseRealTime();
+
+static void JobSystem_run_wait(benchmark::State& state)
+{
+    JobSystem jobSystem;
+    JobSystem::CreateInfo jobSystemCreateInfo { };
+    JobSystem::create(&jobSystemCreateInfo, &jobSystem);
+    auto jobCount = (size_t)state.range(0);
+    for (auto _ : state) {
+        JobCounter counter;
+        for (size_t i = 0; i < jobCount; ++i) {
+            jobSystem.run(&counter, [] { });
+        }
+        jobSystem.wait(&counter);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(JobSystem_run_wait)->Arg(64)->Arg(1024)->UseRealTime();
+
+} // namespace benchmarks
+} // namespace dst
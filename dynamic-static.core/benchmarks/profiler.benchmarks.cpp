@@ -24,4 +24,40 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 *******************************************************************************/
 
-#include "dynamic-static.graphics/defines.hpp"
+#include "dynamic-static/profiler.hpp"
+
+#include "benchmark/benchmark.h"
+
+namespace dst {
+namespace benchmarks {
+
+static void Profiler_get_timestamp(benchmark::State& state)
+{
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(profiler::get_timestamp());
+    }
+}
+BENCHMARK(Profiler_get_timestamp);
+
+static void Profiler_scope(benchmark::State& state)
+{
+    // Clears periodically so the benchmark measures recording, not growth of
+    //  the event storage.
+    size_t zoneCount = 0;
+    for (auto _ : state) {
+        {
+            profiler::Scope scope("Profiler_scope");
+        }
+        if (++zoneCount == 64 * 1024) {
+            state.PauseTiming();
+            profiler::clear();
+            zoneCount = 0;
+            state.ResumeTiming();
+        }
+    }
+    profiler::clear();
+}
+BENCHMARK(Profiler_scope);
+
+} // namespace benchmarks
+} // namespace dst
@@ -0,0 +1,141 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#include "dynamic-static/queue.hpp"
+
+#include "benchmark/benchmark.h"
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace dst {
+namespace benchmarks {
+
+static void Queue_mutex_deque(benchmark::State& state)
+{
+    // Baseline for SpscQueue, one producer and one consumer sharing a std::deque
+    //  guarded by a std::mutex.
+    constexpr int64_t ValueCount = 1 << 20;
+    for (auto _ : state) {
+        std::mutex mutex;
+        std::deque<int64_t> queue;
+        std::thread producer([&]() {
+            for (int64_t i = 0; i < ValueCount; ++i) {
+                std::lock_guard<std::mutex> lock(mutex);
+                queue.push_back(i);
+            }
+        });
+        int64_t sum = 0;
+        for (int64_t i = 0; i < ValueCount;) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!queue.empty()) {
+                sum += queue.front();
+                queue.pop_front();
+                ++i;
+            }
+        }
+        producer.join();
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * ValueCount);
+}
+BENCHMARK(Queue_mutex_deque)->UseRealTime();
+
+static void Queue_spsc(benchmark::State& state)
+{
+    constexpr int64_t ValueCount = 1 << 20;
+    for (auto _ : state) {
+        SpscQueue<int64_t> queue(1024);
+        std::thread producer([&]() {
+            for (int64_t i = 0; i < ValueCount; ++i) {
+                while (!queue.push(i)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+        int64_t sum = 0;
+        int64_t value = 0;
+        for (int64_t i = 0; i < ValueCount;) {
+            if (queue.pop(&value)) {
+                sum += value;
+                ++i;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+        producer.join();
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * ValueCount);
+}
+BENCHMARK(Queue_spsc)->UseRealTime();
+
+static void Queue_mpmc(benchmark::State& state)
+{
+    // state.range(0) producers and state.range(0) consumers.
+    const auto threadCount = (int64_t)state.range(0);
+    const int64_t ValueCount = (1 << 20) / threadCount;
+    for (auto _ : state) {
+        MpmcQueue<int64_t> queue(1024);
+        std::atomic<int64_t> sum { 0 };
+        std::vector<std::thread> threads;
+        for (int64_t thread_i = 0; thread_i < threadCount; ++thread_i) {
+            threads.emplace_back([&]() {
+                for (int64_t i = 0; i < ValueCount; ++i) {
+                    while (!queue.push(i)) {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+            threads.emplace_back([&]() {
+                int64_t localSum = 0;
+                int64_t value = 0;
+                for (int64_t i = 0; i < ValueCount;) {
+                    if (queue.pop(&value)) {
+                        localSum += value;
+                        ++i;
+                    } else {
+                        std::this_thread::yield();
+                    }
+                }
+                sum += localSum;
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        benchmark::DoNotOptimize(sum.load());
+    }
+    state.SetItemsProcessed(state.iterations() * ValueCount * threadCount);
+}
+BENCHMARK(Queue_mpmc)->Arg(1)->Arg(2)->Arg(4)->UseRealTime();
+
+} // namespace benchmarks
+} // namespace dst
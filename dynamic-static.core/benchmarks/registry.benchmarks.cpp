@@ -0,0 +1,142 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#include "dynamic-static/registry.hpp"
+
+#include "benchmark/benchmark.h"
+
+#include <random>
+#include <vector>
+
+namespace dst {
+namespace benchmarks {
+
+// Each iteration integrates positions and writes a translation into each
+//  object's world matrix, approximating a physics to render sync.  The AoS
+//  variant stores every field of an object together like a fat GameObject, the
+//  Registry variant only touches the components the system needs.
+struct Position final
+{
+    float xyz[3] { };
+};
+
+struct Velocity final
+{
+    float xyz[3] { 1, 1, 1 };
+};
+
+struct WorldMatrix final
+{
+    float elements[16] { };
+};
+
+struct RenderData final
+{
+    unsigned char bytes[128] { };
+};
+
+struct GameObject final
+{
+    Position position;
+    Velocity velocity;
+    WorldMatrix worldMatrix;
+    RenderData renderData;
+};
+
+static void update(const Velocity& velocity, Position& position, WorldMatrix& worldMatrix)
+{
+    for (int i = 0; i < 3; ++i) {
+        position.xyz[i] += velocity.xyz[i] * (1.0f / 60.0f);
+        worldMatrix.elements[12 + i] = position.xyz[i];
+    }
+}
+
+static void GameObject_update(benchmark::State& state)
+{
+    std::vector<GameObject> gameObjects((size_t)state.range(0));
+    for (auto _ : state) {
+        for (auto& gameObject : gameObjects) {
+            update(gameObject.velocity, gameObject.position, gameObject.worldMatrix);
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(GameObject_update)->Arg(1024)->Arg(65536);
+
+static void Registry_update(benchmark::State& state)
+{
+    Registry registry;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+        auto entity = registry.create_entity();
+        registry.emplace<Position>(entity);
+        registry.emplace<Velocity>(entity);
+        registry.emplace<WorldMatrix>(entity);
+        registry.emplace<RenderData>(entity);
+    }
+    for (auto _ : state) {
+        registry.each<Velocity, Position, WorldMatrix>(
+            [](Entity, const Velocity& velocity, Position& position, WorldMatrix& worldMatrix)
+            {
+                update(velocity, position, worldMatrix);
+            }
+        );
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(Registry_update)->Arg(1024)->Arg(65536);
+
+static void Registry_churn(benchmark::State& state)
+{
+    // Each iteration despawns and respawns an eighth of the live entities.
+    auto entityCount = (size_t)state.range(0);
+    std::mt19937 rng(0);
+    Registry registry;
+    std::vector<Entity> entities;
+    for (size_t i = 0; i < entityCount; ++i) {
+        entities.push_back(registry.create_entity());
+        registry.emplace<Position>(entities.back());
+        registry.emplace<Velocity>(entities.back());
+        registry.emplace<WorldMatrix>(entities.back());
+    }
+    for (auto _ : state) {
+        for (size_t i = 0; i < entityCount / 8; ++i) {
+            auto& entity = entities[rng() % entities.size()];
+            registry.destroy_entity(entity);
+            entity = registry.create_entity();
+            registry.emplace<Position>(entity);
+            registry.emplace<Velocity>(entity);
+            registry.emplace<WorldMatrix>(entity);
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * (state.range(0) / 8));
+}
+BENCHMARK(Registry_churn)->Arg(1024)->Arg(65536);
+
+} // namespace benchmarks
+} // namespace dst
@@ -0,0 +1,173 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#include "dynamic-static/pool.hpp"
+#include "dynamic-static/slot-map.hpp"
+
+#include "benchmark/benchmark.h"
+
+#include <random>
+#include <unordered_set>
+#include <vector>
+
+namespace dst {
+namespace benchmarks {
+
+// Each iteration despawns and respawns an eighth of the live objects then
+//  updates every live object, approximating a game loop with churn.
+struct Object final
+{
+    float position[3] { };
+    float velocity[3] { 1, 1, 1 };
+};
+
+static void update_object(Object& object)
+{
+    for (int i = 0; i < 3; ++i) {
+        object.position[i] += object.velocity[i] * (1.0f / 60.0f);
+    }
+}
+
+static void Vector_churn(benchmark::State& state)
+{
+    // Baseline, objects are erased with swap and pop so handles are indices that
+    //  are patched when the last object moves into an erased object's slot.
+    //  owners maps each object's index back to the handle that refers to it.
+    auto objectCount = (size_t)state.range(0);
+    std::mt19937 rng(0);
+    std::vector<Object> objects;
+    std::vector<size_t> owners;
+    std::vector<size_t> handles;
+    for (size_t i = 0; i < objectCount; ++i) {
+        handles.push_back(objects.size());
+        owners.push_back(i);
+        objects.emplace_back();
+    }
+    for (auto _ : state) {
+        for (size_t i = 0; i < objectCount / 8; ++i) {
+            auto handle_i = rng() % handles.size();
+            auto object_i = handles[handle_i];
+            objects[object_i] = objects.back();
+            owners[object_i] = owners.back();
+            handles[owners[object_i]] = object_i;
+            objects.pop_back();
+            owners.pop_back();
+            handles[handle_i] = objects.size();
+            owners.push_back(handle_i);
+            objects.emplace_back();
+        }
+        for (auto& object : objects) {
+            update_object(object);
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(Vector_churn)->Arg(1024)->Arg(16384);
+
+static void SlotMap_churn(benchmark::State& state)
+{
+    auto objectCount = (size_t)state.range(0);
+    std::mt19937 rng(0);
+    SlotMap<Object> objects;
+    std::vector<SlotMap<Object>::Handle> handles;
+    for (size_t i = 0; i < objectCount; ++i) {
+        handles.push_back(objects.emplace());
+    }
+    for (auto _ : state) {
+        for (size_t i = 0; i < objectCount / 8; ++i) {
+            auto& handle = handles[rng() % handles.size()];
+            objects.erase(handle);
+            handle = objects.emplace();
+        }
+        for (auto& object : objects) {
+            update_object(object);
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(SlotMap_churn)->Arg(1024)->Arg(16384);
+
+static void UnorderedSet_churn(benchmark::State& state)
+{
+    auto objectCount = (size_t)state.range(0);
+    std::mt19937 rng(0);
+    std::unordered_set<Object*> objects;
+    std::vector<Object*> handles;
+    for (size_t i = 0; i < objectCount; ++i) {
+        handles.push_back(*objects.insert(new Object).first);
+    }
+    for (auto _ : state) {
+        for (size_t i = 0; i < objectCount / 8; ++i) {
+            auto& handle = handles[rng() % handles.size()];
+            objects.erase(handle);
+            delete handle;
+            handle = *objects.insert(new Object).first;
+        }
+        for (auto pObject : objects) {
+            update_object(*pObject);
+        }
+        benchmark::ClobberMemory();
+    }
+    for (auto pObject : objects) {
+        delete pObject;
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(UnorderedSet_churn)->Arg(1024)->Arg(16384);
+
+static void PooledUnorderedSet_churn(benchmark::State& state)
+{
+    auto objectCount = (size_t)state.range(0);
+    std::mt19937 rng(0);
+    Pool<Object> pool;
+    std::unordered_set<Object*> objects;
+    std::vector<Object*> handles;
+    for (size_t i = 0; i < objectCount; ++i) {
+        handles.push_back(*objects.insert(pool.acquire()).first);
+    }
+    for (auto _ : state) {
+        for (size_t i = 0; i < objectCount / 8; ++i) {
+            auto& handle = handles[rng() % handles.size()];
+            objects.erase(handle);
+            pool.release(handle);
+            handle = *objects.insert(pool.acquire()).first;
+        }
+        for (auto pObject : objects) {
+            update_object(*pObject);
+        }
+        benchmark::ClobberMemory();
+    }
+    for (auto pObject : objects) {
+        pool.release(pObject);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(PooledUnorderedSet_churn)->Arg(1024)->Arg(16384);
+
+} // namespace benchmarks
+} // namespace dst
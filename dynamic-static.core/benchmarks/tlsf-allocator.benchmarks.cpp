@@ -0,0 +1,59 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+
+#include "dynamic-static/tlsf-allocator.hpp"
+
+#include "benchmark/benchmark.h"
+
+#include <random>
+#include <vector>
+
+namespace dst {
+namespace benchmarks {
+
+static void TlsfAllocator_allocate_free(benchmark::State& state)
+{
+    TlsfAllocator::CreateInfo tlsfAllocatorCreateInfo { };
+    tlsfAllocatorCreateInfo.size = 64 * 1024 * 1024;
+    TlsfAllocator tlsfAllocator;
+    TlsfAllocator::create(&tlsfAllocatorCreateInfo, &tlsfAllocator);
+    std::mt19937 random(7);
+    std::vector<TlsfAllocator::Handle> handles((size_t)state.range(0), TlsfAllocator::InvalidHandle);
+    for (auto _ : state) {
+        auto& handle = handles[random() % handles.size()];
+        if (handle != TlsfAllocator::InvalidHandle) {
+            tlsfAllocator.free(handle);
+        }
+        handle = tlsfAllocator.allocate(random() % 4096 + 1);
+        benchmark::DoNotOptimize(handle);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(TlsfAllocator_allocate_free)->Arg(256)->Arg(4096);
+
+} // namespace benchmarks
+} // namespace dst
@@ -0,0 +1,175 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#pragma once
+
+#include "dynamic-static/defines.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace dst {
+
+constexpr uint32_t make_fourcc(char c0, char c1, char c2, char c3)
+{
+    return (uint32_t)(uint8_t)c0 | (uint32_t)(uint8_t)c1 << 8 | (uint32_t)(uint8_t)c2 << 16 | (uint32_t)(uint8_t)c3 << 24;
+}
+
+class AssetFile final
+{
+public:
+    // Binary container of typed sections.  A Header is followed by a table of
+    //  Sections, each Section's data starts on a SectionAlignment boundary so
+    //  arrays of trivially copyable types can be used directly from the mapped
+    //  file.  Files are little endian, a byte swapped magic number fails
+    //  validation.  Section types are FourCCs defined by the modules that write
+    //  them, ids distinguish Sections of the same type.
+    static constexpr uint32_t Magic { make_fourcc('D', 'S', 'T', 'A') };
+    static constexpr uint32_t Version { 1 };
+    static constexpr size_t SectionAlignment { 64 };
+
+    struct Header final
+    {
+        uint32_t magic { Magic };
+        uint32_t version { Version };
+        uint32_t sectionCount { 0 };
+        uint32_t reserved { 0 };
+        uint64_t sectionTableOffset { 0 };
+        uint64_t fileSize { 0 };
+    };
+
+    struct Section final
+    {
+        uint32_t type { 0 };
+        uint32_t id { 0 };
+        uint64_t offset { 0 };
+        uint64_t size { 0 };
+        uint32_t stride { 0 };
+        uint32_t reserved { 0 };
+    };
+
+    struct CreateInfo final
+    {
+        std::filesystem::path filePath;
+
+        // Asks the OS to read the whole file ahead of first access instead of
+        //  faulting pages in as Sections are touched.
+        bool prefetch { false };
+
+        // Maps the file copy on write so Section data may be modified in place, see
+        //  get_mutable_section_data().  Modified pages are private to this AssetFile
+        //  and are never written back to the file.
+        bool copyOnWrite { false };
+    };
+
+    // Maps the file and validates its Header and Section table.  The mapping is
+    //  read only unless CreateInfo::copyOnWrite is set, in which case it's a
+    //  private writable mapping.  Consumers that modify Section data in place
+    //  need copyOnWrite, ie. physics::CollisionMesh::create() fails on a read
+    //  only AssetFile because Bullet writes its BVH header in place.  Returns
+    //  false and leaves pAssetFile empty if the file can't be mapped or fails
+    //  validation.
+    static bool create(const CreateInfo* pCreateInfo, AssetFile* pAssetFile);
+
+    // Validates a Header and Section table in memory, used by create().
+    static bool validate(std::span<const uint8_t> data);
+
+    AssetFile() = default;
+    AssetFile(AssetFile&& other) noexcept;
+    AssetFile& operator=(AssetFile&& other) noexcept;
+    AssetFile(const AssetFile&) = delete;
+    AssetFile& operator=(const AssetFile&) = delete;
+    ~AssetFile();
+
+    const Header* get_header() const;
+    std::span<const Section> get_sections() const;
+    const Section* find_section(uint32_t type, uint32_t id = 0) const;
+    std::span<const uint8_t> get_section_data(const Section& section) const;
+    std::span<uint8_t> get_mutable_section_data(const Section& section);
+    std::span<const uint8_t> get_data() const;
+
+    // Returns true if the file is mapped copy on write, get_mutable_section_data()
+    //  may only be called when this returns true.
+    bool is_copy_on_write() const;
+    void reset();
+
+    // Gets a Section's data as a span of T without copying, returns an empty span
+    //  if the Section doesn't exist or its size isn't a multiple of sizeof(T).
+    template <typename T>
+    inline std::span<const T> get_section_data(uint32_t type, uint32_t id = 0) const
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        static_assert(alignof(T) <= SectionAlignment);
+        auto pSection = find_section(type, id);
+        if (pSection && !(pSection->size % sizeof(T))) {
+            auto data = get_section_data(*pSection);
+            return { (const T*)data.data(), data.size() / sizeof(T) };
+        }
+        return { };
+    }
+
+private:
+    const uint8_t* mpData { nullptr };
+    size_t mSize { 0 };
+    bool mCopyOnWrite { false };
+};
+
+class AssetFileWriter final
+{
+public:
+    // Copies pData into a new Section, stride is informational and may be 0.
+    //  Adding a Section with the same type and id as an existing Section
+    //  replaces it.
+    void add_section(uint32_t type, uint32_t id, const void* pData, size_t size, uint32_t stride);
+
+    template <typename T>
+    inline void add_section(uint32_t type, uint32_t id, std::span<const T> data)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        static_assert(alignof(T) <= AssetFile::SectionAlignment);
+        add_section(type, id, data.data(), data.size_bytes(), (uint32_t)sizeof(T));
+    }
+
+    size_t get_section_count() const;
+    void write(std::vector<uint8_t>* pData) const;
+    bool write(const std::filesystem::path& filePath) const;
+    void clear();
+
+private:
+    struct PendingSection final
+    {
+        AssetFile::Section section;
+        std::vector<uint8_t> data;
+    };
+
+    std::vector<PendingSection> mSections;
+};
+
+} // namespace dst
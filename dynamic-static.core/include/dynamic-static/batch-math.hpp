@@ -0,0 +1,158 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#pragma once
+
+#include "dynamic-static/defines.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+
+namespace dst {
+namespace batch {
+
+// Batch kernels operate on structure of arrays (SoA) streams, each component
+//  of an element is read from or written to its own array.  Kernels are
+//  dispatched at runtime to the widest instruction set the CPU supports.  Every
+//  instruction set evaluates the same operations in the same order with no
+//  fused multiply-add, so results match the scalar kernels exactly, only the
+//  sign of zero may differ for min/max on NEON.
+enum class InstructionSet
+{
+    Scalar = 0,
+    Sse2,
+    Avx2,
+    Neon,
+};
+
+template <typename T>
+struct Vector3Soa final
+{
+    T* pX { nullptr };
+    T* pY { nullptr };
+    T* pZ { nullptr };
+
+    inline operator Vector3Soa<const T>() const requires (!std::is_const_v<T>)
+    {
+        return { pX, pY, pZ };
+    }
+};
+
+template <typename T>
+struct QuaternionSoa final
+{
+    T* pX { nullptr };
+    T* pY { nullptr };
+    T* pZ { nullptr };
+    T* pW { nullptr };
+
+    inline operator QuaternionSoa<const T>() const requires (!std::is_const_v<T>)
+    {
+        return { pX, pY, pZ, pW };
+    }
+};
+
+// Rigid transforms, rotations must be unit quaternions.
+template <typename T>
+struct TransformSoa final
+{
+    Vector3Soa<T> positions { };
+    QuaternionSoa<T> rotations { };
+
+    inline operator TransformSoa<const T>() const requires (!std::is_const_v<T>)
+    {
+        return { positions, rotations };
+    }
+};
+
+template <typename T>
+struct AabbSoa final
+{
+    Vector3Soa<T> mins { };
+    Vector3Soa<T> maxs { };
+
+    inline operator AabbSoa<const T>() const requires (!std::is_const_v<T>)
+    {
+        return { mins, maxs };
+    }
+};
+
+template <typename T>
+struct SphereSoa final
+{
+    Vector3Soa<T> centers { };
+    T* pRadii { nullptr };
+
+    inline operator SphereSoa<const T>() const requires (!std::is_const_v<T>)
+    {
+        return { centers, pRadii };
+    }
+};
+
+struct Aabb final
+{
+    float min[3] { };
+    float max[3] { };
+};
+
+// Planes are stored as { normal, distance } with normals pointing inward, the
+//  same convention as dst::gfx::Frustum.
+using Plane = std::array<float, 4>;
+
+bool is_supported(InstructionSet instructionSet);
+InstructionSet get_supported_instruction_set();
+InstructionSet get_instruction_set();
+
+// Overrides the dispatched instruction set, instructionSet must be supported.
+//  Intended for tests and benchmarks.
+void set_instruction_set(InstructionSet instructionSet);
+
+// Writes parents[i] * locals[i] to results[i].  results may alias parents or
+//  locals.
+void compose_transforms(size_t count, TransformSoa<const float> parents, TransformSoa<const float> locals, TransformSoa<float> results);
+
+// Writes a column major 4x4 matrix for each transform to pMatrices, 16 floats
+//  per transform.  This is the layout of glm::mat4 and btTransform::getOpenGLMatrix().
+void create_matrices(size_t count, TransformSoa<const float> transforms, float* pMatrices);
+
+// Writes the AABB enclosing each transformed AABB to results.  results may alias
+//  aabbs.
+void transform_aabbs(size_t count, AabbSoa<const float> aabbs, TransformSoa<const float> transforms, AabbSoa<float> results);
+
+// Returns the AABB enclosing every AABB, when count is 0 min is +infinity and
+//  max is -infinity.
+Aabb merge_aabbs(size_t count, AabbSoa<const float> aabbs);
+
+// Writes 1 to pVisible[i] for each sphere/AABB that intersects or is inside
+//  every plane and 0 otherwise, returns the number visible.
+size_t cull_spheres(std::span<const Plane> planes, size_t count, SphereSoa<const float> spheres, uint8_t* pVisible);
+size_t cull_aabbs(std::span<const Plane> planes, size_t count, AabbSoa<const float> aabbs, uint8_t* pVisible);
+
+} // namespace batch
+} // namespace dst
@@ -0,0 +1,111 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#pragma once
+
+#include "dynamic-static/defines.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+namespace dst {
+
+class FrameArena final
+    : public std::pmr::memory_resource
+{
+public:
+    struct CreateInfo final
+    {
+        size_t blockSize { 1024 * 1024 };
+        std::pmr::memory_resource* pUpstream { nullptr };
+    };
+
+    // Bump allocator for per frame temporaries.  Deallocation is a no-op, memory
+    //  is reclaimed all at once by clear().  When a frame overflows the current
+    //  block another block is taken from upstream, the next clear() coalesces all
+    //  blocks into one so frames of similar size stop allocating from upstream.
+    static void create(const CreateInfo* pCreateInfo, FrameArena* pFrameArena);
+
+    FrameArena() = default;
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+    ~FrameArena();
+
+    size_t get_used_size() const;
+    size_t get_capacity() const;
+    size_t get_block_count() const;
+    void clear();
+    void reset();
+
+private:
+    struct Block final
+    {
+        std::byte* pData { nullptr };
+        size_t size { 0 };
+    };
+
+    void* do_allocate(size_t size, size_t alignment) override final;
+    void do_deallocate(void* pData, size_t size, size_t alignment) override final;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override final;
+    void allocate_block(size_t size);
+
+    std::pmr::memory_resource* mpUpstream { nullptr };
+    std::vector<Block> mBlocks;
+    size_t mBlockSize { 0 };
+    size_t mBlockIndex { 0 };
+    size_t mOffset { 0 };
+};
+
+class BufferedFrameArena final
+{
+public:
+    struct CreateInfo final
+    {
+        uint32_t frameCount { 2 };
+        FrameArena::CreateInfo frameArenaCreateInfo { };
+    };
+
+    // Ring of FrameArenas for data that must outlive the frame that allocated it,
+    //  ie. until the GPU fence for that frame has been waited on.  next_frame()
+    //  advances to the oldest FrameArena and clears it, so callers must wait on
+    //  that frame's fence first.
+    static void create(const CreateInfo* pCreateInfo, BufferedFrameArena* pBufferedFrameArena);
+
+    uint32_t get_frame_count() const;
+    uint32_t get_frame_index() const;
+    FrameArena& get_frame_arena();
+    void next_frame();
+    void reset();
+
+private:
+    std::vector<std::unique_ptr<FrameArena>> mupFrameArenas;
+    uint32_t mFrameIndex { 0 };
+};
+
+} // namespace dst
@@ -0,0 +1,222 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#pragma once
+
+#include "dynamic-static/defines.hpp"
+#include "dynamic-static/profiler.hpp"
+#include "dynamic-static/queue.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace dst {
+
+template <typename InputType, typename SnapshotType>
+class FramePipeline final
+{
+public:
+    struct CreateInfo final
+    {
+        // Called on the simulation thread once for each submitted InputType, must
+        //  write the frame's state to pSnapshot.  pSnapshot holds whatever was last
+        //  written to that buffer so containers can be reused without allocating.
+        std::function<void(const InputType& input, SnapshotType* pSnapshot)> simulate;
+
+        // 2 lets simulation of frame N + 1 overlap render preparation of frame N,
+        //  more lets simulation run further ahead at the cost of latency.
+        uint32_t snapshotCount { 2 };
+    };
+
+    // Runs simulate() on a dedicated thread and hands finished frames to the
+    //  thread that calls acquire() through a ring of Snapshot buffers.  Each frame
+    //  the render thread calls submit() with the next frame's input then
+    //  acquire() to get the previous frame's Snapshot, so simulation of one frame
+    //  overlaps render preparation of the one before it.  create() submits a
+    //  default constructed InputType for the first frame so acquire() never waits
+    //  on the frame that was just submitted.  Latency is bounded by
+    //  snapshotCount - 1 frames, submit() blocks if simulation falls that far
+    //  behind and acquire() blocks until a frame is ready.
+    static void create(const CreateInfo* pCreateInfo, FramePipeline* pFramePipeline)
+    {
+        assert(pCreateInfo);
+        assert(pCreateInfo->simulate);
+        assert(2 <= pCreateInfo->snapshotCount);
+        assert(pFramePipeline);
+        pFramePipeline->reset();
+        pFramePipeline->mSimulate = pCreateInfo->simulate;
+        pFramePipeline->mSnapshots = std::vector<Snapshot>(pCreateInfo->snapshotCount);
+        pFramePipeline->mupInputs = std::make_unique<Channel<InputType>>(pCreateInfo->snapshotCount);
+        pFramePipeline->mupFreeSnapshots = std::make_unique<Channel<uint32_t>>(pCreateInfo->snapshotCount);
+        pFramePipeline->mupReadySnapshots = std::make_unique<Channel<uint32_t>>(pCreateInfo->snapshotCount);
+        for (uint32_t i = 0; i < pCreateInfo->snapshotCount; ++i) {
+            pFramePipeline->mupFreeSnapshots->push(i, pFramePipeline->mRunning);
+        }
+        pFramePipeline->mRunning = true;
+        pFramePipeline->mThread = std::thread(&FramePipeline::simulation_main, pFramePipeline);
+        pFramePipeline->submit({ });
+    }
+
+    FramePipeline() = default;
+    FramePipeline(const FramePipeline&) = delete;
+    FramePipeline& operator=(const FramePipeline&) = delete;
+
+    ~FramePipeline()
+    {
+        reset();
+    }
+
+    void submit(InputType input)
+    {
+        assert(mRunning);
+        mupInputs->push(std::move(input), mRunning);
+    }
+
+    // The returned Snapshot isn't written to until release() is called.
+    const SnapshotType& acquire()
+    {
+        assert(mRunning);
+        assert(mAcquiredSnapshotIndex == NoSnapshot && "FramePipeline::acquire() called twice without release()");
+        auto acquired = mupReadySnapshots->pop(&mAcquiredSnapshotIndex, mRunning);
+        (void)acquired;
+        assert(acquired);
+        return mSnapshots[mAcquiredSnapshotIndex].snapshot;
+    }
+
+    void release()
+    {
+        assert(mAcquiredSnapshotIndex != NoSnapshot && "FramePipeline::release() called without acquire()");
+        mupFreeSnapshots->push(std::exchange(mAcquiredSnapshotIndex, NoSnapshot), mRunning);
+    }
+
+    // Stops the simulation thread after the frame it's working on, frames that
+    //  have been submitted but not started are dropped.
+    void reset()
+    {
+        if (mThread.joinable()) {
+            mRunning = false;
+            mupInputs->notify();
+            mupFreeSnapshots->notify();
+            mupReadySnapshots->notify();
+            mThread.join();
+        }
+        mSimulate = nullptr;
+        mSnapshots.clear();
+        mupInputs.reset();
+        mupFreeSnapshots.reset();
+        mupReadySnapshots.reset();
+        mAcquiredSnapshotIndex = NoSnapshot;
+    }
+
+private:
+    static constexpr uint32_t NoSnapshot { UINT32_MAX };
+
+    struct alignas(64) Snapshot final
+    {
+        SnapshotType snapshot { };
+    };
+
+    template <typename T>
+    class Channel final
+    {
+    public:
+        // SpscQueue that blocks when it's full or empty.  Waiters sleep on a counter
+        //  that's bumped by every push() and pop() so they wake when the queue
+        //  changes, push() and pop() return false if running is cleared.
+        Channel(size_t capacity)
+            : mQueue { capacity }
+        {
+        }
+
+        bool push(T value, const std::atomic<bool>& running)
+        {
+            auto signal = mSignal.load(std::memory_order_acquire);
+            while (!mQueue.push(value)) {
+                if (!running) {
+                    return false;
+                }
+                mSignal.wait(signal, std::memory_order_acquire);
+                signal = mSignal.load(std::memory_order_acquire);
+            }
+            notify();
+            return true;
+        }
+
+        bool pop(T* pValue, const std::atomic<bool>& running)
+        {
+            auto signal = mSignal.load(std::memory_order_acquire);
+            while (!mQueue.pop(pValue)) {
+                if (!running) {
+                    return false;
+                }
+                mSignal.wait(signal, std::memory_order_acquire);
+                signal = mSignal.load(std::memory_order_acquire);
+            }
+            notify();
+            return true;
+        }
+
+        void notify()
+        {
+            mSignal.fetch_add(1, std::memory_order_release);
+            mSignal.notify_all();
+        }
+
+    private:
+        SpscQueue<T> mQueue;
+        std::atomic<uint32_t> mSignal { 0 };
+    };
+
+    void simulation_main()
+    {
+        InputType input { };
+        uint32_t snapshotIndex = 0;
+        while (mupInputs->pop(&input, mRunning) && mupFreeSnapshots->pop(&snapshotIndex, mRunning)) {
+            {
+                dst_profile_scope("FramePipeline::simulate");
+                mSimulate(input, &mSnapshots[snapshotIndex].snapshot);
+            }
+            mupReadySnapshots->push(snapshotIndex, mRunning);
+        }
+    }
+
+    std::function<void(const InputType&, SnapshotType*)> mSimulate;
+    std::vector<Snapshot> mSnapshots;
+    std::unique_ptr<Channel<InputType>> mupInputs;
+    std::unique_ptr<Channel<uint32_t>> mupFreeSnapshots;
+    std::unique_ptr<Channel<uint32_t>> mupReadySnapshots;
+    uint32_t mAcquiredSnapshotIndex { NoSnapshot };
+    std::atomic<bool> mRunning { false };
+    std::thread mThread;
+};
+
+} // namespace dst
@@ -0,0 +1,222 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#pragma once
+
+#include "dynamic-static/defines.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace dst {
+
+template <typename T>
+class WorkStealingDeque final
+{
+public:
+    // Fixed capacity Chase-Lev deque.  push() and pop() may only be called by the
+    //  owning thread, steal() may be called by any thread.
+    // FROM : Le, Pop, Cohen, Nardelli - "Correct and Efficient Work-Stealing for Weak Memory Models"
+    WorkStealingDeque(size_t capacity = 4096)
+        : mupBuffer { std::make_unique<std::atomic<T>[]>(std::bit_ceil(std::max(capacity, (size_t)1))) }
+        , mMask { (int64_t)std::bit_ceil(std::max(capacity, (size_t)1)) - 1 }
+    {
+    }
+
+    bool push(T value)
+    {
+        auto bottom = mBottom.load(std::memory_order_relaxed);
+        auto top = mTop.load(std::memory_order_acquire);
+        if (mMask < bottom - top) {
+            return false;
+        }
+        mupBuffer[bottom & mMask].store(value, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        mBottom.store(bottom + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    bool pop(T* pValue)
+    {
+        assert(pValue);
+        auto bottom = mBottom.load(std::memory_order_relaxed) - 1;
+        mBottom.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto top = mTop.load(std::memory_order_relaxed);
+        auto result = top <= bottom;
+        if (result) {
+            *pValue = mupBuffer[bottom & mMask].load(std::memory_order_relaxed);
+            if (top == bottom) {
+                result = mTop.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+                mBottom.store(bottom + 1, std::memory_order_relaxed);
+            }
+        } else {
+            mBottom.store(bottom + 1, std::memory_order_relaxed);
+        }
+        return result;
+    }
+
+    bool steal(T* pValue)
+    {
+        assert(pValue);
+        auto top = mTop.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto bottom = mBottom.load(std::memory_order_acquire);
+        if (top < bottom) {
+            auto value = mupBuffer[top & mMask].load(std::memory_order_relaxed);
+            if (mTop.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                *pValue = value;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool empty() const
+    {
+        return mBottom.load(std::memory_order_relaxed) <= mTop.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::unique_ptr<std::atomic<T>[]> mupBuffer;
+    int64_t mMask { 0 };
+    alignas(64) std::atomic<int64_t> mTop { 0 };
+    alignas(64) std::atomic<int64_t> mBottom { 0 };
+};
+
+class JobCounter final
+{
+public:
+    bool is_complete() const
+    {
+        return !mCount.load(std::memory_order_acquire);
+    }
+
+private:
+    std::atomic<uint32_t> mCount { 0 };
+    friend class JobSystem;
+};
+
+class JobSystem final
+{
+public:
+    struct CreateInfo final
+    {
+        // The number of worker threads to create in addition to the thread that
+        //  creates the JobSystem, 0 creates one less than the hardware thread count
+        uint32_t workerCount { 0 };
+        uint32_t maxJobCount { 4096 };
+    };
+
+    static void create(const CreateInfo* pCreateInfo, JobSystem* pJobSystem);
+
+    ~JobSystem();
+
+    uint32_t get_thread_count() const;
+
+    // Schedules function on the calling thread's queue and increments pCounter
+    //  until it completes.  May be called from the thread that created the
+    //  JobSystem or from within a job.  Jobs run inline when the queue is full.
+    void run(JobCounter* pCounter, std::function<void()> function);
+
+    // Executes queued jobs on the calling thread until pCounter completes.
+    void wait(JobCounter* pCounter);
+
+    // Calls function(begin, end) over subranges of [0, count).  Ranges are split
+    //  in half whenever the calling thread's queue has been drained by thieves
+    //  so idle threads get work without oversubscribing the queues, ranges are
+    //  never split below minGrainSize.
+    // FROM : Tzannes, Caragea, Barua, Vishkin - "Lazy Binary-Splitting"
+    template <typename FunctionType>
+    inline void parallel_for(size_t count, size_t minGrainSize, FunctionType function)
+    {
+        JobCounter counter;
+        parallel_for_range(&counter, 0, count, std::max(minGrainSize, (size_t)1), function);
+        wait(&counter);
+    }
+
+    void reset();
+
+private:
+    struct Job final
+    {
+        std::function<void()> function;
+        JobCounter* pCounter { nullptr };
+        std::atomic<bool> pending { false };
+    };
+
+    struct Worker final
+    {
+        Worker(size_t maxJobCount);
+        WorkStealingDeque<Job*> deque;
+        std::unique_ptr<Job[]> upJobs;
+        size_t jobCount { 0 };
+        size_t jobIndex { 0 };
+        uint32_t randomState { 0 };
+        std::thread thread;
+    };
+
+    template <typename FunctionType>
+    inline void parallel_for_range(JobCounter* pCounter, size_t begin, size_t end, size_t minGrainSize, FunctionType& function)
+    {
+        while (begin < end) {
+            if (minGrainSize < end - begin && is_local_queue_empty()) {
+                auto middle = begin + (end - begin) / 2;
+                run(pCounter, [this, pCounter, middle, end, minGrainSize, &function]() { parallel_for_range(pCounter, middle, end, minGrainSize, function); });
+                end = middle;
+            } else {
+                auto chunkEnd = std::min(begin + minGrainSize, end);
+                function(begin, chunkEnd);
+                begin = chunkEnd;
+            }
+        }
+    }
+
+    Worker& get_local_worker();
+    bool is_local_queue_empty();
+    bool try_execute_job(Worker& worker);
+    void execute_job(Job* pJob);
+    void worker_main(uint32_t workerIndex);
+
+    std::vector<std::unique_ptr<Worker>> mWorkers;
+    std::thread::id mMainThreadId;
+    std::atomic<bool> mRunning { false };
+    std::atomic<uint32_t> mQueuedJobCount { 0 };
+    std::atomic<uint32_t> mSleepingWorkerCount { 0 };
+    std::mutex mMutex;
+    std::condition_variable mConditionVariable;
+};
+
+} // namespace dst
@@ -0,0 +1,129 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#pragma once
+
+#include "dynamic-static/defines.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace dst {
+
+template <typename T, size_t ChunkSize = 64>
+class Pool final
+{
+public:
+    // Fixed size object pool.  Objects are constructed in chunks of ChunkSize
+    //  nodes and never move, free nodes are threaded through an intrusive free
+    //  list so acquire() and release() are O(1) and only allocate when every
+    //  chunk is full.  All objects must be released before reset().
+    static_assert(ChunkSize);
+
+    Pool() = default;
+    Pool(const Pool&) = delete;
+    Pool& operator=(const Pool&) = delete;
+
+    ~Pool()
+    {
+        reset();
+    }
+
+    template <typename... ArgTypes>
+    inline T* acquire(ArgTypes&&... args)
+    {
+        if (!mpFreeNode) {
+            allocate_chunk();
+        }
+        auto pNode = mpFreeNode;
+        mpFreeNode = pNode->pNext;
+        ++mSize;
+        return new (pNode->storage) T(std::forward<ArgTypes>(args)...);
+    }
+
+    inline void release(T* pObject)
+    {
+        assert(pObject);
+        assert(mSize);
+        pObject->~T();
+        auto pNode = new (pObject) Node;
+        pNode->pNext = mpFreeNode;
+        mpFreeNode = pNode;
+        --mSize;
+    }
+
+    inline size_t size() const
+    {
+        return mSize;
+    }
+
+    inline size_t capacity() const
+    {
+        return mupChunks.size() * ChunkSize;
+    }
+
+    inline void reserve(size_t capacity)
+    {
+        while (this->capacity() < capacity) {
+            allocate_chunk();
+        }
+    }
+
+    inline void reset()
+    {
+        assert(!mSize);
+        mupChunks.clear();
+        mpFreeNode = nullptr;
+        mSize = 0;
+    }
+
+private:
+    union Node
+    {
+        Node* pNext;
+        alignas(T) std::byte storage[sizeof(T)];
+    };
+
+    inline void allocate_chunk()
+    {
+        mupChunks.push_back(std::make_unique<Node[]>(ChunkSize));
+        auto pChunk = mupChunks.back().get();
+        for (size_t i = ChunkSize; i--;) {
+            pChunk[i].pNext = mpFreeNode;
+            mpFreeNode = &pChunk[i];
+        }
+    }
+
+    std::vector<std::unique_ptr<Node[]>> mupChunks;
+    Node* mpFreeNode { nullptr };
+    size_t mSize { 0 };
+};
+
+} // namespace dst
@@ -0,0 +1,124 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#pragma once
+
+#include "dynamic-static/defines.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <ostream>
+#include <vector>
+
+#ifdef DST_PROFILER_ENABLED
+#define dst_profiler_concatenate_impl(LHS, RHS) LHS##RHS
+#define dst_profiler_concatenate(LHS, RHS) dst_profiler_concatenate_impl(LHS, RHS)
+#define dst_profile_scope(NAME) dst::profiler::Scope dst_profiler_concatenate(dstProfilerScope, __LINE__) { NAME }
+#define dst_profile_function() dst_profile_scope(__func__)
+#define dst_profile_frame() dst::profiler::begin_frame()
+#else
+#define dst_profile_scope(NAME)
+#define dst_profile_function()
+#define dst_profile_frame()
+#endif
+
+namespace dst {
+namespace profiler {
+
+// Zones are recorded into a fixed size ring buffer owned by the recording thread,
+//  writers never lock and never allocate after a thread's first zone.  Readers
+//  (get_events(), get_frame_summary() and write_chrome_trace()) may run while
+//  other threads record, events overwritten during a read are discarded.  Once
+//  a thread has recorded EventCapacity events since the last clear() its oldest
+//  event may be mid overwrite, so reads return at most EventCapacity - 1 events
+//  per thread.  Zone names must outlive the profiler, string literals and
+//  __func__ are expected.
+// NOTE : The dst_profile_*() macros compile to nothing unless DST_PROFILER_ENABLED
+//  is defined, the functions below are always available.
+
+constexpr uint64_t EventCapacity = 16384;
+
+struct Event final
+{
+    const char* pName { nullptr };
+    uint64_t beginTimestamp { 0 };
+    uint64_t endTimestamp { 0 };
+    uint32_t threadIndex { 0 };
+    uint32_t depth { 0 };
+};
+
+struct ZoneSummary final
+{
+    const char* pName { nullptr };
+    uint32_t callCount { 0 };
+    double totalMilliseconds { 0 };
+    double maxMilliseconds { 0 };
+};
+
+namespace detail {
+
+uint64_t begin_zone();
+void end_zone(const char* pName, uint64_t beginTimestamp);
+
+} // namespace detail
+
+class Scope final
+{
+public:
+    inline Scope(const char* pName)
+        : mpName { pName }
+        , mBeginTimestamp { detail::begin_zone() }
+    {
+    }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+    inline ~Scope()
+    {
+        detail::end_zone(mpName, mBeginTimestamp);
+    }
+
+private:
+    const char* mpName { nullptr };
+    uint64_t mBeginTimestamp { 0 };
+};
+
+// Timestamps are TSC ticks on x86 and steady_clock nanoseconds elsewhere.
+uint64_t get_timestamp();
+double get_milliseconds(uint64_t beginTimestamp, uint64_t endTimestamp);
+
+// Marks the start of a frame, get_frame_summary() reports on the zones that
+//  completed during the frame that this call ends.
+void begin_frame();
+void get_frame_summary(std::vector<ZoneSummary>* pZoneSummaries);
+void get_events(std::vector<Event>* pEvents);
+void write_chrome_trace(std::ostream& stream);
+bool write_chrome_trace(const std::filesystem::path& filePath);
+void clear();
+
+} // namespace profiler
+} // namespace dst
@@ -0,0 +1,182 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#pragma once
+
+#include "dynamic-static/defines.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace dst {
+
+template <typename T>
+class SpscQueue final
+{
+public:
+    // Bounded single producer, single consumer ring.  push() may only be called
+    //  by one thread and pop() by one other thread.  Each side caches the other
+    //  side's index so the shared cache lines are only read when the ring looks
+    //  full or empty.
+    SpscQueue(size_t capacity = 1024)
+        : mupBuffer { std::make_unique<T[]>(std::bit_ceil(std::max(capacity, (size_t)1))) }
+        , mMask { std::bit_ceil(std::max(capacity, (size_t)1)) - 1 }
+    {
+    }
+
+    bool push(T value)
+    {
+        auto tail = mTail.load(std::memory_order_relaxed);
+        if (mMask < tail - mCachedHead) {
+            mCachedHead = mHead.load(std::memory_order_acquire);
+            if (mMask < tail - mCachedHead) {
+                return false;
+            }
+        }
+        mupBuffer[tail & mMask] = std::move(value);
+        mTail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T* pValue)
+    {
+        assert(pValue);
+        auto head = mHead.load(std::memory_order_relaxed);
+        if (head == mCachedTail) {
+            mCachedTail = mTail.load(std::memory_order_acquire);
+            if (head == mCachedTail) {
+                return false;
+            }
+        }
+        *pValue = std::move(mupBuffer[head & mMask]);
+        mHead.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t get_capacity() const
+    {
+        return mMask + 1;
+    }
+
+    bool empty() const
+    {
+        return mTail.load(std::memory_order_acquire) == mHead.load(std::memory_order_acquire);
+    }
+
+private:
+    std::unique_ptr<T[]> mupBuffer;
+    size_t mMask { 0 };
+    alignas(64) std::atomic<size_t> mHead { 0 };
+    size_t mCachedTail { 0 };
+    alignas(64) std::atomic<size_t> mTail { 0 };
+    size_t mCachedHead { 0 };
+};
+
+template <typename T>
+class MpmcQueue final
+{
+public:
+    // Bounded multi producer, multi consumer ring.  Each cell carries a sequence
+    //  number that tells producers and consumers whether it's free for the lap
+    //  they're on, so push() and pop() are a single CAS in the uncontended case.
+    // FROM : Vyukov - "Bounded MPMC queue"
+    MpmcQueue(size_t capacity = 1024)
+        : mupCells { std::make_unique<Cell[]>(std::bit_ceil(std::max(capacity, (size_t)2))) }
+        , mMask { std::bit_ceil(std::max(capacity, (size_t)2)) - 1 }
+    {
+        for (size_t i = 0; i <= mMask; ++i) {
+            mupCells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    bool push(T value)
+    {
+        auto position = mTail.load(std::memory_order_relaxed);
+        while (true) {
+            auto& cell = mupCells[position & mMask];
+            auto sequence = cell.sequence.load(std::memory_order_acquire);
+            auto difference = (intptr_t)sequence - (intptr_t)position;
+            if (!difference) {
+                if (mTail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    cell.value = std::move(value);
+                    cell.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (difference < 0) {
+                return false;
+            } else {
+                position = mTail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool pop(T* pValue)
+    {
+        assert(pValue);
+        auto position = mHead.load(std::memory_order_relaxed);
+        while (true) {
+            auto& cell = mupCells[position & mMask];
+            auto sequence = cell.sequence.load(std::memory_order_acquire);
+            auto difference = (intptr_t)sequence - (intptr_t)(position + 1);
+            if (!difference) {
+                if (mHead.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    *pValue = std::move(cell.value);
+                    cell.sequence.store(position + mMask + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (difference < 0) {
+                return false;
+            } else {
+                position = mHead.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    size_t get_capacity() const
+    {
+        return mMask + 1;
+    }
+
+private:
+    struct Cell final
+    {
+        std::atomic<size_t> sequence { 0 };
+        T value { };
+    };
+
+    std::unique_ptr<Cell[]> mupCells;
+    size_t mMask { 0 };
+    alignas(64) std::atomic<size_t> mHead { 0 };
+    alignas(64) std::atomic<size_t> mTail { 0 };
+};
+
+} // namespace dst
@@ -0,0 +1,402 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#pragma once
+
+#include "dynamic-static/defines.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace dst {
+
+// Entities are generational indices with no data of their own, components are
+//  stored in one SparseSet per component type.  Each SparseSet keeps its
+//  components and their owning Entities densely packed so systems iterate
+//  contiguous arrays of only the components they need.  Adding or removing a
+//  component is O(1), removal moves the last component into the removed
+//  component's place.  Pointers and references to components are invalidated
+//  when components of the same type are added or removed, Entities are not.
+struct Entity final
+{
+    uint32_t index { std::numeric_limits<uint32_t>::max() };
+    uint32_t generation { 0 };
+
+    inline bool operator==(const Entity&) const = default;
+};
+
+class SparseSetBase
+{
+public:
+    SparseSetBase() = default;
+    SparseSetBase(const SparseSetBase&) = delete;
+    SparseSetBase& operator=(const SparseSetBase&) = delete;
+    virtual ~SparseSetBase() = default;
+
+    inline bool contains(Entity entity) const
+    {
+        return get_dense_index(entity) != InvalidIndex;
+    }
+
+    // Gets the Entities that own this SparseSet's components, in the same order
+    //  as the components.
+    inline const Entity* get_entities() const { return mEntities.data(); }
+    inline size_t size() const { return mEntities.size(); }
+    inline bool empty() const { return mEntities.empty(); }
+
+    virtual bool erase(Entity entity) = 0;
+    virtual void clear() = 0;
+
+protected:
+    static constexpr uint32_t InvalidIndex = std::numeric_limits<uint32_t>::max();
+
+    inline uint32_t get_dense_index(Entity entity) const
+    {
+        if (entity.index < mSparse.size()) {
+            auto denseIndex = mSparse[entity.index];
+            if (denseIndex != InvalidIndex && mEntities[denseIndex] == entity) {
+                return denseIndex;
+            }
+        }
+        return InvalidIndex;
+    }
+
+    inline uint32_t insert_entity(Entity entity)
+    {
+        assert(!contains(entity));
+        if (mSparse.size() <= entity.index) {
+            mSparse.resize((size_t)entity.index + 1, InvalidIndex);
+        }
+        auto denseIndex = (uint32_t)mEntities.size();
+        mSparse[entity.index] = denseIndex;
+        mEntities.push_back(entity);
+        return denseIndex;
+    }
+
+    inline void erase_entity(uint32_t denseIndex)
+    {
+        auto lastIndex = (uint32_t)mEntities.size() - 1;
+        mSparse[mEntities[denseIndex].index] = InvalidIndex;
+        if (denseIndex != lastIndex) {
+            mEntities[denseIndex] = mEntities[lastIndex];
+            mSparse[mEntities[denseIndex].index] = denseIndex;
+        }
+        mEntities.pop_back();
+    }
+
+    std::vector<uint32_t> mSparse;
+    std::vector<Entity> mEntities;
+};
+
+template <typename T>
+class SparseSet final
+    : public SparseSetBase
+{
+public:
+    using iterator = typename std::vector<T>::iterator;
+    using const_iterator = typename std::vector<T>::const_iterator;
+
+    template <typename... ArgTypes>
+    inline T& emplace(Entity entity, ArgTypes&&... args)
+    {
+        insert_entity(entity);
+        return mComponents.emplace_back(std::forward<ArgTypes>(args)...);
+    }
+
+    inline bool erase(Entity entity) override final
+    {
+        auto denseIndex = get_dense_index(entity);
+        if (denseIndex == InvalidIndex) {
+            return false;
+        }
+        if (denseIndex != mComponents.size() - 1) {
+            mComponents[denseIndex] = std::move(mComponents.back());
+        }
+        mComponents.pop_back();
+        erase_entity(denseIndex);
+        return true;
+    }
+
+    inline void clear() override final
+    {
+        for (const auto& entity : mEntities) {
+            mSparse[entity.index] = InvalidIndex;
+        }
+        mEntities.clear();
+        mComponents.clear();
+    }
+
+    inline T* get(Entity entity)
+    {
+        auto denseIndex = get_dense_index(entity);
+        return denseIndex != InvalidIndex ? &mComponents[denseIndex] : nullptr;
+    }
+
+    inline const T* get(Entity entity) const
+    {
+        auto denseIndex = get_dense_index(entity);
+        return denseIndex != InvalidIndex ? &mComponents[denseIndex] : nullptr;
+    }
+
+    inline T& operator[](size_t index)
+    {
+        assert(index < mComponents.size());
+        return mComponents[index];
+    }
+
+    inline const T& operator[](size_t index) const
+    {
+        assert(index < mComponents.size());
+        return mComponents[index];
+    }
+
+    inline T* data() { return mComponents.data(); }
+    inline const T* data() const { return mComponents.data(); }
+    inline iterator begin() { return mComponents.begin(); }
+    inline iterator end() { return mComponents.end(); }
+    inline const_iterator begin() const { return mComponents.begin(); }
+    inline const_iterator end() const { return mComponents.end(); }
+
+    inline void reserve(size_t capacity)
+    {
+        mEntities.reserve(capacity);
+        mComponents.reserve(capacity);
+    }
+
+private:
+    std::vector<T> mComponents;
+};
+
+class Registry final
+{
+public:
+    template <typename... ComponentTypes>
+    class View final
+    {
+    public:
+        // Calls function(Entity, ComponentTypes&...) for every Entity that has all of
+        //  ComponentTypes.  Iteration is driven by the smallest SparseSet and runs
+        //  back to front, so function() may destroy the current Entity or remove its
+        //  components.  function() must not add components of ComponentTypes.
+        template <typename FunctionType>
+        inline void each(FunctionType function) const
+        {
+            std::apply(
+                [&](SparseSet<ComponentTypes>*... pStorages)
+                {
+                    if ((pStorages && ...)) {
+                        const SparseSetBase* pBaseStorages[] { pStorages... };
+                        auto pLeadStorage = *std::min_element(std::begin(pBaseStorages), std::end(pBaseStorages),
+                            [](const SparseSetBase* pLhs, const SparseSetBase* pRhs) { return pLhs->size() < pRhs->size(); }
+                        );
+                        for (size_t i = pLeadStorage->size(); i--;) {
+                            if (i < pLeadStorage->size()) {
+                                auto entity = pLeadStorage->get_entities()[i];
+                                std::tuple<ComponentTypes*...> pComponents { get_component(pStorages, pLeadStorage, i, entity)... };
+                                if ((std::get<ComponentTypes*>(pComponents) && ...)) {
+                                    function(entity, *std::get<ComponentTypes*>(pComponents)...);
+                                }
+                            }
+                        }
+                    }
+                },
+                mpStorages
+            );
+        }
+
+    private:
+        template <typename T>
+        static inline T* get_component(SparseSet<T>* pStorage, const SparseSetBase* pLeadStorage, size_t index, Entity entity)
+        {
+            // The lead SparseSet's component is at the current index, others need a
+            //  sparse lookup.
+            return pStorage == pLeadStorage ? &(*pStorage)[index] : pStorage->get(entity);
+        }
+
+        View(SparseSet<ComponentTypes>*... pStorages)
+            : mpStorages { pStorages... }
+        {
+        }
+
+        std::tuple<SparseSet<ComponentTypes>*...> mpStorages;
+        friend class Registry;
+    };
+
+    Registry() = default;
+    Registry(const Registry&) = delete;
+    Registry& operator=(const Registry&) = delete;
+
+    inline Entity create_entity()
+    {
+        uint32_t index = 0;
+        if (mFreeIndices.empty()) {
+            index = (uint32_t)mGenerations.size();
+            mGenerations.push_back(0);
+        } else {
+            index = mFreeIndices.back();
+            mFreeIndices.pop_back();
+        }
+        return { index, mGenerations[index] };
+    }
+
+    // Removes all of the given Entity's components and invalidates the Entity.
+    //  This is O(n) in the number of component types that have been used with this
+    //  Registry.
+    inline bool destroy_entity(Entity entity)
+    {
+        if (!is_alive(entity)) {
+            return false;
+        }
+        for (const auto& upStorage : mupStorages) {
+            if (upStorage) {
+                upStorage->erase(entity);
+            }
+        }
+        ++mGenerations[entity.index];
+        mFreeIndices.push_back(entity.index);
+        return true;
+    }
+
+    inline bool is_alive(Entity entity) const
+    {
+        return entity.index < mGenerations.size() && mGenerations[entity.index] == entity.generation;
+    }
+
+    inline size_t size() const
+    {
+        return mGenerations.size() - mFreeIndices.size();
+    }
+
+    template <typename T, typename... ArgTypes>
+    inline T& emplace(Entity entity, ArgTypes&&... args)
+    {
+        assert(is_alive(entity));
+        return get_storage<T>().emplace(entity, std::forward<ArgTypes>(args)...);
+    }
+
+    template <typename T>
+    inline bool remove(Entity entity)
+    {
+        auto pStorage = find_storage<T>();
+        return pStorage && pStorage->erase(entity);
+    }
+
+    template <typename T>
+    inline bool has(Entity entity) const
+    {
+        auto pStorage = find_storage<T>();
+        return pStorage && pStorage->contains(entity);
+    }
+
+    template <typename T>
+    inline T* get(Entity entity)
+    {
+        auto pStorage = find_storage<T>();
+        return pStorage ? pStorage->get(entity) : nullptr;
+    }
+
+    template <typename T>
+    inline const T* get(Entity entity) const
+    {
+        auto pStorage = find_storage<T>();
+        return pStorage ? pStorage->get(entity) : nullptr;
+    }
+
+    // Gets the SparseSet for the given component type, creating it if necessary.
+    //  Systems that only need one component type should iterate the SparseSet
+    //  directly.
+    template <typename T>
+    inline SparseSet<T>& get_storage()
+    {
+        auto typeIndex = get_component_type_index<T>();
+        if (mupStorages.size() <= typeIndex) {
+            mupStorages.resize((size_t)typeIndex + 1);
+        }
+        auto& upStorage = mupStorages[typeIndex];
+        if (!upStorage) {
+            upStorage = std::make_unique<SparseSet<T>>();
+        }
+        return static_cast<SparseSet<T>&>(*upStorage);
+    }
+
+    template <typename... ComponentTypes>
+    inline View<ComponentTypes...> view()
+    {
+        return View<ComponentTypes...>(find_storage<ComponentTypes>()...);
+    }
+
+    template <typename... ComponentTypes, typename FunctionType>
+    inline void each(FunctionType function)
+    {
+        view<ComponentTypes...>().each(function);
+    }
+
+    // Destroys every Entity.  Entities created before clear() don't resolve after
+    //  it.
+    inline void clear()
+    {
+        for (const auto& upStorage : mupStorages) {
+            if (upStorage) {
+                upStorage->clear();
+            }
+        }
+        mFreeIndices.clear();
+        for (auto index = (uint32_t)mGenerations.size(); index--;) {
+            ++mGenerations[index];
+            mFreeIndices.push_back(index);
+        }
+    }
+
+private:
+    template <typename T>
+    inline SparseSet<T>* find_storage() const
+    {
+        auto typeIndex = get_component_type_index<T>();
+        return typeIndex < mupStorages.size() ? static_cast<SparseSet<T>*>(mupStorages[typeIndex].get()) : nullptr;
+    }
+
+    template <typename T>
+    static inline uint32_t get_component_type_index()
+    {
+        static const uint32_t sTypeIndex = sComponentTypeCount++;
+        return sTypeIndex;
+    }
+
+    std::vector<std::unique_ptr<SparseSetBase>> mupStorages;
+    std::vector<uint32_t> mGenerations;
+    std::vector<uint32_t> mFreeIndices;
+    static inline std::atomic<uint32_t> sComponentTypeCount { 0 };
+};
+
+} // namespace dst
@@ -0,0 +1,188 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#pragma once
+
+#include "dynamic-static/defines.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace dst {
+
+template <typename T>
+class SlotMap final
+{
+public:
+    // Values are stored densely for contiguous iteration, Handles index an
+    //  indirection table of slots.  Erasing moves the last value into the erased
+    //  value's place and bumps the erased slot's generation so stale Handles no
+    //  longer resolve.  Pointers and iterators to values are invalidated by
+    //  insert() and erase(), Handles are not.
+    struct Handle final
+    {
+        uint32_t index { std::numeric_limits<uint32_t>::max() };
+        uint32_t generation { 0 };
+
+        inline bool operator==(const Handle&) const = default;
+    };
+
+    using iterator = typename std::vector<T>::iterator;
+    using const_iterator = typename std::vector<T>::const_iterator;
+
+    template <typename... ArgTypes>
+    inline Handle emplace(ArgTypes&&... args)
+    {
+        auto slotIndex = mFreeSlotIndex;
+        if (slotIndex == InvalidIndex) {
+            slotIndex = (uint32_t)mSlots.size();
+            mSlots.push_back({ });
+        } else {
+            mFreeSlotIndex = mSlots[slotIndex].index;
+        }
+        auto& slot = mSlots[slotIndex];
+        slot.index = (uint32_t)mValues.size();
+        mValues.emplace_back(std::forward<ArgTypes>(args)...);
+        mValueSlots.push_back(slotIndex);
+        return { slotIndex, slot.generation };
+    }
+
+    inline Handle insert(T value)
+    {
+        return emplace(std::move(value));
+    }
+
+    inline bool erase(Handle handle)
+    {
+        if (!contains(handle)) {
+            return false;
+        }
+        auto& slot = mSlots[handle.index];
+        auto valueIndex = slot.index;
+        auto lastIndex = (uint32_t)mValues.size() - 1;
+        if (valueIndex != lastIndex) {
+            mValues[valueIndex] = std::move(mValues[lastIndex]);
+            mValueSlots[valueIndex] = mValueSlots[lastIndex];
+            mSlots[mValueSlots[valueIndex]].index = valueIndex;
+        }
+        mValues.pop_back();
+        mValueSlots.pop_back();
+        ++slot.generation;
+        slot.index = mFreeSlotIndex;
+        mFreeSlotIndex = handle.index;
+        return true;
+    }
+
+    inline bool contains(Handle handle) const
+    {
+        if (handle.index < mSlots.size()) {
+            const auto& slot = mSlots[handle.index];
+            return slot.generation == handle.generation && slot.index < mValueSlots.size() && mValueSlots[slot.index] == handle.index;
+        }
+        return false;
+    }
+
+    inline T* get(Handle handle)
+    {
+        return contains(handle) ? &mValues[mSlots[handle.index].index] : nullptr;
+    }
+
+    inline const T* get(Handle handle) const
+    {
+        return contains(handle) ? &mValues[mSlots[handle.index].index] : nullptr;
+    }
+
+    // Gets the Handle of the value at the given dense index.
+    inline Handle get_handle(size_t index) const
+    {
+        assert(index < mValueSlots.size());
+        auto slotIndex = mValueSlots[index];
+        return { slotIndex, mSlots[slotIndex].generation };
+    }
+
+    inline T& operator[](size_t index)
+    {
+        assert(index < mValues.size());
+        return mValues[index];
+    }
+
+    inline const T& operator[](size_t index) const
+    {
+        assert(index < mValues.size());
+        return mValues[index];
+    }
+
+    inline size_t size() const { return mValues.size(); }
+    inline bool empty() const { return mValues.empty(); }
+    inline T* data() { return mValues.data(); }
+    inline const T* data() const { return mValues.data(); }
+    inline iterator begin() { return mValues.begin(); }
+    inline iterator end() { return mValues.end(); }
+    inline const_iterator begin() const { return mValues.begin(); }
+    inline const_iterator end() const { return mValues.end(); }
+
+    inline void reserve(size_t capacity)
+    {
+        mValues.reserve(capacity);
+        mValueSlots.reserve(capacity);
+        mSlots.reserve(capacity);
+    }
+
+    inline void clear()
+    {
+        // Every slot moves to the free list with a new generation so Handles from
+        //  before clear() don't resolve to values inserted after it.
+        for (auto slotIndex : mValueSlots) {
+            auto& slot = mSlots[slotIndex];
+            ++slot.generation;
+            slot.index = mFreeSlotIndex;
+            mFreeSlotIndex = slotIndex;
+        }
+        mValues.clear();
+        mValueSlots.clear();
+    }
+
+private:
+    static constexpr uint32_t InvalidIndex = std::numeric_limits<uint32_t>::max();
+
+    struct Slot final
+    {
+        // Index of the value for occupied slots, next free slot for free slots
+        uint32_t index { InvalidIndex };
+        uint32_t generation { 0 };
+    };
+
+    std::vector<T> mValues;
+    std::vector<uint32_t> mValueSlots;
+    std::vector<Slot> mSlots;
+    uint32_t mFreeSlotIndex { InvalidIndex };
+};
+
+} // namespace dst
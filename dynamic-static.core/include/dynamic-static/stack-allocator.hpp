@@ -0,0 +1,90 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#pragma once
+
+#include "dynamic-static/defines.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+
+namespace dst {
+
+class StackAllocator final
+    : public std::pmr::memory_resource
+{
+public:
+    using Marker = size_t;
+
+    struct CreateInfo final
+    {
+        size_t size { 256 * 1024 };
+        std::pmr::memory_resource* pUpstream { nullptr };
+    };
+
+    // Fixed capacity stack, allocations are reclaimed by rewinding to a Marker
+    //  taken before they were made.  Allocations that don't fit go to upstream
+    //  and are returned to upstream when deallocated.
+    class Scope final
+    {
+    public:
+        Scope(StackAllocator& stackAllocator);
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+        ~Scope();
+
+    private:
+        StackAllocator& mStackAllocator;
+        Marker mMarker { 0 };
+    };
+
+    static void create(const CreateInfo* pCreateInfo, StackAllocator* pStackAllocator);
+
+    StackAllocator() = default;
+    StackAllocator(const StackAllocator&) = delete;
+    StackAllocator& operator=(const StackAllocator&) = delete;
+    ~StackAllocator();
+
+    Marker get_marker() const;
+    size_t get_capacity() const;
+    size_t get_overflow_count() const;
+    void rewind(Marker marker);
+    void reset();
+
+private:
+    void* do_allocate(size_t size, size_t alignment) override final;
+    void do_deallocate(void* pData, size_t size, size_t alignment) override final;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override final;
+
+    std::pmr::memory_resource* mpUpstream { nullptr };
+    std::byte* mpData { nullptr };
+    size_t mSize { 0 };
+    size_t mOffset { 0 };
+    size_t mOverflowCount { 0 };
+};
+
+} // namespace dst
@@ -0,0 +1,121 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+
+#pragma once
+
+#include "dynamic-static/defines.hpp"
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace dst {
+
+class TlsfAllocator final
+{
+public:
+    using Handle = uint32_t;
+    static constexpr Handle InvalidHandle { std::numeric_limits<Handle>::max() };
+
+    struct CreateInfo final
+    {
+        uint64_t size { 0 };
+    };
+
+    struct Move final
+    {
+        Handle handle { InvalidHandle };
+        uint64_t srcOffset { 0 };
+        uint64_t dstOffset { 0 };
+        uint64_t size { 0 };
+    };
+
+    // Two level segregated fit offset allocator, it manages offsets into a range
+    //  of some resource, ie. elements of a GPU buffer, without touching the
+    //  resource.  Free blocks are binned by size into power of two classes each
+    //  split into linear subclasses, bitmaps of non empty bins make allocate() and
+    //  free() constant time.  Freed blocks coalesce with free neighbours.  Handles
+    //  stay valid until freed, including across defragment().
+    // FROM : Masmano, Ripoll, Crespo, Real - "TLSF: a New Dynamic Memory Allocator for Real-Time Systems"
+    static void create(const CreateInfo* pCreateInfo, TlsfAllocator* pTlsfAllocator);
+
+    uint64_t get_size() const;
+    uint64_t get_used_size() const;
+    uint32_t get_allocation_count() const;
+    uint32_t get_free_block_count() const;
+    uint64_t get_offset(Handle handle) const;
+    uint64_t get_size(Handle handle) const;
+
+    // Returns InvalidHandle if no free block can hold size.
+    Handle allocate(uint64_t size);
+    void free(Handle handle);
+
+    // Packs every allocation toward offset 0 in offset order, leaving one free
+    //  block at the end.  Allocations that move are appended to pMoves with their
+    //  old and new offsets, callers copy the moved data to match.  Moves are
+    //  ordered by srcOffset and every dstOffset is at or below its srcOffset.
+    void defragment(std::vector<Move>* pMoves);
+
+    void reset();
+
+private:
+    static constexpr uint32_t SubclassCountLog2 { 4 };
+    static constexpr uint32_t SubclassCount { 1 << SubclassCountLog2 };
+    static constexpr uint32_t ClassCount { 64 - SubclassCountLog2 + 1 };
+
+    struct Block final
+    {
+        uint64_t offset { 0 };
+        uint64_t size { 0 };
+        Handle prevPhysical { InvalidHandle };
+        Handle nextPhysical { InvalidHandle };
+        Handle prevFree { InvalidHandle };
+        Handle nextFree { InvalidHandle };
+        bool free { false };
+    };
+
+    static void get_bin(uint64_t size, uint32_t* pClass, uint32_t* pSubclass);
+    Handle create_block(uint64_t offset, uint64_t size);
+    void destroy_block(Handle handle);
+    void insert_free_block(Handle handle);
+    void remove_free_block(Handle handle);
+    Handle find_free_block(uint64_t size) const;
+
+    uint64_t mSize { 0 };
+    uint64_t mUsedSize { 0 };
+    uint32_t mAllocationCount { 0 };
+    uint32_t mFreeBlockCount { 0 };
+    uint64_t mClassBitmap { 0 };
+    std::array<uint32_t, ClassCount> mSubclassBitmaps { };
+    std::array<std::array<Handle, SubclassCount>, ClassCount> mFreeLists { };
+    std::vector<Block> mBlocks;
+    std::vector<Handle> mUnusedBlocks;
+    Handle mFirstBlock { InvalidHandle };
+};
+
+} // namespace dst
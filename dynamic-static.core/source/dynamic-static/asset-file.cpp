@@ -0,0 +1,300 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#include "dynamic-static/asset-file.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <fstream>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace dst {
+
+static const uint8_t* map_file(const std::filesystem::path& filePath, bool prefetch, bool copyOnWrite, size_t* pSize)
+{
+    assert(pSize);
+    *pSize = 0;
+    const uint8_t* pData = nullptr;
+#ifdef _WIN32
+    auto fileHandle = CreateFileW(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, prefetch ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_FLAG_RANDOM_ACCESS, nullptr);
+    if (fileHandle != INVALID_HANDLE_VALUE) {
+        LARGE_INTEGER fileSize { };
+        if (GetFileSizeEx(fileHandle, &fileSize) && fileSize.QuadPart) {
+            // The view keeps the mapping alive after both handles are closed.
+            auto mappingHandle = CreateFileMappingW(fileHandle, nullptr, copyOnWrite ? PAGE_WRITECOPY : PAGE_READONLY, 0, 0, nullptr);
+            if (mappingHandle) {
+                pData = (const uint8_t*)MapViewOfFile(mappingHandle, copyOnWrite ? FILE_MAP_COPY : FILE_MAP_READ, 0, 0, 0);
+                if (pData) {
+                    *pSize = (size_t)fileSize.QuadPart;
+                    if (prefetch) {
+                        WIN32_MEMORY_RANGE_ENTRY memoryRange { (void*)pData, *pSize };
+                        PrefetchVirtualMemory(GetCurrentProcess(), 1, &memoryRange, 0);
+                    }
+                }
+                CloseHandle(mappingHandle);
+            }
+        }
+        CloseHandle(fileHandle);
+    }
+#else
+    auto fileDescriptor = ::open(filePath.c_str(), O_RDONLY);
+    if (fileDescriptor != -1) {
+        struct stat fileStatus { };
+        if (!fstat(fileDescriptor, &fileStatus) && 0 < fileStatus.st_size) {
+            // The mapping stays valid after the file descriptor is closed.
+            auto pMapping = mmap(nullptr, (size_t)fileStatus.st_size, copyOnWrite ? PROT_READ | PROT_WRITE : PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+            if (pMapping != MAP_FAILED) {
+                pData = (const uint8_t*)pMapping;
+                *pSize = (size_t)fileStatus.st_size;
+                madvise(pMapping, *pSize, prefetch ? MADV_WILLNEED : MADV_RANDOM);
+            }
+        }
+        ::close(fileDescriptor);
+    }
+#endif
+    return pData;
+}
+
+static void unmap_file(const uint8_t* pData, size_t size)
+{
+    if (pData) {
+#ifdef _WIN32
+        (void)size;
+        UnmapViewOfFile(pData);
+#else
+        munmap((void*)pData, size);
+#endif
+    }
+}
+
+bool AssetFile::create(const CreateInfo* pCreateInfo, AssetFile* pAssetFile)
+{
+    assert(pCreateInfo);
+    assert(pAssetFile);
+    pAssetFile->reset();
+    size_t size = 0;
+    auto pData = map_file(pCreateInfo->filePath, pCreateInfo->prefetch, pCreateInfo->copyOnWrite, &size);
+    if (pData && validate({ pData, size })) {
+        pAssetFile->mpData = pData;
+        pAssetFile->mSize = size;
+        pAssetFile->mCopyOnWrite = pCreateInfo->copyOnWrite;
+        return true;
+    }
+    unmap_file(pData, size);
+    return false;
+}
+
+bool AssetFile::validate(std::span<const uint8_t> data)
+{
+    // Every offset and size is checked against the data's size without overflow
+    //  so a truncated or corrupt file can't produce out of bounds spans.
+    if (data.size() < sizeof(Header)) {
+        return false;
+    }
+    Header header { };
+    memcpy(&header, data.data(), sizeof(Header));
+    if (header.magic != Magic || header.version != Version || header.fileSize != data.size()) {
+        return false;
+    }
+    if (header.sectionTableOffset % alignof(Section) || data.size() < header.sectionTableOffset) {
+        return false;
+    }
+    if ((data.size() - header.sectionTableOffset) / sizeof(Section) < header.sectionCount) {
+        return false;
+    }
+    for (uint32_t section_i = 0; section_i < header.sectionCount; ++section_i) {
+        Section section { };
+        memcpy(&section, data.data() + header.sectionTableOffset + section_i * sizeof(Section), sizeof(Section));
+        if (section.offset % SectionAlignment || data.size() < section.offset || data.size() - section.offset < section.size) {
+            return false;
+        }
+    }
+    return true;
+}
+
+AssetFile::AssetFile(AssetFile&& other) noexcept
+{
+    *this = std::move(other);
+}
+
+AssetFile& AssetFile::operator=(AssetFile&& other) noexcept
+{
+    if (this != &other) {
+        reset();
+        mpData = std::exchange(other.mpData, nullptr);
+        mSize = std::exchange(other.mSize, 0);
+        mCopyOnWrite = std::exchange(other.mCopyOnWrite, false);
+    }
+    return *this;
+}
+
+AssetFile::~AssetFile()
+{
+    reset();
+}
+
+const AssetFile::Header* AssetFile::get_header() const
+{
+    return (const Header*)mpData;
+}
+
+std::span<const AssetFile::Section> AssetFile::get_sections() const
+{
+    auto pHeader = get_header();
+    if (pHeader) {
+        return { (const Section*)(mpData + pHeader->sectionTableOffset), pHeader->sectionCount };
+    }
+    return { };
+}
+
+const AssetFile::Section* AssetFile::find_section(uint32_t type, uint32_t id) const
+{
+    for (const auto& section : get_sections()) {
+        if (section.type == type && section.id == id) {
+            return &section;
+        }
+    }
+    return nullptr;
+}
+
+std::span<const uint8_t> AssetFile::get_section_data(const Section& section) const
+{
+    assert(mpData);
+    assert(section.offset + section.size <= mSize);
+    return { mpData + section.offset, (size_t)section.size };
+}
+
+std::span<uint8_t> AssetFile::get_mutable_section_data(const Section& section)
+{
+    assert(mCopyOnWrite);
+    assert(mpData);
+    assert(section.offset + section.size <= mSize);
+    return { const_cast<uint8_t*>(mpData) + section.offset, (size_t)section.size };
+}
+
+std::span<const uint8_t> AssetFile::get_data() const
+{
+    return { mpData, mSize };
+}
+
+bool AssetFile::is_copy_on_write() const
+{
+    return mCopyOnWrite;
+}
+
+void AssetFile::reset()
+{
+    unmap_file(mpData, mSize);
+    mpData = nullptr;
+    mSize = 0;
+    mCopyOnWrite = false;
+}
+
+void AssetFileWriter::add_section(uint32_t type, uint32_t id, const void* pData, size_t size, uint32_t stride)
+{
+    assert(pData || !size);
+    auto itr = std::find_if(mSections.begin(), mSections.end(),
+        [&](const PendingSection& pendingSection)
+        {
+            return pendingSection.section.type == type && pendingSection.section.id == id;
+        }
+    );
+    if (itr == mSections.end()) {
+        itr = mSections.insert(mSections.end(), PendingSection { });
+    }
+    itr->section.type = type;
+    itr->section.id = id;
+    itr->section.size = size;
+    itr->section.stride = stride;
+    itr->data.assign((const uint8_t*)pData, (const uint8_t*)pData + size);
+}
+
+size_t AssetFileWriter::get_section_count() const
+{
+    return mSections.size();
+}
+
+void AssetFileWriter::write(std::vector<uint8_t>* pData) const
+{
+    assert(pData);
+    auto align = [](uint64_t offset) { return (offset + AssetFile::SectionAlignment - 1) & ~(uint64_t)(AssetFile::SectionAlignment - 1); };
+    AssetFile::Header header { };
+    header.sectionCount = (uint32_t)mSections.size();
+    header.sectionTableOffset = sizeof(AssetFile::Header);
+    std::vector<AssetFile::Section> sections(mSections.size());
+    uint64_t offset = header.sectionTableOffset + sections.size() * sizeof(AssetFile::Section);
+    for (size_t section_i = 0; section_i < mSections.size(); ++section_i) {
+        offset = align(offset);
+        sections[section_i] = mSections[section_i].section;
+        sections[section_i].offset = offset;
+        offset += sections[section_i].size;
+    }
+    header.fileSize = offset;
+    pData->assign((size_t)header.fileSize, 0);
+    memcpy(pData->data(), &header, sizeof(header));
+    if (!sections.empty()) {
+        memcpy(pData->data() + header.sectionTableOffset, sections.data(), sections.size() * sizeof(AssetFile::Section));
+    }
+    for (size_t section_i = 0; section_i < mSections.size(); ++section_i) {
+        if (!mSections[section_i].data.empty()) {
+            memcpy(pData->data() + sections[section_i].offset, mSections[section_i].data.data(), mSections[section_i].data.size());
+        }
+    }
+}
+
+bool AssetFileWriter::write(const std::filesystem::path& filePath) const
+{
+    std::vector<uint8_t> data;
+    write(&data);
+    std::ofstream file(filePath, std::ios::binary);
+    if (file.is_open()) {
+        file.write((const char*)data.data(), (std::streamsize)data.size());
+    }
+    return file.good();
+}
+
+void AssetFileWriter::clear()
+{
+    mSections.clear();
+}
+
+} // namespace dst
@@ -0,0 +1,400 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#pragma once
+
+#include "dynamic-static/batch-math.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+// Generic kernels shared by every instruction set.  Each instruction set's
+//  translation unit provides an Isa type, defined in an anonymous namespace,
+//  with the following members...
+//      using Float, using Mask, static constexpr size_t Width,
+//      load(), store(), set(), add(), sub(), mul(), min(), max(), abs(), less(),
+//      mask_or(), and get_mask_bits()
+//  ...and instantiates these templates with it.  Instantiations are local to
+//  the translation unit they're compiled in, so code compiled for one
+//  instruction set can't be linked into another.  Translation units compiled
+//  with instruction set specific flags must not instantiate standard library
+//  templates for the same reason.
+
+namespace dst {
+namespace batch {
+namespace detail {
+
+struct Kernels final
+{
+    InstructionSet instructionSet { InstructionSet::Scalar };
+    void (*pfnComposeTransforms)(size_t count, const TransformSoa<const float>& parents, const TransformSoa<const float>& locals, const TransformSoa<float>& results) { nullptr };
+    void (*pfnCreateMatrices)(size_t count, const TransformSoa<const float>& transforms, float* pMatrices) { nullptr };
+    void (*pfnTransformAabbs)(size_t count, const AabbSoa<const float>& aabbs, const TransformSoa<const float>& transforms, const AabbSoa<float>& results) { nullptr };
+    void (*pfnMergeAabbs)(size_t count, const AabbSoa<const float>& aabbs, Aabb* pResult) { nullptr };
+    size_t (*pfnCullSpheres)(const float* pPlanes, size_t planeCount, size_t count, const SphereSoa<const float>& spheres, uint8_t* pVisible) { nullptr };
+    size_t (*pfnCullAabbs)(const float* pPlanes, size_t planeCount, size_t count, const AabbSoa<const float>& aabbs, uint8_t* pVisible) { nullptr };
+};
+
+// Each returns nullptr when its instruction set isn't available on the target
+//  architecture.
+const Kernels* get_scalar_kernels();
+const Kernels* get_sse2_kernels();
+const Kernels* get_avx2_kernels();
+const Kernels* get_neon_kernels();
+
+template <typename Isa, size_t InputCount, size_t OutputCount, typename BlockFunctionType>
+inline void for_each_block(size_t count, const float* const (&ppInputs)[InputCount], float* const (&ppOutputs)[OutputCount], BlockFunctionType blockFunction)
+{
+    // Calls blockFunction() with Width elements loaded from each input stream and
+    //  stores Width elements to each output stream.  The final partial block is
+    //  zero padded through a local buffer.  Every input is loaded before any
+    //  output is stored so outputs may alias inputs.
+    typename Isa::Float inputs[InputCount];
+    typename Isa::Float outputs[OutputCount];
+    size_t i = 0;
+    for (; i + Isa::Width <= count; i += Isa::Width) {
+        for (size_t input_i = 0; input_i < InputCount; ++input_i) {
+            inputs[input_i] = Isa::load(ppInputs[input_i] + i);
+        }
+        blockFunction(inputs, outputs);
+        for (size_t output_i = 0; output_i < OutputCount; ++output_i) {
+            Isa::store(ppOutputs[output_i] + i, outputs[output_i]);
+        }
+    }
+    if (i < count) {
+        auto remaining = count - i;
+        float buffer[Isa::Width] { };
+        for (size_t input_i = 0; input_i < InputCount; ++input_i) {
+            memcpy(buffer, ppInputs[input_i] + i, remaining * sizeof(float));
+            inputs[input_i] = Isa::load(buffer);
+        }
+        blockFunction(inputs, outputs);
+        for (size_t output_i = 0; output_i < OutputCount; ++output_i) {
+            Isa::store(buffer, outputs[output_i]);
+            memcpy(ppOutputs[output_i] + i, buffer, remaining * sizeof(float));
+        }
+    }
+}
+
+template <typename Isa>
+inline void rotate(
+    const typename Isa::Float* pRotation,
+    const typename Isa::Float* pVector,
+    typename Isa::Float* pResult
+)
+{
+    // v' = v + w * t + cross(u, t) where t = 2 * cross(u, v)
+    auto two = Isa::set(2);
+    auto tx = Isa::mul(two, Isa::sub(Isa::mul(pRotation[1], pVector[2]), Isa::mul(pRotation[2], pVector[1])));
+    auto ty = Isa::mul(two, Isa::sub(Isa::mul(pRotation[2], pVector[0]), Isa::mul(pRotation[0], pVector[2])));
+    auto tz = Isa::mul(two, Isa::sub(Isa::mul(pRotation[0], pVector[1]), Isa::mul(pRotation[1], pVector[0])));
+    pResult[0] = Isa::add(Isa::add(pVector[0], Isa::mul(pRotation[3], tx)), Isa::sub(Isa::mul(pRotation[1], tz), Isa::mul(pRotation[2], ty)));
+    pResult[1] = Isa::add(Isa::add(pVector[1], Isa::mul(pRotation[3], ty)), Isa::sub(Isa::mul(pRotation[2], tx), Isa::mul(pRotation[0], tz)));
+    pResult[2] = Isa::add(Isa::add(pVector[2], Isa::mul(pRotation[3], tz)), Isa::sub(Isa::mul(pRotation[0], ty), Isa::mul(pRotation[1], tx)));
+}
+
+template <typename Isa>
+inline void get_rotation_matrix(const typename Isa::Float* pRotation, typename Isa::Float* pMatrix)
+{
+    // Writes the column major 3x3 rotation matrix for a unit quaternion.
+    auto one = Isa::set(1);
+    auto two = Isa::set(2);
+    auto xs = Isa::mul(pRotation[0], two);
+    auto ys = Isa::mul(pRotation[1], two);
+    auto zs = Isa::mul(pRotation[2], two);
+    auto wx = Isa::mul(pRotation[3], xs);
+    auto wy = Isa::mul(pRotation[3], ys);
+    auto wz = Isa::mul(pRotation[3], zs);
+    auto xx = Isa::mul(pRotation[0], xs);
+    auto xy = Isa::mul(pRotation[0], ys);
+    auto xz = Isa::mul(pRotation[0], zs);
+    auto yy = Isa::mul(pRotation[1], ys);
+    auto yz = Isa::mul(pRotation[1], zs);
+    auto zz = Isa::mul(pRotation[2], zs);
+    pMatrix[0] = Isa::sub(one, Isa::add(yy, zz));
+    pMatrix[1] = Isa::add(xy, wz);
+    pMatrix[2] = Isa::sub(xz, wy);
+    pMatrix[3] = Isa::sub(xy, wz);
+    pMatrix[4] = Isa::sub(one, Isa::add(xx, zz));
+    pMatrix[5] = Isa::add(yz, wx);
+    pMatrix[6] = Isa::add(xz, wy);
+    pMatrix[7] = Isa::sub(yz, wx);
+    pMatrix[8] = Isa::sub(one, Isa::add(xx, yy));
+}
+
+template <typename Isa>
+inline void compose_transforms(size_t count, const TransformSoa<const float>& parents, const TransformSoa<const float>& locals, const TransformSoa<float>& results)
+{
+    const float* const ppInputs[] {
+        parents.positions.pX, parents.positions.pY, parents.positions.pZ,
+        parents.rotations.pX, parents.rotations.pY, parents.rotations.pZ, parents.rotations.pW,
+        locals.positions.pX, locals.positions.pY, locals.positions.pZ,
+        locals.rotations.pX, locals.rotations.pY, locals.rotations.pZ, locals.rotations.pW,
+    };
+    float* const ppOutputs[] {
+        results.positions.pX, results.positions.pY, results.positions.pZ,
+        results.rotations.pX, results.rotations.pY, results.rotations.pZ, results.rotations.pW,
+    };
+    for_each_block<Isa>(count, ppInputs, ppOutputs,
+        [](const typename Isa::Float* pInputs, typename Isa::Float* pOutputs)
+        {
+            const auto* pParentPosition = pInputs;
+            const auto* pParentRotation = pInputs + 3;
+            const auto* pLocalPosition = pInputs + 7;
+            const auto* pLocalRotation = pInputs + 10;
+            rotate<Isa>(pParentRotation, pLocalPosition, pOutputs);
+            for (size_t i = 0; i < 3; ++i) {
+                pOutputs[i] = Isa::add(pParentPosition[i], pOutputs[i]);
+            }
+            const auto& ax = pParentRotation[0];
+            const auto& ay = pParentRotation[1];
+            const auto& az = pParentRotation[2];
+            const auto& aw = pParentRotation[3];
+            const auto& bx = pLocalRotation[0];
+            const auto& by = pLocalRotation[1];
+            const auto& bz = pLocalRotation[2];
+            const auto& bw = pLocalRotation[3];
+            pOutputs[3] = Isa::sub(Isa::add(Isa::add(Isa::mul(aw, bx), Isa::mul(ax, bw)), Isa::mul(ay, bz)), Isa::mul(az, by));
+            pOutputs[4] = Isa::add(Isa::add(Isa::sub(Isa::mul(aw, by), Isa::mul(ax, bz)), Isa::mul(ay, bw)), Isa::mul(az, bx));
+            pOutputs[5] = Isa::add(Isa::sub(Isa::add(Isa::mul(aw, bz), Isa::mul(ax, by)), Isa::mul(ay, bx)), Isa::mul(az, bw));
+            pOutputs[6] = Isa::sub(Isa::sub(Isa::sub(Isa::mul(aw, bw), Isa::mul(ax, bx)), Isa::mul(ay, by)), Isa::mul(az, bz));
+        }
+    );
+}
+
+template <typename Isa>
+inline void create_matrices(size_t count, const TransformSoa<const float>& transforms, float* pMatrices)
+{
+    // Rotation matrices are computed into a local SoA buffer a chunk at a time
+    //  then interleaved with positions into the output.
+    constexpr size_t ChunkSize = 64;
+    float rotationMatrices[9][ChunkSize];
+    for (size_t chunk_i = 0; chunk_i < count; chunk_i += ChunkSize) {
+        auto chunkCount = count - chunk_i < ChunkSize ? count - chunk_i : ChunkSize;
+        const float* const ppInputs[] {
+            transforms.rotations.pX + chunk_i, transforms.rotations.pY + chunk_i, transforms.rotations.pZ + chunk_i, transforms.rotations.pW + chunk_i,
+        };
+        float* const ppOutputs[] {
+            rotationMatrices[0], rotationMatrices[1], rotationMatrices[2],
+            rotationMatrices[3], rotationMatrices[4], rotationMatrices[5],
+            rotationMatrices[6], rotationMatrices[7], rotationMatrices[8],
+        };
+        for_each_block<Isa>(chunkCount, ppInputs, ppOutputs,
+            [](const typename Isa::Float* pInputs, typename Isa::Float* pOutputs)
+            {
+                get_rotation_matrix<Isa>(pInputs, pOutputs);
+            }
+        );
+        for (size_t i = 0; i < chunkCount; ++i) {
+            auto* pMatrix = pMatrices + (chunk_i + i) * 16;
+            pMatrix[0] = rotationMatrices[0][i];
+            pMatrix[1] = rotationMatrices[1][i];
+            pMatrix[2] = rotationMatrices[2][i];
+            pMatrix[3] = 0;
+            pMatrix[4] = rotationMatrices[3][i];
+            pMatrix[5] = rotationMatrices[4][i];
+            pMatrix[6] = rotationMatrices[5][i];
+            pMatrix[7] = 0;
+            pMatrix[8] = rotationMatrices[6][i];
+            pMatrix[9] = rotationMatrices[7][i];
+            pMatrix[10] = rotationMatrices[8][i];
+            pMatrix[11] = 0;
+            pMatrix[12] = transforms.positions.pX[chunk_i + i];
+            pMatrix[13] = transforms.positions.pY[chunk_i + i];
+            pMatrix[14] = transforms.positions.pZ[chunk_i + i];
+            pMatrix[15] = 1;
+        }
+    }
+}
+
+template <typename Isa>
+inline void transform_aabbs(size_t count, const AabbSoa<const float>& aabbs, const TransformSoa<const float>& transforms, const AabbSoa<float>& results)
+{
+    // FROM : Arvo - "Transforming Axis-Aligned Bounding Boxes" (Graphics Gems)
+    const float* const ppInputs[] {
+        aabbs.mins.pX, aabbs.mins.pY, aabbs.mins.pZ,
+        aabbs.maxs.pX, aabbs.maxs.pY, aabbs.maxs.pZ,
+        transforms.positions.pX, transforms.positions.pY, transforms.positions.pZ,
+        transforms.rotations.pX, transforms.rotations.pY, transforms.rotations.pZ, transforms.rotations.pW,
+    };
+    float* const ppOutputs[] {
+        results.mins.pX, results.mins.pY, results.mins.pZ,
+        results.maxs.pX, results.maxs.pY, results.maxs.pZ,
+    };
+    for_each_block<Isa>(count, ppInputs, ppOutputs,
+        [](const typename Isa::Float* pInputs, typename Isa::Float* pOutputs)
+        {
+            typename Isa::Float rotation[9];
+            get_rotation_matrix<Isa>(pInputs + 9, rotation);
+            auto half = Isa::set(0.5f);
+            typename Isa::Float center[3];
+            typename Isa::Float extent[3];
+            for (size_t i = 0; i < 3; ++i) {
+                center[i] = Isa::mul(Isa::add(pInputs[i], pInputs[3 + i]), half);
+                extent[i] = Isa::mul(Isa::sub(pInputs[3 + i], pInputs[i]), half);
+            }
+            for (size_t row_i = 0; row_i < 3; ++row_i) {
+                const auto& r0 = rotation[row_i];
+                const auto& r1 = rotation[3 + row_i];
+                const auto& r2 = rotation[6 + row_i];
+                auto transformedCenter = Isa::add(Isa::add(Isa::add(Isa::mul(r0, center[0]), Isa::mul(r1, center[1])), Isa::mul(r2, center[2])), pInputs[6 + row_i]);
+                auto transformedExtent = Isa::add(Isa::add(Isa::mul(Isa::abs(r0), extent[0]), Isa::mul(Isa::abs(r1), extent[1])), Isa::mul(Isa::abs(r2), extent[2]));
+                pOutputs[row_i] = Isa::sub(transformedCenter, transformedExtent);
+                pOutputs[3 + row_i] = Isa::add(transformedCenter, transformedExtent);
+            }
+        }
+    );
+}
+
+template <typename Isa>
+inline void merge_aabbs(size_t count, const AabbSoa<const float>& aabbs, Aabb* pResult)
+{
+    // Lanes are reduced separately then combined.  The remaining elements are
+    //  merged one at a time using the same comparisons as Isa::min()/max().
+    const float* const ppMins[] { aabbs.mins.pX, aabbs.mins.pY, aabbs.mins.pZ };
+    const float* const ppMaxs[] { aabbs.maxs.pX, aabbs.maxs.pY, aabbs.maxs.pZ };
+    constexpr float Infinity = std::numeric_limits<float>::infinity();
+    for (size_t axis_i = 0; axis_i < 3; ++axis_i) {
+        auto min = Isa::set(Infinity);
+        auto max = Isa::set(-Infinity);
+        size_t i = 0;
+        for (; i + Isa::Width <= count; i += Isa::Width) {
+            min = Isa::min(min, Isa::load(ppMins[axis_i] + i));
+            max = Isa::max(max, Isa::load(ppMaxs[axis_i] + i));
+        }
+        float mins[Isa::Width];
+        float maxs[Isa::Width];
+        Isa::store(mins, min);
+        Isa::store(maxs, max);
+        pResult->min[axis_i] = Infinity;
+        pResult->max[axis_i] = -Infinity;
+        for (size_t lane_i = 0; lane_i < Isa::Width; ++lane_i) {
+            pResult->min[axis_i] = mins[lane_i] < pResult->min[axis_i] ? mins[lane_i] : pResult->min[axis_i];
+            pResult->max[axis_i] = pResult->max[axis_i] < maxs[lane_i] ? maxs[lane_i] : pResult->max[axis_i];
+        }
+        for (; i < count; ++i) {
+            pResult->min[axis_i] = ppMins[axis_i][i] < pResult->min[axis_i] ? ppMins[axis_i][i] : pResult->min[axis_i];
+            pResult->max[axis_i] = pResult->max[axis_i] < ppMaxs[axis_i][i] ? ppMaxs[axis_i][i] : pResult->max[axis_i];
+        }
+    }
+}
+
+template <typename Isa, size_t InputCount, typename BlockFunctionType>
+inline size_t cull(size_t count, const float* const (&ppInputs)[InputCount], uint8_t* pVisible, BlockFunctionType blockFunction)
+{
+    // blockFunction() returns a Mask of culled elements.  The final partial block
+    //  is zero padded and only the remaining elements' results are written.
+    size_t visibleCount = 0;
+    typename Isa::Float inputs[InputCount];
+    for (size_t i = 0; i < count; i += Isa::Width) {
+        auto blockCount = count - i < Isa::Width ? count - i : Isa::Width;
+        if (blockCount == Isa::Width) {
+            for (size_t input_i = 0; input_i < InputCount; ++input_i) {
+                inputs[input_i] = Isa::load(ppInputs[input_i] + i);
+            }
+        } else {
+            float buffer[Isa::Width] { };
+            for (size_t input_i = 0; input_i < InputCount; ++input_i) {
+                memcpy(buffer, ppInputs[input_i] + i, blockCount * sizeof(float));
+                inputs[input_i] = Isa::load(buffer);
+            }
+        }
+        auto culledBits = Isa::get_mask_bits(blockFunction(inputs));
+        for (size_t lane_i = 0; lane_i < blockCount; ++lane_i) {
+            pVisible[i + lane_i] = (uint8_t)(!((culledBits >> lane_i) & 1));
+            visibleCount += pVisible[i + lane_i];
+        }
+    }
+    return visibleCount;
+}
+
+template <typename Isa>
+inline size_t cull_spheres(const float* pPlanes, size_t planeCount, size_t count, const SphereSoa<const float>& spheres, uint8_t* pVisible)
+{
+    const float* const ppInputs[] { spheres.centers.pX, spheres.centers.pY, spheres.centers.pZ, spheres.pRadii };
+    return cull<Isa>(count, ppInputs, pVisible,
+        [&](const typename Isa::Float* pInputs)
+        {
+            auto negativeRadius = Isa::sub(Isa::set(0), pInputs[3]);
+            auto culled = Isa::less(Isa::set(1), Isa::set(0));
+            for (size_t plane_i = 0; plane_i < planeCount; ++plane_i) {
+                const auto* pPlane = pPlanes + plane_i * 4;
+                auto distance = Isa::add(Isa::add(Isa::add(Isa::mul(Isa::set(pPlane[0]), pInputs[0]), Isa::mul(Isa::set(pPlane[1]), pInputs[1])), Isa::mul(Isa::set(pPlane[2]), pInputs[2])), Isa::set(pPlane[3]));
+                culled = Isa::mask_or(culled, Isa::less(distance, negativeRadius));
+            }
+            return culled;
+        }
+    );
+}
+
+template <typename Isa>
+inline size_t cull_aabbs(const float* pPlanes, size_t planeCount, size_t count, const AabbSoa<const float>& aabbs, uint8_t* pVisible)
+{
+    const float* const ppInputs[] {
+        aabbs.mins.pX, aabbs.mins.pY, aabbs.mins.pZ,
+        aabbs.maxs.pX, aabbs.maxs.pY, aabbs.maxs.pZ,
+    };
+    return cull<Isa>(count, ppInputs, pVisible,
+        [&](const typename Isa::Float* pInputs)
+        {
+            // Test the AABB corner furthest along the plane normal, the corner is
+            //  selected per plane so no per lane selects are needed.
+            auto zero = Isa::set(0);
+            auto culled = Isa::less(Isa::set(1), zero);
+            for (size_t plane_i = 0; plane_i < planeCount; ++plane_i) {
+                const auto* pPlane = pPlanes + plane_i * 4;
+                const auto& x = 0 <= pPlane[0] ? pInputs[3] : pInputs[0];
+                const auto& y = 0 <= pPlane[1] ? pInputs[4] : pInputs[1];
+                const auto& z = 0 <= pPlane[2] ? pInputs[5] : pInputs[2];
+                auto distance = Isa::add(Isa::add(Isa::add(Isa::mul(Isa::set(pPlane[0]), x), Isa::mul(Isa::set(pPlane[1]), y)), Isa::mul(Isa::set(pPlane[2]), z)), Isa::set(pPlane[3]));
+                culled = Isa::mask_or(culled, Isa::less(distance, zero));
+            }
+            return culled;
+        }
+    );
+}
+
+template <typename Isa>
+constexpr Kernels create_kernels(InstructionSet instructionSet)
+{
+    // Kernels must be constant initialized, dynamic initialization would run
+    //  instruction set specific code before support has been checked.
+    Kernels kernels { };
+    kernels.instructionSet = instructionSet;
+    kernels.pfnComposeTransforms = compose_transforms<Isa>;
+    kernels.pfnCreateMatrices = create_matrices<Isa>;
+    kernels.pfnTransformAabbs = transform_aabbs<Isa>;
+    kernels.pfnMergeAabbs = merge_aabbs<Isa>;
+    kernels.pfnCullSpheres = cull_spheres<Isa>;
+    kernels.pfnCullAabbs = cull_aabbs<Isa>;
+    return kernels;
+}
+
+} // namespace detail
+} // namespace batch
+} // namespace dst
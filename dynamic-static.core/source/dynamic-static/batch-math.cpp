@@ -0,0 +1,237 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#include "dynamic-static/batch-math.hpp"
+#include "batch-math-kernels.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define DST_BATCH_MATH_X86
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace dst {
+namespace batch {
+namespace {
+
+struct Scalar final
+{
+    using Float = float;
+    using Mask = bool;
+    static constexpr size_t Width = 1;
+    static inline Float load(const float* pData) { return *pData; }
+    static inline void store(float* pData, Float value) { *pData = value; }
+    static inline Float set(float value) { return value; }
+    static inline Float add(Float lhs, Float rhs) { return lhs + rhs; }
+    static inline Float sub(Float lhs, Float rhs) { return lhs - rhs; }
+    static inline Float mul(Float lhs, Float rhs) { return lhs * rhs; }
+    static inline Float min(Float lhs, Float rhs) { return lhs < rhs ? lhs : rhs; }
+    static inline Float max(Float lhs, Float rhs) { return lhs > rhs ? lhs : rhs; }
+    static inline Float abs(Float value) { return std::fabs(value); }
+    static inline Mask less(Float lhs, Float rhs) { return lhs < rhs; }
+    static inline Mask mask_or(Mask lhs, Mask rhs) { return lhs || rhs; }
+    static inline uint32_t get_mask_bits(Mask mask) { return mask ? 1 : 0; }
+};
+
+constexpr detail::Kernels ScalarKernels = detail::create_kernels<Scalar>(InstructionSet::Scalar);
+
+#ifdef DST_BATCH_MATH_X86
+void cpuid(uint32_t leaf, uint32_t subleaf, uint32_t* pRegisters)
+{
+#ifdef _MSC_VER
+    int registers[4] { };
+    __cpuidex(registers, (int)leaf, (int)subleaf);
+    for (int i = 0; i < 4; ++i) {
+        pRegisters[i] = (uint32_t)registers[i];
+    }
+#else
+    if (!__get_cpuid_count(leaf, subleaf, &pRegisters[0], &pRegisters[1], &pRegisters[2], &pRegisters[3])) {
+        pRegisters[0] = pRegisters[1] = pRegisters[2] = pRegisters[3] = 0;
+    }
+#endif
+}
+
+uint64_t xgetbv(uint32_t index)
+{
+#ifdef _MSC_VER
+    return _xgetbv(index);
+#else
+    uint32_t eax = 0;
+    uint32_t edx = 0;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(index));
+    return ((uint64_t)edx << 32) | eax;
+#endif
+}
+#endif // DST_BATCH_MATH_X86
+
+bool is_cpu_supported(InstructionSet instructionSet)
+{
+    switch (instructionSet) {
+    case InstructionSet::Scalar: {
+        return true;
+    } break;
+#ifdef DST_BATCH_MATH_X86
+    case InstructionSet::Sse2: {
+        uint32_t registers[4] { };
+        cpuid(1, 0, registers);
+        return registers[3] & (1u << 26);
+    } break;
+    case InstructionSet::Avx2: {
+        // AVX2 needs the CPU to support it and the OS to save YMM registers.
+        uint32_t registers[4] { };
+        cpuid(0, 0, registers);
+        if (registers[0] < 7) {
+            return false;
+        }
+        cpuid(1, 0, registers);
+        const uint32_t OsxsaveAvx = (1u << 27) | (1u << 28);
+        if ((registers[2] & OsxsaveAvx) != OsxsaveAvx || (xgetbv(0) & 0x6) != 0x6) {
+            return false;
+        }
+        cpuid(7, 0, registers);
+        return registers[1] & (1u << 5);
+    } break;
+#else
+    case InstructionSet::Neon: {
+        return true;
+    } break;
+#endif
+    default: {
+        return false;
+    } break;
+    }
+}
+
+const detail::Kernels* get_kernels(InstructionSet instructionSet)
+{
+    if (is_cpu_supported(instructionSet)) {
+        switch (instructionSet) {
+        case InstructionSet::Scalar: return detail::get_scalar_kernels();
+        case InstructionSet::Sse2: return detail::get_sse2_kernels();
+        case InstructionSet::Avx2: return detail::get_avx2_kernels();
+        case InstructionSet::Neon: return detail::get_neon_kernels();
+        default: break;
+        }
+    }
+    return nullptr;
+}
+
+std::atomic<const detail::Kernels*> spKernels;
+
+const detail::Kernels& get_kernels()
+{
+    auto pKernels = spKernels.load(std::memory_order_acquire);
+    if (!pKernels) {
+        pKernels = get_kernels(get_supported_instruction_set());
+        spKernels.store(pKernels, std::memory_order_release);
+    }
+    return *pKernels;
+}
+
+} // namespace
+
+namespace detail {
+
+const Kernels* get_scalar_kernels()
+{
+    return &ScalarKernels;
+}
+
+} // namespace detail
+
+bool is_supported(InstructionSet instructionSet)
+{
+    return get_kernels(instructionSet) != nullptr;
+}
+
+InstructionSet get_supported_instruction_set()
+{
+    for (auto instructionSet : { InstructionSet::Avx2, InstructionSet::Sse2, InstructionSet::Neon }) {
+        if (is_supported(instructionSet)) {
+            return instructionSet;
+        }
+    }
+    return InstructionSet::Scalar;
+}
+
+InstructionSet get_instruction_set()
+{
+    return get_kernels().instructionSet;
+}
+
+void set_instruction_set(InstructionSet instructionSet)
+{
+    auto pKernels = get_kernels(instructionSet);
+    assert(pKernels && "dst::batch::set_instruction_set() called with an unsupported InstructionSet");
+    if (pKernels) {
+        spKernels.store(pKernels, std::memory_order_release);
+    }
+}
+
+void compose_transforms(size_t count, TransformSoa<const float> parents, TransformSoa<const float> locals, TransformSoa<float> results)
+{
+    get_kernels().pfnComposeTransforms(count, parents, locals, results);
+}
+
+void create_matrices(size_t count, TransformSoa<const float> transforms, float* pMatrices)
+{
+    assert(!count || pMatrices);
+    get_kernels().pfnCreateMatrices(count, transforms, pMatrices);
+}
+
+void transform_aabbs(size_t count, AabbSoa<const float> aabbs, TransformSoa<const float> transforms, AabbSoa<float> results)
+{
+    get_kernels().pfnTransformAabbs(count, aabbs, transforms, results);
+}
+
+Aabb merge_aabbs(size_t count, AabbSoa<const float> aabbs)
+{
+    Aabb aabb { };
+    get_kernels().pfnMergeAabbs(count, aabbs, &aabb);
+    return aabb;
+}
+
+size_t cull_spheres(std::span<const Plane> planes, size_t count, SphereSoa<const float> spheres, uint8_t* pVisible)
+{
+    assert(!count || pVisible);
+    return get_kernels().pfnCullSpheres(planes.empty() ? nullptr : planes[0].data(), planes.size(), count, spheres, pVisible);
+}
+
+size_t cull_aabbs(std::span<const Plane> planes, size_t count, AabbSoa<const float> aabbs, uint8_t* pVisible)
+{
+    assert(!count || pVisible);
+    return get_kernels().pfnCullAabbs(planes.empty() ? nullptr : planes[0].data(), planes.size(), count, aabbs, pVisible);
+}
+
+} // namespace batch
+} // namespace dst
@@ -0,0 +1,85 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#include "batch-math-kernels.hpp"
+
+#if defined(__ARM_NEON) || defined(_M_ARM64)
+#define DST_BATCH_MATH_NEON
+#include <arm_neon.h>
+#endif
+
+namespace dst {
+namespace batch {
+namespace detail {
+
+#ifdef DST_BATCH_MATH_NEON
+namespace {
+
+struct Neon final
+{
+    using Float = float32x4_t;
+    using Mask = uint32x4_t;
+    static constexpr size_t Width = 4;
+    static inline Float load(const float* pData) { return vld1q_f32(pData); }
+    static inline void store(float* pData, Float value) { vst1q_f32(pData, value); }
+    static inline Float set(float value) { return vdupq_n_f32(value); }
+    static inline Float add(Float lhs, Float rhs) { return vaddq_f32(lhs, rhs); }
+    static inline Float sub(Float lhs, Float rhs) { return vsubq_f32(lhs, rhs); }
+    static inline Float mul(Float lhs, Float rhs) { return vmulq_f32(lhs, rhs); }
+    static inline Float min(Float lhs, Float rhs) { return vminq_f32(lhs, rhs); }
+    static inline Float max(Float lhs, Float rhs) { return vmaxq_f32(lhs, rhs); }
+    static inline Float abs(Float value) { return vabsq_f32(value); }
+    static inline Mask less(Float lhs, Float rhs) { return vcltq_f32(lhs, rhs); }
+    static inline Mask mask_or(Mask lhs, Mask rhs) { return vorrq_u32(lhs, rhs); }
+
+    static inline uint32_t get_mask_bits(Mask mask)
+    {
+        return
+            (vgetq_lane_u32(mask, 0) & 1) |
+            (vgetq_lane_u32(mask, 1) & 2) |
+            (vgetq_lane_u32(mask, 2) & 4) |
+            (vgetq_lane_u32(mask, 3) & 8);
+    }
+};
+
+constexpr Kernels NeonKernels = create_kernels<Neon>(InstructionSet::Neon);
+
+} // namespace
+
+const Kernels* get_neon_kernels()
+{
+    return &NeonKernels;
+}
+#else
+const Kernels* get_neon_kernels()
+{
+    return nullptr;
+}
+#endif // DST_BATCH_MATH_NEON
+
+} // namespace detail
+} // namespace batch
+} // namespace dst
@@ -0,0 +1,77 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#include "batch-math-kernels.hpp"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define DST_BATCH_MATH_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace dst {
+namespace batch {
+namespace detail {
+
+#ifdef DST_BATCH_MATH_SSE2
+namespace {
+
+struct Sse2 final
+{
+    using Float = __m128;
+    using Mask = __m128;
+    static constexpr size_t Width = 4;
+    static inline Float load(const float* pData) { return _mm_loadu_ps(pData); }
+    static inline void store(float* pData, Float value) { _mm_storeu_ps(pData, value); }
+    static inline Float set(float value) { return _mm_set1_ps(value); }
+    static inline Float add(Float lhs, Float rhs) { return _mm_add_ps(lhs, rhs); }
+    static inline Float sub(Float lhs, Float rhs) { return _mm_sub_ps(lhs, rhs); }
+    static inline Float mul(Float lhs, Float rhs) { return _mm_mul_ps(lhs, rhs); }
+    static inline Float min(Float lhs, Float rhs) { return _mm_min_ps(lhs, rhs); }
+    static inline Float max(Float lhs, Float rhs) { return _mm_max_ps(lhs, rhs); }
+    static inline Float abs(Float value) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), value); }
+    static inline Mask less(Float lhs, Float rhs) { return _mm_cmplt_ps(lhs, rhs); }
+    static inline Mask mask_or(Mask lhs, Mask rhs) { return _mm_or_ps(lhs, rhs); }
+    static inline uint32_t get_mask_bits(Mask mask) { return (uint32_t)_mm_movemask_ps(mask); }
+};
+
+constexpr Kernels Sse2Kernels = create_kernels<Sse2>(InstructionSet::Sse2);
+
+} // namespace
+
+const Kernels* get_sse2_kernels()
+{
+    return &Sse2Kernels;
+}
+#else
+const Kernels* get_sse2_kernels()
+{
+    return nullptr;
+}
+#endif // DST_BATCH_MATH_SSE2
+
+} // namespace detail
+} // namespace batch
+} // namespace dst
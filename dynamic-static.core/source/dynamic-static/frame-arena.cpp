@@ -0,0 +1,181 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#include "dynamic-static/frame-arena.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <memory>
+
+namespace dst {
+
+void FrameArena::create(const CreateInfo* pCreateInfo, FrameArena* pFrameArena)
+{
+    assert(pCreateInfo);
+    assert(pCreateInfo->blockSize);
+    assert(pFrameArena);
+    pFrameArena->reset();
+    pFrameArena->mpUpstream = pCreateInfo->pUpstream ? pCreateInfo->pUpstream : std::pmr::new_delete_resource();
+    pFrameArena->mBlockSize = pCreateInfo->blockSize;
+    pFrameArena->allocate_block(pCreateInfo->blockSize);
+}
+
+FrameArena::~FrameArena()
+{
+    reset();
+}
+
+size_t FrameArena::get_used_size() const
+{
+    size_t usedSize = mOffset;
+    for (size_t block_i = 0; block_i < mBlockIndex && block_i < mBlocks.size(); ++block_i) {
+        usedSize += mBlocks[block_i].size;
+    }
+    return usedSize;
+}
+
+size_t FrameArena::get_capacity() const
+{
+    size_t capacity = 0;
+    for (const auto& block : mBlocks) {
+        capacity += block.size;
+    }
+    return capacity;
+}
+
+size_t FrameArena::get_block_count() const
+{
+    return mBlocks.size();
+}
+
+void FrameArena::clear()
+{
+    if (1 < mBlocks.size()) {
+        auto capacity = get_capacity();
+        for (const auto& block : mBlocks) {
+            mpUpstream->deallocate(block.pData, block.size, alignof(std::max_align_t));
+        }
+        mBlocks.clear();
+        allocate_block(capacity);
+    }
+    mBlockIndex = 0;
+    mOffset = 0;
+}
+
+void FrameArena::reset()
+{
+    for (const auto& block : mBlocks) {
+        mpUpstream->deallocate(block.pData, block.size, alignof(std::max_align_t));
+    }
+    mBlocks.clear();
+    mBlockSize = 0;
+    mBlockIndex = 0;
+    mOffset = 0;
+}
+
+void* FrameArena::do_allocate(size_t size, size_t alignment)
+{
+    assert(mpUpstream);
+    while (true) {
+        if (mBlockIndex < mBlocks.size()) {
+            auto& block = mBlocks[mBlockIndex];
+            void* pData = block.pData + mOffset;
+            auto space = block.size - mOffset;
+            if (std::align(alignment, size, pData, space)) {
+                mOffset = (std::byte*)pData - block.pData + size;
+                return pData;
+            }
+            if (mBlockIndex + 1 < mBlocks.size()) {
+                ++mBlockIndex;
+                mOffset = 0;
+                continue;
+            }
+        }
+        allocate_block(std::max(mBlockSize, size + alignment));
+        mBlockIndex = mBlocks.size() - 1;
+        mOffset = 0;
+    }
+}
+
+void FrameArena::do_deallocate(void*, size_t, size_t)
+{
+}
+
+bool FrameArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+    return this == &other;
+}
+
+void FrameArena::allocate_block(size_t size)
+{
+    Block block { };
+    block.pData = (std::byte*)mpUpstream->allocate(size, alignof(std::max_align_t));
+    block.size = size;
+    mBlocks.push_back(block);
+}
+
+void BufferedFrameArena::create(const CreateInfo* pCreateInfo, BufferedFrameArena* pBufferedFrameArena)
+{
+    assert(pCreateInfo);
+    assert(pCreateInfo->frameCount);
+    assert(pBufferedFrameArena);
+    pBufferedFrameArena->reset();
+    for (uint32_t frame_i = 0; frame_i < pCreateInfo->frameCount; ++frame_i) {
+        pBufferedFrameArena->mupFrameArenas.push_back(std::make_unique<FrameArena>());
+        FrameArena::create(&pCreateInfo->frameArenaCreateInfo, pBufferedFrameArena->mupFrameArenas.back().get());
+    }
+}
+
+uint32_t BufferedFrameArena::get_frame_count() const
+{
+    return (uint32_t)mupFrameArenas.size();
+}
+
+uint32_t BufferedFrameArena::get_frame_index() const
+{
+    return mFrameIndex;
+}
+
+FrameArena& BufferedFrameArena::get_frame_arena()
+{
+    assert(mFrameIndex < mupFrameArenas.size());
+    return *mupFrameArenas[mFrameIndex];
+}
+
+void BufferedFrameArena::next_frame()
+{
+    assert(!mupFrameArenas.empty());
+    mFrameIndex = (mFrameIndex + 1) % (uint32_t)mupFrameArenas.size();
+    mupFrameArenas[mFrameIndex]->clear();
+}
+
+void BufferedFrameArena::reset()
+{
+    mupFrameArenas.clear();
+    mFrameIndex = 0;
+}
+
+} // namespace dst
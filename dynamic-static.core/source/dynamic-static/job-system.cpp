@@ -0,0 +1,207 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#include "dynamic-static/job-system.hpp"
+
+namespace dst {
+namespace {
+
+thread_local const JobSystem* tpJobSystem { nullptr };
+thread_local uint32_t tWorkerIndex { 0 };
+
+} // namespace
+
+JobSystem::Worker::Worker(size_t maxJobCount)
+    : deque(maxJobCount)
+    , upJobs { std::make_unique<Job[]>(maxJobCount) }
+    , jobCount { maxJobCount }
+{
+}
+
+void JobSystem::create(const CreateInfo* pCreateInfo, JobSystem* pJobSystem)
+{
+    assert(pCreateInfo);
+    assert(pCreateInfo->maxJobCount);
+    assert(pJobSystem);
+    pJobSystem->reset();
+    auto workerCount = pCreateInfo->workerCount;
+    if (!workerCount) {
+        workerCount = std::max(std::thread::hardware_concurrency(), 1u) - 1;
+    }
+    pJobSystem->mMainThreadId = std::this_thread::get_id();
+    pJobSystem->mRunning = true;
+    for (uint32_t worker_i = 0; worker_i <= workerCount; ++worker_i) {
+        pJobSystem->mWorkers.push_back(std::make_unique<Worker>(pCreateInfo->maxJobCount));
+        pJobSystem->mWorkers.back()->randomState = worker_i * 2654435761u + 1;
+    }
+    for (uint32_t worker_i = 1; worker_i <= workerCount; ++worker_i) {
+        pJobSystem->mWorkers[worker_i]->thread = std::thread(&JobSystem::worker_main, pJobSystem, worker_i);
+    }
+}
+
+JobSystem::~JobSystem()
+{
+    reset();
+}
+
+uint32_t JobSystem::get_thread_count() const
+{
+    return (uint32_t)mWorkers.size();
+}
+
+void JobSystem::run(JobCounter* pCounter, std::function<void()> function)
+{
+    assert(pCounter);
+    assert(function);
+    auto& worker = get_local_worker();
+    auto& job = worker.upJobs[worker.jobIndex];
+    if (job.pending.load(std::memory_order_acquire)) {
+        function();
+        return;
+    }
+    worker.jobIndex = (worker.jobIndex + 1) % worker.jobCount;
+    job.function = std::move(function);
+    job.pCounter = pCounter;
+    job.pending.store(true, std::memory_order_relaxed);
+    pCounter->mCount.fetch_add(1, std::memory_order_relaxed);
+    // Every queued job holds a pending slot so the deque can't overflow.
+    auto pushed = worker.deque.push(&job);
+    (void)pushed;
+    assert(pushed);
+    mQueuedJobCount.fetch_add(1);
+    if (mSleepingWorkerCount.load()) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mConditionVariable.notify_one();
+    }
+}
+
+void JobSystem::wait(JobCounter* pCounter)
+{
+    assert(pCounter);
+    auto& worker = get_local_worker();
+    while (!pCounter->is_complete()) {
+        if (!try_execute_job(worker)) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void JobSystem::reset()
+{
+    if (mRunning) {
+        mRunning = false;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mConditionVariable.notify_all();
+        }
+        for (auto& upWorker : mWorkers) {
+            if (upWorker->thread.joinable()) {
+                upWorker->thread.join();
+            }
+        }
+    }
+    mWorkers.clear();
+    mQueuedJobCount = 0;
+    mSleepingWorkerCount = 0;
+}
+
+JobSystem::Worker& JobSystem::get_local_worker()
+{
+    assert(!mWorkers.empty());
+    if (tpJobSystem == this) {
+        return *mWorkers[tWorkerIndex];
+    }
+    assert(std::this_thread::get_id() == mMainThreadId);
+    return *mWorkers[0];
+}
+
+bool JobSystem::is_local_queue_empty()
+{
+    return get_local_worker().deque.empty();
+}
+
+bool JobSystem::try_execute_job(Worker& worker)
+{
+    Job* pJob = nullptr;
+    auto found = worker.deque.pop(&pJob);
+    if (!found && 1 < mWorkers.size()) {
+        // Start stealing from a random victim so thieves spread across queues.
+        worker.randomState ^= worker.randomState << 13;
+        worker.randomState ^= worker.randomState >> 17;
+        worker.randomState ^= worker.randomState << 5;
+        auto workerCount = (uint32_t)mWorkers.size();
+        auto victimOffset = worker.randomState % workerCount;
+        for (uint32_t i = 0; i < workerCount && !found; ++i) {
+            auto& victim = *mWorkers[(victimOffset + i) % workerCount];
+            if (&victim != &worker) {
+                found = victim.deque.steal(&pJob);
+            }
+        }
+    }
+    if (found) {
+        mQueuedJobCount.fetch_sub(1);
+        execute_job(pJob);
+    }
+    return found;
+}
+
+void JobSystem::execute_job(Job* pJob)
+{
+    assert(pJob);
+    auto pCounter = pJob->pCounter;
+    pJob->function();
+    pJob->function = nullptr;
+    pJob->pending.store(false, std::memory_order_release);
+    pCounter->mCount.fetch_sub(1, std::memory_order_release);
+}
+
+void JobSystem::worker_main(uint32_t workerIndex)
+{
+    tpJobSystem = this;
+    tWorkerIndex = workerIndex;
+    auto& worker = *mWorkers[workerIndex];
+    uint32_t idleCount = 0;
+    while (mRunning) {
+        if (try_execute_job(worker)) {
+            idleCount = 0;
+        } else if (++idleCount < 64) {
+            std::this_thread::yield();
+        } else {
+            // Sleep until a job is queued, the sleeping count is published before
+            //  the queued count is checked so run() can't miss this worker.
+            mSleepingWorkerCount.fetch_add(1);
+            {
+                std::unique_lock<std::mutex> lock(mMutex);
+                mConditionVariable.wait(lock, [this]() { return mQueuedJobCount.load() || !mRunning; });
+            }
+            mSleepingWorkerCount.fetch_sub(1);
+            idleCount = 0;
+        }
+    }
+    tpJobSystem = nullptr;
+}
+
+} // namespace dst
@@ -0,0 +1,308 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#include "dynamic-static/profiler.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define DST_PROFILER_TSC
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
+
+namespace dst {
+namespace profiler {
+namespace {
+
+struct ThreadBuffer final
+{
+    std::unique_ptr<Event[]> upEvents { std::make_unique<Event[]>(EventCapacity) };
+    std::atomic<uint64_t> writeIndex { 0 };
+    std::atomic<uint64_t> readIndex { 0 };
+    uint32_t threadIndex { 0 };
+    uint32_t depth { 0 };
+};
+
+struct Profiler final
+{
+    Profiler()
+    {
+        // The reference point for converting timestamps to milliseconds, the TSC
+        //  rate is measured against steady_clock between this and each read.
+        referenceTimestamp = get_timestamp();
+        referenceTime = std::chrono::steady_clock::now();
+    }
+
+    std::mutex mutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> threadBuffers;
+    uint64_t referenceTimestamp { 0 };
+    std::chrono::steady_clock::time_point referenceTime;
+    std::atomic<uint64_t> previousFrameTimestamp { 0 };
+    std::atomic<uint64_t> frameTimestamp { 0 };
+};
+
+Profiler& get_profiler()
+{
+    static Profiler sProfiler;
+    return sProfiler;
+}
+
+ThreadBuffer& get_thread_buffer()
+{
+    // ThreadBuffers are owned by the Profiler so events recorded by a thread stay
+    //  readable after it exits.
+    thread_local ThreadBuffer* tpThreadBuffer { nullptr };
+    if (!tpThreadBuffer) {
+        auto& profiler = get_profiler();
+        auto spThreadBuffer = std::make_shared<ThreadBuffer>();
+        std::lock_guard<std::mutex> lock(profiler.mutex);
+        spThreadBuffer->threadIndex = (uint32_t)profiler.threadBuffers.size();
+        profiler.threadBuffers.push_back(spThreadBuffer);
+        tpThreadBuffer = spThreadBuffer.get();
+    }
+    return *tpThreadBuffer;
+}
+
+double get_milliseconds_per_tick()
+{
+#ifdef DST_PROFILER_TSC
+    auto& profiler = get_profiler();
+    auto timestamp = get_timestamp();
+    auto time = std::chrono::steady_clock::now();
+    auto milliseconds = std::chrono::duration<double, std::milli>(time - profiler.referenceTime).count();
+    auto ticks = (double)(timestamp - profiler.referenceTimestamp);
+    return 0 < ticks ? milliseconds / ticks : 0;
+#else
+    return 1.0 / 1000000.0;
+#endif
+}
+
+// Events are written while readers may copy them, every field is accessed
+//  atomically so a torn copy is only ever discarded, never undefined.
+void store_event(const Event& event, Event* pEvent)
+{
+    std::atomic_ref<const char*>(pEvent->pName).store(event.pName, std::memory_order_relaxed);
+    std::atomic_ref<uint64_t>(pEvent->beginTimestamp).store(event.beginTimestamp, std::memory_order_relaxed);
+    std::atomic_ref<uint64_t>(pEvent->endTimestamp).store(event.endTimestamp, std::memory_order_relaxed);
+    std::atomic_ref<uint32_t>(pEvent->threadIndex).store(event.threadIndex, std::memory_order_relaxed);
+    std::atomic_ref<uint32_t>(pEvent->depth).store(event.depth, std::memory_order_relaxed);
+}
+
+Event load_event(Event& event)
+{
+    Event result { };
+    result.pName = std::atomic_ref<const char*>(event.pName).load(std::memory_order_relaxed);
+    result.beginTimestamp = std::atomic_ref<uint64_t>(event.beginTimestamp).load(std::memory_order_relaxed);
+    result.endTimestamp = std::atomic_ref<uint64_t>(event.endTimestamp).load(std::memory_order_relaxed);
+    result.threadIndex = std::atomic_ref<uint32_t>(event.threadIndex).load(std::memory_order_relaxed);
+    result.depth = std::atomic_ref<uint32_t>(event.depth).load(std::memory_order_relaxed);
+    return result;
+}
+
+void write_escaped(std::ostream& stream, const char* pString)
+{
+    for (; pString && *pString; ++pString) {
+        switch (*pString) {
+        case '"': stream << "\\\""; break;
+        case '\\': stream << "\\\\"; break;
+        default: stream << *pString; break;
+        }
+    }
+}
+
+} // namespace
+
+namespace detail {
+
+uint64_t begin_zone()
+{
+    ++get_thread_buffer().depth;
+    return get_timestamp();
+}
+
+void end_zone(const char* pName, uint64_t beginTimestamp)
+{
+    auto endTimestamp = get_timestamp();
+    auto& threadBuffer = get_thread_buffer();
+    assert(threadBuffer.depth);
+    --threadBuffer.depth;
+    auto writeIndex = threadBuffer.writeIndex.load(std::memory_order_relaxed);
+    Event event { };
+    event.pName = pName;
+    event.beginTimestamp = beginTimestamp;
+    event.endTimestamp = endTimestamp;
+    event.threadIndex = threadBuffer.threadIndex;
+    event.depth = threadBuffer.depth;
+    // The release fence orders the publication of writeIndex (by the previous
+    //  event) before this event's stores, a reader that copies any part of this
+    //  event will see writeIndex advanced to at least writeIndex.
+    std::atomic_thread_fence(std::memory_order_release);
+    store_event(event, &threadBuffer.upEvents[writeIndex % EventCapacity]);
+    threadBuffer.writeIndex.store(writeIndex + 1, std::memory_order_release);
+}
+
+} // namespace detail
+
+uint64_t get_timestamp()
+{
+#ifdef DST_PROFILER_TSC
+    return __rdtsc();
+#else
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+double get_milliseconds(uint64_t beginTimestamp, uint64_t endTimestamp)
+{
+    return beginTimestamp < endTimestamp ? (double)(endTimestamp - beginTimestamp) * get_milliseconds_per_tick() : 0;
+}
+
+void begin_frame()
+{
+    auto& profiler = get_profiler();
+    profiler.previousFrameTimestamp.store(profiler.frameTimestamp.load());
+    profiler.frameTimestamp.store(get_timestamp());
+}
+
+void get_frame_summary(std::vector<ZoneSummary>* pZoneSummaries)
+{
+    assert(pZoneSummaries);
+    auto& profiler = get_profiler();
+    auto frameBegin = profiler.previousFrameTimestamp.load();
+    auto frameEnd = profiler.frameTimestamp.load();
+    auto millisecondsPerTick = get_milliseconds_per_tick();
+    std::vector<Event> events;
+    get_events(&events);
+    pZoneSummaries->clear();
+    std::unordered_map<const char*, size_t> zoneSummaryIndices;
+    for (const auto& event : events) {
+        if (frameBegin <= event.beginTimestamp && event.endTimestamp <= frameEnd) {
+            auto inserted = zoneSummaryIndices.insert({ event.pName, pZoneSummaries->size() });
+            if (inserted.second) {
+                pZoneSummaries->push_back({ .pName = event.pName });
+            }
+            auto& zoneSummary = (*pZoneSummaries)[inserted.first->second];
+            auto milliseconds = (double)(event.endTimestamp - event.beginTimestamp) * millisecondsPerTick;
+            ++zoneSummary.callCount;
+            zoneSummary.totalMilliseconds += milliseconds;
+            zoneSummary.maxMilliseconds = std::max(zoneSummary.maxMilliseconds, milliseconds);
+        }
+    }
+    std::sort(pZoneSummaries->begin(), pZoneSummaries->end(),
+        [](const ZoneSummary& lhs, const ZoneSummary& rhs)
+        {
+            return rhs.totalMilliseconds < lhs.totalMilliseconds;
+        }
+    );
+}
+
+void get_events(std::vector<Event>* pEvents)
+{
+    assert(pEvents);
+    auto& profiler = get_profiler();
+    pEvents->clear();
+    std::lock_guard<std::mutex> lock(profiler.mutex);
+    for (const auto& spThreadBuffer : profiler.threadBuffers) {
+        auto endIndex = spThreadBuffer->writeIndex.load(std::memory_order_acquire);
+        auto beginIndex = std::max(spThreadBuffer->readIndex.load(std::memory_order_relaxed), EventCapacity < endIndex ? endIndex - EventCapacity : 0);
+        auto eventOffset = pEvents->size();
+        for (auto event_i = beginIndex; event_i < endIndex; ++event_i) {
+            pEvents->push_back(load_event(spThreadBuffer->upEvents[event_i % EventCapacity]));
+        }
+        // Discard events that the recording thread may have overwritten while
+        //  they were being copied.  The acquire fence pairs with the release fence
+        //  in end_zone() so the second load of writeIndex sees every write that
+        //  the copy observed.  Writes up to overwrittenIndex have completed and the
+        //  write of event overwrittenIndex may be in flight, so every event up to
+        //  and including overwrittenIndex - EventCapacity may have been
+        //  overwritten.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        auto overwrittenIndex = spThreadBuffer->writeIndex.load(std::memory_order_relaxed);
+        if (beginIndex + EventCapacity <= overwrittenIndex) {
+            auto discardCount = std::min(overwrittenIndex - EventCapacity + 1 - beginIndex, endIndex - beginIndex);
+            pEvents->erase(pEvents->begin() + eventOffset, pEvents->begin() + eventOffset + discardCount);
+        }
+    }
+}
+
+void write_chrome_trace(std::ostream& stream)
+{
+    std::vector<Event> events;
+    get_events(&events);
+    auto referenceTimestamp = get_profiler().referenceTimestamp;
+    auto millisecondsPerTick = get_milliseconds_per_tick();
+    auto flags = stream.flags();
+    auto precision = stream.precision();
+    stream << std::fixed << std::setprecision(3);
+    stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    for (size_t event_i = 0; event_i < events.size(); ++event_i) {
+        const auto& event = events[event_i];
+        auto beginMicroseconds = (double)(int64_t)(event.beginTimestamp - referenceTimestamp) * millisecondsPerTick * 1000.0;
+        auto durationMicroseconds = (double)(event.endTimestamp - event.beginTimestamp) * millisecondsPerTick * 1000.0;
+        stream << (event_i ? "," : "") << "\n{\"name\":\"";
+        write_escaped(stream, event.pName);
+        stream << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << event.threadIndex;
+        stream << ",\"ts\":" << beginMicroseconds << ",\"dur\":" << durationMicroseconds << "}";
+    }
+    stream << "\n]}\n";
+    stream.flags(flags);
+    stream.precision(precision);
+}
+
+bool write_chrome_trace(const std::filesystem::path& filePath)
+{
+    std::ofstream file(filePath);
+    if (file.is_open()) {
+        write_chrome_trace(file);
+    }
+    return file.good();
+}
+
+void clear()
+{
+    auto& profiler = get_profiler();
+    std::lock_guard<std::mutex> lock(profiler.mutex);
+    for (const auto& spThreadBuffer : profiler.threadBuffers) {
+        spThreadBuffer->readIndex.store(spThreadBuffer->writeIndex.load(std::memory_order_acquire), std::memory_order_relaxed);
+    }
+    profiler.previousFrameTimestamp = 0;
+    profiler.frameTimestamp = 0;
+}
+
+} // namespace profiler
+} // namespace dst
@@ -0,0 +1,121 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#include "dynamic-static/stack-allocator.hpp"
+
+#include <cassert>
+#include <cstdint>
+#include <memory>
+
+namespace dst {
+
+StackAllocator::Scope::Scope(StackAllocator& stackAllocator)
+    : mStackAllocator { stackAllocator }
+    , mMarker { stackAllocator.get_marker() }
+{
+}
+
+StackAllocator::Scope::~Scope()
+{
+    mStackAllocator.rewind(mMarker);
+}
+
+void StackAllocator::create(const CreateInfo* pCreateInfo, StackAllocator* pStackAllocator)
+{
+    assert(pCreateInfo);
+    assert(pCreateInfo->size);
+    assert(pStackAllocator);
+    pStackAllocator->reset();
+    pStackAllocator->mpUpstream = pCreateInfo->pUpstream ? pCreateInfo->pUpstream : std::pmr::new_delete_resource();
+    pStackAllocator->mpData = (std::byte*)pStackAllocator->mpUpstream->allocate(pCreateInfo->size, alignof(std::max_align_t));
+    pStackAllocator->mSize = pCreateInfo->size;
+}
+
+StackAllocator::~StackAllocator()
+{
+    reset();
+}
+
+StackAllocator::Marker StackAllocator::get_marker() const
+{
+    return mOffset;
+}
+
+size_t StackAllocator::get_capacity() const
+{
+    return mSize;
+}
+
+size_t StackAllocator::get_overflow_count() const
+{
+    return mOverflowCount;
+}
+
+void StackAllocator::rewind(Marker marker)
+{
+    assert(marker <= mOffset);
+    mOffset = marker;
+}
+
+void StackAllocator::reset()
+{
+    if (mpData) {
+        mpUpstream->deallocate(mpData, mSize, alignof(std::max_align_t));
+    }
+    mpData = nullptr;
+    mSize = 0;
+    mOffset = 0;
+    mOverflowCount = 0;
+}
+
+void* StackAllocator::do_allocate(size_t size, size_t alignment)
+{
+    assert(mpUpstream);
+    void* pData = mpData + mOffset;
+    auto space = mSize - mOffset;
+    if (std::align(alignment, size, pData, space)) {
+        mOffset = (std::byte*)pData - mpData + size;
+        return pData;
+    }
+    ++mOverflowCount;
+    return mpUpstream->allocate(size, alignment);
+}
+
+void StackAllocator::do_deallocate(void* pData, size_t size, size_t alignment)
+{
+    auto address = (uintptr_t)pData;
+    auto begin = (uintptr_t)mpData;
+    if (address < begin || begin + mSize <= address) {
+        mpUpstream->deallocate(pData, size, alignment);
+    }
+}
+
+bool StackAllocator::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+    return this == &other;
+}
+
+} // namespace dst
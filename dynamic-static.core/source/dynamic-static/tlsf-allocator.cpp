@@ -0,0 +1,328 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+
+#include "dynamic-static/tlsf-allocator.hpp"
+
+#include <bit>
+#include <cassert>
+
+namespace dst {
+
+void TlsfAllocator::create(const CreateInfo* pCreateInfo, TlsfAllocator* pTlsfAllocator)
+{
+    assert(pCreateInfo);
+    assert(pCreateInfo->size);
+    assert(pTlsfAllocator);
+    pTlsfAllocator->reset();
+    pTlsfAllocator->mSize = pCreateInfo->size;
+    pTlsfAllocator->mFirstBlock = pTlsfAllocator->create_block(0, pCreateInfo->size);
+    pTlsfAllocator->insert_free_block(pTlsfAllocator->mFirstBlock);
+}
+
+uint64_t TlsfAllocator::get_size() const
+{
+    return mSize;
+}
+
+uint64_t TlsfAllocator::get_used_size() const
+{
+    return mUsedSize;
+}
+
+uint32_t TlsfAllocator::get_allocation_count() const
+{
+    return mAllocationCount;
+}
+
+uint32_t TlsfAllocator::get_free_block_count() const
+{
+    return mFreeBlockCount;
+}
+
+uint64_t TlsfAllocator::get_offset(Handle handle) const
+{
+    assert(handle < mBlocks.size());
+    assert(!mBlocks[handle].free);
+    return mBlocks[handle].offset;
+}
+
+uint64_t TlsfAllocator::get_size(Handle handle) const
+{
+    assert(handle < mBlocks.size());
+    assert(!mBlocks[handle].free);
+    return mBlocks[handle].size;
+}
+
+TlsfAllocator::Handle TlsfAllocator::allocate(uint64_t size)
+{
+    assert(mSize);
+    assert(size);
+    if (mSize - mUsedSize < size) {
+        return InvalidHandle;
+    }
+    auto handle = find_free_block(size);
+    if (handle == InvalidHandle) {
+        return InvalidHandle;
+    }
+    remove_free_block(handle);
+
+    // Split the remainder off into a new free block.
+    if (size < mBlocks[handle].size) {
+        auto remainder = create_block(mBlocks[handle].offset + size, mBlocks[handle].size - size);
+        auto& block = mBlocks[handle];
+        mBlocks[remainder].prevPhysical = handle;
+        mBlocks[remainder].nextPhysical = block.nextPhysical;
+        if (block.nextPhysical != InvalidHandle) {
+            mBlocks[block.nextPhysical].prevPhysical = remainder;
+        }
+        block.nextPhysical = remainder;
+        block.size = size;
+        insert_free_block(remainder);
+    }
+    mBlocks[handle].free = false;
+    mUsedSize += size;
+    ++mAllocationCount;
+    return handle;
+}
+
+void TlsfAllocator::free(Handle handle)
+{
+    assert(handle < mBlocks.size());
+    assert(!mBlocks[handle].free);
+    mUsedSize -= mBlocks[handle].size;
+    --mAllocationCount;
+    mBlocks[handle].free = true;
+
+    // Coalesce with the next block if it's free...
+    auto next = mBlocks[handle].nextPhysical;
+    if (next != InvalidHandle && mBlocks[next].free) {
+        remove_free_block(next);
+        mBlocks[handle].size += mBlocks[next].size;
+        mBlocks[handle].nextPhysical = mBlocks[next].nextPhysical;
+        if (mBlocks[handle].nextPhysical != InvalidHandle) {
+            mBlocks[mBlocks[handle].nextPhysical].prevPhysical = handle;
+        }
+        destroy_block(next);
+    }
+
+    // ...and with the previous block if it's free.
+    auto prev = mBlocks[handle].prevPhysical;
+    if (prev != InvalidHandle && mBlocks[prev].free) {
+        remove_free_block(prev);
+        mBlocks[prev].size += mBlocks[handle].size;
+        mBlocks[prev].nextPhysical = mBlocks[handle].nextPhysical;
+        if (mBlocks[prev].nextPhysical != InvalidHandle) {
+            mBlocks[mBlocks[prev].nextPhysical].prevPhysical = prev;
+        }
+        destroy_block(handle);
+        handle = prev;
+    }
+    insert_free_block(handle);
+}
+
+void TlsfAllocator::defragment(std::vector<Move>* pMoves)
+{
+    assert(mSize);
+    assert(pMoves);
+
+    // Walk blocks in offset order sliding allocations down over free blocks, free
+    //  blocks are destroyed and replaced by a single block at the end.
+    uint64_t offset = 0;
+    auto firstBlock = InvalidHandle;
+    auto prevBlock = InvalidHandle;
+    for (auto handle = mFirstBlock; handle != InvalidHandle;) {
+        auto next = mBlocks[handle].nextPhysical;
+        if (mBlocks[handle].free) {
+            destroy_block(handle);
+        } else {
+            auto& block = mBlocks[handle];
+            if (block.offset != offset) {
+                pMoves->push_back({ handle, block.offset, offset, block.size });
+                block.offset = offset;
+            }
+            block.prevPhysical = prevBlock;
+            if (prevBlock != InvalidHandle) {
+                mBlocks[prevBlock].nextPhysical = handle;
+            } else {
+                firstBlock = handle;
+            }
+            prevBlock = handle;
+            offset += block.size;
+        }
+        handle = next;
+    }
+    mClassBitmap = 0;
+    mSubclassBitmaps.fill(0);
+    for (auto& freeLists : mFreeLists) {
+        freeLists.fill(InvalidHandle);
+    }
+    mFreeBlockCount = 0;
+    auto lastBlock = InvalidHandle;
+    if (offset < mSize) {
+        lastBlock = create_block(offset, mSize - offset);
+        mBlocks[lastBlock].prevPhysical = prevBlock;
+        insert_free_block(lastBlock);
+    }
+    if (prevBlock != InvalidHandle) {
+        mBlocks[prevBlock].nextPhysical = lastBlock;
+    }
+    mFirstBlock = firstBlock != InvalidHandle ? firstBlock : lastBlock;
+}
+
+void TlsfAllocator::reset()
+{
+    mSize = 0;
+    mUsedSize = 0;
+    mAllocationCount = 0;
+    mFreeBlockCount = 0;
+    mClassBitmap = 0;
+    mSubclassBitmaps.fill(0);
+    for (auto& freeLists : mFreeLists) {
+        freeLists.fill(InvalidHandle);
+    }
+    mBlocks.clear();
+    mUnusedBlocks.clear();
+    mFirstBlock = InvalidHandle;
+}
+
+void TlsfAllocator::get_bin(uint64_t size, uint32_t* pClass, uint32_t* pSubclass)
+{
+    // Sizes below SubclassCount are binned exactly in class 0, larger sizes are
+    //  binned by their highest set bit then the SubclassCountLog2 bits below it.
+    assert(pClass);
+    assert(pSubclass);
+    if (size < SubclassCount) {
+        *pClass = 0;
+        *pSubclass = (uint32_t)size;
+    } else {
+        auto log2 = (uint32_t)std::bit_width(size) - 1;
+        *pClass = log2 - SubclassCountLog2 + 1;
+        *pSubclass = (uint32_t)(size >> (log2 - SubclassCountLog2)) - SubclassCount;
+    }
+}
+
+TlsfAllocator::Handle TlsfAllocator::create_block(uint64_t offset, uint64_t size)
+{
+    Handle handle = InvalidHandle;
+    if (!mUnusedBlocks.empty()) {
+        handle = mUnusedBlocks.back();
+        mUnusedBlocks.pop_back();
+    } else {
+        handle = (Handle)mBlocks.size();
+        mBlocks.emplace_back();
+    }
+    mBlocks[handle] = { };
+    mBlocks[handle].offset = offset;
+    mBlocks[handle].size = size;
+    return handle;
+}
+
+void TlsfAllocator::destroy_block(Handle handle)
+{
+    mBlocks[handle] = { };
+    mUnusedBlocks.push_back(handle);
+}
+
+void TlsfAllocator::insert_free_block(Handle handle)
+{
+    uint32_t binClass = 0;
+    uint32_t binSubclass = 0;
+    get_bin(mBlocks[handle].size, &binClass, &binSubclass);
+    auto& head = mFreeLists[binClass][binSubclass];
+    auto& block = mBlocks[handle];
+    block.free = true;
+    block.prevFree = InvalidHandle;
+    block.nextFree = head;
+    if (head != InvalidHandle) {
+        mBlocks[head].prevFree = handle;
+    }
+    head = handle;
+    mClassBitmap |= 1ull << binClass;
+    mSubclassBitmaps[binClass] |= 1u << binSubclass;
+    ++mFreeBlockCount;
+}
+
+void TlsfAllocator::remove_free_block(Handle handle)
+{
+    uint32_t binClass = 0;
+    uint32_t binSubclass = 0;
+    get_bin(mBlocks[handle].size, &binClass, &binSubclass);
+    auto& block = mBlocks[handle];
+    if (block.prevFree != InvalidHandle) {
+        mBlocks[block.prevFree].nextFree = block.nextFree;
+    } else {
+        mFreeLists[binClass][binSubclass] = block.nextFree;
+    }
+    if (block.nextFree != InvalidHandle) {
+        mBlocks[block.nextFree].prevFree = block.prevFree;
+    }
+    block.prevFree = InvalidHandle;
+    block.nextFree = InvalidHandle;
+    if (mFreeLists[binClass][binSubclass] == InvalidHandle) {
+        mSubclassBitmaps[binClass] &= ~(1u << binSubclass);
+        if (!mSubclassBitmaps[binClass]) {
+            mClassBitmap &= ~(1ull << binClass);
+        }
+    }
+    --mFreeBlockCount;
+}
+
+TlsfAllocator::Handle TlsfAllocator::find_free_block(uint64_t size) const
+{
+    // Round size up to the next bin boundary so any block in the bin found is
+    //  large enough, then take the first non empty bin at or above it.
+    auto searchSize = size;
+    if (SubclassCount <= searchSize) {
+        searchSize += (1ull << (std::bit_width(searchSize) - 1 - SubclassCountLog2)) - 1;
+    }
+    uint32_t binClass = 0;
+    uint32_t binSubclass = 0;
+    get_bin(searchSize, &binClass, &binSubclass);
+    auto subclassBitmap = mSubclassBitmaps[binClass] & (~0u << binSubclass);
+    if (!subclassBitmap && binClass + 1 < ClassCount) {
+        auto classBitmap = mClassBitmap & (~0ull << (binClass + 1));
+        if (classBitmap) {
+            binClass = (uint32_t)std::countr_zero(classBitmap);
+            subclassBitmap = mSubclassBitmaps[binClass];
+        }
+    }
+    if (subclassBitmap) {
+        return mFreeLists[binClass][std::countr_zero(subclassBitmap)];
+    }
+
+    // Rounding up skips blocks in size's own bin that may still be large enough,
+    //  ie. the last block in a full allocator, so fall back to searching it.
+    get_bin(size, &binClass, &binSubclass);
+    for (auto handle = mFreeLists[binClass][binSubclass]; handle != InvalidHandle; handle = mBlocks[handle].nextFree) {
+        if (size <= mBlocks[handle].size) {
+            return handle;
+        }
+    }
+    return InvalidHandle;
+}
+
+} // namespace dst
@@ -0,0 +1,213 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#include "dynamic-static/asset-file.hpp"
+
+#include "gtest/gtest.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <vector>
+
+namespace dst {
+namespace tests {
+
+static const uint32_t FloatSection { make_fourcc('F', 'L', 'T', 'S') };
+static const uint32_t IndexSection { make_fourcc('I', 'D', 'X', 'S') };
+static const uint32_t EmptySection { make_fourcc('N', 'O', 'N', 'E') };
+
+static std::filesystem::path get_test_file_path()
+{
+    return std::filesystem::temp_directory_path() / "dynamic-static.asset-file.tests.dsta";
+}
+
+static std::vector<uint8_t> create_test_data()
+{
+    std::vector<float> floats(100);
+    std::iota(floats.begin(), floats.end(), 0.0f);
+    std::vector<uint32_t> indices(33);
+    std::iota(indices.begin(), indices.end(), 7);
+    AssetFileWriter writer;
+    writer.add_section<float>(FloatSection, 0, floats);
+    writer.add_section<uint32_t>(IndexSection, 0, indices);
+    writer.add_section<uint32_t>(IndexSection, 1, std::span<const uint32_t>(indices).first(3));
+    writer.add_section(EmptySection, 0, nullptr, 0, 0);
+    std::vector<uint8_t> data;
+    writer.write(&data);
+    return data;
+}
+
+static bool write_test_file(const std::vector<uint8_t>& data)
+{
+    std::ofstream file(get_test_file_path(), std::ios::binary);
+    file.write((const char*)data.data(), (std::streamsize)data.size());
+    return file.good();
+}
+
+TEST(AssetFile, RoundTrip)
+{
+    ASSERT_TRUE(write_test_file(create_test_data()));
+    AssetFile::CreateInfo assetFileCreateInfo { };
+    assetFileCreateInfo.filePath = get_test_file_path();
+    AssetFile assetFile;
+    ASSERT_TRUE(AssetFile::create(&assetFileCreateInfo, &assetFile));
+    ASSERT_NE(assetFile.get_header(), nullptr);
+    EXPECT_EQ(assetFile.get_header()->magic, AssetFile::Magic);
+    EXPECT_EQ(assetFile.get_header()->version, AssetFile::Version);
+    EXPECT_EQ(assetFile.get_sections().size(), 4u);
+
+    // Section data is used in place and starts on a SectionAlignment boundary.
+    auto floats = assetFile.get_section_data<float>(FloatSection);
+    ASSERT_EQ(floats.size(), 100u);
+    EXPECT_EQ((uintptr_t)floats.data() % AssetFile::SectionAlignment, 0u);
+    EXPECT_GE((const uint8_t*)floats.data(), assetFile.get_data().data());
+    EXPECT_LE((const uint8_t*)(floats.data() + floats.size()), assetFile.get_data().data() + assetFile.get_data().size());
+    for (size_t i = 0; i < floats.size(); ++i) {
+        EXPECT_EQ(floats[i], (float)i);
+    }
+    auto indices = assetFile.get_section_data<uint32_t>(IndexSection);
+    ASSERT_EQ(indices.size(), 33u);
+    EXPECT_EQ((uintptr_t)indices.data() % AssetFile::SectionAlignment, 0u);
+    EXPECT_EQ(indices[0], 7u);
+    EXPECT_EQ(indices[32], 39u);
+    EXPECT_EQ(assetFile.get_section_data<uint32_t>(IndexSection, 1).size(), 3u);
+    EXPECT_EQ(assetFile.find_section(IndexSection, 1)->stride, sizeof(uint32_t));
+    EXPECT_NE(assetFile.find_section(EmptySection), nullptr);
+    EXPECT_TRUE(assetFile.get_section_data<uint32_t>(EmptySection).empty());
+
+    // Missing Sections and Sections whose size isn't a multiple of sizeof(T) give
+    //  empty spans.
+    EXPECT_EQ(assetFile.find_section(IndexSection, 2), nullptr);
+    EXPECT_TRUE(assetFile.get_section_data<uint32_t>(IndexSection, 2).empty());
+    struct Triple final { uint32_t values[3]; };
+    EXPECT_TRUE(assetFile.get_section_data<Triple>(FloatSection).empty());
+    EXPECT_EQ(assetFile.get_section_data<Triple>(IndexSection).size(), 11u);
+
+    // Moving transfers the mapping.
+    auto pData = assetFile.get_data().data();
+    AssetFile movedAssetFile(std::move(assetFile));
+    EXPECT_EQ(assetFile.get_header(), nullptr);
+    EXPECT_TRUE(assetFile.get_sections().empty());
+    EXPECT_EQ(movedAssetFile.get_data().data(), pData);
+    movedAssetFile.reset();
+    EXPECT_EQ(movedAssetFile.get_header(), nullptr);
+    std::filesystem::remove(get_test_file_path());
+}
+
+TEST(AssetFile, ReplaceSection)
+{
+    AssetFileWriter writer;
+    std::vector<uint32_t> values { 1, 2, 3 };
+    writer.add_section<uint32_t>(IndexSection, 0, values);
+    values = { 4, 5 };
+    writer.add_section<uint32_t>(IndexSection, 0, values);
+    EXPECT_EQ(writer.get_section_count(), 1u);
+    ASSERT_TRUE(writer.write(get_test_file_path()));
+    AssetFile::CreateInfo assetFileCreateInfo { };
+    assetFileCreateInfo.filePath = get_test_file_path();
+    assetFileCreateInfo.prefetch = true;
+    AssetFile assetFile;
+    ASSERT_TRUE(AssetFile::create(&assetFileCreateInfo, &assetFile));
+    auto data = assetFile.get_section_data<uint32_t>(IndexSection);
+    EXPECT_EQ(std::vector<uint32_t>(data.begin(), data.end()), values);
+    assetFile.reset();
+    std::filesystem::remove(get_test_file_path());
+}
+
+TEST(AssetFile, CopyOnWrite)
+{
+    ASSERT_TRUE(write_test_file(create_test_data()));
+    AssetFile::CreateInfo assetFileCreateInfo { };
+    assetFileCreateInfo.filePath = get_test_file_path();
+    assetFileCreateInfo.copyOnWrite = true;
+    AssetFile assetFile;
+    ASSERT_TRUE(AssetFile::create(&assetFileCreateInfo, &assetFile));
+    EXPECT_TRUE(assetFile.is_copy_on_write());
+    auto data = assetFile.get_mutable_section_data(*assetFile.find_section(IndexSection));
+    data[0] = 0xff;
+    EXPECT_EQ(assetFile.get_section_data<uint8_t>(IndexSection)[0], 0xff);
+
+    // Modifications aren't written back to the file.
+    AssetFile otherAssetFile;
+    assetFileCreateInfo.copyOnWrite = false;
+    ASSERT_TRUE(AssetFile::create(&assetFileCreateInfo, &otherAssetFile));
+    EXPECT_FALSE(otherAssetFile.is_copy_on_write());
+    EXPECT_EQ(otherAssetFile.get_section_data<uint32_t>(IndexSection)[0], 7u);
+    assetFile.reset();
+    EXPECT_FALSE(assetFile.is_copy_on_write());
+    otherAssetFile.reset();
+    std::filesystem::remove(get_test_file_path());
+}
+
+TEST(AssetFile, Validation)
+{
+    auto data = create_test_data();
+    EXPECT_TRUE(AssetFile::validate(data));
+    EXPECT_FALSE(AssetFile::validate({ }));
+
+    // Truncated data fails validation.
+    EXPECT_FALSE(AssetFile::validate(std::span<const uint8_t>(data).first(data.size() - 1)));
+    EXPECT_FALSE(AssetFile::validate(std::span<const uint8_t>(data).first(sizeof(AssetFile::Header) - 1)));
+
+    auto validate_modified = [&](auto modify)
+    {
+        auto modifiedData = data;
+        AssetFile::Header header { };
+        memcpy(&header, modifiedData.data(), sizeof(header));
+        AssetFile::Section section { };
+        memcpy(&section, modifiedData.data() + header.sectionTableOffset, sizeof(section));
+        modify(header, section);
+        memcpy(modifiedData.data(), &header, sizeof(header));
+        memcpy(modifiedData.data() + sizeof(header), &section, sizeof(section));
+        return AssetFile::validate(modifiedData);
+    };
+    EXPECT_TRUE(validate_modified([](AssetFile::Header&, AssetFile::Section&) { }));
+    EXPECT_FALSE(validate_modified([](AssetFile::Header& header, AssetFile::Section&) { header.magic = make_fourcc('A', 'T', 'S', 'D'); }));
+    EXPECT_FALSE(validate_modified([](AssetFile::Header& header, AssetFile::Section&) { ++header.version; }));
+    EXPECT_FALSE(validate_modified([](AssetFile::Header& header, AssetFile::Section&) { header.sectionCount = 1u << 30; }));
+    EXPECT_FALSE(validate_modified([](AssetFile::Header& header, AssetFile::Section&) { header.sectionTableOffset = ~0ull; }));
+    EXPECT_FALSE(validate_modified([](AssetFile::Header& header, AssetFile::Section&) { header.fileSize += 1; }));
+    EXPECT_FALSE(validate_modified([](AssetFile::Header&, AssetFile::Section& section) { section.offset += 4; }));
+    EXPECT_FALSE(validate_modified([](AssetFile::Header&, AssetFile::Section& section) { section.size = ~0ull; }));
+    EXPECT_FALSE(validate_modified([](AssetFile::Header& header, AssetFile::Section& section) { section.offset = header.fileSize + AssetFile::SectionAlignment; }));
+
+    // create() fails for missing and invalid files.
+    AssetFile::CreateInfo assetFileCreateInfo { };
+    assetFileCreateInfo.filePath = get_test_file_path();
+    std::filesystem::remove(get_test_file_path());
+    AssetFile assetFile;
+    EXPECT_FALSE(AssetFile::create(&assetFileCreateInfo, &assetFile));
+    data[0] = 0;
+    ASSERT_TRUE(write_test_file(data));
+    EXPECT_FALSE(AssetFile::create(&assetFileCreateInfo, &assetFile));
+    EXPECT_EQ(assetFile.get_header(), nullptr);
+    std::filesystem::remove(get_test_file_path());
+}
+
+} // namespace tests
+} // namespace dst
@@ -0,0 +1,431 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#include "dynamic-static/batch-math.hpp"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace dst {
+namespace tests {
+
+static const std::vector<size_t> Counts { 0, 1, 3, 4, 5, 7, 8, 9, 63, 64, 65, 200 };
+
+struct Vector3s final
+{
+    Vector3s(size_t count = 0)
+        : x(count)
+        , y(count)
+        , z(count)
+    {
+    }
+
+    batch::Vector3Soa<float> get_soa()
+    {
+        return { x.data(), y.data(), z.data() };
+    }
+
+    std::vector<float>& operator[](size_t axis)
+    {
+        return axis == 0 ? x : axis == 1 ? y : z;
+    }
+
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> z;
+};
+
+struct Transforms final
+{
+    Transforms(size_t count = 0)
+        : positions(count)
+        , x(count)
+        , y(count)
+        , z(count)
+        , w(count)
+    {
+    }
+
+    batch::TransformSoa<float> get_soa()
+    {
+        return { positions.get_soa(), { x.data(), y.data(), z.data(), w.data() } };
+    }
+
+    Vector3s positions;
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> z;
+    std::vector<float> w;
+};
+
+struct Aabbs final
+{
+    Aabbs(size_t count = 0)
+        : mins(count)
+        , maxs(count)
+    {
+    }
+
+    batch::AabbSoa<float> get_soa()
+    {
+        return { mins.get_soa(), maxs.get_soa() };
+    }
+
+    Vector3s mins;
+    Vector3s maxs;
+};
+
+static Transforms create_random_transforms(size_t count, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> distribution(-1, 1);
+    Transforms transforms(count);
+    for (size_t i = 0; i < count; ++i) {
+        transforms.positions.x[i] = distribution(rng) * 100;
+        transforms.positions.y[i] = distribution(rng) * 100;
+        transforms.positions.z[i] = distribution(rng) * 100;
+        std::array<float, 4> q { distribution(rng), distribution(rng), distribution(rng), distribution(rng) };
+        auto length = std::sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+        transforms.x[i] = q[0] / length;
+        transforms.y[i] = q[1] / length;
+        transforms.z[i] = q[2] / length;
+        transforms.w[i] = q[3] / length;
+    }
+    return transforms;
+}
+
+static Aabbs create_random_aabbs(size_t count, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> positionDistribution(-100, 100);
+    std::uniform_real_distribution<float> extentDistribution(0, 10);
+    Aabbs aabbs(count);
+    for (size_t i = 0; i < count; ++i) {
+        aabbs.mins.x[i] = positionDistribution(rng);
+        aabbs.mins.y[i] = positionDistribution(rng);
+        aabbs.mins.z[i] = positionDistribution(rng);
+        aabbs.maxs.x[i] = aabbs.mins.x[i] + extentDistribution(rng);
+        aabbs.maxs.y[i] = aabbs.mins.y[i] + extentDistribution(rng);
+        aabbs.maxs.z[i] = aabbs.mins.z[i] + extentDistribution(rng);
+    }
+    return aabbs;
+}
+
+static std::vector<batch::Plane> create_frustum_planes()
+{
+    // A box shaped frustum, { normal, distance } with inward facing normals.
+    return {
+        batch::Plane { 1, 0, 0, 50 },
+        batch::Plane { -1, 0, 0, 50 },
+        batch::Plane { 0, 1, 0, 50 },
+        batch::Plane { 0, -1, 0, 50 },
+        batch::Plane { 0, 0.70710678f, 0.70710678f, 40 },
+        batch::Plane { 0, 0, -1, 60 },
+    };
+}
+
+static void expect_equal(const std::vector<float>& expected, const std::vector<float>& actual)
+{
+    ASSERT_EQ(expected.size(), actual.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_EQ(expected[i], actual[i]) << "i = " << i;
+    }
+}
+
+static void expect_equal(const Vector3s& expected, const Vector3s& actual)
+{
+    expect_equal(expected.x, actual.x);
+    expect_equal(expected.y, actual.y);
+    expect_equal(expected.z, actual.z);
+}
+
+static void for_each_instruction_set(const std::function<void(batch::InstructionSet)>& function)
+{
+    // Calls function() with each supported non scalar InstructionSet selected then
+    //  restores the default InstructionSet.
+    for (auto instructionSet : { batch::InstructionSet::Sse2, batch::InstructionSet::Avx2, batch::InstructionSet::Neon }) {
+        if (batch::is_supported(instructionSet)) {
+            batch::set_instruction_set(instructionSet);
+            function(instructionSet);
+        }
+    }
+    batch::set_instruction_set(batch::get_supported_instruction_set());
+}
+
+static std::array<float, 3> rotate(const std::array<float, 4>& q, const std::array<float, 3>& v)
+{
+    // q * v * conjugate(q) evaluated in double precision.
+    double w = q[3], x = q[0], y = q[1], z = q[2];
+    double vx = v[0], vy = v[1], vz = v[2];
+    double tw = -x * vx - y * vy - z * vz;
+    double tx = w * vx + y * vz - z * vy;
+    double ty = w * vy + z * vx - x * vz;
+    double tz = w * vz + x * vy - y * vx;
+    return {
+        (float)(tx * w - tw * x - ty * z + tz * y),
+        (float)(ty * w - tw * y - tz * x + tx * z),
+        (float)(tz * w - tw * z - tx * y + ty * x),
+    };
+}
+
+TEST(BatchMath, InstructionSets)
+{
+    EXPECT_TRUE(batch::is_supported(batch::InstructionSet::Scalar));
+    EXPECT_TRUE(batch::is_supported(batch::get_supported_instruction_set()));
+    EXPECT_EQ(batch::get_instruction_set(), batch::get_supported_instruction_set());
+#if defined(__x86_64__) || defined(_M_X64)
+    EXPECT_TRUE(batch::is_supported(batch::InstructionSet::Sse2));
+    EXPECT_FALSE(batch::is_supported(batch::InstructionSet::Neon));
+#endif
+    batch::set_instruction_set(batch::InstructionSet::Scalar);
+    EXPECT_EQ(batch::get_instruction_set(), batch::InstructionSet::Scalar);
+    batch::set_instruction_set(batch::get_supported_instruction_set());
+}
+
+TEST(BatchMath, ComposeTransforms)
+{
+    for (auto count : Counts) {
+        auto parents = create_random_transforms(count, 0);
+        auto locals = create_random_transforms(count, 1);
+        batch::set_instruction_set(batch::InstructionSet::Scalar);
+        Transforms expected(count);
+        batch::compose_transforms(count, parents.get_soa(), locals.get_soa(), expected.get_soa());
+        for (size_t i = 0; i < count; ++i) {
+            // The composed transform applied to a point matches applying the local
+            //  then the parent transform.
+            std::array<float, 4> parentRotation { parents.x[i], parents.y[i], parents.z[i], parents.w[i] };
+            std::array<float, 4> localRotation { locals.x[i], locals.y[i], locals.z[i], locals.w[i] };
+            std::array<float, 4> rotation { expected.x[i], expected.y[i], expected.z[i], expected.w[i] };
+            std::array<float, 3> point { 1, 2, 3 };
+            auto localPoint = rotate(localRotation, point);
+            auto parentPoint = rotate(parentRotation, { localPoint[0] + locals.positions.x[i], localPoint[1] + locals.positions.y[i], localPoint[2] + locals.positions.z[i] });
+            auto composedPoint = rotate(rotation, point);
+            EXPECT_NEAR(composedPoint[0] + expected.positions.x[i], parentPoint[0] + parents.positions.x[i], 1e-3f);
+            EXPECT_NEAR(composedPoint[1] + expected.positions.y[i], parentPoint[1] + parents.positions.y[i], 1e-3f);
+            EXPECT_NEAR(composedPoint[2] + expected.positions.z[i], parentPoint[2] + parents.positions.z[i], 1e-3f);
+        }
+        for_each_instruction_set(
+            [&](batch::InstructionSet)
+            {
+                Transforms actual(count);
+                batch::compose_transforms(count, parents.get_soa(), locals.get_soa(), actual.get_soa());
+                expect_equal(expected.positions, actual.positions);
+                expect_equal(expected.x, actual.x);
+                expect_equal(expected.y, actual.y);
+                expect_equal(expected.z, actual.z);
+                expect_equal(expected.w, actual.w);
+
+                // Results may alias inputs.
+                auto aliased = parents;
+                batch::compose_transforms(count, aliased.get_soa(), locals.get_soa(), aliased.get_soa());
+                expect_equal(expected.positions, aliased.positions);
+                expect_equal(expected.w, aliased.w);
+            }
+        );
+    }
+}
+
+TEST(BatchMath, CreateMatrices)
+{
+    for (auto count : Counts) {
+        auto transforms = create_random_transforms(count, 2);
+        batch::set_instruction_set(batch::InstructionSet::Scalar);
+        std::vector<float> expected(count * 16);
+        batch::create_matrices(count, transforms.get_soa(), expected.data());
+        for (size_t i = 0; i < count; ++i) {
+            const auto* pMatrix = expected.data() + i * 16;
+            std::array<float, 3> point { 1, 2, 3 };
+            auto rotatedPoint = rotate({ transforms.x[i], transforms.y[i], transforms.z[i], transforms.w[i] }, point);
+            for (size_t row_i = 0; row_i < 3; ++row_i) {
+                auto value = pMatrix[row_i] * point[0] + pMatrix[4 + row_i] * point[1] + pMatrix[8 + row_i] * point[2] + pMatrix[12 + row_i];
+                EXPECT_NEAR(value, rotatedPoint[row_i] + transforms.positions[row_i][i], 1e-3f);
+            }
+            EXPECT_EQ(pMatrix[3], 0.0f);
+            EXPECT_EQ(pMatrix[7], 0.0f);
+            EXPECT_EQ(pMatrix[11], 0.0f);
+            EXPECT_EQ(pMatrix[15], 1.0f);
+        }
+        for_each_instruction_set(
+            [&](batch::InstructionSet)
+            {
+                std::vector<float> actual(count * 16);
+                batch::create_matrices(count, transforms.get_soa(), actual.data());
+                expect_equal(expected, actual);
+            }
+        );
+    }
+}
+
+TEST(BatchMath, TransformAabbs)
+{
+    for (auto count : Counts) {
+        auto aabbs = create_random_aabbs(count, 3);
+        auto transforms = create_random_transforms(count, 4);
+        batch::set_instruction_set(batch::InstructionSet::Scalar);
+        Aabbs expected(count);
+        batch::transform_aabbs(count, aabbs.get_soa(), transforms.get_soa(), expected.get_soa());
+        for (size_t i = 0; i < count; ++i) {
+            // Every transformed corner is inside the transformed AABB.
+            for (uint32_t corner_i = 0; corner_i < 8; ++corner_i) {
+                std::array<float, 3> corner {
+                    corner_i & 1 ? aabbs.maxs.x[i] : aabbs.mins.x[i],
+                    corner_i & 2 ? aabbs.maxs.y[i] : aabbs.mins.y[i],
+                    corner_i & 4 ? aabbs.maxs.z[i] : aabbs.mins.z[i],
+                };
+                auto rotatedCorner = rotate({ transforms.x[i], transforms.y[i], transforms.z[i], transforms.w[i] }, corner);
+                EXPECT_LE(expected.mins.x[i], rotatedCorner[0] + transforms.positions.x[i] + 1e-3f);
+                EXPECT_LE(expected.mins.y[i], rotatedCorner[1] + transforms.positions.y[i] + 1e-3f);
+                EXPECT_LE(expected.mins.z[i], rotatedCorner[2] + transforms.positions.z[i] + 1e-3f);
+                EXPECT_GE(expected.maxs.x[i], rotatedCorner[0] + transforms.positions.x[i] - 1e-3f);
+                EXPECT_GE(expected.maxs.y[i], rotatedCorner[1] + transforms.positions.y[i] - 1e-3f);
+                EXPECT_GE(expected.maxs.z[i], rotatedCorner[2] + transforms.positions.z[i] - 1e-3f);
+            }
+        }
+        for_each_instruction_set(
+            [&](batch::InstructionSet)
+            {
+                Aabbs actual(count);
+                batch::transform_aabbs(count, aabbs.get_soa(), transforms.get_soa(), actual.get_soa());
+                expect_equal(expected.mins, actual.mins);
+                expect_equal(expected.maxs, actual.maxs);
+            }
+        );
+    }
+}
+
+TEST(BatchMath, MergeAabbs)
+{
+    for (auto count : Counts) {
+        auto aabbs = create_random_aabbs(count, 5);
+        batch::Aabb expected { };
+        for (size_t axis_i = 0; axis_i < 3; ++axis_i) {
+            const auto& mins = aabbs.mins[axis_i];
+            const auto& maxs = aabbs.maxs[axis_i];
+            expected.min[axis_i] = count ? *std::min_element(mins.begin(), mins.end()) : std::numeric_limits<float>::infinity();
+            expected.max[axis_i] = count ? *std::max_element(maxs.begin(), maxs.end()) : -std::numeric_limits<float>::infinity();
+        }
+        batch::set_instruction_set(batch::InstructionSet::Scalar);
+        auto scalar = batch::merge_aabbs(count, aabbs.get_soa());
+        for (size_t axis_i = 0; axis_i < 3; ++axis_i) {
+            EXPECT_EQ(scalar.min[axis_i], expected.min[axis_i]);
+            EXPECT_EQ(scalar.max[axis_i], expected.max[axis_i]);
+        }
+        for_each_instruction_set(
+            [&](batch::InstructionSet)
+            {
+                auto actual = batch::merge_aabbs(count, aabbs.get_soa());
+                for (size_t axis_i = 0; axis_i < 3; ++axis_i) {
+                    EXPECT_EQ(actual.min[axis_i], expected.min[axis_i]);
+                    EXPECT_EQ(actual.max[axis_i], expected.max[axis_i]);
+                }
+            }
+        );
+    }
+}
+
+TEST(BatchMath, CullSpheres)
+{
+    auto planes = create_frustum_planes();
+    for (auto count : Counts) {
+        std::mt19937 rng(6);
+        std::uniform_real_distribution<float> positionDistribution(-80, 80);
+        std::uniform_real_distribution<float> radiusDistribution(0, 20);
+        Vector3s centers(count);
+        std::vector<float> radii(count);
+        std::vector<uint8_t> expected(count);
+        size_t expectedVisibleCount = 0;
+        for (size_t i = 0; i < count; ++i) {
+            centers.x[i] = positionDistribution(rng);
+            centers.y[i] = positionDistribution(rng);
+            centers.z[i] = positionDistribution(rng);
+            radii[i] = radiusDistribution(rng);
+            expected[i] = 1;
+            for (const auto& plane : planes) {
+                if (plane[0] * centers.x[i] + plane[1] * centers.y[i] + plane[2] * centers.z[i] + plane[3] < -radii[i]) {
+                    expected[i] = 0;
+                }
+            }
+            expectedVisibleCount += expected[i];
+        }
+        batch::SphereSoa<float> spheres { centers.get_soa(), radii.data() };
+        batch::set_instruction_set(batch::InstructionSet::Scalar);
+        std::vector<uint8_t> actual(count);
+        EXPECT_EQ(batch::cull_spheres(planes, count, spheres, actual.data()), expectedVisibleCount);
+        EXPECT_EQ(actual, expected);
+        for_each_instruction_set(
+            [&](batch::InstructionSet)
+            {
+                std::fill(actual.begin(), actual.end(), (uint8_t)0xff);
+                EXPECT_EQ(batch::cull_spheres(planes, count, spheres, actual.data()), expectedVisibleCount);
+                EXPECT_EQ(actual, expected);
+            }
+        );
+    }
+}
+
+TEST(BatchMath, CullAabbs)
+{
+    auto planes = create_frustum_planes();
+    for (auto count : Counts) {
+        auto aabbs = create_random_aabbs(count, 7);
+        std::vector<uint8_t> expected(count);
+        size_t expectedVisibleCount = 0;
+        for (size_t i = 0; i < count; ++i) {
+            expected[i] = 1;
+            for (const auto& plane : planes) {
+                auto x = 0 <= plane[0] ? aabbs.maxs.x[i] : aabbs.mins.x[i];
+                auto y = 0 <= plane[1] ? aabbs.maxs.y[i] : aabbs.mins.y[i];
+                auto z = 0 <= plane[2] ? aabbs.maxs.z[i] : aabbs.mins.z[i];
+                if (plane[0] * x + plane[1] * y + plane[2] * z + plane[3] < 0) {
+                    expected[i] = 0;
+                }
+            }
+            expectedVisibleCount += expected[i];
+        }
+        batch::set_instruction_set(batch::InstructionSet::Scalar);
+        std::vector<uint8_t> actual(count);
+        EXPECT_EQ(batch::cull_aabbs(planes, count, aabbs.get_soa(), actual.data()), expectedVisibleCount);
+        EXPECT_EQ(actual, expected);
+        for_each_instruction_set(
+            [&](batch::InstructionSet)
+            {
+                std::fill(actual.begin(), actual.end(), (uint8_t)0xff);
+                EXPECT_EQ(batch::cull_aabbs(planes, count, aabbs.get_soa(), actual.data()), expectedVisibleCount);
+                EXPECT_EQ(actual, expected);
+            }
+        );
+    }
+}
+
+} // namespace tests
+} // namespace dst
@@ -0,0 +1,205 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#include "dynamic-static/frame-arena.hpp"
+#include "dynamic-static/stack-allocator.hpp"
+
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <memory_resource>
+#include <unordered_map>
+#include <vector>
+
+namespace dst {
+namespace tests {
+
+class CountingMemoryResource final
+    : public std::pmr::memory_resource
+{
+public:
+    size_t allocationCount { 0 };
+    size_t deallocationCount { 0 };
+
+private:
+    void* do_allocate(size_t size, size_t alignment) override final
+    {
+        ++allocationCount;
+        return std::pmr::new_delete_resource()->allocate(size, alignment);
+    }
+
+    void do_deallocate(void* pData, size_t size, size_t alignment) override final
+    {
+        ++deallocationCount;
+        std::pmr::new_delete_resource()->deallocate(pData, size, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override final
+    {
+        return this == &other;
+    }
+};
+
+TEST(FrameArena, Allocate)
+{
+    FrameArena::CreateInfo frameArenaCreateInfo { };
+    frameArenaCreateInfo.blockSize = 1024;
+    FrameArena frameArena;
+    FrameArena::create(&frameArenaCreateInfo, &frameArena);
+    auto pData0 = frameArena.allocate(3, 1);
+    auto pData1 = frameArena.allocate(16, 16);
+    auto pData2 = frameArena.allocate(4, 4);
+    EXPECT_EQ((uintptr_t)pData1 % 16, 0u);
+    EXPECT_EQ((uintptr_t)pData2 % 4, 0u);
+    EXPECT_LT((uintptr_t)pData0, (uintptr_t)pData1);
+    EXPECT_LT((uintptr_t)pData1, (uintptr_t)pData2);
+    EXPECT_LE(23u, frameArena.get_used_size());
+    frameArena.clear();
+    EXPECT_EQ(frameArena.get_used_size(), 0u);
+    EXPECT_EQ(frameArena.allocate(3, 1), pData0);
+}
+
+TEST(FrameArena, Overflow)
+{
+    CountingMemoryResource upstream;
+    FrameArena::CreateInfo frameArenaCreateInfo { };
+    frameArenaCreateInfo.blockSize = 256;
+    frameArenaCreateInfo.pUpstream = &upstream;
+    FrameArena frameArena;
+    FrameArena::create(&frameArenaCreateInfo, &frameArena);
+    EXPECT_EQ(upstream.allocationCount, 1u);
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_NE(frameArena.allocate(200, 8), nullptr);
+    }
+    EXPECT_NE(frameArena.allocate(4096, 8), nullptr);
+    EXPECT_EQ(frameArena.get_block_count(), 5u);
+    auto capacity = frameArena.get_capacity();
+
+    // Clearing coalesces the blocks so the same frame fits in one block.
+    frameArena.clear();
+    EXPECT_EQ(frameArena.get_block_count(), 1u);
+    EXPECT_EQ(frameArena.get_capacity(), capacity);
+    auto allocationCount = upstream.allocationCount;
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_NE(frameArena.allocate(200, 8), nullptr);
+    }
+    EXPECT_NE(frameArena.allocate(4096, 8), nullptr);
+    EXPECT_EQ(upstream.allocationCount, allocationCount);
+    frameArena.reset();
+    EXPECT_EQ(upstream.allocationCount, upstream.deallocationCount);
+}
+
+TEST(FrameArena, SteadyStateFramesDoNotAllocate)
+{
+    CountingMemoryResource upstream;
+    FrameArena::CreateInfo frameArenaCreateInfo { };
+    frameArenaCreateInfo.blockSize = 1024;
+    frameArenaCreateInfo.pUpstream = &upstream;
+    FrameArena frameArena;
+    FrameArena::create(&frameArenaCreateInfo, &frameArena);
+    size_t warmupAllocationCount = 0;
+    for (int frame_i = 0; frame_i < 8; ++frame_i) {
+        frameArena.clear();
+        if (frame_i == 2) {
+            warmupAllocationCount = upstream.allocationCount;
+        }
+        std::pmr::vector<int> values(&frameArena);
+        for (int i = 0; i < 1000; ++i) {
+            values.push_back(i);
+        }
+        std::pmr::unordered_map<int, int> map(&frameArena);
+        for (int i = 0; i < 100; ++i) {
+            map[i] = i;
+        }
+        EXPECT_EQ(values.size(), 1000u);
+        EXPECT_EQ(map.size(), 100u);
+    }
+    EXPECT_EQ(upstream.allocationCount, warmupAllocationCount);
+}
+
+TEST(FrameArena, BufferedFrameArena)
+{
+    BufferedFrameArena::CreateInfo bufferedFrameArenaCreateInfo { };
+    bufferedFrameArenaCreateInfo.frameCount = 3;
+    BufferedFrameArena bufferedFrameArena;
+    BufferedFrameArena::create(&bufferedFrameArenaCreateInfo, &bufferedFrameArena);
+    EXPECT_EQ(bufferedFrameArena.get_frame_count(), 3u);
+    std::vector<int*> pValues;
+    for (uint32_t frame_i = 0; frame_i < 3; ++frame_i) {
+        EXPECT_EQ(bufferedFrameArena.get_frame_index(), frame_i);
+        auto pValue = (int*)bufferedFrameArena.get_frame_arena().allocate(sizeof(int), alignof(int));
+        *pValue = (int)frame_i;
+        pValues.push_back(pValue);
+        bufferedFrameArena.next_frame();
+    }
+
+    // Wrapping around clears only the oldest frame.
+    EXPECT_EQ(bufferedFrameArena.get_frame_index(), 0u);
+    EXPECT_EQ(bufferedFrameArena.get_frame_arena().get_used_size(), 0u);
+    EXPECT_EQ(*pValues[1], 1);
+    EXPECT_EQ(*pValues[2], 2);
+}
+
+TEST(StackAllocator, Markers)
+{
+    StackAllocator::CreateInfo stackAllocatorCreateInfo { };
+    stackAllocatorCreateInfo.size = 1024;
+    StackAllocator stackAllocator;
+    StackAllocator::create(&stackAllocatorCreateInfo, &stackAllocator);
+    auto marker = stackAllocator.get_marker();
+    auto pData0 = stackAllocator.allocate(64, 8);
+    {
+        StackAllocator::Scope scope(stackAllocator);
+        std::pmr::vector<int> values(&stackAllocator);
+        values.resize(16);
+        EXPECT_LT(stackAllocator.get_marker(), 1024u);
+    }
+    EXPECT_EQ(stackAllocator.get_marker(), 64u);
+    stackAllocator.rewind(marker);
+    EXPECT_EQ(stackAllocator.allocate(64, 8), pData0);
+}
+
+TEST(StackAllocator, Overflow)
+{
+    CountingMemoryResource upstream;
+    StackAllocator::CreateInfo stackAllocatorCreateInfo { };
+    stackAllocatorCreateInfo.size = 128;
+    stackAllocatorCreateInfo.pUpstream = &upstream;
+    StackAllocator stackAllocator;
+    StackAllocator::create(&stackAllocatorCreateInfo, &stackAllocator);
+    auto pData0 = stackAllocator.allocate(100, 8);
+    auto pData1 = stackAllocator.allocate(100, 8);
+    EXPECT_EQ(stackAllocator.get_overflow_count(), 1u);
+    EXPECT_EQ(upstream.allocationCount, 2u);
+    stackAllocator.deallocate(pData1, 100, 8);
+    stackAllocator.deallocate(pData0, 100, 8);
+    EXPECT_EQ(upstream.deallocationCount, 1u);
+    stackAllocator.reset();
+    EXPECT_EQ(upstream.deallocationCount, 2u);
+}
+
+} // namespace tests
+} // namespace dst
@@ -0,0 +1,147 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#include "dynamic-static/frame-pipeline.hpp"
+
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace dst {
+namespace tests {
+
+struct Input
+{
+    uint32_t frame { 0 };
+};
+
+struct Snapshot
+{
+    uint32_t frame { 0 };
+    std::vector<uint32_t> values;
+};
+
+TEST(FramePipeline, FrameOrder)
+{
+    // acquire() returns frames in submission order, one frame behind the most
+    //  recent submit(), starting with the frame create() submits.
+    FramePipeline<Input, Snapshot>::CreateInfo framePipelineCreateInfo { };
+    framePipelineCreateInfo.simulate = [](const Input& input, Snapshot* pSnapshot)
+    {
+        pSnapshot->frame = input.frame;
+        pSnapshot->values.assign(16, input.frame);
+    };
+    FramePipeline<Input, Snapshot> framePipeline;
+    FramePipeline<Input, Snapshot>::create(&framePipelineCreateInfo, &framePipeline);
+    for (uint32_t frame = 1; frame <= 1000; ++frame) {
+        framePipeline.submit({ frame });
+        const auto& snapshot = framePipeline.acquire();
+        EXPECT_EQ(snapshot.frame, frame - 1);
+        EXPECT_EQ(snapshot.values, std::vector<uint32_t>(16, frame - 1));
+        framePipeline.release();
+    }
+}
+
+TEST(FramePipeline, AcquiredSnapshotIsStable)
+{
+    // The simulation thread runs ahead while a Snapshot is acquired but must not
+    //  write to it until it's released.
+    std::atomic<uint32_t> simulatedFrameCount { 0 };
+    FramePipeline<Input, Snapshot>::CreateInfo framePipelineCreateInfo { };
+    framePipelineCreateInfo.simulate = [&](const Input& input, Snapshot* pSnapshot)
+    {
+        pSnapshot->frame = input.frame;
+        ++simulatedFrameCount;
+    };
+    FramePipeline<Input, Snapshot> framePipeline;
+    FramePipeline<Input, Snapshot>::create(&framePipelineCreateInfo, &framePipeline);
+    for (uint32_t frame = 1; frame <= 64; ++frame) {
+        framePipeline.submit({ frame });
+        const auto& snapshot = framePipeline.acquire();
+        EXPECT_EQ(snapshot.frame, frame - 1);
+        while (simulatedFrameCount < frame + 1) {
+            std::this_thread::yield();
+        }
+        EXPECT_EQ(snapshot.frame, frame - 1);
+        framePipeline.release();
+    }
+}
+
+TEST(FramePipeline, BoundedLatency)
+{
+    // With 3 Snapshots simulation can be at most 2 frames ahead of the frame
+    //  that's been acquired.
+    std::atomic<uint32_t> simulatedFrameCount { 0 };
+    FramePipeline<Input, Snapshot>::CreateInfo framePipelineCreateInfo { };
+    framePipelineCreateInfo.snapshotCount = 3;
+    framePipelineCreateInfo.simulate = [&](const Input& input, Snapshot* pSnapshot)
+    {
+        pSnapshot->frame = input.frame;
+        ++simulatedFrameCount;
+    };
+    FramePipeline<Input, Snapshot> framePipeline;
+    FramePipeline<Input, Snapshot>::create(&framePipelineCreateInfo, &framePipeline);
+    framePipeline.submit({ 1 });
+    framePipeline.submit({ 2 });
+    framePipeline.submit({ 3 });
+    const auto& snapshot = framePipeline.acquire();
+    EXPECT_EQ(snapshot.frame, 0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    EXPECT_EQ(simulatedFrameCount, 3);
+    framePipeline.release();
+    for (uint32_t frame = 1; frame <= 3; ++frame) {
+        EXPECT_EQ(framePipeline.acquire().frame, frame);
+        framePipeline.release();
+    }
+    EXPECT_EQ(simulatedFrameCount, 4);
+}
+
+TEST(FramePipeline, Reset)
+{
+    // reset() must return while the simulation thread is waiting for input.
+    FramePipeline<Input, Snapshot>::CreateInfo framePipelineCreateInfo { };
+    framePipelineCreateInfo.simulate = [](const Input& input, Snapshot* pSnapshot)
+    {
+        pSnapshot->frame = input.frame;
+    };
+    FramePipeline<Input, Snapshot> framePipeline;
+    FramePipeline<Input, Snapshot>::create(&framePipelineCreateInfo, &framePipeline);
+    EXPECT_EQ(framePipeline.acquire().frame, 0);
+    framePipeline.release();
+    framePipeline.reset();
+    FramePipeline<Input, Snapshot>::create(&framePipelineCreateInfo, &framePipeline);
+    framePipeline.submit({ 7 });
+    framePipeline.acquire();
+    framePipeline.release();
+    EXPECT_EQ(framePipeline.acquire().frame, 7);
+    framePipeline.release();
+}
+
+} // namespace tests
+} // namespace dst
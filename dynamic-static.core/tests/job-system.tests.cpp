@@ -0,0 +1,214 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#include "dynamic-static/job-system.hpp"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace dst {
+namespace tests {
+
+TEST(JobSystem, WorkStealingDeque)
+{
+    WorkStealingDeque<int> deque(4);
+    EXPECT_TRUE(deque.empty());
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(deque.push(i));
+    }
+    EXPECT_FALSE(deque.push(4));
+    int value = -1;
+    EXPECT_TRUE(deque.steal(&value));
+    EXPECT_EQ(value, 0);
+    EXPECT_TRUE(deque.pop(&value));
+    EXPECT_EQ(value, 3);
+    EXPECT_TRUE(deque.pop(&value));
+    EXPECT_EQ(value, 2);
+    EXPECT_TRUE(deque.steal(&value));
+    EXPECT_EQ(value, 1);
+    EXPECT_FALSE(deque.pop(&value));
+    EXPECT_FALSE(deque.steal(&value));
+    EXPECT_TRUE(deque.empty());
+}
+
+TEST(JobSystem, WorkStealingDequeConcurrentSteal)
+{
+    // Every pushed value must be taken exactly once by either the owner or a thief.
+    constexpr int ValueCount = 100000;
+    WorkStealingDeque<int> deque(256);
+    std::atomic<bool> done { false };
+    std::vector<std::vector<int>> stolenValues(3);
+    std::vector<std::thread> thieves;
+    for (auto& values : stolenValues) {
+        thieves.emplace_back([&]() {
+            int value = 0;
+            while (!done || !deque.empty()) {
+                if (deque.steal(&value)) {
+                    values.push_back(value);
+                }
+            }
+        });
+    }
+    std::vector<int> poppedValues;
+    int value = 0;
+    for (int i = 0; i < ValueCount; ++i) {
+        while (!deque.push(i)) {
+            if (deque.pop(&value)) {
+                poppedValues.push_back(value);
+            }
+        }
+        if (i % 3 == 0 && deque.pop(&value)) {
+            poppedValues.push_back(value);
+        }
+    }
+    while (deque.pop(&value)) {
+        poppedValues.push_back(value);
+    }
+    done = true;
+    for (auto& thief : thieves) {
+        thief.join();
+    }
+    std::vector<int> values = poppedValues;
+    for (const auto& stolen : stolenValues) {
+        values.insert(values.end(), stolen.begin(), stolen.end());
+    }
+    std::sort(values.begin(), values.end());
+    ASSERT_EQ(values.size(), (size_t)ValueCount);
+    for (int i = 0; i < ValueCount; ++i) {
+        EXPECT_EQ(values[i], i);
+    }
+}
+
+TEST(JobSystem, Run)
+{
+    JobSystem::CreateInfo jobSystemCreateInfo { };
+    jobSystemCreateInfo.workerCount = 3;
+    JobSystem jobSystem;
+    JobSystem::create(&jobSystemCreateInfo, &jobSystem);
+    EXPECT_EQ(jobSystem.get_thread_count(), 4u);
+    std::atomic<uint32_t> sum { 0 };
+    JobCounter counter;
+    for (uint32_t i = 0; i < 1000; ++i) {
+        jobSystem.run(&counter, [&sum, i]() { sum += i; });
+    }
+    jobSystem.wait(&counter);
+    EXPECT_TRUE(counter.is_complete());
+    EXPECT_EQ(sum, 499500u);
+}
+
+TEST(JobSystem, NestedJobs)
+{
+    // Jobs may fork and join their own jobs, the waiting job executes work while
+    //  it waits so this can't deadlock even with more forks than threads.
+    JobSystem::CreateInfo jobSystemCreateInfo { };
+    jobSystemCreateInfo.workerCount = 2;
+    JobSystem jobSystem;
+    JobSystem::create(&jobSystemCreateInfo, &jobSystem);
+    std::atomic<uint32_t> leafCount { 0 };
+    JobCounter counter;
+    for (uint32_t i = 0; i < 16; ++i) {
+        jobSystem.run(&counter, [&]() {
+            JobCounter childCounter;
+            for (uint32_t j = 0; j < 16; ++j) {
+                jobSystem.run(&childCounter, [&]() { ++leafCount; });
+            }
+            jobSystem.wait(&childCounter);
+        });
+    }
+    jobSystem.wait(&counter);
+    EXPECT_EQ(leafCount, 256u);
+}
+
+TEST(JobSystem, RunInlineWhenFull)
+{
+    JobSystem::CreateInfo jobSystemCreateInfo { };
+    jobSystemCreateInfo.workerCount = 1;
+    jobSystemCreateInfo.maxJobCount = 4;
+    JobSystem jobSystem;
+    JobSystem::create(&jobSystemCreateInfo, &jobSystem);
+    std::atomic<uint32_t> count { 0 };
+    JobCounter counter;
+    for (uint32_t i = 0; i < 100; ++i) {
+        jobSystem.run(&counter, [&]() { ++count; });
+    }
+    jobSystem.wait(&counter);
+    EXPECT_EQ(count, 100u);
+}
+
+TEST(JobSystem, ParallelFor)
+{
+    for (uint32_t workerCount : { 1u, 3u }) {
+        JobSystem::CreateInfo jobSystemCreateInfo { };
+        jobSystemCreateInfo.workerCount = workerCount;
+        JobSystem jobSystem;
+        JobSystem::create(&jobSystemCreateInfo, &jobSystem);
+        std::vector<uint32_t> values(100000, 0);
+        std::mutex mutex;
+        std::set<std::thread::id> threadIds;
+        jobSystem.parallel_for(values.size(), 64,
+            [&](size_t begin, size_t end)
+            {
+                EXPECT_LE(end - begin, 64u);
+                for (size_t i = begin; i < end; ++i) {
+                    ++values[i];
+                }
+                std::lock_guard<std::mutex> lock(mutex);
+                threadIds.insert(std::this_thread::get_id());
+            }
+        );
+        for (auto value : values) {
+            EXPECT_EQ(value, 1u);
+        }
+        EXPECT_LE(threadIds.size(), jobSystem.get_thread_count());
+    }
+}
+
+TEST(JobSystem, MainThreadOnly)
+{
+    // A JobSystem with no workers executes everything on the waiting thread.
+    JobSystem::CreateInfo jobSystemCreateInfo { };
+    jobSystemCreateInfo.workerCount = 0;
+    JobSystem jobSystem;
+    JobSystem::create(&jobSystemCreateInfo, &jobSystem);
+    if (jobSystem.get_thread_count() == 1) {
+        auto threadId = std::this_thread::get_id();
+        JobCounter counter;
+        bool executed = false;
+        jobSystem.run(&counter, [&]() { executed = std::this_thread::get_id() == threadId; });
+        EXPECT_FALSE(counter.is_complete());
+        jobSystem.wait(&counter);
+        EXPECT_TRUE(executed);
+    }
+}
+
+} // namespace tests
+} // namespace dst
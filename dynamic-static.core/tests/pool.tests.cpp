@@ -0,0 +1,100 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#include "dynamic-static/pool.hpp"
+
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <set>
+#include <vector>
+
+namespace dst {
+namespace tests {
+
+struct PoolObject final
+{
+    PoolObject(int value, int* pLiveCount)
+        : value { value }
+        , pLiveCount { pLiveCount }
+    {
+        ++*pLiveCount;
+    }
+
+    ~PoolObject()
+    {
+        --*pLiveCount;
+    }
+
+    int value { 0 };
+    int* pLiveCount { nullptr };
+};
+
+TEST(Pool, AcquireRelease)
+{
+    int liveCount = 0;
+    Pool<PoolObject, 4> pool;
+    std::vector<PoolObject*> pObjects;
+    for (int i = 0; i < 10; ++i) {
+        pObjects.push_back(pool.acquire(i, &liveCount));
+    }
+    EXPECT_EQ(liveCount, 10);
+    EXPECT_EQ(pool.size(), 10u);
+    EXPECT_EQ(pool.capacity(), 12u);
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_EQ(pObjects[i]->value, i);
+        EXPECT_EQ((uintptr_t)pObjects[i] % alignof(PoolObject), 0u);
+    }
+    EXPECT_EQ(std::set<PoolObject*>(pObjects.begin(), pObjects.end()).size(), 10u);
+
+    // Released nodes are reused before any new chunk is allocated.
+    auto pReleased = pObjects[3];
+    pool.release(pReleased);
+    EXPECT_EQ(liveCount, 9);
+    EXPECT_EQ(pool.acquire(42, &liveCount), pReleased);
+    EXPECT_EQ(pReleased->value, 42);
+    EXPECT_EQ(pool.capacity(), 12u);
+    for (auto pObject : pObjects) {
+        pool.release(pObject);
+    }
+    EXPECT_EQ(liveCount, 0);
+    EXPECT_EQ(pool.size(), 0u);
+}
+
+TEST(Pool, Reserve)
+{
+    Pool<uint8_t, 16> pool;
+    pool.reserve(20);
+    EXPECT_EQ(pool.capacity(), 32u);
+    auto pValue = pool.acquire((uint8_t)7);
+    EXPECT_EQ(*pValue, 7);
+    pool.release(pValue);
+    pool.reset();
+    EXPECT_EQ(pool.capacity(), 0u);
+}
+
+} // namespace tests
+} // namespace dst
@@ -0,0 +1,208 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#include "dynamic-static/profiler.hpp"
+
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace dst {
+namespace tests {
+
+static void sleep_zone(const char* pName, int milliseconds)
+{
+    profiler::Scope scope(pName);
+    std::this_thread::sleep_for(std::chrono::milliseconds(milliseconds));
+}
+
+TEST(Profiler, Nesting)
+{
+    profiler::clear();
+    {
+        profiler::Scope outerScope("outer");
+        {
+            profiler::Scope innerScope("inner");
+        }
+    }
+    std::vector<profiler::Event> events;
+    profiler::get_events(&events);
+    ASSERT_EQ(events.size(), 2u);
+    EXPECT_STREQ(events[0].pName, "inner");
+    EXPECT_EQ(events[0].depth, 1u);
+    EXPECT_STREQ(events[1].pName, "outer");
+    EXPECT_EQ(events[1].depth, 0u);
+    EXPECT_LE(events[1].beginTimestamp, events[0].beginTimestamp);
+    EXPECT_LE(events[0].endTimestamp, events[1].endTimestamp);
+}
+
+TEST(Profiler, Threads)
+{
+    profiler::clear();
+    std::vector<std::thread> threads;
+    for (int thread_i = 0; thread_i < 4; ++thread_i) {
+        threads.emplace_back([]() {
+            for (int i = 0; i < 100; ++i) {
+                profiler::Scope scope("thread");
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    std::vector<profiler::Event> events;
+    profiler::get_events(&events);
+    EXPECT_EQ(events.size(), 400u);
+}
+
+TEST(Profiler, RingBufferWraps)
+{
+    profiler::clear();
+    for (int i = 0; i < 100000; ++i) {
+        profiler::Scope scope("wrap");
+    }
+    std::vector<profiler::Event> events;
+    profiler::get_events(&events);
+    EXPECT_LT(0u, events.size());
+    EXPECT_LT(events.size(), 100000u);
+}
+
+TEST(Profiler, RingBufferBoundary)
+{
+    // Once a thread has recorded EventCapacity events its oldest event may be
+    //  mid overwrite so it's discarded.
+    profiler::clear();
+    auto record_zones = [](const char* pName, uint64_t count)
+    {
+        for (uint64_t i = 0; i < count; ++i) {
+            profiler::Scope scope(pName);
+        }
+    };
+    record_zones("first", 1);
+    record_zones("second", 1);
+    record_zones("boundary", profiler::EventCapacity - 3);
+    std::vector<profiler::Event> events;
+    profiler::get_events(&events);
+    ASSERT_EQ(events.size(), profiler::EventCapacity - 1);
+    EXPECT_STREQ(events.front().pName, "first");
+    record_zones("boundary", 1);
+    profiler::get_events(&events);
+    ASSERT_EQ(events.size(), profiler::EventCapacity - 1);
+    EXPECT_STREQ(events.front().pName, "second");
+    record_zones("boundary", 1);
+    profiler::get_events(&events);
+    ASSERT_EQ(events.size(), profiler::EventCapacity - 1);
+    EXPECT_STREQ(events.front().pName, "boundary");
+}
+
+TEST(Profiler, ConcurrentRead)
+{
+    // Events are read while another thread wraps its ring buffer, any event the
+    //  recording thread overwrote during the copy would break the order of its
+    //  timestamps.
+    profiler::clear();
+    std::atomic_bool recording { true };
+    std::thread thread([&]() {
+        while (recording) {
+            profiler::Scope scope("concurrent");
+        }
+    });
+    std::vector<profiler::Event> events;
+    for (int i = 0; i < 64; ++i) {
+        profiler::get_events(&events);
+        const profiler::Event* pPreviousEvent = nullptr;
+        for (const auto& event : events) {
+            ASSERT_STREQ(event.pName, "concurrent");
+            ASSERT_LE(event.beginTimestamp, event.endTimestamp);
+            if (pPreviousEvent) {
+                ASSERT_LE(pPreviousEvent->endTimestamp, event.beginTimestamp);
+            }
+            pPreviousEvent = &event;
+        }
+    }
+    recording = false;
+    thread.join();
+}
+
+TEST(Profiler, FrameSummary)
+{
+    profiler::clear();
+    profiler::begin_frame();
+    sleep_zone("excluded", 1);
+    profiler::begin_frame();
+    sleep_zone("a", 2);
+    sleep_zone("a", 2);
+    sleep_zone("b", 1);
+    profiler::begin_frame();
+    std::vector<profiler::ZoneSummary> zoneSummaries;
+    profiler::get_frame_summary(&zoneSummaries);
+    ASSERT_EQ(zoneSummaries.size(), 2u);
+    EXPECT_STREQ(zoneSummaries[0].pName, "a");
+    EXPECT_EQ(zoneSummaries[0].callCount, 2u);
+    EXPECT_LE(3.5, zoneSummaries[0].totalMilliseconds);
+    EXPECT_LE(1.5, zoneSummaries[0].maxMilliseconds);
+    EXPECT_STREQ(zoneSummaries[1].pName, "b");
+    EXPECT_EQ(zoneSummaries[1].callCount, 1u);
+}
+
+TEST(Profiler, ChromeTrace)
+{
+    profiler::clear();
+    {
+        profiler::Scope scope("quote\"d");
+    }
+    std::stringstream stream;
+    profiler::write_chrome_trace(stream);
+    auto trace = stream.str();
+    EXPECT_EQ(trace.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["), 0u);
+    EXPECT_NE(trace.find("\"name\":\"quote\\\"d\",\"ph\":\"X\""), std::string::npos);
+    EXPECT_NE(trace.find("]}"), std::string::npos);
+}
+
+TEST(Profiler, Macros)
+{
+    profiler::clear();
+    {
+        dst_profile_function();
+        dst_profile_scope("macro");
+    }
+    std::vector<profiler::Event> events;
+    profiler::get_events(&events);
+#ifdef DST_PROFILER_ENABLED
+    EXPECT_EQ(events.size(), 2u);
+#else
+    EXPECT_TRUE(events.empty());
+#endif
+}
+
+} // namespace tests
+} // namespace dst
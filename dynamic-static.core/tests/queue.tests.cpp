@@ -0,0 +1,160 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#include "dynamic-static/queue.hpp"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+namespace dst {
+namespace tests {
+
+TEST(Queue, SpscQueue)
+{
+    SpscQueue<int> queue(3);
+    EXPECT_EQ(queue.get_capacity(), 4);
+    EXPECT_TRUE(queue.empty());
+    int value = -1;
+    EXPECT_FALSE(queue.pop(&value));
+    for (int lap = 0; lap < 3; ++lap) {
+        for (int i = 0; i < 4; ++i) {
+            EXPECT_TRUE(queue.push(lap * 4 + i));
+        }
+        EXPECT_FALSE(queue.push(-1));
+        for (int i = 0; i < 4; ++i) {
+            EXPECT_TRUE(queue.pop(&value));
+            EXPECT_EQ(value, lap * 4 + i);
+        }
+        EXPECT_FALSE(queue.pop(&value));
+        EXPECT_TRUE(queue.empty());
+    }
+}
+
+TEST(Queue, SpscQueueConcurrent)
+{
+    // Values must arrive in order with none lost or duplicated.
+    constexpr int ValueCount = 1000000;
+    SpscQueue<int> queue(64);
+    std::thread producer([&]() {
+        for (int i = 0; i < ValueCount; ++i) {
+            while (!queue.push(i)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+    int expected = 0;
+    int value = 0;
+    bool ordered = true;
+    while (expected < ValueCount) {
+        if (queue.pop(&value)) {
+            ordered &= value == expected;
+            ++expected;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    EXPECT_TRUE(ordered);
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(Queue, MpmcQueue)
+{
+    MpmcQueue<int> queue(4);
+    EXPECT_EQ(queue.get_capacity(), 4);
+    int value = -1;
+    EXPECT_FALSE(queue.pop(&value));
+    for (int lap = 0; lap < 3; ++lap) {
+        for (int i = 0; i < 4; ++i) {
+            EXPECT_TRUE(queue.push(lap * 4 + i));
+        }
+        EXPECT_FALSE(queue.push(-1));
+        for (int i = 0; i < 4; ++i) {
+            EXPECT_TRUE(queue.pop(&value));
+            EXPECT_EQ(value, lap * 4 + i);
+        }
+        EXPECT_FALSE(queue.pop(&value));
+    }
+}
+
+TEST(Queue, MpmcQueueConcurrent)
+{
+    // Every pushed value must be popped exactly once, and values from any one
+    //  producer must be popped in the order that producer pushed them.
+    constexpr int ProducerCount = 4;
+    constexpr int ConsumerCount = 4;
+    constexpr int ValueCount = 100000;
+    MpmcQueue<int> queue(256);
+    std::vector<std::thread> threads;
+    for (int producer_i = 0; producer_i < ProducerCount; ++producer_i) {
+        threads.emplace_back([&, producer_i]() {
+            for (int i = 0; i < ValueCount; ++i) {
+                while (!queue.push(producer_i * ValueCount + i)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    std::atomic<int> poppedCount { 0 };
+    std::vector<std::vector<int>> poppedValues(ConsumerCount);
+    for (auto& values : poppedValues) {
+        threads.emplace_back([&]() {
+            int value = 0;
+            while (poppedCount < ProducerCount * ValueCount) {
+                if (queue.pop(&value)) {
+                    values.push_back(value);
+                    ++poppedCount;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    std::vector<int> allValues;
+    for (const auto& values : poppedValues) {
+        for (size_t i = 1; i < values.size(); ++i) {
+            if (values[i - 1] / ValueCount == values[i] / ValueCount) {
+                EXPECT_LT(values[i - 1], values[i]);
+            }
+        }
+        allValues.insert(allValues.end(), values.begin(), values.end());
+    }
+    std::sort(allValues.begin(), allValues.end());
+    std::vector<int> expectedValues(ProducerCount * ValueCount);
+    std::iota(expectedValues.begin(), expectedValues.end(), 0);
+    EXPECT_EQ(allValues, expectedValues);
+}
+
+} // namespace tests
+} // namespace dst
@@ -0,0 +1,281 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#include "dynamic-static/registry.hpp"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+namespace dst {
+namespace tests {
+
+struct Position final
+{
+    float x { 0 };
+    float y { 0 };
+};
+
+struct Velocity final
+{
+    float x { 0 };
+    float y { 0 };
+};
+
+struct Tag final
+{
+};
+
+TEST(Registry, CreateDestroyEntities)
+{
+    Registry registry;
+    auto entity0 = registry.create_entity();
+    auto entity1 = registry.create_entity();
+    EXPECT_EQ(registry.size(), 2u);
+    EXPECT_TRUE(registry.is_alive(entity0));
+    EXPECT_TRUE(registry.destroy_entity(entity0));
+    EXPECT_FALSE(registry.destroy_entity(entity0));
+    EXPECT_FALSE(registry.is_alive(entity0));
+    EXPECT_TRUE(registry.is_alive(entity1));
+    EXPECT_EQ(registry.size(), 1u);
+
+    // Reusing an index bumps its generation so the stale Entity stays invalid.
+    auto entity2 = registry.create_entity();
+    EXPECT_EQ(entity2.index, entity0.index);
+    EXPECT_NE(entity2.generation, entity0.generation);
+    EXPECT_FALSE(registry.is_alive(entity0));
+    EXPECT_FALSE(registry.is_alive(Entity { }));
+
+    registry.clear();
+    EXPECT_EQ(registry.size(), 0u);
+    EXPECT_FALSE(registry.is_alive(entity1));
+    EXPECT_FALSE(registry.is_alive(entity2));
+}
+
+TEST(Registry, Components)
+{
+    Registry registry;
+    auto entity0 = registry.create_entity();
+    auto entity1 = registry.create_entity();
+    registry.emplace<Position>(entity0, 1.0f, 2.0f);
+    registry.emplace<Position>(entity1, 3.0f, 4.0f);
+    registry.emplace<Velocity>(entity1, 5.0f, 6.0f);
+    EXPECT_TRUE(registry.has<Position>(entity0));
+    EXPECT_FALSE(registry.has<Velocity>(entity0));
+    EXPECT_FALSE(registry.has<Tag>(entity0));
+    EXPECT_EQ(registry.get<Tag>(entity0), nullptr);
+    EXPECT_EQ(registry.get<Position>(entity0)->x, 1.0f);
+    EXPECT_EQ(registry.get<Position>(entity1)->y, 4.0f);
+    EXPECT_EQ(registry.get<Velocity>(entity1)->x, 5.0f);
+
+    // Removing a component moves the last component into its place, Entities
+    //  still resolve to the correct component.
+    EXPECT_TRUE(registry.remove<Position>(entity0));
+    EXPECT_FALSE(registry.remove<Position>(entity0));
+    EXPECT_EQ(registry.get<Position>(entity0), nullptr);
+    EXPECT_EQ(registry.get<Position>(entity1)->x, 3.0f);
+    EXPECT_EQ(registry.get_storage<Position>().size(), 1u);
+
+    // Destroying an Entity removes all of its components.
+    EXPECT_TRUE(registry.destroy_entity(entity1));
+    EXPECT_TRUE(registry.get_storage<Position>().empty());
+    EXPECT_TRUE(registry.get_storage<Velocity>().empty());
+
+    // Components don't resolve for a stale Entity that shares an index.
+    auto entity2 = registry.create_entity();
+    registry.emplace<Position>(entity2);
+    EXPECT_EQ(entity2.index, entity1.index);
+    EXPECT_EQ(registry.get<Position>(entity1), nullptr);
+    EXPECT_NE(registry.get<Position>(entity2), nullptr);
+}
+
+TEST(Registry, DenseStorage)
+{
+    Registry registry;
+    std::vector<Entity> entities;
+    for (int i = 0; i < 8; ++i) {
+        entities.push_back(registry.create_entity());
+        registry.emplace<Position>(entities.back(), (float)i, 0.0f);
+    }
+    for (int i = 0; i < 8; i += 2) {
+        registry.destroy_entity(entities[i]);
+    }
+    const auto& positions = registry.get_storage<Position>();
+    ASSERT_EQ(positions.size(), 4u);
+    for (size_t i = 0; i < positions.size(); ++i) {
+        auto entity = positions.get_entities()[i];
+        EXPECT_EQ(registry.get<Position>(entity), &positions[i]);
+        EXPECT_EQ(entities[(size_t)positions[i].x], entity);
+    }
+}
+
+TEST(Registry, View)
+{
+    Registry registry;
+    std::vector<Entity> entities;
+    for (int i = 0; i < 16; ++i) {
+        auto entity = registry.create_entity();
+        registry.emplace<Position>(entity, (float)i, 0.0f);
+        if (i % 2) {
+            registry.emplace<Velocity>(entity, 1.0f, 2.0f);
+        }
+        if (i % 3 == 0) {
+            registry.emplace<Tag>(entity);
+        }
+        entities.push_back(entity);
+    }
+
+    // Only Entities with every requested component are visited.
+    std::vector<int> visited;
+    registry.each<Position, Velocity>(
+        [&](Entity entity, Position& position, Velocity& velocity)
+        {
+            EXPECT_EQ(registry.get<Position>(entity), &position);
+            EXPECT_EQ(registry.get<Velocity>(entity), &velocity);
+            position.y += velocity.y;
+            visited.push_back((int)position.x);
+        }
+    );
+    std::sort(visited.begin(), visited.end());
+    EXPECT_EQ(visited, (std::vector<int> { 1, 3, 5, 7, 9, 11, 13, 15 }));
+    for (int i = 0; i < 16; ++i) {
+        EXPECT_EQ(registry.get<Position>(entities[i])->y, i % 2 ? 2.0f : 0.0f);
+    }
+
+    visited.clear();
+    registry.each<Velocity, Tag, Position>(
+        [&](Entity, Velocity&, Tag&, Position& position)
+        {
+            visited.push_back((int)position.x);
+        }
+    );
+    std::sort(visited.begin(), visited.end());
+    EXPECT_EQ(visited, (std::vector<int> { 3, 9, 15 }));
+
+    // Views of component types that have never been used visit nothing.
+    struct Unused final { };
+    size_t unusedCount = 0;
+    registry.each<Position, Unused>([&](Entity, Position&, Unused&) { ++unusedCount; });
+    EXPECT_EQ(unusedCount, 0u);
+}
+
+TEST(Registry, DestroyDuringView)
+{
+    Registry registry;
+    for (int i = 0; i < 64; ++i) {
+        auto entity = registry.create_entity();
+        registry.emplace<Position>(entity, (float)i, 0.0f);
+        registry.emplace<Velocity>(entity);
+    }
+    size_t visitedCount = 0;
+    registry.each<Position, Velocity>(
+        [&](Entity entity, Position& position, Velocity&)
+        {
+            ++visitedCount;
+            if ((int)position.x % 3 == 0) {
+                registry.destroy_entity(entity);
+            } else if ((int)position.x % 3 == 1) {
+                registry.remove<Velocity>(entity);
+            }
+        }
+    );
+    EXPECT_EQ(visitedCount, 64u);
+    EXPECT_EQ(registry.size(), 42u);
+    EXPECT_EQ(registry.get_storage<Position>().size(), 42u);
+    EXPECT_EQ(registry.get_storage<Velocity>().size(), 21u);
+    for (const auto& position : registry.get_storage<Position>()) {
+        EXPECT_NE((int)position.x % 3, 0);
+    }
+}
+
+TEST(Registry, MoveOnlyComponents)
+{
+    Registry registry;
+    std::vector<Entity> entities;
+    for (int i = 0; i < 4; ++i) {
+        entities.push_back(registry.create_entity());
+        registry.emplace<std::unique_ptr<int>>(entities.back(), std::make_unique<int>(i));
+    }
+    registry.destroy_entity(entities[0]);
+    for (int i = 1; i < 4; ++i) {
+        EXPECT_EQ(**registry.get<std::unique_ptr<int>>(entities[i]), i);
+    }
+}
+
+TEST(Registry, RandomOperations)
+{
+    // Compare against a std::unordered_map through random operations.
+    Registry registry;
+    std::unordered_map<uint32_t, std::pair<Entity, int>> expected;
+    std::vector<Entity> entities;
+    std::mt19937 rng(0);
+    for (int i = 0; i < 8192; ++i) {
+        auto operation = rng() % 4;
+        if (operation == 0 || entities.empty()) {
+            auto entity = registry.create_entity();
+            entities.push_back(entity);
+            expected[entity.index] = { entity, -1 };
+        } else {
+            auto& entity = entities[rng() % entities.size()];
+            if (operation == 1) {
+                EXPECT_TRUE(registry.destroy_entity(entity));
+                expected.erase(entity.index);
+                entity = entities.back();
+                entities.pop_back();
+            } else if (operation == 2) {
+                if (!registry.has<int>(entity)) {
+                    registry.emplace<int>(entity, i);
+                    expected[entity.index].second = i;
+                }
+            } else {
+                registry.remove<int>(entity);
+                expected[entity.index].second = -1;
+            }
+        }
+    }
+    EXPECT_EQ(registry.size(), expected.size());
+    size_t componentCount = 0;
+    for (const auto& itr : expected) {
+        auto entity = itr.second.first;
+        EXPECT_TRUE(registry.is_alive(entity));
+        auto pComponent = registry.get<int>(entity);
+        if (itr.second.second == -1) {
+            EXPECT_EQ(pComponent, nullptr);
+        } else {
+            ASSERT_NE(pComponent, nullptr);
+            EXPECT_EQ(*pComponent, itr.second.second);
+            ++componentCount;
+        }
+    }
+    EXPECT_EQ(registry.get_storage<int>().size(), componentCount);
+}
+
+} // namespace tests
+} // namespace dst
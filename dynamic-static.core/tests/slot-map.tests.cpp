@@ -0,0 +1,133 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#include "dynamic-static/slot-map.hpp"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+namespace dst {
+namespace tests {
+
+TEST(SlotMap, InsertErase)
+{
+    SlotMap<int> slotMap;
+    auto handle0 = slotMap.insert(0);
+    auto handle1 = slotMap.insert(1);
+    auto handle2 = slotMap.insert(2);
+    EXPECT_EQ(slotMap.size(), 3u);
+    EXPECT_EQ(*slotMap.get(handle1), 1);
+    EXPECT_TRUE(slotMap.erase(handle0));
+    EXPECT_FALSE(slotMap.erase(handle0));
+    EXPECT_FALSE(slotMap.contains(handle0));
+    EXPECT_EQ(slotMap.get(handle0), nullptr);
+    EXPECT_EQ(*slotMap.get(handle1), 1);
+    EXPECT_EQ(*slotMap.get(handle2), 2);
+
+    // Reusing a slot bumps its generation so the stale Handle stays invalid.
+    auto handle3 = slotMap.insert(3);
+    EXPECT_EQ(handle3.index, handle0.index);
+    EXPECT_NE(handle3.generation, handle0.generation);
+    EXPECT_EQ(slotMap.get(handle0), nullptr);
+    EXPECT_EQ(*slotMap.get(handle3), 3);
+    EXPECT_FALSE(slotMap.contains(SlotMap<int>::Handle { }));
+}
+
+TEST(SlotMap, DenseIteration)
+{
+    SlotMap<int> slotMap;
+    std::vector<SlotMap<int>::Handle> handles;
+    for (int i = 0; i < 8; ++i) {
+        handles.push_back(slotMap.insert(i));
+    }
+    for (int i = 0; i < 8; i += 2) {
+        slotMap.erase(handles[i]);
+    }
+    std::vector<int> values(slotMap.begin(), slotMap.end());
+    std::sort(values.begin(), values.end());
+    EXPECT_EQ(values, (std::vector<int> { 1, 3, 5, 7 }));
+    for (size_t i = 0; i < slotMap.size(); ++i) {
+        EXPECT_EQ(slotMap.get(slotMap.get_handle(i)), &slotMap[i]);
+    }
+
+    // Erasing while iterating backwards visits every value exactly once.
+    for (size_t i = slotMap.size(); i--;) {
+        if (slotMap[i] % 3 == 1) {
+            slotMap.erase(slotMap.get_handle(i));
+        }
+    }
+    values.assign(slotMap.begin(), slotMap.end());
+    std::sort(values.begin(), values.end());
+    EXPECT_EQ(values, (std::vector<int> { 3, 5 }));
+}
+
+TEST(SlotMap, Clear)
+{
+    SlotMap<std::unique_ptr<int>> slotMap;
+    auto handle = slotMap.emplace(std::make_unique<int>(4));
+    EXPECT_EQ(**slotMap.get(handle), 4);
+    slotMap.clear();
+    EXPECT_TRUE(slotMap.empty());
+    EXPECT_FALSE(slotMap.contains(handle));
+    auto newHandle = slotMap.emplace(std::make_unique<int>(5));
+    EXPECT_FALSE(slotMap.contains(handle));
+    EXPECT_EQ(**slotMap.get(newHandle), 5);
+}
+
+TEST(SlotMap, RandomOperations)
+{
+    std::mt19937 engine(1);
+    SlotMap<uint32_t> slotMap;
+    std::unordered_map<uint32_t, SlotMap<uint32_t>::Handle> expected;
+    std::vector<SlotMap<uint32_t>::Handle> erasedHandles;
+    for (uint32_t i = 0; i < 10000; ++i) {
+        if (expected.empty() || engine() % 3) {
+            expected[i] = slotMap.insert(i);
+        } else {
+            auto itr = expected.begin();
+            std::advance(itr, engine() % expected.size());
+            EXPECT_TRUE(slotMap.erase(itr->second));
+            erasedHandles.push_back(itr->second);
+            expected.erase(itr);
+        }
+    }
+    EXPECT_EQ(slotMap.size(), expected.size());
+    for (const auto& [value, handle] : expected) {
+        ASSERT_TRUE(slotMap.contains(handle));
+        EXPECT_EQ(*slotMap.get(handle), value);
+    }
+    for (const auto& handle : erasedHandles) {
+        EXPECT_FALSE(slotMap.contains(handle));
+    }
+}
+
+} // namespace tests
+} // namespace dst
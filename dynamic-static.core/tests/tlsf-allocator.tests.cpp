@@ -0,0 +1,231 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+
+#include "dynamic-static/tlsf-allocator.hpp"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace dst {
+namespace tests {
+
+// Validates that live allocations don't overlap, stay in range, and that used
+//  size and allocation count agree with them.
+static void validate_allocations(const TlsfAllocator& tlsfAllocator, const std::vector<TlsfAllocator::Handle>& handles)
+{
+    struct Range final
+    {
+        uint64_t offset { 0 };
+        uint64_t size { 0 };
+    };
+    std::vector<Range> ranges;
+    uint64_t usedSize = 0;
+    for (auto handle : handles) {
+        ranges.push_back({ tlsfAllocator.get_offset(handle), tlsfAllocator.get_size(handle) });
+        usedSize += ranges.back().size;
+    }
+    std::sort(ranges.begin(), ranges.end(), [](const auto& lhs, const auto& rhs) { return lhs.offset < rhs.offset; });
+    for (size_t i = 1; i < ranges.size(); ++i) {
+        ASSERT_LE(ranges[i - 1].offset + ranges[i - 1].size, ranges[i].offset);
+    }
+    if (!ranges.empty()) {
+        ASSERT_LE(ranges.back().offset + ranges.back().size, tlsfAllocator.get_size());
+    }
+    ASSERT_EQ(tlsfAllocator.get_used_size(), usedSize);
+    ASSERT_EQ(tlsfAllocator.get_allocation_count(), handles.size());
+}
+
+TEST(TlsfAllocator, Allocate)
+{
+    TlsfAllocator::CreateInfo tlsfAllocatorCreateInfo { };
+    tlsfAllocatorCreateInfo.size = 1024;
+    TlsfAllocator tlsfAllocator;
+    TlsfAllocator::create(&tlsfAllocatorCreateInfo, &tlsfAllocator);
+    EXPECT_EQ(tlsfAllocator.get_free_block_count(), 1u);
+    auto handle0 = tlsfAllocator.allocate(3);
+    auto handle1 = tlsfAllocator.allocate(100);
+    auto handle2 = tlsfAllocator.allocate(921);
+    ASSERT_NE(handle0, TlsfAllocator::InvalidHandle);
+    ASSERT_NE(handle1, TlsfAllocator::InvalidHandle);
+    ASSERT_NE(handle2, TlsfAllocator::InvalidHandle);
+    EXPECT_EQ(tlsfAllocator.get_offset(handle0), 0u);
+    EXPECT_EQ(tlsfAllocator.get_offset(handle1), 3u);
+    EXPECT_EQ(tlsfAllocator.get_offset(handle2), 103u);
+    EXPECT_EQ(tlsfAllocator.get_size(handle1), 100u);
+    EXPECT_EQ(tlsfAllocator.get_used_size(), 1024u);
+    EXPECT_EQ(tlsfAllocator.get_free_block_count(), 0u);
+    EXPECT_EQ(tlsfAllocator.allocate(1), TlsfAllocator::InvalidHandle);
+    validate_allocations(tlsfAllocator, { handle0, handle1, handle2 });
+}
+
+TEST(TlsfAllocator, FreeCoalesces)
+{
+    TlsfAllocator::CreateInfo tlsfAllocatorCreateInfo { };
+    tlsfAllocatorCreateInfo.size = 1024;
+    TlsfAllocator tlsfAllocator;
+    TlsfAllocator::create(&tlsfAllocatorCreateInfo, &tlsfAllocator);
+    std::vector<TlsfAllocator::Handle> handles;
+    for (int i = 0; i < 4; ++i) {
+        handles.push_back(tlsfAllocator.allocate(256));
+        ASSERT_NE(handles.back(), TlsfAllocator::InvalidHandle);
+    }
+
+    // Freeing alternating blocks leaves two 256 holes, not one 512 hole.
+    tlsfAllocator.free(handles[0]);
+    tlsfAllocator.free(handles[2]);
+    EXPECT_EQ(tlsfAllocator.get_free_block_count(), 2u);
+    EXPECT_EQ(tlsfAllocator.allocate(512), TlsfAllocator::InvalidHandle);
+
+    // Freeing the block between them merges all three.
+    tlsfAllocator.free(handles[1]);
+    EXPECT_EQ(tlsfAllocator.get_free_block_count(), 1u);
+    auto handle = tlsfAllocator.allocate(768);
+    ASSERT_NE(handle, TlsfAllocator::InvalidHandle);
+    EXPECT_EQ(tlsfAllocator.get_offset(handle), 0u);
+    tlsfAllocator.free(handle);
+    tlsfAllocator.free(handles[3]);
+    EXPECT_EQ(tlsfAllocator.get_free_block_count(), 1u);
+    EXPECT_EQ(tlsfAllocator.get_used_size(), 0u);
+    EXPECT_EQ(tlsfAllocator.get_offset(tlsfAllocator.allocate(1024)), 0u);
+}
+
+TEST(TlsfAllocator, Stress)
+{
+    TlsfAllocator::CreateInfo tlsfAllocatorCreateInfo { };
+    tlsfAllocatorCreateInfo.size = 1 << 20;
+    TlsfAllocator tlsfAllocator;
+    TlsfAllocator::create(&tlsfAllocatorCreateInfo, &tlsfAllocator);
+    std::mt19937 random(7);
+    std::uniform_int_distribution<uint64_t> sizeDistribution(1, 1 << 14);
+    std::vector<TlsfAllocator::Handle> handles;
+    for (int i = 0; i < 10000; ++i) {
+        if (!handles.empty() && random() % 2) {
+            auto index = random() % handles.size();
+            tlsfAllocator.free(handles[index]);
+            handles[index] = handles.back();
+            handles.pop_back();
+        } else {
+            auto size = sizeDistribution(random);
+            auto handle = tlsfAllocator.allocate(size);
+            if (handle != TlsfAllocator::InvalidHandle) {
+                ASSERT_EQ(tlsfAllocator.get_size(handle), size);
+                handles.push_back(handle);
+            }
+        }
+        if (i % 100 == 0) {
+            validate_allocations(tlsfAllocator, handles);
+        }
+    }
+    validate_allocations(tlsfAllocator, handles);
+    for (auto handle : handles) {
+        tlsfAllocator.free(handle);
+    }
+    EXPECT_EQ(tlsfAllocator.get_used_size(), 0u);
+    EXPECT_EQ(tlsfAllocator.get_free_block_count(), 1u);
+}
+
+TEST(TlsfAllocator, Defragment)
+{
+    TlsfAllocator::CreateInfo tlsfAllocatorCreateInfo { };
+    tlsfAllocatorCreateInfo.size = 1024;
+    TlsfAllocator tlsfAllocator;
+    TlsfAllocator::create(&tlsfAllocatorCreateInfo, &tlsfAllocator);
+    std::vector<TlsfAllocator::Handle> handles;
+    for (int i = 0; i < 8; ++i) {
+        handles.push_back(tlsfAllocator.allocate(128));
+    }
+    for (int i = 0; i < 8; i += 2) {
+        tlsfAllocator.free(handles[i]);
+    }
+    EXPECT_EQ(tlsfAllocator.allocate(256), TlsfAllocator::InvalidHandle);
+
+    std::vector<TlsfAllocator::Move> moves;
+    tlsfAllocator.defragment(&moves);
+    ASSERT_EQ(moves.size(), 4u);
+    for (size_t i = 0; i < moves.size(); ++i) {
+        EXPECT_EQ(moves[i].handle, handles[i * 2 + 1]);
+        EXPECT_EQ(moves[i].srcOffset, (i * 2 + 1) * 128);
+        EXPECT_EQ(moves[i].dstOffset, i * 128);
+        EXPECT_EQ(moves[i].size, 128u);
+        EXPECT_EQ(tlsfAllocator.get_offset(moves[i].handle), moves[i].dstOffset);
+    }
+    EXPECT_EQ(tlsfAllocator.get_free_block_count(), 1u);
+    auto handle = tlsfAllocator.allocate(512);
+    ASSERT_NE(handle, TlsfAllocator::InvalidHandle);
+    EXPECT_EQ(tlsfAllocator.get_offset(handle), 512u);
+
+    // Defragmenting a packed allocator moves nothing.
+    moves.clear();
+    tlsfAllocator.defragment(&moves);
+    EXPECT_TRUE(moves.empty());
+    EXPECT_EQ(tlsfAllocator.get_free_block_count(), 0u);
+    tlsfAllocator.free(handle);
+    EXPECT_EQ(tlsfAllocator.get_free_block_count(), 1u);
+}
+
+TEST(TlsfAllocator, DefragmentStress)
+{
+    TlsfAllocator::CreateInfo tlsfAllocatorCreateInfo { };
+    tlsfAllocatorCreateInfo.size = 1 << 16;
+    TlsfAllocator tlsfAllocator;
+    TlsfAllocator::create(&tlsfAllocatorCreateInfo, &tlsfAllocator);
+    std::mt19937 random(11);
+    std::vector<TlsfAllocator::Handle> handles;
+    std::vector<TlsfAllocator::Move> moves;
+    for (int i = 0; i < 2000; ++i) {
+        if (!handles.empty() && random() % 3 == 0) {
+            auto index = random() % handles.size();
+            tlsfAllocator.free(handles[index]);
+            handles[index] = handles.back();
+            handles.pop_back();
+        } else {
+            auto handle = tlsfAllocator.allocate(random() % 512 + 1);
+            if (handle != TlsfAllocator::InvalidHandle) {
+                handles.push_back(handle);
+            }
+        }
+        if (i % 250 == 0) {
+            moves.clear();
+            tlsfAllocator.defragment(&moves);
+            for (size_t move_i = 0; move_i < moves.size(); ++move_i) {
+                ASSERT_LE(moves[move_i].dstOffset, moves[move_i].srcOffset);
+                if (move_i) {
+                    ASSERT_LT(moves[move_i - 1].srcOffset, moves[move_i].srcOffset);
+                }
+            }
+            EXPECT_LE(tlsfAllocator.get_free_block_count(), 1u);
+            validate_allocations(tlsfAllocator, handles);
+        }
+    }
+}
+
+} // namespace tests
+} // namespace dst
@@ -0,0 +1,160 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+
+#include "dynamic-static.graphics/bounding-volume-hierarchy.hpp"
+
+#include "benchmark/benchmark.h"
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace dst {
+namespace gfx {
+namespace benchmarks {
+
+// A scene of small objects scattered through a cube with a camera at its center
+//  looking down -z, roughly a sixth of the objects are visible.
+static std::vector<BoundingVolumeHierarchy::Aabb> create_aabbs(size_t count)
+{
+    std::mt19937 generator(5);
+    std::uniform_real_distribution<float> positionDistribution(-500, 500);
+    std::uniform_real_distribution<float> extentDistribution(0.5f, 2);
+    std::vector<BoundingVolumeHierarchy::Aabb> aabbs(count);
+    for (auto& aabb : aabbs) {
+        glm::vec3 position { positionDistribution(generator), positionDistribution(generator), positionDistribution(generator) };
+        glm::vec3 extents { extentDistribution(generator), extentDistribution(generator), extentDistribution(generator) };
+        aabb = { position - extents, position + extents };
+    }
+    return aabbs;
+}
+
+static Frustum create_frustum()
+{
+    return make_frustum(glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 1000.0f) * glm::lookAt({ 0, 0, 0 }, { 0, 0, -1 }, { 0, 1, 0 }));
+}
+
+static void create_bounding_volume_hierarchy(const std::vector<BoundingVolumeHierarchy::Aabb>& aabbs, BoundingVolumeHierarchy* pBoundingVolumeHierarchy, std::vector<BoundingVolumeHierarchy::ProxyId>* pProxyIds)
+{
+    BoundingVolumeHierarchy::CreateInfo boundingVolumeHierarchyCreateInfo { };
+    boundingVolumeHierarchyCreateInfo.capacity = (uint32_t)aabbs.size();
+    BoundingVolumeHierarchy::create(&boundingVolumeHierarchyCreateInfo, pBoundingVolumeHierarchy);
+    pProxyIds->clear();
+    for (uint32_t i = 0; i < (uint32_t)aabbs.size(); ++i) {
+        pProxyIds->push_back(pBoundingVolumeHierarchy->create_proxy(aabbs[i], i));
+    }
+}
+
+static void BoundingVolumeHierarchy_create(benchmark::State& state)
+{
+    auto aabbs = create_aabbs((size_t)state.range(0));
+    BoundingVolumeHierarchy boundingVolumeHierarchy;
+    std::vector<BoundingVolumeHierarchy::ProxyId> proxyIds;
+    for (auto _ : state) {
+        create_bounding_volume_hierarchy(aabbs, &boundingVolumeHierarchy, &proxyIds);
+        benchmark::DoNotOptimize(boundingVolumeHierarchy.get_height());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BoundingVolumeHierarchy_create)->Arg(100000)->Unit(benchmark::kMillisecond);
+
+static void BoundingVolumeHierarchy_update(benchmark::State& state)
+{
+    // Every object moves each frame, about one in ten leaves its margin.
+    auto aabbs = create_aabbs((size_t)state.range(0));
+    BoundingVolumeHierarchy boundingVolumeHierarchy;
+    std::vector<BoundingVolumeHierarchy::ProxyId> proxyIds;
+    create_bounding_volume_hierarchy(aabbs, &boundingVolumeHierarchy, &proxyIds);
+    std::mt19937 generator(7);
+    std::uniform_real_distribution<float> offsetDistribution(-0.02f, 0.02f);
+    for (auto _ : state) {
+        for (size_t i = 0; i < aabbs.size(); ++i) {
+            glm::vec3 offset { offsetDistribution(generator), offsetDistribution(generator), offsetDistribution(generator) };
+            aabbs[i] = { aabbs[i].min + offset, aabbs[i].max + offset };
+            boundingVolumeHierarchy.update_proxy(proxyIds[i], aabbs[i]);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BoundingVolumeHierarchy_update)->Arg(100000)->Unit(benchmark::kMillisecond);
+
+static void BoundingVolumeHierarchy_cull_brute_force(benchmark::State& state)
+{
+    auto aabbs = create_aabbs((size_t)state.range(0));
+    auto frustum = create_frustum();
+    std::vector<uint32_t> indices;
+    for (auto _ : state) {
+        indices.clear();
+        for (uint32_t i = 0; i < (uint32_t)aabbs.size(); ++i) {
+            if (intersects_aabb(frustum, aabbs[i].min, aabbs[i].max)) {
+                indices.push_back(i);
+            }
+        }
+        benchmark::DoNotOptimize(indices.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BoundingVolumeHierarchy_cull_brute_force)->Arg(100000)->Unit(benchmark::kMicrosecond);
+
+static void BoundingVolumeHierarchy_cull(benchmark::State& state)
+{
+    auto aabbs = create_aabbs((size_t)state.range(0));
+    BoundingVolumeHierarchy boundingVolumeHierarchy;
+    std::vector<BoundingVolumeHierarchy::ProxyId> proxyIds;
+    create_bounding_volume_hierarchy(aabbs, &boundingVolumeHierarchy, &proxyIds);
+    auto frustum = create_frustum();
+    std::vector<uint32_t> indices;
+    for (auto _ : state) {
+        boundingVolumeHierarchy.cull(frustum, &indices);
+        benchmark::DoNotOptimize(indices.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BoundingVolumeHierarchy_cull)->Arg(100000)->Unit(benchmark::kMicrosecond);
+
+static void BoundingVolumeHierarchy_cull_parallel(benchmark::State& state)
+{
+    auto aabbs = create_aabbs((size_t)state.range(0));
+    BoundingVolumeHierarchy boundingVolumeHierarchy;
+    std::vector<BoundingVolumeHierarchy::ProxyId> proxyIds;
+    create_bounding_volume_hierarchy(aabbs, &boundingVolumeHierarchy, &proxyIds);
+    JobSystem::CreateInfo jobSystemCreateInfo { };
+    JobSystem jobSystem;
+    JobSystem::create(&jobSystemCreateInfo, &jobSystem);
+    auto frustum = create_frustum();
+    std::vector<uint32_t> indices;
+    for (auto _ : state) {
+        boundingVolumeHierarchy.cull(frustum, jobSystem, &indices);
+        benchmark::DoNotOptimize(indices.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BoundingVolumeHierarchy_cull_parallel)->Arg(100000)->Unit(benchmark::kMicrosecond)->UseRealTime();
+
+} // namespace benchmarks
+} // namespace gfx
+} // namespace dst
@@ -0,0 +1,77 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+
+#include "dynamic-static.graphics/instance-batcher.hpp"
+
+#include "benchmark/benchmark.h"
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace dst {
+namespace gfx {
+namespace benchmarks {
+
+static void InstanceBatcher_build(benchmark::State& state)
+{
+    // A dense scene of state.range(0) objects sharing 4 meshes, ie. bricks,
+    //  barriers, a paddle and balls.  Sorts the frame's draws then packs the
+    //  instance stream, the "draws" counter is the number of instanced draws
+    //  recorded instead of one draw per object.
+    std::mt19937 generator(5);
+    std::uniform_int_distribution<uint32_t> meshDistribution(0, 3);
+    std::uniform_real_distribution<float> depthDistribution(0, 1);
+    std::vector<uint64_t> sortKeys((size_t)state.range(0));
+    std::vector<InstanceWorldColor> sourceInstances(sortKeys.size());
+    for (auto& sortKey : sortKeys) {
+        sortKey = RenderQueue::create_sort_key(0, 0, meshDistribution(generator), depthDistribution(generator));
+    }
+    RenderQueue::CreateInfo renderQueueCreateInfo { };
+    renderQueueCreateInfo.capacity = sortKeys.size();
+    RenderQueue renderQueue;
+    RenderQueue::create(&renderQueueCreateInfo, &renderQueue);
+    InstanceBatcher<>::CreateInfo instanceBatcherCreateInfo { };
+    instanceBatcherCreateInfo.capacity = sortKeys.size();
+    InstanceBatcher<> instanceBatcher;
+    InstanceBatcher<>::create(&instanceBatcherCreateInfo, &instanceBatcher);
+    for (auto _ : state) {
+        renderQueue.clear();
+        for (uint32_t i = 0; i < (uint32_t)sortKeys.size(); ++i) {
+            renderQueue.submit(sortKeys[i], i);
+        }
+        instanceBatcher.build(renderQueue.sort(), [&](uint32_t item) { return sourceInstances[item]; });
+        benchmark::DoNotOptimize(instanceBatcher.get_instances().data());
+    }
+    state.counters["draws"] = (double)instanceBatcher.get_batches().size();
+    state.SetItemsProcessed(state.iterations() * sortKeys.size());
+}
+BENCHMARK(InstanceBatcher_build)->Arg(1000)->Arg(10000)->Unit(benchmark::kMicrosecond);
+
+} // namespace benchmarks
+} // namespace gfx
+} // namespace dst
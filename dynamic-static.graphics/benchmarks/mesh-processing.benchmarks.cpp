@@ -0,0 +1,110 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#include "dynamic-static.graphics/mesh-processing.hpp"
+#include "dynamic-static.graphics/primitives.hpp"
+
+#include "benchmark/benchmark.h"
+
+#include <vector>
+
+namespace dst {
+namespace gfx {
+namespace benchmarks {
+
+static void create_icosphere_vertices(uint32_t subdivisions, std::vector<VertexPositionNormalTangentTexcoord>* pVertices, std::vector<primitive::Triangle<uint32_t>>* pTriangles)
+{
+    std::vector<glm::vec3> positions;
+    primitive::create_icosphere<uint32_t>(1, subdivisions, &positions, pTriangles);
+    pVertices->clear();
+    for (const auto& position : positions) {
+        VertexPositionNormalTangentTexcoord vertex { };
+        vertex.position = position;
+        vertex.texcoord = { position.x, position.y };
+        pVertices->push_back(vertex);
+    }
+}
+
+static void MeshProcessing_compute_normals(benchmark::State& state)
+{
+    std::vector<VertexPositionNormalTangentTexcoord> vertices;
+    std::vector<primitive::Triangle<uint32_t>> triangles;
+    create_icosphere_vertices((uint32_t)state.range(0), &vertices, &triangles);
+    auto weighting = (NormalWeighting)state.range(1);
+    for (auto _ : state) {
+        compute_normals<uint32_t, VertexPositionNormalTangentTexcoord>(triangles, weighting, vertices);
+        benchmark::DoNotOptimize(vertices.data());
+    }
+    state.SetItemsProcessed(state.iterations() * triangles.size());
+}
+BENCHMARK(MeshProcessing_compute_normals)
+    ->ArgsProduct({ { 4, 6 }, { (int64_t)NormalWeighting::Area, (int64_t)NormalWeighting::Angle } })
+    ->Unit(benchmark::kMicrosecond);
+
+static void MeshProcessing_compute_tangents(benchmark::State& state)
+{
+    std::vector<VertexPositionNormalTangentTexcoord> vertices;
+    std::vector<primitive::Triangle<uint32_t>> triangles;
+    create_icosphere_vertices((uint32_t)state.range(0), &vertices, &triangles);
+    compute_normals<uint32_t, VertexPositionNormalTangentTexcoord>(triangles, NormalWeighting::Area, vertices);
+    for (auto _ : state) {
+        compute_tangents<uint32_t, VertexPositionNormalTangentTexcoord>(triangles, vertices);
+        benchmark::DoNotOptimize(vertices.data());
+    }
+    state.SetItemsProcessed(state.iterations() * triangles.size());
+}
+BENCHMARK(MeshProcessing_compute_tangents)->Arg(4)->Arg(6)->Unit(benchmark::kMicrosecond);
+
+static void MeshProcessing_weld_vertices(benchmark::State& state)
+{
+    // Unrolls the icosphere into a triangle soup so every vertex has duplicates.
+    std::vector<VertexPositionNormalTangentTexcoord> vertices;
+    std::vector<primitive::Triangle<uint32_t>> triangles;
+    create_icosphere_vertices((uint32_t)state.range(0), &vertices, &triangles);
+    std::vector<VertexPositionNormalTangentTexcoord> soupVertices;
+    std::vector<primitive::Triangle<uint32_t>> soupTriangles;
+    for (const auto& triangle : triangles) {
+        auto index = (uint32_t)soupVertices.size();
+        for (uint32_t i = 0; i < 3; ++i) {
+            soupVertices.push_back(vertices[triangle[i]]);
+        }
+        soupTriangles.push_back({ index, index + 1, index + 2 });
+    }
+    for (auto _ : state) {
+        state.PauseTiming();
+        vertices = soupVertices;
+        triangles = soupTriangles;
+        state.ResumeTiming();
+        weld_vertices(0.0001f, &vertices, &triangles);
+        benchmark::DoNotOptimize(vertices.data());
+    }
+    state.SetItemsProcessed(state.iterations() * soupTriangles.size());
+}
+BENCHMARK(MeshProcessing_weld_vertices)->Arg(4)->Arg(6)->Unit(benchmark::kMicrosecond);
+
+} // namespace benchmarks
+} // namespace gfx
+} // namespace dst
@@ -0,0 +1,79 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#include "dynamic-static.graphics/meshlet.hpp"
+#include "dynamic-static.graphics/primitives.hpp"
+#include "dynamic-static.graphics/vertex-cache.hpp"
+
+#include "benchmark/benchmark.h"
+
+#include <vector>
+
+namespace dst {
+namespace gfx {
+namespace benchmarks {
+
+static void Meshlet_build_meshlets(benchmark::State& state)
+{
+    std::vector<glm::vec3> vertices;
+    std::vector<primitive::Triangle<uint32_t>> triangles;
+    primitive::create_icosphere<uint32_t>(1, (uint32_t)state.range(0), &vertices, &triangles);
+    optimize_vertex_cache<uint32_t>(triangles, vertices.size());
+    MeshletMesh meshletMesh;
+    for (auto _ : state) {
+        build_meshlets<uint32_t>(vertices, triangles, Meshlet::DefaultMaxVertexCount, Meshlet::DefaultMaxTriangleCount, &meshletMesh);
+        benchmark::DoNotOptimize(meshletMesh.meshlets.data());
+    }
+    state.counters["meshlets"] = (double)meshletMesh.meshlets.size();
+    state.SetItemsProcessed(state.iterations() * triangles.size());
+}
+BENCHMARK(Meshlet_build_meshlets)->Arg(4)->Arg(6)->Unit(benchmark::kMicrosecond);
+
+static void Meshlet_cull_meshlets(benchmark::State& state)
+{
+    std::vector<glm::vec3> vertices;
+    std::vector<primitive::Triangle<uint32_t>> triangles;
+    primitive::create_icosphere<uint32_t>(1, (uint32_t)state.range(0), &vertices, &triangles);
+    optimize_vertex_cache<uint32_t>(triangles, vertices.size());
+    MeshletMesh meshletMesh;
+    build_meshlets<uint32_t>(vertices, triangles, Meshlet::DefaultMaxVertexCount, Meshlet::DefaultMaxTriangleCount, &meshletMesh);
+    glm::vec3 cameraPosition { 0, 0, 1.5f };
+    auto view = glm::lookAt(cameraPosition, glm::vec3 { 0, 0, 0 }, glm::vec3 { 0, 1, 0 });
+    auto projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.01f, 100.0f);
+    auto frustum = make_frustum(projection * view);
+    std::vector<uint32_t> visibleMeshlets;
+    for (auto _ : state) {
+        cull_meshlets(meshletMesh.meshlets, frustum, cameraPosition, &visibleMeshlets);
+        benchmark::DoNotOptimize(visibleMeshlets.data());
+    }
+    state.counters["visible"] = (double)visibleMeshlets.size() / (double)meshletMesh.meshlets.size();
+    state.SetItemsProcessed(state.iterations() * meshletMesh.meshlets.size());
+}
+BENCHMARK(Meshlet_cull_meshlets)->Arg(4)->Arg(6)->Unit(benchmark::kMicrosecond);
+
+} // namespace benchmarks
+} // namespace gfx
+} // namespace dst
@@ -0,0 +1,177 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+
+
+#include "dynamic-static.graphics/occlusion-culler.hpp"
+#include "dynamic-static/batch-math.hpp"
+
+#include "benchmark/benchmark.h"
+
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace dst {
+namespace gfx {
+namespace benchmarks {
+
+// A camera looking down a grid of buildings with small objects scattered among
+//  them.  Each benchmark takes { count, InstructionSet } and is skipped when the
+//  InstructionSet isn't supported.
+struct OcclusionScene final
+{
+    OcclusionScene(size_t objectCount)
+    {
+        viewProjection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 500.0f) * glm::lookAt({ 0, 4, 0 }, { 0, 2, -20 }, { 0, 1, 0 });
+        for (int32_t x = -8; x < 8; ++x) {
+            for (int32_t z = 1; z <= 16; ++z) {
+                buildingCenters.push_back({ x * 20.0f, 10, z * -20.0f });
+            }
+        }
+        std::mt19937 generator(5);
+        std::uniform_real_distribution<float> xDistribution(-160, 160);
+        std::uniform_real_distribution<float> yDistribution(0, 20);
+        std::uniform_real_distribution<float> zDistribution(-330, -10);
+        objects.resize(objectCount);
+        for (auto& object : objects) {
+            glm::vec3 center { xDistribution(generator), yDistribution(generator), zDistribution(generator) };
+            object = { center - 0.5f, center + 0.5f };
+        }
+    }
+
+    void add_occluders(OcclusionCuller& occlusionCuller) const
+    {
+        occlusionCuller.begin_frame(viewProjection);
+        for (const auto& buildingCenter : buildingCenters) {
+            auto world = glm::scale(glm::translate(glm::mat4 { 1 }, buildingCenter), { 12, 20, 12 });
+            occlusionCuller.add_occluder(primitive::Cube::Vertices, primitive::Cube::Triangles, world);
+        }
+    }
+
+    glm::mat4 viewProjection { 1 };
+    std::vector<glm::vec3> buildingCenters;
+    std::vector<std::pair<glm::vec3, glm::vec3>> objects;
+};
+
+static OcclusionCuller create_occlusion_culler()
+{
+    OcclusionCuller::CreateInfo occlusionCullerCreateInfo { };
+    OcclusionCuller occlusionCuller;
+    OcclusionCuller::create(&occlusionCullerCreateInfo, &occlusionCuller);
+    return occlusionCuller;
+}
+
+static bool set_instruction_set(benchmark::State& state)
+{
+    auto instructionSet = (batch::InstructionSet)state.range(1);
+    if (!batch::is_supported(instructionSet)) {
+        state.SkipWithError("InstructionSet not supported");
+        return false;
+    }
+    batch::set_instruction_set(instructionSet);
+    const char* pLabels[] { "Scalar", "Sse2", "Avx2", "Neon" };
+    state.SetLabel(pLabels[state.range(1)]);
+    return true;
+}
+
+static void apply_arguments(benchmark::internal::Benchmark* pBenchmark)
+{
+    for (auto instructionSet : { batch::InstructionSet::Scalar, batch::InstructionSet::Sse2, batch::InstructionSet::Avx2, batch::InstructionSet::Neon }) {
+        if (batch::is_supported(instructionSet)) {
+            pBenchmark->Args({ 65536, (int64_t)instructionSet });
+        }
+    }
+}
+
+static void OcclusionCuller_add_occluders(benchmark::State& state)
+{
+    OcclusionScene scene((size_t)state.range(0));
+    auto occlusionCuller = create_occlusion_culler();
+    for (auto _ : state) {
+        scene.add_occluders(occlusionCuller);
+        benchmark::DoNotOptimize(occlusionCuller.get_triangle_count());
+    }
+    state.SetItemsProcessed(state.iterations() * scene.buildingCenters.size() * primitive::Cube::Triangles.size());
+}
+BENCHMARK(OcclusionCuller_add_occluders)->Arg(0)->Unit(benchmark::kMicrosecond);
+
+static void OcclusionCuller_rasterize(benchmark::State& state)
+{
+    if (set_instruction_set(state)) {
+        OcclusionScene scene(0);
+        auto occlusionCuller = create_occlusion_culler();
+        scene.add_occluders(occlusionCuller);
+        for (auto _ : state) {
+            occlusionCuller.rasterize();
+            benchmark::DoNotOptimize(occlusionCuller.get_depths().data());
+        }
+        state.SetItemsProcessed(state.iterations() * occlusionCuller.get_triangle_count());
+    }
+}
+BENCHMARK(OcclusionCuller_rasterize)->Apply(apply_arguments)->Unit(benchmark::kMicrosecond);
+
+static void OcclusionCuller_rasterize_parallel(benchmark::State& state)
+{
+    if (set_instruction_set(state)) {
+        OcclusionScene scene(0);
+        auto occlusionCuller = create_occlusion_culler();
+        scene.add_occluders(occlusionCuller);
+        JobSystem::CreateInfo jobSystemCreateInfo { };
+        JobSystem jobSystem;
+        JobSystem::create(&jobSystemCreateInfo, &jobSystem);
+        for (auto _ : state) {
+            occlusionCuller.rasterize(jobSystem);
+            benchmark::DoNotOptimize(occlusionCuller.get_depths().data());
+        }
+        state.SetItemsProcessed(state.iterations() * occlusionCuller.get_triangle_count());
+    }
+}
+BENCHMARK(OcclusionCuller_rasterize_parallel)->Apply(apply_arguments)->Unit(benchmark::kMicrosecond)->UseRealTime();
+
+static void OcclusionCuller_is_visible(benchmark::State& state)
+{
+    if (set_instruction_set(state)) {
+        OcclusionScene scene((size_t)state.range(0));
+        auto occlusionCuller = create_occlusion_culler();
+        scene.add_occluders(occlusionCuller);
+        occlusionCuller.rasterize();
+        for (auto _ : state) {
+            size_t visibleCount = 0;
+            for (const auto& object : scene.objects) {
+                visibleCount += occlusionCuller.is_visible(object.first, object.second) ? 1 : 0;
+            }
+            benchmark::DoNotOptimize(visibleCount);
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+}
+BENCHMARK(OcclusionCuller_is_visible)->Apply(apply_arguments)->Unit(benchmark::kMicrosecond);
+
+} // namespace benchmarks
+} // namespace gfx
+} // namespace dst
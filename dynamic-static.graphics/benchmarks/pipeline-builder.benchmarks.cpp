@@ -0,0 +1,86 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+
+#include "dynamic-static.graphics/pipeline-builder.hpp"
+
+#include "benchmark/benchmark.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace dst {
+namespace gfx {
+namespace benchmarks {
+
+// Stands in for a SPIR-V compiler with a fixed amount of work per shader.
+static void compile_shader(gvk::spirv::ShaderInfo* pShaderInfo)
+{
+    auto hash = ShaderCache::hash({ (const uint8_t*)pShaderInfo->source.data(), pShaderInfo->source.size() });
+    for (uint32_t i = 0; i < 1 << 18; ++i) {
+        hash = ShaderCache::hash({ (const uint8_t*)&i, sizeof(i) }, hash);
+    }
+    pShaderInfo->spirv = { 0x07230203, (uint32_t)hash, (uint32_t)(hash >> 32) };
+}
+
+static void PipelineBuilder_build(benchmark::State& state)
+{
+    // 48 variants built from 16 vertex shaders and 3 fragment shaders, the
+    //  argument is the JobSystem worker count.
+    JobSystem::CreateInfo jobSystemCreateInfo { };
+    jobSystemCreateInfo.workerCount = (uint32_t)state.range(0);
+    JobSystem jobSystem;
+    JobSystem::create(&jobSystemCreateInfo, &jobSystem);
+    PipelineBuilder::CreateInfo pipelineBuilderCreateInfo { };
+    pipelineBuilderCreateInfo.pJobSystem = &jobSystem;
+    pipelineBuilderCreateInfo.compile = compile_shader;
+    PipelineBuilder pipelineBuilder;
+    for (auto _ : state) {
+        PipelineBuilder::create(&pipelineBuilderCreateInfo, &pipelineBuilder);
+        std::vector<PipelineBuilder::Description> descriptions(48);
+        for (uint32_t i = 0; i < descriptions.size(); ++i) {
+            gvk::spirv::ShaderInfo vertexShaderInfo { };
+            vertexShaderInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
+            vertexShaderInfo.source = std::to_string(i % 16);
+            gvk::spirv::ShaderInfo fragmentShaderInfo { };
+            fragmentShaderInfo.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+            fragmentShaderInfo.source = std::to_string(i % 3);
+            descriptions[i].shaderInfos = { vertexShaderInfo, fragmentShaderInfo };
+            descriptions[i].create = [](std::span<const gvk::spirv::ShaderInfo>) { return VK_SUCCESS; };
+        }
+        for (const auto& future : pipelineBuilder.build(std::move(descriptions))) {
+            benchmark::DoNotOptimize(future.get());
+        }
+    }
+    state.counters["shaders"] = pipelineBuilder.get_statistics().shaderCount;
+    state.SetItemsProcessed(state.iterations() * 48);
+}
+BENCHMARK(PipelineBuilder_build)->Arg(1)->Arg(3)->Arg(7)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+} // namespace benchmarks
+} // namespace gfx
+} // namespace dst
@@ -24,4 +24,29 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 *******************************************************************************/
 
-#include "dynamic-static/defines.hpp"
+#include "dynamic-static.graphics/primitives.hpp"
+
+#include "benchmark/benchmark.h"
+
+#include <vector>
+
+namespace dst {
+namespace gfx {
+namespace benchmarks {
+
+static void Primitives_create_icosphere(benchmark::State& state)
+{
+    std::vector<glm::vec3> vertices;
+    std::vector<primitive::Triangle<uint32_t>> triangles;
+    for (auto _ : state) {
+        primitive::create_icosphere<uint32_t>(1, (uint32_t)state.range(0), &vertices, &triangles);
+        benchmark::DoNotOptimize(vertices.data());
+        benchmark::DoNotOptimize(triangles.data());
+    }
+    state.SetItemsProcessed(state.iterations() * triangles.size());
+}
+BENCHMARK(Primitives_create_icosphere)->DenseRange(1, 6)->Unit(benchmark::kMicrosecond);
+
+} // namespace benchmarks
+} // namespace gfx
+} // namespace dst
@@ -0,0 +1,100 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+
+#include "dynamic-static.graphics/render-queue.hpp"
+
+#include "benchmark/benchmark.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace dst {
+namespace gfx {
+namespace benchmarks {
+
+static std::vector<uint64_t> create_sort_keys(size_t count)
+{
+    // A scene with a handful of pipelines, a few hundred materials, a few
+    //  thousand meshes and random depths.
+    std::mt19937 generator(3);
+    std::uniform_int_distribution<uint32_t> pipelineDistribution(0, 7);
+    std::uniform_int_distribution<uint32_t> materialDistribution(0, 255);
+    std::uniform_int_distribution<uint32_t> meshDistribution(0, 4095);
+    std::uniform_real_distribution<float> depthDistribution(0, 1);
+    std::vector<uint64_t> sortKeys(count);
+    for (auto& sortKey : sortKeys) {
+        sortKey = RenderQueue::create_sort_key(pipelineDistribution(generator), materialDistribution(generator), meshDistribution(generator), depthDistribution(generator));
+    }
+    return sortKeys;
+}
+
+static void RenderQueue_sort(benchmark::State& state)
+{
+    auto sortKeys = create_sort_keys((size_t)state.range(0));
+    RenderQueue::CreateInfo renderQueueCreateInfo { };
+    renderQueueCreateInfo.capacity = sortKeys.size();
+    RenderQueue renderQueue;
+    RenderQueue::create(&renderQueueCreateInfo, &renderQueue);
+    for (auto _ : state) {
+        renderQueue.clear();
+        for (uint32_t i = 0; i < (uint32_t)sortKeys.size(); ++i) {
+            renderQueue.submit(sortKeys[i], i);
+        }
+        benchmark::DoNotOptimize(renderQueue.sort().data());
+    }
+    const auto& statistics = renderQueue.get_statistics();
+    state.counters["pipelineBinds"] = statistics.pipelineBindCount;
+    state.counters["materialBinds"] = statistics.materialBindCount;
+    state.counters["meshBinds"] = statistics.meshBindCount;
+    state.SetItemsProcessed(state.iterations() * sortKeys.size());
+}
+BENCHMARK(RenderQueue_sort)->Arg(1000)->Arg(100000)->Unit(benchmark::kMicrosecond);
+
+static void RenderQueue_std_sort(benchmark::State& state)
+{
+    // Baseline, the same submissions sorted with std::stable_sort().
+    auto sortKeys = create_sort_keys((size_t)state.range(0));
+    std::vector<std::pair<uint64_t, uint32_t>> submissions;
+    submissions.reserve(sortKeys.size());
+    for (auto _ : state) {
+        submissions.clear();
+        for (uint32_t i = 0; i < (uint32_t)sortKeys.size(); ++i) {
+            submissions.push_back({ sortKeys[i], i });
+        }
+        std::stable_sort(submissions.begin(), submissions.end(), [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+        benchmark::DoNotOptimize(submissions.data());
+    }
+    state.SetItemsProcessed(state.iterations() * sortKeys.size());
+}
+BENCHMARK(RenderQueue_std_sort)->Arg(1000)->Arg(100000)->Unit(benchmark::kMicrosecond);
+
+} // namespace benchmarks
+} // namespace gfx
+} // namespace dst
@@ -0,0 +1,68 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#include "dynamic-static.graphics/primitives.hpp"
+#include "dynamic-static.graphics/simplification.hpp"
+
+#include "benchmark/benchmark.h"
+
+#include <vector>
+
+namespace dst {
+namespace gfx {
+namespace benchmarks {
+
+static void Simplification_simplify(benchmark::State& state)
+{
+    std::vector<glm::vec3> vertices;
+    std::vector<primitive::Triangle<uint32_t>> triangles;
+    primitive::create_icosphere<uint32_t>(1, (uint32_t)state.range(0), &vertices, &triangles);
+    std::vector<primitive::Triangle<uint32_t>> simplified;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(simplify<uint32_t>(vertices, triangles, triangles.size() / 4, 1, &simplified));
+    }
+    state.SetItemsProcessed(state.iterations() * triangles.size());
+}
+BENCHMARK(Simplification_simplify)->Arg(4)->Arg(5)->Unit(benchmark::kMillisecond);
+
+static void Simplification_create_lod_chain(benchmark::State& state)
+{
+    std::vector<glm::vec3> vertices;
+    std::vector<primitive::Triangle<uint32_t>> triangles;
+    primitive::create_icosphere<uint32_t>(1, (uint32_t)state.range(0), &vertices, &triangles);
+    std::vector<LodLevel<uint32_t>> lodLevels;
+    for (auto _ : state) {
+        create_lod_chain<uint32_t>(vertices, triangles, { }, &lodLevels);
+        benchmark::DoNotOptimize(lodLevels.data());
+    }
+    state.counters["levels"] = (double)lodLevels.size();
+    state.SetItemsProcessed(state.iterations() * triangles.size());
+}
+BENCHMARK(Simplification_create_lod_chain)->Arg(4)->Arg(5)->Unit(benchmark::kMillisecond);
+
+} // namespace benchmarks
+} // namespace gfx
+} // namespace dst
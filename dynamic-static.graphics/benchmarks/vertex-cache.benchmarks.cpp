@@ -0,0 +1,77 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#include "dynamic-static.graphics/primitives.hpp"
+#include "dynamic-static.graphics/vertex-cache.hpp"
+
+#include "benchmark/benchmark.h"
+
+#include <vector>
+
+namespace dst {
+namespace gfx {
+namespace benchmarks {
+
+static void VertexCache_optimize_vertex_cache(benchmark::State& state)
+{
+    std::vector<glm::vec3> vertices;
+    std::vector<primitive::Triangle<uint32_t>> sourceTriangles;
+    primitive::create_icosphere<uint32_t>(1, (uint32_t)state.range(0), &vertices, &sourceTriangles);
+    auto triangles = sourceTriangles;
+    for (auto _ : state) {
+        state.PauseTiming();
+        triangles = sourceTriangles;
+        state.ResumeTiming();
+        optimize_vertex_cache<uint32_t>(triangles, vertices.size());
+        benchmark::DoNotOptimize(triangles.data());
+    }
+    auto statistics = analyze_vertex_cache<uint32_t>(triangles, vertices.size());
+    state.counters["acmr"] = statistics.acmr;
+    state.SetItemsProcessed(state.iterations() * triangles.size());
+}
+BENCHMARK(VertexCache_optimize_vertex_cache)->Arg(4)->Arg(6)->Unit(benchmark::kMicrosecond);
+
+static void VertexCache_optimize_overdraw(benchmark::State& state)
+{
+    std::vector<glm::vec3> vertices;
+    std::vector<primitive::Triangle<uint32_t>> sourceTriangles;
+    primitive::create_icosphere<uint32_t>(1, (uint32_t)state.range(0), &vertices, &sourceTriangles);
+    optimize_vertex_cache<uint32_t>(sourceTriangles, vertices.size());
+    auto triangles = sourceTriangles;
+    for (auto _ : state) {
+        state.PauseTiming();
+        triangles = sourceTriangles;
+        state.ResumeTiming();
+        optimize_overdraw<uint32_t>(triangles, vertices);
+        benchmark::DoNotOptimize(triangles.data());
+    }
+    state.SetItemsProcessed(state.iterations() * triangles.size());
+}
+BENCHMARK(VertexCache_optimize_overdraw)->Arg(4)->Arg(6)->Unit(benchmark::kMicrosecond);
+
+} // namespace benchmarks
+} // namespace gfx
+} // namespace dst
@@ -0,0 +1,83 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#include "dynamic-static.graphics/vertex-compression.hpp"
+
+#include "benchmark/benchmark.h"
+
+#include <random>
+#include <vector>
+
+namespace dst {
+namespace gfx {
+namespace benchmarks {
+
+static std::vector<VertexPositionNormalTexcoordColor> create_random_vertices(size_t count)
+{
+    std::mt19937 rng(0);
+    std::uniform_real_distribution<float> distribution(-1, 1);
+    std::vector<VertexPositionNormalTexcoordColor> vertices(count);
+    for (auto& vertex : vertices) {
+        vertex.position = { distribution(rng) * 100, distribution(rng) * 100, distribution(rng) * 100 };
+        vertex.normal = glm::normalize(glm::vec3 { distribution(rng), distribution(rng), 1 });
+        vertex.texcoord = { distribution(rng), distribution(rng) };
+        vertex.color = { 1, distribution(rng) * 0.5f + 0.5f, 0, 1 };
+    }
+    return vertices;
+}
+
+static void VertexCompression_pack_vertices(benchmark::State& state)
+{
+    auto vertices = create_random_vertices((size_t)state.range(0));
+    auto bounds = compute_quantization_bounds(vertices.size(), &vertices[0].position, sizeof(vertices[0]));
+    std::vector<PackedVertexPositionNormalTexcoordColor> packedVertices(vertices.size());
+    for (auto _ : state) {
+        pack_vertices<VertexPositionNormalTexcoordColor, PackedVertexPositionNormalTexcoordColor>(vertices, bounds, packedVertices);
+        benchmark::DoNotOptimize(packedVertices.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(VertexPositionNormalTexcoordColor));
+}
+BENCHMARK(VertexCompression_pack_vertices)->Arg(1 << 16);
+
+static void VertexCompression_unpack_vertices(benchmark::State& state)
+{
+    auto vertices = create_random_vertices((size_t)state.range(0));
+    auto bounds = compute_quantization_bounds(vertices.size(), &vertices[0].position, sizeof(vertices[0]));
+    std::vector<PackedVertexPositionNormalTexcoordColor> packedVertices(vertices.size());
+    pack_vertices<VertexPositionNormalTexcoordColor, PackedVertexPositionNormalTexcoordColor>(vertices, bounds, packedVertices);
+    for (auto _ : state) {
+        unpack_vertices<PackedVertexPositionNormalTexcoordColor, VertexPositionNormalTexcoordColor>(packedVertices, bounds, vertices);
+        benchmark::DoNotOptimize(vertices.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(PackedVertexPositionNormalTexcoordColor));
+}
+BENCHMARK(VertexCompression_unpack_vertices)->Arg(1 << 16);
+
+} // namespace benchmarks
+} // namespace gfx
+} // namespace dst
@@ -0,0 +1,159 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+
+#pragma once
+
+#include "dynamic-static.graphics/defines.hpp"
+#include "dynamic-static.graphics/frustum.hpp"
+#include "dynamic-static/job-system.hpp"
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace dst {
+namespace gfx {
+
+class BoundingVolumeHierarchy final
+{
+public:
+    using ProxyId = uint32_t;
+    static constexpr ProxyId InvalidProxyId { std::numeric_limits<ProxyId>::max() };
+
+    struct CreateInfo final
+    {
+        // Proxy AABBs are stored enlarged by margin on every side so small
+        //  movements don't change the tree.
+        float margin { 0.1f };
+        uint32_t capacity { 0 };
+    };
+
+    struct Aabb final
+    {
+        glm::vec3 min { };
+        glm::vec3 max { };
+    };
+
+    // Dynamic AABB tree of renderables for CPU frustum culling.  Proxies are
+    //  inserted by walking down the branch with the smallest increase in surface
+    //  area and ancestors are refit and rebalanced with rotations on the way back
+    //  up, so moving a proxy costs O(log n) and the tree never needs rebuilding.
+    //  cull() writes the index of each proxy whose AABB intersects a Frustum.
+    // FROM : Catto - "Dynamic Bounding Volume Hierarchies"
+    static void create(const CreateInfo* pCreateInfo, BoundingVolumeHierarchy* pBoundingVolumeHierarchy);
+
+    uint32_t get_proxy_count() const;
+
+    // Returns the height of the tree, 0 for a single proxy.
+    int32_t get_height() const;
+
+    ProxyId create_proxy(const Aabb& aabb, uint32_t index);
+    void destroy_proxy(ProxyId proxyId);
+
+    // Refits the tree if aabb has left the proxy's enlarged AABB, returns true if
+    //  the tree changed.  Call when a proxy's transform is updated.
+    bool update_proxy(ProxyId proxyId, const Aabb& aabb);
+
+    // Returns the proxy's enlarged AABB, this is what cull() tests.
+    const Aabb& get_aabb(ProxyId proxyId) const;
+    uint32_t get_index(ProxyId proxyId) const;
+
+    // Writes the index of every proxy intersecting frustum to pIndices.  Each node
+    //  is tested against every plane at once with SIMD, planes a node is fully
+    //  inside are skipped for its descendants, and each node remembers the plane
+    //  that last rejected it and tests it first next time.
+    // FROM : Assarsson, Moller - "Optimized View Frustum Culling Algorithms for Bounding Boxes"
+    void cull(const Frustum& frustum, std::vector<uint32_t>* pIndices);
+
+    // Splits the tree into subtrees that are culled in parallel on jobSystem.
+    //  Must be called from the thread that created jobSystem or from within a
+    //  job.  Writes the same indices as cull() but not necessarily in the same
+    //  order.
+    void cull(const Frustum& frustum, JobSystem& jobSystem, std::vector<uint32_t>* pIndices);
+
+    void reset();
+
+private:
+    static constexpr uint32_t InvalidNode { std::numeric_limits<uint32_t>::max() };
+    static constexpr uint32_t OutsideMask { std::numeric_limits<uint32_t>::max() };
+
+    struct Node final
+    {
+        Aabb aabb { };
+        uint32_t parent { InvalidNode };
+        std::array<uint32_t, 2> children { InvalidNode, InvalidNode };
+        int32_t height { -1 };
+        uint32_t index { 0 };
+        uint32_t lastRejectedPlane { 0 };
+
+        inline bool is_leaf() const
+        {
+            return children[0] == InvalidNode;
+        }
+    };
+
+    // Frustum planes in structure of arrays layout padded to 8, padding planes
+    //  contain everything.
+    struct CullPlanes final
+    {
+        alignas(16) std::array<float, 8> x { };
+        alignas(16) std::array<float, 8> y { };
+        alignas(16) std::array<float, 8> z { };
+        alignas(16) std::array<float, 8> w { };
+        alignas(16) std::array<float, 8> absX { };
+        alignas(16) std::array<float, 8> absY { };
+        alignas(16) std::array<float, 8> absZ { };
+    };
+
+    static CullPlanes create_cull_planes(const Frustum& frustum);
+
+    // Returns planeMask without the planes node is fully inside, or OutsideMask
+    //  if node is fully outside one of the planes in planeMask.
+    uint32_t classify(const CullPlanes& cullPlanes, uint32_t node, uint32_t planeMask);
+    void cull_subtree(const CullPlanes& cullPlanes, uint32_t node, uint32_t planeMask, std::vector<uint32_t>* pIndices);
+
+    uint32_t allocate_node();
+    void free_node(uint32_t node);
+    void insert_leaf(uint32_t leaf);
+    void remove_leaf(uint32_t leaf);
+    void refit(uint32_t node);
+    uint32_t balance(uint32_t node);
+
+    float mMargin { 0 };
+    std::vector<Node> mNodes;
+    std::vector<uint32_t> mFreeNodes;
+    uint32_t mRoot { InvalidNode };
+    uint32_t mProxyCount { 0 };
+    std::vector<std::pair<uint32_t, uint32_t>> mSubtrees;
+    std::vector<std::pair<uint32_t, uint32_t>> mScratchSubtrees;
+    std::vector<std::vector<uint32_t>> mSubtreeIndices;
+};
+
+} // namespace gfx
+} // namespace dst
@@ -36,8 +36,21 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "gvk-structures.hpp"
 #include "gvk-system.hpp"
 
+#include <cstdint>
+#include <type_traits>
+
 namespace dst {
 namespace gfx {
+namespace detail {
+
+template <typename T>
+inline T& get_element(T* pData, size_t stride, size_t i)
+{
+    using ByteType = std::conditional_t<std::is_const_v<T>, const uint8_t, uint8_t>;
+    return *(T*)((ByteType*)pData + stride * i);
+}
+
+} // namespace detail
 
 struct EmptyVertex
 {
@@ -83,6 +96,93 @@ struct VertexPositionNormalTexcoordColor
     glm::vec4 color;
 };
 
+struct VertexPositionNormalTangentTexcoord
+{
+    glm::vec3 position;
+    glm::vec3 normal;
+    glm::vec4 tangent;
+    glm::vec2 texcoord;
+};
+
+struct Unorm16x4
+{
+    uint16_t x;
+    uint16_t y;
+    uint16_t z;
+    uint16_t w;
+};
+
+struct Snorm16x2
+{
+    int16_t x;
+    int16_t y;
+};
+
+struct Half2
+{
+    uint16_t x;
+    uint16_t y;
+};
+
+struct Unorm8x4
+{
+    uint8_t x;
+    uint8_t y;
+    uint8_t z;
+    uint8_t w;
+};
+
+struct PackedVertexPositionColor
+{
+    Unorm16x4 position;
+    Unorm8x4 color;
+};
+
+struct PackedVertexPositionNormal
+{
+    Unorm16x4 position;
+    Snorm16x2 normal;
+};
+
+struct PackedVertexPositionTexcoord
+{
+    Unorm16x4 position;
+    Half2 texcoord;
+};
+
+struct PackedVertexPositionTexcoordColor
+{
+    Unorm16x4 position;
+    Half2 texcoord;
+    Unorm8x4 color;
+};
+
+struct PackedVertexPositionNormalColor
+{
+    Unorm16x4 position;
+    Snorm16x2 normal;
+    Unorm8x4 color;
+};
+
+struct PackedVertexPositionNormalTexcoordColor
+{
+    Unorm16x4 position;
+    Snorm16x2 normal;
+    Half2 texcoord;
+    Unorm8x4 color;
+};
+
+static_assert(sizeof(PackedVertexPositionNormalTexcoordColor) == 20);
+
+// Per instance data read from a VK_VERTEX_INPUT_RATE_INSTANCE binding.  world
+//  occupies four consecutive attribute locations, one per column, the same as a
+//  mat4 vertex shader input.
+struct InstanceWorldColor
+{
+    glm::mat4 world;
+    glm::vec4 color;
+};
+
 } // namespace gfx
 } // namespace dst
 
@@ -104,6 +204,30 @@ inline VkFormat gvk::get_vertex_input_attribute_format<glm::vec4>()
     return VK_FORMAT_R32G32B32A32_SFLOAT;
 }
 
+template <>
+inline VkFormat gvk::get_vertex_input_attribute_format<dst::gfx::Unorm16x4>()
+{
+    return VK_FORMAT_R16G16B16A16_UNORM;
+}
+
+template <>
+inline VkFormat gvk::get_vertex_input_attribute_format<dst::gfx::Snorm16x2>()
+{
+    return VK_FORMAT_R16G16_SNORM;
+}
+
+template <>
+inline VkFormat gvk::get_vertex_input_attribute_format<dst::gfx::Half2>()
+{
+    return VK_FORMAT_R16G16_SFLOAT;
+}
+
+template <>
+inline VkFormat gvk::get_vertex_input_attribute_format<dst::gfx::Unorm8x4>()
+{
+    return VK_FORMAT_R8G8B8A8_UNORM;
+}
+
 template <>
 inline auto gvk::get_vertex_description<dst::gfx::EmptyVertex>(uint32_t binding)
 {
@@ -157,6 +281,87 @@ inline auto gvk::get_vertex_description<dst::gfx::VertexPositionTexcoordColor>(u
     >(binding);
 }
 
+template <>
+inline auto gvk::get_vertex_description<dst::gfx::VertexPositionNormalTangentTexcoord>(uint32_t binding)
+{
+    return gvk::get_vertex_input_attribute_descriptions<
+        glm::vec3,
+        glm::vec3,
+        glm::vec4,
+        glm::vec2
+    >(binding);
+}
+
+template <>
+inline auto gvk::get_vertex_description<dst::gfx::PackedVertexPositionColor>(uint32_t binding)
+{
+    return gvk::get_vertex_input_attribute_descriptions<
+        dst::gfx::Unorm16x4,
+        dst::gfx::Unorm8x4
+    >(binding);
+}
+
+template <>
+inline auto gvk::get_vertex_description<dst::gfx::PackedVertexPositionNormal>(uint32_t binding)
+{
+    return gvk::get_vertex_input_attribute_descriptions<
+        dst::gfx::Unorm16x4,
+        dst::gfx::Snorm16x2
+    >(binding);
+}
+
+template <>
+inline auto gvk::get_vertex_description<dst::gfx::PackedVertexPositionTexcoord>(uint32_t binding)
+{
+    return gvk::get_vertex_input_attribute_descriptions<
+        dst::gfx::Unorm16x4,
+        dst::gfx::Half2
+    >(binding);
+}
+
+template <>
+inline auto gvk::get_vertex_description<dst::gfx::PackedVertexPositionTexcoordColor>(uint32_t binding)
+{
+    return gvk::get_vertex_input_attribute_descriptions<
+        dst::gfx::Unorm16x4,
+        dst::gfx::Half2,
+        dst::gfx::Unorm8x4
+    >(binding);
+}
+
+template <>
+inline auto gvk::get_vertex_description<dst::gfx::PackedVertexPositionNormalColor>(uint32_t binding)
+{
+    return gvk::get_vertex_input_attribute_descriptions<
+        dst::gfx::Unorm16x4,
+        dst::gfx::Snorm16x2,
+        dst::gfx::Unorm8x4
+    >(binding);
+}
+
+template <>
+inline auto gvk::get_vertex_description<dst::gfx::PackedVertexPositionNormalTexcoordColor>(uint32_t binding)
+{
+    return gvk::get_vertex_input_attribute_descriptions<
+        dst::gfx::Unorm16x4,
+        dst::gfx::Snorm16x2,
+        dst::gfx::Half2,
+        dst::gfx::Unorm8x4
+    >(binding);
+}
+
+template <>
+inline auto gvk::get_vertex_description<dst::gfx::InstanceWorldColor>(uint32_t binding)
+{
+    return gvk::get_vertex_input_attribute_descriptions<
+        glm::vec4,
+        glm::vec4,
+        glm::vec4,
+        glm::vec4,
+        glm::vec4
+    >(binding);
+}
+
 template <>
 inline auto gvk::get_vertex_description<glm::vec2>(uint32_t binding)
 {
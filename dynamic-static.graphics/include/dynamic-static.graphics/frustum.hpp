@@ -0,0 +1,105 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#pragma once
+
+#include "dynamic-static.graphics/defines.hpp"
+
+#include <array>
+
+namespace dst {
+namespace gfx {
+
+struct Frustum
+{
+    enum Plane
+    {
+        Left = 0,
+        Right,
+        Bottom,
+        Top,
+        Near,
+        Far,
+        Count,
+    };
+
+    // Planes are stored as { normal, distance } with normals pointing inward.
+    std::array<glm::vec4, Plane::Count> planes { };
+};
+
+inline Frustum make_frustum(const glm::mat4& viewProjection)
+{
+    // FROM : Gribb, Hartmann - "Fast Extraction of Viewing Frustum Planes from the World-View-Projection Matrix"
+    auto get_row = [&](int i) { return glm::vec4 { viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i] }; };
+    auto row0 = get_row(0);
+    auto row1 = get_row(1);
+    auto row2 = get_row(2);
+    auto row3 = get_row(3);
+    Frustum frustum { };
+    frustum.planes[Frustum::Left] = row3 + row0;
+    frustum.planes[Frustum::Right] = row3 - row0;
+    frustum.planes[Frustum::Bottom] = row3 + row1;
+    frustum.planes[Frustum::Top] = row3 - row1;
+#ifdef GLM_FORCE_DEPTH_ZERO_TO_ONE
+    frustum.planes[Frustum::Near] = row2;
+#else
+    frustum.planes[Frustum::Near] = row3 + row2;
+#endif
+    frustum.planes[Frustum::Far] = row3 - row2;
+    for (auto& plane : frustum.planes) {
+        plane /= glm::length(glm::vec3(plane));
+    }
+    return frustum;
+}
+
+inline bool intersects_sphere(const Frustum& frustum, const glm::vec3& center, float radius)
+{
+    for (const auto& plane : frustum.planes) {
+        if (glm::dot(glm::vec3(plane), center) + plane.w < -radius) {
+            return false;
+        }
+    }
+    return true;
+}
+
+inline bool intersects_aabb(const Frustum& frustum, const glm::vec3& min, const glm::vec3& max)
+{
+    for (const auto& plane : frustum.planes) {
+        // Test the AABB corner furthest along the plane normal.
+        glm::vec3 positiveVertex {
+            0 <= plane.x ? max.x : min.x,
+            0 <= plane.y ? max.y : min.y,
+            0 <= plane.z ? max.z : min.z,
+        };
+        if (glm::dot(glm::vec3(plane), positiveVertex) + plane.w < 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace gfx
+} // namespace dst
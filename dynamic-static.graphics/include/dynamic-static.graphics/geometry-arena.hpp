@@ -0,0 +1,201 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+
+#pragma once
+
+#include "dynamic-static.graphics/defines.hpp"
+#include "dynamic-static.graphics/upload-batcher.hpp"
+#include "dynamic-static/tlsf-allocator.hpp"
+
+#include <cassert>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace dst {
+namespace gfx {
+namespace detail {
+
+// Appends a copy of size elements to pRegions, a copy that continues the last
+//  region in both source and destination is merged into it.  Empty copies are
+//  skipped.
+inline void add_copy_region(uint64_t srcOffset, uint64_t dstOffset, uint64_t size, std::vector<VkBufferCopy>* pRegions)
+{
+    assert(pRegions);
+    if (size) {
+        auto& regions = *pRegions;
+        if (!regions.empty() &&
+            regions.back().srcOffset + regions.back().size == srcOffset &&
+            regions.back().dstOffset + regions.back().size == dstOffset) {
+            regions.back().size += size;
+        } else {
+            regions.push_back({ srcOffset, dstOffset, size });
+        }
+    }
+}
+
+// Gets the copies from an old buffer to a new buffer that match the moves from
+//  TlsfAllocator::defragment(), usedSize is the allocator's used size after
+//  defragment().  Moves and usedSize are in elements, regions are in bytes.
+inline void get_defragment_regions(const std::vector<TlsfAllocator::Move>& moves, uint64_t usedSize, uint64_t elementSize, std::vector<VkBufferCopy>* pRegions)
+{
+    // After TlsfAllocator::defragment() live ranges fill [0, usedSize) in offset
+    //  order, ranges between moved ranges didn't move so they're copied from the
+    //  same offset in the old buffer.
+    assert(pRegions);
+    uint64_t offset = 0;
+    for (const auto& move : moves) {
+        add_copy_region(offset, offset, move.dstOffset - offset, pRegions);
+        add_copy_region(move.srcOffset, move.dstOffset, move.size, pRegions);
+        offset = move.dstOffset + move.size;
+    }
+    add_copy_region(offset, offset, usedSize - offset, pRegions);
+    for (auto& region : *pRegions) {
+        region.srcOffset *= elementSize;
+        region.dstOffset *= elementSize;
+        region.size *= elementSize;
+    }
+}
+
+// Gets the byte offset of an allocation in a buffer of elementSize elements.
+inline VkDeviceSize get_buffer_offset(const TlsfAllocator& allocator, TlsfAllocator::Handle handle, uint64_t elementSize)
+{
+    return allocator.get_offset(handle) * elementSize;
+}
+
+} // namespace detail
+
+class GeometryArena final
+{
+public:
+    struct CreateInfo final
+    {
+        // The size in bytes of one vertex, every Mesh in a GeometryArena shares a
+        //  vertex layout.
+        uint32_t vertexSize { 0 };
+        uint32_t vertexCapacity { 1024 * 1024 };
+        uint32_t indexCapacity { 4 * 1024 * 1024 };
+        VkIndexType indexType { VK_INDEX_TYPE_UINT32 };
+    };
+
+    // A Mesh is a view of ranges in its GeometryArena's buffers, it owns no
+    //  Vulkan resources.
+    struct Mesh final
+    {
+        TlsfAllocator::Handle vertices { TlsfAllocator::InvalidHandle };
+        TlsfAllocator::Handle indices { TlsfAllocator::InvalidHandle };
+        uint32_t vertexCount { 0 };
+        uint32_t indexCount { 0 };
+    };
+
+    // One device local vertex buffer and one index buffer shared by every Mesh
+    //  with the same vertex layout, ranges are sub-allocated with a TlsfAllocator
+    //  in vertex and index units.  Binding the GeometryArena once lets any number
+    //  of its Meshes be drawn with vkCmdDrawIndexed() firstIndex and vertexOffset
+    //  instead of binding buffers per Mesh.  Meshes are written through an
+    //  UploadBatcher, the same rules apply as for UploadBatcher::write_mesh().
+    static VkResult create(const gvk::Device& device, const CreateInfo* pCreateInfo, GeometryArena* pGeometryArena);
+
+    const gvk::Buffer& get_vertex_buffer() const;
+    const gvk::Buffer& get_index_buffer() const;
+    VkIndexType get_index_type() const;
+    const TlsfAllocator& get_vertex_allocator() const;
+    const TlsfAllocator& get_index_allocator() const;
+
+    // Allocates ranges for pMesh and records their uploads, returns
+    //  VK_ERROR_OUT_OF_DEVICE_MEMORY if either range doesn't fit.  VertexType
+    //  must be CreateInfo::vertexSize bytes and IndexType must match
+    //  CreateInfo::indexType.  If recording an upload fails, copies already
+    //  recorded may still execute, so the ranges aren't freed until
+    //  uploadBatcher completes the batch they were recorded in.
+    template <typename VertexType, typename IndexType>
+    inline VkResult write(UploadBatcher& uploadBatcher, std::span<const VertexType> vertices, std::span<const IndexType> indices, Mesh* pMesh, uint64_t* pToken = nullptr)
+    {
+        static_assert(sizeof(IndexType) == sizeof(uint16_t) || sizeof(IndexType) == sizeof(uint32_t));
+        assert(sizeof(VertexType) == mVertexSize);
+        assert(sizeof(IndexType) == get_index_size());
+        return write(
+            uploadBatcher,
+            { (const uint8_t*)vertices.data(), vertices.size_bytes() },
+            (uint32_t)vertices.size(),
+            { (const uint8_t*)indices.data(), indices.size_bytes() },
+            (uint32_t)indices.size(),
+            pMesh,
+            pToken
+        );
+    }
+
+    // Releases mesh's ranges, they may be reused by the next write() so callers
+    //  must only free a Mesh once submissions that draw it have completed.
+    void free(const Mesh& mesh);
+
+    uint32_t get_first_index(const Mesh& mesh) const;
+    int32_t get_vertex_offset(const Mesh& mesh) const;
+
+    // Binds the vertex buffer at binding 0 and the index buffer.
+    void record_bind_cmds(VkCommandBuffer commandBuffer) const;
+
+    // Records an indexed draw of mesh, record_bind_cmds() must have been recorded
+    //  earlier in commandBuffer.
+    void record_draw_cmds(VkCommandBuffer commandBuffer, const Mesh& mesh, uint32_t instanceCount = 1, uint32_t firstInstance = 0) const;
+
+    // Packs every Mesh toward the start of new vertex and index buffers, records
+    //  the copies and a barrier into commandBuffer, then replaces this
+    //  GeometryArena's buffers.  The old buffers are appended to
+    //  pRetiredBuffers, callers must keep them alive until commandBuffer has
+    //  executed.  Writes still pending in an UploadBatcher target the old buffers
+    //  so the UploadBatcher must be submitted before commandBuffer.  Meshes stay
+    //  valid, draws recorded after this must be recorded after
+    //  record_bind_cmds() is called again.  Does nothing if neither allocator has
+    //  more than one free block.
+    VkResult defragment(VkCommandBuffer commandBuffer, std::vector<gvk::Buffer>* pRetiredBuffers);
+
+    void reset();
+
+private:
+    struct PendingFree final
+    {
+        Mesh mesh;
+        uint64_t token { 0 };
+    };
+
+    VkResult write(UploadBatcher& uploadBatcher, std::span<const uint8_t> vertexData, uint32_t vertexCount, std::span<const uint8_t> indexData, uint32_t indexCount, Mesh* pMesh, uint64_t* pToken);
+    VkResult create_buffers(gvk::Buffer* pVertexBuffer, gvk::Buffer* pIndexBuffer) const;
+    uint32_t get_index_size() const;
+
+    gvk::Device mDevice;
+    uint32_t mVertexSize { 0 };
+    VkIndexType mIndexType { VK_INDEX_TYPE_UINT32 };
+    gvk::Buffer mVertexBuffer;
+    gvk::Buffer mIndexBuffer;
+    TlsfAllocator mVertexAllocator;
+    TlsfAllocator mIndexAllocator;
+    std::vector<PendingFree> mPendingFrees;
+};
+
+} // namespace gfx
+} // namespace dst
@@ -0,0 +1,135 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+
+#pragma once
+
+#include "dynamic-static.graphics/defines.hpp"
+#include "dynamic-static.graphics/render-queue.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace dst {
+namespace gfx {
+
+template <typename InstanceType = InstanceWorldColor>
+class InstanceBatcher final
+{
+public:
+    struct CreateInfo final
+    {
+        size_t capacity { 1024 };
+    };
+
+    struct Batch final
+    {
+        // The RenderQueue::Draw::Flags of the Batch's first Draw, ie. the state
+        //  that must be bound before recording the Batch.
+        uint32_t flags { 0 };
+        uint32_t pipeline { 0 };
+        uint32_t material { 0 };
+        uint32_t mesh { 0 };
+
+        // The item of the Batch's first Draw, use it to look up the mesh to draw.
+        uint32_t item { 0 };
+        uint32_t firstInstance { 0 };
+        uint32_t instanceCount { 0 };
+    };
+
+    // Groups consecutive RenderQueue Draws that share a pipeline, material and
+    //  mesh into Batches that are each recorded as one instanced draw.  Instance
+    //  data is packed into a single stream in Draw order so each Batch's
+    //  instances are contiguous.  Bind the stream once at offset 0 with
+    //  VK_VERTEX_INPUT_RATE_INSTANCE using
+    //  gvk::get_vertex_description<InstanceType>() and pass each Batch's
+    //  firstInstance to vkCmdDrawIndexed().
+    static inline void create(const CreateInfo* pCreateInfo, InstanceBatcher* pInstanceBatcher)
+    {
+        assert(pCreateInfo);
+        assert(pInstanceBatcher);
+        pInstanceBatcher->reset();
+        pInstanceBatcher->mInstances.reserve(pCreateInfo->capacity);
+    }
+
+    // Rebuilds the instance stream and Batches from sorted Draws, getInstance()
+    //  is called with each Draw's item and returns its InstanceType.  A new Batch
+    //  starts whenever a Draw has any state change flagged, Draws without flags
+    //  share their predecessor's pipeline, material and mesh.
+    template <typename GetInstanceFunctionType>
+    inline const std::vector<Batch>& build(const std::vector<RenderQueue::Draw>& draws, GetInstanceFunctionType getInstance)
+    {
+        clear();
+        for (const auto& draw : draws) {
+            if (draw.flags || mBatches.empty()) {
+                Batch batch { };
+                batch.flags = draw.flags;
+                batch.pipeline = draw.pipeline;
+                batch.material = draw.material;
+                batch.mesh = draw.mesh;
+                batch.item = draw.item;
+                batch.firstInstance = (uint32_t)mInstances.size();
+                mBatches.push_back(batch);
+            }
+            mInstances.push_back(getInstance(draw.item));
+            ++mBatches.back().instanceCount;
+        }
+        return mBatches;
+    }
+
+    inline std::span<const InstanceType> get_instances() const
+    {
+        return mInstances;
+    }
+
+    inline const std::vector<Batch>& get_batches() const
+    {
+        return mBatches;
+    }
+
+    // Clears instances and Batches but keeps allocations for the next frame.
+    inline void clear()
+    {
+        mInstances.clear();
+        mBatches.clear();
+    }
+
+    inline void reset()
+    {
+        mInstances = { };
+        mBatches = { };
+    }
+
+private:
+    std::vector<InstanceType> mInstances;
+    std::vector<Batch> mBatches;
+};
+
+} // namespace gfx
+} // namespace dst
@@ -0,0 +1,131 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#pragma once
+
+#include "dynamic-static.graphics/defines.hpp"
+#include "dynamic-static.graphics/meshlet.hpp"
+#include "dynamic-static.graphics/primitives.hpp"
+#include "dynamic-static.graphics/simplification.hpp"
+#include "dynamic-static/asset-file.hpp"
+
+#include <cassert>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace dst {
+namespace gfx {
+
+struct MeshAsset
+{
+    // AssetFile Section types for a mesh, every Section of one mesh shares an id.
+    //  The triangles of every LOD are concatenated in one Section, LodRanges
+    //  index into it.  Meshlets are built from LOD 0.
+    static constexpr uint32_t PositionsSection { make_fourcc('M', 'P', 'O', 'S') };
+    static constexpr uint32_t TrianglesSection { make_fourcc('M', 'T', 'R', 'I') };
+    static constexpr uint32_t LodRangesSection { make_fourcc('M', 'L', 'O', 'D') };
+    static constexpr uint32_t MeshletsSection { make_fourcc('M', 'M', 'L', 'T') };
+    static constexpr uint32_t MeshletVerticesSection { make_fourcc('M', 'M', 'V', 'T') };
+    static constexpr uint32_t MeshletTrianglesSection { make_fourcc('M', 'M', 'T', 'R') };
+
+    struct LodRange
+    {
+        uint32_t triangleOffset { 0 };
+        uint32_t triangleCount { 0 };
+        float error { 0 };
+    };
+
+    inline std::span<const primitive::Triangle<uint32_t>> get_lod_triangles(size_t lod) const
+    {
+        assert(lod < lodRanges.size());
+        return triangles.subspan(lodRanges[lod].triangleOffset, lodRanges[lod].triangleCount);
+    }
+
+    // Views into a mapped AssetFile, valid until the AssetFile is reset.
+    std::span<const glm::vec3> positions;
+    std::span<const primitive::Triangle<uint32_t>> triangles;
+    std::span<const LodRange> lodRanges;
+    std::span<const Meshlet> meshlets;
+    std::span<const uint32_t> meshletVertices;
+    std::span<const uint8_t> meshletTriangles;
+};
+
+inline void write_mesh_asset(
+    uint32_t id,
+    std::span<const glm::vec3> positions,
+    std::span<const LodLevel<uint32_t>> lodLevels,
+    const MeshletMesh* pMeshletMesh,
+    AssetFileWriter* pAssetFileWriter
+)
+{
+    // pMeshletMesh may be null.  lodLevels must contain at least LOD 0.
+    assert(!lodLevels.empty());
+    assert(pAssetFileWriter);
+    std::vector<primitive::Triangle<uint32_t>> triangles;
+    std::vector<MeshAsset::LodRange> lodRanges;
+    for (const auto& lodLevel : lodLevels) {
+        lodRanges.push_back({ (uint32_t)triangles.size(), (uint32_t)lodLevel.triangles.size(), lodLevel.error });
+        triangles.insert(triangles.end(), lodLevel.triangles.begin(), lodLevel.triangles.end());
+    }
+    pAssetFileWriter->add_section<glm::vec3>(MeshAsset::PositionsSection, id, positions);
+    pAssetFileWriter->add_section<primitive::Triangle<uint32_t>>(MeshAsset::TrianglesSection, id, triangles);
+    pAssetFileWriter->add_section<MeshAsset::LodRange>(MeshAsset::LodRangesSection, id, lodRanges);
+    if (pMeshletMesh) {
+        pAssetFileWriter->add_section<Meshlet>(MeshAsset::MeshletsSection, id, pMeshletMesh->meshlets);
+        pAssetFileWriter->add_section<uint32_t>(MeshAsset::MeshletVerticesSection, id, pMeshletMesh->vertices);
+        pAssetFileWriter->add_section<uint8_t>(MeshAsset::MeshletTrianglesSection, id, pMeshletMesh->triangles);
+    }
+}
+
+inline bool get_mesh_asset(const AssetFile& assetFile, uint32_t id, MeshAsset* pMeshAsset)
+{
+    // Gets views of a mesh's Sections without copying.  Returns false if the
+    //  positions, triangles or LOD ranges are missing or a LOD range is out of
+    //  bounds.  Index values aren't validated, that would touch every page of the
+    //  mesh.
+    assert(pMeshAsset);
+    MeshAsset meshAsset { };
+    meshAsset.positions = assetFile.get_section_data<glm::vec3>(MeshAsset::PositionsSection, id);
+    meshAsset.triangles = assetFile.get_section_data<primitive::Triangle<uint32_t>>(MeshAsset::TrianglesSection, id);
+    meshAsset.lodRanges = assetFile.get_section_data<MeshAsset::LodRange>(MeshAsset::LodRangesSection, id);
+    meshAsset.meshlets = assetFile.get_section_data<Meshlet>(MeshAsset::MeshletsSection, id);
+    meshAsset.meshletVertices = assetFile.get_section_data<uint32_t>(MeshAsset::MeshletVerticesSection, id);
+    meshAsset.meshletTriangles = assetFile.get_section_data<uint8_t>(MeshAsset::MeshletTrianglesSection, id);
+    if (meshAsset.positions.empty() || meshAsset.triangles.empty() || meshAsset.lodRanges.empty()) {
+        return false;
+    }
+    for (const auto& lodRange : meshAsset.lodRanges) {
+        if (meshAsset.triangles.size() < lodRange.triangleOffset || meshAsset.triangles.size() - lodRange.triangleOffset < lodRange.triangleCount) {
+            return false;
+        }
+    }
+    *pMeshAsset = meshAsset;
+    return true;
+}
+
+} // namespace gfx
+} // namespace dst
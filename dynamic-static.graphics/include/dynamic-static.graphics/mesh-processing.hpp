@@ -0,0 +1,340 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#pragma once
+
+#include "dynamic-static.graphics/defines.hpp"
+#include "dynamic-static.graphics/primitives.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace dst {
+namespace gfx {
+namespace detail {
+
+inline uint64_t get_weld_cell_key(const glm::ivec3& cell)
+{
+    return
+        ((uint64_t)(cell.x & 0x1fffff)) |
+        ((uint64_t)(cell.y & 0x1fffff) << 21) |
+        ((uint64_t)(cell.z & 0x1fffff) << 42);
+}
+
+// Normals and tangents are computed a block of triangles at a time, corner
+//  attributes are gathered into SoA blocks for the instruction set specific
+//  kernels in mesh-processing.cpp, see dst::batch::get_instruction_set(), and
+//  the results are accumulated into vertices.
+static constexpr size_t MeshProcessingBlockSize { 64 };
+
+struct Vec2Block final
+{
+    inline void set(size_t index, const glm::vec2& value)
+    {
+        x[index] = value.x;
+        y[index] = value.y;
+    }
+
+    float x[MeshProcessingBlockSize];
+    float y[MeshProcessingBlockSize];
+};
+
+struct Vec3Block final
+{
+    inline void set(size_t index, const glm::vec3& value)
+    {
+        x[index] = value.x;
+        y[index] = value.y;
+        z[index] = value.z;
+    }
+
+    inline glm::vec3 get(size_t index) const
+    {
+        return { x[index], y[index], z[index] };
+    }
+
+    float x[MeshProcessingBlockSize];
+    float y[MeshProcessingBlockSize];
+    float z[MeshProcessingBlockSize];
+};
+
+void compute_face_normal_block(size_t count, const Vec3Block (&positions)[3], Vec3Block* pNormals);
+void compute_corner_normal_block(size_t count, const Vec3Block (&positions)[3], Vec3Block (&normals)[3]);
+void compute_corner_tangent_block(
+    size_t count,
+    const Vec3Block (&positions)[3],
+    const Vec2Block (&texcoords)[3],
+    const Vec3Block (&normals)[3],
+    Vec3Block (&tangents)[3],
+    Vec3Block (&bitangents)[3]
+);
+void normalize_block(size_t count, Vec3Block* pVectors);
+
+} // namespace detail
+
+enum class NormalWeighting
+{
+    Area,
+    Angle,
+};
+
+template <typename IndexType>
+inline size_t create_weld_remap(size_t count, const glm::vec3* pPositions, size_t stride, float tolerance, std::vector<IndexType>* pRemap)
+{
+    // Maps each vertex to the index of the first vertex within tolerance of it.
+    //  Vertices are bucketed in a spatial hash with cells twice tolerance wide so
+    //  only the 8 cells nearest each vertex need to be searched.  Remapped indices
+    //  are compacted in order of first occurrence, returns the welded vertex count.
+    assert(0 <= tolerance);
+    assert(pRemap);
+    auto& remap = *pRemap;
+    remap.resize(count);
+    auto cellScale = 0 < tolerance ? 0.5f / tolerance : 1.0f;
+    auto toleranceSquared = tolerance * tolerance;
+    std::unordered_map<uint64_t, uint32_t> cellHeads;
+    cellHeads.reserve(count);
+    std::vector<uint32_t> uniqueVertices;
+    std::vector<uint32_t> uniqueNext;
+    constexpr uint32_t InvalidIndex = std::numeric_limits<uint32_t>::max();
+    for (size_t vertex_i = 0; vertex_i < count; ++vertex_i) {
+        const auto& position = detail::get_element(pPositions, stride, vertex_i);
+        auto scaled = position * cellScale;
+        glm::ivec3 cell { (int)std::floor(scaled.x), (int)std::floor(scaled.y), (int)std::floor(scaled.z) };
+        glm::ivec3 neighbor {
+            scaled.x - cell.x < 0.5f ? -1 : 1,
+            scaled.y - cell.y < 0.5f ? -1 : 1,
+            scaled.z - cell.z < 0.5f ? -1 : 1,
+        };
+        auto unique = InvalidIndex;
+        for (uint32_t neighbor_i = 0; neighbor_i < 8 && unique == InvalidIndex; ++neighbor_i) {
+            auto searchCell = cell;
+            searchCell.x += neighbor_i & 1 ? neighbor.x : 0;
+            searchCell.y += neighbor_i & 2 ? neighbor.y : 0;
+            searchCell.z += neighbor_i & 4 ? neighbor.z : 0;
+            auto itr = cellHeads.find(detail::get_weld_cell_key(searchCell));
+            for (auto unique_i = itr != cellHeads.end() ? itr->second : InvalidIndex; unique_i != InvalidIndex; unique_i = uniqueNext[unique_i]) {
+                auto offset = detail::get_element(pPositions, stride, uniqueVertices[unique_i]) - position;
+                if (glm::dot(offset, offset) <= toleranceSquared) {
+                    unique = unique_i;
+                    break;
+                }
+            }
+        }
+        if (unique == InvalidIndex) {
+            unique = (uint32_t)uniqueVertices.size();
+            auto& cellHead = cellHeads.insert({ detail::get_weld_cell_key(cell), InvalidIndex }).first->second;
+            uniqueVertices.push_back((uint32_t)vertex_i);
+            uniqueNext.push_back(cellHead);
+            cellHead = unique;
+        }
+        remap[vertex_i] = (IndexType)unique;
+    }
+    return uniqueVertices.size();
+}
+
+template <typename VertexType, typename IndexType>
+inline void weld_vertices(float tolerance, std::vector<VertexType>* pVertices, std::vector<primitive::Triangle<IndexType>>* pTriangles)
+{
+    // Welds vertices whose positions are within tolerance, welded vertices keep
+    //  the attributes of the first vertex in the group.  Triangles that collapse
+    //  are removed.
+    assert(pVertices);
+    assert(pTriangles);
+    auto& vertices = *pVertices;
+    auto& triangles = *pTriangles;
+    if (vertices.empty()) {
+        return;
+    }
+    std::vector<IndexType> remap;
+    auto vertexCount = create_weld_remap<IndexType>(vertices.size(), &vertices[0].position, sizeof(VertexType), tolerance, &remap);
+    size_t uniqueCount = 0;
+    for (size_t vertex_i = 0; vertex_i < vertices.size(); ++vertex_i) {
+        if (remap[vertex_i] == uniqueCount) {
+            vertices[uniqueCount++] = vertices[vertex_i];
+        }
+    }
+    vertices.resize(vertexCount);
+    size_t writeIndex = 0;
+    for (const auto& triangle : triangles) {
+        primitive::Triangle<IndexType> remapped { remap[triangle[0]], remap[triangle[1]], remap[triangle[2]] };
+        if (remapped[0] != remapped[1] && remapped[1] != remapped[2] && remapped[2] != remapped[0]) {
+            triangles[writeIndex++] = remapped;
+        }
+    }
+    triangles.resize(writeIndex);
+}
+
+template <typename IndexType>
+inline void compute_normals(
+    std::span<const primitive::Triangle<IndexType>> triangles,
+    size_t vertexCount,
+    const glm::vec3* pPositions,
+    size_t positionStride,
+    NormalWeighting weighting,
+    glm::vec3* pNormals,
+    size_t normalStride
+)
+{
+    // Computes smooth normals for counter clockwise triangles.  Area weighting
+    //  accumulates unnormalized face normals, angle weighting accumulates unit
+    //  face normals scaled by the angle of the corner at each vertex.  Vertices
+    //  not referenced by a non degenerate triangle get zero normals.
+    std::vector<glm::vec3> normals(vertexCount, glm::vec3 { 0 });
+    detail::Vec3Block positions[3];
+    detail::Vec3Block cornerNormals[3];
+    for (size_t first = 0; first < triangles.size(); first += detail::MeshProcessingBlockSize) {
+        auto count = std::min(detail::MeshProcessingBlockSize, triangles.size() - first);
+        for (size_t triangle_i = 0; triangle_i < count; ++triangle_i) {
+            const auto& triangle = triangles[first + triangle_i];
+            for (size_t corner_i = 0; corner_i < 3; ++corner_i) {
+                positions[corner_i].set(triangle_i, detail::get_element(pPositions, positionStride, triangle[corner_i]));
+            }
+        }
+        if (weighting == NormalWeighting::Area) {
+            detail::compute_face_normal_block(count, positions, &cornerNormals[0]);
+            for (size_t triangle_i = 0; triangle_i < count; ++triangle_i) {
+                auto normal = cornerNormals[0].get(triangle_i);
+                for (auto index : triangles[first + triangle_i]) {
+                    normals[index] += normal;
+                }
+            }
+        } else {
+            detail::compute_corner_normal_block(count, positions, cornerNormals);
+            for (size_t triangle_i = 0; triangle_i < count; ++triangle_i) {
+                const auto& triangle = triangles[first + triangle_i];
+                for (size_t corner_i = 0; corner_i < 3; ++corner_i) {
+                    normals[triangle[corner_i]] += cornerNormals[corner_i].get(triangle_i);
+                }
+            }
+        }
+    }
+    for (size_t first = 0; first < vertexCount; first += detail::MeshProcessingBlockSize) {
+        auto count = std::min(detail::MeshProcessingBlockSize, vertexCount - first);
+        for (size_t vertex_i = 0; vertex_i < count; ++vertex_i) {
+            cornerNormals[0].set(vertex_i, normals[first + vertex_i]);
+        }
+        detail::normalize_block(count, &cornerNormals[0]);
+        for (size_t vertex_i = 0; vertex_i < count; ++vertex_i) {
+            detail::get_element(pNormals, normalStride, first + vertex_i) = cornerNormals[0].get(vertex_i);
+        }
+    }
+}
+
+template <typename IndexType, typename VertexType>
+inline void compute_normals(std::span<const primitive::Triangle<IndexType>> triangles, NormalWeighting weighting, std::span<VertexType> vertices)
+{
+    if (!vertices.empty()) {
+        compute_normals<IndexType>(triangles, vertices.size(), &vertices[0].position, sizeof(VertexType), weighting, &vertices[0].normal, sizeof(VertexType));
+    }
+}
+
+template <typename IndexType>
+inline void compute_tangents(
+    std::span<const primitive::Triangle<IndexType>> triangles,
+    size_t vertexCount,
+    const glm::vec3* pPositions,
+    size_t positionStride,
+    const glm::vec3* pNormals,
+    size_t normalStride,
+    const glm::vec2* pTexcoords,
+    size_t texcoordStride,
+    glm::vec4* pTangents,
+    size_t tangentStride
+)
+{
+    // Computes tangents the way MikkTSpace does for vertices that are already
+    //  split at texcoord and smoothing seams; per corner tangents and bitangents
+    //  are projected onto the plane of the vertex normal and weighted by the
+    //  corner angle in that plane.  The tangent's w holds the bitangent sign so
+    //  shaders reconstruct bitangent = tangent.w * cross(normal, tangent.xyz).
+    //  MikkTSpace's own vertex splitting isn't performed.
+    // FROM : Morten Mikkelsen - "Simulation of Wrinkled Surfaces Revisited"
+    std::vector<glm::vec3> tangents(vertexCount, glm::vec3 { 0 });
+    std::vector<glm::vec3> bitangents(vertexCount, glm::vec3 { 0 });
+    detail::Vec3Block positions[3];
+    detail::Vec2Block texcoords[3];
+    detail::Vec3Block normals[3];
+    detail::Vec3Block cornerTangents[3];
+    detail::Vec3Block cornerBitangents[3];
+    for (size_t first = 0; first < triangles.size(); first += detail::MeshProcessingBlockSize) {
+        auto count = std::min(detail::MeshProcessingBlockSize, triangles.size() - first);
+        for (size_t triangle_i = 0; triangle_i < count; ++triangle_i) {
+            const auto& triangle = triangles[first + triangle_i];
+            for (size_t corner_i = 0; corner_i < 3; ++corner_i) {
+                positions[corner_i].set(triangle_i, detail::get_element(pPositions, positionStride, triangle[corner_i]));
+                texcoords[corner_i].set(triangle_i, detail::get_element(pTexcoords, texcoordStride, triangle[corner_i]));
+                normals[corner_i].set(triangle_i, detail::get_element(pNormals, normalStride, triangle[corner_i]));
+            }
+        }
+        detail::compute_corner_tangent_block(count, positions, texcoords, normals, cornerTangents, cornerBitangents);
+        for (size_t triangle_i = 0; triangle_i < count; ++triangle_i) {
+            const auto& triangle = triangles[first + triangle_i];
+            for (size_t corner_i = 0; corner_i < 3; ++corner_i) {
+                tangents[triangle[corner_i]] += cornerTangents[corner_i].get(triangle_i);
+                bitangents[triangle[corner_i]] += cornerBitangents[corner_i].get(triangle_i);
+            }
+        }
+    }
+    for (size_t vertex_i = 0; vertex_i < vertexCount; ++vertex_i) {
+        const auto& normal = detail::get_element(pNormals, normalStride, vertex_i);
+        auto tangent = tangents[vertex_i] - normal * glm::dot(normal, tangents[vertex_i]);
+        auto length = glm::length(tangent);
+        if (0 < length) {
+            tangent /= length;
+        } else {
+            // Fall back to any unit vector perpendicular to the normal.
+            auto axis = std::abs(normal.x) < 0.9f ? glm::vec3 { 1, 0, 0 } : glm::vec3 { 0, 1, 0 };
+            tangent = glm::cross(normal, axis);
+            length = glm::length(tangent);
+            tangent = 0 < length ? tangent / length : glm::vec3 { 1, 0, 0 };
+        }
+        auto sign = glm::dot(glm::cross(normal, tangent), bitangents[vertex_i]) < 0 ? -1.0f : 1.0f;
+        detail::get_element(pTangents, tangentStride, vertex_i) = glm::vec4 { tangent, sign };
+    }
+}
+
+template <typename IndexType, typename VertexType>
+inline void compute_tangents(std::span<const primitive::Triangle<IndexType>> triangles, std::span<VertexType> vertices)
+{
+    if (!vertices.empty()) {
+        compute_tangents<IndexType>(
+            triangles,
+            vertices.size(),
+            &vertices[0].position, sizeof(VertexType),
+            &vertices[0].normal, sizeof(VertexType),
+            &vertices[0].texcoord, sizeof(VertexType),
+            &vertices[0].tangent, sizeof(VertexType)
+        );
+    }
+}
+
+} // namespace gfx
+} // namespace dst
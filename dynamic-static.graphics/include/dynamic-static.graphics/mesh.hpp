@@ -0,0 +1,61 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+
+#pragma once
+
+#include "dynamic-static.graphics/defines.hpp"
+
+#include <cstdint>
+
+namespace dst {
+namespace gfx {
+
+// Device local vertex and index buffers written by UploadBatcher::write_mesh().
+//  Unlike gvk::Mesh writing a Mesh doesn't submit and wait, the buffers may be
+//  drawn from by any submission made to the UploadBatcher's queue after the
+//  UploadBatcher submits the copies that fill them.
+struct Mesh final
+{
+    gvk::Buffer vertexBuffer;
+    gvk::Buffer indexBuffer;
+    uint32_t vertexCount { 0 };
+    uint32_t indexCount { 0 };
+    VkIndexType indexType { VK_INDEX_TYPE_UINT32 };
+
+    // Binds the vertex buffer at binding 0 and the index buffer, then records an
+    //  indexed draw.
+    inline void record_cmds(VkCommandBuffer commandBuffer, uint32_t instanceCount = 1) const
+    {
+        VkDeviceSize offset = 0;
+        vkCmdBindVertexBuffers(commandBuffer, 0, 1, &vertexBuffer.get<const VkBuffer&>(), &offset);
+        vkCmdBindIndexBuffer(commandBuffer, indexBuffer, 0, indexType);
+        vkCmdDrawIndexed(commandBuffer, indexCount, instanceCount, 0, 0, 0);
+    }
+};
+
+} // namespace gfx
+} // namespace dst
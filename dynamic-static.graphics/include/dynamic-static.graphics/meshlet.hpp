@@ -0,0 +1,315 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#pragma once
+
+#include "dynamic-static.graphics/defines.hpp"
+#include "dynamic-static.graphics/frustum.hpp"
+#include "dynamic-static.graphics/primitives.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <span>
+#include <vector>
+
+namespace dst {
+namespace gfx {
+
+struct Meshlet
+{
+    static constexpr uint32_t DefaultMaxVertexCount { 64 };
+    static constexpr uint32_t DefaultMaxTriangleCount { 124 };
+
+    // Offsets into MeshletMesh::vertices and MeshletMesh::triangles, triangles
+    //  are stored as 3 uint8_t indices into this Meshlet's vertices.
+    uint32_t vertexOffset { 0 };
+    uint32_t vertexCount { 0 };
+    uint32_t triangleOffset { 0 };
+    uint32_t triangleCount { 0 };
+
+    // Bounding sphere and normal cone.  Cones are built from counter clockwise
+    //  front faces and are degenerate (never culled) when coneCutoff is 1.
+    glm::vec3 center { };
+    float radius { 0 };
+    glm::vec3 coneApex { };
+    glm::vec3 coneAxis { };
+    float coneCutoff { 1 };
+};
+
+struct MeshletMesh
+{
+    std::vector<Meshlet> meshlets;
+    std::vector<uint32_t> vertices;
+    std::vector<uint8_t> triangles;
+};
+
+namespace detail {
+
+inline void compute_meshlet_bounds(std::span<const glm::vec3> positions, const MeshletMesh& meshletMesh, Meshlet* pMeshlet)
+{
+    assert(pMeshlet);
+    auto& meshlet = *pMeshlet;
+    auto get_position = [&](uint32_t localIndex) -> const glm::vec3&
+    {
+        return positions[meshletMesh.vertices[meshlet.vertexOffset + localIndex]];
+    };
+
+    // Ritter's bounding sphere.
+    auto p0 = get_position(0);
+    auto p1 = p0;
+    auto p2 = p0;
+    for (uint32_t i = 0; i < meshlet.vertexCount; ++i) {
+        if (glm::dot(get_position(i) - p0, get_position(i) - p0) > glm::dot(p1 - p0, p1 - p0)) {
+            p1 = get_position(i);
+        }
+    }
+    for (uint32_t i = 0; i < meshlet.vertexCount; ++i) {
+        if (glm::dot(get_position(i) - p1, get_position(i) - p1) > glm::dot(p2 - p1, p2 - p1)) {
+            p2 = get_position(i);
+        }
+    }
+    auto center = (p1 + p2) * 0.5f;
+    auto radius = glm::length(p2 - p1) * 0.5f;
+    for (uint32_t i = 0; i < meshlet.vertexCount; ++i) {
+        auto distance = glm::length(get_position(i) - center);
+        if (radius < distance) {
+            auto expandedRadius = (radius + distance) * 0.5f;
+            center += (get_position(i) - center) * ((expandedRadius - radius) / distance);
+            radius = expandedRadius;
+        }
+    }
+    meshlet.center = center;
+    meshlet.radius = radius;
+
+    // Normal cone, see meshoptimizer's meshopt_computeClusterBounds().
+    std::vector<glm::vec3> normals(meshlet.triangleCount);
+    std::vector<glm::vec3> corners(meshlet.triangleCount);
+    glm::vec3 normalSum { };
+    for (uint32_t triangle_i = 0; triangle_i < meshlet.triangleCount; ++triangle_i) {
+        const auto* pTriangle = &meshletMesh.triangles[(meshlet.triangleOffset + triangle_i) * 3];
+        const auto& v0 = get_position(pTriangle[0]);
+        const auto& v1 = get_position(pTriangle[1]);
+        const auto& v2 = get_position(pTriangle[2]);
+        auto normal = glm::cross(v1 - v0, v2 - v0);
+        auto length = glm::length(normal);
+        normals[triangle_i] = 0 < length ? normal / length : glm::vec3 { };
+        corners[triangle_i] = v0;
+        normalSum += normals[triangle_i];
+    }
+    meshlet.coneApex = center;
+    meshlet.coneAxis = { };
+    meshlet.coneCutoff = 1;
+    auto normalSumLength = glm::length(normalSum);
+    if (normalSumLength <= 0) {
+        return;
+    }
+    auto axis = normalSum / normalSumLength;
+    auto minDot = 1.0f;
+    for (const auto& normal : normals) {
+        minDot = std::min(minDot, glm::dot(normal, axis));
+    }
+    // Cones wider than ~85 degrees aren't useful for culling.
+    if (minDot <= 0.1f) {
+        return;
+    }
+    auto maxT = 0.0f;
+    for (uint32_t triangle_i = 0; triangle_i < meshlet.triangleCount; ++triangle_i) {
+        auto dc = glm::dot(center - corners[triangle_i], normals[triangle_i]);
+        auto dn = glm::dot(axis, normals[triangle_i]);
+        assert(0 < dn);
+        maxT = std::max(maxT, dc / dn);
+    }
+    meshlet.coneApex = center - axis * maxT;
+    meshlet.coneAxis = axis;
+    meshlet.coneCutoff = std::sqrt(1.0f - minDot * minDot);
+}
+
+} // namespace detail
+
+template <typename IndexType>
+inline void build_meshlets(
+    std::span<const glm::vec3> positions,
+    std::span<const primitive::Triangle<IndexType>> triangles,
+    uint32_t maxVertexCount,
+    uint32_t maxTriangleCount,
+    MeshletMesh* pMeshletMesh
+)
+{
+    // Greedily grows each Meshlet from a seed triangle by adding the adjacent
+    //  triangle that introduces the fewest new vertices, ties go to the triangle
+    //  closest to the Meshlet's centroid.  When no adjacent triangle fits, the next
+    //  unassigned triangle in input order starts a new Meshlet, so input that has
+    //  been run through optimize_vertex_cache() produces more compact Meshlets.
+    assert(3 <= maxVertexCount && maxVertexCount <= 256);
+    assert(maxTriangleCount && maxTriangleCount <= 512);
+    assert(pMeshletMesh);
+    constexpr auto InvalidIndex = std::numeric_limits<uint32_t>::max();
+    auto& meshletMesh = *pMeshletMesh;
+    meshletMesh.meshlets.clear();
+    meshletMesh.vertices.clear();
+    meshletMesh.triangles.clear();
+    if (triangles.empty()) {
+        return;
+    }
+
+    // Build vertex/triangle adjacency.
+    auto vertexCount = positions.size();
+    std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+    for (const auto& triangle : triangles) {
+        for (auto index : triangle) {
+            assert(index < vertexCount);
+            ++adjacencyOffsets[index + 1];
+        }
+    }
+    for (size_t vertex_i = 0; vertex_i < vertexCount; ++vertex_i) {
+        adjacencyOffsets[vertex_i + 1] += adjacencyOffsets[vertex_i];
+    }
+    std::vector<uint32_t> adjacency(triangles.size() * 3);
+    std::vector<uint32_t> adjacencyCursors(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+    for (uint32_t triangle_i = 0; triangle_i < (uint32_t)triangles.size(); ++triangle_i) {
+        for (auto index : triangles[triangle_i]) {
+            adjacency[adjacencyCursors[index]++] = triangle_i;
+        }
+    }
+
+    std::vector<bool> assigned(triangles.size(), false);
+    std::vector<uint32_t> localIndices(vertexCount, InvalidIndex);
+    size_t seedCursor = 0;
+    Meshlet meshlet { };
+    glm::vec3 positionSum { };
+    auto get_new_vertex_count = [&](const primitive::Triangle<IndexType>& triangle)
+    {
+        uint32_t newVertexCount = 0;
+        for (auto index : triangle) {
+            newVertexCount += localIndices[index] == InvalidIndex ? 1 : 0;
+        }
+        return newVertexCount;
+    };
+    auto finish_meshlet = [&]()
+    {
+        if (meshlet.triangleCount) {
+            detail::compute_meshlet_bounds(positions, meshletMesh, &meshlet);
+            for (uint32_t i = 0; i < meshlet.vertexCount; ++i) {
+                localIndices[meshletMesh.vertices[meshlet.vertexOffset + i]] = InvalidIndex;
+            }
+            meshletMesh.meshlets.push_back(meshlet);
+        }
+        meshlet = { };
+        meshlet.vertexOffset = (uint32_t)meshletMesh.vertices.size();
+        meshlet.triangleOffset = (uint32_t)(meshletMesh.triangles.size() / 3);
+        positionSum = { };
+    };
+    auto add_triangle = [&](uint32_t triangle_i)
+    {
+        assigned[triangle_i] = true;
+        for (auto index : triangles[triangle_i]) {
+            if (localIndices[index] == InvalidIndex) {
+                localIndices[index] = meshlet.vertexCount++;
+                meshletMesh.vertices.push_back((uint32_t)index);
+                positionSum += positions[index];
+            }
+            meshletMesh.triangles.push_back((uint8_t)localIndices[index]);
+        }
+        ++meshlet.triangleCount;
+    };
+
+    finish_meshlet();
+    for (size_t assignedCount = 0; assignedCount < triangles.size(); ++assignedCount) {
+        auto bestTriangle = InvalidIndex;
+        auto bestNewVertexCount = std::numeric_limits<uint32_t>::max();
+        auto bestDistance = std::numeric_limits<float>::max();
+        if (meshlet.triangleCount) {
+            auto centroid = positionSum / (float)meshlet.vertexCount;
+            for (uint32_t i = 0; i < meshlet.vertexCount; ++i) {
+                auto index = meshletMesh.vertices[meshlet.vertexOffset + i];
+                for (auto adjacency_i = adjacencyOffsets[index]; adjacency_i < adjacencyOffsets[index + 1]; ++adjacency_i) {
+                    auto triangle_i = adjacency[adjacency_i];
+                    if (!assigned[triangle_i]) {
+                        const auto& triangle = triangles[triangle_i];
+                        auto newVertexCount = get_new_vertex_count(triangle);
+                        if (newVertexCount <= bestNewVertexCount) {
+                            auto triangleCentroid = (positions[triangle[0]] + positions[triangle[1]] + positions[triangle[2]]) * (1.0f / 3.0f);
+                            auto distance = glm::dot(triangleCentroid - centroid, triangleCentroid - centroid);
+                            if (newVertexCount < bestNewVertexCount || distance < bestDistance) {
+                                bestTriangle = triangle_i;
+                                bestNewVertexCount = newVertexCount;
+                                bestDistance = distance;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        if (bestTriangle == InvalidIndex) {
+            while (assigned[seedCursor]) {
+                ++seedCursor;
+            }
+            bestTriangle = (uint32_t)seedCursor;
+            bestNewVertexCount = get_new_vertex_count(triangles[bestTriangle]);
+        }
+        if (maxVertexCount < meshlet.vertexCount + bestNewVertexCount || maxTriangleCount <= meshlet.triangleCount) {
+            finish_meshlet();
+            bestNewVertexCount = get_new_vertex_count(triangles[bestTriangle]);
+        }
+        add_triangle(bestTriangle);
+    }
+    finish_meshlet();
+}
+
+inline bool is_meshlet_visible(const Meshlet& meshlet, const Frustum& frustum, const glm::vec3& cameraPosition)
+{
+    if (!intersects_sphere(frustum, meshlet.center, meshlet.radius)) {
+        return false;
+    }
+    if (meshlet.coneCutoff < 1) {
+        auto direction = meshlet.coneApex - cameraPosition;
+        auto distance = glm::length(direction);
+        if (0 < distance && meshlet.coneCutoff <= glm::dot(direction / distance, meshlet.coneAxis)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+inline size_t cull_meshlets(std::span<const Meshlet> meshlets, const Frustum& frustum, const glm::vec3& cameraPosition, std::vector<uint32_t>* pVisibleMeshlets)
+{
+    // frustum and cameraPosition must be in the same space as the Meshlets, ie.
+    //  build the Frustum from the world/view/projection matrix and transform the
+    //  camera position by the inverse world matrix.
+    assert(pVisibleMeshlets);
+    pVisibleMeshlets->clear();
+    for (uint32_t meshlet_i = 0; meshlet_i < (uint32_t)meshlets.size(); ++meshlet_i) {
+        if (is_meshlet_visible(meshlets[meshlet_i], frustum, cameraPosition)) {
+            pVisibleMeshlets->push_back(meshlet_i);
+        }
+    }
+    return pVisibleMeshlets->size();
+}
+
+} // namespace gfx
+} // namespace dst
@@ -0,0 +1,129 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+
+#pragma once
+
+#include "dynamic-static.graphics/defines.hpp"
+#include "dynamic-static.graphics/primitives.hpp"
+#include "dynamic-static/job-system.hpp"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace dst {
+namespace gfx {
+namespace detail {
+
+struct OcclusionKernels;
+struct OcclusionTriangle;
+
+} // namespace detail
+
+class OcclusionCuller final
+{
+public:
+    // Tile dimensions in pixels, CreateInfo::width and CreateInfo::height must be
+    //  multiples of these.
+    static constexpr uint32_t TileWidth { 16 };
+    static constexpr uint32_t TileHeight { 8 };
+
+    struct CreateInfo final
+    {
+        uint32_t width { 256 };
+        uint32_t height { 128 };
+    };
+
+    // Low resolution software depth buffer for CPU occlusion culling.  Simplified
+    //  occluder meshes are transformed, clipped against the near plane, and binned
+    //  into screen tiles as they're added, then each tile is rasterized with SIMD
+    //  edge functions using the instruction set selected by dst::batch.  Each
+    //  tile's farthest depth forms a hierarchical depth buffer, is_visible() tests
+    //  an AABB's nearest depth against the tiles it covers and only tests pixels
+    //  in tiles that aren't conclusively in front of it.  Runs entirely on the
+    //  CPU so results are available the same frame and testable without a GPU.
+    // FROM : Hasselgren, Andersson, Akenine-Moller - "Masked Software Occlusion Culling"
+    // FROM : Kharlamov, Cantlay, Stepanenko - "Software Occlusion Culling"
+    static void create(const CreateInfo* pCreateInfo, OcclusionCuller* pOcclusionCuller);
+
+    OcclusionCuller();
+    OcclusionCuller(OcclusionCuller&& other);
+    OcclusionCuller& operator=(OcclusionCuller&& other);
+    ~OcclusionCuller();
+
+    uint32_t get_width() const;
+    uint32_t get_height() const;
+
+    // Returns the number of triangles binned since begin_frame().  Triangles that
+    //  don't cover any pixel centers are discarded, triangles crossing the near
+    //  plane may be split in two.
+    uint32_t get_triangle_count() const;
+
+    // Returns the depth buffer in rows of get_width() normalized depths with 1 at
+    //  the far plane.  Row 0 is at normalized device y -1.  Valid after
+    //  rasterize().
+    std::span<const float> get_depths() const;
+
+    // Clears occluders and sets the view projection used by add_occluder() and
+    //  is_visible().
+    void begin_frame(const glm::mat4& viewProjection);
+
+    // Transforms triangles by world, clips them against the near plane, and bins
+    //  them into tiles.  Triangles are rasterized regardless of winding.
+    void add_occluder(std::span<const glm::vec3> positions, std::span<const primitive::Triangle<uint32_t>> triangles, const glm::mat4& world);
+
+    // Rasterizes binned triangles and builds the hierarchical depth buffer.
+    void rasterize();
+
+    // Rasterizes tiles in parallel on jobSystem.  Must be called from the thread
+    //  that created jobSystem or from within a job.  Produces the same depth
+    //  buffer as rasterize().
+    void rasterize(JobSystem& jobSystem);
+
+    // Returns false if the AABB is fully hidden behind rasterized occluders or
+    //  outside the view.  AABBs crossing the near plane are always visible.
+    bool is_visible(const glm::vec3& min, const glm::vec3& max) const;
+
+    void reset();
+
+private:
+    void bin_triangle(const glm::vec4& clip0, const glm::vec4& clip1, const glm::vec4& clip2);
+    void rasterize_tile(const detail::OcclusionKernels& kernels, uint32_t tile);
+
+    uint32_t mWidth { 0 };
+    uint32_t mHeight { 0 };
+    uint32_t mTileCountX { 0 };
+    uint32_t mTileCountY { 0 };
+    glm::mat4 mViewProjection { 1 };
+    std::vector<float> mDepths;
+    std::vector<float> mTileDepths;
+    std::vector<detail::OcclusionTriangle> mTriangles;
+    std::vector<std::vector<uint32_t>> mBins;
+};
+
+} // namespace gfx
+} // namespace dst
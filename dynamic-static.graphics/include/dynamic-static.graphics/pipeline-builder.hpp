@@ -0,0 +1,142 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+
+#pragma once
+
+#include "dynamic-static.graphics/defines.hpp"
+#include "dynamic-static.graphics/shader-cache.hpp"
+#include "dynamic-static/job-system.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace dst {
+namespace gfx {
+
+class PipelineBuilder final
+{
+public:
+    using CompileFunction = std::function<void(gvk::spirv::ShaderInfo*)>;
+    using CreateFunction = std::function<VkResult(std::span<const gvk::spirv::ShaderInfo>)>;
+
+    struct CreateInfo final
+    {
+        JobSystem* pJobSystem { nullptr };
+
+        // Optional, when provided SPIR-V is loaded from pShaderCache and compile is
+        //  only called on a miss.
+        ShaderCache* pShaderCache { nullptr };
+
+        // Compiles a gvk::spirv::ShaderInfo, called concurrently from JobSystem
+        //  threads so it must not share compiler state between calls.
+        CompileFunction compile;
+    };
+
+    struct Description final
+    {
+        std::vector<gvk::spirv::ShaderInfo> shaderInfos;
+
+        // Called from a JobSystem thread once every shader in shaderInfos has
+        //  compiled without errors.  Different Descriptions' create functions run
+        //  concurrently.
+        CreateFunction create;
+    };
+
+    struct Statistics final
+    {
+        uint32_t pipelineCount { 0 };
+        uint32_t shaderCount { 0 };
+        uint32_t sharedShaderCount { 0 };
+    };
+
+    class Future final
+    {
+    public:
+        bool valid() const;
+        bool is_ready() const;
+
+        // Executes JobSystem jobs on the calling thread until the pipeline has been
+        //  built, then returns the result of its Description's create function or
+        //  VK_ERROR_INITIALIZATION_FAILED if a shader failed to compile.  Must be
+        //  called from the thread that created the JobSystem.
+        VkResult get() const;
+
+        // The Description's shaders with SPIR-V or errors filled in, only valid
+        //  once is_ready() returns true.
+        std::span<const gvk::spirv::ShaderInfo> get_shader_infos() const;
+
+    private:
+        struct State;
+        std::shared_ptr<State> mspState;
+        friend class PipelineBuilder;
+    };
+
+    // Builds pipelines on a JobSystem.  Every unique shader is compiled by its own
+    //  job and every Description's create function runs in its own job once its
+    //  shaders are ready, so independent variants compile and build in parallel.
+    //  Shaders are keyed with ShaderCache::create_key() so variants that share a
+    //  shader, ie. solid and wireframe, compile it once, including across calls
+    //  to build() until reset().
+    static void create(const CreateInfo* pCreateInfo, PipelineBuilder* pPipelineBuilder);
+
+    ~PipelineBuilder();
+
+    const Statistics& get_statistics() const;
+
+    // Schedules description and returns immediately, must be called from the
+    //  thread that created the JobSystem.
+    Future build(Description description);
+    std::vector<Future> build(std::vector<Description> descriptions);
+
+    // Waits for every scheduled shader and pipeline.
+    void wait();
+
+    void reset();
+
+private:
+    struct ShaderEntry final
+    {
+        gvk::spirv::ShaderInfo shaderInfo;
+        JobCounter counter;
+    };
+
+    std::shared_ptr<ShaderEntry> get_shader_entry(const gvk::spirv::ShaderInfo& shaderInfo);
+
+    JobSystem* mpJobSystem { nullptr };
+    ShaderCache* mpShaderCache { nullptr };
+    CompileFunction mCompile;
+    std::unordered_map<uint64_t, std::shared_ptr<ShaderEntry>> mShaderEntries;
+    std::vector<std::shared_ptr<Future::State>> mPendingStates;
+    Statistics mStatistics { };
+};
+
+} // namespace gfx
+} // namespace dst
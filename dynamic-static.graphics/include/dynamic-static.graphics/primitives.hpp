@@ -27,11 +27,15 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #pragma once
 
 #include "dynamic-static.graphics/defines.hpp"
+#include "dynamic-static/profiler.hpp"
 
 #include <array>
 #include <cassert>
+#include <functional>
+#include <memory>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 namespace dst {
 namespace gfx {
@@ -133,6 +137,49 @@ struct Icosahedron
     };
 };
 
+// The edge lookup used while subdividing allocates from pVertices' allocator.
+template <typename IndexType = uint32_t, typename VertexAllocatorType, typename TriangleAllocatorType>
+inline void create_icosphere(float radius, uint32_t subdivisions, std::vector<glm::vec3, VertexAllocatorType>* pVertices, std::vector<Triangle<IndexType>, TriangleAllocatorType>* pTriangles)
+{
+    dst_profile_scope("create_icosphere");
+    assert(pVertices);
+    assert(pTriangles);
+    auto& vertices = *pVertices;
+    auto& triangles = *pTriangles;
+    vertices.assign(Icosahedron::Vertices.begin(), Icosahedron::Vertices.end());
+    for (auto& vertex : vertices) {
+        vertex *= radius;
+    }
+    triangles.clear();
+    for (const auto& triangle : Icosahedron::Triangles) {
+        triangles.push_back({ (IndexType)triangle[0], (IndexType)triangle[1], (IndexType)triangle[2] });
+    }
+    using EdgeAllocatorType = typename std::allocator_traits<VertexAllocatorType>::template rebind_alloc<std::pair<const Edge<IndexType>, IndexType>>;
+    std::unordered_map<Edge<IndexType>, IndexType, EdgeHasher<IndexType>, std::equal_to<Edge<IndexType>>, EdgeAllocatorType> edges(EdgeAllocatorType(vertices.get_allocator()));
+    for (uint32_t subdivision_i = 0; subdivision_i < subdivisions; ++subdivision_i) {
+        auto triangleCount = triangles.size();
+        for (size_t triangle_i = 0; triangle_i < triangleCount; ++triangle_i) {
+            subdivide_triangle(
+                triangles[triangle_i],
+                [&](const Edge<IndexType>& edge)
+                {
+                    auto itr = edges.find(edge);
+                    if (itr == edges.end()) {
+                        vertices.push_back(glm::normalize(vertices[edge[0]] + vertices[edge[1]]) * radius);
+                        itr = edges.insert(itr, { edge, (IndexType)(vertices.size() - 1) });
+                    }
+                    return itr->second;
+                },
+                [&](const Triangle<IndexType>& subdividedTriangle, const std::array<Triangle<IndexType>, 3>& newTriangles)
+                {
+                    triangles[triangle_i] = subdividedTriangle;
+                    triangles.insert(triangles.end(), newTriangles.begin(), newTriangles.end());
+                }
+            );
+        }
+    }
+}
+
 struct Cube
 {
     static constexpr std::array<glm::vec3, 24> Vertices {
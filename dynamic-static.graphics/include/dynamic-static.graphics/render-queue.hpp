@@ -0,0 +1,118 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+
+#pragma once
+
+#include "dynamic-static.graphics/defines.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace dst {
+namespace gfx {
+
+class RenderQueue final
+{
+public:
+    struct CreateInfo final
+    {
+        size_t capacity { 1024 };
+    };
+
+    // Sort key fields from most to least significant.  Submissions sort by
+    //  pipeline first since those binds are the most expensive, then material,
+    //  then mesh, then front to back by depth.
+    static constexpr uint32_t PipelineBits { 10 };
+    static constexpr uint32_t MaterialBits { 14 };
+    static constexpr uint32_t MeshBits { 16 };
+    static constexpr uint32_t DepthBits { 24 };
+
+    struct Draw final
+    {
+        enum Flags
+        {
+            BindPipeline = 1,
+            BindMaterial = 1 << 1,
+            BindMesh     = 1 << 2,
+        };
+
+        uint32_t flags { 0 };
+        uint32_t pipeline { 0 };
+        uint32_t material { 0 };
+        uint32_t mesh { 0 };
+        uint32_t item { 0 };
+    };
+
+    struct Statistics final
+    {
+        uint32_t pipelineBindCount { 0 };
+        uint32_t materialBindCount { 0 };
+        uint32_t meshBindCount { 0 };
+        uint32_t drawCount { 0 };
+    };
+
+    // Packs ids into a 64 bit sort key, ids must fit in their field's bits.  depth
+    //  is clamped to [0, 1] and quantized, pass 1 - depth to sort back to front.
+    static uint64_t create_sort_key(uint32_t pipeline, uint32_t material, uint32_t mesh, float depth);
+
+    // Collects draw submissions for a frame, radix sorts them by key and emits a
+    //  Draw list flagged with only the state changes between consecutive draws.
+    //  item is an opaque index the caller uses to find its per draw data.
+    static void create(const CreateInfo* pCreateInfo, RenderQueue* pRenderQueue);
+
+    size_t size() const;
+    void submit(uint64_t sortKey, uint32_t item);
+    void submit(uint32_t pipeline, uint32_t material, uint32_t mesh, float depth, uint32_t item);
+
+    // Sorts this frame's submissions and rebuilds the Draw list.  Equal keys keep
+    //  their submission order.
+    const std::vector<Draw>& sort();
+
+    const std::vector<Draw>& get_draws() const;
+    const Statistics& get_statistics() const;
+
+    // Clears submissions and Draws but keeps allocations for the next frame.
+    void clear();
+
+    void reset();
+
+private:
+    struct Submission final
+    {
+        uint64_t sortKey { 0 };
+        uint32_t item { 0 };
+    };
+
+    std::vector<Submission> mSubmissions;
+    std::vector<Submission> mScratch;
+    std::vector<Draw> mDraws;
+    Statistics mStatistics { };
+};
+
+} // namespace gfx
+} // namespace dst
@@ -0,0 +1,153 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+
+#pragma once
+
+#include "dynamic-static.graphics/defines.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace dst {
+namespace gfx {
+
+class DescriptorSlotAllocator final
+{
+public:
+    struct CreateInfo final
+    {
+        uint32_t capacity { 1024 };
+        uint32_t frameCount { 2 };
+    };
+
+    // Allocates indices into a descriptor array.  Freed slots may still be read
+    //  by frames in flight so they're held until begin_frame() comes back around
+    //  to the frame that freed them, callers must have waited for the GPU to
+    //  finish with that frame first.  Slots are reused most recently freed
+    //  first, new slots are taken from the low end so the used range of the
+    //  array stays compact.
+    static void create(const CreateInfo* pCreateInfo, DescriptorSlotAllocator* pDescriptorSlotAllocator);
+
+    uint32_t get_capacity() const;
+    uint32_t get_used_count() const;
+    uint32_t get_frame_count() const;
+    uint32_t get_frame_index() const;
+    void begin_frame(uint32_t frameIndex);
+
+    // Returns false if every slot is in use or waiting to be released.
+    bool allocate(uint32_t* pSlot);
+
+    void free(uint32_t slot);
+    void reset();
+
+private:
+    uint32_t mCapacity { 0 };
+    uint32_t mHighWaterMark { 0 };
+    uint32_t mUsedCount { 0 };
+    uint32_t mFrameIndex { 0 };
+    std::vector<uint32_t> mFreeSlots;
+    std::vector<std::vector<uint32_t>> mPendingFreeSlots;
+};
+
+class DescriptorWriteBatch final
+{
+public:
+    // Collects buffer descriptor writes into a single array binding and emits
+    //  them as few VkWriteDescriptorSets as possible for one
+    //  vkUpdateDescriptorSets() call.  Writes to consecutive array elements are
+    //  merged into one VkWriteDescriptorSet, a later write to the same element
+    //  replaces the earlier one.
+    void write(uint32_t arrayElement, const VkDescriptorBufferInfo& descriptorBufferInfo);
+
+    size_t size() const;
+
+    // Sorts and merges the pending writes, the returned VkWriteDescriptorSets
+    //  reference storage owned by this DescriptorWriteBatch and are valid until
+    //  the next call to write(), get_write_descriptor_sets() or clear().
+    const std::vector<VkWriteDescriptorSet>& get_write_descriptor_sets(VkDescriptorSet descriptorSet, uint32_t binding, VkDescriptorType descriptorType);
+
+    void clear();
+
+private:
+    struct Write final
+    {
+        uint32_t arrayElement { 0 };
+        VkDescriptorBufferInfo descriptorBufferInfo { };
+    };
+
+    std::vector<Write> mWrites;
+    std::vector<VkDescriptorBufferInfo> mDescriptorBufferInfos;
+    std::vector<VkWriteDescriptorSet> mWriteDescriptorSets;
+};
+
+class ResourceTable final
+{
+public:
+    struct CreateInfo final
+    {
+        uint32_t storageBufferCount { 16 * 1024 };
+        uint32_t frameCount { 2 };
+    };
+
+    // A single DescriptorSet holding a large, partially bound array of storage
+    //  buffers at binding 0.  Draws index the array with a per draw id, ie. a push
+    //  constant or instance attribute, instead of binding a DescriptorSet per
+    //  object.  Registered buffers are written in one batched
+    //  vkUpdateDescriptorSets() call by flush(), the array is created with
+    //  VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT so the DescriptorSet can be
+    //  updated while bound by frames in flight.  Requires descriptorIndexing's
+    //  descriptorBindingStorageBufferUpdateAfterBind, descriptorBindingPartiallyBound
+    //  and runtimeDescriptorArray features.
+    static VkResult create(const gvk::Device& device, const CreateInfo* pCreateInfo, ResourceTable* pResourceTable);
+
+    const gvk::DescriptorSetLayout& get_descriptor_set_layout() const;
+    const gvk::DescriptorSet& get_descriptor_set() const;
+    const DescriptorSlotAllocator& get_slot_allocator() const;
+    void begin_frame(uint32_t frameIndex);
+
+    // Returns false if the table is full.  The index is valid in shaders after the
+    //  next flush().
+    bool register_storage_buffer(const VkDescriptorBufferInfo& descriptorBufferInfo, uint32_t* pIndex);
+
+    void update_storage_buffer(uint32_t index, const VkDescriptorBufferInfo& descriptorBufferInfo);
+    void unregister_storage_buffer(uint32_t index);
+
+    // Writes every registration and update since the last flush().
+    void flush();
+
+    void reset();
+
+private:
+    gvk::DescriptorPool mDescriptorPool;
+    gvk::DescriptorSetLayout mDescriptorSetLayout;
+    gvk::DescriptorSet mDescriptorSet;
+    DescriptorSlotAllocator mSlotAllocator;
+    DescriptorWriteBatch mWriteBatch;
+};
+
+} // namespace gfx
+} // namespace dst
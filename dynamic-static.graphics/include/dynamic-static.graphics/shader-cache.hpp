@@ -0,0 +1,126 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+
+#pragma once
+
+#include "dynamic-static.graphics/defines.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace dst {
+namespace gfx {
+
+class ShaderCache final
+{
+public:
+    struct CreateInfo final
+    {
+        std::filesystem::path directory;
+    };
+
+    struct Statistics final
+    {
+        uint32_t hitCount { 0 };
+        uint32_t missCount { 0 };
+    };
+
+    // Bump when the compiler or the cache file layout changes so stale entries
+    //  are ignored rather than loaded.
+    static constexpr uint32_t Version { 1 };
+
+    // 64 bit FNV-1a, seed with a previous result to hash discontiguous data.
+    static uint64_t hash(std::span<const uint8_t> data, uint64_t seed = 14695981039346656037ull);
+
+    // Keys a shader by the content that determines its SPIR-V, Version, the
+    //  shading language, stage, line offset, source and defines.
+    static uint64_t create_key(const gvk::spirv::ShaderInfo& shaderInfo, std::span<const std::string_view> defines = { });
+
+    // Returns false if a VkPipelineCache blob's header doesn't match the given
+    //  device, drivers may reject or misbehave with blobs from another device or
+    //  driver version.
+    static bool validate_pipeline_cache_data(std::span<const uint8_t> data, const VkPhysicalDeviceProperties& physicalDeviceProperties);
+
+    // Caches compiled SPIR-V and VkPipelineCache data in a directory so warm
+    //  launches skip shader compilation.  SPIR-V entries are stored one file per
+    //  key with a header that's validated on load, a corrupt or stale entry is
+    //  treated as a miss and overwritten.  Reflection runs on the SPIR-V so it
+    //  needs no separate entry.  Returns false if the directory can't be created.
+    static bool create(const CreateInfo* pCreateInfo, ShaderCache* pShaderCache);
+
+    const std::filesystem::path& get_directory() const;
+    const Statistics& get_statistics() const;
+    bool load(uint64_t key, std::vector<uint32_t>* pSpirv) const;
+    bool store(uint64_t key, std::span<const uint32_t> spirv) const;
+
+    // Loads pShaderInfo->spirv from the cache.  On a miss compile() is called
+    //  with pShaderInfo and the SPIR-V is stored if it produced no errors.
+    //  compile() is only invoked on a miss so callers can defer creating a
+    //  gvk::spirv::Context until the first one.  Returns false if compile()
+    //  reported errors.  May be called concurrently for different shaders.
+    template <typename CompileFunctionType>
+    inline bool compile(gvk::spirv::ShaderInfo* pShaderInfo, CompileFunctionType compile, std::span<const std::string_view> defines = { })
+    {
+        assert(pShaderInfo);
+        auto key = create_key(*pShaderInfo, defines);
+        if (load(key, &pShaderInfo->spirv)) {
+            std::atomic_ref<uint32_t>(mStatistics.hitCount).fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+        std::atomic_ref<uint32_t>(mStatistics.missCount).fetch_add(1, std::memory_order_relaxed);
+        compile(pShaderInfo);
+        if (!pShaderInfo->errors.empty()) {
+            return false;
+        }
+        store(key, pShaderInfo->spirv);
+        return true;
+    }
+
+    // Creates a gvk::PipelineCache seeded with the cache directory's blob if it
+    //  passes validation for device, otherwise the gvk::PipelineCache starts empty.
+    VkResult create_pipeline_cache(const gvk::Device& device, gvk::PipelineCache* pPipelineCache) const;
+
+    // Writes pipelineCache's data to the cache directory.
+    VkResult store_pipeline_cache(const gvk::PipelineCache& pipelineCache) const;
+
+    void reset();
+
+private:
+    std::filesystem::path get_spirv_path(uint64_t key) const;
+    std::filesystem::path get_pipeline_cache_path() const;
+
+    std::filesystem::path mDirectory;
+    Statistics mStatistics { };
+};
+
+} // namespace gfx
+} // namespace dst
@@ -0,0 +1,374 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#pragma once
+
+#include "dynamic-static.graphics/defines.hpp"
+#include "dynamic-static.graphics/primitives.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace dst {
+namespace gfx {
+namespace detail {
+
+struct Quadric
+{
+    inline static Quadric create(const glm::vec3& normal, float distance, float weight)
+    {
+        Quadric quadric { };
+        quadric.a00 = weight * normal.x * normal.x;
+        quadric.a01 = weight * normal.x * normal.y;
+        quadric.a02 = weight * normal.x * normal.z;
+        quadric.a11 = weight * normal.y * normal.y;
+        quadric.a12 = weight * normal.y * normal.z;
+        quadric.a22 = weight * normal.z * normal.z;
+        quadric.b0 = weight * normal.x * distance;
+        quadric.b1 = weight * normal.y * distance;
+        quadric.b2 = weight * normal.z * distance;
+        quadric.c = weight * distance * distance;
+        quadric.weight = weight;
+        return quadric;
+    }
+
+    inline Quadric& operator+=(const Quadric& other)
+    {
+        a00 += other.a00; a01 += other.a01; a02 += other.a02;
+        a11 += other.a11; a12 += other.a12; a22 += other.a22;
+        b0 += other.b0; b1 += other.b1; b2 += other.b2;
+        c += other.c;
+        weight += other.weight;
+        return *this;
+    }
+
+    inline double evaluate(const glm::vec3& p) const
+    {
+        // Returns the weighted mean squared distance from p to this Quadric's planes.
+        double x = p.x;
+        double y = p.y;
+        double z = p.z;
+        double error =
+            a00 * x * x + a11 * y * y + a22 * z * z +
+            2 * (a01 * x * y + a02 * x * z + a12 * y * z) +
+            2 * (b0 * x + b1 * y + b2 * z) +
+            c;
+        return 0 < weight ? std::max(error / weight, 0.0) : 0.0;
+    }
+
+    double a00 { 0 }, a01 { 0 }, a02 { 0 }, a11 { 0 }, a12 { 0 }, a22 { 0 };
+    double b0 { 0 }, b1 { 0 }, b2 { 0 };
+    double c { 0 };
+    double weight { 0 };
+};
+
+} // namespace detail
+
+template <typename IndexType>
+inline float simplify(
+    std::span<const glm::vec3> positions,
+    std::span<const primitive::Triangle<IndexType>> triangles,
+    size_t targetTriangleCount,
+    float targetError,
+    std::vector<primitive::Triangle<IndexType>>* pTriangles
+)
+{
+    // Quadric error metric edge collapse simplification.  Vertices are collapsed
+    //  onto one of their neighbors so output triangles reference the original
+    //  vertices and every level of detail can share one vertex buffer.  Vertices
+    //  that share a position with another vertex (attribute seams) and vertices on
+    //  open borders are locked.  Collapses are performed in passes of
+    //  non-overlapping collapses sorted by cost until targetTriangleCount is
+    //  reached or no collapse is under targetError.  Returns the largest error
+    //  (distance in position units) introduced by a collapse.
+    // FROM : Garland, Heckbert - "Surface Simplification Using Quadric Error Metrics"
+    assert(pTriangles);
+    auto vertexCount = positions.size();
+    auto& result = *pTriangles;
+    result.assign(triangles.begin(), triangles.end());
+
+    // Lock vertices on attribute seams, ie. vertices sharing a position.
+    std::vector<bool> locked(vertexCount, false);
+    {
+        auto hash_position = [](const glm::vec3& position)
+        {
+            std::hash<float> hasher;
+            return hasher(position.x) ^ (hasher(position.y) * 31) ^ (hasher(position.z) * 131);
+        };
+        std::unordered_multimap<size_t, IndexType> positionVertices;
+        positionVertices.reserve(vertexCount);
+        for (size_t vertex_i = 0; vertex_i < vertexCount; ++vertex_i) {
+            auto hash = hash_position(positions[vertex_i]);
+            auto range = positionVertices.equal_range(hash);
+            for (auto itr = range.first; itr != range.second; ++itr) {
+                if (positions[itr->second] == positions[vertex_i]) {
+                    locked[itr->second] = true;
+                    locked[vertex_i] = true;
+                }
+            }
+            positionVertices.insert({ hash, (IndexType)vertex_i });
+        }
+    }
+
+    // Lock vertices on open borders, ie. vertices with an edge used once.
+    {
+        std::unordered_map<primitive::Edge<IndexType>, uint32_t, primitive::EdgeHasher<IndexType>> edgeCounts;
+        for (const auto& triangle : result) {
+            for (uint32_t i = 0; i < 3; ++i) {
+                if (triangle[i] != triangle[(i + 1) % 3]) {
+                    ++edgeCounts[primitive::create_edge<IndexType>(triangle[i], triangle[(i + 1) % 3])];
+                }
+            }
+        }
+        for (const auto& edgeCount : edgeCounts) {
+            if (edgeCount.second == 1) {
+                locked[edgeCount.first[0]] = true;
+                locked[edgeCount.first[1]] = true;
+            }
+        }
+    }
+
+    // Accumulate area weighted plane quadrics.
+    std::vector<detail::Quadric> quadrics(vertexCount);
+    for (const auto& triangle : result) {
+        const auto& p0 = positions[triangle[0]];
+        const auto& p1 = positions[triangle[1]];
+        const auto& p2 = positions[triangle[2]];
+        auto normal = glm::cross(p1 - p0, p2 - p0);
+        auto length = glm::length(normal);
+        if (0 < length) {
+            normal /= length;
+            auto quadric = detail::Quadric::create(normal, -glm::dot(normal, p0), length * 0.5f);
+            for (auto index : triangle) {
+                quadrics[index] += quadric;
+            }
+        }
+    }
+
+    struct Collapse
+    {
+        IndexType from { 0 };
+        IndexType to { 0 };
+        double cost { 0 };
+    };
+    std::vector<Collapse> collapses;
+    std::vector<IndexType> remap(vertexCount);
+    std::vector<bool> touched(vertexCount);
+    std::vector<uint32_t> adjacencyOffsets;
+    std::vector<uint32_t> adjacency;
+    double maxError = 0;
+    auto maxCost = (double)targetError * (double)targetError;
+    while (targetTriangleCount < result.size()) {
+        // Build vertex/triangle adjacency for the current triangles.
+        adjacencyOffsets.assign(vertexCount + 1, 0);
+        for (const auto& triangle : result) {
+            for (auto index : triangle) {
+                ++adjacencyOffsets[index + 1];
+            }
+        }
+        for (size_t vertex_i = 0; vertex_i < vertexCount; ++vertex_i) {
+            adjacencyOffsets[vertex_i + 1] += adjacencyOffsets[vertex_i];
+        }
+        adjacency.resize(result.size() * 3);
+        std::vector<uint32_t> adjacencyCursors(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+        for (uint32_t triangle_i = 0; triangle_i < (uint32_t)result.size(); ++triangle_i) {
+            for (auto index : result[triangle_i]) {
+                adjacency[adjacencyCursors[index]++] = triangle_i;
+            }
+        }
+
+        // Gather candidate collapses for every edge, each edge collapses in the
+        //  cheaper direction that moves an unlocked vertex.  Interior edges are
+        //  visited once from each side, so only the side with v0 < v1 is used.
+        collapses.clear();
+        for (const auto& triangle : result) {
+            for (uint32_t i = 0; i < 3; ++i) {
+                auto v0 = triangle[i];
+                auto v1 = triangle[(i + 1) % 3];
+                if (v0 < v1) {
+                    auto quadric = quadrics[v0];
+                    quadric += quadrics[v1];
+                    auto cost0 = locked[v0] ? std::numeric_limits<double>::max() : quadric.evaluate(positions[v1]);
+                    auto cost1 = locked[v1] ? std::numeric_limits<double>::max() : quadric.evaluate(positions[v0]);
+                    if (cost0 <= cost1 && !locked[v0]) {
+                        collapses.push_back({ v0, v1, cost0 });
+                    } else if (!locked[v1]) {
+                        collapses.push_back({ v1, v0, cost1 });
+                    }
+                }
+            }
+        }
+        std::sort(collapses.begin(), collapses.end(), [](const Collapse& lhs, const Collapse& rhs) { return lhs.cost < rhs.cost; });
+
+        // Apply non-overlapping collapses in cost order.
+        for (size_t vertex_i = 0; vertex_i < vertexCount; ++vertex_i) {
+            remap[vertex_i] = (IndexType)vertex_i;
+        }
+        std::fill(touched.begin(), touched.end(), false);
+        auto triangleCount = result.size();
+        size_t collapseCount = 0;
+        for (const auto& collapse : collapses) {
+            if (maxCost < collapse.cost || triangleCount <= targetTriangleCount) {
+                break;
+            }
+            if (touched[collapse.from] || touched[collapse.to]) {
+                continue;
+            }
+            // Reject collapses that flip or degenerate a remaining triangle.
+            bool valid = true;
+            size_t removedTriangleCount = 0;
+            for (auto adjacency_i = adjacencyOffsets[collapse.from]; valid && adjacency_i < adjacencyOffsets[collapse.from + 1]; ++adjacency_i) {
+                const auto& triangle = result[adjacency[adjacency_i]];
+                if (triangle[0] == collapse.to || triangle[1] == collapse.to || triangle[2] == collapse.to) {
+                    ++removedTriangleCount;
+                    continue;
+                }
+                const auto& p0 = positions[triangle[0]];
+                const auto& p1 = positions[triangle[1]];
+                const auto& p2 = positions[triangle[2]];
+                auto normal = glm::cross(p1 - p0, p2 - p0);
+                auto collapsed = triangle;
+                for (auto& index : collapsed) {
+                    index = index == collapse.from ? collapse.to : index;
+                }
+                const auto& c0 = positions[collapsed[0]];
+                const auto& c1 = positions[collapsed[1]];
+                const auto& c2 = positions[collapsed[2]];
+                auto collapsedNormal = glm::cross(c1 - c0, c2 - c0);
+                valid = 0.25f * glm::length(normal) * glm::length(collapsedNormal) < glm::dot(normal, collapsedNormal);
+            }
+            if (!valid) {
+                continue;
+            }
+            remap[collapse.from] = collapse.to;
+            quadrics[collapse.to] += quadrics[collapse.from];
+            for (auto adjacency_i = adjacencyOffsets[collapse.from]; adjacency_i < adjacencyOffsets[collapse.from + 1]; ++adjacency_i) {
+                for (auto index : result[adjacency[adjacency_i]]) {
+                    touched[index] = true;
+                }
+            }
+            triangleCount -= std::min(removedTriangleCount, triangleCount);
+            maxError = std::max(maxError, collapse.cost);
+            ++collapseCount;
+        }
+        if (!collapseCount) {
+            break;
+        }
+
+        // Remap triangles and remove those that have become degenerate.
+        size_t writeIndex = 0;
+        for (const auto& triangle : result) {
+            primitive::Triangle<IndexType> remapped { remap[triangle[0]], remap[triangle[1]], remap[triangle[2]] };
+            if (remapped[0] != remapped[1] && remapped[1] != remapped[2] && remapped[2] != remapped[0]) {
+                result[writeIndex++] = remapped;
+            }
+        }
+        result.resize(writeIndex);
+    }
+    return (float)std::sqrt(maxError);
+}
+
+template <typename IndexType>
+struct LodLevel
+{
+    std::vector<primitive::Triangle<IndexType>> triangles;
+    float error { 0 };
+};
+
+struct LodChainCreateInfo
+{
+    uint32_t maxLevelCount { 8 };
+    float reduction { 0.5f };
+    float maxError { std::numeric_limits<float>::max() };
+    size_t minTriangleCount { 8 };
+};
+
+template <typename IndexType>
+inline void create_lod_chain(
+    std::span<const glm::vec3> positions,
+    std::span<const primitive::Triangle<IndexType>> triangles,
+    const LodChainCreateInfo& createInfo,
+    std::vector<LodLevel<IndexType>>* pLodLevels
+)
+{
+    // Level 0 is the input, each following level is simplified from the previous
+    //  level to reduction times its triangle count.  Level errors accumulate so
+    //  they're conservative bounds relative to level 0.  Generation stops when a
+    //  level fails to reduce by at least half of what was requested.
+    assert(0 < createInfo.reduction && createInfo.reduction < 1);
+    assert(pLodLevels);
+    auto& lodLevels = *pLodLevels;
+    lodLevels.clear();
+    lodLevels.push_back({ .triangles = { triangles.begin(), triangles.end() }, .error = 0 });
+    while (lodLevels.size() < createInfo.maxLevelCount) {
+        const auto& previous = lodLevels.back();
+        auto targetTriangleCount = std::max((size_t)(previous.triangles.size() * createInfo.reduction), createInfo.minTriangleCount);
+        if (previous.triangles.size() <= targetTriangleCount) {
+            break;
+        }
+        LodLevel<IndexType> lodLevel { };
+        auto error = simplify<IndexType>(positions, previous.triangles, targetTriangleCount, createInfo.maxError - previous.error, &lodLevel.triangles);
+        auto requiredTriangleCount = previous.triangles.size() - (previous.triangles.size() - targetTriangleCount) / 2;
+        if (requiredTriangleCount < lodLevel.triangles.size()) {
+            break;
+        }
+        lodLevel.error = previous.error + error;
+        lodLevels.push_back(std::move(lodLevel));
+    }
+}
+
+inline float get_lod_projection_scale(float viewportHeight, float fieldOfView)
+{
+    // Pixels per unit at a distance of 1 for a perspective projection with the
+    //  given vertical fieldOfView (in radians).
+    return viewportHeight / (2.0f * std::tan(fieldOfView * 0.5f));
+}
+
+template <typename IndexType>
+inline size_t select_lod(std::span<const LodLevel<IndexType>> lodLevels, float distance, float projectionScale, float maxPixelError = 1.0f)
+{
+    // Selects the coarsest level whose error projected to the screen at distance
+    //  is no more than maxPixelError.  Errors are in object space, so scale either
+    //  distance or projectionScale by the object's scale.
+    size_t lod = 0;
+    if (0 < distance) {
+        for (size_t lod_i = 1; lod_i < lodLevels.size(); ++lod_i) {
+            if (lodLevels[lod_i].error * projectionScale / distance <= maxPixelError) {
+                lod = lod_i;
+            }
+        }
+    }
+    return lod;
+}
+
+} // namespace gfx
+} // namespace dst
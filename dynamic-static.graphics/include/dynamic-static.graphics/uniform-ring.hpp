@@ -0,0 +1,160 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#pragma once
+
+#include "dynamic-static.graphics/defines.hpp"
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <span>
+
+namespace dst {
+namespace gfx {
+
+class UniformRingAllocator final
+{
+public:
+    struct CreateInfo final
+    {
+        uint32_t frameCount { 2 };
+        uint64_t frameSize { 64 * 1024 };
+
+        // Must be a power of two, for uniform buffers this is
+        //  VkPhysicalDeviceLimits::minUniformBufferOffsetAlignment.
+        uint64_t alignment { 256 };
+    };
+
+    // Offset allocator for UniformRing, kept separate so it can be used and tested
+    //  without a device.  The ring is split into one region per frame in flight,
+    //  begin_frame() rewinds a frame's region so allocations wrap back to its start
+    //  each time the frame comes around.  Callers must have waited for the GPU to
+    //  finish with a frame before calling begin_frame() for it.  Frame sizes are
+    //  rounded up to alignment so every allocation offset is aligned.
+    static void create(const CreateInfo* pCreateInfo, UniformRingAllocator* pUniformRingAllocator);
+
+    uint32_t get_frame_count() const;
+    uint64_t get_frame_size() const;
+    uint64_t get_size() const;
+    uint32_t get_frame_index() const;
+    uint64_t get_frame_offset() const;
+    uint64_t get_used_size() const;
+    void begin_frame(uint32_t frameIndex);
+
+    // Returns false if the current frame's region doesn't have room for size.
+    bool allocate(uint64_t size, uint64_t* pOffset);
+
+    void reset();
+
+private:
+    uint32_t mFrameCount { 0 };
+    uint64_t mFrameSize { 0 };
+    uint64_t mAlignment { 1 };
+    uint32_t mFrameIndex { 0 };
+    uint64_t mUsedSize { 0 };
+};
+
+class UniformRing final
+{
+public:
+    struct CreateInfo final
+    {
+        uint32_t frameCount { 2 };
+        uint64_t frameSize { 64 * 1024 };
+        uint64_t alignment { 256 };
+
+        // Usage in addition to VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, ie.
+        //  VK_BUFFER_USAGE_VERTEX_BUFFER_BIT to stream per instance data.
+        VkBufferUsageFlags usage { 0 };
+    };
+
+    // One persistently mapped uniform buffer shared by every object drawn in a
+    //  frame.  Objects write() their uniforms each frame and bind a single
+    //  VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC descriptor with the returned
+    //  offset instead of owning a buffer and descriptor set each.  The region for
+    //  every frame in flight lives in the same buffer so one descriptor covers all
+    //  of them.  pCreateInfo->alignment is raised to the device's
+    //  minUniformBufferOffsetAlignment.
+    static VkResult create(const gvk::Device& device, const CreateInfo* pCreateInfo, UniformRing* pUniformRing);
+
+    uint32_t get_frame_count() const;
+    const gvk::Buffer& get_buffer() const;
+    const UniformRingAllocator& get_allocator() const;
+    void begin_frame(uint32_t frameIndex);
+
+    // Makes the current frame's writes visible to the device, this is a no-op
+    //  when the buffer's memory is host coherent.  Call before submitting.
+    VkResult flush();
+
+    void reset();
+
+    template <typename T>
+    inline bool write(const T& value, uint32_t* pDynamicOffset)
+    {
+        assert(mpMappedData);
+        assert(pDynamicOffset);
+        uint64_t offset = 0;
+        if (!mAllocator.allocate(sizeof(T), &offset)) {
+            return false;
+        }
+        memcpy(mpMappedData + offset, &value, sizeof(T));
+        *pDynamicOffset = (uint32_t)offset;
+        return true;
+    }
+
+    // Writes an array of values in one allocation, ie. an instance stream bound
+    //  with vkCmdBindVertexBuffers() at the returned offset.
+    template <typename T>
+    inline bool write(std::span<const T> values, uint64_t* pOffset)
+    {
+        assert(mpMappedData);
+        assert(pOffset);
+        if (!mAllocator.allocate(values.size_bytes(), pOffset)) {
+            return false;
+        }
+        if (!values.empty()) {
+            memcpy(mpMappedData + *pOffset, values.data(), values.size_bytes());
+        }
+        return true;
+    }
+
+    template <typename T>
+    inline VkDescriptorBufferInfo get_descriptor_buffer_info() const
+    {
+        // The range of a dynamic uniform buffer descriptor is fixed, the offset
+        //  comes from vkCmdBindDescriptorSets().
+        return { mBuffer, 0, sizeof(T) };
+    }
+
+private:
+    gvk::Buffer mBuffer;
+    uint8_t* mpMappedData { nullptr };
+    UniformRingAllocator mAllocator;
+};
+
+} // namespace gfx
+} // namespace dst
@@ -0,0 +1,197 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+
+#pragma once
+
+#include "dynamic-static.graphics/defines.hpp"
+#include "dynamic-static.graphics/mesh.hpp"
+#include "dynamic-static/frame-arena.hpp"
+
+#include <cassert>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace dst {
+namespace gfx {
+
+class StagingRingAllocator final
+{
+public:
+    struct CreateInfo final
+    {
+        uint64_t size { 16 * 1024 * 1024 };
+
+        // Must be a power of two.
+        uint64_t alignment { 16 };
+    };
+
+    // Offset allocator for UploadBatcher's staging buffer, kept separate so it can
+    //  be used and tested without a device.  Allocations are made in order at the
+    //  head of the ring and released in order from its tail, release() takes a
+    //  value previously returned by get_head() and frees everything allocated
+    //  before it.  Allocations are never split across the end of the ring, the
+    //  remainder of the ring is skipped instead.
+    static void create(const CreateInfo* pCreateInfo, StagingRingAllocator* pStagingRingAllocator);
+
+    uint64_t get_size() const;
+    uint64_t get_used_size() const;
+    uint64_t get_head() const;
+
+    // Returns false if the ring doesn't have room for size until more is
+    //  released.  size must not exceed get_size().
+    bool allocate(uint64_t size, uint64_t* pOffset);
+
+    void release(uint64_t head);
+    void reset();
+
+private:
+    // Head and tail increase monotonically, offsets into the ring are taken
+    //  modulo mSize so a full ring and an empty ring are distinguishable.
+    uint64_t mSize { 0 };
+    uint64_t mAlignment { 1 };
+    uint64_t mHead { 0 };
+    uint64_t mTail { 0 };
+};
+
+class UploadBatcher final
+{
+public:
+    struct CreateInfo final
+    {
+        uint64_t stagingSize { 16 * 1024 * 1024 };
+
+        // The number of submitted batches that can be in flight, when a batch's
+        //  slot comes back around before it completes the UploadBatcher waits.
+        uint32_t batchCount { 4 };
+    };
+
+    struct Statistics final
+    {
+        uint32_t submitCount { 0 };
+        uint32_t copyCount { 0 };
+        uint64_t byteCount { 0 };
+        uint32_t waitCount { 0 };
+    };
+
+    // Packs buffer uploads into a persistently mapped staging ring and records
+    //  every copy in a batch into one command buffer, submit() issues one
+    //  vkQueueSubmit() per batch.  Writes return a token identifying their batch,
+    //  callers check or wait on the token instead of stalling per upload.  Copies
+    //  are followed by a barrier that makes them visible to vertex, index, uniform
+    //  and shader reads in later submissions to the same queue, so draws that use
+    //  uploaded buffers only need to be submitted after the batch.  Staging memory
+    //  is reclaimed as batches complete, a write that doesn't fit submits the
+    //  current batch and waits for the oldest.
+    static VkResult create(const gvk::Device& device, const gvk::Queue& queue, const CreateInfo* pCreateInfo, UploadBatcher* pUploadBatcher);
+
+    ~UploadBatcher();
+
+    const Statistics& get_statistics() const;
+
+    // The token of the batch that writes are currently recorded into.
+    uint64_t get_token() const;
+
+    VkResult write(const gvk::Buffer& buffer, VkDeviceSize offset, std::span<const uint8_t> data, uint64_t* pToken = nullptr);
+
+    template <typename T>
+    inline VkResult write(const gvk::Buffer& buffer, VkDeviceSize offset, std::span<const T> values, uint64_t* pToken = nullptr)
+    {
+        return write(buffer, offset, { (const uint8_t*)values.data(), values.size_bytes() }, pToken);
+    }
+
+    // Creates device local vertex and index buffers for pMesh and records their
+    //  uploads.  IndexType must be uint16_t or uint32_t.
+    template <typename VertexType, typename IndexType>
+    inline VkResult write_mesh(std::span<const VertexType> vertices, std::span<const IndexType> indices, Mesh* pMesh, uint64_t* pToken = nullptr)
+    {
+        static_assert(sizeof(IndexType) == sizeof(uint16_t) || sizeof(IndexType) == sizeof(uint32_t));
+        return write_mesh(
+            { (const uint8_t*)vertices.data(), vertices.size_bytes() },
+            (uint32_t)vertices.size(),
+            { (const uint8_t*)indices.data(), indices.size_bytes() },
+            (uint32_t)indices.size(),
+            sizeof(IndexType) == sizeof(uint16_t) ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32,
+            pMesh,
+            pToken
+        );
+    }
+
+    // Submits the current batch, a no-op if nothing has been written since the
+    //  last submit().
+    VkResult submit();
+
+    // Returns true once the batch identified by token has finished executing.
+    bool is_complete(uint64_t token);
+
+    // Submits token's batch if it hasn't been submitted, then waits for it.
+    VkResult wait(uint64_t token);
+
+    void reset();
+
+private:
+    struct Copy final
+    {
+        VkBuffer buffer { VK_NULL_HANDLE };
+        VkBufferCopy region { };
+    };
+
+    struct Batch final
+    {
+        gvk::CommandBuffer commandBuffer;
+        gvk::Fence fence;
+        uint64_t token { 0 };
+        uint64_t stagingHead { 0 };
+        std::vector<gvk::Buffer> buffers;
+    };
+
+    VkResult write_mesh(std::span<const uint8_t> vertexData, uint32_t vertexCount, std::span<const uint8_t> indexData, uint32_t indexCount, VkIndexType indexType, Mesh* pMesh, uint64_t* pToken);
+    VkResult allocate(uint64_t size, uint64_t* pOffset);
+
+    // Retires completed batches in submission order, waiting for batches up to
+    //  and including waitToken.
+    VkResult retire_batches(uint64_t waitToken);
+    Batch& get_batch(uint64_t token);
+
+    gvk::Device mDevice;
+    gvk::Queue mQueue;
+    gvk::CommandPool mCommandPool;
+    gvk::Buffer mStagingBuffer;
+    uint8_t* mpMappedData { nullptr };
+    StagingRingAllocator mStagingRingAllocator;
+
+    // Backs the merged copy regions built in submit(), cleared every submit().
+    FrameArena mFrameArena;
+    std::vector<Batch> mBatches;
+    std::vector<Copy> mCopies;
+    uint64_t mToken { 1 };
+    uint64_t mCompletedToken { 0 };
+    Statistics mStatistics { };
+};
+
+} // namespace gfx
+} // namespace dst
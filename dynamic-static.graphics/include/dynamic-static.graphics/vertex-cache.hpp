@@ -0,0 +1,402 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#pragma once
+
+#include "dynamic-static.graphics/defines.hpp"
+#include "dynamic-static.graphics/primitives.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace dst {
+namespace gfx {
+
+struct VertexCacheStatistics
+{
+    uint32_t vertexTransformCount { 0 };
+    float acmr { 0 };
+    float atvr { 0 };
+};
+
+template <typename IndexType>
+inline VertexCacheStatistics analyze_vertex_cache(std::span<const primitive::Triangle<IndexType>> triangles, size_t vertexCount, uint32_t cacheSize = 16)
+{
+    // Simulates a FIFO post-transform cache.  A vertex is a hit if it was
+    //  transformed within the last cacheSize transforms.
+    assert(cacheSize);
+    VertexCacheStatistics statistics { };
+    std::vector<uint32_t> cacheTimestamps(vertexCount, 0);
+    uint32_t timestamp = cacheSize + 1;
+    for (const auto& triangle : triangles) {
+        for (auto index : triangle) {
+            assert(index < vertexCount);
+            if (cacheSize < timestamp - cacheTimestamps[index]) {
+                cacheTimestamps[index] = timestamp++;
+                ++statistics.vertexTransformCount;
+            }
+        }
+    }
+    auto usedVertexCount = std::count_if(cacheTimestamps.begin(), cacheTimestamps.end(), [](uint32_t cacheTimestamp) { return cacheTimestamp != 0; });
+    statistics.acmr = triangles.empty() ? 0.0f : (float)statistics.vertexTransformCount / (float)triangles.size();
+    statistics.atvr = usedVertexCount ? (float)statistics.vertexTransformCount / (float)usedVertexCount : 0.0f;
+    return statistics;
+}
+
+namespace detail {
+
+constexpr uint32_t VertexCacheOptimizerCacheSize = 32;
+constexpr uint32_t VertexCacheOptimizerValenceTableSize = 32;
+
+inline float get_vertex_cache_optimizer_score(int32_t cachePosition, uint32_t liveTriangleCount)
+{
+    // FROM : https://tomforsyth1000.github.io/papers/fast_vert_cache_opt.html
+    static const auto CacheScores = []()
+    {
+        constexpr float CacheDecayPower = 1.5f;
+        constexpr float LastTriangleScore = 0.75f;
+        std::array<float, VertexCacheOptimizerCacheSize> cacheScores { };
+        for (uint32_t i = 0; i < VertexCacheOptimizerCacheSize; ++i) {
+            if (i < 3) {
+                cacheScores[i] = LastTriangleScore;
+            } else {
+                auto scale = 1.0f / (VertexCacheOptimizerCacheSize - 3);
+                cacheScores[i] = std::pow(1.0f - (i - 3) * scale, CacheDecayPower);
+            }
+        }
+        return cacheScores;
+    }();
+    static const auto ValenceScores = []()
+    {
+        constexpr float ValenceBoostScale = 2.0f;
+        constexpr float ValenceBoostPower = 0.5f;
+        std::array<float, VertexCacheOptimizerValenceTableSize> valenceScores { };
+        for (uint32_t i = 1; i < VertexCacheOptimizerValenceTableSize; ++i) {
+            valenceScores[i] = ValenceBoostScale * std::pow((float)i, -ValenceBoostPower);
+        }
+        return valenceScores;
+    }();
+    if (!liveTriangleCount) {
+        return -1.0f;
+    }
+    auto score = 0 <= cachePosition ? CacheScores[cachePosition] : 0.0f;
+    if (liveTriangleCount < VertexCacheOptimizerValenceTableSize) {
+        score += ValenceScores[liveTriangleCount];
+    } else {
+        score += 2.0f / std::sqrt((float)liveTriangleCount);
+    }
+    return score;
+}
+
+} // namespace detail
+
+template <typename IndexType>
+inline void optimize_vertex_cache(std::span<primitive::Triangle<IndexType>> triangles, size_t vertexCount)
+{
+    // Reorders triangles for post-transform cache locality using Tom Forsyth's
+    //  "Linear-Speed Vertex Cache Optimisation".  Vertex indices are unchanged.
+    constexpr auto CacheSize = detail::VertexCacheOptimizerCacheSize;
+    constexpr auto InvalidTriangle = std::numeric_limits<size_t>::max();
+    auto triangleCount = triangles.size();
+    if (!triangleCount) {
+        return;
+    }
+
+    // Build vertex/triangle adjacency.  Each vertex's triangles are stored in a
+    //  contiguous range of adjacency, the first liveTriangleCounts[vertex] entries
+    //  are the triangles that haven't been emitted yet.
+    std::vector<uint32_t> liveTriangleCounts(vertexCount, 0);
+    for (const auto& triangle : triangles) {
+        for (auto index : triangle) {
+            assert(index < vertexCount);
+            ++liveTriangleCounts[index];
+        }
+    }
+    std::vector<size_t> adjacencyOffsets(vertexCount + 1, 0);
+    for (size_t vertex_i = 0; vertex_i < vertexCount; ++vertex_i) {
+        adjacencyOffsets[vertex_i + 1] = adjacencyOffsets[vertex_i] + liveTriangleCounts[vertex_i];
+    }
+    std::vector<size_t> adjacency(triangleCount * 3);
+    std::vector<size_t> adjacencyCursors(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+    for (size_t triangle_i = 0; triangle_i < triangleCount; ++triangle_i) {
+        for (auto index : triangles[triangle_i]) {
+            adjacency[adjacencyCursors[index]++] = triangle_i;
+        }
+    }
+
+    // Initialize vertex and triangle scores.
+    std::vector<int32_t> cachePositions(vertexCount, -1);
+    std::vector<float> vertexScores(vertexCount);
+    for (size_t vertex_i = 0; vertex_i < vertexCount; ++vertex_i) {
+        vertexScores[vertex_i] = detail::get_vertex_cache_optimizer_score(-1, liveTriangleCounts[vertex_i]);
+    }
+    std::vector<float> triangleScores(triangleCount);
+    auto bestTriangle = InvalidTriangle;
+    auto bestScore = -std::numeric_limits<float>::max();
+    for (size_t triangle_i = 0; triangle_i < triangleCount; ++triangle_i) {
+        const auto& triangle = triangles[triangle_i];
+        triangleScores[triangle_i] = vertexScores[triangle[0]] + vertexScores[triangle[1]] + vertexScores[triangle[2]];
+        if (bestScore < triangleScores[triangle_i]) {
+            bestScore = triangleScores[triangle_i];
+            bestTriangle = triangle_i;
+        }
+    }
+
+    std::vector<bool> emitted(triangleCount, false);
+    std::vector<primitive::Triangle<IndexType>> output;
+    output.reserve(triangleCount);
+    std::vector<IndexType> cache;
+    std::vector<IndexType> updatedCache;
+    cache.reserve(CacheSize + 3);
+    updatedCache.reserve(CacheSize + 3);
+    size_t inputCursor = 0;
+    while (output.size() < triangleCount) {
+        // If no cached vertex has a live triangle, resume with the next triangle that
+        //  hasn't been emitted in input order.
+        if (bestTriangle == InvalidTriangle) {
+            while (emitted[inputCursor]) {
+                ++inputCursor;
+            }
+            bestTriangle = inputCursor;
+        }
+        const auto triangle = triangles[bestTriangle];
+        emitted[bestTriangle] = true;
+        output.push_back(triangle);
+
+        // Remove the emitted triangle from its vertices' live triangles.
+        for (auto index : triangle) {
+            auto begin = adjacency.begin() + adjacencyOffsets[index];
+            auto end = begin + liveTriangleCounts[index];
+            auto itr = std::find(begin, end, bestTriangle);
+            if (itr != end) {
+                std::iter_swap(itr, end - 1);
+                --liveTriangleCounts[index];
+            }
+        }
+
+        // Move the emitted triangle's vertices to the front of the LRU cache, the
+        //  entries pushed past CacheSize are evicted.
+        updatedCache.assign(triangle.begin(), triangle.end());
+        for (auto index : cache) {
+            if (index != triangle[0] && index != triangle[1] && index != triangle[2]) {
+                updatedCache.push_back(index);
+            }
+        }
+        std::swap(cache, updatedCache);
+
+        // Update scores for every vertex that was touched then choose the best live
+        //  triangle referencing a cached vertex.
+        for (size_t cache_i = 0; cache_i < cache.size(); ++cache_i) {
+            auto index = cache[cache_i];
+            cachePositions[index] = cache_i < CacheSize ? (int32_t)cache_i : -1;
+            auto score = detail::get_vertex_cache_optimizer_score(cachePositions[index], liveTriangleCounts[index]);
+            auto scoreDelta = score - vertexScores[index];
+            vertexScores[index] = score;
+            auto adjacencyBegin = adjacencyOffsets[index];
+            for (uint32_t i = 0; i < liveTriangleCounts[index]; ++i) {
+                triangleScores[adjacency[adjacencyBegin + i]] += scoreDelta;
+            }
+        }
+        if (CacheSize < cache.size()) {
+            cache.resize(CacheSize);
+        }
+        bestTriangle = InvalidTriangle;
+        bestScore = -std::numeric_limits<float>::max();
+        for (auto index : cache) {
+            auto adjacencyBegin = adjacencyOffsets[index];
+            for (uint32_t i = 0; i < liveTriangleCounts[index]; ++i) {
+                auto triangle_i = adjacency[adjacencyBegin + i];
+                if (bestScore < triangleScores[triangle_i]) {
+                    bestScore = triangleScores[triangle_i];
+                    bestTriangle = triangle_i;
+                }
+            }
+        }
+    }
+    std::copy(output.begin(), output.end(), triangles.begin());
+}
+
+template <typename IndexType>
+inline void optimize_overdraw(std::span<primitive::Triangle<IndexType>> triangles, std::span<const glm::vec3> positions, float threshold = 1.05f, uint32_t cacheSize = 16)
+{
+    // Sorts clusters of triangles front to back relative to the mesh centroid so
+    //  that outward facing clusters are more likely to be drawn first, reducing
+    //  overdraw from any view direction.  Hard cluster boundaries are triangles
+    //  that miss the cache on every vertex, hard clusters are then split into soft
+    //  clusters as long as each soft cluster's ACMR stays within threshold of its
+    //  hard cluster's ACMR.  Call after optimize_vertex_cache().
+    // FROM : Sander, Nehab, Barczak - "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw"
+    assert(1 <= threshold);
+    assert(cacheSize);
+    if (triangles.empty()) {
+        return;
+    }
+    std::vector<uint32_t> cacheTimestamps(positions.size(), 0);
+    uint32_t timestamp = cacheSize + 1;
+    auto get_miss_count = [&](const primitive::Triangle<IndexType>& triangle)
+    {
+        uint32_t missCount = 0;
+        for (auto index : triangle) {
+            assert(index < positions.size());
+            if (cacheSize < timestamp - cacheTimestamps[index]) {
+                cacheTimestamps[index] = timestamp++;
+                ++missCount;
+            }
+        }
+        return missCount;
+    };
+    auto flush_cache = [&]()
+    {
+        timestamp += cacheSize + 1;
+    };
+
+    // The first triangle always starts a hard cluster, even when it's degenerate
+    //  or shares vertices, so every triangle belongs to a cluster.
+    std::vector<size_t> hardBoundaries;
+    for (size_t triangle_i = 0; triangle_i < triangles.size(); ++triangle_i) {
+        auto missCount = get_miss_count(triangles[triangle_i]);
+        if (!triangle_i || missCount == 3) {
+            hardBoundaries.push_back(triangle_i);
+        }
+    }
+    hardBoundaries.push_back(triangles.size());
+
+    std::vector<size_t> softBoundaries;
+    for (size_t hardBoundary_i = 0; hardBoundary_i + 1 < hardBoundaries.size(); ++hardBoundary_i) {
+        auto begin = hardBoundaries[hardBoundary_i];
+        auto end = hardBoundaries[hardBoundary_i + 1];
+        flush_cache();
+        uint32_t hardClusterMissCount = 0;
+        for (auto triangle_i = begin; triangle_i < end; ++triangle_i) {
+            hardClusterMissCount += get_miss_count(triangles[triangle_i]);
+        }
+        auto softClusterThreshold = threshold * (float)hardClusterMissCount / (float)(end - begin);
+        flush_cache();
+        softBoundaries.push_back(begin);
+        uint32_t softClusterMissCount = 0;
+        for (auto triangle_i = begin; triangle_i < end; ++triangle_i) {
+            softClusterMissCount += get_miss_count(triangles[triangle_i]);
+            auto softClusterTriangleCount = triangle_i + 1 - softBoundaries.back();
+            if (triangle_i + 1 < end && (float)softClusterMissCount / (float)softClusterTriangleCount <= softClusterThreshold) {
+                softBoundaries.push_back(triangle_i + 1);
+                softClusterMissCount = 0;
+                flush_cache();
+            }
+        }
+    }
+    softBoundaries.push_back(triangles.size());
+
+    struct Cluster
+    {
+        size_t begin { 0 };
+        size_t end { 0 };
+        float sortKey { 0 };
+    };
+    std::vector<Cluster> clusters;
+    clusters.reserve(softBoundaries.size() - 1);
+    glm::vec3 meshCentroid { };
+    float meshArea = 0;
+    std::vector<glm::vec3> clusterCentroids;
+    std::vector<glm::vec3> clusterNormals;
+    for (size_t softBoundary_i = 0; softBoundary_i + 1 < softBoundaries.size(); ++softBoundary_i) {
+        Cluster cluster { .begin = softBoundaries[softBoundary_i], .end = softBoundaries[softBoundary_i + 1] };
+        glm::vec3 clusterCentroid { };
+        glm::vec3 clusterNormal { };
+        float clusterArea = 0;
+        for (auto triangle_i = cluster.begin; triangle_i < cluster.end; ++triangle_i) {
+            const auto& triangle = triangles[triangle_i];
+            const auto& p0 = positions[triangle[0]];
+            const auto& p1 = positions[triangle[1]];
+            const auto& p2 = positions[triangle[2]];
+            auto normal = glm::cross(p1 - p0, p2 - p0);
+            auto area = glm::length(normal) * 0.5f;
+            clusterCentroid += (p0 + p1 + p2) * (area / 3.0f);
+            clusterNormal += normal;
+            clusterArea += area;
+        }
+        meshCentroid += clusterCentroid;
+        meshArea += clusterArea;
+        clusterCentroids.push_back(0 < clusterArea ? clusterCentroid / clusterArea : clusterCentroid);
+        clusterNormals.push_back(clusterNormal);
+        clusters.push_back(cluster);
+    }
+    if (0 < meshArea) {
+        meshCentroid /= meshArea;
+    }
+    for (size_t cluster_i = 0; cluster_i < clusters.size(); ++cluster_i) {
+        auto normalLength = glm::length(clusterNormals[cluster_i]);
+        if (0 < normalLength) {
+            clusters[cluster_i].sortKey = glm::dot(clusterCentroids[cluster_i] - meshCentroid, clusterNormals[cluster_i] / normalLength);
+        }
+    }
+    std::stable_sort(clusters.begin(), clusters.end(), [](const Cluster& lhs, const Cluster& rhs) { return rhs.sortKey < lhs.sortKey; });
+    std::vector<primitive::Triangle<IndexType>> output;
+    output.reserve(triangles.size());
+    for (const auto& cluster : clusters) {
+        output.insert(output.end(), triangles.begin() + cluster.begin, triangles.begin() + cluster.end);
+    }
+    std::copy(output.begin(), output.end(), triangles.begin());
+}
+
+template <typename IndexType, typename VertexType, typename AllocatorType>
+inline size_t optimize_vertex_fetch(std::span<primitive::Triangle<IndexType>> triangles, std::vector<VertexType, AllocatorType>* pVertices)
+{
+    // Reorders vertices to match the order they're first referenced by triangles
+    //  and updates indices accordingly.  Unreferenced vertices are removed.
+    //  Temporaries allocate from pVertices' allocator.
+    assert(pVertices);
+    auto& vertices = *pVertices;
+    constexpr auto Unused = std::numeric_limits<IndexType>::max();
+    using IndexAllocatorType = typename std::allocator_traits<AllocatorType>::template rebind_alloc<IndexType>;
+    std::vector<IndexType, IndexAllocatorType> remap(vertices.size(), Unused, IndexAllocatorType(vertices.get_allocator()));
+    IndexType vertexCount = 0;
+    for (auto& triangle : triangles) {
+        for (auto& index : triangle) {
+            assert(index < vertices.size());
+            if (remap[index] == Unused) {
+                remap[index] = vertexCount++;
+            }
+            index = remap[index];
+        }
+    }
+    std::vector<VertexType, AllocatorType> remappedVertices(vertexCount, vertices.get_allocator());
+    for (size_t vertex_i = 0; vertex_i < remap.size(); ++vertex_i) {
+        if (remap[vertex_i] != Unused) {
+            remappedVertices[remap[vertex_i]] = vertices[vertex_i];
+        }
+    }
+    vertices = std::move(remappedVertices);
+    return vertexCount;
+}
+
+} // namespace gfx
+} // namespace dst
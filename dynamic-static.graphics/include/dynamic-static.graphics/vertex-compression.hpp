@@ -0,0 +1,216 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#pragma once
+
+#include "dynamic-static.graphics/defines.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <span>
+
+namespace dst {
+namespace gfx {
+
+struct QuantizationBounds
+{
+    glm::vec3 min { };
+    glm::vec3 extent { };
+};
+
+QuantizationBounds compute_quantization_bounds(size_t count, const glm::vec3* pPositions, size_t stride = sizeof(glm::vec3));
+glm::mat4 get_dequantization_matrix(const QuantizationBounds& bounds);
+
+inline uint16_t float_to_half(float value)
+{
+    uint32_t bits = 0;
+    memcpy(&bits, &value, sizeof(bits));
+    uint32_t sign = (bits >> 16) & 0x8000;
+    uint32_t absBits = bits & 0x7fffffff;
+    if (0x7f800000 <= absBits) {
+        return (uint16_t)(sign | 0x7c00 | (0x7f800000 < absBits ? 0x200 : 0));
+    }
+    if (0x477ff000 <= absBits) {
+        return (uint16_t)(sign | 0x7c00);
+    }
+    if (absBits < 0x38800000) {
+        float absValue = 0;
+        memcpy(&absValue, &absBits, sizeof(absValue));
+        return (uint16_t)(sign | (uint32_t)std::nearbyint(absValue * 16777216.0f));
+    }
+    uint32_t rebiased = absBits - 0x38000000;
+    rebiased += 0xfff + ((rebiased >> 13) & 1);
+    return (uint16_t)(sign | (rebiased >> 13));
+}
+
+inline float half_to_float(uint16_t value)
+{
+    uint32_t sign = (uint32_t)(value & 0x8000) << 16;
+    uint32_t exponent = (value >> 10) & 0x1f;
+    uint32_t mantissa = value & 0x3ff;
+    if (!exponent) {
+        auto result = (float)mantissa * (1.0f / 16777216.0f);
+        return sign ? -result : result;
+    }
+    uint32_t bits = sign | (exponent == 0x1f ? 0x7f800000 | (mantissa << 13) : ((exponent + 112) << 23) | (mantissa << 13));
+    float result = 0;
+    memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+inline Unorm16x4 pack_position(const glm::vec3& position, const QuantizationBounds& bounds)
+{
+    auto quantize = [](float value, float min, float extent)
+    {
+        auto scale = 0 < extent ? 1.0f / extent : 0.0f;
+        return (uint16_t)std::nearbyint(std::clamp((value - min) * scale, 0.0f, 1.0f) * 65535.0f);
+    };
+    return {
+        quantize(position.x, bounds.min.x, bounds.extent.x),
+        quantize(position.y, bounds.min.y, bounds.extent.y),
+        quantize(position.z, bounds.min.z, bounds.extent.z),
+        0,
+    };
+}
+
+inline glm::vec3 unpack_position(const Unorm16x4& position, const QuantizationBounds& bounds)
+{
+    return bounds.min + glm::vec3 { position.x / 65535.0f, position.y / 65535.0f, position.z / 65535.0f } * bounds.extent;
+}
+
+inline Snorm16x2 pack_normal(const glm::vec3& normal)
+{
+    // FROM : Cigolle et al. - "A Survey of Efficient Representations for Independent Unit Vectors"
+    auto l1Norm = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+    auto x = 0 < l1Norm ? normal.x / l1Norm : 0.0f;
+    auto y = 0 < l1Norm ? normal.y / l1Norm : 0.0f;
+    if (normal.z < 0) {
+        auto foldedX = (1.0f - std::abs(y)) * std::copysign(1.0f, x);
+        auto foldedY = (1.0f - std::abs(x)) * std::copysign(1.0f, y);
+        x = foldedX;
+        y = foldedY;
+    }
+    return {
+        (int16_t)std::nearbyint(std::clamp(x, -1.0f, 1.0f) * 32767.0f),
+        (int16_t)std::nearbyint(std::clamp(y, -1.0f, 1.0f) * 32767.0f),
+    };
+}
+
+inline glm::vec3 unpack_normal(const Snorm16x2& normal)
+{
+    auto x = std::max(normal.x / 32767.0f, -1.0f);
+    auto y = std::max(normal.y / 32767.0f, -1.0f);
+    auto z = 1.0f - std::abs(x) - std::abs(y);
+    auto t = std::max(-z, 0.0f);
+    x += 0 <= x ? -t : t;
+    y += 0 <= y ? -t : t;
+    return glm::normalize(glm::vec3 { x, y, z });
+}
+
+inline Half2 pack_texcoord(const glm::vec2& texcoord)
+{
+    return { float_to_half(texcoord.x), float_to_half(texcoord.y) };
+}
+
+inline glm::vec2 unpack_texcoord(const Half2& texcoord)
+{
+    return { half_to_float(texcoord.x), half_to_float(texcoord.y) };
+}
+
+inline Unorm8x4 pack_color(const glm::vec4& color)
+{
+    auto quantize = [](float value)
+    {
+        return (uint8_t)std::nearbyint(std::clamp(value, 0.0f, 1.0f) * 255.0f);
+    };
+    return { quantize(color.x), quantize(color.y), quantize(color.z), quantize(color.w) };
+}
+
+inline glm::vec4 unpack_color(const Unorm8x4& color)
+{
+    return { color.x / 255.0f, color.y / 255.0f, color.z / 255.0f, color.w / 255.0f };
+}
+
+// Batch kernels.  Inputs and outputs may be interleaved, strides are in bytes.
+//  SSE2 is used for positions, normals and colors, F16C is used for texcoords
+//  when available.
+void pack_positions(size_t count, const glm::vec3* pPositions, size_t stride, const QuantizationBounds& bounds, Unorm16x4* pPackedPositions, size_t packedStride);
+void unpack_positions(size_t count, const Unorm16x4* pPackedPositions, size_t packedStride, const QuantizationBounds& bounds, glm::vec3* pPositions, size_t stride);
+void pack_normals(size_t count, const glm::vec3* pNormals, size_t stride, Snorm16x2* pPackedNormals, size_t packedStride);
+void unpack_normals(size_t count, const Snorm16x2* pPackedNormals, size_t packedStride, glm::vec3* pNormals, size_t stride);
+void pack_texcoords(size_t count, const glm::vec2* pTexcoords, size_t stride, Half2* pPackedTexcoords, size_t packedStride);
+void unpack_texcoords(size_t count, const Half2* pPackedTexcoords, size_t packedStride, glm::vec2* pTexcoords, size_t stride);
+void pack_colors(size_t count, const glm::vec4* pColors, size_t stride, Unorm8x4* pPackedColors, size_t packedStride);
+void unpack_colors(size_t count, const Unorm8x4* pPackedColors, size_t packedStride, glm::vec4* pColors, size_t stride);
+
+template <typename VertexType, typename PackedVertexType>
+inline void pack_vertices(std::span<const VertexType> vertices, const QuantizationBounds& bounds, std::span<PackedVertexType> packedVertices)
+{
+    assert(vertices.size() <= packedVertices.size());
+    if (vertices.empty()) {
+        return;
+    }
+    auto count = vertices.size();
+    const auto& vertex = vertices[0];
+    auto& packedVertex = packedVertices[0];
+    pack_positions(count, &vertex.position, sizeof(VertexType), bounds, &packedVertex.position, sizeof(PackedVertexType));
+    if constexpr (requires { vertex.normal; packedVertex.normal; }) {
+        pack_normals(count, &vertex.normal, sizeof(VertexType), &packedVertex.normal, sizeof(PackedVertexType));
+    }
+    if constexpr (requires { vertex.texcoord; packedVertex.texcoord; }) {
+        pack_texcoords(count, &vertex.texcoord, sizeof(VertexType), &packedVertex.texcoord, sizeof(PackedVertexType));
+    }
+    if constexpr (requires { vertex.color; packedVertex.color; }) {
+        pack_colors(count, &vertex.color, sizeof(VertexType), &packedVertex.color, sizeof(PackedVertexType));
+    }
+}
+
+template <typename PackedVertexType, typename VertexType>
+inline void unpack_vertices(std::span<const PackedVertexType> packedVertices, const QuantizationBounds& bounds, std::span<VertexType> vertices)
+{
+    assert(packedVertices.size() <= vertices.size());
+    if (packedVertices.empty()) {
+        return;
+    }
+    auto count = packedVertices.size();
+    const auto& packedVertex = packedVertices[0];
+    auto& vertex = vertices[0];
+    unpack_positions(count, &packedVertex.position, sizeof(PackedVertexType), bounds, &vertex.position, sizeof(VertexType));
+    if constexpr (requires { vertex.normal; packedVertex.normal; }) {
+        unpack_normals(count, &packedVertex.normal, sizeof(PackedVertexType), &vertex.normal, sizeof(VertexType));
+    }
+    if constexpr (requires { vertex.texcoord; packedVertex.texcoord; }) {
+        unpack_texcoords(count, &packedVertex.texcoord, sizeof(PackedVertexType), &vertex.texcoord, sizeof(VertexType));
+    }
+    if constexpr (requires { vertex.color; packedVertex.color; }) {
+        unpack_colors(count, &packedVertex.color, sizeof(PackedVertexType), &vertex.color, sizeof(VertexType));
+    }
+}
+
+} // namespace gfx
+} // namespace dst
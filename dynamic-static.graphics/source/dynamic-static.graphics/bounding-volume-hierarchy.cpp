@@ -0,0 +1,536 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+
+#include "dynamic-static.graphics/bounding-volume-hierarchy.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <tuple>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define DST_BOUNDING_VOLUME_HIERARCHY_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define DST_BOUNDING_VOLUME_HIERARCHY_NEON
+#include <arm_neon.h>
+#endif
+
+namespace dst {
+namespace gfx {
+
+namespace {
+
+// SSE2 and NEON are baseline on the platforms that define them so there's no
+//  runtime dispatch, other platforms use one plane per lane scalar code.
+#if defined(DST_BOUNDING_VOLUME_HIERARCHY_SSE2)
+struct Simd final
+{
+    using Float = __m128;
+    static inline Float load(const float* pData) { return _mm_load_ps(pData); }
+    static inline Float set(float value) { return _mm_set1_ps(value); }
+    static inline Float add(Float lhs, Float rhs) { return _mm_add_ps(lhs, rhs); }
+    static inline Float sub(Float lhs, Float rhs) { return _mm_sub_ps(lhs, rhs); }
+    static inline Float mul(Float lhs, Float rhs) { return _mm_mul_ps(lhs, rhs); }
+    static inline uint32_t get_less_bits(Float lhs, Float rhs) { return (uint32_t)_mm_movemask_ps(_mm_cmplt_ps(lhs, rhs)); }
+};
+#elif defined(DST_BOUNDING_VOLUME_HIERARCHY_NEON)
+struct Simd final
+{
+    using Float = float32x4_t;
+    static inline Float load(const float* pData) { return vld1q_f32(pData); }
+    static inline Float set(float value) { return vdupq_n_f32(value); }
+    static inline Float add(Float lhs, Float rhs) { return vaddq_f32(lhs, rhs); }
+    static inline Float sub(Float lhs, Float rhs) { return vsubq_f32(lhs, rhs); }
+    static inline Float mul(Float lhs, Float rhs) { return vmulq_f32(lhs, rhs); }
+
+    static inline uint32_t get_less_bits(Float lhs, Float rhs)
+    {
+        auto mask = vcltq_f32(lhs, rhs);
+        return
+            (vgetq_lane_u32(mask, 0) & 1) |
+            (vgetq_lane_u32(mask, 1) & 2) |
+            (vgetq_lane_u32(mask, 2) & 4) |
+            (vgetq_lane_u32(mask, 3) & 8);
+    }
+};
+#else
+struct Simd final
+{
+    struct Float final
+    {
+        std::array<float, 4> lanes { };
+    };
+
+    static inline Float load(const float* pData) { return { { pData[0], pData[1], pData[2], pData[3] } }; }
+    static inline Float set(float value) { return { { value, value, value, value } }; }
+
+    template <typename FunctionType>
+    static inline Float apply(Float lhs, Float rhs, FunctionType function)
+    {
+        for (size_t i = 0; i < 4; ++i) {
+            lhs.lanes[i] = function(lhs.lanes[i], rhs.lanes[i]);
+        }
+        return lhs;
+    }
+
+    static inline Float add(Float lhs, Float rhs) { return apply(lhs, rhs, [](float l, float r) { return l + r; }); }
+    static inline Float sub(Float lhs, Float rhs) { return apply(lhs, rhs, [](float l, float r) { return l - r; }); }
+    static inline Float mul(Float lhs, Float rhs) { return apply(lhs, rhs, [](float l, float r) { return l * r; }); }
+
+    static inline uint32_t get_less_bits(Float lhs, Float rhs)
+    {
+        uint32_t bits = 0;
+        for (size_t i = 0; i < 4; ++i) {
+            bits |= (lhs.lanes[i] < rhs.lanes[i] ? 1u : 0u) << i;
+        }
+        return bits;
+    }
+};
+#endif
+
+constexpr uint32_t AllPlanesMask { (1u << Frustum::Plane::Count) - 1 };
+
+inline BoundingVolumeHierarchy::Aabb merge(const BoundingVolumeHierarchy::Aabb& lhs, const BoundingVolumeHierarchy::Aabb& rhs)
+{
+    return { glm::min(lhs.min, rhs.min), glm::max(lhs.max, rhs.max) };
+}
+
+inline bool contains(const BoundingVolumeHierarchy::Aabb& aabb, const BoundingVolumeHierarchy::Aabb& other)
+{
+    return
+        aabb.min.x <= other.min.x && aabb.min.y <= other.min.y && aabb.min.z <= other.min.z &&
+        other.max.x <= aabb.max.x && other.max.y <= aabb.max.y && other.max.z <= aabb.max.z;
+}
+
+inline float get_perimeter(const BoundingVolumeHierarchy::Aabb& aabb)
+{
+    auto extent = aabb.max - aabb.min;
+    return 2.0f * (extent.x + extent.y + extent.z);
+}
+
+} // namespace
+
+void BoundingVolumeHierarchy::create(const CreateInfo* pCreateInfo, BoundingVolumeHierarchy* pBoundingVolumeHierarchy)
+{
+    assert(pCreateInfo);
+    assert(0 <= pCreateInfo->margin);
+    assert(pBoundingVolumeHierarchy);
+    pBoundingVolumeHierarchy->reset();
+    pBoundingVolumeHierarchy->mMargin = pCreateInfo->margin;
+    pBoundingVolumeHierarchy->mNodes.reserve(pCreateInfo->capacity ? pCreateInfo->capacity * 2 - 1 : 0);
+}
+
+uint32_t BoundingVolumeHierarchy::get_proxy_count() const
+{
+    return mProxyCount;
+}
+
+int32_t BoundingVolumeHierarchy::get_height() const
+{
+    return mRoot != InvalidNode ? mNodes[mRoot].height : 0;
+}
+
+BoundingVolumeHierarchy::ProxyId BoundingVolumeHierarchy::create_proxy(const Aabb& aabb, uint32_t index)
+{
+    auto proxyId = allocate_node();
+    auto& node = mNodes[proxyId];
+    node.aabb = { aabb.min - glm::vec3(mMargin), aabb.max + glm::vec3(mMargin) };
+    node.index = index;
+    node.height = 0;
+    insert_leaf(proxyId);
+    ++mProxyCount;
+    return proxyId;
+}
+
+void BoundingVolumeHierarchy::destroy_proxy(ProxyId proxyId)
+{
+    assert(proxyId < mNodes.size());
+    assert(mNodes[proxyId].is_leaf());
+    remove_leaf(proxyId);
+    free_node(proxyId);
+    --mProxyCount;
+}
+
+bool BoundingVolumeHierarchy::update_proxy(ProxyId proxyId, const Aabb& aabb)
+{
+    assert(proxyId < mNodes.size());
+    assert(mNodes[proxyId].is_leaf());
+    if (contains(mNodes[proxyId].aabb, aabb)) {
+        return false;
+    }
+    remove_leaf(proxyId);
+    mNodes[proxyId].aabb = { aabb.min - glm::vec3(mMargin), aabb.max + glm::vec3(mMargin) };
+    insert_leaf(proxyId);
+    return true;
+}
+
+const BoundingVolumeHierarchy::Aabb& BoundingVolumeHierarchy::get_aabb(ProxyId proxyId) const
+{
+    assert(proxyId < mNodes.size());
+    assert(mNodes[proxyId].is_leaf());
+    return mNodes[proxyId].aabb;
+}
+
+uint32_t BoundingVolumeHierarchy::get_index(ProxyId proxyId) const
+{
+    assert(proxyId < mNodes.size());
+    assert(mNodes[proxyId].is_leaf());
+    return mNodes[proxyId].index;
+}
+
+void BoundingVolumeHierarchy::cull(const Frustum& frustum, std::vector<uint32_t>* pIndices)
+{
+    assert(pIndices);
+    pIndices->clear();
+    if (mRoot != InvalidNode) {
+        cull_subtree(create_cull_planes(frustum), mRoot, AllPlanesMask, pIndices);
+    }
+}
+
+void BoundingVolumeHierarchy::cull(const Frustum& frustum, JobSystem& jobSystem, std::vector<uint32_t>* pIndices)
+{
+    assert(pIndices);
+    pIndices->clear();
+    if (mRoot == InvalidNode) {
+        return;
+    }
+
+    // Cull the top of the tree breadth first on the calling thread until there
+    //  are a few subtrees per thread, then cull the subtrees in parallel.  Each
+    //  subtree writes its own index list and touches only its own nodes.
+    auto cullPlanes = create_cull_planes(frustum);
+    auto subtreeCount = (size_t)jobSystem.get_thread_count() * 4;
+    mSubtrees.clear();
+    mSubtrees.push_back({ mRoot, AllPlanesMask });
+    while (!mSubtrees.empty() && mSubtrees.size() < subtreeCount) {
+        mScratchSubtrees.clear();
+        for (auto [node, planeMask] : mSubtrees) {
+            planeMask = planeMask ? classify(cullPlanes, node, planeMask) : planeMask;
+            if (planeMask != OutsideMask) {
+                if (mNodes[node].is_leaf()) {
+                    pIndices->push_back(mNodes[node].index);
+                } else {
+                    mScratchSubtrees.push_back({ mNodes[node].children[0], planeMask });
+                    mScratchSubtrees.push_back({ mNodes[node].children[1], planeMask });
+                }
+            }
+        }
+        std::swap(mSubtrees, mScratchSubtrees);
+    }
+    if (mSubtreeIndices.size() < mSubtrees.size()) {
+        mSubtreeIndices.resize(mSubtrees.size());
+    }
+    jobSystem.parallel_for(mSubtrees.size(), 1,
+        [&](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i) {
+                mSubtreeIndices[i].clear();
+                cull_subtree(cullPlanes, mSubtrees[i].first, mSubtrees[i].second, &mSubtreeIndices[i]);
+            }
+        }
+    );
+    for (size_t i = 0; i < mSubtrees.size(); ++i) {
+        pIndices->insert(pIndices->end(), mSubtreeIndices[i].begin(), mSubtreeIndices[i].end());
+    }
+}
+
+void BoundingVolumeHierarchy::reset()
+{
+    mMargin = 0;
+    mNodes.clear();
+    mFreeNodes.clear();
+    mRoot = InvalidNode;
+    mProxyCount = 0;
+    mSubtrees.clear();
+    mScratchSubtrees.clear();
+    mSubtreeIndices.clear();
+}
+
+BoundingVolumeHierarchy::CullPlanes BoundingVolumeHierarchy::create_cull_planes(const Frustum& frustum)
+{
+    CullPlanes cullPlanes { };
+    cullPlanes.w.fill(1);
+    for (size_t i = 0; i < frustum.planes.size(); ++i) {
+        const auto& plane = frustum.planes[i];
+        cullPlanes.x[i] = plane.x;
+        cullPlanes.y[i] = plane.y;
+        cullPlanes.z[i] = plane.z;
+        cullPlanes.w[i] = plane.w;
+        cullPlanes.absX[i] = std::abs(plane.x);
+        cullPlanes.absY[i] = std::abs(plane.y);
+        cullPlanes.absZ[i] = std::abs(plane.z);
+    }
+    return cullPlanes;
+}
+
+uint32_t BoundingVolumeHierarchy::classify(const CullPlanes& cullPlanes, uint32_t node, uint32_t planeMask)
+{
+    // With the AABB as center c and extents e, and a plane as normal n and
+    //  distance w, the AABB is outside the plane when dot(n, c) + w < -dot(|n|, e)
+    //  and inside when dot(n, c) + w >= dot(|n|, e).
+    auto& aabb = mNodes[node].aabb;
+    auto center = (aabb.min + aabb.max) * 0.5f;
+    auto extents = (aabb.max - aabb.min) * 0.5f;
+
+    // Test the plane that last rejected this node first, a node that was outside
+    //  last frame is usually still outside the same plane.
+    auto plane_i = mNodes[node].lastRejectedPlane;
+    if (planeMask & (1u << plane_i)) {
+        auto distance = cullPlanes.x[plane_i] * center.x + cullPlanes.y[plane_i] * center.y + cullPlanes.z[plane_i] * center.z + cullPlanes.w[plane_i];
+        auto radius = cullPlanes.absX[plane_i] * extents.x + cullPlanes.absY[plane_i] * extents.y + cullPlanes.absZ[plane_i] * extents.z;
+        if (distance + radius < 0) {
+            return OutsideMask;
+        }
+    }
+
+    // Test 4 planes per instruction.
+    auto centerX = Simd::set(center.x);
+    auto centerY = Simd::set(center.y);
+    auto centerZ = Simd::set(center.z);
+    auto extentsX = Simd::set(extents.x);
+    auto extentsY = Simd::set(extents.y);
+    auto extentsZ = Simd::set(extents.z);
+    auto zero = Simd::set(0);
+    uint32_t outsideBits = 0;
+    uint32_t intersectingBits = 0;
+    for (uint32_t i = 0; i < 8; i += 4) {
+        auto distance = Simd::add(
+            Simd::add(Simd::mul(Simd::load(&cullPlanes.x[i]), centerX), Simd::mul(Simd::load(&cullPlanes.y[i]), centerY)),
+            Simd::add(Simd::mul(Simd::load(&cullPlanes.z[i]), centerZ), Simd::load(&cullPlanes.w[i]))
+        );
+        auto radius = Simd::add(
+            Simd::add(Simd::mul(Simd::load(&cullPlanes.absX[i]), extentsX), Simd::mul(Simd::load(&cullPlanes.absY[i]), extentsY)),
+            Simd::mul(Simd::load(&cullPlanes.absZ[i]), extentsZ)
+        );
+        outsideBits |= Simd::get_less_bits(Simd::add(distance, radius), zero) << i;
+        intersectingBits |= Simd::get_less_bits(Simd::sub(distance, radius), zero) << i;
+    }
+    outsideBits &= planeMask;
+    if (outsideBits) {
+        mNodes[node].lastRejectedPlane = (uint32_t)std::countr_zero(outsideBits);
+        return OutsideMask;
+    }
+    return planeMask & intersectingBits;
+}
+
+void BoundingVolumeHierarchy::cull_subtree(const CullPlanes& cullPlanes, uint32_t node, uint32_t planeMask, std::vector<uint32_t>* pIndices)
+{
+    // Once a node is inside every plane its descendants are accepted untested.
+    //  Rotations keep the tree's height far below the fixed stack's capacity, if
+    //  the fixed stack does fill, nodes spill into overflowStack which is drained
+    //  first so traversal order is unchanged.
+    assert(pIndices);
+    std::array<std::pair<uint32_t, uint32_t>, 64> stack;
+    std::vector<std::pair<uint32_t, uint32_t>> overflowStack;
+    size_t stackSize = 0;
+    auto push = [&](uint32_t pushNode, uint32_t pushPlaneMask)
+    {
+        if (stackSize < stack.size()) {
+            stack[stackSize++] = { pushNode, pushPlaneMask };
+        } else {
+            overflowStack.push_back({ pushNode, pushPlaneMask });
+        }
+    };
+    push(node, planeMask);
+    while (stackSize) {
+        if (!overflowStack.empty()) {
+            std::tie(node, planeMask) = overflowStack.back();
+            overflowStack.pop_back();
+        } else {
+            std::tie(node, planeMask) = stack[--stackSize];
+        }
+        if (planeMask) {
+            planeMask = classify(cullPlanes, node, planeMask);
+            if (planeMask == OutsideMask) {
+                continue;
+            }
+        }
+        const auto& currentNode = mNodes[node];
+        if (currentNode.is_leaf()) {
+            pIndices->push_back(currentNode.index);
+        } else {
+            push(currentNode.children[1], planeMask);
+            push(currentNode.children[0], planeMask);
+        }
+    }
+}
+
+uint32_t BoundingVolumeHierarchy::allocate_node()
+{
+    uint32_t node = InvalidNode;
+    if (!mFreeNodes.empty()) {
+        node = mFreeNodes.back();
+        mFreeNodes.pop_back();
+    } else {
+        node = (uint32_t)mNodes.size();
+        mNodes.emplace_back();
+    }
+    mNodes[node] = { };
+    return node;
+}
+
+void BoundingVolumeHierarchy::free_node(uint32_t node)
+{
+    assert(node < mNodes.size());
+    mNodes[node] = { };
+    mFreeNodes.push_back(node);
+}
+
+void BoundingVolumeHierarchy::insert_leaf(uint32_t leaf)
+{
+    if (mRoot == InvalidNode) {
+        mRoot = leaf;
+        mNodes[leaf].parent = InvalidNode;
+        return;
+    }
+
+    // Find the best sibling for leaf by descending toward the child whose
+    //  perimeter grows least, stopping when pairing with the current node is
+    //  cheaper than descending.
+    auto leafAabb = mNodes[leaf].aabb;
+    auto sibling = mRoot;
+    while (!mNodes[sibling].is_leaf()) {
+        const auto& node = mNodes[sibling];
+        auto perimeter = get_perimeter(node.aabb);
+        auto mergedPerimeter = get_perimeter(merge(node.aabb, leafAabb));
+        auto cost = 2.0f * mergedPerimeter;
+        auto inheritanceCost = 2.0f * (mergedPerimeter - perimeter);
+        std::array<float, 2> childCosts { };
+        for (size_t i = 0; i < 2; ++i) {
+            const auto& child = mNodes[node.children[i]];
+            childCosts[i] = get_perimeter(merge(child.aabb, leafAabb)) + inheritanceCost;
+            if (!child.is_leaf()) {
+                childCosts[i] -= get_perimeter(child.aabb);
+            }
+        }
+        if (cost < childCosts[0] && cost < childCosts[1]) {
+            break;
+        }
+        sibling = node.children[childCosts[0] < childCosts[1] ? 0 : 1];
+    }
+
+    // Create a new parent for leaf and sibling.
+    auto oldParent = mNodes[sibling].parent;
+    auto newParent = allocate_node();
+    mNodes[newParent].parent = oldParent;
+    mNodes[newParent].aabb = merge(leafAabb, mNodes[sibling].aabb);
+    mNodes[newParent].height = mNodes[sibling].height + 1;
+    mNodes[newParent].children = { sibling, leaf };
+    mNodes[sibling].parent = newParent;
+    mNodes[leaf].parent = newParent;
+    if (oldParent != InvalidNode) {
+        auto& children = mNodes[oldParent].children;
+        children[children[0] == sibling ? 0 : 1] = newParent;
+    } else {
+        mRoot = newParent;
+    }
+    refit(newParent);
+}
+
+void BoundingVolumeHierarchy::remove_leaf(uint32_t leaf)
+{
+    if (leaf == mRoot) {
+        mRoot = InvalidNode;
+        return;
+    }
+    auto parent = mNodes[leaf].parent;
+    auto grandParent = mNodes[parent].parent;
+    const auto& parentChildren = mNodes[parent].children;
+    auto sibling = parentChildren[parentChildren[0] == leaf ? 1 : 0];
+    mNodes[sibling].parent = grandParent;
+    if (grandParent != InvalidNode) {
+        auto& children = mNodes[grandParent].children;
+        children[children[0] == parent ? 0 : 1] = sibling;
+        free_node(parent);
+        refit(grandParent);
+    } else {
+        mRoot = sibling;
+        free_node(parent);
+    }
+    mNodes[leaf].parent = InvalidNode;
+}
+
+void BoundingVolumeHierarchy::refit(uint32_t node)
+{
+    // Rebalance and recompute bounds and heights from node to the root.
+    while (node != InvalidNode) {
+        node = balance(node);
+        auto& currentNode = mNodes[node];
+        const auto& child0 = mNodes[currentNode.children[0]];
+        const auto& child1 = mNodes[currentNode.children[1]];
+        currentNode.height = 1 + std::max(child0.height, child1.height);
+        currentNode.aabb = merge(child0.aabb, child1.aabb);
+        node = currentNode.parent;
+    }
+}
+
+uint32_t BoundingVolumeHierarchy::balance(uint32_t a)
+{
+    // If one child of a is more than one level taller than the other, rotate the
+    //  taller child up into a's place and move its taller child down under a.
+    //  Returns the node now in a's place.
+    if (mNodes[a].is_leaf() || mNodes[a].height < 2) {
+        return a;
+    }
+    auto heightDifference = mNodes[mNodes[a].children[1]].height - mNodes[mNodes[a].children[0]].height;
+    if (-1 <= heightDifference && heightDifference <= 1) {
+        return a;
+    }
+    auto tallIndex = 1 < heightDifference ? 1 : 0;
+    auto shortIndex = 1 - tallIndex;
+    auto b = mNodes[a].children[tallIndex];
+    auto c = mNodes[a].children[shortIndex];
+    auto d = mNodes[b].children[0];
+    auto e = mNodes[b].children[1];
+
+    // b replaces a.
+    mNodes[b].parent = mNodes[a].parent;
+    mNodes[a].parent = b;
+    if (mNodes[b].parent != InvalidNode) {
+        auto& children = mNodes[mNodes[b].parent].children;
+        children[children[0] == a ? 0 : 1] = b;
+    } else {
+        mRoot = b;
+    }
+
+    // a takes b's shorter child, b keeps its taller child and adopts a.
+    auto keep = mNodes[e].height < mNodes[d].height ? d : e;
+    auto move = keep == d ? e : d;
+    mNodes[b].children = { a, keep };
+    mNodes[a].children[tallIndex] = move;
+    mNodes[move].parent = a;
+    mNodes[a].aabb = merge(mNodes[c].aabb, mNodes[move].aabb);
+    mNodes[a].height = 1 + std::max(mNodes[c].height, mNodes[move].height);
+    mNodes[b].aabb = merge(mNodes[a].aabb, mNodes[keep].aabb);
+    mNodes[b].height = 1 + std::max(mNodes[a].height, mNodes[keep].height);
+    return b;
+}
+
+} // namespace gfx
+} // namespace dst
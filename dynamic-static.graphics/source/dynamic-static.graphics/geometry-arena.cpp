@@ -0,0 +1,247 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+
+#include "dynamic-static.graphics/geometry-arena.hpp"
+
+namespace dst {
+namespace gfx {
+
+VkResult GeometryArena::create(const gvk::Device& device, const CreateInfo* pCreateInfo, GeometryArena* pGeometryArena)
+{
+    assert(device);
+    assert(pCreateInfo);
+    assert(pCreateInfo->vertexSize);
+    assert(pCreateInfo->vertexCapacity);
+    assert(pCreateInfo->indexCapacity);
+    assert(pCreateInfo->indexType == VK_INDEX_TYPE_UINT16 || pCreateInfo->indexType == VK_INDEX_TYPE_UINT32);
+    assert(pGeometryArena);
+    pGeometryArena->reset();
+    gvk_result_scope_begin(VK_ERROR_INITIALIZATION_FAILED) {
+        pGeometryArena->mDevice = device;
+        pGeometryArena->mVertexSize = pCreateInfo->vertexSize;
+        pGeometryArena->mIndexType = pCreateInfo->indexType;
+        TlsfAllocator::CreateInfo tlsfAllocatorCreateInfo { };
+        tlsfAllocatorCreateInfo.size = pCreateInfo->vertexCapacity;
+        TlsfAllocator::create(&tlsfAllocatorCreateInfo, &pGeometryArena->mVertexAllocator);
+        tlsfAllocatorCreateInfo.size = pCreateInfo->indexCapacity;
+        TlsfAllocator::create(&tlsfAllocatorCreateInfo, &pGeometryArena->mIndexAllocator);
+        gvk_result(pGeometryArena->create_buffers(&pGeometryArena->mVertexBuffer, &pGeometryArena->mIndexBuffer));
+    } gvk_result_scope_end;
+    if (gvkResult != VK_SUCCESS) {
+        pGeometryArena->reset();
+    }
+    return gvkResult;
+}
+
+const gvk::Buffer& GeometryArena::get_vertex_buffer() const
+{
+    return mVertexBuffer;
+}
+
+const gvk::Buffer& GeometryArena::get_index_buffer() const
+{
+    return mIndexBuffer;
+}
+
+VkIndexType GeometryArena::get_index_type() const
+{
+    return mIndexType;
+}
+
+const TlsfAllocator& GeometryArena::get_vertex_allocator() const
+{
+    return mVertexAllocator;
+}
+
+const TlsfAllocator& GeometryArena::get_index_allocator() const
+{
+    return mIndexAllocator;
+}
+
+void GeometryArena::free(const Mesh& mesh)
+{
+    assert(mDevice);
+    if (mesh.vertices != TlsfAllocator::InvalidHandle) {
+        mVertexAllocator.free(mesh.vertices);
+    }
+    if (mesh.indices != TlsfAllocator::InvalidHandle) {
+        mIndexAllocator.free(mesh.indices);
+    }
+}
+
+uint32_t GeometryArena::get_first_index(const Mesh& mesh) const
+{
+    return (uint32_t)mIndexAllocator.get_offset(mesh.indices);
+}
+
+int32_t GeometryArena::get_vertex_offset(const Mesh& mesh) const
+{
+    return (int32_t)mVertexAllocator.get_offset(mesh.vertices);
+}
+
+void GeometryArena::record_bind_cmds(VkCommandBuffer commandBuffer) const
+{
+    assert(mDevice);
+    VkDeviceSize offset = 0;
+    vkCmdBindVertexBuffers(commandBuffer, 0, 1, &mVertexBuffer.get<const VkBuffer&>(), &offset);
+    vkCmdBindIndexBuffer(commandBuffer, mIndexBuffer, 0, mIndexType);
+}
+
+void GeometryArena::record_draw_cmds(VkCommandBuffer commandBuffer, const Mesh& mesh, uint32_t instanceCount, uint32_t firstInstance) const
+{
+    assert(mDevice);
+    vkCmdDrawIndexed(commandBuffer, mesh.indexCount, instanceCount, get_first_index(mesh), get_vertex_offset(mesh), firstInstance);
+}
+
+VkResult GeometryArena::defragment(VkCommandBuffer commandBuffer, std::vector<gvk::Buffer>* pRetiredBuffers)
+{
+    assert(mDevice);
+    assert(commandBuffer);
+    assert(pRetiredBuffers);
+    if (mVertexAllocator.get_free_block_count() <= 1 && mIndexAllocator.get_free_block_count() <= 1) {
+        return VK_SUCCESS;
+    }
+    gvk_result_scope_begin(VK_ERROR_INITIALIZATION_FAILED) {
+        // vkCmdCopyBuffer() regions within one buffer must not overlap and a
+        //  packed range usually overlaps its old location, so live ranges are
+        //  copied into new buffers instead of being moved in place.
+        gvk::Buffer vertexBuffer;
+        gvk::Buffer indexBuffer;
+        gvk_result(create_buffers(&vertexBuffer, &indexBuffer));
+        std::vector<TlsfAllocator::Move> moves;
+        std::vector<VkBufferCopy> regions;
+        mVertexAllocator.defragment(&moves);
+        detail::get_defragment_regions(moves, mVertexAllocator.get_used_size(), mVertexSize, &regions);
+        if (!regions.empty()) {
+            vkCmdCopyBuffer(commandBuffer, mVertexBuffer, vertexBuffer, (uint32_t)regions.size(), regions.data());
+        }
+        moves.clear();
+        regions.clear();
+        mIndexAllocator.defragment(&moves);
+        detail::get_defragment_regions(moves, mIndexAllocator.get_used_size(), get_index_size(), &regions);
+        if (!regions.empty()) {
+            vkCmdCopyBuffer(commandBuffer, mIndexBuffer, indexBuffer, (uint32_t)regions.size(), regions.data());
+        }
+
+        // Make the copies visible to vertex input and to later uploads.
+        auto memoryBarrier = gvk::get_default<VkMemoryBarrier>();
+        memoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        memoryBarrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &memoryBarrier, 0, nullptr, 0, nullptr);
+        pRetiredBuffers->push_back(mVertexBuffer);
+        pRetiredBuffers->push_back(mIndexBuffer);
+        mVertexBuffer = vertexBuffer;
+        mIndexBuffer = indexBuffer;
+    } gvk_result_scope_end;
+    return gvkResult;
+}
+
+void GeometryArena::reset()
+{
+    mDevice = gvk::Device();
+    mVertexSize = 0;
+    mIndexType = VK_INDEX_TYPE_UINT32;
+    mVertexBuffer = gvk::Buffer();
+    mIndexBuffer = gvk::Buffer();
+    mVertexAllocator.reset();
+    mIndexAllocator.reset();
+    mPendingFrees.clear();
+}
+
+VkResult GeometryArena::write(UploadBatcher& uploadBatcher, std::span<const uint8_t> vertexData, uint32_t vertexCount, std::span<const uint8_t> indexData, uint32_t indexCount, Mesh* pMesh, uint64_t* pToken)
+{
+    assert(mDevice);
+    assert(vertexCount);
+    assert(indexCount);
+    assert(pMesh);
+    *pMesh = { };
+
+    // Free ranges left by failed writes once the copies recorded into them have
+    //  completed.
+    std::erase_if(mPendingFrees,
+        [&](const PendingFree& pendingFree)
+        {
+            auto complete = uploadBatcher.is_complete(pendingFree.token);
+            if (complete) {
+                free(pendingFree.mesh);
+            }
+            return complete;
+        }
+    );
+
+    // Both ranges are allocated before any upload is recorded so running out of
+    //  space never leaves a copy pending.  If recording an upload fails after
+    //  that, part of the Mesh may already be recorded into the current batch so
+    //  its ranges are held until that batch completes.
+    Mesh mesh { };
+    mesh.vertices = mVertexAllocator.allocate(vertexCount);
+    mesh.indices = mIndexAllocator.allocate(indexCount);
+    if (mesh.vertices == TlsfAllocator::InvalidHandle || mesh.indices == TlsfAllocator::InvalidHandle) {
+        free(mesh);
+        return VK_ERROR_OUT_OF_DEVICE_MEMORY;
+    }
+    mesh.vertexCount = vertexCount;
+    mesh.indexCount = indexCount;
+    gvk_result_scope_begin(VK_ERROR_INITIALIZATION_FAILED) {
+        gvk_result(uploadBatcher.write(mVertexBuffer, detail::get_buffer_offset(mVertexAllocator, mesh.vertices, mVertexSize), vertexData, pToken));
+        gvk_result(uploadBatcher.write(mIndexBuffer, detail::get_buffer_offset(mIndexAllocator, mesh.indices, get_index_size()), indexData, pToken));
+    } gvk_result_scope_end;
+    if (gvkResult == VK_SUCCESS) {
+        *pMesh = mesh;
+    } else {
+        mPendingFrees.push_back({ mesh, uploadBatcher.get_token() });
+    }
+    return gvkResult;
+}
+
+VkResult GeometryArena::create_buffers(gvk::Buffer* pVertexBuffer, gvk::Buffer* pIndexBuffer) const
+{
+    assert(pVertexBuffer);
+    assert(pIndexBuffer);
+    gvk_result_scope_begin(VK_ERROR_INITIALIZATION_FAILED) {
+        // Buffers are transfer sources as well as destinations so defragment()
+        //  can copy out of them.
+        auto bufferCreateInfo = gvk::get_default<VkBufferCreateInfo>();
+        bufferCreateInfo.size = mVertexAllocator.get_size() * mVertexSize;
+        bufferCreateInfo.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+        VmaAllocationCreateInfo vmaAllocationCreateInfo { };
+        vmaAllocationCreateInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+        gvk_result(gvk::Buffer::create(mDevice, &bufferCreateInfo, &vmaAllocationCreateInfo, pVertexBuffer));
+        bufferCreateInfo.size = mIndexAllocator.get_size() * get_index_size();
+        bufferCreateInfo.usage = VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+        gvk_result(gvk::Buffer::create(mDevice, &bufferCreateInfo, &vmaAllocationCreateInfo, pIndexBuffer));
+    } gvk_result_scope_end;
+    return gvkResult;
+}
+
+uint32_t GeometryArena::get_index_size() const
+{
+    return mIndexType == VK_INDEX_TYPE_UINT16 ? (uint32_t)sizeof(uint16_t) : (uint32_t)sizeof(uint32_t);
+}
+
+} // namespace gfx
+} // namespace dst
@@ -0,0 +1,305 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#pragma once
+
+#include "dynamic-static/batch-math.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Triangle kernels shared by every instruction set, see batch-math-kernels.hpp
+//  in dynamic-static.core for the Isa type each translation unit provides.  This
+//  header additionally requires Isa::div(), Isa::sqrt(), Isa::mask_and() and
+//  Isa::select(mask, lhs, rhs) returning lhs where mask is set and rhs
+//  elsewhere.  The same restriction applies, translation units compiled with
+//  instruction set specific flags must not instantiate standard library or glm
+//  templates.
+// Streams are SoA and corner major, ie. a triangle's positions are read from
+//  x0, y0, z0, x1, y1, z1, x2, y2, z2.
+
+namespace dst {
+namespace gfx {
+namespace detail {
+
+struct MeshProcessingKernels final
+{
+    batch::InstructionSet instructionSet { batch::InstructionSet::Scalar };
+
+    // Writes the unnormalized face normal of each counter clockwise triangle.
+    void (*pfnComputeFaceNormals)(size_t count, const float* const (&ppPositions)[9], float* const (&ppNormals)[3]) { nullptr };
+
+    // Writes each triangle's unit face normal scaled by the angle of each of its
+    //  corners, degenerate triangles write zero.
+    void (*pfnComputeCornerNormals)(size_t count, const float* const (&ppPositions)[9], float* const (&ppNormals)[9]) { nullptr };
+
+    // Reads positions, texcoords and vertex normals for each corner and writes
+    //  each corner's angle weighted unit tangent then bitangent projected onto
+    //  the plane of its normal, see compute_tangents().
+    void (*pfnComputeCornerTangents)(size_t count, const float* const (&ppInputs)[24], float* const (&ppOutputs)[18]) { nullptr };
+
+    // Normalizes vectors in place, zero length vectors stay zero.
+    void (*pfnNormalize)(size_t count, float* const (&ppVectors)[3]) { nullptr };
+};
+
+// Each returns nullptr when its instruction set isn't available on the target
+//  architecture.
+const MeshProcessingKernels* get_scalar_mesh_processing_kernels();
+const MeshProcessingKernels* get_sse2_mesh_processing_kernels();
+const MeshProcessingKernels* get_avx2_mesh_processing_kernels();
+
+template <typename Isa, size_t InputCount, size_t OutputCount, typename BlockFunctionType>
+inline void for_each_mesh_processing_block(size_t count, const float* const (&ppInputs)[InputCount], float* const (&ppOutputs)[OutputCount], BlockFunctionType blockFunction)
+{
+    // Matches dst::batch's for_each_block(), every input is loaded before any
+    //  output is stored so outputs may alias inputs.
+    typename Isa::Float inputs[InputCount];
+    typename Isa::Float outputs[OutputCount];
+    size_t i = 0;
+    for (; i + Isa::Width <= count; i += Isa::Width) {
+        for (size_t input_i = 0; input_i < InputCount; ++input_i) {
+            inputs[input_i] = Isa::load(ppInputs[input_i] + i);
+        }
+        blockFunction(inputs, outputs);
+        for (size_t output_i = 0; output_i < OutputCount; ++output_i) {
+            Isa::store(ppOutputs[output_i] + i, outputs[output_i]);
+        }
+    }
+    if (i < count) {
+        auto remaining = count - i;
+        float buffer[Isa::Width] { };
+        for (size_t input_i = 0; input_i < InputCount; ++input_i) {
+            memcpy(buffer, ppInputs[input_i] + i, remaining * sizeof(float));
+            inputs[input_i] = Isa::load(buffer);
+        }
+        blockFunction(inputs, outputs);
+        for (size_t output_i = 0; output_i < OutputCount; ++output_i) {
+            Isa::store(buffer, outputs[output_i]);
+            memcpy(ppOutputs[output_i] + i, buffer, remaining * sizeof(float));
+        }
+    }
+}
+
+template <typename Isa>
+inline typename Isa::Float dot(const typename Isa::Float* pLhs, const typename Isa::Float* pRhs)
+{
+    return Isa::add(Isa::add(Isa::mul(pLhs[0], pRhs[0]), Isa::mul(pLhs[1], pRhs[1])), Isa::mul(pLhs[2], pRhs[2]));
+}
+
+template <typename Isa>
+inline void cross(const typename Isa::Float* pLhs, const typename Isa::Float* pRhs, typename Isa::Float* pResult)
+{
+    pResult[0] = Isa::sub(Isa::mul(pLhs[1], pRhs[2]), Isa::mul(pRhs[1], pLhs[2]));
+    pResult[1] = Isa::sub(Isa::mul(pLhs[2], pRhs[0]), Isa::mul(pRhs[2], pLhs[0]));
+    pResult[2] = Isa::sub(Isa::mul(pLhs[0], pRhs[1]), Isa::mul(pRhs[0], pLhs[1]));
+}
+
+template <typename Isa>
+inline typename Isa::Float arc_cosine(typename Isa::Float value)
+{
+    // acos(x) = sqrt(1 - x) * polynomial(x) for 0 <= x <= 1 with an absolute error
+    //  of at most 2e-8, acos(-x) = pi - acos(x).
+    // FROM : Abramowitz and Stegun - "Handbook of Mathematical Functions" 4.4.46
+    auto x = Isa::abs(value);
+    auto result = Isa::set(-0.0012624911f);
+    result = Isa::add(Isa::mul(result, x), Isa::set(0.0066700901f));
+    result = Isa::add(Isa::mul(result, x), Isa::set(-0.0170881256f));
+    result = Isa::add(Isa::mul(result, x), Isa::set(0.0308918810f));
+    result = Isa::add(Isa::mul(result, x), Isa::set(-0.0501743046f));
+    result = Isa::add(Isa::mul(result, x), Isa::set(0.0889789874f));
+    result = Isa::add(Isa::mul(result, x), Isa::set(-0.2145988016f));
+    result = Isa::add(Isa::mul(result, x), Isa::set(1.5707963050f));
+    result = Isa::mul(result, Isa::sqrt(Isa::sub(Isa::set(1), x)));
+    return Isa::select(Isa::less(value, Isa::set(0)), Isa::sub(Isa::set(3.14159265f), result), result);
+}
+
+template <typename Isa>
+inline typename Isa::Float get_corner_angle(const typename Isa::Float* pEdge0, const typename Isa::Float* pEdge1)
+{
+    auto zero = Isa::set(0);
+    auto lengths = Isa::mul(Isa::sqrt(dot<Isa>(pEdge0, pEdge0)), Isa::sqrt(dot<Isa>(pEdge1, pEdge1)));
+    auto valid = Isa::less(zero, lengths);
+    auto cosine = Isa::div(dot<Isa>(pEdge0, pEdge1), Isa::select(valid, lengths, Isa::set(1)));
+    cosine = Isa::min(Isa::max(cosine, Isa::set(-1)), Isa::set(1));
+    return Isa::select(valid, arc_cosine<Isa>(cosine), zero);
+}
+
+template <typename Isa>
+inline void compute_face_normals(size_t count, const float* const (&ppPositions)[9], float* const (&ppNormals)[3])
+{
+    for_each_mesh_processing_block<Isa>(count, ppPositions, ppNormals,
+        [](const typename Isa::Float* pPositions, typename Isa::Float* pNormals)
+        {
+            typename Isa::Float e01[3];
+            typename Isa::Float e02[3];
+            for (size_t i = 0; i < 3; ++i) {
+                e01[i] = Isa::sub(pPositions[3 + i], pPositions[i]);
+                e02[i] = Isa::sub(pPositions[6 + i], pPositions[i]);
+            }
+            cross<Isa>(e01, e02, pNormals);
+        }
+    );
+}
+
+template <typename Isa>
+inline void compute_corner_normals(size_t count, const float* const (&ppPositions)[9], float* const (&ppNormals)[9])
+{
+    for_each_mesh_processing_block<Isa>(count, ppPositions, ppNormals,
+        [](const typename Isa::Float* pPositions, typename Isa::Float* pNormals)
+        {
+            auto zero = Isa::set(0);
+            typename Isa::Float e01[3];
+            typename Isa::Float e02[3];
+            typename Isa::Float e10[3];
+            typename Isa::Float e12[3];
+            for (size_t i = 0; i < 3; ++i) {
+                e01[i] = Isa::sub(pPositions[3 + i], pPositions[i]);
+                e02[i] = Isa::sub(pPositions[6 + i], pPositions[i]);
+                e10[i] = Isa::sub(zero, e01[i]);
+                e12[i] = Isa::sub(pPositions[6 + i], pPositions[3 + i]);
+            }
+            typename Isa::Float normal[3];
+            cross<Isa>(e01, e02, normal);
+            auto length = Isa::sqrt(dot<Isa>(normal, normal));
+            auto valid = Isa::less(zero, length);
+            auto angle0 = get_corner_angle<Isa>(e01, e02);
+            auto angle1 = get_corner_angle<Isa>(e10, e12);
+            typename Isa::Float weights[3] {
+                Isa::div(angle0, Isa::select(valid, length, Isa::set(1))),
+                Isa::div(angle1, Isa::select(valid, length, Isa::set(1))),
+                Isa::div(Isa::sub(Isa::sub(Isa::set(3.14159265f), angle0), angle1), Isa::select(valid, length, Isa::set(1))),
+            };
+            for (size_t corner_i = 0; corner_i < 3; ++corner_i) {
+                for (size_t i = 0; i < 3; ++i) {
+                    pNormals[corner_i * 3 + i] = Isa::select(valid, Isa::mul(normal[i], weights[corner_i]), zero);
+                }
+            }
+        }
+    );
+}
+
+template <typename Isa>
+inline void compute_corner_tangents(size_t count, const float* const (&ppInputs)[24], float* const (&ppOutputs)[18])
+{
+    for_each_mesh_processing_block<Isa>(count, ppInputs, ppOutputs,
+        [](const typename Isa::Float* pInputs, typename Isa::Float* pOutputs)
+        {
+            const auto* pPositions = pInputs;
+            const auto* pTexcoords = pInputs + 9;
+            const auto* pNormals = pInputs + 15;
+            auto zero = Isa::set(0);
+            typename Isa::Float e1[3];
+            typename Isa::Float e2[3];
+            for (size_t i = 0; i < 3; ++i) {
+                e1[i] = Isa::sub(pPositions[3 + i], pPositions[i]);
+                e2[i] = Isa::sub(pPositions[6 + i], pPositions[i]);
+            }
+            auto st1x = Isa::sub(pTexcoords[2], pTexcoords[0]);
+            auto st1y = Isa::sub(pTexcoords[3], pTexcoords[1]);
+            auto st2x = Isa::sub(pTexcoords[4], pTexcoords[0]);
+            auto st2y = Isa::sub(pTexcoords[5], pTexcoords[1]);
+            auto signedAreaSt = Isa::sub(Isa::mul(st1x, st2y), Isa::mul(st1y, st2x));
+            auto valid = Isa::less(zero, Isa::abs(signedAreaSt));
+            auto sign = Isa::select(Isa::less(signedAreaSt, zero), Isa::set(-1), Isa::set(1));
+            typename Isa::Float tangent[3];
+            typename Isa::Float bitangent[3];
+            for (size_t i = 0; i < 3; ++i) {
+                tangent[i] = Isa::mul(Isa::sub(Isa::mul(e1[i], st2y), Isa::mul(e2[i], st1y)), sign);
+                bitangent[i] = Isa::mul(Isa::sub(Isa::mul(e2[i], st1x), Isa::mul(e1[i], st2x)), sign);
+            }
+            for (size_t corner_i = 0; corner_i < 3; ++corner_i) {
+                const auto* pNormal = pNormals + corner_i * 3;
+                auto project = [&](const typename Isa::Float* pVector, typename Isa::Float* pResult)
+                {
+                    auto d = dot<Isa>(pNormal, pVector);
+                    for (size_t i = 0; i < 3; ++i) {
+                        pResult[i] = Isa::sub(pVector[i], Isa::mul(pNormal[i], d));
+                    }
+                };
+                typename Isa::Float edge0[3];
+                typename Isa::Float edge1[3];
+                for (size_t i = 0; i < 3; ++i) {
+                    edge0[i] = Isa::sub(pPositions[(corner_i + 1) % 3 * 3 + i], pPositions[corner_i * 3 + i]);
+                    edge1[i] = Isa::sub(pPositions[(corner_i + 2) % 3 * 3 + i], pPositions[corner_i * 3 + i]);
+                }
+                typename Isa::Float projectedEdge0[3];
+                typename Isa::Float projectedEdge1[3];
+                project(edge0, projectedEdge0);
+                project(edge1, projectedEdge1);
+                auto angle = get_corner_angle<Isa>(projectedEdge0, projectedEdge1);
+                typename Isa::Float projectedTangent[3];
+                typename Isa::Float projectedBitangent[3];
+                project(tangent, projectedTangent);
+                project(bitangent, projectedBitangent);
+                auto tangentLength = Isa::sqrt(dot<Isa>(projectedTangent, projectedTangent));
+                auto bitangentLength = Isa::sqrt(dot<Isa>(projectedBitangent, projectedBitangent));
+                auto tangentValid = Isa::mask_and(valid, Isa::less(zero, tangentLength));
+                auto bitangentValid = Isa::mask_and(valid, Isa::less(zero, bitangentLength));
+                auto tangentWeight = Isa::div(angle, Isa::select(tangentValid, tangentLength, Isa::set(1)));
+                auto bitangentWeight = Isa::div(angle, Isa::select(bitangentValid, bitangentLength, Isa::set(1)));
+                for (size_t i = 0; i < 3; ++i) {
+                    pOutputs[corner_i * 3 + i] = Isa::select(tangentValid, Isa::mul(projectedTangent[i], tangentWeight), zero);
+                    pOutputs[9 + corner_i * 3 + i] = Isa::select(bitangentValid, Isa::mul(projectedBitangent[i], bitangentWeight), zero);
+                }
+            }
+        }
+    );
+}
+
+template <typename Isa>
+inline void normalize_vectors(size_t count, float* const (&ppVectors)[3])
+{
+    const float* const ppInputs[] { ppVectors[0], ppVectors[1], ppVectors[2] };
+    for_each_mesh_processing_block<Isa>(count, ppInputs, ppVectors,
+        [](const typename Isa::Float* pInputs, typename Isa::Float* pOutputs)
+        {
+            auto zero = Isa::set(0);
+            auto length = Isa::sqrt(dot<Isa>(pInputs, pInputs));
+            auto valid = Isa::less(zero, length);
+            length = Isa::select(valid, length, Isa::set(1));
+            for (size_t i = 0; i < 3; ++i) {
+                pOutputs[i] = Isa::select(valid, Isa::div(pInputs[i], length), zero);
+            }
+        }
+    );
+}
+
+template <typename Isa>
+constexpr MeshProcessingKernels create_mesh_processing_kernels(batch::InstructionSet instructionSet)
+{
+    MeshProcessingKernels kernels { };
+    kernels.instructionSet = instructionSet;
+    kernels.pfnComputeFaceNormals = compute_face_normals<Isa>;
+    kernels.pfnComputeCornerNormals = compute_corner_normals<Isa>;
+    kernels.pfnComputeCornerTangents = compute_corner_tangents<Isa>;
+    kernels.pfnNormalize = normalize_vectors<Isa>;
+    return kernels;
+}
+
+} // namespace detail
+} // namespace gfx
+} // namespace dst
@@ -0,0 +1,154 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#include "dynamic-static.graphics/mesh-processing.hpp"
+#include "mesh-processing-kernels.hpp"
+
+#include <cassert>
+#include <cmath>
+
+namespace dst {
+namespace gfx {
+namespace detail {
+namespace {
+
+struct Scalar final
+{
+    using Float = float;
+    using Mask = bool;
+    static constexpr size_t Width = 1;
+    static inline Float load(const float* pData) { return *pData; }
+    static inline void store(float* pData, Float value) { *pData = value; }
+    static inline Float set(float value) { return value; }
+    static inline Float add(Float lhs, Float rhs) { return lhs + rhs; }
+    static inline Float sub(Float lhs, Float rhs) { return lhs - rhs; }
+    static inline Float mul(Float lhs, Float rhs) { return lhs * rhs; }
+    static inline Float div(Float lhs, Float rhs) { return lhs / rhs; }
+    static inline Float sqrt(Float value) { return std::sqrt(value); }
+    static inline Float min(Float lhs, Float rhs) { return lhs < rhs ? lhs : rhs; }
+    static inline Float max(Float lhs, Float rhs) { return lhs > rhs ? lhs : rhs; }
+    static inline Float abs(Float value) { return std::fabs(value); }
+    static inline Mask less(Float lhs, Float rhs) { return lhs < rhs; }
+    static inline Mask mask_and(Mask lhs, Mask rhs) { return lhs && rhs; }
+    static inline Float select(Mask mask, Float lhs, Float rhs) { return mask ? lhs : rhs; }
+};
+
+constexpr MeshProcessingKernels ScalarMeshProcessingKernels = create_mesh_processing_kernels<Scalar>(batch::InstructionSet::Scalar);
+
+// Follows dst::batch, instruction sets without mesh processing kernels fall
+//  back to the next narrowest.
+const MeshProcessingKernels& get_kernels()
+{
+    auto instructionSet = batch::get_instruction_set();
+    const MeshProcessingKernels* pKernels = nullptr;
+    if (instructionSet == batch::InstructionSet::Avx2) {
+        pKernels = get_avx2_mesh_processing_kernels();
+    }
+    if (!pKernels && (instructionSet == batch::InstructionSet::Avx2 || instructionSet == batch::InstructionSet::Sse2)) {
+        pKernels = get_sse2_mesh_processing_kernels();
+    }
+    return pKernels ? *pKernels : *get_scalar_mesh_processing_kernels();
+}
+
+} // namespace
+
+const MeshProcessingKernels* get_scalar_mesh_processing_kernels()
+{
+    return &ScalarMeshProcessingKernels;
+}
+
+void compute_face_normal_block(size_t count, const Vec3Block (&positions)[3], Vec3Block* pNormals)
+{
+    assert(count <= MeshProcessingBlockSize);
+    assert(pNormals);
+    const float* const ppPositions[] {
+        positions[0].x, positions[0].y, positions[0].z,
+        positions[1].x, positions[1].y, positions[1].z,
+        positions[2].x, positions[2].y, positions[2].z,
+    };
+    float* const ppNormals[] { pNormals->x, pNormals->y, pNormals->z };
+    get_kernels().pfnComputeFaceNormals(count, ppPositions, ppNormals);
+}
+
+void compute_corner_normal_block(size_t count, const Vec3Block (&positions)[3], Vec3Block (&normals)[3])
+{
+    assert(count <= MeshProcessingBlockSize);
+    const float* const ppPositions[] {
+        positions[0].x, positions[0].y, positions[0].z,
+        positions[1].x, positions[1].y, positions[1].z,
+        positions[2].x, positions[2].y, positions[2].z,
+    };
+    float* const ppNormals[] {
+        normals[0].x, normals[0].y, normals[0].z,
+        normals[1].x, normals[1].y, normals[1].z,
+        normals[2].x, normals[2].y, normals[2].z,
+    };
+    get_kernels().pfnComputeCornerNormals(count, ppPositions, ppNormals);
+}
+
+void compute_corner_tangent_block(
+    size_t count,
+    const Vec3Block (&positions)[3],
+    const Vec2Block (&texcoords)[3],
+    const Vec3Block (&normals)[3],
+    Vec3Block (&tangents)[3],
+    Vec3Block (&bitangents)[3]
+)
+{
+    assert(count <= MeshProcessingBlockSize);
+    const float* const ppInputs[] {
+        positions[0].x, positions[0].y, positions[0].z,
+        positions[1].x, positions[1].y, positions[1].z,
+        positions[2].x, positions[2].y, positions[2].z,
+        texcoords[0].x, texcoords[0].y,
+        texcoords[1].x, texcoords[1].y,
+        texcoords[2].x, texcoords[2].y,
+        normals[0].x, normals[0].y, normals[0].z,
+        normals[1].x, normals[1].y, normals[1].z,
+        normals[2].x, normals[2].y, normals[2].z,
+    };
+    float* const ppOutputs[] {
+        tangents[0].x, tangents[0].y, tangents[0].z,
+        tangents[1].x, tangents[1].y, tangents[1].z,
+        tangents[2].x, tangents[2].y, tangents[2].z,
+        bitangents[0].x, bitangents[0].y, bitangents[0].z,
+        bitangents[1].x, bitangents[1].y, bitangents[1].z,
+        bitangents[2].x, bitangents[2].y, bitangents[2].z,
+    };
+    get_kernels().pfnComputeCornerTangents(count, ppInputs, ppOutputs);
+}
+
+void normalize_block(size_t count, Vec3Block* pVectors)
+{
+    assert(count <= MeshProcessingBlockSize);
+    assert(pVectors);
+    float* const ppVectors[] { pVectors->x, pVectors->y, pVectors->z };
+    get_kernels().pfnNormalize(count, ppVectors);
+}
+
+} // namespace detail
+} // namespace gfx
+} // namespace dst
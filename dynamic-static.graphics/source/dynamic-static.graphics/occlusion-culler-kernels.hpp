@@ -0,0 +1,179 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+
+#pragma once
+
+#include "dynamic-static/batch-math.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+// Tile kernels shared by every instruction set, see batch-math-kernels.hpp in
+//  dynamic-static.core for the Isa type each translation unit provides.  This
+//  header additionally requires Isa::select(mask, lhs, rhs) returning lhs where
+//  mask is set and rhs elsewhere.  The same restriction applies, translation
+//  units compiled with instruction set specific flags must not instantiate
+//  standard library or glm templates.
+
+namespace dst {
+namespace gfx {
+namespace detail {
+
+static constexpr int32_t OcclusionTileWidth { 16 };
+static constexpr int32_t OcclusionTileHeight { 8 };
+
+// A screen space triangle.  Edge functions and depth are planes evaluated as
+//  a * x + (b * y + c) at pixel centers, a pixel is covered when no edge
+//  function is negative.  The bounds are inclusive pixel coordinates clamped
+//  to the depth buffer.
+struct OcclusionTriangle final
+{
+    float edgeA[3] { };
+    float edgeB[3] { };
+    float edgeC[3] { };
+    float depthA { 0 };
+    float depthB { 0 };
+    float depthC { 0 };
+    int32_t minX { 0 };
+    int32_t minY { 0 };
+    int32_t maxX { 0 };
+    int32_t maxY { 0 };
+};
+
+struct OcclusionKernels final
+{
+    batch::InstructionSet instructionSet { batch::InstructionSet::Scalar };
+
+    // Rasterizes the binned triangles into the tile at (tileX, tileY), keeping
+    //  the nearest depth per pixel, and returns the tile's farthest depth.
+    float (*pfnRasterizeTile)(const OcclusionTriangle* pTriangles, const uint32_t* pTriangleIndices, size_t triangleCount, int32_t tileX, int32_t tileY, int32_t stride, float* pDepths) { nullptr };
+
+    // Returns true if any pixel in the inclusive rectangle has a depth at or
+    //  beyond depth.
+    bool (*pfnTestRect)(const float* pDepths, int32_t stride, int32_t minX, int32_t minY, int32_t maxX, int32_t maxY, float depth) { nullptr };
+};
+
+// Each returns nullptr when its instruction set isn't available on the target
+//  architecture.
+const OcclusionKernels* get_scalar_occlusion_kernels();
+const OcclusionKernels* get_sse2_occlusion_kernels();
+const OcclusionKernels* get_avx2_occlusion_kernels();
+
+alignas(32) static constexpr float OcclusionLaneOffsets[8] { 0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f };
+
+template <typename Isa>
+inline float rasterize_tile(const OcclusionTriangle* pTriangles, const uint32_t* pTriangleIndices, size_t triangleCount, int32_t tileX, int32_t tileY, int32_t stride, float* pDepths)
+{
+    static_assert(OcclusionTileWidth % Isa::Width == 0);
+    auto zero = Isa::set(0);
+    auto laneOffsets = Isa::load(OcclusionLaneOffsets);
+    for (size_t triangle_i = 0; triangle_i < triangleCount; ++triangle_i) {
+        const auto& triangle = pTriangles[pTriangleIndices[triangle_i]];
+        auto minX = triangle.minX < tileX ? tileX : triangle.minX;
+        auto minY = triangle.minY < tileY ? tileY : triangle.minY;
+        auto maxX = tileX + OcclusionTileWidth - 1 < triangle.maxX ? tileX + OcclusionTileWidth - 1 : triangle.maxX;
+        auto maxY = tileY + OcclusionTileHeight - 1 < triangle.maxY ? tileY + OcclusionTileHeight - 1 : triangle.maxY;
+        auto firstX = tileX + (minX - tileX) / (int32_t)Isa::Width * (int32_t)Isa::Width;
+        auto edgeA0 = Isa::set(triangle.edgeA[0]);
+        auto edgeA1 = Isa::set(triangle.edgeA[1]);
+        auto edgeA2 = Isa::set(triangle.edgeA[2]);
+        auto depthA = Isa::set(triangle.depthA);
+        for (auto y = minY; y <= maxY; ++y) {
+            auto pixelY = (float)y + 0.5f;
+            auto row0 = Isa::set(triangle.edgeB[0] * pixelY + triangle.edgeC[0]);
+            auto row1 = Isa::set(triangle.edgeB[1] * pixelY + triangle.edgeC[1]);
+            auto row2 = Isa::set(triangle.edgeB[2] * pixelY + triangle.edgeC[2]);
+            auto rowDepth = Isa::set(triangle.depthB * pixelY + triangle.depthC);
+            auto pRow = pDepths + (ptrdiff_t)y * stride;
+            for (auto x = firstX; x <= maxX; x += (int32_t)Isa::Width) {
+                auto pixelX = Isa::add(Isa::set((float)x), laneOffsets);
+                auto outside = Isa::mask_or(
+                    Isa::mask_or(
+                        Isa::less(Isa::add(Isa::mul(edgeA0, pixelX), row0), zero),
+                        Isa::less(Isa::add(Isa::mul(edgeA1, pixelX), row1), zero)
+                    ),
+                    Isa::less(Isa::add(Isa::mul(edgeA2, pixelX), row2), zero)
+                );
+                if (Isa::get_mask_bits(outside) != (1u << Isa::Width) - 1) {
+                    auto depth = Isa::add(Isa::mul(depthA, pixelX), rowDepth);
+                    auto depths = Isa::load(pRow + x);
+                    Isa::store(pRow + x, Isa::select(outside, depths, Isa::min(depths, depth)));
+                }
+            }
+        }
+    }
+
+    // Reduce the tile to its farthest depth for the hierarchical depth buffer.
+    auto farthest = zero;
+    for (auto y = tileY; y < tileY + OcclusionTileHeight; ++y) {
+        for (auto x = tileX; x < tileX + OcclusionTileWidth; x += (int32_t)Isa::Width) {
+            farthest = Isa::max(farthest, Isa::load(pDepths + (ptrdiff_t)y * stride + x));
+        }
+    }
+    float lanes[Isa::Width] { };
+    Isa::store(lanes, farthest);
+    auto result = lanes[0];
+    for (size_t i = 1; i < Isa::Width; ++i) {
+        result = result < lanes[i] ? lanes[i] : result;
+    }
+    return result;
+}
+
+template <typename Isa>
+inline bool test_rect(const float* pDepths, int32_t stride, int32_t minX, int32_t minY, int32_t maxX, int32_t maxY, float depth)
+{
+    // Rows are read in whole blocks aligned to the rectangle's first pixel,
+    //  lanes outside the rectangle are masked off.  Reads may extend up to one
+    //  block past maxX so the depth buffer is padded, see OcclusionCuller.
+    auto depths = Isa::set(depth);
+    auto laneOffsets = Isa::load(OcclusionLaneOffsets);
+    auto right = Isa::set((float)maxX + 1);
+    for (auto y = minY; y <= maxY; ++y) {
+        auto pRow = pDepths + (ptrdiff_t)y * stride;
+        for (auto x = minX; x <= maxX; x += (int32_t)Isa::Width) {
+            auto excluded = Isa::mask_or(Isa::less(Isa::load(pRow + x), depths), Isa::less(right, Isa::add(Isa::set((float)x), laneOffsets)));
+            if (Isa::get_mask_bits(excluded) != (1u << Isa::Width) - 1) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+template <typename Isa>
+constexpr OcclusionKernels create_occlusion_kernels(batch::InstructionSet instructionSet)
+{
+    OcclusionKernels kernels { };
+    kernels.instructionSet = instructionSet;
+    kernels.pfnRasterizeTile = rasterize_tile<Isa>;
+    kernels.pfnTestRect = test_rect<Isa>;
+    return kernels;
+}
+
+} // namespace detail
+} // namespace gfx
+} // namespace dst
@@ -0,0 +1,387 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+
+
+#include "dynamic-static.graphics/occlusion-culler.hpp"
+#include "occlusion-culler-kernels.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+namespace dst {
+namespace gfx {
+namespace detail {
+namespace {
+
+struct Scalar final
+{
+    using Float = float;
+    using Mask = bool;
+    static constexpr size_t Width = 1;
+    static inline Float load(const float* pData) { return *pData; }
+    static inline void store(float* pData, Float value) { *pData = value; }
+    static inline Float set(float value) { return value; }
+    static inline Float add(Float lhs, Float rhs) { return lhs + rhs; }
+    static inline Float mul(Float lhs, Float rhs) { return lhs * rhs; }
+    static inline Float min(Float lhs, Float rhs) { return lhs < rhs ? lhs : rhs; }
+    static inline Float max(Float lhs, Float rhs) { return lhs > rhs ? lhs : rhs; }
+    static inline Mask less(Float lhs, Float rhs) { return lhs < rhs; }
+    static inline Mask mask_or(Mask lhs, Mask rhs) { return lhs || rhs; }
+    static inline Float select(Mask mask, Float lhs, Float rhs) { return mask ? lhs : rhs; }
+    static inline uint32_t get_mask_bits(Mask mask) { return mask ? 1 : 0; }
+};
+
+constexpr OcclusionKernels ScalarOcclusionKernels = create_occlusion_kernels<Scalar>(batch::InstructionSet::Scalar);
+
+} // namespace
+
+const OcclusionKernels* get_scalar_occlusion_kernels()
+{
+    return &ScalarOcclusionKernels;
+}
+
+} // namespace detail
+
+namespace {
+
+static_assert(OcclusionCuller::TileWidth == detail::OcclusionTileWidth);
+static_assert(OcclusionCuller::TileHeight == detail::OcclusionTileHeight);
+
+// Follows dst::batch, instruction sets without tile kernels fall back to the
+//  next narrowest.
+const detail::OcclusionKernels& get_kernels()
+{
+    auto instructionSet = batch::get_instruction_set();
+    const detail::OcclusionKernels* pKernels = nullptr;
+    if (instructionSet == batch::InstructionSet::Avx2) {
+        pKernels = detail::get_avx2_occlusion_kernels();
+    }
+    if (!pKernels && (instructionSet == batch::InstructionSet::Avx2 || instructionSet == batch::InstructionSet::Sse2)) {
+        pKernels = detail::get_sse2_occlusion_kernels();
+    }
+    return pKernels ? *pKernels : *detail::get_scalar_occlusion_kernels();
+}
+
+// Returns the signed distance to the near plane in clip space, see
+//  make_frustum().
+inline float get_near_distance(const glm::vec4& clip)
+{
+#ifdef GLM_FORCE_DEPTH_ZERO_TO_ONE
+    return clip.z;
+#else
+    return clip.z + clip.w;
+#endif
+}
+
+inline glm::vec3 get_screen_position(const glm::vec4& clip, float width, float height)
+{
+    auto w = 1.0f / clip.w;
+#ifdef GLM_FORCE_DEPTH_ZERO_TO_ONE
+    auto depth = clip.z * w;
+#else
+    auto depth = clip.z * w * 0.5f + 0.5f;
+#endif
+    return { (clip.x * w * 0.5f + 0.5f) * width, (clip.y * w * 0.5f + 0.5f) * height, depth };
+}
+
+// Returns the edge function for the directed edge from a to b, positive to the
+//  left of the edge.
+inline std::array<float, 3> create_edge_function(const glm::vec3& a, const glm::vec3& b)
+{
+    return { a.y - b.y, b.x - a.x, a.x * b.y - a.y * b.x };
+}
+
+} // namespace
+
+OcclusionCuller::OcclusionCuller() = default;
+OcclusionCuller::OcclusionCuller(OcclusionCuller&& other) = default;
+OcclusionCuller& OcclusionCuller::operator=(OcclusionCuller&& other) = default;
+
+OcclusionCuller::~OcclusionCuller()
+{
+}
+
+void OcclusionCuller::create(const CreateInfo* pCreateInfo, OcclusionCuller* pOcclusionCuller)
+{
+    assert(pCreateInfo);
+    assert(pCreateInfo->width && !(pCreateInfo->width % TileWidth));
+    assert(pCreateInfo->height && !(pCreateInfo->height % TileHeight));
+    assert(pOcclusionCuller);
+    pOcclusionCuller->reset();
+    pOcclusionCuller->mWidth = pCreateInfo->width;
+    pOcclusionCuller->mHeight = pCreateInfo->height;
+    pOcclusionCuller->mTileCountX = pCreateInfo->width / TileWidth;
+    pOcclusionCuller->mTileCountY = pCreateInfo->height / TileHeight;
+    auto tileCount = pOcclusionCuller->mTileCountX * pOcclusionCuller->mTileCountY;
+    // The depth buffer is padded so test_rect() can read whole blocks past the
+    //  last pixel.
+    pOcclusionCuller->mDepths.resize((size_t)pCreateInfo->width * pCreateInfo->height + TileWidth, 1.0f);
+    pOcclusionCuller->mTileDepths.resize(tileCount, 1.0f);
+    pOcclusionCuller->mBins.resize(tileCount);
+}
+
+uint32_t OcclusionCuller::get_width() const
+{
+    return mWidth;
+}
+
+uint32_t OcclusionCuller::get_height() const
+{
+    return mHeight;
+}
+
+uint32_t OcclusionCuller::get_triangle_count() const
+{
+    return (uint32_t)mTriangles.size();
+}
+
+std::span<const float> OcclusionCuller::get_depths() const
+{
+    return { mDepths.data(), (size_t)mWidth * mHeight };
+}
+
+void OcclusionCuller::begin_frame(const glm::mat4& viewProjection)
+{
+    assert(mWidth && "dst::gfx::OcclusionCuller::begin_frame() called on an OcclusionCuller that hasn't been created");
+    mViewProjection = viewProjection;
+    mTriangles.clear();
+    for (auto& bin : mBins) {
+        bin.clear();
+    }
+}
+
+void OcclusionCuller::add_occluder(std::span<const glm::vec3> positions, std::span<const primitive::Triangle<uint32_t>> triangles, const glm::mat4& world)
+{
+    assert(mWidth && "dst::gfx::OcclusionCuller::add_occluder() called on an OcclusionCuller that hasn't been created");
+    auto worldViewProjection = mViewProjection * world;
+    for (const auto& triangle : triangles) {
+        std::array<glm::vec4, 3> clip { };
+        std::array<float, 3> nearDistances { };
+        uint32_t insideCount = 0;
+        for (size_t i = 0; i < clip.size(); ++i) {
+            assert(triangle[i] < positions.size());
+            clip[i] = worldViewProjection * glm::vec4(positions[triangle[i]], 1);
+            nearDistances[i] = get_near_distance(clip[i]);
+            insideCount += 0 < nearDistances[i] ? 1 : 0;
+        }
+        if (insideCount == 3) {
+            bin_triangle(clip[0], clip[1], clip[2]);
+        } else if (insideCount) {
+            // Clip against the near plane, one vertex inside produces a triangle
+            //  and two produce a quad.
+            std::array<glm::vec4, 4> polygon { };
+            uint32_t polygonSize = 0;
+            for (size_t i = 0; i < clip.size(); ++i) {
+                auto j = (i + 1) % clip.size();
+                if (0 < nearDistances[i]) {
+                    polygon[polygonSize++] = clip[i];
+                }
+                if ((0 < nearDistances[i]) != (0 < nearDistances[j])) {
+                    auto t = nearDistances[i] / (nearDistances[i] - nearDistances[j]);
+                    polygon[polygonSize++] = clip[i] + (clip[j] - clip[i]) * t;
+                }
+            }
+            for (uint32_t i = 2; i < polygonSize; ++i) {
+                bin_triangle(polygon[0], polygon[i - 1], polygon[i]);
+            }
+        }
+    }
+}
+
+void OcclusionCuller::rasterize()
+{
+    assert(mWidth && "dst::gfx::OcclusionCuller::rasterize() called on an OcclusionCuller that hasn't been created");
+    const auto& kernels = get_kernels();
+    for (uint32_t tile = 0; tile < mBins.size(); ++tile) {
+        rasterize_tile(kernels, tile);
+    }
+}
+
+void OcclusionCuller::rasterize(JobSystem& jobSystem)
+{
+    assert(mWidth && "dst::gfx::OcclusionCuller::rasterize() called on an OcclusionCuller that hasn't been created");
+    const auto& kernels = get_kernels();
+    jobSystem.parallel_for(mBins.size(), 4,
+        [&](size_t begin, size_t end)
+        {
+            for (size_t tile = begin; tile < end; ++tile) {
+                rasterize_tile(kernels, (uint32_t)tile);
+            }
+        }
+    );
+}
+
+bool OcclusionCuller::is_visible(const glm::vec3& min, const glm::vec3& max) const
+{
+    assert(mWidth && "dst::gfx::OcclusionCuller::is_visible() called on an OcclusionCuller that hasn't been created");
+    glm::vec3 screenMin { std::numeric_limits<float>::max() };
+    glm::vec3 screenMax { std::numeric_limits<float>::lowest() };
+    for (uint32_t corner_i = 0; corner_i < 8; ++corner_i) {
+        glm::vec3 corner {
+            corner_i & 1 ? max.x : min.x,
+            corner_i & 2 ? max.y : min.y,
+            corner_i & 4 ? max.z : min.z,
+        };
+        auto clip = mViewProjection * glm::vec4(corner, 1);
+        if (!(0 < get_near_distance(clip))) {
+            return true;
+        }
+        auto screen = get_screen_position(clip, (float)mWidth, (float)mHeight);
+        screenMin = glm::min(screenMin, screen);
+        screenMax = glm::max(screenMax, screen);
+    }
+    if (screenMax.x < 0 || screenMax.y < 0 || (float)mWidth <= screenMin.x || (float)mHeight <= screenMin.y || 1 < screenMin.z) {
+        return false;
+    }
+
+    // Test every pixel the rectangle touches, tiles whose farthest depth is in
+    //  front of the AABB's nearest depth can't show any of it.
+    auto minX = (int32_t)std::max(screenMin.x, 0.0f);
+    auto minY = (int32_t)std::max(screenMin.y, 0.0f);
+    auto maxX = (int32_t)std::min(screenMax.x, (float)(mWidth - 1));
+    auto maxY = (int32_t)std::min(screenMax.y, (float)(mHeight - 1));
+    auto depth = screenMin.z;
+    const auto& kernels = get_kernels();
+    for (auto tileY = minY / (int32_t)TileHeight; tileY <= maxY / (int32_t)TileHeight; ++tileY) {
+        for (auto tileX = minX / (int32_t)TileWidth; tileX <= maxX / (int32_t)TileWidth; ++tileX) {
+            if (mTileDepths[tileY * mTileCountX + tileX] < depth) {
+                continue;
+            }
+            auto rectMinX = std::max(minX, tileX * (int32_t)TileWidth);
+            auto rectMinY = std::max(minY, tileY * (int32_t)TileHeight);
+            auto rectMaxX = std::min(maxX, (tileX + 1) * (int32_t)TileWidth - 1);
+            auto rectMaxY = std::min(maxY, (tileY + 1) * (int32_t)TileHeight - 1);
+            if (kernels.pfnTestRect(mDepths.data(), (int32_t)mWidth, rectMinX, rectMinY, rectMaxX, rectMaxY, depth)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void OcclusionCuller::reset()
+{
+    mWidth = 0;
+    mHeight = 0;
+    mTileCountX = 0;
+    mTileCountY = 0;
+    mViewProjection = glm::mat4 { 1 };
+    mDepths.clear();
+    mTileDepths.clear();
+    mTriangles.clear();
+    mBins.clear();
+}
+
+void OcclusionCuller::bin_triangle(const glm::vec4& clip0, const glm::vec4& clip1, const glm::vec4& clip2)
+{
+    std::array<glm::vec3, 3> vertices {
+        get_screen_position(clip0, (float)mWidth, (float)mHeight),
+        get_screen_position(clip1, (float)mWidth, (float)mHeight),
+        get_screen_position(clip2, (float)mWidth, (float)mHeight),
+    };
+    if (1 < vertices[0].z && 1 < vertices[1].z && 1 < vertices[2].z) {
+        return;
+    }
+    auto area = (vertices[1].x - vertices[0].x) * (vertices[2].y - vertices[0].y) - (vertices[1].y - vertices[0].y) * (vertices[2].x - vertices[0].x);
+    if (area < 0) {
+        std::swap(vertices[1], vertices[2]);
+        area = -area;
+    }
+    if (!(0 < area)) {
+        return;
+    }
+
+    // Cover pixels whose centers are inside the triangle's bounds.
+    auto boundsMin = glm::min(glm::min(vertices[0], vertices[1]), vertices[2]);
+    auto boundsMax = glm::max(glm::max(vertices[0], vertices[1]), vertices[2]);
+    detail::OcclusionTriangle triangle { };
+    triangle.minX = (int32_t)std::ceil(std::clamp(boundsMin.x - 0.5f, 0.0f, (float)mWidth));
+    triangle.minY = (int32_t)std::ceil(std::clamp(boundsMin.y - 0.5f, 0.0f, (float)mHeight));
+    triangle.maxX = (int32_t)std::floor(std::clamp(boundsMax.x - 0.5f, -1.0f, (float)(mWidth - 1)));
+    triangle.maxY = (int32_t)std::floor(std::clamp(boundsMax.y - 0.5f, -1.0f, (float)(mHeight - 1)));
+    if (triangle.maxX < triangle.minX || triangle.maxY < triangle.minY) {
+        return;
+    }
+
+    // Edge i is opposite vertex i so it evaluates to area at vertex i, dividing by
+    //  area gives barycentric coordinates for interpolating depth.
+    std::array<std::array<float, 3>, 3> edges {
+        create_edge_function(vertices[1], vertices[2]),
+        create_edge_function(vertices[2], vertices[0]),
+        create_edge_function(vertices[0], vertices[1]),
+    };
+    auto rcpArea = 1.0f / area;
+    for (size_t i = 0; i < edges.size(); ++i) {
+        triangle.edgeA[i] = edges[i][0];
+        triangle.edgeB[i] = edges[i][1];
+        triangle.edgeC[i] = edges[i][2];
+    }
+    triangle.depthA = (edges[0][0] * vertices[0].z + edges[1][0] * vertices[1].z + edges[2][0] * vertices[2].z) * rcpArea;
+    triangle.depthB = (edges[0][1] * vertices[0].z + edges[1][1] * vertices[1].z + edges[2][1] * vertices[2].z) * rcpArea;
+    triangle.depthC = (edges[0][2] * vertices[0].z + edges[1][2] * vertices[1].z + edges[2][2] * vertices[2].z) * rcpArea;
+
+    // Bin into every tile in the triangle's bounds that isn't fully outside one of
+    //  its edges, each edge is tested at the tile's pixel center that maximizes
+    //  it.
+    auto triangleIndex = (uint32_t)mTriangles.size();
+    mTriangles.push_back(triangle);
+    for (auto tileY = triangle.minY / (int32_t)TileHeight; tileY <= triangle.maxY / (int32_t)TileHeight; ++tileY) {
+        for (auto tileX = triangle.minX / (int32_t)TileWidth; tileX <= triangle.maxX / (int32_t)TileWidth; ++tileX) {
+            auto minX = (float)(tileX * (int32_t)TileWidth) + 0.5f;
+            auto minY = (float)(tileY * (int32_t)TileHeight) + 0.5f;
+            auto maxX = minX + (float)(TileWidth - 1);
+            auto maxY = minY + (float)(TileHeight - 1);
+            bool outside = false;
+            for (size_t i = 0; i < edges.size() && !outside; ++i) {
+                auto x = 0 < edges[i][0] ? maxX : minX;
+                auto y = 0 < edges[i][1] ? maxY : minY;
+                outside = edges[i][0] * x + (edges[i][1] * y + edges[i][2]) < 0;
+            }
+            if (!outside) {
+                mBins[tileY * mTileCountX + tileX].push_back(triangleIndex);
+            }
+        }
+    }
+}
+
+void OcclusionCuller::rasterize_tile(const detail::OcclusionKernels& kernels, uint32_t tile)
+{
+    auto tileX = (int32_t)(tile % mTileCountX * TileWidth);
+    auto tileY = (int32_t)(tile / mTileCountX * TileHeight);
+    for (auto y = tileY; y < tileY + (int32_t)TileHeight; ++y) {
+        std::fill_n(mDepths.begin() + (ptrdiff_t)y * mWidth + tileX, TileWidth, 1.0f);
+    }
+    const auto& bin = mBins[tile];
+    mTileDepths[tile] = bin.empty() ? 1.0f : kernels.pfnRasterizeTile(mTriangles.data(), bin.data(), bin.size(), tileX, tileY, (int32_t)mWidth, mDepths.data());
+}
+
+} // namespace gfx
+} // namespace dst
@@ -0,0 +1,188 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+
+#include "dynamic-static.graphics/pipeline-builder.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace dst {
+namespace gfx {
+
+struct PipelineBuilder::Future::State final
+{
+    JobSystem* pJobSystem { nullptr };
+    std::vector<gvk::spirv::ShaderInfo> shaderInfos;
+    CreateFunction create;
+    VkResult result { VK_NOT_READY };
+    JobCounter counter;
+};
+
+bool PipelineBuilder::Future::valid() const
+{
+    return mspState != nullptr;
+}
+
+bool PipelineBuilder::Future::is_ready() const
+{
+    assert(valid());
+    return mspState->counter.is_complete();
+}
+
+VkResult PipelineBuilder::Future::get() const
+{
+    assert(valid());
+    mspState->pJobSystem->wait(&mspState->counter);
+    return mspState->result;
+}
+
+std::span<const gvk::spirv::ShaderInfo> PipelineBuilder::Future::get_shader_infos() const
+{
+    assert(is_ready());
+    return mspState->shaderInfos;
+}
+
+void PipelineBuilder::create(const CreateInfo* pCreateInfo, PipelineBuilder* pPipelineBuilder)
+{
+    assert(pCreateInfo);
+    assert(pCreateInfo->pJobSystem);
+    assert(pCreateInfo->compile);
+    assert(pPipelineBuilder);
+    pPipelineBuilder->reset();
+    pPipelineBuilder->mpJobSystem = pCreateInfo->pJobSystem;
+    pPipelineBuilder->mpShaderCache = pCreateInfo->pShaderCache;
+    pPipelineBuilder->mCompile = pCreateInfo->compile;
+}
+
+PipelineBuilder::~PipelineBuilder()
+{
+    reset();
+}
+
+const PipelineBuilder::Statistics& PipelineBuilder::get_statistics() const
+{
+    return mStatistics;
+}
+
+PipelineBuilder::Future PipelineBuilder::build(Description description)
+{
+    assert(mpJobSystem);
+    assert(description.create);
+    std::erase_if(mPendingStates, [](const auto& spState) { return spState->counter.is_complete(); });
+
+    // Compile jobs are scheduled before the pipeline job that waits on them, a
+    //  pipeline job that starts before its shaders are ready executes other jobs
+    //  while it waits rather than blocking its thread.
+    std::vector<std::shared_ptr<ShaderEntry>> shaderEntries;
+    shaderEntries.reserve(description.shaderInfos.size());
+    for (const auto& shaderInfo : description.shaderInfos) {
+        shaderEntries.push_back(get_shader_entry(shaderInfo));
+    }
+    auto spState = std::make_shared<Future::State>();
+    spState->pJobSystem = mpJobSystem;
+    spState->shaderInfos = std::move(description.shaderInfos);
+    spState->create = std::move(description.create);
+    mPendingStates.push_back(spState);
+    ++mStatistics.pipelineCount;
+    mpJobSystem->run(&spState->counter,
+        [pJobSystem = mpJobSystem, pState = spState.get(), shaderEntries = std::move(shaderEntries)]()
+        {
+            auto compiled = true;
+            for (size_t i = 0; i < shaderEntries.size(); ++i) {
+                pJobSystem->wait(&shaderEntries[i]->counter);
+                pState->shaderInfos[i].spirv = shaderEntries[i]->shaderInfo.spirv;
+                pState->shaderInfos[i].errors = shaderEntries[i]->shaderInfo.errors;
+                compiled &= pState->shaderInfos[i].errors.empty();
+            }
+            pState->result = compiled ? pState->create(pState->shaderInfos) : VK_ERROR_INITIALIZATION_FAILED;
+        }
+    );
+    Future future;
+    future.mspState = std::move(spState);
+    return future;
+}
+
+std::vector<PipelineBuilder::Future> PipelineBuilder::build(std::vector<Description> descriptions)
+{
+    std::vector<Future> futures;
+    futures.reserve(descriptions.size());
+    for (auto& description : descriptions) {
+        futures.push_back(build(std::move(description)));
+    }
+    return futures;
+}
+
+void PipelineBuilder::wait()
+{
+    if (mpJobSystem) {
+        for (const auto& spState : mPendingStates) {
+            mpJobSystem->wait(&spState->counter);
+        }
+        for (const auto& itr : mShaderEntries) {
+            mpJobSystem->wait(&itr.second->counter);
+        }
+    }
+    mPendingStates.clear();
+}
+
+void PipelineBuilder::reset()
+{
+    wait();
+    mpJobSystem = nullptr;
+    mpShaderCache = nullptr;
+    mCompile = nullptr;
+    mShaderEntries.clear();
+    mStatistics = { };
+}
+
+std::shared_ptr<PipelineBuilder::ShaderEntry> PipelineBuilder::get_shader_entry(const gvk::spirv::ShaderInfo& shaderInfo)
+{
+    auto& spShaderEntry = mShaderEntries[ShaderCache::create_key(shaderInfo)];
+    if (spShaderEntry) {
+        ++mStatistics.sharedShaderCount;
+        return spShaderEntry;
+    }
+    spShaderEntry = std::make_shared<ShaderEntry>();
+    spShaderEntry->shaderInfo = shaderInfo;
+    spShaderEntry->shaderInfo.spirv.clear();
+    spShaderEntry->shaderInfo.errors.clear();
+    ++mStatistics.shaderCount;
+    mpJobSystem->run(&spShaderEntry->counter,
+        [this, pShaderEntry = spShaderEntry.get()]()
+        {
+            if (mpShaderCache) {
+                mpShaderCache->compile(&pShaderEntry->shaderInfo, mCompile);
+            } else {
+                mCompile(&pShaderEntry->shaderInfo);
+            }
+        }
+    );
+    return spShaderEntry;
+}
+
+} // namespace gfx
+} // namespace dst
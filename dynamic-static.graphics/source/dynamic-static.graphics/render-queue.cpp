@@ -0,0 +1,196 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+
+#include "dynamic-static.graphics/render-queue.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+
+namespace dst {
+namespace gfx {
+
+static_assert(RenderQueue::PipelineBits + RenderQueue::MaterialBits + RenderQueue::MeshBits + RenderQueue::DepthBits == 64);
+
+static constexpr uint32_t DepthShift { 0 };
+static constexpr uint32_t MeshShift { DepthShift + RenderQueue::DepthBits };
+static constexpr uint32_t MaterialShift { MeshShift + RenderQueue::MeshBits };
+static constexpr uint32_t PipelineShift { MaterialShift + RenderQueue::MaterialBits };
+
+static constexpr uint64_t get_field_mask(uint32_t bits)
+{
+    return ((uint64_t)1 << bits) - 1;
+}
+
+static constexpr uint32_t get_field(uint64_t sortKey, uint32_t shift, uint32_t bits)
+{
+    return (uint32_t)((sortKey >> shift) & get_field_mask(bits));
+}
+
+uint64_t RenderQueue::create_sort_key(uint32_t pipeline, uint32_t material, uint32_t mesh, float depth)
+{
+    assert(pipeline <= get_field_mask(PipelineBits));
+    assert(material <= get_field_mask(MaterialBits));
+    assert(mesh <= get_field_mask(MeshBits));
+    auto quantizedDepth = (uint64_t)std::lround(std::clamp(depth, 0.0f, 1.0f) * (float)get_field_mask(DepthBits));
+    return
+        (uint64_t)pipeline << PipelineShift |
+        (uint64_t)material << MaterialShift |
+        (uint64_t)mesh << MeshShift |
+        quantizedDepth << DepthShift;
+}
+
+void RenderQueue::create(const CreateInfo* pCreateInfo, RenderQueue* pRenderQueue)
+{
+    assert(pCreateInfo);
+    assert(pRenderQueue);
+    pRenderQueue->reset();
+    pRenderQueue->mSubmissions.reserve(pCreateInfo->capacity);
+    pRenderQueue->mScratch.reserve(pCreateInfo->capacity);
+    pRenderQueue->mDraws.reserve(pCreateInfo->capacity);
+}
+
+size_t RenderQueue::size() const
+{
+    return mSubmissions.size();
+}
+
+void RenderQueue::submit(uint64_t sortKey, uint32_t item)
+{
+    mSubmissions.push_back({ sortKey, item });
+}
+
+void RenderQueue::submit(uint32_t pipeline, uint32_t material, uint32_t mesh, float depth, uint32_t item)
+{
+    submit(create_sort_key(pipeline, material, mesh, depth), item);
+}
+
+const std::vector<RenderQueue::Draw>& RenderQueue::sort()
+{
+    // LSD radix sort, 11 bits per pass so 64 bit keys take 6 passes.  Histograms
+    //  for every pass are built in a single read of the keys and passes where
+    //  every key has the same digit are skipped, in practice the pipeline and
+    //  material digits are often uniform.  Small queues don't amortize clearing
+    //  and scanning the histograms so they fall back to a comparison sort.
+    constexpr uint32_t RadixBits = 11;
+    constexpr uint32_t RadixSize = 1 << RadixBits;
+    constexpr uint32_t PassCount = (64 + RadixBits - 1) / RadixBits;
+    constexpr size_t RadixSortThreshold = 2048;
+    auto count = mSubmissions.size();
+    if (count < RadixSortThreshold) {
+        std::stable_sort(mSubmissions.begin(), mSubmissions.end(), [](const auto& lhs, const auto& rhs) { return lhs.sortKey < rhs.sortKey; });
+    } else {
+        std::array<std::array<uint32_t, RadixSize>, PassCount> histograms { };
+        for (const auto& submission : mSubmissions) {
+            for (uint32_t pass = 0; pass < PassCount; ++pass) {
+                ++histograms[pass][(submission.sortKey >> (pass * RadixBits)) & (RadixSize - 1)];
+            }
+        }
+        mScratch.resize(count);
+        auto pSource = mSubmissions.data();
+        auto pDestination = mScratch.data();
+        for (uint32_t pass = 0; pass < PassCount; ++pass) {
+            auto shift = pass * RadixBits;
+            auto& histogram = histograms[pass];
+            if (histogram[(pSource[0].sortKey >> shift) & (RadixSize - 1)] == count) {
+                continue;
+            }
+            uint32_t offset = 0;
+            for (auto& bucket : histogram) {
+                auto bucketCount = bucket;
+                bucket = offset;
+                offset += bucketCount;
+            }
+            for (size_t i = 0; i < count; ++i) {
+                pDestination[histogram[(pSource[i].sortKey >> shift) & (RadixSize - 1)]++] = pSource[i];
+            }
+            std::swap(pSource, pDestination);
+        }
+        if (pSource != mSubmissions.data()) {
+            mSubmissions.swap(mScratch);
+        }
+    }
+
+    // Walk the sorted submissions and flag only the state that differs from the
+    //  previous Draw.  Materials are rebound after a pipeline change since the new
+    //  pipeline's layout may not be compatible with the bound DescriptorSets.
+    mDraws.resize(count);
+    mStatistics = { };
+    mStatistics.drawCount = (uint32_t)count;
+    for (size_t i = 0; i < count; ++i) {
+        auto sortKey = mSubmissions[i].sortKey;
+        auto& draw = mDraws[i];
+        draw.pipeline = get_field(sortKey, PipelineShift, PipelineBits);
+        draw.material = get_field(sortKey, MaterialShift, MaterialBits);
+        draw.mesh = get_field(sortKey, MeshShift, MeshBits);
+        draw.item = mSubmissions[i].item;
+        draw.flags = 0;
+        const auto* pPrevious = i ? &mDraws[i - 1] : nullptr;
+        if (!pPrevious || pPrevious->pipeline != draw.pipeline) {
+            draw.flags |= Draw::BindPipeline;
+            ++mStatistics.pipelineBindCount;
+        }
+        if (!pPrevious || pPrevious->material != draw.material || (draw.flags & Draw::BindPipeline)) {
+            draw.flags |= Draw::BindMaterial;
+            ++mStatistics.materialBindCount;
+        }
+        if (!pPrevious || pPrevious->mesh != draw.mesh) {
+            draw.flags |= Draw::BindMesh;
+            ++mStatistics.meshBindCount;
+        }
+    }
+    return mDraws;
+}
+
+const std::vector<RenderQueue::Draw>& RenderQueue::get_draws() const
+{
+    return mDraws;
+}
+
+const RenderQueue::Statistics& RenderQueue::get_statistics() const
+{
+    return mStatistics;
+}
+
+void RenderQueue::clear()
+{
+    mSubmissions.clear();
+    mDraws.clear();
+    mStatistics = { };
+}
+
+void RenderQueue::reset()
+{
+    mSubmissions = { };
+    mScratch = { };
+    mDraws = { };
+    mStatistics = { };
+}
+
+} // namespace gfx
+} // namespace dst
@@ -0,0 +1,281 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+
+#include "dynamic-static.graphics/resource-table.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+namespace dst {
+namespace gfx {
+
+void DescriptorSlotAllocator::create(const CreateInfo* pCreateInfo, DescriptorSlotAllocator* pDescriptorSlotAllocator)
+{
+    assert(pCreateInfo);
+    assert(pCreateInfo->capacity);
+    assert(pCreateInfo->frameCount);
+    assert(pDescriptorSlotAllocator);
+    pDescriptorSlotAllocator->reset();
+    pDescriptorSlotAllocator->mCapacity = pCreateInfo->capacity;
+    pDescriptorSlotAllocator->mPendingFreeSlots.resize(pCreateInfo->frameCount);
+}
+
+uint32_t DescriptorSlotAllocator::get_capacity() const
+{
+    return mCapacity;
+}
+
+uint32_t DescriptorSlotAllocator::get_used_count() const
+{
+    return mUsedCount;
+}
+
+uint32_t DescriptorSlotAllocator::get_frame_count() const
+{
+    return (uint32_t)mPendingFreeSlots.size();
+}
+
+uint32_t DescriptorSlotAllocator::get_frame_index() const
+{
+    return mFrameIndex;
+}
+
+void DescriptorSlotAllocator::begin_frame(uint32_t frameIndex)
+{
+    assert(frameIndex < mPendingFreeSlots.size());
+    mFrameIndex = frameIndex;
+    auto& pendingFreeSlots = mPendingFreeSlots[mFrameIndex];
+    mFreeSlots.insert(mFreeSlots.end(), pendingFreeSlots.begin(), pendingFreeSlots.end());
+    pendingFreeSlots.clear();
+}
+
+bool DescriptorSlotAllocator::allocate(uint32_t* pSlot)
+{
+    assert(mCapacity);
+    assert(pSlot);
+    if (!mFreeSlots.empty()) {
+        *pSlot = mFreeSlots.back();
+        mFreeSlots.pop_back();
+    } else if (mHighWaterMark < mCapacity) {
+        *pSlot = mHighWaterMark++;
+    } else {
+        return false;
+    }
+    ++mUsedCount;
+    return true;
+}
+
+void DescriptorSlotAllocator::free(uint32_t slot)
+{
+    assert(slot < mHighWaterMark);
+    assert(mUsedCount);
+    mPendingFreeSlots[mFrameIndex].push_back(slot);
+    --mUsedCount;
+}
+
+void DescriptorSlotAllocator::reset()
+{
+    mCapacity = 0;
+    mHighWaterMark = 0;
+    mUsedCount = 0;
+    mFrameIndex = 0;
+    mFreeSlots.clear();
+    mPendingFreeSlots.clear();
+}
+
+void DescriptorWriteBatch::write(uint32_t arrayElement, const VkDescriptorBufferInfo& descriptorBufferInfo)
+{
+    mWrites.push_back({ arrayElement, descriptorBufferInfo });
+}
+
+size_t DescriptorWriteBatch::size() const
+{
+    return mWrites.size();
+}
+
+const std::vector<VkWriteDescriptorSet>& DescriptorWriteBatch::get_write_descriptor_sets(VkDescriptorSet descriptorSet, uint32_t binding, VkDescriptorType descriptorType)
+{
+    // Stable sort by array element so the last write to an element can be kept,
+    //  then gather the surviving VkDescriptorBufferInfos contiguously so each run
+    //  of consecutive elements points into one range.  mDescriptorBufferInfos is
+    //  fully populated before any VkWriteDescriptorSet takes a pointer into it.
+    std::stable_sort(mWrites.begin(), mWrites.end(), [](const auto& lhs, const auto& rhs) { return lhs.arrayElement < rhs.arrayElement; });
+    mDescriptorBufferInfos.clear();
+    mWriteDescriptorSets.clear();
+    std::vector<std::pair<uint32_t, uint32_t>> runs;
+    for (size_t i = 0; i < mWrites.size(); ++i) {
+        const auto& write = mWrites[i];
+        if (i + 1 < mWrites.size() && mWrites[i + 1].arrayElement == write.arrayElement) {
+            continue;
+        }
+        if (runs.empty() || runs.back().first + runs.back().second != write.arrayElement) {
+            runs.push_back({ write.arrayElement, 0 });
+        }
+        ++runs.back().second;
+        mDescriptorBufferInfos.push_back(write.descriptorBufferInfo);
+    }
+    uint32_t descriptorBufferInfoIndex = 0;
+    for (const auto& run : runs) {
+        auto writeDescriptorSet = gvk::get_default<VkWriteDescriptorSet>();
+        writeDescriptorSet.dstSet = descriptorSet;
+        writeDescriptorSet.dstBinding = binding;
+        writeDescriptorSet.dstArrayElement = run.first;
+        writeDescriptorSet.descriptorCount = run.second;
+        writeDescriptorSet.descriptorType = descriptorType;
+        writeDescriptorSet.pBufferInfo = mDescriptorBufferInfos.data() + descriptorBufferInfoIndex;
+        mWriteDescriptorSets.push_back(writeDescriptorSet);
+        descriptorBufferInfoIndex += run.second;
+    }
+    return mWriteDescriptorSets;
+}
+
+void DescriptorWriteBatch::clear()
+{
+    mWrites.clear();
+    mDescriptorBufferInfos.clear();
+    mWriteDescriptorSets.clear();
+}
+
+VkResult ResourceTable::create(const gvk::Device& device, const CreateInfo* pCreateInfo, ResourceTable* pResourceTable)
+{
+    assert(device);
+    assert(pCreateInfo);
+    assert(pCreateInfo->storageBufferCount);
+    assert(pResourceTable);
+    pResourceTable->reset();
+    gvk_result_scope_begin(VK_ERROR_INITIALIZATION_FAILED) {
+        DescriptorSlotAllocator::CreateInfo slotAllocatorCreateInfo { };
+        slotAllocatorCreateInfo.capacity = pCreateInfo->storageBufferCount;
+        slotAllocatorCreateInfo.frameCount = pCreateInfo->frameCount;
+        DescriptorSlotAllocator::create(&slotAllocatorCreateInfo, &pResourceTable->mSlotAllocator);
+
+        // Create a DescriptorSetLayout with a single array of storage buffers.  The
+        //  array is partially bound so unregistered elements are never accessed by
+        //  the device, and update after bind so flush() doesn't have to wait for
+        //  frames in flight.
+        VkDescriptorSetLayoutBinding descriptorSetLayoutBinding { };
+        descriptorSetLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        descriptorSetLayoutBinding.descriptorCount = pCreateInfo->storageBufferCount;
+        descriptorSetLayoutBinding.stageFlags = VK_SHADER_STAGE_ALL;
+        VkDescriptorBindingFlags descriptorBindingFlags = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT;
+        auto descriptorSetLayoutBindingFlagsCreateInfo = gvk::get_default<VkDescriptorSetLayoutBindingFlagsCreateInfo>();
+        descriptorSetLayoutBindingFlagsCreateInfo.bindingCount = 1;
+        descriptorSetLayoutBindingFlagsCreateInfo.pBindingFlags = &descriptorBindingFlags;
+        auto descriptorSetLayoutCreateInfo = gvk::get_default<VkDescriptorSetLayoutCreateInfo>();
+        descriptorSetLayoutCreateInfo.pNext = &descriptorSetLayoutBindingFlagsCreateInfo;
+        descriptorSetLayoutCreateInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+        descriptorSetLayoutCreateInfo.bindingCount = 1;
+        descriptorSetLayoutCreateInfo.pBindings = &descriptorSetLayoutBinding;
+        gvk_result(gvk::DescriptorSetLayout::create(device, &descriptorSetLayoutCreateInfo, nullptr, &pResourceTable->mDescriptorSetLayout));
+
+        // Create a DescriptorPool with room for the one DescriptorSet.
+        VkDescriptorPoolSize descriptorPoolSize { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, pCreateInfo->storageBufferCount };
+        auto descriptorPoolCreateInfo = gvk::get_default<VkDescriptorPoolCreateInfo>();
+        descriptorPoolCreateInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+        descriptorPoolCreateInfo.maxSets = 1;
+        descriptorPoolCreateInfo.poolSizeCount = 1;
+        descriptorPoolCreateInfo.pPoolSizes = &descriptorPoolSize;
+        gvk_result(gvk::DescriptorPool::create(device, &descriptorPoolCreateInfo, nullptr, &pResourceTable->mDescriptorPool));
+
+        // Allocate the DescriptorSet.
+        auto descriptorSetAllocateInfo = gvk::get_default<VkDescriptorSetAllocateInfo>();
+        descriptorSetAllocateInfo.descriptorPool = pResourceTable->mDescriptorPool;
+        descriptorSetAllocateInfo.descriptorSetCount = 1;
+        descriptorSetAllocateInfo.pSetLayouts = &pResourceTable->mDescriptorSetLayout.get<const VkDescriptorSetLayout&>();
+        gvk_result(gvk::DescriptorSet::allocate(device, &descriptorSetAllocateInfo, &pResourceTable->mDescriptorSet));
+    } gvk_result_scope_end;
+    if (gvkResult != VK_SUCCESS) {
+        pResourceTable->reset();
+    }
+    return gvkResult;
+}
+
+const gvk::DescriptorSetLayout& ResourceTable::get_descriptor_set_layout() const
+{
+    return mDescriptorSetLayout;
+}
+
+const gvk::DescriptorSet& ResourceTable::get_descriptor_set() const
+{
+    return mDescriptorSet;
+}
+
+const DescriptorSlotAllocator& ResourceTable::get_slot_allocator() const
+{
+    return mSlotAllocator;
+}
+
+void ResourceTable::begin_frame(uint32_t frameIndex)
+{
+    mSlotAllocator.begin_frame(frameIndex);
+}
+
+bool ResourceTable::register_storage_buffer(const VkDescriptorBufferInfo& descriptorBufferInfo, uint32_t* pIndex)
+{
+    assert(pIndex);
+    if (!mSlotAllocator.allocate(pIndex)) {
+        return false;
+    }
+    mWriteBatch.write(*pIndex, descriptorBufferInfo);
+    return true;
+}
+
+void ResourceTable::update_storage_buffer(uint32_t index, const VkDescriptorBufferInfo& descriptorBufferInfo)
+{
+    mWriteBatch.write(index, descriptorBufferInfo);
+}
+
+void ResourceTable::unregister_storage_buffer(uint32_t index)
+{
+    // The array is partially bound so the stale descriptor is left in place, the
+    //  index is only reused once frames that might read it have completed.
+    mSlotAllocator.free(index);
+}
+
+void ResourceTable::flush()
+{
+    assert(mDescriptorSet);
+    if (mWriteBatch.size()) {
+        const auto& writeDescriptorSets = mWriteBatch.get_write_descriptor_sets(mDescriptorSet, 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER);
+        const auto& device = mDescriptorSet.get<gvk::Device>();
+        vkUpdateDescriptorSets(device, (uint32_t)writeDescriptorSets.size(), writeDescriptorSets.data(), 0, nullptr);
+        mWriteBatch.clear();
+    }
+}
+
+void ResourceTable::reset()
+{
+    mDescriptorSet = gvk::DescriptorSet();
+    mDescriptorPool = gvk::DescriptorPool();
+    mDescriptorSetLayout = gvk::DescriptorSetLayout();
+    mSlotAllocator.reset();
+    mWriteBatch.clear();
+}
+
+} // namespace gfx
+} // namespace dst
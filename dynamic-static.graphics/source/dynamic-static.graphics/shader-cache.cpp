@@ -0,0 +1,273 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+
+#include "dynamic-static.graphics/shader-cache.hpp"
+#include "dynamic-static/asset-file.hpp"
+
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <system_error>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace dst {
+namespace gfx {
+
+static constexpr uint32_t SpirvMagic { make_fourcc('D', 'S', 'P', 'V') };
+
+struct SpirvHeader final
+{
+    uint32_t magic { SpirvMagic };
+    uint32_t version { ShaderCache::Version };
+    uint64_t key { 0 };
+    uint64_t spirvHash { 0 };
+    uint64_t wordCount { 0 };
+};
+
+static bool read_file(const std::filesystem::path& filePath, std::vector<uint8_t>* pData)
+{
+    assert(pData);
+    pData->clear();
+    std::ifstream file(filePath, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        return false;
+    }
+    pData->resize((size_t)file.tellg());
+    file.seekg(0);
+    file.read((char*)pData->data(), (std::streamsize)pData->size());
+    return file.good();
+}
+
+static bool write_file(const std::filesystem::path& filePath, std::span<const uint8_t> header, std::span<const uint8_t> data)
+{
+    // Write to a temporary file then rename it over filePath so a concurrent or
+    //  interrupted write never leaves a partial file where a reader can find it.
+    //  The temporary file's name is unique to this process and write so
+    //  concurrent writers of the same file never share a temporary file.
+    static std::atomic<uint64_t> sWriteCount;
+#ifdef _WIN32
+    auto processId = (uint64_t)_getpid();
+#else
+    auto processId = (uint64_t)getpid();
+#endif
+    auto temporaryFilePath = filePath;
+    temporaryFilePath += "." + std::to_string(processId) + "." + std::to_string(sWriteCount.fetch_add(1, std::memory_order_relaxed)) + ".tmp";
+    {
+        std::ofstream file(temporaryFilePath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            return false;
+        }
+        file.write((const char*)header.data(), (std::streamsize)header.size());
+        file.write((const char*)data.data(), (std::streamsize)data.size());
+        if (!file.good()) {
+            return false;
+        }
+    }
+    std::error_code errorCode;
+    std::filesystem::rename(temporaryFilePath, filePath, errorCode);
+    if (errorCode) {
+        std::filesystem::remove(temporaryFilePath, errorCode);
+        return false;
+    }
+    return true;
+}
+
+uint64_t ShaderCache::hash(std::span<const uint8_t> data, uint64_t seed)
+{
+    auto result = seed;
+    for (auto byte : data) {
+        result ^= byte;
+        result *= 1099511628211ull;
+    }
+    return result;
+}
+
+uint64_t ShaderCache::create_key(const gvk::spirv::ShaderInfo& shaderInfo, std::span<const std::string_view> defines)
+{
+    // Each variable length field is followed by its length so adjacent fields
+    //  can't run together, ie. defines { "AB" } and { "A", "B" } hash differently.
+    auto hash_value = [](auto value, uint64_t seed)
+    {
+        return hash({ (const uint8_t*)&value, sizeof(value) }, seed);
+    };
+    auto hash_string = [&](std::string_view string, uint64_t seed)
+    {
+        return hash_value((uint64_t)string.size(), hash({ (const uint8_t*)string.data(), string.size() }, seed));
+    };
+    auto key = hash_value(Version, hash({ }));
+    key = hash_value((uint32_t)shaderInfo.language, key);
+    key = hash_value((uint32_t)shaderInfo.stage, key);
+    key = hash_value((uint32_t)shaderInfo.lineOffset, key);
+    key = hash_string(shaderInfo.source, key);
+    for (auto define : defines) {
+        key = hash_string(define, key);
+    }
+    return hash_value((uint64_t)defines.size(), key);
+}
+
+bool ShaderCache::validate_pipeline_cache_data(std::span<const uint8_t> data, const VkPhysicalDeviceProperties& physicalDeviceProperties)
+{
+    // VkPipelineCacheHeaderVersionOne, 4 uint32_t fields followed by the UUID.
+    constexpr size_t HeaderSize = 4 * sizeof(uint32_t) + VK_UUID_SIZE;
+    if (data.size() < HeaderSize) {
+        return false;
+    }
+    uint32_t headerSize = 0;
+    uint32_t headerVersion = 0;
+    uint32_t vendorId = 0;
+    uint32_t deviceId = 0;
+    memcpy(&headerSize, data.data(), sizeof(uint32_t));
+    memcpy(&headerVersion, data.data() + 4, sizeof(uint32_t));
+    memcpy(&vendorId, data.data() + 8, sizeof(uint32_t));
+    memcpy(&deviceId, data.data() + 12, sizeof(uint32_t));
+    return
+        HeaderSize <= headerSize && headerSize <= data.size() &&
+        headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+        vendorId == physicalDeviceProperties.vendorID &&
+        deviceId == physicalDeviceProperties.deviceID &&
+        !memcmp(data.data() + 16, physicalDeviceProperties.pipelineCacheUUID, VK_UUID_SIZE);
+}
+
+bool ShaderCache::create(const CreateInfo* pCreateInfo, ShaderCache* pShaderCache)
+{
+    assert(pCreateInfo);
+    assert(!pCreateInfo->directory.empty());
+    assert(pShaderCache);
+    pShaderCache->reset();
+    std::error_code errorCode;
+    std::filesystem::create_directories(pCreateInfo->directory, errorCode);
+    if (errorCode || !std::filesystem::is_directory(pCreateInfo->directory, errorCode)) {
+        return false;
+    }
+    pShaderCache->mDirectory = pCreateInfo->directory;
+    return true;
+}
+
+const std::filesystem::path& ShaderCache::get_directory() const
+{
+    return mDirectory;
+}
+
+const ShaderCache::Statistics& ShaderCache::get_statistics() const
+{
+    return mStatistics;
+}
+
+bool ShaderCache::load(uint64_t key, std::vector<uint32_t>* pSpirv) const
+{
+    assert(!mDirectory.empty());
+    assert(pSpirv);
+    std::vector<uint8_t> data;
+    if (!read_file(get_spirv_path(key), &data) || data.size() < sizeof(SpirvHeader)) {
+        return false;
+    }
+    SpirvHeader header { };
+    memcpy(&header, data.data(), sizeof(SpirvHeader));
+    std::span<const uint8_t> spirvData(data.data() + sizeof(SpirvHeader), data.size() - sizeof(SpirvHeader));
+    if (header.magic != SpirvMagic ||
+        header.version != Version ||
+        header.key != key ||
+        header.wordCount * sizeof(uint32_t) != spirvData.size() ||
+        header.spirvHash != hash(spirvData)) {
+        return false;
+    }
+    pSpirv->resize(header.wordCount);
+    memcpy(pSpirv->data(), spirvData.data(), spirvData.size());
+    return true;
+}
+
+bool ShaderCache::store(uint64_t key, std::span<const uint32_t> spirv) const
+{
+    assert(!mDirectory.empty());
+    std::span<const uint8_t> spirvData((const uint8_t*)spirv.data(), spirv.size_bytes());
+    SpirvHeader header { };
+    header.key = key;
+    header.spirvHash = hash(spirvData);
+    header.wordCount = spirv.size();
+    return write_file(get_spirv_path(key), { (const uint8_t*)&header, sizeof(SpirvHeader) }, spirvData);
+}
+
+VkResult ShaderCache::create_pipeline_cache(const gvk::Device& device, gvk::PipelineCache* pPipelineCache) const
+{
+    assert(device);
+    assert(!mDirectory.empty());
+    assert(pPipelineCache);
+    VkPhysicalDeviceProperties physicalDeviceProperties { };
+    vkGetPhysicalDeviceProperties(device.get<gvk::PhysicalDevice>(), &physicalDeviceProperties);
+    std::vector<uint8_t> data;
+    auto pipelineCacheCreateInfo = gvk::get_default<VkPipelineCacheCreateInfo>();
+    if (read_file(get_pipeline_cache_path(), &data) && validate_pipeline_cache_data(data, physicalDeviceProperties)) {
+        pipelineCacheCreateInfo.initialDataSize = data.size();
+        pipelineCacheCreateInfo.pInitialData = data.data();
+    }
+    return gvk::PipelineCache::create(device, &pipelineCacheCreateInfo, nullptr, pPipelineCache);
+}
+
+VkResult ShaderCache::store_pipeline_cache(const gvk::PipelineCache& pipelineCache) const
+{
+    assert(pipelineCache);
+    assert(!mDirectory.empty());
+    gvk_result_scope_begin(VK_ERROR_INITIALIZATION_FAILED) {
+        const auto& device = pipelineCache.get<gvk::Device>();
+        size_t dataSize = 0;
+        gvk_result(vkGetPipelineCacheData(device, pipelineCache, &dataSize, nullptr));
+        std::vector<uint8_t> data(dataSize);
+        gvk_result(vkGetPipelineCacheData(device, pipelineCache, &dataSize, data.data()));
+        data.resize(dataSize);
+        gvk_result(write_file(get_pipeline_cache_path(), { }, data) ? VK_SUCCESS : VK_ERROR_INITIALIZATION_FAILED);
+    } gvk_result_scope_end;
+    return gvkResult;
+}
+
+void ShaderCache::reset()
+{
+    mDirectory.clear();
+    mStatistics = { };
+}
+
+std::filesystem::path ShaderCache::get_spirv_path(uint64_t key) const
+{
+    std::stringstream fileName;
+    fileName << std::hex << std::setw(16) << std::setfill('0') << key << ".spv";
+    return mDirectory / fileName.str();
+}
+
+std::filesystem::path ShaderCache::get_pipeline_cache_path() const
+{
+    return mDirectory / "pipeline-cache.bin";
+}
+
+} // namespace gfx
+} // namespace dst
@@ -0,0 +1,179 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#include "dynamic-static.graphics/uniform-ring.hpp"
+
+#include <algorithm>
+#include <bit>
+
+namespace dst {
+namespace gfx {
+
+void UniformRingAllocator::create(const CreateInfo* pCreateInfo, UniformRingAllocator* pUniformRingAllocator)
+{
+    assert(pCreateInfo);
+    assert(pCreateInfo->frameCount);
+    assert(pCreateInfo->frameSize);
+    assert(std::has_single_bit(pCreateInfo->alignment));
+    assert(pUniformRingAllocator);
+    pUniformRingAllocator->reset();
+    pUniformRingAllocator->mFrameCount = pCreateInfo->frameCount;
+    pUniformRingAllocator->mAlignment = pCreateInfo->alignment;
+    pUniformRingAllocator->mFrameSize = (pCreateInfo->frameSize + pCreateInfo->alignment - 1) & ~(pCreateInfo->alignment - 1);
+}
+
+uint32_t UniformRingAllocator::get_frame_count() const
+{
+    return mFrameCount;
+}
+
+uint64_t UniformRingAllocator::get_frame_size() const
+{
+    return mFrameSize;
+}
+
+uint64_t UniformRingAllocator::get_size() const
+{
+    return mFrameSize * mFrameCount;
+}
+
+uint32_t UniformRingAllocator::get_frame_index() const
+{
+    return mFrameIndex;
+}
+
+uint64_t UniformRingAllocator::get_frame_offset() const
+{
+    return mFrameSize * mFrameIndex;
+}
+
+uint64_t UniformRingAllocator::get_used_size() const
+{
+    return mUsedSize;
+}
+
+void UniformRingAllocator::begin_frame(uint32_t frameIndex)
+{
+    assert(frameIndex < mFrameCount);
+    mFrameIndex = frameIndex;
+    mUsedSize = 0;
+}
+
+bool UniformRingAllocator::allocate(uint64_t size, uint64_t* pOffset)
+{
+    assert(mFrameCount);
+    assert(pOffset);
+    auto alignedSize = (size + mAlignment - 1) & ~(mAlignment - 1);
+    if (mFrameSize - mUsedSize < alignedSize) {
+        return false;
+    }
+    *pOffset = get_frame_offset() + mUsedSize;
+    mUsedSize += alignedSize;
+    return true;
+}
+
+void UniformRingAllocator::reset()
+{
+    mFrameCount = 0;
+    mFrameSize = 0;
+    mAlignment = 1;
+    mFrameIndex = 0;
+    mUsedSize = 0;
+}
+
+VkResult UniformRing::create(const gvk::Device& device, const CreateInfo* pCreateInfo, UniformRing* pUniformRing)
+{
+    assert(device);
+    assert(pCreateInfo);
+    assert(pUniformRing);
+    pUniformRing->reset();
+    gvk_result_scope_begin(VK_ERROR_INITIALIZATION_FAILED) {
+        VkPhysicalDeviceProperties physicalDeviceProperties { };
+        vkGetPhysicalDeviceProperties(device.get<gvk::PhysicalDevice>(), &physicalDeviceProperties);
+        UniformRingAllocator::CreateInfo allocatorCreateInfo { };
+        allocatorCreateInfo.frameCount = pCreateInfo->frameCount;
+        allocatorCreateInfo.frameSize = pCreateInfo->frameSize;
+        allocatorCreateInfo.alignment = std::max(pCreateInfo->alignment, (uint64_t)physicalDeviceProperties.limits.minUniformBufferOffsetAlignment);
+        UniformRingAllocator::create(&allocatorCreateInfo, &pUniformRing->mAllocator);
+
+        auto bufferCreateInfo = gvk::get_default<VkBufferCreateInfo>();
+        bufferCreateInfo.size = pUniformRing->mAllocator.get_size();
+        bufferCreateInfo.usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | pCreateInfo->usage;
+        VmaAllocationCreateInfo vmaAllocationCreateInfo { };
+        vmaAllocationCreateInfo.flags = VMA_ALLOCATION_CREATE_MAPPED_BIT | VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT;
+        vmaAllocationCreateInfo.usage = VMA_MEMORY_USAGE_AUTO;
+        gvk_result(gvk::Buffer::create(device, &bufferCreateInfo, &vmaAllocationCreateInfo, &pUniformRing->mBuffer));
+
+        VmaAllocationInfo allocationInfo { };
+        vmaGetAllocationInfo(device.get<VmaAllocator>(), pUniformRing->mBuffer.get<VmaAllocation>(), &allocationInfo);
+        gvk_result(allocationInfo.pMappedData ? VK_SUCCESS : VK_ERROR_MEMORY_MAP_FAILED);
+        pUniformRing->mpMappedData = (uint8_t*)allocationInfo.pMappedData;
+    } gvk_result_scope_end;
+    if (gvkResult != VK_SUCCESS) {
+        pUniformRing->reset();
+    }
+    return gvkResult;
+}
+
+uint32_t UniformRing::get_frame_count() const
+{
+    return mAllocator.get_frame_count();
+}
+
+const gvk::Buffer& UniformRing::get_buffer() const
+{
+    return mBuffer;
+}
+
+const UniformRingAllocator& UniformRing::get_allocator() const
+{
+    return mAllocator;
+}
+
+void UniformRing::begin_frame(uint32_t frameIndex)
+{
+    mAllocator.begin_frame(frameIndex);
+}
+
+VkResult UniformRing::flush()
+{
+    assert(mBuffer);
+    if (!mAllocator.get_used_size()) {
+        return VK_SUCCESS;
+    }
+    const auto& device = mBuffer.get<gvk::Device>();
+    return vmaFlushAllocation(device.get<VmaAllocator>(), mBuffer.get<VmaAllocation>(), mAllocator.get_frame_offset(), mAllocator.get_used_size());
+}
+
+void UniformRing::reset()
+{
+    mBuffer = gvk::Buffer();
+    mpMappedData = nullptr;
+    mAllocator.reset();
+}
+
+} // namespace gfx
+} // namespace dst
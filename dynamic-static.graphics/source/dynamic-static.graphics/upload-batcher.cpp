@@ -0,0 +1,390 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+
+#include "dynamic-static.graphics/upload-batcher.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <memory_resource>
+
+namespace dst {
+namespace gfx {
+
+static VkResult create_device_local_buffer(const gvk::Device& device, VkDeviceSize size, VkBufferUsageFlags usage, gvk::Buffer* pBuffer)
+{
+    auto bufferCreateInfo = gvk::get_default<VkBufferCreateInfo>();
+    bufferCreateInfo.size = size;
+    bufferCreateInfo.usage = usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    VmaAllocationCreateInfo vmaAllocationCreateInfo { };
+    vmaAllocationCreateInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+    return gvk::Buffer::create(device, &bufferCreateInfo, &vmaAllocationCreateInfo, pBuffer);
+}
+
+void StagingRingAllocator::create(const CreateInfo* pCreateInfo, StagingRingAllocator* pStagingRingAllocator)
+{
+    assert(pCreateInfo);
+    assert(pCreateInfo->size);
+    assert(std::has_single_bit(pCreateInfo->alignment));
+    assert(pStagingRingAllocator);
+    pStagingRingAllocator->reset();
+    pStagingRingAllocator->mAlignment = pCreateInfo->alignment;
+    pStagingRingAllocator->mSize = (pCreateInfo->size + pCreateInfo->alignment - 1) & ~(pCreateInfo->alignment - 1);
+}
+
+uint64_t StagingRingAllocator::get_size() const
+{
+    return mSize;
+}
+
+uint64_t StagingRingAllocator::get_used_size() const
+{
+    return mHead - mTail;
+}
+
+uint64_t StagingRingAllocator::get_head() const
+{
+    return mHead;
+}
+
+bool StagingRingAllocator::allocate(uint64_t size, uint64_t* pOffset)
+{
+    assert(mSize);
+    assert(size <= mSize);
+    assert(pOffset);
+    if (mHead == mTail) {
+        // The ring is empty, restart at its beginning so any allocation fits.
+        mHead = (mHead + mSize - 1) / mSize * mSize;
+        mTail = mHead;
+    }
+    auto head = (mHead + mAlignment - 1) & ~(mAlignment - 1);
+    auto offset = head % mSize;
+    if (mSize - offset < size) {
+        head += mSize - offset;
+        offset = 0;
+    }
+    if (mSize < head + size - mTail) {
+        return false;
+    }
+    *pOffset = offset;
+    mHead = head + size;
+    return true;
+}
+
+void StagingRingAllocator::release(uint64_t head)
+{
+    assert(mTail <= head);
+    assert(head <= mHead);
+    mTail = head;
+}
+
+void StagingRingAllocator::reset()
+{
+    mSize = 0;
+    mAlignment = 1;
+    mHead = 0;
+    mTail = 0;
+}
+
+VkResult UploadBatcher::create(const gvk::Device& device, const gvk::Queue& queue, const CreateInfo* pCreateInfo, UploadBatcher* pUploadBatcher)
+{
+    assert(device);
+    assert(queue);
+    assert(pCreateInfo);
+    assert(pCreateInfo->batchCount);
+    assert(pUploadBatcher);
+    pUploadBatcher->reset();
+    gvk_result_scope_begin(VK_ERROR_INITIALIZATION_FAILED) {
+        pUploadBatcher->mDevice = device;
+        pUploadBatcher->mQueue = queue;
+        StagingRingAllocator::CreateInfo stagingRingAllocatorCreateInfo { };
+        stagingRingAllocatorCreateInfo.size = pCreateInfo->stagingSize;
+        StagingRingAllocator::create(&stagingRingAllocatorCreateInfo, &pUploadBatcher->mStagingRingAllocator);
+        FrameArena::CreateInfo frameArenaCreateInfo { };
+        frameArenaCreateInfo.blockSize = 64 * 1024;
+        FrameArena::create(&frameArenaCreateInfo, &pUploadBatcher->mFrameArena);
+
+        // Create a persistently mapped staging gvk::Buffer.
+        auto bufferCreateInfo = gvk::get_default<VkBufferCreateInfo>();
+        bufferCreateInfo.size = pUploadBatcher->mStagingRingAllocator.get_size();
+        bufferCreateInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+        VmaAllocationCreateInfo vmaAllocationCreateInfo { };
+        vmaAllocationCreateInfo.flags = VMA_ALLOCATION_CREATE_MAPPED_BIT | VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT;
+        vmaAllocationCreateInfo.usage = VMA_MEMORY_USAGE_AUTO;
+        gvk_result(gvk::Buffer::create(device, &bufferCreateInfo, &vmaAllocationCreateInfo, &pUploadBatcher->mStagingBuffer));
+        VmaAllocationInfo allocationInfo { };
+        vmaGetAllocationInfo(device.get<VmaAllocator>(), pUploadBatcher->mStagingBuffer.get<VmaAllocation>(), &allocationInfo);
+        gvk_result(allocationInfo.pMappedData ? VK_SUCCESS : VK_ERROR_MEMORY_MAP_FAILED);
+        pUploadBatcher->mpMappedData = (uint8_t*)allocationInfo.pMappedData;
+
+        // Create a gvk::CommandBuffer and gvk::Fence for each batch.
+        auto commandPoolCreateInfo = gvk::get_default<VkCommandPoolCreateInfo>();
+        commandPoolCreateInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+        commandPoolCreateInfo.queueFamilyIndex = queue.get<VkDeviceQueueCreateInfo>().queueFamilyIndex;
+        gvk_result(gvk::CommandPool::create(device, &commandPoolCreateInfo, nullptr, &pUploadBatcher->mCommandPool));
+        auto commandBufferAllocateInfo = gvk::get_default<VkCommandBufferAllocateInfo>();
+        commandBufferAllocateInfo.commandPool = pUploadBatcher->mCommandPool;
+        commandBufferAllocateInfo.commandBufferCount = pCreateInfo->batchCount;
+        std::vector<gvk::CommandBuffer> commandBuffers(pCreateInfo->batchCount);
+        gvk_result(gvk::CommandBuffer::allocate(device, &commandBufferAllocateInfo, commandBuffers.data()));
+        auto fenceResult = VK_SUCCESS;
+        pUploadBatcher->mBatches.resize(pCreateInfo->batchCount);
+        for (uint32_t batch_i = 0; batch_i < pCreateInfo->batchCount && fenceResult == VK_SUCCESS; ++batch_i) {
+            auto& batch = pUploadBatcher->mBatches[batch_i];
+            batch.commandBuffer = commandBuffers[batch_i];
+            fenceResult = gvk::Fence::create(device, &gvk::get_default<VkFenceCreateInfo>(), nullptr, &batch.fence);
+        }
+        gvk_result(fenceResult);
+    } gvk_result_scope_end;
+    if (gvkResult != VK_SUCCESS) {
+        pUploadBatcher->reset();
+    }
+    return gvkResult;
+}
+
+UploadBatcher::~UploadBatcher()
+{
+    reset();
+}
+
+const UploadBatcher::Statistics& UploadBatcher::get_statistics() const
+{
+    return mStatistics;
+}
+
+uint64_t UploadBatcher::get_token() const
+{
+    return mToken;
+}
+
+VkResult UploadBatcher::write(const gvk::Buffer& buffer, VkDeviceSize offset, std::span<const uint8_t> data, uint64_t* pToken)
+{
+    assert(mpMappedData);
+    assert(buffer);
+    auto vkResult = VK_SUCCESS;
+    while (vkResult == VK_SUCCESS && !data.empty()) {
+        // Uploads larger than the staging ring are split into ring sized copies.
+        auto size = std::min((uint64_t)data.size(), mStagingRingAllocator.get_size());
+        uint64_t stagingOffset = 0;
+        vkResult = allocate(size, &stagingOffset);
+        if (vkResult == VK_SUCCESS) {
+            memcpy(mpMappedData + stagingOffset, data.data(), size);
+            mCopies.push_back({ buffer, { stagingOffset, offset, size } });
+            auto& buffers = get_batch(mToken).buffers;
+            if (buffers.empty() || (VkBuffer)buffers.back() != (VkBuffer)buffer) {
+                buffers.push_back(buffer);
+            }
+            ++mStatistics.copyCount;
+            mStatistics.byteCount += size;
+            data = data.subspan(size);
+            offset += size;
+        }
+    }
+    if (pToken) {
+        *pToken = mToken;
+    }
+    return vkResult;
+}
+
+VkResult UploadBatcher::submit()
+{
+    assert(mDevice);
+    if (mCopies.empty()) {
+        return VK_SUCCESS;
+    }
+    gvk_result_scope_begin(VK_ERROR_INITIALIZATION_FAILED) {
+        // Sort copies by destination so each destination gets one
+        //  vkCmdCopyBuffer(), regions contiguous in both buffers are merged.
+        std::stable_sort(mCopies.begin(), mCopies.end(), [](const auto& lhs, const auto& rhs) { return lhs.buffer < rhs.buffer; });
+        auto& batch = get_batch(mToken);
+        auto commandBufferBeginInfo = gvk::get_default<VkCommandBufferBeginInfo>();
+        commandBufferBeginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        gvk_result(vkBeginCommandBuffer(batch.commandBuffer, &commandBufferBeginInfo));
+        mFrameArena.clear();
+        std::pmr::vector<VkBufferCopy> regions(&mFrameArena);
+        regions.reserve(mCopies.size());
+        for (size_t copy_i = 0; copy_i < mCopies.size();) {
+            auto buffer = mCopies[copy_i].buffer;
+            regions.clear();
+            for (; copy_i < mCopies.size() && mCopies[copy_i].buffer == buffer; ++copy_i) {
+                const auto& region = mCopies[copy_i].region;
+                if (!regions.empty() &&
+                    regions.back().srcOffset + regions.back().size == region.srcOffset &&
+                    regions.back().dstOffset + regions.back().size == region.dstOffset) {
+                    regions.back().size += region.size;
+                } else {
+                    regions.push_back(region);
+                }
+            }
+            vkCmdCopyBuffer(batch.commandBuffer, mStagingBuffer, buffer, (uint32_t)regions.size(), regions.data());
+        }
+
+        // Make the copies visible to any read in later submissions to the queue.
+        auto memoryBarrier = gvk::get_default<VkMemoryBarrier>();
+        memoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        memoryBarrier.dstAccessMask =
+            VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT |
+            VK_ACCESS_INDEX_READ_BIT |
+            VK_ACCESS_UNIFORM_READ_BIT |
+            VK_ACCESS_SHADER_READ_BIT |
+            VK_ACCESS_TRANSFER_READ_BIT;
+        vkCmdPipelineBarrier(batch.commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 1, &memoryBarrier, 0, nullptr, 0, nullptr);
+        gvk_result(vkEndCommandBuffer(batch.commandBuffer));
+        gvk_result(vmaFlushAllocation(mDevice.get<VmaAllocator>(), mStagingBuffer.get<VmaAllocation>(), 0, VK_WHOLE_SIZE));
+        gvk_result(vkResetFences(mDevice, 1, &batch.fence.get<const VkFence&>()));
+        auto submitInfo = gvk::get_default<VkSubmitInfo>();
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers = &batch.commandBuffer.get<const VkCommandBuffer&>();
+        gvk_result(vkQueueSubmit(mQueue, 1, &submitInfo, batch.fence));
+        batch.token = mToken;
+        batch.stagingHead = mStagingRingAllocator.get_head();
+        ++mToken;
+        ++mStatistics.submitCount;
+        mCopies.clear();
+    } gvk_result_scope_end;
+    return gvkResult;
+}
+
+bool UploadBatcher::is_complete(uint64_t token)
+{
+    assert(mDevice);
+    retire_batches(0);
+    return token <= mCompletedToken;
+}
+
+VkResult UploadBatcher::wait(uint64_t token)
+{
+    assert(mDevice);
+    assert(token <= mToken);
+    gvk_result_scope_begin(VK_ERROR_INITIALIZATION_FAILED) {
+        if (token == mToken) {
+            gvk_result(submit());
+        }
+        gvk_result(retire_batches(token));
+    } gvk_result_scope_end;
+    return gvkResult;
+}
+
+void UploadBatcher::reset()
+{
+    // Pending copies are discarded, submitted batches are waited on so their
+    //  resources aren't destroyed while in use.
+    if (mDevice) {
+        retire_batches(mToken - 1);
+    }
+    mDevice = gvk::Device();
+    mQueue = gvk::Queue();
+    mCommandPool = gvk::CommandPool();
+    mStagingBuffer = gvk::Buffer();
+    mpMappedData = nullptr;
+    mStagingRingAllocator.reset();
+    mFrameArena.reset();
+    mBatches.clear();
+    mCopies.clear();
+    mToken = 1;
+    mCompletedToken = 0;
+    mStatistics = { };
+}
+
+VkResult UploadBatcher::allocate(uint64_t size, uint64_t* pOffset)
+{
+    assert(pOffset);
+    gvk_result_scope_begin(VK_ERROR_INITIALIZATION_FAILED) {
+        // When the ring is full submit pending copies so their staging memory can
+        //  be reclaimed, then wait for the oldest batch.  An empty ring fits any
+        //  allocation so this terminates once every batch has been retired.
+        while (!mStagingRingAllocator.allocate(size, pOffset)) {
+            auto vkResult = submit();
+            if (vkResult == VK_SUCCESS) {
+                assert(mCompletedToken + 1 < mToken);
+                vkResult = retire_batches(mCompletedToken + 1);
+            }
+            if (vkResult != VK_SUCCESS) {
+                gvkResult = vkResult;
+                break;
+            }
+        }
+        gvk_result(gvkResult);
+
+        // The first copy in a batch waits for the batch that last used its slot.
+        auto batchCount = (uint64_t)mBatches.size();
+        if (mCopies.empty() && batchCount < mToken) {
+            gvk_result(retire_batches(mToken - batchCount));
+        }
+    } gvk_result_scope_end;
+    return gvkResult;
+}
+
+VkResult UploadBatcher::retire_batches(uint64_t waitToken)
+{
+    while (mCompletedToken + 1 < mToken) {
+        auto& batch = get_batch(mCompletedToken + 1);
+        auto vkResult = vkGetFenceStatus(mDevice, batch.fence);
+        if (vkResult == VK_NOT_READY && batch.token <= waitToken) {
+            ++mStatistics.waitCount;
+            vkResult = vkWaitForFences(mDevice, 1, &batch.fence.get<const VkFence&>(), VK_TRUE, UINT64_MAX);
+        }
+        if (vkResult == VK_NOT_READY) {
+            break;
+        }
+        if (vkResult != VK_SUCCESS) {
+            return vkResult;
+        }
+        mStagingRingAllocator.release(batch.stagingHead);
+        batch.buffers.clear();
+        mCompletedToken = batch.token;
+    }
+    return VK_SUCCESS;
+}
+
+UploadBatcher::Batch& UploadBatcher::get_batch(uint64_t token)
+{
+    assert(!mBatches.empty());
+    return mBatches[token % mBatches.size()];
+}
+
+VkResult UploadBatcher::write_mesh(std::span<const uint8_t> vertexData, uint32_t vertexCount, std::span<const uint8_t> indexData, uint32_t indexCount, VkIndexType indexType, Mesh* pMesh, uint64_t* pToken)
+{
+    assert(mDevice);
+    assert(!vertexData.empty());
+    assert(!indexData.empty());
+    assert(pMesh);
+    gvk_result_scope_begin(VK_ERROR_INITIALIZATION_FAILED) {
+        *pMesh = { };
+        gvk_result(create_device_local_buffer(mDevice, vertexData.size(), VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, &pMesh->vertexBuffer));
+        gvk_result(create_device_local_buffer(mDevice, indexData.size(), VK_BUFFER_USAGE_INDEX_BUFFER_BIT, &pMesh->indexBuffer));
+        gvk_result(write(pMesh->vertexBuffer, 0, vertexData, pToken));
+        gvk_result(write(pMesh->indexBuffer, 0, indexData, pToken));
+        pMesh->vertexCount = vertexCount;
+        pMesh->indexCount = indexCount;
+        pMesh->indexType = indexType;
+    } gvk_result_scope_end;
+    return gvkResult;
+}
+
+} // namespace gfx
+} // namespace dst
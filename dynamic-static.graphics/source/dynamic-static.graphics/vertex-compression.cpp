@@ -0,0 +1,380 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#include "dynamic-static.graphics/vertex-compression.hpp"
+
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && 2 <= _M_IX86_FP)
+#define DST_VERTEX_COMPRESSION_SSE2
+#include <emmintrin.h>
+#endif
+#if defined(__F16C__)
+#define DST_VERTEX_COMPRESSION_F16C
+#include <immintrin.h>
+#endif
+
+namespace dst {
+namespace gfx {
+
+using detail::get_element;
+
+#ifdef DST_VERTEX_COMPRESSION_SSE2
+// Loads four strided 32 bit elements into one register without going through
+//  memory, a stack array would stall on the wide reload.
+template <typename T>
+static inline __m128i load_4x32(const T* pElements, size_t stride, size_t i)
+{
+    static_assert(sizeof(T) == sizeof(int32_t));
+    int32_t bits[4] { };
+    for (size_t j = 0; j < 4; ++j) {
+        memcpy(&bits[j], &get_element(pElements, stride, i + j), sizeof(T));
+    }
+    auto bits01 = _mm_unpacklo_epi32(_mm_cvtsi32_si128(bits[0]), _mm_cvtsi32_si128(bits[1]));
+    auto bits23 = _mm_unpacklo_epi32(_mm_cvtsi32_si128(bits[2]), _mm_cvtsi32_si128(bits[3]));
+    return _mm_unpacklo_epi64(bits01, bits23);
+}
+#endif
+
+QuantizationBounds compute_quantization_bounds(size_t count, const glm::vec3* pPositions, size_t stride)
+{
+    assert(!count || pPositions);
+    if (!count) {
+        return { };
+    }
+    auto min = glm::vec3 { std::numeric_limits<float>::max() };
+    auto max = glm::vec3 { std::numeric_limits<float>::lowest() };
+    for (size_t i = 0; i < count; ++i) {
+        const auto& position = get_element(pPositions, stride, i);
+        min = glm::min(min, position);
+        max = glm::max(max, position);
+    }
+    return { .min = min, .extent = max - min };
+}
+
+glm::mat4 get_dequantization_matrix(const QuantizationBounds& bounds)
+{
+    glm::mat4 dequantization(1.0f);
+    dequantization[0][0] = bounds.extent.x;
+    dequantization[1][1] = bounds.extent.y;
+    dequantization[2][2] = bounds.extent.z;
+    dequantization[3] = glm::vec4(bounds.min, 1.0f);
+    return dequantization;
+}
+
+void pack_positions(size_t count, const glm::vec3* pPositions, size_t stride, const QuantizationBounds& bounds, Unorm16x4* pPackedPositions, size_t packedStride)
+{
+    assert(!count || (pPositions && pPackedPositions));
+    size_t i = 0;
+#ifdef DST_VERTEX_COMPRESSION_SSE2
+    auto get_scale = [](float extent) { return 0 < extent ? 1.0f / extent : 0.0f; };
+    const auto minX = _mm_set1_ps(bounds.min.x);
+    const auto minY = _mm_set1_ps(bounds.min.y);
+    const auto minZ = _mm_set1_ps(bounds.min.z);
+    const auto scaleX = _mm_set1_ps(get_scale(bounds.extent.x));
+    const auto scaleY = _mm_set1_ps(get_scale(bounds.extent.y));
+    const auto scaleZ = _mm_set1_ps(get_scale(bounds.extent.z));
+    const auto zero = _mm_setzero_ps();
+    const auto one = _mm_set1_ps(1.0f);
+    const auto unormMax = _mm_set1_ps(65535.0f);
+    const auto bias = _mm_set1_epi32(32768);
+    const auto signBit = _mm_set1_epi16((short)0x8000);
+    auto quantize = [&](__m128 value, __m128 min, __m128 scale)
+    {
+        value = _mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_sub_ps(value, min), scale), zero), one), unormMax);
+        // SSE2 doesn't have an unsigned 32 to 16 bit pack, bias into signed range,
+        //  pack with signed saturation, then flip the sign bit back.
+        auto quantized = _mm_sub_epi32(_mm_cvtps_epi32(value), bias);
+        return _mm_xor_si128(_mm_packs_epi32(quantized, quantized), signBit);
+    };
+    for (; i + 4 <= count; i += 4) {
+        const auto& p0 = get_element(pPositions, stride, i + 0);
+        const auto& p1 = get_element(pPositions, stride, i + 1);
+        const auto& p2 = get_element(pPositions, stride, i + 2);
+        const auto& p3 = get_element(pPositions, stride, i + 3);
+        auto x = quantize(_mm_setr_ps(p0.x, p1.x, p2.x, p3.x), minX, scaleX);
+        auto y = quantize(_mm_setr_ps(p0.y, p1.y, p2.y, p3.y), minY, scaleY);
+        auto z = quantize(_mm_setr_ps(p0.z, p1.z, p2.z, p3.z), minZ, scaleZ);
+
+        // Interleave back to xyzw with w zeroed, two vertices per register.
+        auto xy = _mm_unpacklo_epi16(x, y);
+        auto zw = _mm_unpacklo_epi16(z, _mm_setzero_si128());
+        auto packed01 = _mm_unpacklo_epi32(xy, zw);
+        auto packed23 = _mm_unpackhi_epi32(xy, zw);
+        _mm_storel_epi64((__m128i*)&get_element(pPackedPositions, packedStride, i + 0), packed01);
+        _mm_storel_epi64((__m128i*)&get_element(pPackedPositions, packedStride, i + 1), _mm_srli_si128(packed01, 8));
+        _mm_storel_epi64((__m128i*)&get_element(pPackedPositions, packedStride, i + 2), packed23);
+        _mm_storel_epi64((__m128i*)&get_element(pPackedPositions, packedStride, i + 3), _mm_srli_si128(packed23, 8));
+    }
+#endif
+    for (; i < count; ++i) {
+        get_element(pPackedPositions, packedStride, i) = pack_position(get_element(pPositions, stride, i), bounds);
+    }
+}
+
+void unpack_positions(size_t count, const Unorm16x4* pPackedPositions, size_t packedStride, const QuantizationBounds& bounds, glm::vec3* pPositions, size_t stride)
+{
+    assert(!count || (pPackedPositions && pPositions));
+    size_t i = 0;
+#ifdef DST_VERTEX_COMPRESSION_SSE2
+    const auto minX = _mm_set1_ps(bounds.min.x);
+    const auto minY = _mm_set1_ps(bounds.min.y);
+    const auto minZ = _mm_set1_ps(bounds.min.z);
+    const auto extentX = _mm_set1_ps(bounds.extent.x);
+    const auto extentY = _mm_set1_ps(bounds.extent.y);
+    const auto extentZ = _mm_set1_ps(bounds.extent.z);
+    const auto unormMax = _mm_set1_ps(65535.0f);
+    const auto zero = _mm_setzero_si128();
+    auto dequantize = [&](__m128i quantized, __m128 min, __m128 extent)
+    {
+        return _mm_add_ps(_mm_mul_ps(_mm_div_ps(_mm_cvtepi32_ps(quantized), unormMax), extent), min);
+    };
+    for (; i + 4 <= count; i += 4) {
+        auto packed01 = _mm_unpacklo_epi64(
+            _mm_loadl_epi64((const __m128i*)&get_element(pPackedPositions, packedStride, i + 0)),
+            _mm_loadl_epi64((const __m128i*)&get_element(pPackedPositions, packedStride, i + 1))
+        );
+        auto packed23 = _mm_unpacklo_epi64(
+            _mm_loadl_epi64((const __m128i*)&get_element(pPackedPositions, packedStride, i + 2)),
+            _mm_loadl_epi64((const __m128i*)&get_element(pPackedPositions, packedStride, i + 3))
+        );
+
+        // Transpose xyzw pairs into x0x1x2x3y0y1y2y3 and z0z1z2z3w0w1w2w3.
+        auto packed02 = _mm_unpacklo_epi16(packed01, packed23);
+        auto packed13 = _mm_unpackhi_epi16(packed01, packed23);
+        auto xy = _mm_unpacklo_epi16(packed02, packed13);
+        auto zw = _mm_unpackhi_epi16(packed02, packed13);
+        auto x = dequantize(_mm_unpacklo_epi16(xy, zero), minX, extentX);
+        auto y = dequantize(_mm_unpackhi_epi16(xy, zero), minY, extentY);
+        auto z = dequantize(_mm_unpacklo_epi16(zw, zero), minZ, extentZ);
+        auto w = _mm_setzero_ps();
+        _MM_TRANSPOSE4_PS(x, y, z, w);
+        auto store = [&](size_t j, __m128 position)
+        {
+            auto& result = get_element(pPositions, stride, i + j);
+            _mm_storel_pi((__m64*)&result.x, position);
+            _mm_store_ss(&result.z, _mm_movehl_ps(position, position));
+        };
+        store(0, x);
+        store(1, y);
+        store(2, z);
+        store(3, w);
+    }
+#endif
+    for (; i < count; ++i) {
+        get_element(pPositions, stride, i) = unpack_position(get_element(pPackedPositions, packedStride, i), bounds);
+    }
+}
+
+void pack_normals(size_t count, const glm::vec3* pNormals, size_t stride, Snorm16x2* pPackedNormals, size_t packedStride)
+{
+    assert(!count || (pNormals && pPackedNormals));
+    size_t i = 0;
+#ifdef DST_VERTEX_COMPRESSION_SSE2
+    const auto zero = _mm_setzero_ps();
+    const auto one = _mm_set1_ps(1.0f);
+    const auto negativeOne = _mm_set1_ps(-1.0f);
+    const auto snormMax = _mm_set1_ps(32767.0f);
+    const auto signMask = _mm_set1_ps(-0.0f);
+    for (; i + 4 <= count; i += 4) {
+        const auto& n0 = get_element(pNormals, stride, i + 0);
+        const auto& n1 = get_element(pNormals, stride, i + 1);
+        const auto& n2 = get_element(pNormals, stride, i + 2);
+        const auto& n3 = get_element(pNormals, stride, i + 3);
+        auto x = _mm_setr_ps(n0.x, n1.x, n2.x, n3.x);
+        auto y = _mm_setr_ps(n0.y, n1.y, n2.y, n3.y);
+        auto z = _mm_setr_ps(n0.z, n1.z, n2.z, n3.z);
+
+        // Project onto the octahedron then fold the lower hemisphere.
+        auto l1Norm = _mm_add_ps(_mm_add_ps(_mm_andnot_ps(signMask, x), _mm_andnot_ps(signMask, y)), _mm_andnot_ps(signMask, z));
+        auto valid = _mm_cmpgt_ps(l1Norm, zero);
+        auto safeL1Norm = _mm_or_ps(_mm_and_ps(valid, l1Norm), _mm_andnot_ps(valid, one));
+        x = _mm_and_ps(valid, _mm_div_ps(x, safeL1Norm));
+        y = _mm_and_ps(valid, _mm_div_ps(y, safeL1Norm));
+        auto foldedX = _mm_mul_ps(_mm_sub_ps(one, _mm_andnot_ps(signMask, y)), _mm_or_ps(_mm_and_ps(signMask, x), one));
+        auto foldedY = _mm_mul_ps(_mm_sub_ps(one, _mm_andnot_ps(signMask, x)), _mm_or_ps(_mm_and_ps(signMask, y), one));
+        auto fold = _mm_cmplt_ps(z, zero);
+        x = _mm_or_ps(_mm_and_ps(fold, foldedX), _mm_andnot_ps(fold, x));
+        y = _mm_or_ps(_mm_and_ps(fold, foldedY), _mm_andnot_ps(fold, y));
+
+        auto quantizedX = _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(x, negativeOne), one), snormMax));
+        auto quantizedY = _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(y, negativeOne), one), snormMax));
+        auto packed = _mm_unpacklo_epi16(_mm_packs_epi32(quantizedX, quantizedX), _mm_packs_epi32(quantizedY, quantizedY));
+        for (size_t j = 0; j < 4; ++j) {
+            auto bits = _mm_cvtsi128_si32(packed);
+            memcpy(&get_element(pPackedNormals, packedStride, i + j), &bits, sizeof(Snorm16x2));
+            packed = _mm_srli_si128(packed, 4);
+        }
+    }
+#endif
+    for (; i < count; ++i) {
+        get_element(pPackedNormals, packedStride, i) = pack_normal(get_element(pNormals, stride, i));
+    }
+}
+
+void unpack_normals(size_t count, const Snorm16x2* pPackedNormals, size_t packedStride, glm::vec3* pNormals, size_t stride)
+{
+    assert(!count || (pPackedNormals && pNormals));
+    size_t i = 0;
+#ifdef DST_VERTEX_COMPRESSION_SSE2
+    const auto zero = _mm_setzero_ps();
+    const auto one = _mm_set1_ps(1.0f);
+    const auto negativeOne = _mm_set1_ps(-1.0f);
+    const auto snormMax = _mm_set1_ps(32767.0f);
+    const auto signMask = _mm_set1_ps(-0.0f);
+    for (; i + 4 <= count; i += 4) {
+        auto packed = load_4x32(pPackedNormals, packedStride, i);
+        auto x = _mm_max_ps(_mm_div_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_slli_epi32(packed, 16), 16)), snormMax), negativeOne);
+        auto y = _mm_max_ps(_mm_div_ps(_mm_cvtepi32_ps(_mm_srai_epi32(packed, 16)), snormMax), negativeOne);
+        auto z = _mm_sub_ps(_mm_sub_ps(one, _mm_andnot_ps(signMask, x)), _mm_andnot_ps(signMask, y));
+        auto t = _mm_max_ps(_mm_sub_ps(zero, z), zero);
+        auto negativeT = _mm_sub_ps(zero, t);
+        auto positiveX = _mm_cmpge_ps(x, zero);
+        auto positiveY = _mm_cmpge_ps(y, zero);
+        x = _mm_add_ps(x, _mm_or_ps(_mm_and_ps(positiveX, negativeT), _mm_andnot_ps(positiveX, t)));
+        y = _mm_add_ps(y, _mm_or_ps(_mm_and_ps(positiveY, negativeT), _mm_andnot_ps(positiveY, t)));
+        auto inverseLength = _mm_div_ps(one, _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z))));
+        alignas(16) float results[3][4];
+        _mm_store_ps(results[0], _mm_mul_ps(x, inverseLength));
+        _mm_store_ps(results[1], _mm_mul_ps(y, inverseLength));
+        _mm_store_ps(results[2], _mm_mul_ps(z, inverseLength));
+        for (size_t j = 0; j < 4; ++j) {
+            get_element(pNormals, stride, i + j) = { results[0][j], results[1][j], results[2][j] };
+        }
+    }
+#endif
+    for (; i < count; ++i) {
+        get_element(pNormals, stride, i) = unpack_normal(get_element(pPackedNormals, packedStride, i));
+    }
+}
+
+void pack_texcoords(size_t count, const glm::vec2* pTexcoords, size_t stride, Half2* pPackedTexcoords, size_t packedStride)
+{
+    assert(!count || (pTexcoords && pPackedTexcoords));
+    size_t i = 0;
+#ifdef DST_VERTEX_COMPRESSION_F16C
+    for (; i + 2 <= count; i += 2) {
+        const auto& t0 = get_element(pTexcoords, stride, i + 0);
+        const auto& t1 = get_element(pTexcoords, stride, i + 1);
+        auto packed = _mm_cvtps_ph(_mm_setr_ps(t0.x, t0.y, t1.x, t1.y), _MM_FROUND_TO_NEAREST_INT);
+        int32_t bits[2] { _mm_cvtsi128_si32(packed), _mm_cvtsi128_si32(_mm_srli_si128(packed, 4)) };
+        memcpy(&get_element(pPackedTexcoords, packedStride, i + 0), &bits[0], sizeof(Half2));
+        memcpy(&get_element(pPackedTexcoords, packedStride, i + 1), &bits[1], sizeof(Half2));
+    }
+#endif
+    for (; i < count; ++i) {
+        get_element(pPackedTexcoords, packedStride, i) = pack_texcoord(get_element(pTexcoords, stride, i));
+    }
+}
+
+void unpack_texcoords(size_t count, const Half2* pPackedTexcoords, size_t packedStride, glm::vec2* pTexcoords, size_t stride)
+{
+    assert(!count || (pPackedTexcoords && pTexcoords));
+    size_t i = 0;
+#ifdef DST_VERTEX_COMPRESSION_F16C
+    for (; i + 2 <= count; i += 2) {
+        int32_t bits[2] { };
+        memcpy(&bits[0], &get_element(pPackedTexcoords, packedStride, i + 0), sizeof(Half2));
+        memcpy(&bits[1], &get_element(pPackedTexcoords, packedStride, i + 1), sizeof(Half2));
+        alignas(16) float results[4];
+        _mm_store_ps(results, _mm_cvtph_ps(_mm_setr_epi32(bits[0], bits[1], 0, 0)));
+        get_element(pTexcoords, stride, i + 0) = { results[0], results[1] };
+        get_element(pTexcoords, stride, i + 1) = { results[2], results[3] };
+    }
+#endif
+    for (; i < count; ++i) {
+        get_element(pTexcoords, stride, i) = unpack_texcoord(get_element(pPackedTexcoords, packedStride, i));
+    }
+}
+
+void pack_colors(size_t count, const glm::vec4* pColors, size_t stride, Unorm8x4* pPackedColors, size_t packedStride)
+{
+    assert(!count || (pColors && pPackedColors));
+    size_t i = 0;
+#ifdef DST_VERTEX_COMPRESSION_SSE2
+    const auto zero = _mm_setzero_ps();
+    const auto one = _mm_set1_ps(1.0f);
+    const auto unormMax = _mm_set1_ps(255.0f);
+    auto quantize = [&](__m128 value)
+    {
+        return _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(value, zero), one), unormMax));
+    };
+    for (; i + 4 <= count; i += 4) {
+        auto r = _mm_loadu_ps(&get_element(pColors, stride, i + 0).x);
+        auto g = _mm_loadu_ps(&get_element(pColors, stride, i + 1).x);
+        auto b = _mm_loadu_ps(&get_element(pColors, stride, i + 2).x);
+        auto a = _mm_loadu_ps(&get_element(pColors, stride, i + 3).x);
+        _MM_TRANSPOSE4_PS(r, g, b, a);
+
+        // Each channel is quantized to [0, 255] so they can be shifted into place
+        //  without packing.
+        auto packed = _mm_or_si128(
+            _mm_or_si128(quantize(r), _mm_slli_epi32(quantize(g), 8)),
+            _mm_or_si128(_mm_slli_epi32(quantize(b), 16), _mm_slli_epi32(quantize(a), 24))
+        );
+        alignas(16) int32_t bits[4];
+        _mm_store_si128((__m128i*)bits, packed);
+        for (size_t j = 0; j < 4; ++j) {
+            memcpy(&get_element(pPackedColors, packedStride, i + j), &bits[j], sizeof(Unorm8x4));
+        }
+    }
+#endif
+    for (; i < count; ++i) {
+        get_element(pPackedColors, packedStride, i) = pack_color(get_element(pColors, stride, i));
+    }
+}
+
+void unpack_colors(size_t count, const Unorm8x4* pPackedColors, size_t packedStride, glm::vec4* pColors, size_t stride)
+{
+    assert(!count || (pPackedColors && pColors));
+    size_t i = 0;
+#ifdef DST_VERTEX_COMPRESSION_SSE2
+    const auto channelMask = _mm_set1_epi32(0xff);
+    const auto unormMax = _mm_set1_ps(255.0f);
+    auto dequantize = [&](__m128i quantized)
+    {
+        return _mm_div_ps(_mm_cvtepi32_ps(_mm_and_si128(quantized, channelMask)), unormMax);
+    };
+    for (; i + 4 <= count; i += 4) {
+        auto packed = load_4x32(pPackedColors, packedStride, i);
+        auto r = dequantize(packed);
+        auto g = dequantize(_mm_srli_epi32(packed, 8));
+        auto b = dequantize(_mm_srli_epi32(packed, 16));
+        auto a = dequantize(_mm_srli_epi32(packed, 24));
+        _MM_TRANSPOSE4_PS(r, g, b, a);
+        _mm_storeu_ps(&get_element(pColors, stride, i + 0).x, r);
+        _mm_storeu_ps(&get_element(pColors, stride, i + 1).x, g);
+        _mm_storeu_ps(&get_element(pColors, stride, i + 2).x, b);
+        _mm_storeu_ps(&get_element(pColors, stride, i + 3).x, a);
+    }
+#endif
+    for (; i < count; ++i) {
+        get_element(pColors, stride, i) = unpack_color(get_element(pPackedColors, packedStride, i));
+    }
+}
+
+} // namespace gfx
+} // namespace dst
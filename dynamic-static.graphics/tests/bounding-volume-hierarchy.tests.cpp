@@ -0,0 +1,190 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+
+#include "dynamic-static.graphics/bounding-volume-hierarchy.hpp"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace dst {
+namespace gfx {
+namespace tests {
+
+static BoundingVolumeHierarchy::Aabb create_random_aabb(std::mt19937& generator)
+{
+    std::uniform_real_distribution<float> positionDistribution(-100, 100);
+    std::uniform_real_distribution<float> extentDistribution(0.1f, 2);
+    glm::vec3 position { positionDistribution(generator), positionDistribution(generator), positionDistribution(generator) };
+    glm::vec3 extents { extentDistribution(generator), extentDistribution(generator), extentDistribution(generator) };
+    return { position - extents, position + extents };
+}
+
+static Frustum create_test_frustum(const glm::vec3& eye, const glm::vec3& center)
+{
+    return make_frustum(glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 80.0f) * glm::lookAt(eye, center, { 0, 1, 0 }));
+}
+
+static std::vector<uint32_t> cull_brute_force(const BoundingVolumeHierarchy& boundingVolumeHierarchy, const std::vector<BoundingVolumeHierarchy::ProxyId>& proxyIds, const Frustum& frustum)
+{
+    std::vector<uint32_t> indices;
+    for (auto proxyId : proxyIds) {
+        const auto& aabb = boundingVolumeHierarchy.get_aabb(proxyId);
+        if (intersects_aabb(frustum, aabb.min, aabb.max)) {
+            indices.push_back(boundingVolumeHierarchy.get_index(proxyId));
+        }
+    }
+    std::sort(indices.begin(), indices.end());
+    return indices;
+}
+
+static std::vector<uint32_t> cull_sorted(BoundingVolumeHierarchy& boundingVolumeHierarchy, const Frustum& frustum)
+{
+    std::vector<uint32_t> indices;
+    boundingVolumeHierarchy.cull(frustum, &indices);
+    std::sort(indices.begin(), indices.end());
+    return indices;
+}
+
+TEST(BoundingVolumeHierarchy, Cull)
+{
+    BoundingVolumeHierarchy::CreateInfo boundingVolumeHierarchyCreateInfo { };
+    BoundingVolumeHierarchy boundingVolumeHierarchy;
+    BoundingVolumeHierarchy::create(&boundingVolumeHierarchyCreateInfo, &boundingVolumeHierarchy);
+    std::vector<uint32_t> indices;
+    boundingVolumeHierarchy.cull(create_test_frustum({ 0, 0, 0 }, { 0, 0, -1 }), &indices);
+    EXPECT_TRUE(indices.empty());
+
+    std::mt19937 generator(5);
+    std::vector<BoundingVolumeHierarchy::ProxyId> proxyIds;
+    for (uint32_t i = 0; i < 4096; ++i) {
+        proxyIds.push_back(boundingVolumeHierarchy.create_proxy(create_random_aabb(generator), i));
+    }
+    EXPECT_EQ(boundingVolumeHierarchy.get_proxy_count(), 4096u);
+
+    // Rotations keep the tree balanced so its height stays logarithmic.
+    EXPECT_LE(boundingVolumeHierarchy.get_height(), 24);
+
+    // Culling the same view twice exercises the cached rejecting planes.
+    std::uniform_real_distribution<float> distribution(-100, 100);
+    for (int i = 0; i < 16; ++i) {
+        glm::vec3 eye { distribution(generator), distribution(generator), distribution(generator) };
+        glm::vec3 center { distribution(generator), distribution(generator), distribution(generator) };
+        auto frustum = create_test_frustum(eye, center);
+        auto expected = cull_brute_force(boundingVolumeHierarchy, proxyIds, frustum);
+        EXPECT_FALSE(expected.empty());
+        EXPECT_EQ(cull_sorted(boundingVolumeHierarchy, frustum), expected);
+        EXPECT_EQ(cull_sorted(boundingVolumeHierarchy, frustum), expected);
+    }
+}
+
+TEST(BoundingVolumeHierarchy, Update)
+{
+    BoundingVolumeHierarchy::CreateInfo boundingVolumeHierarchyCreateInfo { };
+    boundingVolumeHierarchyCreateInfo.margin = 0.5f;
+    BoundingVolumeHierarchy boundingVolumeHierarchy;
+    BoundingVolumeHierarchy::create(&boundingVolumeHierarchyCreateInfo, &boundingVolumeHierarchy);
+    std::mt19937 generator(7);
+    std::vector<BoundingVolumeHierarchy::Aabb> aabbs;
+    std::vector<BoundingVolumeHierarchy::ProxyId> proxyIds;
+    for (uint32_t i = 0; i < 1024; ++i) {
+        aabbs.push_back(create_random_aabb(generator));
+        proxyIds.push_back(boundingVolumeHierarchy.create_proxy(aabbs.back(), i));
+    }
+
+    // Movements within the margin don't change the tree.
+    glm::vec3 nudge { 0.25f, 0, 0 };
+    EXPECT_FALSE(boundingVolumeHierarchy.update_proxy(proxyIds[0], { aabbs[0].min + nudge, aabbs[0].max + nudge }));
+
+    // Move everything, destroying and recreating some proxies along the way.
+    std::uniform_real_distribution<float> distribution(-4, 4);
+    for (int frame = 0; frame < 32; ++frame) {
+        for (uint32_t i = 0; i < proxyIds.size(); ++i) {
+            glm::vec3 offset { distribution(generator), distribution(generator), distribution(generator) };
+            aabbs[i] = { aabbs[i].min + offset, aabbs[i].max + offset };
+            boundingVolumeHierarchy.update_proxy(proxyIds[i], aabbs[i]);
+            const auto& aabb = boundingVolumeHierarchy.get_aabb(proxyIds[i]);
+            ASSERT_LE(aabb.min.x, aabbs[i].min.x);
+            ASSERT_LE(aabbs[i].max.z, aabb.max.z);
+        }
+        for (uint32_t i = frame; i < proxyIds.size(); i += 97) {
+            boundingVolumeHierarchy.destroy_proxy(proxyIds[i]);
+            proxyIds[i] = boundingVolumeHierarchy.create_proxy(aabbs[i], i);
+        }
+    }
+    EXPECT_EQ(boundingVolumeHierarchy.get_proxy_count(), 1024u);
+    EXPECT_LE(boundingVolumeHierarchy.get_height(), 20);
+    auto frustum = create_test_frustum({ 0, 0, 150 }, { 0, 0, 0 });
+    EXPECT_EQ(cull_sorted(boundingVolumeHierarchy, frustum), cull_brute_force(boundingVolumeHierarchy, proxyIds, frustum));
+
+    // A frustum containing every proxy accepts all of them.
+    Frustum containingFrustum { };
+    for (auto& plane : containingFrustum.planes) {
+        plane = { 0, 0, 0, 1 };
+    }
+    EXPECT_EQ(cull_sorted(boundingVolumeHierarchy, containingFrustum).size(), 1024u);
+
+    for (auto proxyId : proxyIds) {
+        boundingVolumeHierarchy.destroy_proxy(proxyId);
+    }
+    EXPECT_EQ(boundingVolumeHierarchy.get_proxy_count(), 0u);
+    EXPECT_EQ(boundingVolumeHierarchy.get_height(), 0);
+}
+
+TEST(BoundingVolumeHierarchy, ParallelCull)
+{
+    BoundingVolumeHierarchy::CreateInfo boundingVolumeHierarchyCreateInfo { };
+    BoundingVolumeHierarchy boundingVolumeHierarchy;
+    BoundingVolumeHierarchy::create(&boundingVolumeHierarchyCreateInfo, &boundingVolumeHierarchy);
+    std::mt19937 generator(9);
+    std::vector<BoundingVolumeHierarchy::ProxyId> proxyIds;
+    for (uint32_t i = 0; i < 8192; ++i) {
+        proxyIds.push_back(boundingVolumeHierarchy.create_proxy(create_random_aabb(generator), i));
+    }
+    JobSystem::CreateInfo jobSystemCreateInfo { };
+    jobSystemCreateInfo.workerCount = 3;
+    JobSystem jobSystem;
+    JobSystem::create(&jobSystemCreateInfo, &jobSystem);
+    std::uniform_real_distribution<float> distribution(-100, 100);
+    std::vector<uint32_t> indices;
+    for (int i = 0; i < 16; ++i) {
+        glm::vec3 eye { distribution(generator), distribution(generator), distribution(generator) };
+        glm::vec3 center { distribution(generator), distribution(generator), distribution(generator) };
+        auto frustum = create_test_frustum(eye, center);
+        boundingVolumeHierarchy.cull(frustum, jobSystem, &indices);
+        std::sort(indices.begin(), indices.end());
+        EXPECT_EQ(indices, cull_brute_force(boundingVolumeHierarchy, proxyIds, frustum));
+    }
+}
+
+} // namespace tests
+} // namespace gfx
+} // namespace dst
@@ -0,0 +1,170 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+
+#include "dynamic-static.graphics/geometry-arena.hpp"
+
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace dst {
+namespace gfx {
+namespace tests {
+
+using Region = std::tuple<uint64_t, uint64_t, uint64_t>;
+
+static std::vector<Region> get_regions(const std::vector<VkBufferCopy>& bufferCopies)
+{
+    std::vector<Region> regions;
+    for (const auto& bufferCopy : bufferCopies) {
+        regions.push_back({ bufferCopy.srcOffset, bufferCopy.dstOffset, bufferCopy.size });
+    }
+    return regions;
+}
+
+TEST(GeometryArena, DefragmentRegionsMergeAdjacent)
+{
+    // [0, 2) didn't move, [4, 6) and [6, 8) moved down by 2 so they're copied with
+    //  one region.  Regions are scaled from elements to bytes.
+    std::vector<TlsfAllocator::Move> moves {
+        { 1, 4, 2, 2 },
+        { 2, 6, 4, 2 },
+    };
+    std::vector<VkBufferCopy> regions;
+    detail::get_defragment_regions(moves, 6, 4, &regions);
+    std::vector<Region> expectedRegions {
+        { 0, 0, 8 },
+        { 16, 8, 16 },
+    };
+    EXPECT_EQ(get_regions(regions), expectedRegions);
+
+    // Moves that aren't contiguous in their source aren't merged.
+    moves = {
+        { 1, 4, 2, 2 },
+        { 2, 8, 4, 2 },
+    };
+    regions.clear();
+    detail::get_defragment_regions(moves, 6, 1, &regions);
+    expectedRegions = {
+        { 0, 0, 2 },
+        { 4, 2, 2 },
+        { 8, 4, 2 },
+    };
+    EXPECT_EQ(get_regions(regions), expectedRegions);
+}
+
+TEST(GeometryArena, DefragmentRegionsWithoutMoves)
+{
+    // Without moves the used range is copied in place, an empty allocator needs
+    //  no copies.
+    std::vector<VkBufferCopy> regions;
+    detail::get_defragment_regions({ }, 10, 12, &regions);
+    std::vector<Region> expectedRegions {
+        { 0, 0, 120 },
+    };
+    EXPECT_EQ(get_regions(regions), expectedRegions);
+    regions.clear();
+    detail::get_defragment_regions({ }, 0, 12, &regions);
+    EXPECT_TRUE(regions.empty());
+}
+
+TEST(GeometryArena, BufferOffsets)
+{
+    // Offsets are in elements, vertex buffer offsets are scaled by the vertex size
+    //  and index buffer offsets by the index size.
+    TlsfAllocator::CreateInfo tlsfAllocatorCreateInfo { };
+    tlsfAllocatorCreateInfo.size = 1024;
+    TlsfAllocator allocator;
+    TlsfAllocator::create(&tlsfAllocatorCreateInfo, &allocator);
+    auto handle0 = allocator.allocate(3);
+    auto handle1 = allocator.allocate(5);
+    ASSERT_NE(handle0, TlsfAllocator::InvalidHandle);
+    ASSERT_NE(handle1, TlsfAllocator::InvalidHandle);
+    EXPECT_EQ(detail::get_buffer_offset(allocator, handle0, 12), allocator.get_offset(handle0) * 12);
+    EXPECT_EQ(detail::get_buffer_offset(allocator, handle1, 12), allocator.get_offset(handle1) * 12);
+    EXPECT_EQ(detail::get_buffer_offset(allocator, handle1, sizeof(uint16_t)), allocator.get_offset(handle1) * sizeof(uint16_t));
+    EXPECT_NE(allocator.get_offset(handle0), allocator.get_offset(handle1));
+}
+
+TEST(GeometryArena, DefragmentRelocation)
+{
+    // Simulates defragment() with CPU buffers, after copying the regions from the
+    //  old buffer every live allocation's data is found at its new offset.
+    for (uint64_t elementSize : { (uint64_t)sizeof(uint16_t), (uint64_t)sizeof(uint32_t), (uint64_t)12 }) {
+        constexpr uint64_t ElementCount = 4096;
+        TlsfAllocator::CreateInfo tlsfAllocatorCreateInfo { };
+        tlsfAllocatorCreateInfo.size = ElementCount;
+        TlsfAllocator allocator;
+        TlsfAllocator::create(&tlsfAllocatorCreateInfo, &allocator);
+        std::vector<uint8_t> oldBuffer(ElementCount * elementSize);
+        std::vector<std::pair<TlsfAllocator::Handle, uint8_t>> allocations;
+        std::mt19937 rng(0);
+        for (uint32_t i = 0; i < 256; ++i) {
+            if (!allocations.empty() && rng() % 3 == 0) {
+                auto allocation_i = rng() % allocations.size();
+                allocator.free(allocations[allocation_i].first);
+                allocations.erase(allocations.begin() + allocation_i);
+            } else {
+                auto handle = allocator.allocate(1 + rng() % 32);
+                if (handle != TlsfAllocator::InvalidHandle) {
+                    auto value = (uint8_t)(1 + rng() % 255);
+                    auto offset = detail::get_buffer_offset(allocator, handle, elementSize);
+                    memset(oldBuffer.data() + offset, value, allocator.get_size(handle) * elementSize);
+                    allocations.push_back({ handle, value });
+                }
+            }
+        }
+        ASSERT_LT(1u, allocator.get_free_block_count());
+        std::vector<TlsfAllocator::Move> moves;
+        allocator.defragment(&moves);
+        EXPECT_FALSE(moves.empty());
+        std::vector<VkBufferCopy> regions;
+        detail::get_defragment_regions(moves, allocator.get_used_size(), elementSize, &regions);
+        std::vector<uint8_t> newBuffer(oldBuffer.size());
+        for (const auto& region : regions) {
+            ASSERT_LE(region.srcOffset + region.size, oldBuffer.size());
+            ASSERT_LE(region.dstOffset + region.size, allocator.get_used_size() * elementSize);
+            memcpy(newBuffer.data() + region.dstOffset, oldBuffer.data() + region.srcOffset, region.size);
+        }
+        for (const auto& allocation : allocations) {
+            auto offset = detail::get_buffer_offset(allocator, allocation.first, elementSize);
+            auto size = allocator.get_size(allocation.first) * elementSize;
+            for (uint64_t i = 0; i < size; ++i) {
+                ASSERT_EQ(newBuffer[offset + i], allocation.second);
+            }
+        }
+    }
+}
+
+} // namespace tests
+} // namespace gfx
+} // namespace dst
@@ -0,0 +1,114 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+
+#include "dynamic-static.graphics/instance-batcher.hpp"
+
+#include "gtest/gtest.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace dst {
+namespace gfx {
+namespace tests {
+
+TEST(InstanceBatcher, Build)
+{
+    // Submit interleaved draws for three meshes, each mesh should produce one
+    //  Batch with its instances contiguous and front to back.
+    RenderQueue::CreateInfo renderQueueCreateInfo { };
+    RenderQueue renderQueue;
+    RenderQueue::create(&renderQueueCreateInfo, &renderQueue);
+    std::vector<InstanceWorldColor> sourceInstances;
+    for (uint32_t i = 0; i < 12; ++i) {
+        InstanceWorldColor instance { };
+        instance.color = glm::vec4((float)i);
+        sourceInstances.push_back(instance);
+        renderQueue.submit(0, 0, i % 3, 1.0f - i / 12.0f, i);
+    }
+    InstanceBatcher<>::CreateInfo instanceBatcherCreateInfo { };
+    InstanceBatcher<> instanceBatcher;
+    InstanceBatcher<>::create(&instanceBatcherCreateInfo, &instanceBatcher);
+    const auto& batches = instanceBatcher.build(renderQueue.sort(), [&](uint32_t item) { return sourceInstances[item]; });
+    ASSERT_EQ(batches.size(), 3);
+    auto instances = instanceBatcher.get_instances();
+    ASSERT_EQ(instances.size(), 12);
+    for (uint32_t mesh = 0; mesh < 3; ++mesh) {
+        const auto& batch = batches[mesh];
+        EXPECT_EQ(batch.mesh, mesh);
+        EXPECT_EQ(batch.firstInstance, mesh * 4);
+        EXPECT_EQ(batch.instanceCount, 4);
+        EXPECT_EQ(batch.item, mesh + 9);
+        EXPECT_TRUE(batch.flags & RenderQueue::Draw::BindMesh);
+        for (uint32_t i = 0; i < batch.instanceCount; ++i) {
+            EXPECT_EQ(instances[batch.firstInstance + i].color.x, (float)(mesh + 9 - i * 3));
+        }
+    }
+    instanceBatcher.clear();
+    EXPECT_TRUE(instanceBatcher.get_batches().empty());
+    EXPECT_TRUE(instanceBatcher.get_instances().empty());
+}
+
+TEST(InstanceBatcher, PipelineChange)
+{
+    // Draws sharing a mesh but not a pipeline can't be batched together.
+    RenderQueue::CreateInfo renderQueueCreateInfo { };
+    RenderQueue renderQueue;
+    RenderQueue::create(&renderQueueCreateInfo, &renderQueue);
+    renderQueue.submit(0, 0, 5, 0, 0);
+    renderQueue.submit(1, 0, 5, 0, 1);
+    renderQueue.submit(0, 0, 5, 0, 2);
+    InstanceBatcher<>::CreateInfo instanceBatcherCreateInfo { };
+    InstanceBatcher<> instanceBatcher;
+    InstanceBatcher<>::create(&instanceBatcherCreateInfo, &instanceBatcher);
+    const auto& batches = instanceBatcher.build(renderQueue.sort(), [](uint32_t) { return InstanceWorldColor { }; });
+    ASSERT_EQ(batches.size(), 2);
+    EXPECT_EQ(batches[0].pipeline, 0);
+    EXPECT_EQ(batches[0].instanceCount, 2);
+    EXPECT_EQ(batches[1].pipeline, 1);
+    EXPECT_EQ(batches[1].firstInstance, 2);
+    EXPECT_EQ(batches[1].instanceCount, 1);
+    EXPECT_TRUE(batches[1].flags & RenderQueue::Draw::BindPipeline);
+}
+
+TEST(InstanceBatcher, InstanceWorldColorDescription)
+{
+    auto attributes = gvk::get_vertex_description<InstanceWorldColor>(1);
+    ASSERT_EQ(attributes.size(), 5u);
+    for (uint32_t i = 0; i < 4; ++i) {
+        EXPECT_EQ(attributes[i].binding, 1);
+        EXPECT_EQ(attributes[i].format, VK_FORMAT_R32G32B32A32_SFLOAT);
+        EXPECT_EQ(attributes[i].offset, offsetof(InstanceWorldColor, world) + i * sizeof(glm::vec4));
+    }
+    EXPECT_EQ(attributes[4].offset, offsetof(InstanceWorldColor, color));
+    EXPECT_EQ(sizeof(InstanceWorldColor), 5 * sizeof(glm::vec4));
+}
+
+} // namespace tests
+} // namespace gfx
+} // namespace dst
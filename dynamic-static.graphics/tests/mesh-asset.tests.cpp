@@ -0,0 +1,112 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#include "dynamic-static.graphics/mesh-asset.hpp"
+#include "dynamic-static.graphics/meshlet.hpp"
+#include "dynamic-static.graphics/primitives.hpp"
+#include "dynamic-static.graphics/simplification.hpp"
+
+#include "gtest/gtest.h"
+
+#include <cstring>
+#include <filesystem>
+#include <vector>
+
+namespace dst {
+namespace gfx {
+namespace tests {
+
+TEST(MeshAsset, RoundTrip)
+{
+    std::vector<glm::vec3> vertices;
+    std::vector<primitive::Triangle<uint32_t>> triangles;
+    primitive::create_icosphere<uint32_t>(1, 3, &vertices, &triangles);
+    std::vector<LodLevel<uint32_t>> lodLevels;
+    create_lod_chain<uint32_t>(vertices, triangles, { }, &lodLevels);
+    ASSERT_LT(1u, lodLevels.size());
+    MeshletMesh meshletMesh;
+    build_meshlets<uint32_t>(vertices, triangles, Meshlet::DefaultMaxVertexCount, Meshlet::DefaultMaxTriangleCount, &meshletMesh);
+
+    // Two meshes with different ids, the second without Meshlets.
+    AssetFileWriter assetFileWriter;
+    write_mesh_asset(0, vertices, lodLevels, &meshletMesh, &assetFileWriter);
+    write_mesh_asset(1, vertices, std::span<const LodLevel<uint32_t>>(lodLevels).first(1), nullptr, &assetFileWriter);
+    auto filePath = std::filesystem::temp_directory_path() / "dynamic-static.graphics.mesh-asset.tests.dsta";
+    ASSERT_TRUE(assetFileWriter.write(filePath));
+    AssetFile::CreateInfo assetFileCreateInfo { };
+    assetFileCreateInfo.filePath = filePath;
+    AssetFile assetFile;
+    ASSERT_TRUE(AssetFile::create(&assetFileCreateInfo, &assetFile));
+
+    MeshAsset meshAsset;
+    ASSERT_TRUE(get_mesh_asset(assetFile, 0, &meshAsset));
+    ASSERT_EQ(meshAsset.positions.size(), vertices.size());
+    EXPECT_FALSE(memcmp(meshAsset.positions.data(), vertices.data(), vertices.size() * sizeof(glm::vec3)));
+    ASSERT_EQ(meshAsset.lodRanges.size(), lodLevels.size());
+    for (size_t lod_i = 0; lod_i < lodLevels.size(); ++lod_i) {
+        auto lodTriangles = meshAsset.get_lod_triangles(lod_i);
+        EXPECT_EQ(std::vector<primitive::Triangle<uint32_t>>(lodTriangles.begin(), lodTriangles.end()), lodLevels[lod_i].triangles);
+        EXPECT_EQ(meshAsset.lodRanges[lod_i].error, lodLevels[lod_i].error);
+    }
+    ASSERT_EQ(meshAsset.meshlets.size(), meshletMesh.meshlets.size());
+    EXPECT_FALSE(memcmp(meshAsset.meshlets.data(), meshletMesh.meshlets.data(), meshletMesh.meshlets.size() * sizeof(Meshlet)));
+    EXPECT_EQ(std::vector<uint32_t>(meshAsset.meshletVertices.begin(), meshAsset.meshletVertices.end()), meshletMesh.vertices);
+    EXPECT_EQ(std::vector<uint8_t>(meshAsset.meshletTriangles.begin(), meshAsset.meshletTriangles.end()), meshletMesh.triangles);
+
+    ASSERT_TRUE(get_mesh_asset(assetFile, 1, &meshAsset));
+    EXPECT_EQ(meshAsset.lodRanges.size(), 1u);
+    EXPECT_EQ(meshAsset.get_lod_triangles(0).size(), triangles.size());
+    EXPECT_TRUE(meshAsset.meshlets.empty());
+    EXPECT_FALSE(get_mesh_asset(assetFile, 2, &meshAsset));
+
+    assetFile.reset();
+    std::filesystem::remove(filePath);
+}
+
+TEST(MeshAsset, InvalidLodRange)
+{
+    std::vector<glm::vec3> vertices(3);
+    std::vector<primitive::Triangle<uint32_t>> triangles { { 0, 1, 2 } };
+    std::vector<MeshAsset::LodRange> lodRanges { { 0, 2, 0 } };
+    AssetFileWriter assetFileWriter;
+    assetFileWriter.add_section<glm::vec3>(MeshAsset::PositionsSection, 0, vertices);
+    assetFileWriter.add_section<primitive::Triangle<uint32_t>>(MeshAsset::TrianglesSection, 0, triangles);
+    assetFileWriter.add_section<MeshAsset::LodRange>(MeshAsset::LodRangesSection, 0, lodRanges);
+    auto filePath = std::filesystem::temp_directory_path() / "dynamic-static.graphics.mesh-asset.tests.dsta";
+    ASSERT_TRUE(assetFileWriter.write(filePath));
+    AssetFile::CreateInfo assetFileCreateInfo { };
+    assetFileCreateInfo.filePath = filePath;
+    AssetFile assetFile;
+    ASSERT_TRUE(AssetFile::create(&assetFileCreateInfo, &assetFile));
+    MeshAsset meshAsset;
+    EXPECT_FALSE(get_mesh_asset(assetFile, 0, &meshAsset));
+    assetFile.reset();
+    std::filesystem::remove(filePath);
+}
+
+} // namespace tests
+} // namespace gfx
+} // namespace dst
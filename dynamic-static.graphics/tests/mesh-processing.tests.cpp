@@ -0,0 +1,220 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#include "dynamic-static.graphics/mesh-processing.hpp"
+#include "dynamic-static.graphics/primitives.hpp"
+#include "dynamic-static/batch-math.hpp"
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <vector>
+
+namespace dst {
+namespace gfx {
+namespace tests {
+
+static void create_counter_clockwise_cube(std::vector<VertexPositionNormal>* pVertices, std::vector<primitive::Triangle<uint32_t>>* pTriangles)
+{
+    pVertices->clear();
+    for (const auto& position : primitive::Cube::Vertices) {
+        pVertices->push_back({ .position = position, .normal = { } });
+    }
+    pTriangles->clear();
+    for (const auto& triangle : primitive::Cube::Triangles) {
+        pTriangles->push_back({ triangle[0], triangle[2], triangle[1] });
+    }
+}
+
+static void create_grid(int resolution, bool mirrorTexcoords, std::vector<VertexPositionNormalTangentTexcoord>* pVertices, std::vector<primitive::Triangle<uint32_t>>* pTriangles)
+{
+    pVertices->clear();
+    pTriangles->clear();
+    for (int y = 0; y <= resolution; ++y) {
+        for (int x = 0; x <= resolution; ++x) {
+            VertexPositionNormalTangentTexcoord vertex { };
+            vertex.position = { (float)x, (float)y, 0 };
+            vertex.texcoord = { mirrorTexcoords ? -(float)x : (float)x, (float)y };
+            pVertices->push_back(vertex);
+        }
+    }
+    auto get_index = [=](int x, int y) { return (uint32_t)(y * (resolution + 1) + x); };
+    for (int y = 0; y < resolution; ++y) {
+        for (int x = 0; x < resolution; ++x) {
+            pTriangles->push_back({ get_index(x, y), get_index(x + 1, y), get_index(x + 1, y + 1) });
+            pTriangles->push_back({ get_index(x + 1, y + 1), get_index(x, y + 1), get_index(x, y) });
+        }
+    }
+}
+
+TEST(MeshProcessing, WeldVertices)
+{
+    std::vector<VertexPositionNormal> vertices;
+    std::vector<primitive::Triangle<uint32_t>> triangles;
+    create_counter_clockwise_cube(&vertices, &triangles);
+    weld_vertices(0, &vertices, &triangles);
+    EXPECT_EQ(vertices.size(), 8u);
+    EXPECT_EQ(triangles.size(), 12u);
+    for (const auto& triangle : triangles) {
+        for (auto index : triangle) {
+            EXPECT_LT(index, vertices.size());
+        }
+    }
+}
+
+TEST(MeshProcessing, WeldVerticesWithTolerance)
+{
+    std::vector<VertexPositionNormal> vertices;
+    std::vector<primitive::Triangle<uint32_t>> triangles;
+    create_counter_clockwise_cube(&vertices, &triangles);
+    for (size_t vertex_i = 0; vertex_i < vertices.size(); ++vertex_i) {
+        vertices[vertex_i].position += glm::vec3 { 0.00001f } * (float)(vertex_i % 3);
+    }
+    auto jitteredVertices = vertices;
+    auto jitteredTriangles = triangles;
+    weld_vertices(0, &jitteredVertices, &jitteredTriangles);
+    EXPECT_LT(8u, jitteredVertices.size());
+    weld_vertices(0.0001f, &vertices, &triangles);
+    EXPECT_EQ(vertices.size(), 8u);
+    EXPECT_EQ(triangles.size(), 12u);
+}
+
+TEST(MeshProcessing, ComputeNormals)
+{
+    std::vector<glm::vec3> positions;
+    std::vector<primitive::Triangle<uint32_t>> triangles;
+    primitive::create_icosphere<uint32_t>(1, 3, &positions, &triangles);
+    for (auto& triangle : triangles) {
+        std::swap(triangle[1], triangle[2]);
+    }
+    for (auto weighting : { NormalWeighting::Area, NormalWeighting::Angle }) {
+        std::vector<glm::vec3> normals(positions.size());
+        compute_normals<uint32_t>(triangles, positions.size(), positions.data(), sizeof(glm::vec3), weighting, normals.data(), sizeof(glm::vec3));
+        for (size_t vertex_i = 0; vertex_i < positions.size(); ++vertex_i) {
+            EXPECT_NEAR(glm::length(normals[vertex_i]), 1.0f, 0.0001f);
+            EXPECT_LT(0.999f, glm::dot(normals[vertex_i], glm::normalize(positions[vertex_i])));
+        }
+    }
+
+    // Angle weighting gives every face of a welded cube equal influence.
+    std::vector<VertexPositionNormal> vertices;
+    create_counter_clockwise_cube(&vertices, &triangles);
+    weld_vertices(0, &vertices, &triangles);
+    compute_normals<uint32_t, VertexPositionNormal>(triangles, NormalWeighting::Angle, vertices);
+    for (const auto& vertex : vertices) {
+        auto expected = glm::normalize(vertex.position);
+        EXPECT_NEAR(vertex.normal.x, expected.x, 0.0001f);
+        EXPECT_NEAR(vertex.normal.y, expected.y, 0.0001f);
+        EXPECT_NEAR(vertex.normal.z, expected.z, 0.0001f);
+    }
+}
+
+TEST(MeshProcessing, ComputeTangents)
+{
+    for (auto mirrorTexcoords : { false, true }) {
+        std::vector<VertexPositionNormalTangentTexcoord> vertices;
+        std::vector<primitive::Triangle<uint32_t>> triangles;
+        create_grid(4, mirrorTexcoords, &vertices, &triangles);
+        compute_normals<uint32_t, VertexPositionNormalTangentTexcoord>(triangles, NormalWeighting::Area, vertices);
+        compute_tangents<uint32_t, VertexPositionNormalTangentTexcoord>(triangles, vertices);
+        for (const auto& vertex : vertices) {
+            EXPECT_EQ(vertex.normal, (glm::vec3 { 0, 0, 1 }));
+            EXPECT_NEAR(vertex.tangent.x, mirrorTexcoords ? -1.0f : 1.0f, 0.0001f);
+            EXPECT_NEAR(vertex.tangent.y, 0.0f, 0.0001f);
+            EXPECT_NEAR(vertex.tangent.z, 0.0f, 0.0001f);
+            EXPECT_EQ(vertex.tangent.w, mirrorTexcoords ? -1.0f : 1.0f);
+        }
+    }
+}
+
+TEST(MeshProcessing, ComputeTangentsOrthonormal)
+{
+    std::vector<glm::vec3> positions;
+    std::vector<primitive::Triangle<uint32_t>> triangles;
+    primitive::create_icosphere<uint32_t>(1, 3, &positions, &triangles);
+    std::vector<VertexPositionNormalTangentTexcoord> vertices;
+    for (const auto& position : positions) {
+        VertexPositionNormalTangentTexcoord vertex { };
+        vertex.position = position;
+        vertex.texcoord = { std::atan2(position.z, position.x), position.y };
+        vertices.push_back(vertex);
+    }
+    for (auto& triangle : triangles) {
+        std::swap(triangle[1], triangle[2]);
+    }
+    compute_normals<uint32_t, VertexPositionNormalTangentTexcoord>(triangles, NormalWeighting::Angle, vertices);
+    compute_tangents<uint32_t, VertexPositionNormalTangentTexcoord>(triangles, vertices);
+    for (const auto& vertex : vertices) {
+        auto tangent = glm::vec3(vertex.tangent);
+        EXPECT_NEAR(glm::length(tangent), 1.0f, 0.0001f);
+        EXPECT_NEAR(glm::dot(tangent, vertex.normal), 0.0f, 0.0001f);
+        EXPECT_TRUE(vertex.tangent.w == 1.0f || vertex.tangent.w == -1.0f);
+    }
+}
+
+TEST(MeshProcessing, InstructionSets)
+{
+    // Every instruction set produces the same normals and tangents.
+    std::vector<glm::vec3> positions;
+    std::vector<primitive::Triangle<uint32_t>> triangles;
+    primitive::create_icosphere<uint32_t>(1, 3, &positions, &triangles);
+    for (auto& triangle : triangles) {
+        std::swap(triangle[1], triangle[2]);
+    }
+    auto initialInstructionSet = batch::get_instruction_set();
+    std::vector<std::vector<VertexPositionNormalTangentTexcoord>> results;
+    for (auto instructionSet : { batch::InstructionSet::Scalar, batch::InstructionSet::Sse2, batch::InstructionSet::Avx2, batch::InstructionSet::Neon }) {
+        if (!batch::is_supported(instructionSet)) {
+            continue;
+        }
+        batch::set_instruction_set(instructionSet);
+        for (auto weighting : { NormalWeighting::Area, NormalWeighting::Angle }) {
+            std::vector<VertexPositionNormalTangentTexcoord> vertices;
+            for (const auto& position : positions) {
+                VertexPositionNormalTangentTexcoord vertex { };
+                vertex.position = position;
+                vertex.texcoord = { std::atan2(position.z, position.x), position.y };
+                vertices.push_back(vertex);
+            }
+            compute_normals<uint32_t, VertexPositionNormalTangentTexcoord>(triangles, weighting, vertices);
+            compute_tangents<uint32_t, VertexPositionNormalTangentTexcoord>(triangles, vertices);
+            results.push_back(vertices);
+        }
+    }
+    batch::set_instruction_set(initialInstructionSet);
+    ASSERT_LE(2u, results.size());
+    for (size_t i = 2; i < results.size(); ++i) {
+        const auto& expected = results[i % 2];
+        for (size_t vertex_i = 0; vertex_i < expected.size(); ++vertex_i) {
+            EXPECT_EQ(results[i][vertex_i].normal, expected[vertex_i].normal);
+            EXPECT_EQ(results[i][vertex_i].tangent, expected[vertex_i].tangent);
+        }
+    }
+}
+
+} // namespace tests
+} // namespace gfx
+} // namespace dst
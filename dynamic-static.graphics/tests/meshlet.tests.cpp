@@ -0,0 +1,140 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#include "dynamic-static.graphics/frustum.hpp"
+#include "dynamic-static.graphics/meshlet.hpp"
+#include "dynamic-static.graphics/primitives.hpp"
+#include "dynamic-static.graphics/vertex-cache.hpp"
+
+#include "gtest/gtest.h"
+
+#include <set>
+#include <vector>
+
+namespace dst {
+namespace gfx {
+namespace tests {
+
+TEST(Meshlet, MakeFrustum)
+{
+    // An identity view projection yields a frustum matching the clip volume.
+    auto frustum = make_frustum(glm::mat4(1.0f));
+    EXPECT_TRUE(intersects_sphere(frustum, { 0, 0, 0.5f }, 0.1f));
+    EXPECT_TRUE(intersects_sphere(frustum, { 1.5f, 0, 0.5f }, 0.6f));
+    EXPECT_FALSE(intersects_sphere(frustum, { 1.5f, 0, 0.5f }, 0.4f));
+    EXPECT_FALSE(intersects_sphere(frustum, { 0, -2, 0.5f }, 0.5f));
+    EXPECT_TRUE(intersects_aabb(frustum, { 0.9f, 0.9f, 0.4f }, { 2, 2, 0.6f }));
+    EXPECT_FALSE(intersects_aabb(frustum, { 1.1f, -0.5f, 0.4f }, { 2, 0.5f, 0.6f }));
+    EXPECT_FALSE(intersects_aabb(frustum, { -0.5f, -0.5f, 1.1f }, { 0.5f, 0.5f, 2 }));
+}
+
+TEST(Meshlet, BuildMeshlets)
+{
+    std::vector<glm::vec3> vertices;
+    std::vector<primitive::Triangle<uint32_t>> triangles;
+    primitive::create_icosphere<uint32_t>(1, 4, &vertices, &triangles);
+    optimize_vertex_cache<uint32_t>(triangles, vertices.size());
+    MeshletMesh meshletMesh;
+    build_meshlets<uint32_t>(vertices, triangles, Meshlet::DefaultMaxVertexCount, Meshlet::DefaultMaxTriangleCount, &meshletMesh);
+    ASSERT_FALSE(meshletMesh.meshlets.empty());
+
+    std::multiset<primitive::Triangle<uint32_t>> expectedTriangles(triangles.begin(), triangles.end());
+    std::multiset<primitive::Triangle<uint32_t>> meshletTriangles;
+    for (const auto& meshlet : meshletMesh.meshlets) {
+        EXPECT_LE(meshlet.vertexCount, Meshlet::DefaultMaxVertexCount);
+        EXPECT_LE(meshlet.triangleCount, Meshlet::DefaultMaxTriangleCount);
+        for (uint32_t i = 0; i < meshlet.vertexCount; ++i) {
+            const auto& position = vertices[meshletMesh.vertices[meshlet.vertexOffset + i]];
+            EXPECT_LE(glm::length(position - meshlet.center), meshlet.radius * 1.0001f);
+        }
+        for (uint32_t triangle_i = 0; triangle_i < meshlet.triangleCount; ++triangle_i) {
+            primitive::Triangle<uint32_t> triangle { };
+            for (uint32_t i = 0; i < 3; ++i) {
+                auto localIndex = meshletMesh.triangles[(meshlet.triangleOffset + triangle_i) * 3 + i];
+                EXPECT_LT(localIndex, meshlet.vertexCount);
+                triangle[i] = meshletMesh.vertices[meshlet.vertexOffset + localIndex];
+            }
+            meshletTriangles.insert(triangle);
+            if (meshlet.coneCutoff < 1) {
+                const auto& v0 = vertices[triangle[0]];
+                auto normal = glm::normalize(glm::cross(vertices[triangle[1]] - v0, vertices[triangle[2]] - v0));
+                EXPECT_GE(glm::dot(normal, meshlet.coneAxis), std::sqrt(1 - meshlet.coneCutoff * meshlet.coneCutoff) - 0.0001f);
+            }
+        }
+    }
+    EXPECT_EQ(meshletTriangles, expectedTriangles);
+
+    // A sphere subdivided 4 times has 5120 triangles, with 124 triangles per
+    //  Meshlet a reasonable build should average better than half full.
+    EXPECT_LT(meshletMesh.meshlets.size(), triangles.size() / (Meshlet::DefaultMaxTriangleCount / 2));
+}
+
+TEST(Meshlet, CullMeshlets)
+{
+    std::vector<glm::vec3> vertices;
+    std::vector<primitive::Triangle<uint32_t>> triangles;
+    primitive::create_icosphere<uint32_t>(1, 4, &vertices, &triangles);
+    // Icosphere triangles are clockwise when viewed from outside, flip them so
+    //  that normal cones point outward.
+    for (auto& triangle : triangles) {
+        std::swap(triangle[1], triangle[2]);
+    }
+    MeshletMesh meshletMesh;
+    build_meshlets<uint32_t>(vertices, triangles, 64, 64, &meshletMesh);
+
+    // Every Meshlet is inside a frustum that encloses the sphere, but Meshlets
+    //  facing away from the camera are culled.
+    Frustum frustum { };
+    frustum.planes[Frustum::Left] = { 1, 0, 0, 10 };
+    frustum.planes[Frustum::Right] = { -1, 0, 0, 10 };
+    frustum.planes[Frustum::Bottom] = { 0, 1, 0, 10 };
+    frustum.planes[Frustum::Top] = { 0, -1, 0, 10 };
+    frustum.planes[Frustum::Near] = { 0, 0, 1, 10 };
+    frustum.planes[Frustum::Far] = { 0, 0, -1, 10 };
+    glm::vec3 cameraPosition { 0, 0, 8 };
+    std::vector<uint32_t> visibleMeshlets;
+    auto visibleMeshletCount = cull_meshlets(meshletMesh.meshlets, frustum, cameraPosition, &visibleMeshlets);
+    EXPECT_LT(visibleMeshletCount, meshletMesh.meshlets.size());
+    EXPECT_GT(visibleMeshletCount, 0u);
+    for (uint32_t meshlet_i = 0; meshlet_i < meshletMesh.meshlets.size(); ++meshlet_i) {
+        const auto& meshlet = meshletMesh.meshlets[meshlet_i];
+        bool visible = std::find(visibleMeshlets.begin(), visibleMeshlets.end(), meshlet_i) != visibleMeshlets.end();
+        if (0.5f < meshlet.center.z) {
+            EXPECT_TRUE(visible);
+        }
+        if (meshlet.coneCutoff < 1 && meshlet.coneAxis.z < -0.9f) {
+            EXPECT_FALSE(visible);
+        }
+    }
+
+    // Moving the far plane in front of the sphere culls everything.
+    frustum.planes[Frustum::Far] = { 0, 0, -1, -2 };
+    EXPECT_EQ(cull_meshlets(meshletMesh.meshlets, frustum, cameraPosition, &visibleMeshlets), 0u);
+}
+
+} // namespace tests
+} // namespace gfx
+} // namespace dst
@@ -0,0 +1,232 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+
+
+#include "dynamic-static.graphics/occlusion-culler.hpp"
+#include "dynamic-static/batch-math.hpp"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace dst {
+namespace gfx {
+namespace tests {
+
+static OcclusionCuller create_occlusion_culler()
+{
+    OcclusionCuller::CreateInfo occlusionCullerCreateInfo { };
+    OcclusionCuller occlusionCuller;
+    OcclusionCuller::create(&occlusionCullerCreateInfo, &occlusionCuller);
+    return occlusionCuller;
+}
+
+static glm::mat4 create_test_view_projection(const glm::vec3& eye, const glm::vec3& center)
+{
+    return glm::perspective(glm::radians(60.0f), 2.0f, 0.1f, 100.0f) * glm::lookAt(eye, center, { 0, 1, 0 });
+}
+
+static void add_box_occluder(OcclusionCuller& occlusionCuller, const glm::vec3& center, const glm::vec3& extents)
+{
+    auto world = glm::scale(glm::translate(glm::mat4 { 1 }, center), extents);
+    occlusionCuller.add_occluder(primitive::Cube::Vertices, primitive::Cube::Triangles, world);
+}
+
+static bool is_box_visible(const OcclusionCuller& occlusionCuller, const glm::vec3& center, const glm::vec3& extents)
+{
+    return occlusionCuller.is_visible(center - extents * 0.5f, center + extents * 0.5f);
+}
+
+static void add_random_occluders(std::mt19937& generator, OcclusionCuller& occlusionCuller)
+{
+    std::uniform_real_distribution<float> positionDistribution(-20, 20);
+    std::uniform_real_distribution<float> extentDistribution(0.5f, 8);
+    for (uint32_t i = 0; i < 64; ++i) {
+        glm::vec3 center { positionDistribution(generator), positionDistribution(generator), positionDistribution(generator) };
+        glm::vec3 extents { extentDistribution(generator), extentDistribution(generator), extentDistribution(generator) };
+        add_box_occluder(occlusionCuller, center, extents);
+    }
+}
+
+TEST(OcclusionCuller, Occlusion)
+{
+    auto occlusionCuller = create_occlusion_culler();
+    occlusionCuller.begin_frame(create_test_view_projection({ 0, 0, 10 }, { 0, 0, 0 }));
+    add_box_occluder(occlusionCuller, { 0, 0, 0 }, { 4, 4, 0.2f });
+    EXPECT_NE(occlusionCuller.get_triangle_count(), 0);
+    EXPECT_LE(occlusionCuller.get_triangle_count(), 12);
+    occlusionCuller.rasterize();
+    auto depths = occlusionCuller.get_depths();
+    ASSERT_EQ(depths.size(), occlusionCuller.get_width() * occlusionCuller.get_height());
+    EXPECT_LT(*std::min_element(depths.begin(), depths.end()), 1.0f);
+    EXPECT_EQ(*std::max_element(depths.begin(), depths.end()), 1.0f);
+
+    EXPECT_FALSE(is_box_visible(occlusionCuller, { 0, 0, -3 }, { 1, 1, 1 }));
+    EXPECT_FALSE(is_box_visible(occlusionCuller, { 1, 1, -1 }, { 0.5f, 0.5f, 0.5f }));
+    EXPECT_TRUE(is_box_visible(occlusionCuller, { 0, 0, 3 }, { 1, 1, 1 }));
+    EXPECT_TRUE(is_box_visible(occlusionCuller, { 8, 0, -3 }, { 1, 1, 1 }));
+    EXPECT_TRUE(is_box_visible(occlusionCuller, { 0, 0, -3 }, { 12, 1, 1 }));
+    EXPECT_TRUE(is_box_visible(occlusionCuller, { 0, 3, -3 }, { 1, 1, 1 }));
+    EXPECT_FALSE(is_box_visible(occlusionCuller, { 100, 0, 0 }, { 1, 1, 1 }));
+
+    // Boxes crossing the near plane are always visible.
+    EXPECT_TRUE(is_box_visible(occlusionCuller, { 0, 0, 10 }, { 1, 1, 1 }));
+
+    // Occluders are cleared by begin_frame().
+    occlusionCuller.begin_frame(create_test_view_projection({ 0, 0, 10 }, { 0, 0, 0 }));
+    occlusionCuller.rasterize();
+    EXPECT_EQ(occlusionCuller.get_triangle_count(), 0);
+    EXPECT_TRUE(is_box_visible(occlusionCuller, { 0, 0, -3 }, { 1, 1, 1 }));
+}
+
+TEST(OcclusionCuller, NearPlaneClipping)
+{
+    // A floor extending behind the camera is clipped against the near plane.
+    auto occlusionCuller = create_occlusion_culler();
+    occlusionCuller.begin_frame(create_test_view_projection({ 0, 2, 0 }, { 0, 1, -10 }));
+    add_box_occluder(occlusionCuller, { 0, 0, 0 }, { 200, 0.2f, 200 });
+    occlusionCuller.rasterize();
+    for (auto depth : occlusionCuller.get_depths()) {
+        EXPECT_LE(0.0f, depth);
+        EXPECT_LE(depth, 1.0f);
+    }
+    EXPECT_FALSE(is_box_visible(occlusionCuller, { 0, -3, -20 }, { 2, 2, 2 }));
+    EXPECT_FALSE(is_box_visible(occlusionCuller, { 0, -1, -1 }, { 1, 1, 1 }));
+    EXPECT_TRUE(is_box_visible(occlusionCuller, { 0, 1, -20 }, { 1, 1, 1 }));
+}
+
+TEST(OcclusionCuller, BrickBreakerLayout)
+{
+    // Mirrors the brick-breaker sample, the play field barriers, bricks and paddle
+    //  are occluders and draws are tested with the AABB of their bounding sphere.
+    //  Nothing in the play field is fully hidden, so no draw may be culled, even
+    //  when a knocked out brick or a ball drifts behind a barrier or a row of
+    //  bricks.
+    auto occlusionCuller = create_occlusion_culler();
+    auto projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 1.0f, 1000.0f);
+    occlusionCuller.begin_frame(projection * glm::lookAt({ 0, 0, -64 }, { 0, 0, 0 }, { 0, 1, 0 }));
+    std::vector<std::pair<glm::vec3, glm::vec3>> occluders {
+        { { 0, 32, 0 }, { 32, 1, 1 } },
+        { { 16, 0, 0 }, { 1, 64, 1 } },
+        { { -16, 0, 0 }, { 1, 64, 1 } },
+        { { 0, -28, 0 }, { 6, 1, 0.1f } },
+    };
+    for (uint32_t row_i = 0; row_i < 6; ++row_i) {
+        for (uint32_t brick_i = 0; brick_i < 10; ++brick_i) {
+            occluders.push_back({ { -13.95f + brick_i * 3.1f, 30.0f - row_i * 2.0f, 0 }, { 2, 1, 1 } });
+        }
+    }
+    for (const auto& occluder : occluders) {
+        add_box_occluder(occlusionCuller, occluder.first, occluder.second);
+    }
+    occlusionCuller.rasterize();
+    auto is_sphere_visible = [&](const glm::vec3& center, float radius)
+    {
+        return occlusionCuller.is_visible(center - glm::vec3(radius), center + glm::vec3(radius));
+    };
+
+    // Occluders never hide themselves.
+    for (const auto& occluder : occluders) {
+        EXPECT_TRUE(is_sphere_visible(occluder.first, glm::length(occluder.second * 0.5f)));
+    }
+
+    // Knocked out bricks and balls behind the play field barriers, the bricks and
+    //  the paddle are still visible.
+    const float BrickRadius = glm::length(glm::vec3(2, 1, 1) * 0.5f);
+    for (auto z : { 1.0f, 2.0f, 4.0f, 7.5f }) {
+        for (const auto& occluder : occluders) {
+            EXPECT_TRUE(is_sphere_visible(occluder.first + glm::vec3(0, 0, z), BrickRadius));
+            EXPECT_TRUE(is_sphere_visible(occluder.first + glm::vec3(0, 0, z), 0.5f));
+        }
+        for (auto x : { -16.5f, -15.5f, 15.5f, 16.5f }) {
+            EXPECT_TRUE(is_sphere_visible({ x, 10, z }, BrickRadius));
+        }
+    }
+}
+
+TEST(OcclusionCuller, InstructionSets)
+{
+    // Every instruction set produces the same depth buffer and results.
+    auto initialInstructionSet = batch::get_instruction_set();
+    std::vector<std::vector<float>> depths;
+    std::vector<std::vector<bool>> visibility;
+    for (auto instructionSet : { batch::InstructionSet::Scalar, batch::InstructionSet::Sse2, batch::InstructionSet::Avx2, batch::InstructionSet::Neon }) {
+        if (!batch::is_supported(instructionSet)) {
+            continue;
+        }
+        batch::set_instruction_set(instructionSet);
+        std::mt19937 generator(3);
+        auto occlusionCuller = create_occlusion_culler();
+        occlusionCuller.begin_frame(create_test_view_projection({ 0, 5, 40 }, { 0, 0, 0 }));
+        add_random_occluders(generator, occlusionCuller);
+        occlusionCuller.rasterize();
+        auto occlusionCullerDepths = occlusionCuller.get_depths();
+        depths.emplace_back(occlusionCullerDepths.begin(), occlusionCullerDepths.end());
+        std::uniform_real_distribution<float> positionDistribution(-30, 30);
+        std::uniform_real_distribution<float> extentDistribution(0.1f, 4);
+        visibility.emplace_back();
+        for (uint32_t i = 0; i < 1024; ++i) {
+            glm::vec3 center { positionDistribution(generator), positionDistribution(generator), positionDistribution(generator) };
+            glm::vec3 extents { extentDistribution(generator), extentDistribution(generator), extentDistribution(generator) };
+            visibility.back().push_back(is_box_visible(occlusionCuller, center, extents));
+        }
+    }
+    batch::set_instruction_set(initialInstructionSet);
+    ASSERT_FALSE(depths.empty());
+    EXPECT_NE(std::count(visibility[0].begin(), visibility[0].end(), true), 0);
+    EXPECT_NE(std::count(visibility[0].begin(), visibility[0].end(), false), 0);
+    for (size_t i = 1; i < depths.size(); ++i) {
+        EXPECT_EQ(depths[i], depths[0]);
+        EXPECT_EQ(visibility[i], visibility[0]);
+    }
+}
+
+TEST(OcclusionCuller, ParallelRasterize)
+{
+    JobSystem::CreateInfo jobSystemCreateInfo { };
+    jobSystemCreateInfo.workerCount = 3;
+    JobSystem jobSystem;
+    JobSystem::create(&jobSystemCreateInfo, &jobSystem);
+    std::mt19937 generator(5);
+    auto occlusionCuller = create_occlusion_culler();
+    occlusionCuller.begin_frame(create_test_view_projection({ 0, 5, 40 }, { 0, 0, 0 }));
+    add_random_occluders(generator, occlusionCuller);
+    occlusionCuller.rasterize();
+    auto depths = occlusionCuller.get_depths();
+    std::vector<float> expected(depths.begin(), depths.end());
+    occlusionCuller.rasterize(jobSystem);
+    depths = occlusionCuller.get_depths();
+    EXPECT_EQ(std::vector<float>(depths.begin(), depths.end()), expected);
+}
+
+} // namespace tests
+} // namespace gfx
+} // namespace dst
@@ -0,0 +1,232 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+
+#include "dynamic-static.graphics/pipeline-builder.hpp"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace dst {
+namespace gfx {
+namespace tests {
+
+static gvk::spirv::ShaderInfo create_test_shader_info(VkShaderStageFlagBits stage, uint32_t variant)
+{
+    gvk::spirv::ShaderInfo shaderInfo { };
+    shaderInfo.language = gvk::spirv::ShadingLanguage::Glsl;
+    shaderInfo.stage = stage;
+    shaderInfo.source = "#version 450\n#define VARIANT " + std::to_string(variant) + "\nvoid main() { }\n";
+    return shaderInfo;
+}
+
+// Stands in for a SPIR-V compiler, "compiles" a shader to its source's hash and
+//  reports an error for sources containing "error".
+static void test_compile(gvk::spirv::ShaderInfo* pShaderInfo)
+{
+    if (pShaderInfo->source.find("error") != std::string::npos) {
+        pShaderInfo->errors.push_back("error");
+    } else {
+        auto hash = ShaderCache::hash({ (const uint8_t*)pShaderInfo->source.data(), pShaderInfo->source.size() });
+        pShaderInfo->spirv = { 0x07230203, (uint32_t)hash, (uint32_t)(hash >> 32) };
+    }
+}
+
+TEST(PipelineBuilder, Build)
+{
+    JobSystem::CreateInfo jobSystemCreateInfo { };
+    jobSystemCreateInfo.workerCount = 3;
+    JobSystem jobSystem;
+    JobSystem::create(&jobSystemCreateInfo, &jobSystem);
+    std::atomic<uint32_t> compileCount { 0 };
+    PipelineBuilder::CreateInfo pipelineBuilderCreateInfo { };
+    pipelineBuilderCreateInfo.pJobSystem = &jobSystem;
+    pipelineBuilderCreateInfo.compile = [&](gvk::spirv::ShaderInfo* pShaderInfo)
+    {
+        ++compileCount;
+        test_compile(pShaderInfo);
+    };
+    PipelineBuilder pipelineBuilder;
+    PipelineBuilder::create(&pipelineBuilderCreateInfo, &pipelineBuilder);
+
+    // 32 variants share 4 vertex shaders and 2 fragment shaders.
+    std::atomic<uint32_t> createCount { 0 };
+    std::vector<PipelineBuilder::Description> descriptions(32);
+    for (uint32_t i = 0; i < descriptions.size(); ++i) {
+        descriptions[i].shaderInfos = {
+            create_test_shader_info(VK_SHADER_STAGE_VERTEX_BIT, i % 4),
+            create_test_shader_info(VK_SHADER_STAGE_FRAGMENT_BIT, i % 2),
+        };
+        descriptions[i].create = [&, i](std::span<const gvk::spirv::ShaderInfo> shaderInfos)
+        {
+            ++createCount;
+            EXPECT_EQ(shaderInfos.size(), 2);
+            for (const auto& shaderInfo : shaderInfos) {
+                EXPECT_EQ(shaderInfo.spirv.size(), 3);
+            }
+            return i % 8 ? VK_SUCCESS : VK_ERROR_INITIALIZATION_FAILED;
+        };
+    }
+    auto futures = pipelineBuilder.build(std::move(descriptions));
+    ASSERT_EQ(futures.size(), 32);
+    for (uint32_t i = 0; i < futures.size(); ++i) {
+        ASSERT_TRUE(futures[i].valid());
+        EXPECT_EQ(futures[i].get(), i % 8 ? VK_SUCCESS : VK_ERROR_INITIALIZATION_FAILED);
+        EXPECT_TRUE(futures[i].is_ready());
+        ASSERT_EQ(futures[i].get_shader_infos().size(), 2);
+        auto expectedShaderInfo = create_test_shader_info(VK_SHADER_STAGE_VERTEX_BIT, i % 4);
+        test_compile(&expectedShaderInfo);
+        EXPECT_EQ(futures[i].get_shader_infos()[0].spirv, expectedShaderInfo.spirv);
+    }
+    EXPECT_EQ(compileCount, 6);
+    EXPECT_EQ(createCount, 32);
+    EXPECT_EQ(pipelineBuilder.get_statistics().pipelineCount, 32);
+    EXPECT_EQ(pipelineBuilder.get_statistics().shaderCount, 6);
+    EXPECT_EQ(pipelineBuilder.get_statistics().sharedShaderCount, 58);
+
+    // Shaders compiled by a previous call to build() are reused.
+    PipelineBuilder::Description description { };
+    description.shaderInfos = { create_test_shader_info(VK_SHADER_STAGE_VERTEX_BIT, 0) };
+    description.create = [](std::span<const gvk::spirv::ShaderInfo>) { return VK_SUCCESS; };
+    EXPECT_EQ(pipelineBuilder.build(std::move(description)).get(), VK_SUCCESS);
+    EXPECT_EQ(compileCount, 6);
+}
+
+TEST(PipelineBuilder, Errors)
+{
+    JobSystem::CreateInfo jobSystemCreateInfo { };
+    jobSystemCreateInfo.workerCount = 2;
+    JobSystem jobSystem;
+    JobSystem::create(&jobSystemCreateInfo, &jobSystem);
+    PipelineBuilder::CreateInfo pipelineBuilderCreateInfo { };
+    pipelineBuilderCreateInfo.pJobSystem = &jobSystem;
+    pipelineBuilderCreateInfo.compile = test_compile;
+    PipelineBuilder pipelineBuilder;
+    PipelineBuilder::create(&pipelineBuilderCreateInfo, &pipelineBuilder);
+    auto errorShaderInfo = create_test_shader_info(VK_SHADER_STAGE_FRAGMENT_BIT, 0);
+    errorShaderInfo.source += "error";
+    std::atomic<uint32_t> createCount { 0 };
+    std::vector<PipelineBuilder::Description> descriptions(2);
+    descriptions[0].shaderInfos = { create_test_shader_info(VK_SHADER_STAGE_VERTEX_BIT, 0), errorShaderInfo };
+    descriptions[1].shaderInfos = { create_test_shader_info(VK_SHADER_STAGE_VERTEX_BIT, 0) };
+    for (auto& description : descriptions) {
+        description.create = [&](std::span<const gvk::spirv::ShaderInfo>) { ++createCount; return VK_SUCCESS; };
+    }
+    auto futures = pipelineBuilder.build(std::move(descriptions));
+    EXPECT_EQ(futures[0].get(), VK_ERROR_INITIALIZATION_FAILED);
+    EXPECT_TRUE(futures[0].get_shader_infos()[0].errors.empty());
+    EXPECT_EQ(futures[0].get_shader_infos()[1].errors.size(), 1);
+    EXPECT_EQ(futures[1].get(), VK_SUCCESS);
+    EXPECT_EQ(createCount, 1);
+}
+
+TEST(PipelineBuilder, Concurrency)
+{
+    JobSystem::CreateInfo jobSystemCreateInfo { };
+    jobSystemCreateInfo.workerCount = 3;
+    JobSystem jobSystem;
+    JobSystem::create(&jobSystemCreateInfo, &jobSystem);
+    std::atomic<uint32_t> activeCompileCount { 0 };
+    std::atomic<uint32_t> maxActiveCompileCount { 0 };
+    PipelineBuilder::CreateInfo pipelineBuilderCreateInfo { };
+    pipelineBuilderCreateInfo.pJobSystem = &jobSystem;
+    pipelineBuilderCreateInfo.compile = [&](gvk::spirv::ShaderInfo* pShaderInfo)
+    {
+        auto activeCount = ++activeCompileCount;
+        auto maxActiveCount = maxActiveCompileCount.load();
+        while (maxActiveCount < activeCount && !maxActiveCompileCount.compare_exchange_weak(maxActiveCount, activeCount)) { }
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        test_compile(pShaderInfo);
+        --activeCompileCount;
+    };
+    PipelineBuilder pipelineBuilder;
+    PipelineBuilder::create(&pipelineBuilderCreateInfo, &pipelineBuilder);
+    for (uint32_t i = 0; i < 8; ++i) {
+        PipelineBuilder::Description description { };
+        description.shaderInfos = { create_test_shader_info(VK_SHADER_STAGE_VERTEX_BIT, i) };
+        description.create = [](std::span<const gvk::spirv::ShaderInfo>) { return VK_SUCCESS; };
+        pipelineBuilder.build(std::move(description));
+    }
+    pipelineBuilder.wait();
+    EXPECT_LT(1u, maxActiveCompileCount.load());
+}
+
+TEST(PipelineBuilder, ShaderCache)
+{
+    auto directory = std::filesystem::temp_directory_path() / "dynamic-static.pipeline-builder.tests";
+    std::filesystem::remove_all(directory);
+    ShaderCache::CreateInfo shaderCacheCreateInfo { };
+    shaderCacheCreateInfo.directory = directory;
+    ShaderCache shaderCache;
+    ASSERT_TRUE(ShaderCache::create(&shaderCacheCreateInfo, &shaderCache));
+    JobSystem::CreateInfo jobSystemCreateInfo { };
+    jobSystemCreateInfo.workerCount = 3;
+    JobSystem jobSystem;
+    JobSystem::create(&jobSystemCreateInfo, &jobSystem);
+    std::atomic<uint32_t> compileCount { 0 };
+    PipelineBuilder::CreateInfo pipelineBuilderCreateInfo { };
+    pipelineBuilderCreateInfo.pJobSystem = &jobSystem;
+    pipelineBuilderCreateInfo.pShaderCache = &shaderCache;
+    pipelineBuilderCreateInfo.compile = [&](gvk::spirv::ShaderInfo* pShaderInfo)
+    {
+        ++compileCount;
+        test_compile(pShaderInfo);
+    };
+
+    // The second PipelineBuilder starts with no compiled shaders so every shader
+    //  is loaded from the ShaderCache.
+    for (uint32_t launch_i = 0; launch_i < 2; ++launch_i) {
+        PipelineBuilder pipelineBuilder;
+        PipelineBuilder::create(&pipelineBuilderCreateInfo, &pipelineBuilder);
+        std::vector<PipelineBuilder::Description> descriptions(16);
+        for (uint32_t i = 0; i < descriptions.size(); ++i) {
+            descriptions[i].shaderInfos = { create_test_shader_info(VK_SHADER_STAGE_VERTEX_BIT, i) };
+            descriptions[i].create = [](std::span<const gvk::spirv::ShaderInfo> shaderInfos)
+            {
+                return shaderInfos[0].spirv.empty() ? VK_ERROR_INITIALIZATION_FAILED : VK_SUCCESS;
+            };
+        }
+        for (const auto& future : pipelineBuilder.build(std::move(descriptions))) {
+            EXPECT_EQ(future.get(), VK_SUCCESS);
+        }
+    }
+    EXPECT_EQ(compileCount, 16);
+    EXPECT_EQ(shaderCache.get_statistics().missCount, 16);
+    EXPECT_EQ(shaderCache.get_statistics().hitCount, 16);
+    std::filesystem::remove_all(directory);
+}
+
+} // namespace tests
+} // namespace gfx
+} // namespace dst
@@ -0,0 +1,134 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+
+#include "dynamic-static.graphics/render-queue.hpp"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace dst {
+namespace gfx {
+namespace tests {
+
+TEST(RenderQueue, SortKeyOrder)
+{
+    // Each field outranks every field after it.
+    EXPECT_LT(RenderQueue::create_sort_key(0, 1023, 65535, 1), RenderQueue::create_sort_key(1, 0, 0, 0));
+    EXPECT_LT(RenderQueue::create_sort_key(0, 0, 65535, 1), RenderQueue::create_sort_key(0, 1, 0, 0));
+    EXPECT_LT(RenderQueue::create_sort_key(0, 0, 0, 1), RenderQueue::create_sort_key(0, 0, 1, 0));
+    EXPECT_LT(RenderQueue::create_sort_key(0, 0, 0, 0.25f), RenderQueue::create_sort_key(0, 0, 0, 0.5f));
+    EXPECT_EQ(RenderQueue::create_sort_key(0, 0, 0, -1), RenderQueue::create_sort_key(0, 0, 0, 0));
+    EXPECT_EQ(RenderQueue::create_sort_key(0, 0, 0, 2), RenderQueue::create_sort_key(0, 0, 0, 1));
+}
+
+TEST(RenderQueue, Sort)
+{
+    // The sort must match a stable comparison sort, including the order of
+    //  submissions with equal keys, for queues on both sides of the radix sort
+    //  threshold.
+    for (uint32_t count : { 100, 5000 }) {
+        RenderQueue::CreateInfo renderQueueCreateInfo { };
+        RenderQueue renderQueue;
+        RenderQueue::create(&renderQueueCreateInfo, &renderQueue);
+        std::mt19937 generator(count);
+        std::uniform_int_distribution<uint32_t> pipelineDistribution(0, 3);
+        std::uniform_int_distribution<uint32_t> materialDistribution(0, 1000);
+        std::uniform_int_distribution<uint32_t> meshDistribution(0, 40000);
+        std::uniform_int_distribution<uint32_t> depthDistribution(0, 16);
+        std::vector<std::pair<uint64_t, uint32_t>> expected;
+        for (uint32_t i = 0; i < count; ++i) {
+            auto sortKey = RenderQueue::create_sort_key(
+                pipelineDistribution(generator),
+                materialDistribution(generator),
+                meshDistribution(generator),
+                depthDistribution(generator) / 16.0f
+            );
+            renderQueue.submit(sortKey, i);
+            expected.push_back({ sortKey, i });
+        }
+        std::stable_sort(expected.begin(), expected.end(), [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+        const auto& draws = renderQueue.sort();
+        ASSERT_EQ(draws.size(), expected.size());
+        for (size_t i = 0; i < draws.size(); ++i) {
+            EXPECT_EQ(draws[i].item, expected[i].second);
+        }
+    }
+}
+
+TEST(RenderQueue, StateChanges)
+{
+    RenderQueue::CreateInfo renderQueueCreateInfo { };
+    RenderQueue renderQueue;
+    RenderQueue::create(&renderQueueCreateInfo, &renderQueue);
+    renderQueue.submit(1, 0, 2, 0.5f, 0);
+    renderQueue.submit(0, 0, 1, 0.5f, 1);
+    renderQueue.submit(0, 0, 1, 0.1f, 2);
+    renderQueue.submit(0, 3, 1, 0.0f, 3);
+    renderQueue.submit(1, 0, 2, 0.2f, 4);
+    const auto& draws = renderQueue.sort();
+    ASSERT_EQ(draws.size(), 5);
+    using Draw = RenderQueue::Draw;
+    EXPECT_EQ(draws[0].item, 2);
+    EXPECT_EQ(draws[0].flags, Draw::BindPipeline | Draw::BindMaterial | Draw::BindMesh);
+    EXPECT_EQ(draws[1].item, 1);
+    EXPECT_EQ(draws[1].flags, 0);
+    EXPECT_EQ(draws[2].item, 3);
+    EXPECT_EQ(draws[2].flags, Draw::BindMaterial);
+    EXPECT_EQ(draws[3].item, 4);
+    EXPECT_EQ(draws[3].flags, Draw::BindPipeline | Draw::BindMaterial | Draw::BindMesh);
+    EXPECT_EQ(draws[3].pipeline, 1);
+    EXPECT_EQ(draws[3].mesh, 2);
+    EXPECT_EQ(draws[4].item, 0);
+    EXPECT_EQ(draws[4].flags, 0);
+    const auto& statistics = renderQueue.get_statistics();
+    EXPECT_EQ(statistics.pipelineBindCount, 2);
+    EXPECT_EQ(statistics.materialBindCount, 3);
+    EXPECT_EQ(statistics.meshBindCount, 2);
+    EXPECT_EQ(statistics.drawCount, 5);
+}
+
+TEST(RenderQueue, Clear)
+{
+    RenderQueue::CreateInfo renderQueueCreateInfo { };
+    RenderQueue renderQueue;
+    RenderQueue::create(&renderQueueCreateInfo, &renderQueue);
+    EXPECT_TRUE(renderQueue.sort().empty());
+    renderQueue.submit(0, 0, 0, 0, 0);
+    EXPECT_EQ(renderQueue.sort().size(), 1);
+    renderQueue.clear();
+    EXPECT_EQ(renderQueue.size(), 0);
+    EXPECT_TRUE(renderQueue.get_draws().empty());
+    EXPECT_EQ(renderQueue.get_statistics().drawCount, 0);
+}
+
+} // namespace tests
+} // namespace gfx
+} // namespace dst
@@ -0,0 +1,113 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+
+#include "dynamic-static.graphics/resource-table.hpp"
+
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <set>
+
+namespace dst {
+namespace gfx {
+namespace tests {
+
+TEST(DescriptorSlotAllocator, Allocate)
+{
+    DescriptorSlotAllocator::CreateInfo descriptorSlotAllocatorCreateInfo { };
+    descriptorSlotAllocatorCreateInfo.capacity = 4;
+    DescriptorSlotAllocator descriptorSlotAllocator;
+    DescriptorSlotAllocator::create(&descriptorSlotAllocatorCreateInfo, &descriptorSlotAllocator);
+    std::set<uint32_t> slots;
+    for (uint32_t i = 0; i < 4; ++i) {
+        uint32_t slot = 0;
+        EXPECT_TRUE(descriptorSlotAllocator.allocate(&slot));
+        EXPECT_EQ(slot, i);
+        slots.insert(slot);
+    }
+    EXPECT_EQ(slots.size(), 4);
+    EXPECT_EQ(descriptorSlotAllocator.get_used_count(), 4);
+    uint32_t slot = 12345;
+    EXPECT_FALSE(descriptorSlotAllocator.allocate(&slot));
+    EXPECT_EQ(slot, 12345);
+}
+
+TEST(DescriptorSlotAllocator, DeferredFree)
+{
+    // A freed slot isn't reused until its frame comes back around.
+    DescriptorSlotAllocator::CreateInfo descriptorSlotAllocatorCreateInfo { };
+    descriptorSlotAllocatorCreateInfo.capacity = 2;
+    descriptorSlotAllocatorCreateInfo.frameCount = 2;
+    DescriptorSlotAllocator descriptorSlotAllocator;
+    DescriptorSlotAllocator::create(&descriptorSlotAllocatorCreateInfo, &descriptorSlotAllocator);
+    uint32_t slot0 = 0;
+    uint32_t slot1 = 0;
+    EXPECT_TRUE(descriptorSlotAllocator.allocate(&slot0));
+    EXPECT_TRUE(descriptorSlotAllocator.allocate(&slot1));
+    descriptorSlotAllocator.free(slot0);
+    EXPECT_EQ(descriptorSlotAllocator.get_used_count(), 1);
+    uint32_t slot = 0;
+    EXPECT_FALSE(descriptorSlotAllocator.allocate(&slot));
+    descriptorSlotAllocator.begin_frame(1);
+    EXPECT_FALSE(descriptorSlotAllocator.allocate(&slot));
+    descriptorSlotAllocator.begin_frame(0);
+    EXPECT_TRUE(descriptorSlotAllocator.allocate(&slot));
+    EXPECT_EQ(slot, slot0);
+}
+
+TEST(DescriptorWriteBatch, Merge)
+{
+    // Writes to elements 4, 5, 6 and 9 produce two VkWriteDescriptorSets, the
+    //  second write to element 5 wins.
+    auto get_descriptor_buffer_info = [](uint64_t offset) { return VkDescriptorBufferInfo { nullptr, offset, 16 }; };
+    DescriptorWriteBatch descriptorWriteBatch;
+    descriptorWriteBatch.write(9, get_descriptor_buffer_info(90));
+    descriptorWriteBatch.write(5, get_descriptor_buffer_info(50));
+    descriptorWriteBatch.write(4, get_descriptor_buffer_info(40));
+    descriptorWriteBatch.write(6, get_descriptor_buffer_info(60));
+    descriptorWriteBatch.write(5, get_descriptor_buffer_info(55));
+    EXPECT_EQ(descriptorWriteBatch.size(), 5);
+    const auto& writeDescriptorSets = descriptorWriteBatch.get_write_descriptor_sets(nullptr, 3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER);
+    ASSERT_EQ(writeDescriptorSets.size(), 2);
+    EXPECT_EQ(writeDescriptorSets[0].dstBinding, 3);
+    EXPECT_EQ(writeDescriptorSets[0].descriptorType, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER);
+    EXPECT_EQ(writeDescriptorSets[0].dstArrayElement, 4);
+    ASSERT_EQ(writeDescriptorSets[0].descriptorCount, 3);
+    EXPECT_EQ(writeDescriptorSets[0].pBufferInfo[0].offset, 40);
+    EXPECT_EQ(writeDescriptorSets[0].pBufferInfo[1].offset, 55);
+    EXPECT_EQ(writeDescriptorSets[0].pBufferInfo[2].offset, 60);
+    EXPECT_EQ(writeDescriptorSets[1].dstArrayElement, 9);
+    ASSERT_EQ(writeDescriptorSets[1].descriptorCount, 1);
+    EXPECT_EQ(writeDescriptorSets[1].pBufferInfo[0].offset, 90);
+    descriptorWriteBatch.clear();
+    EXPECT_EQ(descriptorWriteBatch.size(), 0);
+    EXPECT_TRUE(descriptorWriteBatch.get_write_descriptor_sets(nullptr, 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER).empty());
+}
+
+} // namespace tests
+} // namespace gfx
+} // namespace dst
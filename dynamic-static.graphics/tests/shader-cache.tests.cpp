@@ -0,0 +1,205 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+
+#include "dynamic-static.graphics/shader-cache.hpp"
+
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace dst {
+namespace gfx {
+namespace tests {
+
+static std::filesystem::path get_test_directory()
+{
+    return std::filesystem::temp_directory_path() / "dynamic-static.shader-cache.tests";
+}
+
+static gvk::spirv::ShaderInfo create_test_shader_info()
+{
+    gvk::spirv::ShaderInfo shaderInfo { };
+    shaderInfo.language = gvk::spirv::ShadingLanguage::Glsl;
+    shaderInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
+    shaderInfo.source = "#version 450\nvoid main() { }\n";
+    return shaderInfo;
+}
+
+TEST(ShaderCache, Key)
+{
+    auto shaderInfo = create_test_shader_info();
+    auto key = ShaderCache::create_key(shaderInfo);
+    EXPECT_EQ(key, ShaderCache::create_key(create_test_shader_info()));
+    auto fragmentShaderInfo = shaderInfo;
+    fragmentShaderInfo.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+    EXPECT_NE(key, ShaderCache::create_key(fragmentShaderInfo));
+    auto modifiedShaderInfo = shaderInfo;
+    modifiedShaderInfo.source += " ";
+    EXPECT_NE(key, ShaderCache::create_key(modifiedShaderInfo));
+    std::vector<std::string_view> defines { "A", "B" };
+    std::vector<std::string_view> joinedDefines { "AB" };
+    EXPECT_NE(key, ShaderCache::create_key(shaderInfo, defines));
+    EXPECT_NE(ShaderCache::create_key(shaderInfo, defines), ShaderCache::create_key(shaderInfo, joinedDefines));
+}
+
+TEST(ShaderCache, StoreLoad)
+{
+    std::filesystem::remove_all(get_test_directory());
+    ShaderCache::CreateInfo shaderCacheCreateInfo { };
+    shaderCacheCreateInfo.directory = get_test_directory();
+    ShaderCache shaderCache;
+    ASSERT_TRUE(ShaderCache::create(&shaderCacheCreateInfo, &shaderCache));
+    std::vector<uint32_t> spirv { 0x07230203, 1, 2, 3, 4 };
+    std::vector<uint32_t> loadedSpirv;
+    EXPECT_FALSE(shaderCache.load(42, &loadedSpirv));
+    EXPECT_TRUE(shaderCache.store(42, spirv));
+    EXPECT_TRUE(shaderCache.load(42, &loadedSpirv));
+    EXPECT_EQ(loadedSpirv, spirv);
+    EXPECT_FALSE(shaderCache.load(43, &loadedSpirv));
+
+    // Corrupt the stored SPIR-V, the entry must be rejected.
+    for (const auto& directoryEntry : std::filesystem::directory_iterator(get_test_directory())) {
+        std::fstream file(directoryEntry.path(), std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(-1, std::ios::end);
+        file.put('x');
+    }
+    EXPECT_FALSE(shaderCache.load(42, &loadedSpirv));
+    std::filesystem::remove_all(get_test_directory());
+}
+
+TEST(ShaderCache, ConcurrentStore)
+{
+    // Concurrent stores of the same key each write their own temporary file so
+    //  every store succeeds and no temporary files are left behind.
+    std::filesystem::remove_all(get_test_directory());
+    ShaderCache::CreateInfo shaderCacheCreateInfo { };
+    shaderCacheCreateInfo.directory = get_test_directory();
+    ShaderCache shaderCache;
+    ASSERT_TRUE(ShaderCache::create(&shaderCacheCreateInfo, &shaderCache));
+    std::vector<uint32_t> spirv(4096, 0x07230203);
+    constexpr uint32_t ThreadCount = 8;
+    std::vector<int> stored(ThreadCount, 0);
+    std::vector<std::thread> threads;
+    for (uint32_t thread_i = 0; thread_i < ThreadCount; ++thread_i) {
+        threads.emplace_back(
+            [&, thread_i]()
+            {
+                for (int i = 0; i < 16; ++i) {
+                    stored[thread_i] += shaderCache.store(42, spirv) ? 1 : 0;
+                }
+            }
+        );
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(stored, std::vector<int>(ThreadCount, 16));
+    std::vector<uint32_t> loadedSpirv;
+    EXPECT_TRUE(shaderCache.load(42, &loadedSpirv));
+    EXPECT_EQ(loadedSpirv, spirv);
+    for (const auto& directoryEntry : std::filesystem::directory_iterator(get_test_directory())) {
+        EXPECT_NE(directoryEntry.path().extension(), ".tmp");
+    }
+    std::filesystem::remove_all(get_test_directory());
+}
+
+TEST(ShaderCache, Compile)
+{
+    // The first compile is a miss and invokes the compiler, the second is served
+    //  from the cache, shaders with errors are never stored.
+    std::filesystem::remove_all(get_test_directory());
+    ShaderCache::CreateInfo shaderCacheCreateInfo { };
+    shaderCacheCreateInfo.directory = get_test_directory();
+    ShaderCache shaderCache;
+    ASSERT_TRUE(ShaderCache::create(&shaderCacheCreateInfo, &shaderCache));
+    uint32_t compileCount = 0;
+    auto compile = [&](gvk::spirv::ShaderInfo* pShaderInfo)
+    {
+        ++compileCount;
+        pShaderInfo->spirv = { 0x07230203, (uint32_t)pShaderInfo->source.size() };
+    };
+    auto shaderInfo = create_test_shader_info();
+    EXPECT_TRUE(shaderCache.compile(&shaderInfo, compile));
+    EXPECT_EQ(compileCount, 1);
+    auto cachedShaderInfo = create_test_shader_info();
+    EXPECT_TRUE(shaderCache.compile(&cachedShaderInfo, compile));
+    EXPECT_EQ(compileCount, 1);
+    EXPECT_EQ(cachedShaderInfo.spirv, shaderInfo.spirv);
+    EXPECT_EQ(shaderCache.get_statistics().hitCount, 1);
+    EXPECT_EQ(shaderCache.get_statistics().missCount, 1);
+
+    auto invalidShaderInfo = create_test_shader_info();
+    invalidShaderInfo.source = "invalid";
+    auto compileWithErrors = [&](gvk::spirv::ShaderInfo* pShaderInfo)
+    {
+        ++compileCount;
+        pShaderInfo->errors.push_back("error");
+    };
+    EXPECT_FALSE(shaderCache.compile(&invalidShaderInfo, compileWithErrors));
+    invalidShaderInfo.errors.clear();
+    EXPECT_FALSE(shaderCache.compile(&invalidShaderInfo, compileWithErrors));
+    EXPECT_EQ(compileCount, 3);
+    std::filesystem::remove_all(get_test_directory());
+}
+
+TEST(ShaderCache, ValidatePipelineCacheData)
+{
+    VkPhysicalDeviceProperties physicalDeviceProperties { };
+    physicalDeviceProperties.vendorID = 0x10DE;
+    physicalDeviceProperties.deviceID = 0x2204;
+    for (uint8_t i = 0; i < VK_UUID_SIZE; ++i) {
+        physicalDeviceProperties.pipelineCacheUUID[i] = i;
+    }
+    std::vector<uint8_t> data(64);
+    uint32_t header[4] { 32, VK_PIPELINE_CACHE_HEADER_VERSION_ONE, physicalDeviceProperties.vendorID, physicalDeviceProperties.deviceID };
+    memcpy(data.data(), header, sizeof(header));
+    memcpy(data.data() + sizeof(header), physicalDeviceProperties.pipelineCacheUUID, VK_UUID_SIZE);
+    EXPECT_TRUE(ShaderCache::validate_pipeline_cache_data(data, physicalDeviceProperties));
+    EXPECT_FALSE(ShaderCache::validate_pipeline_cache_data({ data.data(), 31 }, physicalDeviceProperties));
+    auto otherPhysicalDeviceProperties = physicalDeviceProperties;
+    otherPhysicalDeviceProperties.pipelineCacheUUID[7] = 0xFF;
+    EXPECT_FALSE(ShaderCache::validate_pipeline_cache_data(data, otherPhysicalDeviceProperties));
+    otherPhysicalDeviceProperties = physicalDeviceProperties;
+    otherPhysicalDeviceProperties.deviceID = 0;
+    EXPECT_FALSE(ShaderCache::validate_pipeline_cache_data(data, otherPhysicalDeviceProperties));
+    auto invalidData = data;
+    invalidData[4] = 2;
+    EXPECT_FALSE(ShaderCache::validate_pipeline_cache_data(invalidData, physicalDeviceProperties));
+    invalidData = data;
+    invalidData[0] = 128;
+    EXPECT_FALSE(ShaderCache::validate_pipeline_cache_data(invalidData, physicalDeviceProperties));
+}
+
+} // namespace tests
+} // namespace gfx
+} // namespace dst
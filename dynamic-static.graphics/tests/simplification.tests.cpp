@@ -0,0 +1,116 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#include "dynamic-static.graphics/primitives.hpp"
+#include "dynamic-static.graphics/simplification.hpp"
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+namespace dst {
+namespace gfx {
+namespace tests {
+
+TEST(Simplification, Simplify)
+{
+    std::vector<glm::vec3> vertices;
+    std::vector<primitive::Triangle<uint32_t>> triangles;
+    primitive::create_icosphere<uint32_t>(1, 4, &vertices, &triangles);
+    std::vector<primitive::Triangle<uint32_t>> simplified;
+    auto error = simplify<uint32_t>(vertices, triangles, triangles.size() / 4, 1, &simplified);
+    EXPECT_LE(simplified.size(), triangles.size() / 4);
+    EXPECT_LT(0.0f, error);
+    EXPECT_LT(error, 0.05f);
+
+    // Simplification must not flip any triangle, icosphere triangles all wind the
+    //  same way so every normal must face the same side of the surface.
+    for (const auto& triangle : simplified) {
+        const auto& p0 = vertices[triangle[0]];
+        const auto& p1 = vertices[triangle[1]];
+        const auto& p2 = vertices[triangle[2]];
+        auto normal = glm::cross(p1 - p0, p2 - p0);
+        EXPECT_GT(0.0f, glm::dot(normal, p0 + p1 + p2));
+    }
+}
+
+TEST(Simplification, SimplifyRespectsTargetError)
+{
+    std::vector<glm::vec3> vertices;
+    std::vector<primitive::Triangle<uint32_t>> triangles;
+    primitive::create_icosphere<uint32_t>(1, 4, &vertices, &triangles);
+    std::vector<primitive::Triangle<uint32_t>> simplified;
+    auto error = simplify<uint32_t>(vertices, triangles, 0, 0.01f, &simplified);
+    EXPECT_LE(error, 0.01f);
+    EXPECT_LT(simplified.size(), triangles.size());
+    EXPECT_LT(0u, simplified.size());
+}
+
+TEST(Simplification, SimplifyLocksSeams)
+{
+    // Every Cube vertex shares its position with vertices on adjacent faces.
+    std::vector<glm::vec3> vertices(primitive::Cube::Vertices.begin(), primitive::Cube::Vertices.end());
+    std::vector<primitive::Triangle<uint32_t>> triangles(primitive::Cube::Triangles.begin(), primitive::Cube::Triangles.end());
+    std::vector<primitive::Triangle<uint32_t>> simplified;
+    auto error = simplify<uint32_t>(vertices, triangles, 0, 1, &simplified);
+    EXPECT_EQ(error, 0.0f);
+    EXPECT_EQ(simplified, triangles);
+}
+
+TEST(Simplification, CreateLodChain)
+{
+    std::vector<glm::vec3> vertices;
+    std::vector<primitive::Triangle<uint32_t>> triangles;
+    primitive::create_icosphere<uint32_t>(1, 5, &vertices, &triangles);
+    std::vector<LodLevel<uint32_t>> lodLevels;
+    create_lod_chain<uint32_t>(vertices, triangles, { }, &lodLevels);
+    ASSERT_LT(3u, lodLevels.size());
+    EXPECT_EQ(lodLevels[0].triangles, triangles);
+    EXPECT_EQ(lodLevels[0].error, 0.0f);
+    for (size_t lod_i = 1; lod_i < lodLevels.size(); ++lod_i) {
+        EXPECT_LT(lodLevels[lod_i].triangles.size(), lodLevels[lod_i - 1].triangles.size());
+        EXPECT_LE(lodLevels[lod_i - 1].error, lodLevels[lod_i].error);
+    }
+}
+
+TEST(Simplification, SelectLod)
+{
+    std::vector<LodLevel<uint32_t>> lodLevels(4);
+    lodLevels[1].error = 0.01f;
+    lodLevels[2].error = 0.1f;
+    lodLevels[3].error = 1.0f;
+    auto projectionScale = get_lod_projection_scale(1080, glm::radians(60.0f));
+    EXPECT_NEAR(projectionScale, 935.3f, 0.1f);
+    EXPECT_EQ(select_lod<uint32_t>(lodLevels, 1, projectionScale), 0u);
+    EXPECT_EQ(select_lod<uint32_t>(lodLevels, 10, projectionScale), 1u);
+    EXPECT_EQ(select_lod<uint32_t>(lodLevels, 100, projectionScale), 2u);
+    EXPECT_EQ(select_lod<uint32_t>(lodLevels, 1000, projectionScale), 3u);
+    EXPECT_EQ(select_lod<uint32_t>(lodLevels, 100, projectionScale, 0.5f), 1u);
+}
+
+} // namespace tests
+} // namespace gfx
+} // namespace dst
@@ -0,0 +1,114 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#include "dynamic-static.graphics/uniform-ring.hpp"
+
+#include "gtest/gtest.h"
+
+#include <cstdint>
+
+namespace dst {
+namespace gfx {
+namespace tests {
+
+TEST(UniformRingAllocator, Alignment)
+{
+    UniformRingAllocator::CreateInfo uniformRingAllocatorCreateInfo { };
+    uniformRingAllocatorCreateInfo.frameCount = 3;
+    uniformRingAllocatorCreateInfo.frameSize = 1000;
+    uniformRingAllocatorCreateInfo.alignment = 256;
+    UniformRingAllocator uniformRingAllocator;
+    UniformRingAllocator::create(&uniformRingAllocatorCreateInfo, &uniformRingAllocator);
+    EXPECT_EQ(uniformRingAllocator.get_frame_count(), 3);
+    EXPECT_EQ(uniformRingAllocator.get_frame_size(), 1024);
+    EXPECT_EQ(uniformRingAllocator.get_size(), 3072);
+    uint64_t offset = 0;
+    EXPECT_TRUE(uniformRingAllocator.allocate(80, &offset));
+    EXPECT_EQ(offset, 0);
+    EXPECT_TRUE(uniformRingAllocator.allocate(256, &offset));
+    EXPECT_EQ(offset, 256);
+    EXPECT_TRUE(uniformRingAllocator.allocate(257, &offset));
+    EXPECT_EQ(offset, 512);
+    EXPECT_EQ(uniformRingAllocator.get_used_size(), 1024);
+}
+
+TEST(UniformRingAllocator, FrameFull)
+{
+    UniformRingAllocator::CreateInfo uniformRingAllocatorCreateInfo { };
+    uniformRingAllocatorCreateInfo.frameCount = 2;
+    uniformRingAllocatorCreateInfo.frameSize = 512;
+    uniformRingAllocatorCreateInfo.alignment = 64;
+    UniformRingAllocator uniformRingAllocator;
+    UniformRingAllocator::create(&uniformRingAllocatorCreateInfo, &uniformRingAllocator);
+    uint64_t offset = 0;
+    for (uint64_t i = 0; i < 8; ++i) {
+        EXPECT_TRUE(uniformRingAllocator.allocate(64, &offset));
+        EXPECT_EQ(offset, i * 64);
+    }
+    offset = 12345;
+    EXPECT_FALSE(uniformRingAllocator.allocate(1, &offset));
+    EXPECT_EQ(offset, 12345);
+    EXPECT_FALSE(uniformRingAllocator.allocate(1024, &offset));
+}
+
+TEST(UniformRingAllocator, FrameWrap)
+{
+    // Each frame allocates from its own region, beginning a frame again rewinds
+    //  its region without touching the others.
+    UniformRingAllocator::CreateInfo uniformRingAllocatorCreateInfo { };
+    uniformRingAllocatorCreateInfo.frameCount = 3;
+    uniformRingAllocatorCreateInfo.frameSize = 1024;
+    uniformRingAllocatorCreateInfo.alignment = 256;
+    UniformRingAllocator uniformRingAllocator;
+    UniformRingAllocator::create(&uniformRingAllocatorCreateInfo, &uniformRingAllocator);
+    for (uint32_t frame = 0; frame < 10; ++frame) {
+        auto frameIndex = frame % 3;
+        uniformRingAllocator.begin_frame(frameIndex);
+        EXPECT_EQ(uniformRingAllocator.get_frame_index(), frameIndex);
+        EXPECT_EQ(uniformRingAllocator.get_frame_offset(), frameIndex * 1024);
+        EXPECT_EQ(uniformRingAllocator.get_used_size(), 0);
+        for (uint64_t i = 0; i < 4; ++i) {
+            uint64_t offset = 0;
+            EXPECT_TRUE(uniformRingAllocator.allocate(128, &offset));
+            EXPECT_EQ(offset, frameIndex * 1024 + i * 256);
+        }
+        uint64_t offset = 0;
+        EXPECT_FALSE(uniformRingAllocator.allocate(128, &offset));
+    }
+
+    // Frames may begin out of order, ie. in swapchain image order.
+    uniformRingAllocator.begin_frame(2);
+    uint64_t offset = 0;
+    EXPECT_TRUE(uniformRingAllocator.allocate(16, &offset));
+    EXPECT_EQ(offset, 2048);
+    uniformRingAllocator.begin_frame(0);
+    EXPECT_TRUE(uniformRingAllocator.allocate(16, &offset));
+    EXPECT_EQ(offset, 0);
+}
+
+} // namespace tests
+} // namespace gfx
+} // namespace dst
@@ -0,0 +1,161 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+
+#include "dynamic-static.graphics/upload-batcher.hpp"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace dst {
+namespace gfx {
+namespace tests {
+
+TEST(StagingRingAllocator, Alignment)
+{
+    StagingRingAllocator::CreateInfo stagingRingAllocatorCreateInfo { };
+    stagingRingAllocatorCreateInfo.size = 1000;
+    stagingRingAllocatorCreateInfo.alignment = 16;
+    StagingRingAllocator stagingRingAllocator;
+    StagingRingAllocator::create(&stagingRingAllocatorCreateInfo, &stagingRingAllocator);
+    EXPECT_EQ(stagingRingAllocator.get_size(), 1008);
+    uint64_t offset = 0;
+    EXPECT_TRUE(stagingRingAllocator.allocate(12, &offset));
+    EXPECT_EQ(offset, 0);
+    EXPECT_TRUE(stagingRingAllocator.allocate(17, &offset));
+    EXPECT_EQ(offset, 16);
+    EXPECT_TRUE(stagingRingAllocator.allocate(1, &offset));
+    EXPECT_EQ(offset, 48);
+    EXPECT_EQ(stagingRingAllocator.get_head(), 49);
+    EXPECT_EQ(stagingRingAllocator.get_used_size(), 49);
+}
+
+TEST(StagingRingAllocator, FullAndRelease)
+{
+    StagingRingAllocator::CreateInfo stagingRingAllocatorCreateInfo { };
+    stagingRingAllocatorCreateInfo.size = 1024;
+    StagingRingAllocator stagingRingAllocator;
+    StagingRingAllocator::create(&stagingRingAllocatorCreateInfo, &stagingRingAllocator);
+    uint64_t offset = 0;
+    EXPECT_TRUE(stagingRingAllocator.allocate(512, &offset));
+    auto firstBatchHead = stagingRingAllocator.get_head();
+    EXPECT_TRUE(stagingRingAllocator.allocate(256, &offset));
+    EXPECT_TRUE(stagingRingAllocator.allocate(256, &offset));
+    EXPECT_EQ(offset, 768);
+    offset = 12345;
+    EXPECT_FALSE(stagingRingAllocator.allocate(16, &offset));
+    EXPECT_EQ(offset, 12345);
+
+    // Releasing the first batch frees the start of the ring.
+    stagingRingAllocator.release(firstBatchHead);
+    EXPECT_EQ(stagingRingAllocator.get_used_size(), 512);
+    EXPECT_TRUE(stagingRingAllocator.allocate(512, &offset));
+    EXPECT_EQ(offset, 0);
+    EXPECT_FALSE(stagingRingAllocator.allocate(16, &offset));
+}
+
+TEST(StagingRingAllocator, Wrap)
+{
+    StagingRingAllocator::CreateInfo stagingRingAllocatorCreateInfo { };
+    stagingRingAllocatorCreateInfo.size = 1024;
+    StagingRingAllocator stagingRingAllocator;
+    StagingRingAllocator::create(&stagingRingAllocatorCreateInfo, &stagingRingAllocator);
+    uint64_t offset = 0;
+    EXPECT_TRUE(stagingRingAllocator.allocate(256, &offset));
+    auto firstBatchHead = stagingRingAllocator.get_head();
+    EXPECT_TRUE(stagingRingAllocator.allocate(640, &offset));
+    EXPECT_EQ(offset, 256);
+    stagingRingAllocator.release(firstBatchHead);
+
+    // 128 bytes remain at the end of the ring, too few for 192 so the
+    //  allocation wraps to the start and the remainder is skipped.
+    EXPECT_TRUE(stagingRingAllocator.allocate(192, &offset));
+    EXPECT_EQ(offset, 0);
+    EXPECT_EQ(stagingRingAllocator.get_used_size(), 960);
+    EXPECT_FALSE(stagingRingAllocator.allocate(128, &offset));
+    EXPECT_TRUE(stagingRingAllocator.allocate(64, &offset));
+    EXPECT_EQ(offset, 192);
+
+    // An empty ring restarts at its beginning so an allocation of the whole ring
+    //  fits regardless of where the last allocation ended.
+    stagingRingAllocator.release(stagingRingAllocator.get_head());
+    EXPECT_TRUE(stagingRingAllocator.allocate(1024, &offset));
+    EXPECT_EQ(offset, 0);
+}
+
+TEST(StagingRingAllocator, Batches)
+{
+    // Simulates an UploadBatcher, batches of random allocations are released in
+    //  order.  Live allocations must never overlap.
+    StagingRingAllocator::CreateInfo stagingRingAllocatorCreateInfo { };
+    stagingRingAllocatorCreateInfo.size = 64 * 1024;
+    StagingRingAllocator stagingRingAllocator;
+    StagingRingAllocator::create(&stagingRingAllocatorCreateInfo, &stagingRingAllocator);
+    std::vector<uint32_t> owners(stagingRingAllocator.get_size());
+    std::deque<std::pair<uint64_t, std::vector<std::pair<uint64_t, uint64_t>>>> batches;
+    std::vector<std::pair<uint64_t, uint64_t>> allocations;
+    std::mt19937 generator(7);
+    std::uniform_int_distribution<uint64_t> sizeDistribution(1, 16 * 1024);
+    uint32_t owner = 0;
+    for (uint32_t i = 0; i < 4096; ++i) {
+        auto size = sizeDistribution(generator);
+        uint64_t offset = 0;
+        while (!stagingRingAllocator.allocate(size, &offset)) {
+            if (!allocations.empty()) {
+                batches.push_back({ stagingRingAllocator.get_head(), std::move(allocations) });
+                allocations.clear();
+            }
+            ASSERT_FALSE(batches.empty());
+            for (const auto& allocation : batches.front().second) {
+                std::fill_n(owners.begin() + allocation.first, allocation.second, 0);
+            }
+            stagingRingAllocator.release(batches.front().first);
+            batches.pop_front();
+        }
+        ASSERT_EQ(offset % 16, 0);
+        ASSERT_LE(offset + size, stagingRingAllocator.get_size());
+        ++owner;
+        for (uint64_t byte_i = offset; byte_i < offset + size; ++byte_i) {
+            ASSERT_EQ(owners[byte_i], 0);
+            owners[byte_i] = owner;
+        }
+        allocations.push_back({ offset, size });
+        if (i % 5 == 4) {
+            batches.push_back({ stagingRingAllocator.get_head(), std::move(allocations) });
+            allocations.clear();
+        }
+    }
+}
+
+} // namespace tests
+} // namespace gfx
+} // namespace dst
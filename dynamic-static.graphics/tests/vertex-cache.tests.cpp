@@ -0,0 +1,153 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#include "dynamic-static.graphics/primitives.hpp"
+#include "dynamic-static.graphics/vertex-cache.hpp"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <set>
+#include <vector>
+
+namespace dst {
+namespace gfx {
+namespace tests {
+
+using Triangles = std::vector<primitive::Triangle<uint32_t>>;
+
+static std::multiset<std::array<float, 9>> get_triangle_positions(const Triangles& triangles, const std::vector<glm::vec3>& vertices)
+{
+    std::multiset<std::array<float, 9>> trianglePositions;
+    for (const auto& triangle : triangles) {
+        // Rotate so the smallest index comes first, winding is preserved.
+        std::array<glm::vec3, 3> positions { vertices[triangle[0]], vertices[triangle[1]], vertices[triangle[2]] };
+        auto compare = [](const glm::vec3& lhs, const glm::vec3& rhs) { return std::tie(lhs.x, lhs.y, lhs.z) < std::tie(rhs.x, rhs.y, rhs.z); };
+        std::rotate(positions.begin(), std::min_element(positions.begin(), positions.end(), compare), positions.end());
+        trianglePositions.insert({
+            positions[0].x, positions[0].y, positions[0].z,
+            positions[1].x, positions[1].y, positions[1].z,
+            positions[2].x, positions[2].y, positions[2].z,
+        });
+    }
+    return trianglePositions;
+}
+
+TEST(VertexCache, AnalyzeVertexCache)
+{
+    // Two triangles sharing an edge, every vertex is transformed once.
+    Triangles triangles { { 0, 1, 2 }, { 2, 1, 3 } };
+    auto statistics = analyze_vertex_cache<uint32_t>(triangles, 4);
+    EXPECT_EQ(statistics.vertexTransformCount, 4u);
+    EXPECT_FLOAT_EQ(statistics.acmr, 2.0f);
+    EXPECT_FLOAT_EQ(statistics.atvr, 1.0f);
+
+    // With a cache size of 3, vertex 0 is evicted before it's referenced again.
+    triangles = { { 0, 1, 2 }, { 3, 4, 5 }, { 0, 1, 2 } };
+    statistics = analyze_vertex_cache<uint32_t>(triangles, 6, 3);
+    EXPECT_EQ(statistics.vertexTransformCount, 9u);
+    EXPECT_FLOAT_EQ(statistics.atvr, 1.5f);
+}
+
+TEST(VertexCache, OptimizeVertexCache)
+{
+    std::vector<glm::vec3> vertices;
+    Triangles triangles;
+    primitive::create_icosphere<uint32_t>(1, 4, &vertices, &triangles);
+    auto expectedTrianglePositions = get_triangle_positions(triangles, vertices);
+    auto before = analyze_vertex_cache<uint32_t>(triangles, vertices.size());
+    optimize_vertex_cache<uint32_t>(triangles, vertices.size());
+    auto after = analyze_vertex_cache<uint32_t>(triangles, vertices.size());
+    EXPECT_EQ(get_triangle_positions(triangles, vertices), expectedTrianglePositions);
+    EXPECT_LT(after.acmr, before.acmr);
+    EXPECT_LT(after.atvr, before.atvr);
+    EXPECT_LT(after.acmr, 0.8f);
+}
+
+TEST(VertexCache, OptimizeOverdraw)
+{
+    std::vector<glm::vec3> vertices;
+    Triangles triangles;
+    primitive::create_icosphere<uint32_t>(1, 3, &vertices, &triangles);
+    optimize_vertex_cache<uint32_t>(triangles, vertices.size());
+    auto expectedTrianglePositions = get_triangle_positions(triangles, vertices);
+    auto before = analyze_vertex_cache<uint32_t>(triangles, vertices.size());
+    optimize_overdraw<uint32_t>(triangles, vertices);
+    auto after = analyze_vertex_cache<uint32_t>(triangles, vertices.size());
+    EXPECT_EQ(get_triangle_positions(triangles, vertices), expectedTrianglePositions);
+    EXPECT_LE(after.acmr, before.acmr * 1.1f);
+}
+
+TEST(VertexCache, OptimizeOverdrawDegenerateFirstTriangle)
+{
+    // The first triangle is degenerate so it misses the cache on fewer than 3
+    //  vertices, it must still be in the output along with every other triangle.
+    std::vector<glm::vec3> vertices {
+        { 0, 0, 0 }, { 1, 0, 0 },
+        { 0, 0, 1 }, { 1, 0, 1 }, { 0, 1, 1 },
+        { 0, 0, -1 }, { 0, 1, -1 }, { 1, 0, -1 },
+    };
+    Triangles triangles { { 0, 0, 1 }, { 2, 3, 4 }, { 5, 6, 7 } };
+    auto sort_triangles = [](Triangles triangles)
+    {
+        for (auto& triangle : triangles) {
+            std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+        }
+        std::sort(triangles.begin(), triangles.end());
+        return triangles;
+    };
+    auto expectedTriangles = sort_triangles(triangles);
+    optimize_overdraw<uint32_t>(triangles, vertices);
+    EXPECT_EQ(sort_triangles(triangles), expectedTriangles);
+}
+
+TEST(VertexCache, OptimizeVertexFetch)
+{
+    std::vector<glm::vec3> vertices;
+    Triangles triangles;
+    primitive::create_icosphere<uint32_t>(1, 3, &vertices, &triangles);
+    auto usedVertexCount = vertices.size();
+    vertices.push_back({ 4, 4, 4 });
+    optimize_vertex_cache<uint32_t>(triangles, vertices.size());
+    auto expectedTrianglePositions = get_triangle_positions(triangles, vertices);
+    auto vertexCount = optimize_vertex_fetch<uint32_t>(triangles, &vertices);
+    EXPECT_EQ(vertexCount, usedVertexCount);
+    EXPECT_EQ(vertexCount, vertices.size());
+    EXPECT_EQ(std::count(vertices.begin(), vertices.end(), glm::vec3 { 4, 4, 4 }), 0);
+    EXPECT_EQ(get_triangle_positions(triangles, vertices), expectedTrianglePositions);
+    uint32_t nextIndex = 0;
+    for (const auto& triangle : triangles) {
+        for (auto index : triangle) {
+            EXPECT_LE(index, nextIndex);
+            nextIndex = std::max(nextIndex, index + 1);
+        }
+    }
+    EXPECT_EQ(nextIndex, vertexCount);
+}
+
+} // namespace tests
+} // namespace gfx
+} // namespace dst
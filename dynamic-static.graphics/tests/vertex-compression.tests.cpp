@@ -0,0 +1,175 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#include "dynamic-static.graphics/defines.hpp"
+#include "dynamic-static.graphics/vertex-compression.hpp"
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace dst {
+namespace gfx {
+namespace tests {
+
+static std::vector<VertexPositionNormalTexcoordColor> create_random_vertices(size_t count)
+{
+    std::mt19937 rng(0);
+    std::uniform_real_distribution<float> positionDistribution(-100, 100);
+    std::uniform_real_distribution<float> unitDistribution(-1, 1);
+    std::uniform_real_distribution<float> texcoordDistribution(-4, 4);
+    std::uniform_real_distribution<float> colorDistribution(0, 1);
+    std::vector<VertexPositionNormalTexcoordColor> vertices(count);
+    for (auto& vertex : vertices) {
+        vertex.position = { positionDistribution(rng), positionDistribution(rng), positionDistribution(rng) };
+        do {
+            vertex.normal = { unitDistribution(rng), unitDistribution(rng), unitDistribution(rng) };
+        } while (glm::length(vertex.normal) < 0.01f);
+        vertex.normal = glm::normalize(vertex.normal);
+        vertex.texcoord = { texcoordDistribution(rng), texcoordDistribution(rng) };
+        vertex.color = { colorDistribution(rng), colorDistribution(rng), colorDistribution(rng), colorDistribution(rng) };
+    }
+    // Edge cases...axis aligned normals, bounds extremes, etc.
+    vertices[0].normal = { 0, 0, -1 };
+    vertices[1].normal = { 0, 0, 1 };
+    vertices[2].normal = { -1, 0, 0 };
+    vertices[3].normal = { 0, -1, 0 };
+    vertices[4].color = { 0, 1, 0, 1 };
+    vertices[5].texcoord = { 0, 1 };
+    return vertices;
+}
+
+TEST(VertexCompression, HalfConversion)
+{
+    EXPECT_EQ(float_to_half(0.0f), 0x0000);
+    EXPECT_EQ(float_to_half(-0.0f), 0x8000);
+    EXPECT_EQ(float_to_half(1.0f), 0x3c00);
+    EXPECT_EQ(float_to_half(-2.0f), 0xc000);
+    EXPECT_EQ(float_to_half(65504.0f), 0x7bff);
+    EXPECT_EQ(float_to_half(65520.0f), 0x7c00);
+    EXPECT_EQ(float_to_half(std::ldexp(1.0f, -24)), 0x0001);
+    EXPECT_EQ(float_to_half(std::ldexp(1.0f, -14)), 0x0400);
+    EXPECT_EQ(float_to_half(INFINITY), 0x7c00);
+    EXPECT_TRUE(std::isnan(half_to_float(float_to_half(NAN))));
+    for (uint32_t i = 0; i < 0x7c00; ++i) {
+        auto value = half_to_float((uint16_t)i);
+        EXPECT_EQ(float_to_half(value), i);
+        EXPECT_EQ(float_to_half(-value), i | 0x8000);
+    }
+    // 1 + 2^-11 is halfway between two halfs and rounds to even.
+    EXPECT_EQ(float_to_half(1.0f + std::ldexp(1.0f, -11)), 0x3c00);
+    EXPECT_EQ(float_to_half(1.0f + 3 * std::ldexp(1.0f, -11)), 0x3c02);
+}
+
+TEST(VertexCompression, ErrorBounds)
+{
+    auto vertices = create_random_vertices(1027);
+    auto bounds = compute_quantization_bounds(vertices.size(), &vertices[0].position, sizeof(vertices[0]));
+    std::vector<PackedVertexPositionNormalTexcoordColor> packedVertices(vertices.size());
+    pack_vertices<VertexPositionNormalTexcoordColor, PackedVertexPositionNormalTexcoordColor>(vertices, bounds, packedVertices);
+    std::vector<VertexPositionNormalTexcoordColor> unpackedVertices(vertices.size());
+    unpack_vertices<PackedVertexPositionNormalTexcoordColor, VertexPositionNormalTexcoordColor>(packedVertices, bounds, unpackedVertices);
+
+    // Positions are within half a quantization step (plus float rounding).
+    auto positionError = bounds.extent * (0.5f / 65535.0f) + glm::vec3 { 0.0001f };
+    // 16 bit octahedral normals are accurate to well under 0.01 degrees.
+    auto normalError = glm::radians(0.01f);
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        const auto& vertex = vertices[i];
+        const auto& unpackedVertex = unpackedVertices[i];
+        for (int j = 0; j < 3; ++j) {
+            EXPECT_LE(std::abs(vertex.position[j] - unpackedVertex.position[j]), positionError[j]);
+        }
+        auto normalAngle = std::atan2(glm::length(glm::cross(vertex.normal, unpackedVertex.normal)), glm::dot(vertex.normal, unpackedVertex.normal));
+        EXPECT_LE(normalAngle, normalError);
+        EXPECT_NEAR(glm::length(unpackedVertex.normal), 1.0f, 0.0001f);
+        for (int j = 0; j < 2; ++j) {
+            EXPECT_LE(std::abs(vertex.texcoord[j] - unpackedVertex.texcoord[j]), std::abs(vertex.texcoord[j]) * std::ldexp(1.0f, -11));
+        }
+        for (int j = 0; j < 4; ++j) {
+            EXPECT_LE(std::abs(vertex.color[j] - unpackedVertex.color[j]), 0.5f / 255.0f + 0.000001f);
+        }
+    }
+}
+
+TEST(VertexCompression, BatchKernelsMatchScalar)
+{
+    auto vertices = create_random_vertices(1027);
+    auto bounds = compute_quantization_bounds(vertices.size(), &vertices[0].position, sizeof(vertices[0]));
+    std::vector<PackedVertexPositionNormalTexcoordColor> packedVertices(vertices.size());
+    pack_vertices<VertexPositionNormalTexcoordColor, PackedVertexPositionNormalTexcoordColor>(vertices, bounds, packedVertices);
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        const auto& vertex = vertices[i];
+        const auto& packedVertex = packedVertices[i];
+        auto position = pack_position(vertex.position, bounds);
+        EXPECT_EQ(packedVertex.position.x, position.x);
+        EXPECT_EQ(packedVertex.position.y, position.y);
+        EXPECT_EQ(packedVertex.position.z, position.z);
+        EXPECT_EQ(packedVertex.position.w, 0);
+        auto normal = pack_normal(vertex.normal);
+        EXPECT_EQ(packedVertex.normal.x, normal.x);
+        EXPECT_EQ(packedVertex.normal.y, normal.y);
+        auto texcoord = pack_texcoord(vertex.texcoord);
+        EXPECT_EQ(packedVertex.texcoord.x, texcoord.x);
+        EXPECT_EQ(packedVertex.texcoord.y, texcoord.y);
+        auto color = pack_color(vertex.color);
+        EXPECT_EQ(packedVertex.color.x, color.x);
+        EXPECT_EQ(packedVertex.color.y, color.y);
+        EXPECT_EQ(packedVertex.color.z, color.z);
+        EXPECT_EQ(packedVertex.color.w, color.w);
+    }
+}
+
+TEST(VertexCompression, PackedVertexDescriptions)
+{
+    EXPECT_EQ(sizeof(PackedVertexPositionNormalTexcoordColor) * 2, sizeof(VertexPositionNormalTexcoordColor) - 8);
+    auto attributes = gvk::get_vertex_description<PackedVertexPositionNormalTexcoordColor>(0);
+    ASSERT_EQ(attributes.size(), 4u);
+    EXPECT_EQ(attributes[0].format, VK_FORMAT_R16G16B16A16_UNORM);
+    EXPECT_EQ(attributes[0].offset, offsetof(PackedVertexPositionNormalTexcoordColor, position));
+    EXPECT_EQ(attributes[1].format, VK_FORMAT_R16G16_SNORM);
+    EXPECT_EQ(attributes[1].offset, offsetof(PackedVertexPositionNormalTexcoordColor, normal));
+    EXPECT_EQ(attributes[2].format, VK_FORMAT_R16G16_SFLOAT);
+    EXPECT_EQ(attributes[2].offset, offsetof(PackedVertexPositionNormalTexcoordColor, texcoord));
+    EXPECT_EQ(attributes[3].format, VK_FORMAT_R8G8B8A8_UNORM);
+    EXPECT_EQ(attributes[3].offset, offsetof(PackedVertexPositionNormalTexcoordColor, color));
+}
+
+TEST(VertexCompression, DequantizationMatrix)
+{
+    QuantizationBounds bounds { .min = { -1, 2, -3 }, .extent = { 4, 5, 6 } };
+    auto dequantization = get_dequantization_matrix(bounds);
+    auto position = dequantization * glm::vec4 { 0.5f, 0.0f, 1.0f, 1.0f };
+    EXPECT_FLOAT_EQ(position.x, 1);
+    EXPECT_FLOAT_EQ(position.y, 2);
+    EXPECT_FLOAT_EQ(position.z, 3);
+}
+
+} // namespace tests
+} // namespace gfx
+} // namespace dst
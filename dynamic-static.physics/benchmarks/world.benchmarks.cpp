@@ -0,0 +1,164 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#include "dynamic-static.physics/rigid-body.hpp"
+#include "dynamic-static.physics/world.hpp"
+
+#include "benchmark/benchmark.h"
+
+#include <array>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace dst {
+namespace physics {
+namespace benchmarks {
+
+// A closed container of frictionless, perfectly elastic spheres with no
+//  gravity.  Spheres never come to rest so Bullet never puts them to sleep and
+//  every update() does a steady amount of broadphase, narrowphase, and
+//  collision gathering work.
+class Scene final
+{
+public:
+    inline Scene(size_t sphereCount)
+        : mSphereCountPerAxis { (size_t)std::ceil(std::cbrt((double)sphereCount)) }
+        , mBarrierShape(btVector3(1, 1, 1) * (btScalar)mSphereCountPerAxis)
+        , mSphereShape(0.5f)
+    {
+        World::CreateInfo worldCreateInfo { };
+        World::create(&worldCreateInfo, &mWorld);
+        mWorld.set_gravity({ 0, 0, 0 });
+        auto extent = (btScalar)mSphereCountPerAxis;
+        mBarriers.resize(6);
+        for (int i = 0; i < 6; ++i) {
+            btVector3 offset { 0, 0, 0 };
+            offset[i % 3] = (i < 3 ? 2 : -2) * extent;
+            RigidBody::CreateInfo rigidBodyCreateInfo { };
+            rigidBodyCreateInfo.material = { .friction = 0, .restitution = 1 };
+            rigidBodyCreateInfo.initialTransform.setOrigin(offset);
+            rigidBodyCreateInfo.pCollisionShape = &mBarrierShape;
+            RigidBody::create(&rigidBodyCreateInfo, &mBarriers[i]);
+            mWorld.make_static(mBarriers[i]);
+        }
+        std::mt19937 rng(0);
+        std::uniform_real_distribution<btScalar> distribution(-1, 1);
+        mSpheres.resize(sphereCount);
+        for (size_t i = 0; i < sphereCount; ++i) {
+            auto x = (btScalar)(i % mSphereCountPerAxis);
+            auto y = (btScalar)(i / mSphereCountPerAxis % mSphereCountPerAxis);
+            auto z = (btScalar)(i / (mSphereCountPerAxis * mSphereCountPerAxis));
+            RigidBody::CreateInfo rigidBodyCreateInfo { };
+            rigidBodyCreateInfo.mass = 1;
+            rigidBodyCreateInfo.material = { .friction = 0, .restitution = 1 };
+            rigidBodyCreateInfo.initialTransform.setOrigin(btVector3(x, y, z) * 2 - btVector3(extent, extent, extent) + btVector3(1, 1, 1));
+            rigidBodyCreateInfo.pCollisionShape = &mSphereShape;
+            RigidBody::create(&rigidBodyCreateInfo, &mSpheres[i]);
+            mWorld.make_dynamic(mSpheres[i]);
+            mSpheres[i].apply_impulse(btVector3(distribution(rng), distribution(rng), distribution(rng)) * 4);
+        }
+    }
+
+    inline World& get_world()
+    {
+        return mWorld;
+    }
+
+    inline const std::vector<RigidBody>& get_spheres() const
+    {
+        return mSpheres;
+    }
+
+private:
+    size_t mSphereCountPerAxis { 0 };
+    btBoxShape mBarrierShape;
+    btSphereShape mSphereShape;
+    std::vector<RigidBody> mBarriers;
+    std::vector<RigidBody> mSpheres;
+
+    // Declared last so it's destroyed first, removing RigidBodies from the
+    //  World before they're destroyed.
+    World mWorld;
+};
+
+static void World_update(benchmark::State& state)
+{
+    Scene scene((size_t)state.range(0));
+    size_t collisionCount = 0;
+    for (auto _ : state) {
+        scene.get_world().update(1.0f / 60.0f);
+        collisionCount += scene.get_world().get_collisions().size();
+    }
+    state.counters["collisions"] = benchmark::Counter((double)collisionCount, benchmark::Counter::kAvgIterations);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(World_update)->RangeMultiplier(4)->Range(64, 4096)->Unit(benchmark::kMicrosecond);
+
+static void World_collision_queries(benchmark::State& state)
+{
+    // Mirrors how the samples consume collisions, every RigidBody is looked up
+    //  in the set of collided RigidBodies and every Collision is visited.
+    Scene scene((size_t)state.range(0));
+    for (int i = 0; i < 60; ++i) {
+        scene.get_world().update(1.0f / 60.0f);
+    }
+    const auto& world = scene.get_world();
+    for (auto _ : state) {
+        size_t hitCount = 0;
+        for (const auto& sphere : scene.get_spheres()) {
+            hitCount += world.get_collided_rigid_bodies().count(&sphere);
+        }
+        for (const auto& collision : world.get_collisions()) {
+            hitCount += collision[0] < collision[1] ? 1 : 0;
+        }
+        benchmark::DoNotOptimize(hitCount);
+    }
+    state.counters["collisions"] = (double)world.get_collisions().size();
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(World_collision_queries)->RangeMultiplier(4)->Range(64, 4096);
+
+static void RigidBody_export_transforms(benchmark::State& state)
+{
+    // Writes each RigidBody's transform as a column major 4x4 matrix the way
+    //  the samples populate per object uniform data.
+    Scene scene((size_t)state.range(0));
+    scene.get_world().update(1.0f / 60.0f);
+    std::vector<std::array<btScalar, 16>> matrices(scene.get_spheres().size());
+    for (auto _ : state) {
+        for (size_t i = 0; i < matrices.size(); ++i) {
+            scene.get_spheres()[i].get_motion_state_transform().getOpenGLMatrix(matrices[i].data());
+        }
+        benchmark::DoNotOptimize(matrices.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(RigidBody_export_transforms)->RangeMultiplier(4)->Range(64, 4096);
+
+} // namespace benchmarks
+} // namespace physics
+} // namespace dst
@@ -0,0 +1,89 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#pragma once
+
+#include "dynamic-static.physics/defines.hpp"
+#include "dynamic-static/asset-file.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <span>
+
+namespace dst {
+namespace physics {
+
+class CollisionMesh final
+{
+public:
+    // Static triangle mesh collision shape with a quantized BVH.  write() builds
+    //  the BVH offline and stores it using Bullet's in place serialization, create()
+    //  uses the vertices, indices and BVH directly from a mapped AssetFile so
+    //  loading doesn't copy, rebuild or even read the mesh until it's queried.
+    //  The BVH Section is only valid for the Bullet version, btScalar precision
+    //  and architecture it was written with.
+    static constexpr uint32_t BoundsSection { make_fourcc('C', 'B', 'N', 'D') };
+    static constexpr uint32_t VerticesSection { make_fourcc('C', 'V', 'T', 'X') };
+    static constexpr uint32_t IndicesSection { make_fourcc('C', 'I', 'D', 'X') };
+    static constexpr uint32_t BvhSection { make_fourcc('C', 'B', 'V', 'H') };
+
+    struct Bounds final
+    {
+        float min[3] { };
+        float max[3] { };
+    };
+
+    struct CreateInfo final
+    {
+        // The AssetFile must be created with copyOnWrite, Bullet writes the BVH's
+        //  header in place.  The AssetFile must outlive the CollisionMesh.
+        AssetFile* pAssetFile { nullptr };
+        uint32_t id { 0 };
+    };
+
+    // vertices are xyz triplets, indices are 3 per triangle.
+    static void write(uint32_t id, std::span<const float> vertices, std::span<const int32_t> indices, AssetFileWriter* pAssetFileWriter);
+
+    // Returns false and leaves pCollisionMesh empty if the AssetFile isn't mapped
+    //  copy on write, any Section is missing or the BVH fails Bullet's validation.
+    static bool create(const CreateInfo* pCreateInfo, CollisionMesh* pCollisionMesh);
+
+    CollisionMesh() = default;
+    CollisionMesh(CollisionMesh&& other) noexcept;
+    CollisionMesh& operator=(CollisionMesh&& other) noexcept;
+    void reset();
+    ~CollisionMesh();
+
+    btCollisionShape* get_collision_shape() const;
+
+private:
+    std::unique_ptr<btTriangleIndexVertexArray> mupMeshInterface;
+    std::unique_ptr<btBvhTriangleMeshShape> mupCollisionShape;
+    btQuantizedBvh* mpBvh { nullptr };
+};
+
+} // namespace physics
+} // namespace dst
@@ -28,9 +28,11 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "dynamic-static.physics/defines.hpp"
 #include "dynamic-static.physics/rigid-body.hpp"
+#include "dynamic-static/frame-arena.hpp"
 
 #include <array>
 #include <memory>
+#include <memory_resource>
 #include <set>
 
 namespace dst {
@@ -45,14 +47,16 @@ class World final
 public:
     struct CreateInfo final
     {
+        // Backs the collision sets, which are rebuilt every update().
+        FrameArena::CreateInfo frameArenaCreateInfo { .blockSize = 64 * 1024 };
     };
 
     static void create(const CreateInfo* pCreateInfo, World* pWorld);
 
     ~World();
 
-    const std::set<const RigidBody*>& get_collided_rigid_bodies() const;
-    const std::set<Collision>& get_collisions() const;
+    const std::pmr::set<const RigidBody*>& get_collided_rigid_bodies() const;
+    const std::pmr::set<Collision>& get_collisions() const;
     btVector3 get_gravity() const;
     void set_gravity(const btVector3& gravity);
 
@@ -71,8 +75,9 @@ private:
     std::unique_ptr<btBroadphaseInterface> mupBroadPhaseInterface;
     std::unique_ptr<btSequentialImpulseConstraintSolver> mupSolver;
     std::unique_ptr<btDiscreteDynamicsWorld> mupWorld;
-    std::set<const RigidBody*> mCollidedRigidBodies;
-    std::set<Collision> mCollisions;
+    FrameArena mFrameArena;
+    std::pmr::set<const RigidBody*> mCollidedRigidBodies { &mFrameArena };
+    std::pmr::set<Collision> mCollisions { &mFrameArena };
 };
 
 } // namespace physics
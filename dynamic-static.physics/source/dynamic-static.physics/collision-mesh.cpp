@@ -0,0 +1,158 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#include "dynamic-static.physics/collision-mesh.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <utility>
+
+namespace dst {
+namespace physics {
+
+static btIndexedMesh create_indexed_mesh(std::span<const float> vertices, std::span<const int32_t> indices)
+{
+    // Vertices are always floats so assets are the same for single and double
+    //  precision builds of Bullet.
+    btIndexedMesh indexedMesh;
+    indexedMesh.m_numTriangles = (int)(indices.size() / 3);
+    indexedMesh.m_triangleIndexBase = (const unsigned char*)indices.data();
+    indexedMesh.m_triangleIndexStride = (int)(3 * sizeof(int32_t));
+    indexedMesh.m_numVertices = (int)(vertices.size() / 3);
+    indexedMesh.m_vertexBase = (const unsigned char*)vertices.data();
+    indexedMesh.m_vertexStride = (int)(3 * sizeof(float));
+    indexedMesh.m_indexType = PHY_INTEGER;
+    indexedMesh.m_vertexType = PHY_FLOAT;
+    return indexedMesh;
+}
+
+void CollisionMesh::write(uint32_t id, std::span<const float> vertices, std::span<const int32_t> indices, AssetFileWriter* pAssetFileWriter)
+{
+    assert(!vertices.empty() && !(vertices.size() % 3));
+    assert(!indices.empty() && !(indices.size() % 3));
+    assert(pAssetFileWriter);
+    Bounds bounds { };
+    std::fill(std::begin(bounds.min), std::end(bounds.min), std::numeric_limits<float>::max());
+    std::fill(std::begin(bounds.max), std::end(bounds.max), std::numeric_limits<float>::lowest());
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        bounds.min[i % 3] = std::min(bounds.min[i % 3], vertices[i]);
+        bounds.max[i % 3] = std::max(bounds.max[i % 3], vertices[i]);
+    }
+    btVector3 aabbMin(bounds.min[0], bounds.min[1], bounds.min[2]);
+    btVector3 aabbMax(bounds.max[0], bounds.max[1], bounds.max[2]);
+    btTriangleIndexVertexArray meshInterface;
+    meshInterface.addIndexedMesh(create_indexed_mesh(vertices, indices), PHY_INTEGER);
+    meshInterface.setPremadeAabb(aabbMin, aabbMax);
+    btBvhTriangleMeshShape collisionShape(&meshInterface, true, aabbMin, aabbMax, true);
+    auto pBvh = collisionShape.getOptimizedBvh();
+    assert(pBvh);
+    auto bvhSize = pBvh->calculateSerializeBufferSize();
+    auto pBvhData = btAlignedAlloc(bvhSize, 16);
+    pBvh->serializeInPlace(pBvhData, bvhSize, false);
+    pAssetFileWriter->add_section(BvhSection, id, pBvhData, bvhSize, 0);
+    btAlignedFree(pBvhData);
+    pAssetFileWriter->add_section<Bounds>(BoundsSection, id, std::span<const Bounds>(&bounds, 1));
+    pAssetFileWriter->add_section<float>(VerticesSection, id, vertices);
+    pAssetFileWriter->add_section<int32_t>(IndicesSection, id, indices);
+}
+
+bool CollisionMesh::create(const CreateInfo* pCreateInfo, CollisionMesh* pCollisionMesh)
+{
+    assert(pCreateInfo);
+    assert(pCreateInfo->pAssetFile);
+    assert(pCollisionMesh);
+    pCollisionMesh->reset();
+    auto& assetFile = *pCreateInfo->pAssetFile;
+    if (!assetFile.is_copy_on_write()) {
+        return false;
+    }
+    auto bounds = assetFile.get_section_data<Bounds>(BoundsSection, pCreateInfo->id);
+    auto vertices = assetFile.get_section_data<float>(VerticesSection, pCreateInfo->id);
+    auto indices = assetFile.get_section_data<int32_t>(IndicesSection, pCreateInfo->id);
+    auto pBvhSection = assetFile.find_section(BvhSection, pCreateInfo->id);
+    if (bounds.size() != 1 || vertices.empty() || vertices.size() % 3 || indices.empty() || indices.size() % 3 || !pBvhSection) {
+        return false;
+    }
+    auto bvhData = assetFile.get_mutable_section_data(*pBvhSection);
+    pCollisionMesh->mpBvh = btQuantizedBvh::deSerializeInPlace(bvhData.data(), (unsigned)bvhData.size(), false);
+    if (!pCollisionMesh->mpBvh) {
+        return false;
+    }
+    btVector3 aabbMin(bounds[0].min[0], bounds[0].min[1], bounds[0].min[2]);
+    btVector3 aabbMax(bounds[0].max[0], bounds[0].max[1], bounds[0].max[2]);
+    pCollisionMesh->mupMeshInterface = std::make_unique<btTriangleIndexVertexArray>();
+    pCollisionMesh->mupMeshInterface->addIndexedMesh(create_indexed_mesh(vertices, indices), PHY_INTEGER);
+    pCollisionMesh->mupMeshInterface->setPremadeAabb(aabbMin, aabbMax);
+    pCollisionMesh->mupCollisionShape = std::make_unique<btBvhTriangleMeshShape>(pCollisionMesh->mupMeshInterface.get(), true, aabbMin, aabbMax, false);
+
+    // deSerializeInPlace() constructs a btQuantizedBvh, btBvhTriangleMeshShape
+    //  only uses the btQuantizedBvh interface.  Bullet's own examples load
+    //  serialized BVHs the same way.
+    pCollisionMesh->mupCollisionShape->setOptimizedBvh((btOptimizedBvh*)pCollisionMesh->mpBvh);
+    return true;
+}
+
+CollisionMesh::CollisionMesh(CollisionMesh&& other) noexcept
+{
+    *this = std::move(other);
+}
+
+CollisionMesh& CollisionMesh::operator=(CollisionMesh&& other) noexcept
+{
+    if (this != &other) {
+        reset();
+        mupMeshInterface = std::move(other.mupMeshInterface);
+        mupCollisionShape = std::move(other.mupCollisionShape);
+        mpBvh = std::exchange(other.mpBvh, nullptr);
+    }
+    return *this;
+}
+
+void CollisionMesh::reset()
+{
+    // The btQuantizedBvh lives in the AssetFile's memory so it's destroyed but not
+    //  freed.
+    mupCollisionShape.reset();
+    mupMeshInterface.reset();
+    if (mpBvh) {
+        mpBvh->~btQuantizedBvh();
+        mpBvh = nullptr;
+    }
+}
+
+CollisionMesh::~CollisionMesh()
+{
+    reset();
+}
+
+btCollisionShape* CollisionMesh::get_collision_shape() const
+{
+    return mupCollisionShape.get();
+}
+
+} // namespace physics
+} // namespace dst
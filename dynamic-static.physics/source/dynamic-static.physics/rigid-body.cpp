@@ -65,7 +65,9 @@ RigidBody& RigidBody::operator=(RigidBody&& other) noexcept
         mupRigidBody = std::move(other.mupRigidBody);
         mState = std::move(other.mState);
         mpUserData = std::move(other.mpUserData);
-        mupRigidBody->setUserPointer(this);
+        if (mupRigidBody) {
+            mupRigidBody->setUserPointer(this);
+        }
     }
     return *this;
 }
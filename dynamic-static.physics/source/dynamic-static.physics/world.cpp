@@ -26,6 +26,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "dynamic-static.physics/world.hpp"
 #include "dynamic-static.physics/rigid-body.hpp"
+#include "dynamic-static/profiler.hpp"
 
 #include <algorithm>
 #include <cassert>
@@ -40,9 +41,10 @@ Collision make_collision(const RigidBody* pRigidBody0, const RigidBody* pRigidBo
 
 void World::create(const CreateInfo* pCreateInfo, World* pWorld)
 {
-    (void)pCreateInfo;
     assert(pCreateInfo);
     assert(pWorld);
+    pWorld->reset();
+    FrameArena::create(&pCreateInfo->frameArenaCreateInfo, &pWorld->mFrameArena);
     pWorld->mupCollisionConfiguration = std::make_unique<btDefaultCollisionConfiguration>();
     pWorld->mupDispatcher = std::make_unique<btCollisionDispatcher>(pWorld->mupCollisionConfiguration.get());
     pWorld->mupBroadPhaseInterface = std::make_unique<btDbvtBroadphase>();
@@ -63,12 +65,12 @@ World::~World()
     reset();
 }
 
-const std::set<const RigidBody*>& World::get_collided_rigid_bodies() const
+const std::pmr::set<const RigidBody*>& World::get_collided_rigid_bodies() const
 {
     return mCollidedRigidBodies;
 }
 
-const std::set<Collision>& World::get_collisions() const
+const std::pmr::set<Collision>& World::get_collisions() const
 {
     return mCollisions;
 }
@@ -109,9 +111,11 @@ void World::disable(RigidBody& rigidBody)
 
 void World::update(btScalar deltaTime)
 {
+    dst_profile_scope("World::update");
     assert(mupWorld);
     mCollidedRigidBodies.clear();
     mCollisions.clear();
+    mFrameArena.clear();
     mupWorld->stepSimulation(deltaTime);
 }
 
@@ -137,10 +141,12 @@ void World::reset()
     mupWorld.reset();
     mCollidedRigidBodies.clear();
     mCollisions.clear();
+    mFrameArena.reset();
 }
 
 void World::bullet_physics_tick_callback(btDynamicsWorld* pDynamicsWorld, btScalar)
 {
+    dst_profile_scope("World::bullet_physics_tick_callback");
     auto pWorld = (World*)pDynamicsWorld->getWorldUserInfo();
     auto& collisions = pWorld->mCollisions;
     auto& collidedRigidBodies = pWorld->mCollidedRigidBodies;
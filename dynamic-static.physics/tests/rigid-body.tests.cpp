@@ -0,0 +1,99 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#include "dynamic-static.physics/rigid-body.hpp"
+#include "dynamic-static.physics/world.hpp"
+#include "dynamic-static/registry.hpp"
+
+#include "gtest/gtest.h"
+
+#include <utility>
+
+namespace dst {
+namespace physics {
+namespace tests {
+
+static void create_box_rigid_body(btCollisionShape* pCollisionShape, btScalar mass, const btVector3& position, RigidBody* pRigidBody)
+{
+    RigidBody::CreateInfo rigidBodyCreateInfo { };
+    rigidBodyCreateInfo.mass = mass;
+    rigidBodyCreateInfo.initialTransform.setOrigin(position);
+    rigidBodyCreateInfo.pCollisionShape = pCollisionShape;
+    RigidBody::create(&rigidBodyCreateInfo, pRigidBody);
+}
+
+TEST(RigidBody, MoveEmpty)
+{
+    // Moving from an empty RigidBody leaves the destination empty.
+    btBoxShape boxShape({ 0.5f, 0.5f, 0.5f });
+    RigidBody rigidBody;
+    create_box_rigid_body(&boxShape, 1, { 0, 0, 0 }, &rigidBody);
+    RigidBody emptyRigidBody;
+    rigidBody = std::move(emptyRigidBody);
+    EXPECT_EQ(rigidBody.get_state(), RigidBody::State::Disabled);
+    RigidBody movedRigidBody(std::move(emptyRigidBody));
+    EXPECT_EQ(movedRigidBody.get_state(), RigidBody::State::Disabled);
+}
+
+TEST(RigidBody, SparseSetErase)
+{
+    // Erasing a RigidBody from the middle of a SparseSet moves the last RigidBody
+    //  into its slot.  The moved RigidBody's btRigidBody must point back at its
+    //  new address so dst::physics::World reports collisions with it.
+    btBoxShape boxShape({ 0.5f, 0.5f, 0.5f });
+    SparseSet<RigidBody> rigidBodies;
+    World::CreateInfo worldCreateInfo { };
+    World world;
+    World::create(&worldCreateInfo, &world);
+    world.set_gravity({ 0, 0, 0 });
+
+    Entity floor { 0, 0 };
+    Entity erased { 1, 0 };
+    Entity moved { 2, 0 };
+    create_box_rigid_body(&boxShape, 0, { 0, 0, 0 }, &rigidBodies.emplace(floor));
+    create_box_rigid_body(&boxShape, 1, { 0, 8, 0 }, &rigidBodies.emplace(erased));
+    create_box_rigid_body(&boxShape, 1, { 0, 0.75f, 0 }, &rigidBodies.emplace(moved));
+    world.make_static(*rigidBodies.get(floor));
+    world.make_dynamic(*rigidBodies.get(erased));
+    world.make_dynamic(*rigidBodies.get(moved));
+    world.disable(*rigidBodies.get(erased));
+    auto pMovedRigidBody = rigidBodies.get(moved);
+    ASSERT_TRUE(rigidBodies.erase(erased));
+    ASSERT_NE(rigidBodies.get(moved), pMovedRigidBody);
+    pMovedRigidBody = rigidBodies.get(moved);
+    EXPECT_EQ(pMovedRigidBody->get_state(), RigidBody::State::Dynamic);
+
+    world.update(1.0f / 60.0f);
+    auto pFloorRigidBody = rigidBodies.get(floor);
+    EXPECT_EQ(world.get_collided_rigid_bodies().count(pMovedRigidBody), 1u);
+    EXPECT_EQ(world.get_collided_rigid_bodies().count(pFloorRigidBody), 1u);
+    EXPECT_EQ(world.get_collisions().count(make_collision(pMovedRigidBody, pFloorRigidBody)), 1u);
+    world.reset();
+}
+
+} // namespace tests
+} // namespace physics
+} // namespace dst
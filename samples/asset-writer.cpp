@@ -0,0 +1,121 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#include "dynamic-static.graphics/mesh-asset.hpp"
+#include "dynamic-static.graphics/meshlet.hpp"
+#include "dynamic-static.graphics/primitives.hpp"
+#include "dynamic-static.graphics/simplification.hpp"
+#include "dynamic-static.graphics/vertex-cache.hpp"
+#include "dynamic-static.physics/collision-mesh.hpp"
+#include "dynamic-static/asset-file.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// asset-writer reads an asset manifest and writes an AssetFile with the same
+//  name and a .dsta extension to the working directory.  Each manifest line
+//  describes one asset, blank lines and lines starting with # are ignored...
+//      sphere <id> <radius> <subdivisions> [collision]
+//  ...writes an icosphere MeshAsset with a LOD chain and Meshlets, collision
+//  also writes a dst::physics::CollisionMesh with the same id.
+
+static void write_sphere(uint32_t id, float radius, uint32_t subdivisions, bool collision, dst::AssetFileWriter* pAssetFileWriter)
+{
+    std::vector<glm::vec3> positions;
+    std::vector<dst::gfx::primitive::Triangle<uint32_t>> triangles;
+    dst::gfx::primitive::create_icosphere(radius, subdivisions, &positions, &triangles);
+    dst::gfx::optimize_vertex_cache<uint32_t>(triangles, positions.size());
+    dst::gfx::optimize_overdraw<uint32_t>(triangles, positions);
+    dst::gfx::optimize_vertex_fetch<uint32_t>(triangles, &positions);
+
+    std::vector<dst::gfx::LodLevel<uint32_t>> lodLevels;
+    dst::gfx::create_lod_chain<uint32_t>(positions, triangles, { }, &lodLevels);
+    dst::gfx::MeshletMesh meshletMesh { };
+    dst::gfx::build_meshlets<uint32_t>(positions, triangles, dst::gfx::Meshlet::DefaultMaxVertexCount, dst::gfx::Meshlet::DefaultMaxTriangleCount, &meshletMesh);
+    dst::gfx::write_mesh_asset(id, positions, lodLevels, &meshletMesh, pAssetFileWriter);
+
+    if (collision) {
+        std::vector<float> vertices;
+        vertices.reserve(positions.size() * 3);
+        for (const auto& position : positions) {
+            vertices.insert(vertices.end(), { position.x, position.y, position.z });
+        }
+        std::vector<int32_t> indices;
+        indices.reserve(triangles.size() * 3);
+        for (const auto& triangle : triangles) {
+            indices.insert(indices.end(), { (int32_t)triangle[0], (int32_t)triangle[1], (int32_t)triangle[2] });
+        }
+        dst::physics::CollisionMesh::write(id, vertices, indices, pAssetFileWriter);
+    }
+}
+
+int main(int argc, const char* argv[])
+{
+    if (argc != 2) {
+        std::cerr << "usage : asset-writer <manifest>" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::filesystem::path manifestPath(argv[1]);
+    std::ifstream manifest(manifestPath);
+    if (!manifest) {
+        std::cerr << "asset-writer : failed to open " << manifestPath << std::endl;
+        return EXIT_FAILURE;
+    }
+    dst::AssetFileWriter assetFileWriter;
+    std::string line;
+    for (uint32_t line_i = 1; std::getline(manifest, line); ++line_i) {
+        std::istringstream strStrm(line);
+        std::string type;
+        if (!(strStrm >> type) || type[0] == '#') {
+            continue;
+        }
+        if (type == "sphere") {
+            uint32_t id = 0;
+            float radius = 0;
+            uint32_t subdivisions = 0;
+            std::string option;
+            if (strStrm >> id >> radius >> subdivisions && 0 < radius) {
+                strStrm >> option;
+                write_sphere(id, radius, subdivisions, option == "collision", &assetFileWriter);
+                continue;
+            }
+        }
+        std::cerr << manifestPath.string() << "(" << line_i << ") : invalid asset \"" << line << "\"" << std::endl;
+        return EXIT_FAILURE;
+    }
+    auto assetFilePath = manifestPath.filename().replace_extension(".dsta");
+    if (!assetFileWriter.write(assetFilePath)) {
+        std::cerr << "asset-writer : failed to write " << assetFilePath << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,392 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+#include "brick-breaker-simulation.hpp"
+#include "dynamic-static/profiler.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string_view>
+#include <vector>
+
+// Every heap allocation made through operator new and every allocation Bullet
+//  makes through btAlignedAlloc() is counted so each frame can report how many
+//  allocations it made.  Bullet's allocations are counted separately, see the
+//  check after the frame loop.
+static std::atomic<uint64_t> sAllocationCount;
+static std::atomic<uint64_t> sAllocationSize;
+static std::atomic<uint64_t> sBulletAllocationCount;
+static std::atomic<uint64_t> sBulletAllocationSize;
+
+static void* allocate(size_t size, std::atomic<uint64_t>& allocationCount, std::atomic<uint64_t>& allocationSize)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocationSize.fetch_add(size, std::memory_order_relaxed);
+    return std::malloc(size ? size : 1);
+}
+
+static void* allocate(size_t size, std::align_val_t alignment, std::atomic<uint64_t>& allocationCount, std::atomic<uint64_t>& allocationSize)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocationSize.fetch_add(size, std::memory_order_relaxed);
+    // aligned_alloc() requires size to be a multiple of alignment.
+    auto alignmentSize = (size_t)alignment;
+    size = (std::max(size, (size_t)1) + alignmentSize - 1) & ~(alignmentSize - 1);
+#ifdef _MSC_VER
+    return _aligned_malloc(size, alignmentSize);
+#else
+    return std::aligned_alloc(alignmentSize, size);
+#endif
+}
+
+static void free_aligned(void* pData)
+{
+#ifdef _MSC_VER
+    _aligned_free(pData);
+#else
+    std::free(pData);
+#endif
+}
+
+void* operator new(size_t size)
+{
+    if (auto pData = allocate(size, sAllocationCount, sAllocationSize)) {
+        return pData;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* pData) noexcept
+{
+    std::free(pData);
+}
+
+void operator delete[](void* pData) noexcept
+{
+    std::free(pData);
+}
+
+void operator delete(void* pData, size_t) noexcept
+{
+    std::free(pData);
+}
+
+void operator delete[](void* pData, size_t) noexcept
+{
+    std::free(pData);
+}
+
+// Over aligned types (ie. alignas(32) SIMD blocks) bypass the operators above
+//  and come through these, so they need to be counted as well.
+void* operator new(size_t size, std::align_val_t alignment)
+{
+    if (auto pData = allocate(size, alignment, sAllocationCount, sAllocationSize)) {
+        return pData;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size, std::align_val_t alignment)
+{
+    return operator new(size, alignment);
+}
+
+void operator delete(void* pData, std::align_val_t) noexcept
+{
+    free_aligned(pData);
+}
+
+void operator delete[](void* pData, std::align_val_t) noexcept
+{
+    free_aligned(pData);
+}
+
+void operator delete(void* pData, size_t, std::align_val_t) noexcept
+{
+    free_aligned(pData);
+}
+
+void operator delete[](void* pData, size_t, std::align_val_t) noexcept
+{
+    free_aligned(pData);
+}
+
+static void* bullet_allocate(size_t size)
+{
+    return allocate(size, sBulletAllocationCount, sBulletAllocationSize);
+}
+
+static void bullet_free(void* pData)
+{
+    std::free(pData);
+}
+
+struct FrameStatistics
+{
+    double frameMilliseconds { 0 };
+    double stepMilliseconds { 0 };
+    uint32_t collisionCount { 0 };
+    uint32_t collidedRigidBodyCount { 0 };
+    uint64_t allocationCount { 0 };
+    uint64_t allocationSize { 0 };
+    uint64_t bulletAllocationCount { 0 };
+    uint64_t bulletAllocationSize { 0 };
+};
+
+template <typename T>
+static void print_statistic(const char* pName, std::vector<FrameStatistics>& frameStatistics, T FrameStatistics::* pMember)
+{
+    // Prints the mean, median, 99th percentile, and max of a FrameStatistics
+    //  member over all recorded frames.
+    std::sort(frameStatistics.begin(), frameStatistics.end(), [&](const auto& lhs, const auto& rhs) { return lhs.*pMember < rhs.*pMember; });
+    double sum = 0;
+    for (const auto& frame : frameStatistics) {
+        sum += (double)(frame.*pMember);
+    }
+    auto get_percentile = [&](double percentile)
+    {
+        return (double)(frameStatistics[(size_t)(percentile * (frameStatistics.size() - 1))].*pMember);
+    };
+    std::cout << "    " << std::left << std::setw(24) << pName << std::right << std::fixed << std::setprecision(3)
+        << std::setw(14) << sum / frameStatistics.size()
+        << std::setw(14) << get_percentile(0.5)
+        << std::setw(14) << get_percentile(0.99)
+        << std::setw(14) << get_percentile(1.0)
+        << std::endl;
+}
+
+static uint32_t parse_argument(int argc, const char* argv[], std::string_view name, uint32_t defaultValue)
+{
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (name == argv[i]) {
+            return (uint32_t)std::strtoul(argv[i + 1], nullptr, 10);
+        }
+    }
+    return defaultValue;
+}
+
+int main(int argc, const char* argv[])
+{
+    // The defaults match the layout of the brick-breaker sample, pass larger
+    //  counts to scale the simulation up.
+    const uint32_t BrickRowCount   = std::max(1u, parse_argument(argc, argv, "--rows", 6));
+    const uint32_t BrickColumCount = std::max(1u, parse_argument(argc, argv, "--columns", 10));
+    const uint32_t BallCount       = std::max(1u, parse_argument(argc, argv, "--balls", 3));
+    const uint32_t FrameCount      = std::max(1u, parse_argument(argc, argv, "--frames", 3600));
+    const uint32_t BrickCount      = BrickRowCount * BrickColumCount;
+
+    std::cout <<                                                                                       std::endl;
+    std::cout << "================================================================================" << std::endl;
+    std::cout << "    dynamic-static - Brick Breaker (Headless)                                   " << std::endl;
+    std::cout << "--------------------------------------------------------------------------------" << std::endl;
+    std::cout << "                                                                                " << std::endl;
+    std::cout << "    Runs the Brick Breaker game logic with a scripted paddle and a fixed time   " << std::endl;
+    std::cout << "    step, no window or GPU required.  Runs are deterministic.                   " << std::endl;
+    std::cout << "                                                                                " << std::endl;
+    std::cout << "    Options                                                                     " << std::endl;
+    std::cout << "        --rows <count>    : Brick row count    (default 6)                      " << std::endl;
+    std::cout << "        --columns <count> : Brick column count (default 10)                     " << std::endl;
+    std::cout << "        --balls <count>   : Ball count         (default 3)                      " << std::endl;
+    std::cout << "        --frames <count>  : Frame count        (default 3600)                   " << std::endl;
+    std::cout << "                                                                                " << std::endl;
+    std::cout << "================================================================================" << std::endl;
+    std::cout <<                                                                                       std::endl;
+
+    // Route Bullet's allocations through the counting allocator.  This must
+    //  happen before any Bullet objects are created.
+    btAlignedAllocSetCustom(bullet_allocate, bullet_free);
+
+    // Create a dst::physics::World.
+    dst::physics::World::CreateInfo physicsWorldCreateInfo { };
+    dst::physics::World physicsWorld;
+    dst::physics::World::create(&physicsWorldCreateInfo, &physicsWorld);
+
+    // Create a dst::Registry and the BrickBreaker simulation shared with the
+    //  brick-breaker sample.  BrickBreaker owns the collision shapes used by the
+    //  Registry's RigidBody components so it's declared first and outlives them.
+    BrickBreaker brickBreaker;
+    dst::Registry registry;
+    BrickBreaker::CreateInfo brickBreakerCreateInfo { };
+    brickBreakerCreateInfo.pPhysicsWorld = &physicsWorld;
+    brickBreakerCreateInfo.pRegistry = &registry;
+    brickBreakerCreateInfo.brickRowCount = BrickRowCount;
+    brickBreakerCreateInfo.brickColumnCount = BrickColumCount;
+    brickBreakerCreateInfo.ballCount = BallCount;
+    BrickBreaker::create(&brickBreakerCreateInfo, &brickBreaker);
+    const auto& paddleRigidBody = *registry.get<dst::physics::RigidBody>(brickBreaker.get_paddle());
+    const btScalar PlayFieldWidth = brickBreaker.get_play_field_width();
+    const btScalar OutOfPlay = -brickBreaker.get_play_field_height() * 0.5f;
+
+    // World matrices are written for every RigidBody each frame the same way the
+    //  brick-breaker sample writes its ObjectInstance components.
+    std::vector<std::array<btScalar, 16>> worldMatrices(registry.get_storage<dst::physics::RigidBody>().size());
+
+    // Time is advanced by a fixed step and the paddle is driven by a script so
+    //  every run produces the same simulation.  The script fires a ball every
+    //  FireInterval frames and pushes the paddle toward the lowest live ball.
+    constexpr float DeltaTime = 1.0f / 60.0f;
+    constexpr uint32_t FireInterval = 8;
+
+    // Per frame temporaries come from dst::FrameArenas and containers keep their
+    //  capacity, so once WarmupFrameCount frames have run no frame should
+    //  allocate through operator new.
+    constexpr uint32_t WarmupFrameCount = 60;
+    uint32_t fireCount = 0;
+    std::vector<FrameStatistics> frameStatistics;
+    frameStatistics.reserve(FrameCount);
+
+    for (uint32_t frame_i = 0; frame_i < FrameCount; ++frame_i) {
+        auto frameAllocationCount = sAllocationCount.load(std::memory_order_relaxed);
+        auto frameAllocationSize = sAllocationSize.load(std::memory_order_relaxed);
+        auto frameBulletAllocationCount = sBulletAllocationCount.load(std::memory_order_relaxed);
+        auto frameBulletAllocationSize = sBulletAllocationSize.load(std::memory_order_relaxed);
+        auto frameBegin = std::chrono::steady_clock::now();
+        dst_profile_frame();
+
+        // Push the paddle toward the lowest ball that's still in play.  The paddle
+        //  moves toward +x for movePaddleLeft.
+        FrameInput frameInput { };
+        frameInput.deltaTime = DeltaTime;
+        const dst::physics::RigidBody* pTargetBall = nullptr;
+        for (auto ball : brickBreaker.get_balls()) {
+            const auto& rigidBody = *registry.get<dst::physics::RigidBody>(ball);
+            if (rigidBody.get_state() == dst::physics::RigidBody::State::Dynamic) {
+                const auto& ballPosition = rigidBody.get_transform().getOrigin();
+                if (OutOfPlay < ballPosition.y() && (!pTargetBall || ballPosition.y() < pTargetBall->get_transform().getOrigin().y())) {
+                    pTargetBall = &rigidBody;
+                }
+            }
+        }
+        if (pTargetBall) {
+            auto offset = pTargetBall->get_transform().getOrigin().x() - paddleRigidBody.get_transform().getOrigin().x();
+            if (BrickBreaker::PaddleWidth * 0.1f < std::abs(offset)) {
+                frameInput.movePaddleLeft = 0 < offset;
+                frameInput.movePaddleRight = offset < 0;
+            }
+        }
+
+        // Fire a ball every FireInterval frames, balls enter play at spread out
+        //  positions across the middle of the play field.
+        if (!(frame_i % FireInterval)) {
+            frameInput.fireBall = true;
+            frameInput.fireBallX = ((btScalar)(fireCount++ * 7 % 16) / 15.0f - 0.5f) * (PlayFieldWidth - BrickBreaker::BarrierThickness - BrickBreaker::BallGap);
+        }
+
+        // Run the game logic
+        brickBreaker.update(frameInput);
+
+        // Update the dst::physics::World
+        auto stepBegin = std::chrono::steady_clock::now();
+        physicsWorld.update(DeltaTime);
+        auto stepEnd = std::chrono::steady_clock::now();
+
+        // Write world matrices
+        size_t worldMatrixIndex = 0;
+        registry.each<dst::physics::RigidBody>(
+            [&](dst::Entity, const dst::physics::RigidBody& rigidBody)
+            {
+                rigidBody.get_motion_state_transform().getOpenGLMatrix(worldMatrices[worldMatrixIndex++].data());
+            }
+        );
+
+        auto frameEnd = std::chrono::steady_clock::now();
+        FrameStatistics frame { };
+        frame.frameMilliseconds = std::chrono::duration<double, std::milli>(frameEnd - frameBegin).count();
+        frame.stepMilliseconds = std::chrono::duration<double, std::milli>(stepEnd - stepBegin).count();
+        frame.collisionCount = (uint32_t)physicsWorld.get_collisions().size();
+        frame.collidedRigidBodyCount = (uint32_t)physicsWorld.get_collided_rigid_bodies().size();
+        frame.allocationCount = sAllocationCount.load(std::memory_order_relaxed) - frameAllocationCount;
+        frame.allocationSize = sAllocationSize.load(std::memory_order_relaxed) - frameAllocationSize;
+        frame.bulletAllocationCount = sBulletAllocationCount.load(std::memory_order_relaxed) - frameBulletAllocationCount;
+        frame.bulletAllocationSize = sBulletAllocationSize.load(std::memory_order_relaxed) - frameBulletAllocationSize;
+        frameStatistics.push_back(frame);
+    }
+
+    // Bullet allocates broadphase proxies and contact manifolds through
+    //  btAlignedAlloc() whenever a RigidBody is added to or removed from the
+    //  World, ie. when bricks are knocked out and balls are fired or lost, those
+    //  allocations are reported but not checked.
+    uint64_t steadyStateAllocationCount = 0;
+    for (uint32_t frame_i = WarmupFrameCount; frame_i < (uint32_t)frameStatistics.size(); ++frame_i) {
+        steadyStateAllocationCount += frameStatistics[frame_i].allocationCount;
+    }
+
+    // Hash the final world matrices, identical arguments should always produce an
+    //  identical hash.
+    uint64_t hash = 14695981039346656037ull;
+    for (const auto& worldMatrix : worldMatrices) {
+        const auto* pBytes = (const uint8_t*)worldMatrix.data();
+        for (size_t i = 0; i < sizeof(worldMatrix); ++i) {
+            hash = (hash ^ pBytes[i]) * 1099511628211ull;
+        }
+    }
+
+    std::cout << "    " << BrickCount << " bricks, " << BallCount << " balls, " << FrameCount << " frames, " << brickBreaker.get_game_count() << " games" << std::endl;
+    std::cout << "    final state hash : " << std::hex << hash << std::dec << std::endl;
+    std::cout << std::endl;
+    std::cout << "    " << std::left << std::setw(24) << "per frame" << std::right
+        << std::setw(14) << "mean"
+        << std::setw(14) << "p50"
+        << std::setw(14) << "p99"
+        << std::setw(14) << "max"
+        << std::endl;
+    print_statistic("frame (ms)", frameStatistics, &FrameStatistics::frameMilliseconds);
+    print_statistic("World::update (ms)", frameStatistics, &FrameStatistics::stepMilliseconds);
+    print_statistic("collisions", frameStatistics, &FrameStatistics::collisionCount);
+    print_statistic("collided rigid bodies", frameStatistics, &FrameStatistics::collidedRigidBodyCount);
+    print_statistic("allocations", frameStatistics, &FrameStatistics::allocationCount);
+    print_statistic("allocated bytes", frameStatistics, &FrameStatistics::allocationSize);
+    print_statistic("Bullet allocations", frameStatistics, &FrameStatistics::bulletAllocationCount);
+    print_statistic("Bullet allocated bytes", frameStatistics, &FrameStatistics::bulletAllocationSize);
+    std::cout << std::endl;
+    if (steadyStateAllocationCount) {
+        std::cout << "    FAILED : " << steadyStateAllocationCount << " allocations after " << WarmupFrameCount << " warmup frames" << std::endl;
+        std::cout << std::endl;
+    }
+
+    // Reset the dst::physics::World before allowing physics destructors to run.
+    physicsWorld.reset();
+
+#ifdef DST_PROFILER_ENABLED
+    dst::profiler::write_chrome_trace("brick-breaker-headless.trace.json");
+#endif
+
+    return steadyStateAllocationCount ? EXIT_FAILURE : EXIT_SUCCESS;
+}
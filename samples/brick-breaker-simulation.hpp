@@ -0,0 +1,529 @@
+
+/*******************************************************************************
+
+MIT License
+
+Copyright (c) dynamic-static
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the
+Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*******************************************************************************/
+
+
+#pragma once
+
+#include "dynamic-static.physics/defines.hpp"
+#include "dynamic-static.physics/rigid-body.hpp"
+#include "dynamic-static.physics/world.hpp"
+#include "dynamic-static/registry.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+// Brick Breaker's game logic, shared by the brick-breaker and
+//  brick-breaker-headless samples.  The game is made of dst::Entity handles in a
+//  dst::Registry, each with a dst::physics::RigidBody.  The components below tag
+//  what kind of object an Entity is.  BrickBreaker only depends on
+//  dynamic-static.core and dynamic-static.physics, samples that render attach
+//  their own components to each Entity as it's created.
+enum class GameState
+{
+    Playing,
+    Celebration,
+    GameOver,
+    Resetting,
+};
+
+struct PlayFieldBarrier
+{
+};
+
+struct ContainerBarrier
+{
+};
+
+struct Brick
+{
+    uint32_t index { 0 };
+    btVector3 deadPosition { 0, 0, 0 };
+    btQuaternion deadRotation { btQuaternion::getIdentity() };
+};
+
+struct LiveBrick
+{
+};
+
+struct Ball
+{
+};
+
+struct FrameInput
+{
+    float deltaTime { 0 };
+    bool movePaddleLeft { false };
+    bool movePaddleRight { false };
+    bool fireBall { false };
+
+    // The x position a fired ball enters play at.
+    float fireBallX { 0 };
+};
+
+class BrickBreaker final
+{
+public:
+    enum class EntityType
+    {
+        PlayFieldBarrier,
+        ContainerBarrier,
+        Brick,
+        Ball,
+        Paddle,
+    };
+
+    // Describes an Entity to a CreateInfo::onEntityCreated callback.  Boxes have
+    //  non zero boxExtents, spheres have a non zero sphereRadius.  index is the
+    //  Entity's index among Entities of the same type.
+    struct EntityInfo
+    {
+        EntityType type { EntityType::PlayFieldBarrier };
+        uint32_t index { 0 };
+        btVector3 boxExtents { 0, 0, 0 };
+        btScalar sphereRadius { 0 };
+    };
+
+    struct CreateInfo
+    {
+        dst::physics::World* pPhysicsWorld { nullptr };
+        dst::Registry* pRegistry { nullptr };
+        uint32_t brickRowCount { 6 };
+        uint32_t brickColumnCount { 10 };
+        uint32_t ballCount { 3 };
+
+        // Called after each Entity and its RigidBody are created.
+        std::function<void(dst::Entity, const EntityInfo&)> onEntityCreated;
+    };
+
+    static constexpr btScalar BarrierThickness      = 1;
+    static constexpr btScalar BrickMass             = 8;
+    static constexpr btScalar BrickWidth            = 2;
+    static constexpr btScalar BrickHeight           = 1;
+    static constexpr btScalar BrickDepth            = 1;
+    static constexpr btScalar BrickAreaWidth        = 3.1f;
+    static constexpr btScalar BallRadius            = 0.5f;
+    static constexpr btScalar BallMass              = 1;
+    static constexpr btScalar BallRestitution       = 0.9f;
+    static constexpr btScalar BallGap               = BallRadius * 4;
+    static constexpr btScalar PaddleWidth           = 6;
+    static constexpr btScalar PaddleHeight          = 1;
+    static constexpr btScalar PaddleDepth           = 0.1f;
+    static constexpr btScalar PaddleMass            = 1;
+    static constexpr btScalar PaddleForceStrength   = 48;
+    static constexpr btScalar PaddleImpulseStrength = 64;
+    static constexpr btScalar ContainerDepth        = 16;
+    static constexpr float CelebrationDuration      = 4.5f;
+    static constexpr float ResetDuration            = 2.5f;
+
+    // Creates the play field, the container surrounding it, the bricks, the balls
+    //  and the paddle.  The play field is sized to fit the bricks, the default
+    //  counts produce a 32 x 64 play field.  BrickBreaker owns the collision
+    //  shapes so it must outlive the Registry's RigidBody components.
+    static inline void create(const CreateInfo* pCreateInfo, BrickBreaker* pBrickBreaker)
+    {
+        assert(pCreateInfo);
+        assert(pCreateInfo->pPhysicsWorld);
+        assert(pCreateInfo->pRegistry);
+        assert(pCreateInfo->brickRowCount);
+        assert(pCreateInfo->brickColumnCount);
+        assert(pCreateInfo->ballCount);
+        assert(pBrickBreaker);
+        auto& brickBreaker = *pBrickBreaker;
+        brickBreaker.mpPhysicsWorld = pCreateInfo->pPhysicsWorld;
+        brickBreaker.mpRegistry = pCreateInfo->pRegistry;
+        brickBreaker.mOnEntityCreated = pCreateInfo->onEntityCreated;
+        auto& physicsWorld = *brickBreaker.mpPhysicsWorld;
+        auto& registry = *brickBreaker.mpRegistry;
+        auto brickRowCount = pCreateInfo->brickRowCount;
+        auto brickColumnCount = pCreateInfo->brickColumnCount;
+        brickBreaker.mPlayFieldWidth = BrickAreaWidth * brickColumnCount + BarrierThickness;
+        brickBreaker.mPlayFieldHeight = std::max((btScalar)64, (btScalar)(2 * (20 + (brickRowCount - 1) * BrickHeight * 2 + 2)));
+        const auto PlayFieldWidth = brickBreaker.mPlayFieldWidth;
+        const auto PlayFieldHeight = brickBreaker.mPlayFieldHeight;
+
+        // Create the play field made up of the side and top barriers that the player
+        //  sees.
+        constexpr btScalar PlayFieldBarrierRestitution = 0.6f;
+        const std::array<std::pair<btVector3, btVector3>, 3> PlayFieldBarriers {
+            std::make_pair(btVector3(PlayFieldWidth,   BarrierThickness, BarrierThickness), btVector3(                     0, PlayFieldHeight * 0.5f, 0)), // Top
+            std::make_pair(btVector3(BarrierThickness, PlayFieldHeight,  BarrierThickness), btVector3( PlayFieldWidth * 0.5f,                      0, 0)), // Left
+            std::make_pair(btVector3(BarrierThickness, PlayFieldHeight,  BarrierThickness), btVector3(-PlayFieldWidth * 0.5f,                      0, 0)), // Right
+        };
+        for (uint32_t i = 0; i < (uint32_t)PlayFieldBarriers.size(); ++i) {
+            dst::physics::RigidBody::CreateInfo rigidBodyCreateInfo { };
+            rigidBodyCreateInfo.material.restitution = PlayFieldBarrierRestitution;
+            rigidBodyCreateInfo.initialTransform.setOrigin(PlayFieldBarriers[i].second);
+            auto entity = brickBreaker.create_box_entity({ EntityType::PlayFieldBarrier, i, PlayFieldBarriers[i].first }, rigidBodyCreateInfo);
+            registry.emplace<PlayFieldBarrier>(entity);
+            physicsWorld.make_static(*registry.get<dst::physics::RigidBody>(entity));
+        }
+
+        // Create the container surrounding the play field.  This container provides a
+        //  boundary for bricks/balls that have gone out of play.
+        const btScalar ContainerWidth = PlayFieldWidth + PlayFieldWidth * 0.5f;
+        const btScalar ContainerHeight = PlayFieldHeight + PlayFieldHeight * 0.18f;
+        const std::array<std::pair<btVector3, btVector3>, 5> ContainerBarriers {
+            std::make_pair(btVector3(ContainerWidth,   ContainerHeight,  BarrierThickness), btVector3(                     0,                        0,  ContainerDepth * 0.5f)), // Back
+            std::make_pair(btVector3(BarrierThickness, ContainerHeight,  ContainerDepth),   btVector3( ContainerWidth * 0.5f,                        0,                      0)), // Left
+            std::make_pair(btVector3(BarrierThickness, ContainerHeight,  ContainerDepth),   btVector3(-ContainerWidth * 0.5f,                        0,                      0)), // Right
+            std::make_pair(btVector3(ContainerWidth,   ContainerHeight,  BarrierThickness), btVector3(                     0,                        0, -ContainerDepth * 0.5f)), // Front
+            std::make_pair(btVector3(ContainerWidth,   BarrierThickness, ContainerDepth),   btVector3(                     0, -ContainerHeight * 0.5f,                      0)), // Bottom
+        };
+        for (uint32_t i = 0; i < (uint32_t)ContainerBarriers.size(); ++i) {
+            dst::physics::RigidBody::CreateInfo rigidBodyCreateInfo { };
+            rigidBodyCreateInfo.initialTransform.setOrigin(ContainerBarriers[i].second);
+            auto entity = brickBreaker.create_box_entity({ EntityType::ContainerBarrier, i, ContainerBarriers[i].first }, rigidBodyCreateInfo);
+            registry.emplace<ContainerBarrier>(entity);
+            physicsWorld.make_static(*registry.get<dst::physics::RigidBody>(entity));
+        }
+
+        // Create the bricks.  EntityInfo::index is the brick's index, its row is
+        //  index / brickColumnCount.
+        brickBreaker.mBrickPositions.resize(brickRowCount * brickColumnCount);
+        for (uint32_t row_i = 0; row_i < brickRowCount; ++row_i) {
+            auto x = -(PlayFieldWidth - BarrierThickness) * 0.5f + BrickAreaWidth * 0.5f;
+            for (uint32_t brick_i = 0; brick_i < brickColumnCount; ++brick_i) {
+                auto y = PlayFieldHeight * 0.5f - 2.0f - row_i * BrickHeight * 2.0f;
+                brickBreaker.mBrickPositions[row_i * brickColumnCount + brick_i] = { x, y, 0 };
+                x += BrickAreaWidth;
+            }
+        }
+        for (uint32_t i = 0; i < (uint32_t)brickBreaker.mBrickPositions.size(); ++i) {
+            dst::physics::RigidBody::CreateInfo rigidBodyCreateInfo { };
+            rigidBodyCreateInfo.mass = BrickMass;
+            rigidBodyCreateInfo.initialTransform.setOrigin(brickBreaker.mBrickPositions[i]);
+            auto entity = brickBreaker.create_box_entity({ EntityType::Brick, i, { BrickWidth, BrickHeight, BrickDepth } }, rigidBodyCreateInfo);
+            registry.emplace<Brick>(entity).index = i;
+            registry.emplace<LiveBrick>(entity);
+            physicsWorld.make_static(*registry.get<dst::physics::RigidBody>(entity));
+        }
+
+        // Create the balls.  Balls wait in rows above the play field until they're
+        //  fired.
+        const uint32_t BallsPerRow = std::max(1u, (uint32_t)(PlayFieldWidth / BallGap));
+        brickBreaker.mBallPositions.resize(pCreateInfo->ballCount);
+        brickBreaker.mBalls.resize(pCreateInfo->ballCount);
+        for (uint32_t i = 0; i < pCreateInfo->ballCount; ++i) {
+            auto x = -PlayFieldWidth * 0.5f + (i % BallsPerRow) * BallGap;
+            auto y = PlayFieldHeight * 0.5f + (1 + i / BallsPerRow) * BallGap;
+            brickBreaker.mBallPositions[i] = { x, y, 0 };
+            dst::physics::RigidBody::CreateInfo rigidBodyCreateInfo { };
+            rigidBodyCreateInfo.mass = BallMass;
+            rigidBodyCreateInfo.material.restitution = BallRestitution;
+            rigidBodyCreateInfo.linearFactor = { 1, 1, 0 };
+            rigidBodyCreateInfo.initialTransform.setOrigin(brickBreaker.mBallPositions[i]);
+            brickBreaker.mBalls[i] = brickBreaker.create_sphere_entity({ EntityType::Ball, i, { 0, 0, 0 }, BallRadius }, rigidBodyCreateInfo);
+            registry.emplace<Ball>(brickBreaker.mBalls[i]);
+        }
+
+        // Create the paddle.
+        dst::physics::RigidBody::CreateInfo rigidBodyCreateInfo { };
+        rigidBodyCreateInfo.mass = PaddleMass;
+        rigidBodyCreateInfo.linearDamping = 0.4f;
+        rigidBodyCreateInfo.linearFactor = { 1, 0, 0 };
+        rigidBodyCreateInfo.angularFactor = { 0, 0, 0 };
+        rigidBodyCreateInfo.initialTransform.setOrigin({ 0, -PlayFieldHeight * 0.5f + PaddleHeight * 4, 0 });
+        brickBreaker.mPaddle = brickBreaker.create_box_entity({ EntityType::Paddle, 0, { PaddleWidth, PaddleHeight, PaddleDepth } }, rigidBodyCreateInfo);
+        physicsWorld.make_dynamic(*registry.get<dst::physics::RigidBody>(brickBreaker.mPaddle));
+    }
+
+    inline GameState get_state() const
+    {
+        return mState;
+    }
+
+    // Returns the time in seconds spent in the current GameState.
+    inline float get_state_time() const
+    {
+        return mStateTime;
+    }
+
+    // Returns the number of games started, including the current game.
+    inline uint32_t get_game_count() const
+    {
+        return mGameCount;
+    }
+
+    inline btScalar get_play_field_width() const
+    {
+        return mPlayFieldWidth;
+    }
+
+    inline btScalar get_play_field_height() const
+    {
+        return mPlayFieldHeight;
+    }
+
+    inline dst::Entity get_paddle() const
+    {
+        return mPaddle;
+    }
+
+    inline const std::vector<dst::Entity>& get_balls() const
+    {
+        return mBalls;
+    }
+
+    // Applies frameInput and advances the GameState by frameInput.deltaTime.
+    //  Callers update the dst::physics::World after this.  The paddle moves toward
+    //  +x for movePaddleLeft since the camera looks down +z.
+    inline void update(const FrameInput& frameInput)
+    {
+        auto& physicsWorld = *mpPhysicsWorld;
+        auto& registry = *mpRegistry;
+        auto& paddleRigidBody = *registry.get<dst::physics::RigidBody>(mPaddle);
+        mStateTime += frameInput.deltaTime;
+
+        // Apply a force on the paddle when the player is moving it.
+        if (frameInput.movePaddleLeft) {
+            paddleRigidBody.apply_force({ PaddleForceStrength, 0, 0 });
+        }
+        if (frameInput.movePaddleRight) {
+            paddleRigidBody.apply_force({ -PaddleForceStrength, 0, 0 });
+        }
+
+        // Switch on GameState.
+        switch (mState) {
+        case GameState::Playing: {
+            // If the player fires and there's at least one waiting ball left, fire a
+            //  ball from fireBallX.
+            if (frameInput.fireBall) {
+                for (auto ritr = mBalls.rbegin(); ritr != mBalls.rend(); ++ritr) {
+                    auto& rigidBody = *registry.get<dst::physics::RigidBody>(*ritr);
+                    if (rigidBody.get_state() == dst::physics::RigidBody::State::Disabled) {
+                        auto transform = btTransform::getIdentity();
+                        transform.setOrigin({ frameInput.fireBallX, 0, 0 });
+                        rigidBody.halt();
+                        rigidBody.set_transform(transform);
+                        physicsWorld.make_dynamic(rigidBody);
+                        break;
+                    }
+                }
+            }
+            // If a live brick has been hit by anything (a ball or another brick), make it
+            //  dynamic and remove its LiveBrick component.  Removing the current
+            //  Entity's components during each() is allowed.
+            registry.each<LiveBrick, dst::physics::RigidBody>(
+                [&](dst::Entity entity, LiveBrick&, dst::physics::RigidBody& rigidBody)
+                {
+                    if (physicsWorld.get_collided_rigid_bodies().count(&rigidBody)) {
+                        physicsWorld.disable(rigidBody);
+                        physicsWorld.make_dynamic(rigidBody);
+                        registry.remove<LiveBrick>(entity);
+                    }
+                }
+            );
+            // Check for live balls and ball/paddle collisions.  If there was a collision
+            //  between a ball and the top of the paddle, apply an impulse to the ball.
+            //  The direction of the impulse is the vector from the center of the paddle to
+            //  the center of the ball.
+            uint32_t liveBallCount = 0;
+            const btScalar OutOfPlay = -mPlayFieldHeight * 0.5f;
+            const auto& paddlePosition = paddleRigidBody.get_transform().getOrigin();
+            registry.each<Ball, dst::physics::RigidBody>(
+                [&](dst::Entity, Ball&, dst::physics::RigidBody& rigidBody)
+                {
+                    const auto& ballPosition = rigidBody.get_transform().getOrigin();
+                    if (OutOfPlay < ballPosition.y()) {
+                        ++liveBallCount;
+                        if (physicsWorld.get_collisions().count(dst::physics::make_collision(&rigidBody, &paddleRigidBody))) {
+                            if (paddlePosition.y() < ballPosition.y()) {
+                                auto impulse = (ballPosition - paddlePosition).normalized();
+                                impulse *= PaddleImpulseStrength;
+                                impulse.setY(PaddleImpulseStrength);
+                                rigidBody.apply_impulse(impulse);
+                            }
+                        }
+                    }
+                }
+            );
+            // If there are no LiveBrick components, then all bricks have been broken out
+            //  and GameState transitions to Celebration.  If there are still live bricks
+            //  left but no live balls, then transition GameState to GameOver.
+            if (registry.get_storage<LiveBrick>().empty()) {
+                set_state(GameState::Celebration);
+            } else if (!liveBallCount) {
+                set_state(GameState::GameOver);
+            }
+        } break;
+        case GameState::Celebration: {
+            // Samples may flash the play field while celebrating, then transition
+            //  GameState to GameOver.
+            if (CelebrationDuration <= mStateTime) {
+                set_state(GameState::GameOver);
+            }
+        } break;
+        case GameState::GameOver: {
+            // halt() and disable() the bricks.  Record brick positions and rotations for
+            //  use in the reset animation.
+            registry.each<Brick, dst::physics::RigidBody>(
+                [&](dst::Entity, Brick& brick, dst::physics::RigidBody& rigidBody)
+                {
+                    rigidBody.halt();
+                    physicsWorld.disable(rigidBody);
+                    const auto& transform = rigidBody.get_transform();
+                    brick.deadPosition = transform.getOrigin();
+                    brick.deadRotation = transform.getRotation();
+                }
+            );
+            // halt() and disable() the balls.
+            registry.each<Ball, dst::physics::RigidBody>(
+                [&](dst::Entity, Ball&, dst::physics::RigidBody& rigidBody)
+                {
+                    rigidBody.halt();
+                    physicsWorld.disable(rigidBody);
+                }
+            );
+            set_state(GameState::Resetting);
+        } break;
+        case GameState::Resetting: {
+            // If the reset animation is still running, bricks lerp from their GameOver
+            //  positions back to their initial positions and balls return to their
+            //  initial positions one at a time.  Otherwise set all of the bricks and
+            //  balls to their initial positions and transition GameState to Playing.
+            if (mStateTime < ResetDuration) {
+                float t = mStateTime / ResetDuration;
+                registry.each<Brick, dst::physics::RigidBody>(
+                    [&](dst::Entity, Brick& brick, dst::physics::RigidBody& rigidBody)
+                    {
+                        auto transform = rigidBody.get_transform();
+                        transform.setOrigin(brick.deadPosition.lerp(mBrickPositions[brick.index], t));
+                        transform.setRotation(brick.deadRotation.slerp(btQuaternion::getIdentity(), t));
+                        rigidBody.set_transform(transform);
+                    }
+                );
+                // When resetting the balls, a counter is used that starts at the ball count
+                //  and counts down.  As the counter decrements, the counter value (minus 1)
+                //  is subracted from the ball count to get the index of the ball that
+                //  should be reset to its initial position.
+                auto ballCount = mBalls.size();
+                auto ballResetCounter = ballCount - (size_t)(t * (ballCount + 1));
+                if (ballResetCounter < ballCount) {
+                    auto ballIndex = ballCount - ballResetCounter - 1;
+                    auto& rigidBody = *registry.get<dst::physics::RigidBody>(mBalls[ballIndex]);
+                    auto transform = rigidBody.get_transform();
+                    transform.setOrigin(mBallPositions[ballIndex]);
+                    rigidBody.set_transform(transform);
+                }
+            } else {
+                registry.get_storage<LiveBrick>().clear();
+                registry.each<Brick, dst::physics::RigidBody>(
+                    [&](dst::Entity entity, Brick& brick, dst::physics::RigidBody& rigidBody)
+                    {
+                        auto transform = rigidBody.get_transform();
+                        transform.setOrigin(mBrickPositions[brick.index]);
+                        transform.setRotation(btQuaternion::getIdentity());
+                        rigidBody.set_transform(transform);
+                        physicsWorld.make_static(rigidBody);
+                        registry.emplace<LiveBrick>(entity);
+                    }
+                );
+                for (size_t i = 0; i < mBalls.size(); ++i) {
+                    auto& rigidBody = *registry.get<dst::physics::RigidBody>(mBalls[i]);
+                    auto transform = rigidBody.get_transform();
+                    transform.setOrigin(mBallPositions[i]);
+                    transform.setRotation(btQuaternion::getIdentity());
+                    rigidBody.set_transform(transform);
+                }
+                ++mGameCount;
+                set_state(GameState::Playing);
+            }
+        } break;
+        }
+
+        // Clamp the paddle's position within the play field boundaries.  This prevents
+        //  the paddle from tunneling through the walls.  Without this, the right
+        //  combination of forces from the player, the balls, and bricks can cause the
+        //  paddle to escape the play field.
+        auto paddleTransform = paddleRigidBody.get_transform();
+        auto xMax = mPlayFieldWidth * 0.5f - PaddleWidth * 0.5f;
+        paddleTransform.getOrigin().setX(std::clamp(paddleTransform.getOrigin().x(), -xMax, xMax));
+        paddleRigidBody.set_transform(paddleTransform);
+    }
+
+private:
+    inline void set_state(GameState state)
+    {
+        mState = state;
+        mStateTime = 0;
+    }
+
+    inline dst::Entity create_box_entity(const EntityInfo& entityInfo, dst::physics::RigidBody::CreateInfo rigidBodyCreateInfo)
+    {
+        // Collision shapes are shared by every RigidBody of the same size.
+        const auto& extents = entityInfo.boxExtents;
+        auto key = std::make_tuple(extents.x(), extents.y(), extents.z());
+        auto itr = mBoxShapes.find(key);
+        if (itr == mBoxShapes.end()) {
+            itr = mBoxShapes.insert({ key, btBoxShape(extents * 0.5f) }).first;
+        }
+        rigidBodyCreateInfo.pCollisionShape = &itr->second;
+        return create_entity(entityInfo, rigidBodyCreateInfo);
+    }
+
+    inline dst::Entity create_sphere_entity(const EntityInfo& entityInfo, dst::physics::RigidBody::CreateInfo rigidBodyCreateInfo)
+    {
+        auto itr = mSphereShapes.find(entityInfo.sphereRadius);
+        if (itr == mSphereShapes.end()) {
+            itr = mSphereShapes.insert({ entityInfo.sphereRadius, btSphereShape(entityInfo.sphereRadius) }).first;
+        }
+        rigidBodyCreateInfo.pCollisionShape = &itr->second;
+        return create_entity(entityInfo, rigidBodyCreateInfo);
+    }
+
+    inline dst::Entity create_entity(const EntityInfo& entityInfo, const dst::physics::RigidBody::CreateInfo& rigidBodyCreateInfo)
+    {
+        auto& registry = *mpRegistry;
+        auto entity = registry.create_entity();
+        dst::physics::RigidBody::create(&rigidBodyCreateInfo, &registry.emplace<dst::physics::RigidBody>(entity));
+        if (mOnEntityCreated) {
+            mOnEntityCreated(entity, entityInfo);
+        }
+        return entity;
+    }
+
+    dst::physics::World* mpPhysicsWorld { nullptr };
+    dst::Registry* mpRegistry { nullptr };
+    std::function<void(dst::Entity, const EntityInfo&)> mOnEntityCreated;
+    std::map<std::tuple<btScalar, btScalar, btScalar>, btBoxShape> mBoxShapes;
+    std::map<btScalar, btSphereShape> mSphereShapes;
+    btScalar mPlayFieldWidth { 0 };
+    btScalar mPlayFieldHeight { 0 };
+    std::vector<btVector3> mBrickPositions;
+    std::vector<btVector3> mBallPositions;
+    std::vector<dst::Entity> mBalls;
+    dst::Entity mPaddle { };
+    GameState mState { GameState::Playing };
+    float mStateTime { 0 };
+    uint32_t mGameCount { 1 };
+};
@@ -25,21 +25,39 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 *******************************************************************************/
 
 #include "dynamic-static.sample-utilities.hpp"
+#include "brick-breaker-simulation.hpp"
+#include "dynamic-static.graphics/bounding-volume-hierarchy.hpp"
+#include "dynamic-static.graphics/instance-batcher.hpp"
+#include "dynamic-static.graphics/occlusion-culler.hpp"
+#include "dynamic-static.graphics/pipeline-builder.hpp"
+#include "dynamic-static.graphics/render-queue.hpp"
+#include "dynamic-static.graphics/uniform-ring.hpp"
+#include "dynamic-static.graphics/upload-batcher.hpp"
+#include "dynamic-static/frame-pipeline.hpp"
+#include "dynamic-static/registry.hpp"
 
 #include <map>
+#include <span>
 #include <tuple>
-#include <unordered_set>
 #include <utility>
 
-VkResult create_pipeline(const gvk::RenderPass& renderPass, VkPolygonMode polygonMode, gvk::Pipeline* pPipeline)
+dst::gfx::PipelineBuilder::Description create_pipeline_description(
+    const gvk::RenderPass& renderPass,
+    VkPolygonMode polygonMode,
+    const gvk::PipelineLayout& pipelineLayout,
+    const gvk::PipelineCache& pipelineCache,
+    gvk::Pipeline* pPipeline
+)
 {
     assert(renderPass);
+    assert(pipelineLayout);
     assert(pPipeline);
 
     // A simple vertex shader (GPU program that processes individual vertices) that
-    //  draws a mesh comprised of vec3 vertices.  This shader's interface is made
-    //  up of two uniform buffers, CameraUniforms bound at DescriptorSet 0, and
-    //  ObjectUniforms bound at DescriptorSet 1.
+    //  draws instances of a mesh comprised of vec3 vertices.  This shader's
+    //  interface is made up of a uniform buffer, CameraUniforms bound at
+    //  DescriptorSet 0, and per instance world matrix and color attributes read
+    //  from vertex buffer binding 1.
     gvk::spirv::ShaderInfo vertexShaderInfo {
         .language = gvk::spirv::ShadingLanguage::Glsl,
         .stage = VK_SHADER_STAGE_VERTEX_BIT,
@@ -54,14 +72,11 @@ VkResult create_pipeline(const gvk::RenderPass& renderPass, VkPolygonMode polygo
                 mat4 projection;
             } camera;
 
-            layout(set = 1, binding = 0)
-            uniform ObjectUniforms
-            {
-                mat4 world;
-                vec4 color;
-            } object;
-
             layout(location = 0) in vec3 vertexPosition;
+            layout(location = 1) in mat4 instanceWorld;
+            layout(location = 5) in vec4 instanceColor;
+
+            layout(location = 0) out vec4 color;
 
             out gl_PerVertex
             {
@@ -70,14 +85,14 @@ VkResult create_pipeline(const gvk::RenderPass& renderPass, VkPolygonMode polygo
 
             void main()
             {
-                gl_Position = camera.projection * camera.view * object.world * vec4(vertexPosition, 1);
+                gl_Position = camera.projection * camera.view * instanceWorld * vec4(vertexPosition, 1);
+                color = instanceColor;
             }
         )"
     };
 
     // A simple fragment shader (GPU program that processes individual fragments)
-    //  that writes the object color provided by the ObjectUniforms bound at
-    //  DescriptorSet 1.
+    //  that writes the instance color passed from the vertex shader.
     gvk::spirv::ShaderInfo fragmentShaderInfo {
         .language = gvk::spirv::ShadingLanguage::Glsl,
         .stage = VK_SHADER_STAGE_FRAGMENT_BIT,
@@ -85,22 +100,28 @@ VkResult create_pipeline(const gvk::RenderPass& renderPass, VkPolygonMode polygo
         .source = R"(
             #version 450
 
-            layout(set = 1, binding = 0)
-            uniform ObjectUniforms
-            {
-                mat4 world;
-                vec4 color;
-            } object;
+            layout(location = 0) in vec4 color;
 
             layout(location = 0) out vec4 fragmentColor;
 
             void main()
             {
-                fragmentColor = object.color;
+                fragmentColor = color;
             }
         )"
     };
-    return dst_sample_create_pipeline<glm::vec3>(renderPass, VK_CULL_MODE_BACK_BIT, polygonMode, vertexShaderInfo, fragmentShaderInfo, pPipeline);
+
+    // The dst::gfx::PipelineBuilder compiles the shaders then calls create from a
+    //  JobSystem thread.  gvk handles are captured by value so the Description
+    //  doesn't depend on the caller's stack.
+    dst::gfx::PipelineBuilder::Description description { };
+    description.shaderInfos = { std::move(vertexShaderInfo), std::move(fragmentShaderInfo) };
+    description.create = [renderPass, polygonMode, pipelineLayout, pipelineCache, pPipeline](std::span<const gvk::spirv::ShaderInfo> shaderInfos)
+    {
+        assert(shaderInfos.size() == 2);
+        return dst_sample_create_pipeline<glm::vec3, dst::gfx::InstanceWorldColor>(renderPass, VK_CULL_MODE_BACK_BIT, polygonMode, shaderInfos[0], shaderInfos[1], pipelineLayout, pipelineCache, pPipeline);
+    };
+    return description;
 }
 
 struct CameraUniforms
@@ -109,179 +130,238 @@ struct CameraUniforms
     glm::mat4 projection { };
 };
 
-struct ObjectUniforms
+struct ObjectInstance
 {
     glm::mat4 world { };
     glm::vec4 color { };
 };
 
-class GameObject final
+// The sample's objects are dst::Entity handles into a dst::Registry, each
+//  system iterates only the components it needs.  dst::physics::RigidBody and
+//  ObjectInstance are stored densely so the physics to render sync streams
+//  through two contiguous arrays.  Renderable holds the graphics resources used
+//  to draw an Entity, its mesh is a view into the sample's dst::gfx::GeometryArena
+//  and meshId identifies the mesh in RenderQueue sort keys.  boundingRadius
+//  bounds the mesh about its origin for frustum culling.  Boxes are rasterized
+//  as occluders with occluderExtents, it's 0 for meshes that don't occlude.
+//  Game logic and the components that tag what kind of object an Entity is
+//  are in brick-breaker-simulation.hpp.
+struct Renderable
 {
-public:
-    struct BoxCreateInfo
-    {
-        btVector3 extents { 1, 1, 1 };
-    };
+    dst::gfx::GeometryArena::Mesh mesh;
+    uint32_t meshId { 0 };
+    float boundingRadius { 0 };
+    glm::vec3 occluderExtents { 0, 0, 0 };
+};
 
-    struct SphereCreateInfo
+class RenderableFactory final
+{
+public:
+    inline Renderable get_renderable(
+        dst::gfx::GeometryArena& geometryArena,
+        dst::gfx::UploadBatcher& uploadBatcher,
+        const BrickBreaker::EntityInfo& entityInfo,
+        const dst::gfx::MeshAsset* pSphereMeshAsset
+    )
     {
-        btScalar radius { 1 };
-    };
+        // Check if a Renderable has already been created for a box with the given
+        //  extents or a sphere with the given radius.  If so return the existing
+        //  Renderable, otherwise create a new one.  If pSphereMeshAsset is set, LOD 0
+        //  is used for spheres instead of generating an icosphere, it must have the
+        //  Entity's radius.
+        if (entityInfo.sphereRadius) {
+            auto radius = entityInfo.sphereRadius;
+            auto itr = mSphereRenderables.find(radius);
+            if (itr == mSphereRenderables.end()) {
+                dst::gfx::GeometryArena::Mesh mesh;
+                if (pSphereMeshAsset) {
+                    dst_vk_result(dst_sample_create_mesh(geometryArena, uploadBatcher, *pSphereMeshAsset, 0, &mesh));
+                } else {
+                    dst_vk_result(dst_sample_create_sphere_mesh(geometryArena, uploadBatcher, radius, 1, &mesh));
+                }
+                itr = mSphereRenderables.insert({ radius, { mesh, mMeshCount++, radius } }).first;
+            }
+            return itr->second;
+        }
+        glm::vec3 extents { entityInfo.boxExtents.x(), entityInfo.boxExtents.y(), entityInfo.boxExtents.z() };
+        auto key = std::make_tuple(extents.x, extents.y, extents.z);
+        auto itr = mBoxRenderables.find(key);
+        if (itr == mBoxRenderables.end()) {
+            dst::gfx::GeometryArena::Mesh mesh;
+            dst_vk_result(dst_sample_create_box_mesh(geometryArena, uploadBatcher, extents, &mesh));
+            itr = mBoxRenderables.insert({ key, { mesh, mMeshCount++, glm::length(extents * 0.5f), extents } }).first;
+        }
+        return itr->second;
+    }
 
-    struct CreateInfo
-    {
-        const BoxCreateInfo* pBoxCreateInfo { nullptr };
-        const SphereCreateInfo* pSphereCreateInfo { nullptr };
-        dst::physics::RigidBody::CreateInfo rigidBodyCreateInfo { };
-    };
+private:
+    std::map<std::tuple<float, float, float>, Renderable> mBoxRenderables;
+    std::map<btScalar, Renderable> mSphereRenderables;
+    uint32_t mMeshCount { 0 };
+};
 
-    class Factory final
-    {
-    public:
-        inline Factory(const gvk::DescriptorPool& descriptorPool, const gvk::DescriptorSetLayout& descriptorSetLayout)
-            : mDescriptorPool { descriptorPool }
-            , mDescriptorSetLayout { descriptorSetLayout }
+inline void sync_object_instances(dst::Registry& registry)
+{
+    // Stream every RigidBody's interpolated transform into its ObjectInstance.
+    registry.each<dst::physics::RigidBody, ObjectInstance>(
+        [](dst::Entity, const dst::physics::RigidBody& rigidBody, ObjectInstance& objectInstance)
         {
-            assert(mDescriptorPool);
-            assert(mDescriptorSetLayout);
+            rigidBody.get_motion_state_transform().getOpenGLMatrix(&objectInstance.world[0][0]);
         }
+    );
+}
 
-        inline void create_game_object(const gvk::CommandBuffer& commandBuffer, GameObject::CreateInfo createInfo, GameObject* pGameObject)
-        {
-            assert(commandBuffer);
-            assert(!createInfo.pBoxCreateInfo != !createInfo.pSphereCreateInfo);
-            assert(pGameObject);
-            std::pair<btCollisionShape*, gvk::Mesh> resources;
-            if (createInfo.pBoxCreateInfo) {
-                resources = get_box_resources(commandBuffer, *createInfo.pBoxCreateInfo);
-            } else {
-                resources = get_sphere_resources(commandBuffer, *createInfo.pSphereCreateInfo);
-            }
-            pGameObject->mMesh = resources.second;
-            createInfo.rigidBodyCreateInfo.pCollisionShape = resources.first;
-            createInfo.rigidBodyCreateInfo.pUserData = this;
-            dst::physics::RigidBody::create(&createInfo.rigidBodyCreateInfo, &pGameObject->rigidBody);
-            create_descriptor_resources(pGameObject);
-        }
+struct DrawSnapshot
+{
+    const Renderable* pRenderable { nullptr };
+    ObjectInstance objectInstance { };
+    bool containerBarrier { false };
+};
 
-    private:
-        inline std::pair<btCollisionShape*, gvk::Mesh> get_box_resources(const gvk::CommandBuffer& commandBuffer, const GameObject::BoxCreateInfo& boxCreateInfo)
-        {
-            // Check if a btCollisionShape and gvk::Mesh have already been created for a
-            //  box with the given extents.  If so return the existing resources, otherwise
-            //  create new reosurces.
-            auto itr = mBoxResources.find(boxCreateInfo.extents);
-            if (itr == mBoxResources.end()) {
-                gvk::Mesh mesh;
-                dst_vk_result(dst_sample_create_box_mesh(commandBuffer, { boxCreateInfo.extents.x(), boxCreateInfo.extents.y(), boxCreateInfo.extents.z() }, &mesh));
-                itr = mBoxResources.insert({ boxCreateInfo.extents, { btBoxShape(boxCreateInfo.extents * 0.5f), mesh } }).first;
-            }
-            return { &itr->second.first, itr->second.second };
-        }
+struct FrameSnapshot
+{
+    std::vector<DrawSnapshot> draws;
+};
 
-        inline std::pair<btCollisionShape*, gvk::Mesh> get_sphere_resources(const gvk::CommandBuffer& commandBuffer, const GameObject::SphereCreateInfo& sphereCreateInfo)
+inline void write_frame_snapshot(dst::Registry& registry, FrameSnapshot* pFrameSnapshot)
+{
+    // Copy everything the render thread needs out of the Registry so it never
+    //  reads components the simulation thread is writing.  Renderable components
+    //  are only read, and are never added or removed after setup, so pointers to
+    //  them stay valid.
+    assert(pFrameSnapshot);
+    pFrameSnapshot->draws.clear();
+    registry.each<ObjectInstance, Renderable>(
+        [&](dst::Entity entity, const ObjectInstance& objectInstance, const Renderable& renderable)
         {
-            // Check if a btCollisionShape and gvk::Mesh have already been created for a
-            //  sphere with the given radius.  If so return the existing resources,
-            //  otherwise create new reosurces.
-            auto itr = mSphereResources.find(sphereCreateInfo.radius);
-            if (itr == mSphereResources.end()) {
-                gvk::Mesh mesh;
-                dst_vk_result(dst_sample_create_sphere_mesh(commandBuffer, sphereCreateInfo.radius, 1, &mesh));
-                itr = mSphereResources.insert({ sphereCreateInfo.radius, { btSphereShape(sphereCreateInfo.radius), mesh } }).first;
-            }
-            return { &itr->second.first, itr->second.second };
+            pFrameSnapshot->draws.push_back({ &renderable, objectInstance, registry.has<ContainerBarrier>(entity) });
         }
+    );
+}
 
-        inline void create_descriptor_resources(GameObject* pGameObject)
-        {
-            assert(pGameObject);
-
-            // Create a uniform Buffer.  This Buffer will be populated with data that is
-            //  needed to process the GameObject during vertex/fragment shading.
-            dst_vk_result(dst_sample_create_uniform_buffer<ObjectUniforms>(mDescriptorSetLayout.get<gvk::Device>(), &pGameObject->mUniformBuffer));
-
-            // Allocate a DescriptorSet.  DescriptorSets are used to bind resources (like
-            //  uniform Buffers) for consumption by the vertex/fragment shader.
-            auto descriptorSetAllocateInfo = gvk::get_default<VkDescriptorSetAllocateInfo>();
-            descriptorSetAllocateInfo.descriptorPool = mDescriptorPool;
-            descriptorSetAllocateInfo.descriptorSetCount = 1;
-            descriptorSetAllocateInfo.pSetLayouts = &mDescriptorSetLayout.get<const VkDescriptorSetLayout&>();
-            dst_vk_result(gvk::DescriptorSet::allocate(mDescriptorPool.get<gvk::Device>(), &descriptorSetAllocateInfo, &pGameObject->mDescriptorSet));
-
-            // Update the GameObject's DescriptorSet to reference the uniform Buffer.
-            auto descriptorBufferInfo = gvk::get_default<VkDescriptorBufferInfo>();
-            descriptorBufferInfo.buffer = pGameObject->mUniformBuffer;
-            auto writeDescriptorSet = gvk::get_default<VkWriteDescriptorSet>();
-            writeDescriptorSet.descriptorCount = 1;
-            writeDescriptorSet.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-            writeDescriptorSet.dstSet = pGameObject->mDescriptorSet;
-            writeDescriptorSet.pBufferInfo = &descriptorBufferInfo;
-            vkUpdateDescriptorSets(mDescriptorPool.get<gvk::Device>(), 1, &writeDescriptorSet, 0, nullptr);
+inline void update_bounding_volume_hierarchy(
+    const FrameSnapshot& frameSnapshot,
+    dst::gfx::BoundingVolumeHierarchy* pBoundingVolumeHierarchy,
+    std::vector<dst::gfx::BoundingVolumeHierarchy::ProxyId>* pProxyIds
+)
+{
+    // Each draw's proxy is the AABB of its Renderable's bounding sphere so only
+    //  translation moves a proxy.  Proxies are indexed by draw index, draw
+    //  indices are stable because Renderable components are never added or
+    //  removed after setup.  Proxies are created the first time a draw is seen.
+    assert(pBoundingVolumeHierarchy);
+    assert(pProxyIds);
+    for (uint32_t i = 0; i < (uint32_t)frameSnapshot.draws.size(); ++i) {
+        const auto& draw = frameSnapshot.draws[i];
+        auto center = glm::vec3(draw.objectInstance.world[3]);
+        auto radius = glm::vec3(draw.pRenderable->boundingRadius);
+        dst::gfx::BoundingVolumeHierarchy::Aabb aabb { center - radius, center + radius };
+        if (i < pProxyIds->size()) {
+            pBoundingVolumeHierarchy->update_proxy((*pProxyIds)[i], aabb);
+        } else {
+            pProxyIds->push_back(pBoundingVolumeHierarchy->create_proxy(aabb, i));
         }
-
-        gvk::DescriptorPool mDescriptorPool;
-        gvk::DescriptorSetLayout mDescriptorSetLayout;
-        std::map<btVector3, std::pair<btBoxShape, gvk::Mesh>> mBoxResources;
-        std::map<btScalar, std::pair<btSphereShape, gvk::Mesh>> mSphereResources;
-    };
-
-    GameObject() = default;
-
-    inline GameObject(GameObject && other) noexcept
-    {
-        *this = std::move(other);
     }
+}
 
-    inline GameObject& operator=(GameObject && other) noexcept
-    {
-        if (this != &other) {
-            rigidBody = std::move(other.rigidBody);
-            color = std::move(other.color);
-            mMesh = std::move(other.mMesh);
-            mUniformBuffer = std::move(other.mUniformBuffer);
-            mDescriptorSet = std::move(other.mDescriptorSet);
-            rigidBody.set_user_data(this);
+inline void cull_occluded_draws(
+    const FrameSnapshot& frameSnapshot,
+    const dst::gfx::BoundingVolumeHierarchy& boundingVolumeHierarchy,
+    std::span<const dst::gfx::BoundingVolumeHierarchy::ProxyId> proxyIds,
+    const glm::mat4& viewProjection,
+    dst::JobSystem& jobSystem,
+    dst::gfx::OcclusionCuller* pOcclusionCuller,
+    std::vector<uint32_t>* pVisibleDraws
+)
+{
+    // Rasterize every visible box except the container as an occluder, then
+    //  remove draws whose proxy AABB is hidden.  A proxy AABB encloses its own
+    //  mesh so occluders never hide themselves.
+    assert(pOcclusionCuller);
+    assert(pVisibleDraws);
+    pOcclusionCuller->begin_frame(viewProjection);
+    for (auto i : *pVisibleDraws) {
+        const auto& draw = frameSnapshot.draws[i];
+        const auto& occluderExtents = draw.pRenderable->occluderExtents;
+        if (!draw.containerBarrier && occluderExtents != glm::vec3(0)) {
+            auto world = glm::scale(draw.objectInstance.world, occluderExtents);
+            pOcclusionCuller->add_occluder(dst::gfx::primitive::Cube::Vertices, dst::gfx::primitive::Cube::Triangles, world);
         }
-        return *this;
     }
+    pOcclusionCuller->rasterize(jobSystem);
+    std::erase_if(*pVisibleDraws,
+        [&](uint32_t i)
+        {
+            const auto& aabb = boundingVolumeHierarchy.get_aabb(proxyIds[i]);
+            return !pOcclusionCuller->is_visible(aabb.min, aabb.max);
+        }
+    );
+}
 
-    inline void update_uniform_buffer(const gvk::Device& device) const
-    {
-        // Write this GameObject's ObjectUniforms data into the uniform Buffer.
-        ObjectUniforms ubo { };
-        rigidBody.get_motion_state_transform().getOpenGLMatrix(&ubo.world[0][0]);
-        ubo.color = color;
-        VmaAllocationInfo allocationInfo { };
-        vmaGetAllocationInfo(device.get<VmaAllocator>(), mUniformBuffer.get<VmaAllocation>(), &allocationInfo);
-        assert(allocationInfo.pMappedData);
-        memcpy(allocationInfo.pMappedData, &ubo, sizeof(ObjectUniforms));
+inline void record_draw_cmds(
+    const gvk::CommandBuffer& commandBuffer,
+    const gvk::Pipeline& pipeline,
+    const gvk::PipelineLayout& pipelineLayout,
+    const gvk::DescriptorSet& cameraDescriptorSet,
+    const glm::mat4& viewProjection,
+    bool drawContainer,
+    const FrameSnapshot& frameSnapshot,
+    std::span<const uint32_t> visibleDraws,
+    dst::gfx::RenderQueue& renderQueue,
+    dst::gfx::InstanceBatcher<>& instanceBatcher,
+    dst::gfx::UniformRing& instanceRing,
+    const dst::gfx::GeometryArena& geometryArena
+)
+{
+    // Submit each draw that survived frustum culling to the RenderQueue keyed by
+    //  mesh then depth so Entities sharing a mesh are adjacent, front to back.
+    //  Every draw in a frame uses the same Pipeline so pipeline and material ids
+    //  are 0.  The container is only drawn when drawContainer is true.
+    renderQueue.clear();
+    for (auto i : visibleDraws) {
+        const auto& draw = frameSnapshot.draws[i];
+        if (drawContainer || !draw.containerBarrier) {
+            auto clipPosition = viewProjection * draw.objectInstance.world[3];
+            auto depth = clipPosition.w ? clipPosition.z / clipPosition.w : 0.0f;
+#ifndef GLM_FORCE_DEPTH_ZERO_TO_ONE
+            // RenderQueue clamps depth to [0, 1], remap GL's [-1, 1] clip depth.
+            depth = depth * 0.5f + 0.5f;
+#endif
+            renderQueue.submit(0, 0, draw.pRenderable->meshId, depth, i);
+        }
     }
 
-    inline void record_draw_cmds(const gvk::CommandBuffer& commandBuffer, const gvk::PipelineLayout& pipelineLayout) const
-    {
-        // Bind this GameObject's DescriptorSet (which references the uniform Buffer)
-        //  then record the gvk::Mesh's draw cmds.
-        vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 1, 1, &mDescriptorSet.get<const VkDescriptorSet&>(), 0, nullptr);
-        mMesh.record_cmds(commandBuffer);
+    // Group the sorted draws into one Batch per mesh and write the
+    //  packed instance stream into the UniformRing.
+    const auto& batches = instanceBatcher.build(
+        renderQueue.sort(),
+        [&](uint32_t item)
+        {
+            const auto& objectInstance = frameSnapshot.draws[item].objectInstance;
+            return dst::gfx::InstanceWorldColor { objectInstance.world, objectInstance.color };
+        }
+    );
+    uint64_t instanceOffset = 0;
+    auto written = instanceRing.write(instanceBatcher.get_instances(), &instanceOffset);
+    (void)written;
+    assert(written);
+
+    // Record one instanced draw per Batch.  The Pipeline and Camera's
+    //  DescriptorSet are only bound when the RenderQueue flags a pipeline change.
+    //  Every mesh lives in the dst::gfx::GeometryArena and the frame's instance
+    //  stream is bound once at binding 1, so vertex and index buffers are bound
+    //  once per frame and each Batch only selects its ranges with firstIndex,
+    //  vertexOffset and firstInstance.
+    geometryArena.record_bind_cmds(commandBuffer);
+    vkCmdBindVertexBuffers(commandBuffer, 1, 1, &instanceRing.get_buffer().get<const VkBuffer&>(), &instanceOffset);
+    for (const auto& batch : batches) {
+        if (batch.flags & dst::gfx::RenderQueue::Draw::BindPipeline) {
+            vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+            vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &cameraDescriptorSet.get<const VkDescriptorSet&>(), 0, nullptr);
+        }
+        geometryArena.record_draw_cmds(commandBuffer, frameSnapshot.draws[batch.item].pRenderable->mesh, batch.instanceCount, batch.firstInstance);
     }
-
-    dst::physics::RigidBody rigidBody;
-    glm::vec4 color { gvk::math::Color::White };
-
-private:
-    gvk::Mesh mMesh;
-    gvk::Buffer mUniformBuffer;
-    gvk::DescriptorSet mDescriptorSet;
-};
-
-enum class GameState
-{
-    Playing,
-    Celebration,
-    GameOver,
-    Resetting,
-};
+}
 
 int main(int, const char* [])
 {
@@ -336,52 +416,107 @@ int main(int, const char* [])
     gvk::WsiManager wsiManager;
     dst_vk_result(gvk::WsiManager::create(gvkDevice, &wsiManagerCreateInfo, nullptr, &wsiManager));
 
+    // Create the DescriptorSetLayout and PipelineLayout by hand rather than
+    //  reflecting them from the shaders.  CameraUniforms at set 0 is a uniform
+    //  Buffer used in the vertex shader, per Entity data is read from an instance
+    //  stream so no other DescriptorSets are needed.
+    VkDescriptorSetLayoutBinding cameraDescriptorSetLayoutBinding { };
+    cameraDescriptorSetLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    cameraDescriptorSetLayoutBinding.descriptorCount = 1;
+    cameraDescriptorSetLayoutBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+    auto descriptorSetLayoutCreateInfo = gvk::get_default<VkDescriptorSetLayoutCreateInfo>();
+    descriptorSetLayoutCreateInfo.bindingCount = 1;
+    descriptorSetLayoutCreateInfo.pBindings = &cameraDescriptorSetLayoutBinding;
+    gvk::DescriptorSetLayout cameraDescriptorSetLayout;
+    dst_vk_result(gvk::DescriptorSetLayout::create(gvkDevice, &descriptorSetLayoutCreateInfo, nullptr, &cameraDescriptorSetLayout));
+    auto pipelineLayoutCreateInfo = gvk::get_default<VkPipelineLayoutCreateInfo>();
+    pipelineLayoutCreateInfo.setLayoutCount = 1;
+    pipelineLayoutCreateInfo.pSetLayouts = &cameraDescriptorSetLayout.get<const VkDescriptorSetLayout&>();
+    gvk::PipelineLayout pipelineLayout;
+    dst_vk_result(gvk::PipelineLayout::create(gvkDevice, &pipelineLayoutCreateInfo, nullptr, &pipelineLayout));
+
+    // Create a dst::gfx::ShaderCache next to the sample's assets and a
+    //  gvk::PipelineCache seeded from it.  Compiled SPIR-V and the driver's
+    //  pipeline cache data persist between launches so warm launches skip shader
+    //  compilation.  If the cache directory can't be created shaders are compiled
+    //  every launch.
+    dst::gfx::ShaderCache::CreateInfo shaderCacheCreateInfo { };
+    shaderCacheCreateInfo.directory = DST_SAMPLE_ASSET_DIRECTORY "/brick-breaker.cache";
+    dst::gfx::ShaderCache shaderCache;
+    auto shaderCacheCreated = dst::gfx::ShaderCache::create(&shaderCacheCreateInfo, &shaderCache);
+    auto pShaderCache = shaderCacheCreated ? &shaderCache : nullptr;
+    gvk::PipelineCache pipelineCache;
+    if (shaderCacheCreated) {
+        dst_vk_result(shaderCache.create_pipeline_cache(gvkDevice, &pipelineCache));
+    }
+
+    // Create a dst::JobSystem and a dst::gfx::PipelineBuilder that uses it to
+    //  compile shaders and create Pipelines in parallel.
+    dst::JobSystem::CreateInfo jobSystemCreateInfo { };
+    dst::JobSystem jobSystem;
+    dst::JobSystem::create(&jobSystemCreateInfo, &jobSystem);
+    dst::gfx::PipelineBuilder::CreateInfo pipelineBuilderCreateInfo { };
+    pipelineBuilderCreateInfo.pJobSystem = &jobSystem;
+    pipelineBuilderCreateInfo.pShaderCache = pShaderCache;
+    pipelineBuilderCreateInfo.compile = dst_sample_compile_shader;
+    dst::gfx::PipelineBuilder pipelineBuilder;
+    dst::gfx::PipelineBuilder::create(&pipelineBuilderCreateInfo, &pipelineBuilder);
+
     // Create two Pipelines.  These are identical except for the VkPolygonMode.
     //  polygonPipeline is used normally.  The wireframePipeline can be toggled for
-    //  debugging.
+    //  debugging.  Both variants share their shaders so the PipelineBuilder only
+    //  compiles each shader once, then the Pipelines are created concurrently.
     gvk::Pipeline polygonPipeline;
-    dst_vk_result(create_pipeline(wsiManager.get_render_pass(), VK_POLYGON_MODE_FILL, &polygonPipeline));
     gvk::Pipeline wireframePipeline;
-    dst_vk_result(create_pipeline(wsiManager.get_render_pass(), VK_POLYGON_MODE_LINE, &wireframePipeline));
+    std::vector<dst::gfx::PipelineBuilder::Description> pipelineDescriptions;
+    pipelineDescriptions.push_back(create_pipeline_description(wsiManager.get_render_pass(), VK_POLYGON_MODE_FILL, pipelineLayout, pipelineCache, &polygonPipeline));
+    pipelineDescriptions.push_back(create_pipeline_description(wsiManager.get_render_pass(), VK_POLYGON_MODE_LINE, pipelineLayout, pipelineCache, &wireframePipeline));
+    auto pipelineFutures = pipelineBuilder.build(std::move(pipelineDescriptions));
+    for (const auto& pipelineFuture : pipelineFutures) {
+        dst_vk_result(pipelineFuture.get());
+    }
+    if (pipelineCache) {
+        dst_vk_result(shaderCache.store_pipeline_cache(pipelineCache));
+    }
     auto pipeline = polygonPipeline;
 
-    // Create a DescriptorPool.  This DescriptorPool provides 1000 uniform Buffer
-    //  descriptors.  Only one is needed for each GameObject, but this leaves
-    //  plenty of headroom to create more GameObjects without having to change the
-    //  DescriptorPool.
-    auto descriptorPoolSize = gvk::get_default<VkDescriptorPoolSize>();
-    descriptorPoolSize.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    descriptorPoolSize.descriptorCount = 1000;
+    // Create a DescriptorPool.  Only one DescriptorSet is needed, for the Camera.
+    VkDescriptorPoolSize descriptorPoolSize { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1 };
     auto descriptorPoolCreateInfo = gvk::get_default<VkDescriptorPoolCreateInfo>();
     descriptorPoolCreateInfo.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
-    descriptorPoolCreateInfo.maxSets = descriptorPoolSize.descriptorCount;
+    descriptorPoolCreateInfo.maxSets = 1;
     descriptorPoolCreateInfo.poolSizeCount = 1;
     descriptorPoolCreateInfo.pPoolSizes = &descriptorPoolSize;
     gvk::DescriptorPool descriptorPool;
     dst_vk_result(gvk::DescriptorPool::create(gvkContext.get_devices()[0], &descriptorPoolCreateInfo, nullptr, &descriptorPool));
 
-    // Get the DescriptorSetLayouts from the Pipeline.  There should be two...
-    //      `layout(set = 0, binding = 0) uniform CameraUniforms`
-    //          used in the vertex shader
-    //  and
-    //      `layout(set = 1, binding = 0) uniform ObjectUniforms`
-    //          used in both the vertex and fragment shaders
-    const auto& descriptorSetLayouts = pipeline.get<gvk::PipelineLayout>().get<gvk::DescriptorSetLayouts>();
-    assert(descriptorSetLayouts.size() == 2);
-    const auto& cameraDescriptorSetLayout = descriptorSetLayouts[0];
-    const auto& objectDescriptorSetLayout = descriptorSetLayouts[1];
-
-    // Create a GameObject::Factory.  GameObject::Factory initializes graphics and
-    //  resources for GameObjects so provide it with the DescriptorPool and object
-    //  DescriptorSetLayout so it can allocate uniform Buffer descriptors when
-    //  creating GameObjects.
-    GameObject::Factory gameObjectFactory(descriptorPool, objectDescriptorSetLayout);
+    // Create a RenderableFactory.  RenderableFactory initializes graphics resources
+    //  for Entities.  Meshes are written through a dst::gfx::UploadBatcher so every
+    //  mesh in the level is uploaded with one submission.  Every mesh shares the
+    //  same vertex layout so they're all sub-allocated from one
+    //  dst::gfx::GeometryArena.
+    RenderableFactory renderableFactory;
+    dst::gfx::GeometryArena::CreateInfo geometryArenaCreateInfo { };
+    geometryArenaCreateInfo.vertexSize = sizeof(glm::vec3);
+    geometryArenaCreateInfo.vertexCapacity = 64 * 1024;
+    geometryArenaCreateInfo.indexCapacity = 256 * 1024;
+    dst::gfx::GeometryArena geometryArena;
+    dst_vk_result(dst::gfx::GeometryArena::create(gvkDevice, &geometryArenaCreateInfo, &geometryArena));
+    dst::gfx::UploadBatcher::CreateInfo uploadBatcherCreateInfo { };
+    dst::gfx::UploadBatcher uploadBatcher;
+    dst_vk_result(dst::gfx::UploadBatcher::create(gvkDevice, gvkQueue, &uploadBatcherCreateInfo, &uploadBatcher));
 
     // Create a dst::physics::World.
     dst::physics::World::CreateInfo physicsWorldCreateInfo { };
     dst::physics::World physicsWorld;
     dst::physics::World::create(&physicsWorldCreateInfo, &physicsWorld);
 
+    // Create a dst::Registry.  Every object in the sample is an Entity in this
+    //  Registry.  BrickBreaker owns the collision shapes used by the Registry's
+    //  RigidBody components so it's declared first and outlives them.
+    BrickBreaker brickBreaker;
+    dst::Registry registry;
+
     // Create a Camera.
     gvk::math::Camera camera;
     gvk::math::FreeCameraController cameraController;
@@ -412,76 +547,21 @@ int main(int, const char* [])
     writeDescriptorSet.pBufferInfo = &descriptorBufferInfo;
     vkUpdateDescriptorSets(gvkContext.get_devices()[0], 1, &writeDescriptorSet, 0, nullptr);
 
-    // Create the play field made up of the side and top barriers that the player
-    //  sees.
-    constexpr btScalar PlayFieldWidth        = 32;
-    constexpr btScalar PlayFieldHeight       = 64;
-    constexpr btScalar BarrierThickness      = 1;
-    constexpr uint32_t PlayFieldBarrierCount = 3;
-    const std::array<btVector3, PlayFieldBarrierCount> PlayFieldBarrierExtents {
-        btVector3(PlayFieldWidth,   BarrierThickness, BarrierThickness), // Top
-        btVector3(BarrierThickness, PlayFieldHeight,  BarrierThickness), // Left
-        btVector3(BarrierThickness, PlayFieldHeight,  BarrierThickness), // Right
-    };
-    const std::array<btVector3, PlayFieldBarrierCount> PlayFieldBarrierPositions {
-        btVector3(                  0,    PlayFieldHeight * 0.5f, 0), // Top
-        btVector3( PlayFieldWidth * 0.5f,                   0,    0), // Left
-        btVector3(-PlayFieldWidth * 0.5f,                   0,    0), // Right
-    };
-    constexpr btScalar PlayFieldBarrierRestitution = 0.6f;
-    std::array<GameObject, PlayFieldBarrierCount> playFieldBarriers;
-    for (size_t i = 0; i < playFieldBarriers.size(); ++i) {
-        GameObject::BoxCreateInfo gameObjectBoxCreateInfo { };
-        gameObjectBoxCreateInfo.extents = PlayFieldBarrierExtents[i];
-        GameObject::CreateInfo gameObjectCreateInfo { };
-        gameObjectCreateInfo.pBoxCreateInfo = &gameObjectBoxCreateInfo;
-        gameObjectCreateInfo.rigidBodyCreateInfo.material.restitution = PlayFieldBarrierRestitution;
-        gameObjectCreateInfo.rigidBodyCreateInfo.initialTransform.setOrigin(PlayFieldBarrierPositions[i]);
-        gameObjectFactory.create_game_object(gvkContext.get_command_buffers()[0], gameObjectCreateInfo, &playFieldBarriers[i]);
-        physicsWorld.make_static(playFieldBarriers[i].rigidBody);
-    }
-
-    // Create the container surrounding the play field.  This container provides a
-    //  boundary for bricks/balls that have gone out of play.  The container isn't
-    //  rendered unless the wireframe Pipeline is enabled.
-    constexpr btScalar ContainerWidth        = PlayFieldWidth + PlayFieldWidth * 0.5f;
-    constexpr btScalar ContainerHeight       = PlayFieldHeight + PlayFieldHeight * 0.18f;
-    constexpr btScalar ContainerDepth        = 16;
-    constexpr uint32_t ContainerBarrierCount = 5;
-    const std::array<btVector3, ContainerBarrierCount> ContainerBarrierExtents {
-        btVector3(ContainerWidth,   ContainerHeight,  BarrierThickness), // Back
-        btVector3(BarrierThickness, ContainerHeight,  ContainerDepth),   // Left
-        btVector3(BarrierThickness, ContainerHeight,  ContainerDepth),   // Right
-        btVector3(ContainerWidth,   ContainerHeight,  BarrierThickness), // Front
-        btVector3(ContainerWidth,   BarrierThickness, ContainerDepth),   // Bottom
-    };
-    const std::array<btVector3, ContainerBarrierCount> ContainerBarrierPositions {
-        btVector3(                  0,                       0,     ContainerDepth * 0.5f), // Back
-        btVector3( ContainerWidth * 0.5f,                    0,                      0),    // Left
-        btVector3(-ContainerWidth * 0.5f,                    0,                      0),    // Right
-        btVector3(                  0,                       0,    -ContainerDepth * 0.5f), // Front
-        btVector3(                  0,    -ContainerHeight * 0.5f,                   0),    // Bottom
-    };
-    std::array<GameObject, ContainerBarrierCount> containerBarriers;
-    for (size_t i = 0; i < containerBarriers.size(); ++i) {
-        GameObject::BoxCreateInfo gameObjectBoxCreateInfo { };
-        gameObjectBoxCreateInfo.extents = ContainerBarrierExtents[i];
-        GameObject::CreateInfo gameObjectCreateInfo { };
-        gameObjectCreateInfo.pBoxCreateInfo = &gameObjectBoxCreateInfo;
-        gameObjectCreateInfo.rigidBodyCreateInfo.initialTransform.setOrigin(ContainerBarrierPositions[i]);
-        gameObjectFactory.create_game_object(gvkContext.get_command_buffers()[0], gameObjectCreateInfo, &containerBarriers[i]);
-        physicsWorld.make_static(containerBarriers[i].rigidBody);
-    }
-
-    // Create the bricks.
-    constexpr btScalar BrickMass       = 8;
-    constexpr btScalar BrickWidth      = 2;
-    constexpr btScalar BrickHeight     = 1;
-    constexpr btScalar BrickDepth      = 1;
-    constexpr uint32_t BrickRowCount   = 6;
-    constexpr uint32_t BrickColumCount = 10;
-    constexpr uint32_t BrickCount      = BrickRowCount * BrickColumCount;
-    const std::array<glm::vec4, BrickRowCount> BrickRowColors {
+    // Map the AssetFile written at build time by asset-writer from
+    //  brick-breaker.assets.  If it's missing the ball mesh is generated instead.
+    constexpr uint32_t BallMeshAssetId = 0;
+    dst::AssetFile assetFile;
+    dst::AssetFile::CreateInfo assetFileCreateInfo { };
+    assetFileCreateInfo.filePath = DST_SAMPLE_ASSET_DIRECTORY "/brick-breaker.dsta";
+    dst::gfx::MeshAsset ballMeshAsset { };
+    auto ballMeshAssetLoaded =
+        dst::AssetFile::create(&assetFileCreateInfo, &assetFile) &&
+        dst::gfx::get_mesh_asset(assetFile, BallMeshAssetId, &ballMeshAsset);
+
+    // Create the level.  BrickBreaker creates each Entity and its RigidBody, the
+    //  callback adds the ObjectInstance and Renderable used to draw it.  The
+    //  container isn't rendered unless the wireframe Pipeline is enabled.
+    const std::array<glm::vec4, 6> BrickRowColors {
         gvk::math::Color::Red,
         gvk::math::Color::DarkOrange,
         gvk::math::Color::Yellow,
@@ -489,100 +569,112 @@ int main(int, const char* [])
         gvk::math::Color::DodgerBlue,
         gvk::math::Color::Violet,
     };
-    const std::array<btVector3, BrickCount> BrickPositions {
-        [&]()
-        {
-            const btScalar PlayAreaWidth = PlayFieldWidth - BarrierThickness;
-            const btScalar BrickAreaWidth = PlayAreaWidth / BrickColumCount;
-            std::array<btVector3, BrickCount> brickPositions { };
-            for (uint32_t row_i = 0; row_i < BrickRowCount; ++row_i) {
-                auto x = -PlayAreaWidth * 0.5f + BrickAreaWidth * 0.5f;
-                for (uint32_t brick_i = 0; brick_i < BrickColumCount; ++brick_i) {
-                    auto y = 30.0f - row_i * BrickHeight * 2.0f;
-                    brickPositions[row_i * BrickColumCount + brick_i] = { x, y, 0 };
-                    x += BrickAreaWidth;
-                }
-            }
-            return brickPositions;
-        }()
+    BrickBreaker::CreateInfo brickBreakerCreateInfo { };
+    brickBreakerCreateInfo.pPhysicsWorld = &physicsWorld;
+    brickBreakerCreateInfo.pRegistry = &registry;
+    brickBreakerCreateInfo.brickRowCount = (uint32_t)BrickRowColors.size();
+    brickBreakerCreateInfo.onEntityCreated = [&](dst::Entity entity, const BrickBreaker::EntityInfo& entityInfo)
+    {
+        glm::vec4 color = gvk::math::Color::White;
+        switch (entityInfo.type) {
+        case BrickBreaker::EntityType::Brick: {
+            color = BrickRowColors[entityInfo.index / brickBreakerCreateInfo.brickColumnCount];
+        } break;
+        case BrickBreaker::EntityType::Ball: {
+            color = gvk::math::Color::SlateGray;
+        } break;
+        case BrickBreaker::EntityType::Paddle: {
+            color = gvk::math::Color::Brown;
+        } break;
+        default: break;
+        }
+        registry.emplace<ObjectInstance>(entity).color = color;
+        registry.emplace<Renderable>(entity, renderableFactory.get_renderable(geometryArena, uploadBatcher, entityInfo, ballMeshAssetLoaded ? &ballMeshAsset : nullptr));
     };
-    std::array<GameObject, BrickCount> bricks { };
-    std::unordered_set<GameObject*> liveBricks;
-    std::array<std::tuple<btVector3, btQuaternion>, BrickCount> deadBricks { };
-    for (uint32_t i = 0; i < BrickCount; ++i) {
-        GameObject::BoxCreateInfo gameObjectBoxCreateInfo { };
-        gameObjectBoxCreateInfo.extents = { BrickWidth, BrickHeight, BrickDepth };
-        GameObject::CreateInfo gameObjectCreateInfo { };
-        gameObjectCreateInfo.pBoxCreateInfo = &gameObjectBoxCreateInfo;
-        gameObjectCreateInfo.rigidBodyCreateInfo.mass = BrickMass;
-        gameObjectCreateInfo.rigidBodyCreateInfo.initialTransform.setOrigin(BrickPositions[i]);
-        gameObjectFactory.create_game_object(gvkContext.get_command_buffers()[0], gameObjectCreateInfo, &bricks[i]);
-        bricks[i].color = BrickRowColors[i / BrickColumCount];
-        physicsWorld.make_static(bricks[i].rigidBody);
-        liveBricks.insert(&bricks[i]);
-    }
+    BrickBreaker::create(&brickBreakerCreateInfo, &brickBreaker);
+
+    // Submit the level's mesh uploads.  Frames are submitted to the same queue
+    //  after this so they don't need to wait for the upload to complete.
+    dst_vk_result(uploadBatcher.submit());
+
+    // Every Entity's ObjectInstance is written to instanceRing each frame.  Its
+    //  Buffer is created once the SwapchainKHR's Image count is known.
+    const auto instanceRingFrameSize = (uint64_t)registry.get_storage<Renderable>().size() * sizeof(dst::gfx::InstanceWorldColor);
+    dst::gfx::UniformRing instanceRing;
+
+    // Create a dst::gfx::RenderQueue used to sort draws each frame and a
+    //  dst::gfx::InstanceBatcher used to group them into instanced draws.
+    dst::gfx::RenderQueue::CreateInfo renderQueueCreateInfo { };
+    renderQueueCreateInfo.capacity = registry.get_storage<Renderable>().size();
+    dst::gfx::RenderQueue renderQueue;
+    dst::gfx::RenderQueue::create(&renderQueueCreateInfo, &renderQueue);
+    dst::gfx::InstanceBatcher<>::CreateInfo instanceBatcherCreateInfo { };
+    instanceBatcherCreateInfo.capacity = registry.get_storage<Renderable>().size();
+    dst::gfx::InstanceBatcher<> instanceBatcher;
+    dst::gfx::InstanceBatcher<>::create(&instanceBatcherCreateInfo, &instanceBatcher);
+
+    // Create a dst::gfx::BoundingVolumeHierarchy used to frustum cull draws each
+    //  frame, visibleDraws receives the indices of draws that survive.
+    dst::gfx::BoundingVolumeHierarchy::CreateInfo boundingVolumeHierarchyCreateInfo { };
+    boundingVolumeHierarchyCreateInfo.capacity = (uint32_t)registry.get_storage<Renderable>().size();
+    dst::gfx::BoundingVolumeHierarchy boundingVolumeHierarchy;
+    dst::gfx::BoundingVolumeHierarchy::create(&boundingVolumeHierarchyCreateInfo, &boundingVolumeHierarchy);
+    std::vector<dst::gfx::BoundingVolumeHierarchy::ProxyId> drawProxyIds;
+    std::vector<uint32_t> visibleDraws;
+
+    // Create a dst::gfx::OcclusionCuller used to remove frustum culled draws that
+    //  are hidden behind bricks and barriers.
+    dst::gfx::OcclusionCuller::CreateInfo occlusionCullerCreateInfo { };
+    dst::gfx::OcclusionCuller occlusionCuller;
+    dst::gfx::OcclusionCuller::create(&occlusionCullerCreateInfo, &occlusionCuller);
+
+    // Create a Clock.
+    gvk::system::Clock clock;
 
-    // Create the balls.
-    constexpr btScalar BallRadius = 0.5f;
-    constexpr btScalar BallMass   = 1;
-    constexpr uint32_t BallCount  = 3;
-    const std::array<btVector3, BallCount> BallPositions {
-        [&]()
-        {
-            const btScalar Gap = BallRadius * 4;
-            std::array<btVector3, BallCount> ballPositions { };
-            for (uint32_t i = 0; i < BallCount; ++i) {
-                auto x = -PlayFieldWidth * 0.5f + i * Gap;
-                auto y = PlayFieldHeight * 0.5f + Gap;
-                ballPositions[i] = { x, y, 0 };
+    // Game logic and physics run on the FramePipeline's simulation thread, the
+    //  main thread handles input, the Camera and rendering.  Everything captured
+    //  here other than the FrameInput and FrameSnapshot is only touched by the
+    //  simulation thread from now until the FramePipeline is reset.
+    auto simulate = [&](const FrameInput& frameInput, FrameSnapshot* pFrameSnapshot)
+    {
+        // Run the game logic then update the dst::physics::World.
+        brickBreaker.update(frameInput);
+        physicsWorld.update(frameInput.deltaTime);
+
+        // Cycle through flashing colors on the play field barriers while
+        //  celebrating, otherwise the play field barriers are Color::White.
+        constexpr float CelebrationColorDuration = 0.01f;
+        static const std::vector<glm::vec4> CelebrationColors {
+            gvk::math::Color::Red,
+            gvk::math::Color::White,
+            gvk::math::Color::Blue,
+            gvk::math::Color::Yellow
+        };
+        glm::vec4 playFieldBarrierColor = gvk::math::Color::White;
+        if (brickBreaker.get_state() == GameState::Celebration) {
+            float t = brickBreaker.get_state_time() / CelebrationColorDuration;
+            playFieldBarrierColor = CelebrationColors[(size_t)std::round(t) % CelebrationColors.size()];
+        }
+        registry.each<PlayFieldBarrier, ObjectInstance>(
+            [&](dst::Entity, PlayFieldBarrier&, ObjectInstance& objectInstance)
+            {
+                objectInstance.color = playFieldBarrierColor;
             }
-            return ballPositions;
-        }()
-    };
-    constexpr btScalar BallRestitution = 0.9f;
-    std::array<GameObject, BallCount> balls;
-    for (uint32_t i = 0; i < BallCount; ++i) {
-        GameObject::SphereCreateInfo gameObjectSphereCreateInfo { };
-        gameObjectSphereCreateInfo.radius = BallRadius;
-        GameObject::CreateInfo gameObjectCreateInfo { };
-        gameObjectCreateInfo.pSphereCreateInfo = &gameObjectSphereCreateInfo;
-        gameObjectCreateInfo.rigidBodyCreateInfo.mass = BallMass;
-        gameObjectCreateInfo.rigidBodyCreateInfo.material.restitution = BallRestitution;
-        gameObjectCreateInfo.rigidBodyCreateInfo.linearFactor = { 1, 1, 0 };
-        gameObjectCreateInfo.rigidBodyCreateInfo.initialTransform.setOrigin(BallPositions[i]);
-        gameObjectFactory.create_game_object(gvkContext.get_command_buffers()[0], gameObjectCreateInfo, &balls[i]);
-        balls[i].color = gvk::math::Color::SlateGray;
-    }
+        );
 
-    // Create the paddle.
-    constexpr btScalar PaddleWidth           = 6;
-    constexpr btScalar PaddleHeight          = 1;
-    constexpr btScalar PaddleDepth           = 0.1f;
-    constexpr btScalar PaddleMass            = 1;
-    constexpr btScalar PaddleForceStrength   = 48;
-    constexpr btScalar PaddleImpulseStrength = 64;
-    GameObject paddle;
-    {
-        GameObject::BoxCreateInfo gameObjectBoxCreateInfo { };
-        gameObjectBoxCreateInfo.extents = { PaddleWidth, PaddleHeight, PaddleDepth };
-        GameObject::CreateInfo gameObjectCreateInfo { };
-        gameObjectCreateInfo.rigidBodyCreateInfo.mass = PaddleMass;
-        gameObjectCreateInfo.rigidBodyCreateInfo.linearDamping = 0.4f;
-        gameObjectCreateInfo.rigidBodyCreateInfo.linearFactor = { 1, 0, 0 };
-        gameObjectCreateInfo.rigidBodyCreateInfo.angularFactor = { 0, 0, 0 };
-        gameObjectCreateInfo.rigidBodyCreateInfo.initialTransform.setOrigin({ 0, -PlayFieldHeight * 0.5f + PaddleHeight * 4, 0 });
-        gameObjectCreateInfo.pBoxCreateInfo = &gameObjectBoxCreateInfo;
-        gameObjectFactory.create_game_object(gvkContext.get_command_buffers()[0], gameObjectCreateInfo, &paddle);
-        paddle.color = gvk::math::Color::Brown;
-        physicsWorld.make_dynamic(paddle.rigidBody);
-    }
+        // Sync RigidBody transforms into ObjectInstance then copy ObjectInstance
+        //  into the FrameSnapshot for the render thread.
+        sync_object_instances(registry);
+        write_frame_snapshot(registry, pFrameSnapshot);
+    };
 
-    // Create a Clock, some timers that will be used when GameState changes and set
-    //  the GameState to GameState::Playing.
-    gvk::system::Clock clock;
-    float celebrationTimer = 0;
-    float resetTimer = 0;
-    GameState state = GameState::Playing;
+    // Create a dst::FramePipeline.  While the simulation thread runs frame N + 1
+    //  the main thread writes uniforms and records draw cmds for frame N
+    //  from a double buffered FrameSnapshot.
+    dst::FramePipeline<FrameInput, FrameSnapshot>::CreateInfo framePipelineCreateInfo { };
+    framePipelineCreateInfo.simulate = simulate;
+    dst::FramePipeline<FrameInput, FrameSnapshot> framePipeline;
+    dst::FramePipeline<FrameInput, FrameSnapshot>::create(&framePipelineCreateInfo, &framePipeline);
 
     // Loop until the user presses [Esc] or closes the app window.
     while (
@@ -594,6 +686,10 @@ int main(int, const char* [])
         clock.update();
         auto deltaTime = clock.elapsed<gvk::system::Seconds<float>>();
 
+        // Mark the start of a new frame for the profiler.  This compiles to nothing
+        //  unless DST_PROFILER_ENABLED is defined.
+        dst_profile_frame();
+
         // Call the static function gvk::system::Surface::update() to cause all
         //  gvk::system::Surface objects to process window/input events.  Get a
         //  reference to the Surface's Input object.
@@ -628,200 +724,15 @@ int main(int, const char* [])
         }
         cameraController.update(cameraControllerUpdateInfo);
 
-        // Apply a force on the paddle when the user is pressing [<] or [>].
-        if (input.keyboard.down(gvk::system::Key::LeftArrow)) {
-            paddle.rigidBody.apply_force({ PaddleForceStrength, 0, 0 });
-        }
-        if (input.keyboard.down(gvk::system::Key::RightArrow)) {
-            paddle.rigidBody.apply_force({ -PaddleForceStrength, 0, 0 });
-        }
-
-        // Switch on GameState.
-        switch (state) {
-        case GameState::Playing: {
-            // If the user presses [Space] and there's at least one live ball left, fire a
-            //  ball.
-            if (input.keyboard.pressed(gvk::system::Key::SpaceBar)) {
-                for (auto ritr = balls.rbegin(); ritr != balls.rend(); ++ritr) {
-                    auto& rigidBody = ritr->rigidBody;
-                    if (rigidBody.get_state() == dst::physics::RigidBody::State::Disabled) {
-                        rigidBody.halt();
-                        rigidBody.set_transform(btTransform::getIdentity());
-                        physicsWorld.make_dynamic(rigidBody);
-                        break;
-                    }
-                }
-            }
-            // If a live brick has been hit by anything (a ball or another brick), make it
-            //  dynamic and remove it from the liveBricks collection.
-            for (auto itr = liveBricks.begin(); itr != liveBricks.end();) {
-                auto& rigidBody = (*itr)->rigidBody;
-                if (physicsWorld.get_collided_rigid_bodies().count(&rigidBody)) {
-                    physicsWorld.disable(rigidBody);
-                    physicsWorld.make_dynamic(rigidBody);
-                    liveBricks.erase(itr++);
-                } else {
-                    ++itr;
-                }
-            }
-            // Check for live balls and ball/paddle collisions.  If there was a collision
-            //  between a ball and the top of the paddle, apply an impulse to the ball.
-            //  The direction of the impulse is the vector from the center of the paddle to
-            //  the center of the ball.
-            uint32_t liveBallCount = 0;
-            const btScalar OutOfPlay = -PlayFieldHeight * 0.5f;
-            const auto& paddlePosition = paddle.rigidBody.get_transform().getOrigin();
-            for (auto& ball : balls) {
-                const auto& ballPosition = ball.rigidBody.get_transform().getOrigin();
-                if (OutOfPlay < ballPosition.y()) {
-                    ++liveBallCount;
-                    if (physicsWorld.get_collisions().count(dst::physics::make_collision(&ball.rigidBody, &paddle.rigidBody))) {
-                        if (paddlePosition.y() < ballPosition.y()) {
-                            auto impulse = (ballPosition - paddlePosition).normalized();
-                            impulse *= PaddleImpulseStrength;
-                            impulse.setY(PaddleImpulseStrength);
-                            ball.rigidBody.apply_impulse(impulse);
-                        }
-                    }
-                }
-            }
-            // If liveBricks is empty, then all bricks have been broken out and GameState
-            //  transitions to Celebration.  If there are still live bricks left but no
-            //  live balls, then transition GameState to GameOver.
-            if (liveBricks.empty()) {
-                celebrationTimer = 0;
-                state = GameState::Celebration;
-            } else if (!liveBallCount) {
-                state = GameState::GameOver;
-            }
-        } break;
-        case GameState::Celebration: {
-            // Cycle through flashing colors on the play field barriers for some time.
-            //  When celebrationTimer reaches CelebrationDuration, reset the play field
-            //  barrier colors to Color::White and transition GameState to GameOver.
-            constexpr float CelebrationDuration      = 4.5f;
-            constexpr float CelebrationColorDuration = 0.01f;
-            static const std::vector<glm::vec4> CelebrationColors {
-                gvk::math::Color::Red,
-                gvk::math::Color::White,
-                gvk::math::Color::Blue,
-                gvk::math::Color::Yellow
-            };
-            celebrationTimer += deltaTime;
-            if (celebrationTimer < CelebrationDuration) {
-                float t = celebrationTimer / CelebrationColorDuration;
-                auto colorIndex = (size_t)std::round(t) % CelebrationColors.size();
-                for (auto& wall : playFieldBarriers) {
-                    wall.color = CelebrationColors[colorIndex];
-                }
-            } else {
-                for (auto& wall : playFieldBarriers) {
-                    wall.color = gvk::math::Color::White;
-                }
-                state = GameState::GameOver;
-            }
-        } break;
-        case GameState::GameOver: {
-            // halt() and disable() the bricks.  Record brick positions and rotations for
-            //  use in the reset animation.
-            for (uint32_t i = 0; i < BrickCount; ++i) {
-                auto& brick = bricks[i];
-                brick.rigidBody.halt();
-                physicsWorld.disable(brick.rigidBody);
-                const auto& transform = brick.rigidBody.get_transform();
-                std::get<btVector3>(deadBricks[i]) = transform.getOrigin();
-                std::get<btQuaternion>(deadBricks[i]) = transform.getRotation();
-            }
-            // halt() and disable() the balls.
-            for (auto& ball : balls) {
-                ball.rigidBody.halt();
-                physicsWorld.disable(ball.rigidBody);
-            }
-            // Transition GameState to Resetting
-            resetTimer = 0;
-            state = GameState::Resetting;
-        } break;
-        case GameState::Resetting: {
-            constexpr float ResetDuration = 2.5f;
-            resetTimer += deltaTime;
-            // If resetTimer is less than ResetDuration, run the reset logic, otherwise set
-            //  all of the bricks and balls to their initial positions (bricks lerp from
-            //  their GameOver positions back to their initial positions, but may not land
-            //  at exactly their starting positions...the balls should always get back to
-            //  their starting positions via the reset logic unless something causes a very
-            //  long delta time in which case a ball's reset may be skipped) and transition
-            //  GameState to Playing.
-            if (resetTimer < ResetDuration) {
-                float t = resetTimer / ResetDuration;
-                for (uint32_t i = 0; i < BrickCount; ++i) {
-                    auto transform = bricks[i].rigidBody.get_transform();
-                    transform.setOrigin(std::get<btVector3>(deadBricks[i]).lerp(BrickPositions[i], t));
-                    transform.setRotation(std::get<btQuaternion>(deadBricks[i]).slerp(btQuaternion::getIdentity(), t));
-                    bricks[i].rigidBody.set_transform(transform);
-                }
-                // When resetting the balls, a counter is used that starts at BallCount and
-                //  counts down.  As the counter decrements, the counter value (minus 1) is
-                //  subracted from BallCount to get the index of the ball that should be reset
-                //  to its initial position.
-                auto ballResetCounter = BallCount - (size_t)(t * (BallCount + 1));
-                if (ballResetCounter < BallCount) {
-                    auto ballIndex = BallCount - ballResetCounter - 1;
-                    auto transform = balls[ballIndex].rigidBody.get_transform();
-                    transform.setOrigin(BallPositions[ballIndex]);
-                    balls[ballIndex].rigidBody.set_transform(transform);
-                }
-            } else {
-                for (uint32_t i = 0; i < BrickCount; ++i) {
-                    auto transform = bricks[i].rigidBody.get_transform();
-                    transform.setOrigin(BrickPositions[i]);
-                    transform.setRotation(btQuaternion::getIdentity());
-                    bricks[i].rigidBody.set_transform(transform);
-                    physicsWorld.make_static(bricks[i].rigidBody);
-                    liveBricks.insert(&bricks[i]);
-                }
-                for (uint32_t i = 0; i < BallCount; ++i) {
-                    auto transform = balls[i].rigidBody.get_transform();
-                    transform.setOrigin(BallPositions[i]);
-                    transform.setRotation(btQuaternion::getIdentity());
-                    balls[i].rigidBody.set_transform(transform);
-                }
-                state = GameState::Playing;
-            }
-        } break;
-        }
-
-        // Clamp the paddle's position within the play field boundaries.  This prevents
-        //  the paddle from tunneling through the walls.  Without this, the right
-        //  combination of forces from the player, the balls, and bricks can cause the
-        //  paddle to escape the play field.
-        auto paddleTransform = paddle.rigidBody.get_transform();
-        auto paddleX = paddleTransform.getOrigin().x();
-        auto xMax = PlayFieldWidth * 0.5f - PaddleWidth * 0.5f;
-        auto xMin = -xMax;
-        paddleTransform.getOrigin().setX(glm::clamp(paddleX, xMin, xMax));
-        paddle.rigidBody.set_transform(paddleTransform);
-
-        // Update the dst::physics::World
-        physicsWorld.update(deltaTime);
-
-        // Update GameObject uniform buffers
-        paddle.update_uniform_buffer(gvkContext.get_devices()[0]);
-        for (const auto& wall : playFieldBarriers) {
-            wall.update_uniform_buffer(gvkContext.get_devices()[0]);
-        }
-        for (const auto& brick : bricks) {
-            brick.update_uniform_buffer(gvkContext.get_devices()[0]);
-        }
-        for (const auto& ball : balls) {
-            ball.update_uniform_buffer(gvkContext.get_devices()[0]);
-        }
-
-        // If wireframe (debug) mode is enabled, update the container uniform buffers.
-        if (pipeline == wireframePipeline) {
-            for (const auto& containerBarrier : containerBarriers) {
-                containerBarrier.update_uniform_buffer(gvkContext.get_devices()[0]);
-            }
-        }
+        // Submit this frame's input to the FramePipeline then acquire the previous
+        //  frame's FrameSnapshot.
+        FrameInput frameInput { };
+        frameInput.deltaTime = deltaTime;
+        frameInput.movePaddleLeft = input.keyboard.down(gvk::system::Key::LeftArrow);
+        frameInput.movePaddleRight = input.keyboard.down(gvk::system::Key::RightArrow);
+        frameInput.fireBall = input.keyboard.pressed(gvk::system::Key::SpaceBar);
+        framePipeline.submit(frameInput);
+        const auto& frameSnapshot = framePipeline.acquire();
 
         // Call wsiManager.update().  This will cause WsiManager to respond to system
         //  updates for the SurfaceKHR it's managing.  This call may cause resources to
@@ -829,6 +740,19 @@ int main(int, const char* [])
         wsiManager.update();
         auto swapchain = wsiManager.get_swapchain();
         if (swapchain) {
+            // instanceRing has a frame region per SwapchainKHR Image so it can be indexed
+            //  with the acquired Image index.  If the Image count changes, wait for the
+            //  GPU to be idle then recreate it.
+            auto frameCount = (uint32_t)wsiManager.get_command_buffers().size();
+            if (instanceRing.get_frame_count() != frameCount) {
+                dst_vk_result(vkDeviceWaitIdle(gvkDevice));
+                dst::gfx::UniformRing::CreateInfo uniformRingCreateInfo { };
+                uniformRingCreateInfo.frameCount = frameCount;
+                uniformRingCreateInfo.frameSize = instanceRingFrameSize;
+                uniformRingCreateInfo.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
+                dst_vk_result(dst::gfx::UniformRing::create(gvkDevice, &uniformRingCreateInfo, &instanceRing));
+            }
+
             // Update the Camera's aspect ratio to match the SwapchainKHR's then update the
             //  Camera's uniform buffer
             auto extent = wsiManager.get_swapchain().get<VkSwapchainCreateInfoKHR>().imageExtent;
@@ -857,6 +781,10 @@ int main(int, const char* [])
             dst_vk_result(vkWaitForFences(gvkDevice, 1, &vkFences[imageIndex], VK_TRUE, UINT64_MAX));
             dst_vk_result(vkResetFences(gvkDevice, 1, &vkFences[imageIndex]));
 
+            // The Fence wait guarantees the GPU is done reading this Image's region of
+            //  instanceRing so it can be rewound and written again.
+            instanceRing.begin_frame(imageIndex);
+
             // Begin CommandBuffer recording and begin a RenderPass.
             const auto& commandBuffer = wsiManager.get_command_buffers()[imageIndex];
             dst_vk_result(vkBeginCommandBuffer(commandBuffer, &gvk::get_default<VkCommandBufferBeginInfo>()));
@@ -869,39 +797,43 @@ int main(int, const char* [])
             VkViewport viewport { .width = (float)scissor.extent.width, .height = (float)scissor.extent.height, .minDepth = 0, .maxDepth = 1 };
             vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
 
-            // Bind the current Pipeline
-            vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+            // Refit boundingVolumeHierarchy with this frame's transforms and cull it
+            //  against the Camera's frustum on the JobSystem.
+            auto viewProjection = cameraUbo.projection * cameraUbo.view;
+            update_bounding_volume_hierarchy(frameSnapshot, &boundingVolumeHierarchy, &drawProxyIds);
+            boundingVolumeHierarchy.cull(dst::gfx::make_frustum(viewProjection), jobSystem, &visibleDraws);
 
-            // Bind the Camera's DescriptorSet.  Since all objects are being drawn with the
-            //  same Camera this binding will be used for all subsequent draw calls in this
-            //  RenderPass.
-            const auto& pipelineLayout = pipeline.get<gvk::PipelineLayout>();
-            vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &cameraDescriptorSet.get<const VkDescriptorSet&>(), 0, nullptr);
-
-            // Record draw calls for all of the GameObjects.
-            paddle.record_draw_cmds(commandBuffer, pipelineLayout);
-            for (const auto& playFieldBarrier : playFieldBarriers) {
-                playFieldBarrier.record_draw_cmds(commandBuffer, pipelineLayout);
-            }
-            for (const auto& brick : bricks) {
-                brick.record_draw_cmds(commandBuffer, pipelineLayout);
-            }
-            for (const auto& ball : balls) {
-                ball.record_draw_cmds(commandBuffer, pipelineLayout);
+            // Occlusion cull the visible draws on the CPU.  Everything in the frustum
+            //  is drawn in wireframe mode.
+            if (pipeline != wireframePipeline) {
+                cull_occluded_draws(frameSnapshot, boundingVolumeHierarchy, drawProxyIds, viewProjection, jobSystem, &occlusionCuller, &visibleDraws);
             }
 
-            // If wireframe (debug) mode is enabled, draw the container.
-            if (pipeline == wireframePipeline) {
-                for (const auto& containerBarrier : containerBarriers) {
-                    containerBarrier.record_draw_cmds(commandBuffer, pipelineLayout);
-                }
-            }
+            // Record draw calls for the visible Entities.  record_draw_cmds() binds the
+            //  current Pipeline, the Camera's DescriptorSet and the GeometryArena.  If
+            //  wireframe (debug) mode is enabled, draw the container.
+            record_draw_cmds(
+                commandBuffer,
+                pipeline,
+                pipelineLayout,
+                cameraDescriptorSet,
+                viewProjection,
+                pipeline == wireframePipeline,
+                frameSnapshot,
+                visibleDraws,
+                renderQueue,
+                instanceBatcher,
+                instanceRing,
+                geometryArena
+            );
 
             // End the RenderPass and CommandBuffer.
             vkCmdEndRenderPass(commandBuffer);
             dst_vk_result(vkEndCommandBuffer(commandBuffer));
 
-            // Submit the CommandBuffer for execution on the GPU.
+            // Flush instanceRing's writes then submit the CommandBuffer for execution on
+            //  the GPU.
+            dst_vk_result(instanceRing.flush());
             auto submitInfo = wsiManager.get_submit_info(imageIndex);
             dst_vk_result(vkQueueSubmit(gvkQueue, 1, &submitInfo, vkFences[imageIndex]));
 
@@ -910,13 +842,26 @@ int main(int, const char* [])
             vkResult = vkQueuePresentKHR(gvkQueue, &presentInfo);
             assert(vkResult == VK_SUCCESS || vkResult == VK_SUBOPTIMAL_KHR);
         }
+
+        // Release the FrameSnapshot so the simulation thread can write to it again.
+        framePipeline.release();
     }
 
+    // Stop the simulation thread before the Registry and dst::physics::World it
+    //  uses are destroyed.
+    framePipeline.reset();
+
     // Wait for the GPU to be idle before allowing graphics destructors to run.
     dst_vk_result(vkDeviceWaitIdle(gvkContext.get_devices()[0]));
 
     // Reset the dst::physics::World before allowing physics destructors to run.
     physicsWorld.reset();
 
+#ifdef DST_PROFILER_ENABLED
+    // Write the profiler's recorded zones to a trace that can be opened in
+    //  chrome://tracing or https://ui.perfetto.dev.
+    dst::profiler::write_chrome_trace("brick-breaker.trace.json");
+#endif
+
     return 0;
 }
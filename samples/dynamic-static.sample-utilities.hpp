@@ -27,15 +27,24 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #pragma once
 
 #include "dynamic-static.graphics/defines.hpp"
+#include "dynamic-static.graphics/geometry-arena.hpp"
+#include "dynamic-static.graphics/mesh-asset.hpp"
+#include "dynamic-static.graphics/pipeline-builder.hpp"
 #include "dynamic-static.graphics/primitives.hpp"
+#include "dynamic-static.graphics/upload-batcher.hpp"
+#include "dynamic-static.graphics/vertex-cache.hpp"
 #include "dynamic-static.physics/defines.hpp"
 #include "dynamic-static.physics/material.hpp"
 #include "dynamic-static.physics/rigid-body.hpp"
 #include "dynamic-static.physics/world.hpp"
+#include "dynamic-static/profiler.hpp"
+#include "dynamic-static/stack-allocator.hpp"
 
 #include <algorithm>
 #include <cassert>
 #include <iostream>
+#include <memory_resource>
+#include <type_traits>
 #include <vector>
 #include <unordered_map>
 
@@ -134,24 +143,43 @@ inline VkFormat dst_sample_get_render_pass_depth_format(const gvk::RenderPass& r
     return VK_FORMAT_UNDEFINED;
 }
 
-template <typename VertexType>
+// Compiles GLSL to SPIR-V, suitable for dst::gfx::PipelineBuilder::CreateInfo::compile.
+//  Each thread gets its own gvk::spirv::Context so shaders can be compiled
+//  concurrently, a thread's gvk::spirv::Context is only created the first time it
+//  actually compiles a shader so warm launches that load every shader from a
+//  dst::gfx::ShaderCache skip the compiler entirely.
+inline void dst_sample_compile_shader(gvk::spirv::ShaderInfo* pShaderInfo)
+{
+    assert(pShaderInfo);
+    thread_local gvk::spirv::Context tSpirvContext;
+    thread_local auto tSpirvContextResult = VK_NOT_READY;
+    if (tSpirvContextResult == VK_NOT_READY) {
+        tSpirvContextResult = gvk::spirv::Context::create(&gvk::get_default<gvk::spirv::Context::CreateInfo>(), &tSpirvContext);
+    }
+    if (tSpirvContextResult == VK_SUCCESS) {
+        tSpirvContext.compile(pShaderInfo);
+    } else {
+        pShaderInfo->errors.push_back("Failed to create gvk::spirv::Context");
+    }
+}
+
+// Creates a gvk::Pipeline from compiled shaders, see dst_sample_compile_shader().
+//  Safe to call concurrently for different gvk::Pipelines.
+template <typename VertexType, typename InstanceType = dst::gfx::EmptyVertex>
 inline VkResult dst_sample_create_pipeline(
     const gvk::RenderPass& renderPass,
     VkCullModeFlagBits cullMode,
     VkPolygonMode polygonMode,
-    gvk::spirv::ShaderInfo& vertexShaderInfo,
-    gvk::spirv::ShaderInfo& fragmentShaderInfo,
+    const gvk::spirv::ShaderInfo& vertexShaderInfo,
+    const gvk::spirv::ShaderInfo& fragmentShaderInfo,
+    const gvk::PipelineLayout& pipelineLayout,
+    const gvk::PipelineCache& pipelineCache,
     gvk::Pipeline* pPipeline
 )
 {
     gvk_result_scope_begin(VK_ERROR_INITIALIZATION_FAILED) {
-        // Create a gvk::spirv::Compiler, compile GLSL to SPIR-V, then validate both
-        //  shaders.
-        gvk::spirv::Context spirvContext;
-        gvk_result(gvk::spirv::Context::create(&gvk::get_default<gvk::spirv::Context::CreateInfo>(), &spirvContext));
-        spirvContext.compile(&vertexShaderInfo);
+        // Validate both shaders.
         gvk_result(dst_sample_validate_shader_info(vertexShaderInfo));
-        spirvContext.compile(&fragmentShaderInfo);
         gvk_result(dst_sample_validate_shader_info(fragmentShaderInfo));
         auto vsVkResult = dst_sample_validate_shader_info(vertexShaderInfo);
         auto fsVkResult = dst_sample_validate_shader_info(fragmentShaderInfo);
@@ -190,11 +218,25 @@ inline VkResult dst_sample_create_pipeline(
         // NOTE : gvk::get_vertex_description<VertexType>(0) is used to get an array of
         //  VkVertexInputAttributeDescriptions at binding 0 which indicates that the
         //  array is associated with the 0th element of pVertexBindingDescriptions.
-        VkVertexInputBindingDescription vertexInputBindingDescription { 0, sizeof(VertexType), VK_VERTEX_INPUT_RATE_VERTEX };
-        auto vertexInputAttributeDescriptions = gvk::get_vertex_description<VertexType>(0);
+        // NOTE : If an InstanceType is provided its attributes are read from binding 1
+        //  at VK_VERTEX_INPUT_RATE_INSTANCE.  gvk::get_vertex_description() starts
+        //  locations at 0 so the instance attributes are moved to follow the vertex
+        //  attributes.
+        std::vector<VkVertexInputBindingDescription> vertexInputBindingDescriptions {
+            VkVertexInputBindingDescription { 0, sizeof(VertexType), VK_VERTEX_INPUT_RATE_VERTEX },
+        };
+        auto vertexDescription = gvk::get_vertex_description<VertexType>(0);
+        std::vector<VkVertexInputAttributeDescription> vertexInputAttributeDescriptions(vertexDescription.begin(), vertexDescription.end());
+        if constexpr (!std::is_same_v<InstanceType, dst::gfx::EmptyVertex>) {
+            vertexInputBindingDescriptions.push_back({ 1, sizeof(InstanceType), VK_VERTEX_INPUT_RATE_INSTANCE });
+            for (auto instanceInputAttributeDescription : gvk::get_vertex_description<InstanceType>(1)) {
+                instanceInputAttributeDescription.location += (uint32_t)vertexDescription.size();
+                vertexInputAttributeDescriptions.push_back(instanceInputAttributeDescription);
+            }
+        }
         auto pipelineVertexInputStateCreateInfo = gvk::get_default<VkPipelineVertexInputStateCreateInfo>();
-        pipelineVertexInputStateCreateInfo.vertexBindingDescriptionCount = 1;
-        pipelineVertexInputStateCreateInfo.pVertexBindingDescriptions = &vertexInputBindingDescription;
+        pipelineVertexInputStateCreateInfo.vertexBindingDescriptionCount = (uint32_t)vertexInputBindingDescriptions.size();
+        pipelineVertexInputStateCreateInfo.pVertexBindingDescriptions = vertexInputBindingDescriptions.data();
         pipelineVertexInputStateCreateInfo.vertexAttributeDescriptionCount = (uint32_t)vertexInputAttributeDescriptions.size();
         pipelineVertexInputStateCreateInfo.pVertexAttributeDescriptions = vertexInputAttributeDescriptions.data();
 
@@ -219,16 +261,21 @@ inline VkResult dst_sample_create_pipeline(
         pipelineDepthStencilStateCreateInfo.depthWriteEnable = depthTestEnable;
         pipelineDepthStencilStateCreateInfo.depthCompareOp = VK_COMPARE_OP_LESS;
 
-        // Populate a gvk::spirv::BindingInfo with our gvk::spirv::ShaderInfo objects.
-        //  This will run the shader byte code through SPIRV-Cross to reflect the
-        //  resource bindings used in the shaders.  When the gvk::spirv::BindingInfo is
-        //  passed to create_pipeline_layout() it will be used to create the necessary
-        //  gvk::DescriptorSetLayout objects for the gvk::PipelineLayout.
-        gvk::spirv::BindingInfo spirvBindingInfo;
-        spirvBindingInfo.add_shader(vertexShaderInfo);
-        spirvBindingInfo.add_shader(fragmentShaderInfo);
-        gvk::PipelineLayout pipelineLayout;
-        gvk_result(gvk::spirv::create_pipeline_layout(renderPass.get<gvk::Device>(), spirvBindingInfo, nullptr, &pipelineLayout));
+        // If no gvk::PipelineLayout was provided, populate a gvk::spirv::BindingInfo
+        //  with our gvk::spirv::ShaderInfo objects.  This will run the shader byte
+        //  code through SPIRV-Cross to reflect the resource bindings used in the
+        //  shaders.  When the gvk::spirv::BindingInfo is passed to
+        //  create_pipeline_layout() it will be used to create the necessary
+        //  gvk::DescriptorSetLayout objects for the gvk::PipelineLayout.  Reflection
+        //  can't tell whether a uniform buffer should use dynamic offsets so callers
+        //  that need them provide their own gvk::PipelineLayout.
+        gvk::PipelineLayout reflectedPipelineLayout;
+        if (!pipelineLayout) {
+            gvk::spirv::BindingInfo spirvBindingInfo;
+            spirvBindingInfo.add_shader(vertexShaderInfo);
+            spirvBindingInfo.add_shader(fragmentShaderInfo);
+            gvk_result(gvk::spirv::create_pipeline_layout(renderPass.get<gvk::Device>(), spirvBindingInfo, nullptr, &reflectedPipelineLayout));
+        }
 
         // Finally we populate a VkGraphicsPipelineCreateInfo with the components
         //  necessary for this gvk::Pipeline.
@@ -247,9 +294,9 @@ inline VkResult dst_sample_create_pipeline(
         graphicsPipelineCreateInfo.pRasterizationState = &pipelineRasterizationStateCreateInfo;
         graphicsPipelineCreateInfo.pMultisampleState = &pipelineMultisampleStateCreateInfo;
         graphicsPipelineCreateInfo.pDepthStencilState = &pipelineDepthStencilStateCreateInfo;
-        graphicsPipelineCreateInfo.layout = pipelineLayout;
+        graphicsPipelineCreateInfo.layout = pipelineLayout ? pipelineLayout : reflectedPipelineLayout;
         graphicsPipelineCreateInfo.renderPass = renderPass;
-        gvk_result(gvk::Pipeline::create(renderPass.get<gvk::Device>(), VK_NULL_HANDLE, 1, &graphicsPipelineCreateInfo, nullptr, pPipeline));
+        gvk_result(gvk::Pipeline::create(renderPass.get<gvk::Device>(), pipelineCache, 1, &graphicsPipelineCreateInfo, nullptr, pPipeline));
     } gvk_result_scope_end;
     return gvkResult;
 }
@@ -269,65 +316,51 @@ inline VkResult dst_sample_create_uniform_buffer(const gvk::Device& device, gvk:
     return gvk::Buffer::create(device, &bufferCreateInfo, &vmaAllocationCreateInfo, pUniformBuffer);
 }
 
-VkResult dst_sample_create_sphere_mesh(const gvk::CommandBuffer& commandBuffer, float radius, uint32_t subdivisions, gvk::Mesh* pMesh)
+// Returns the calling thread's dst::StackAllocator for temporary geometry, open
+//  a dst::StackAllocator::Scope before using it.
+inline dst::StackAllocator& dst_sample_get_scratch_allocator()
 {
-    std::vector<glm::vec3> vertices(dst::gfx::primitive::Icosahedron::Vertices.begin(), dst::gfx::primitive::Icosahedron::Vertices.end());
-    for (auto& vertex : vertices) {
-        vertex *= radius;
+    thread_local dst::StackAllocator stackAllocator;
+    if (!stackAllocator.get_capacity()) {
+        dst::StackAllocator::CreateInfo stackAllocatorCreateInfo { };
+        dst::StackAllocator::create(&stackAllocatorCreateInfo, &stackAllocator);
     }
-    std::vector<dst::gfx::primitive::Triangle<uint32_t>> triangles(dst::gfx::primitive::Icosahedron::Triangles.begin(), dst::gfx::primitive::Icosahedron::Triangles.end());
-    std::unordered_map<dst::gfx::primitive::Edge<uint32_t>, uint32_t, dst::gfx::primitive::EdgeHasher<uint32_t>> edges;
-    for (uint32_t subdivision_i = 0; subdivision_i < subdivisions; ++subdivision_i) {
-        auto triangleCount = (uint32_t)triangles.size();
-        for (uint32_t triangle_i = 0; triangle_i < triangleCount; ++triangle_i) {
-            dst::gfx::primitive::subdivide_triangle(
-                triangles[triangle_i],
-                [&](const dst::gfx::primitive::Edge<uint32_t>& edge)
-                {
-                    auto itr = edges.find(edge);
-                    if (itr == edges.end()) {
-                        vertices.push_back(glm::normalize(vertices[edge[0]] + vertices[edge[1]]) * radius);
-                        itr = edges.insert(itr, { edge, (uint32_t)vertices.size() - 1 });
-                    }
-                    return itr->second;
-                },
-                [&](
-                    const dst::gfx::primitive::Triangle<uint32_t>& subdividedTriangle,
-                    const std::array<dst::gfx::primitive::Triangle<uint32_t>, 3>& newTriangles
-                )
-                {
-                    triangles[triangle_i] = subdividedTriangle;
-                    triangles.insert(triangles.end(), newTriangles.begin(), newTriangles.end());
-                }
-            );
-        }
-    }
-    return pMesh->write(
-        commandBuffer.get<gvk::Device>(),
-        commandBuffer.get<gvk::Device>().get<gvk::QueueFamilies>()[0].queues[0],
-        commandBuffer,
-        VK_NULL_HANDLE,
-        (uint32_t)vertices.size(),
-        vertices.data(),
-        (uint32_t)triangles.size() * 3,
-        triangles[0].data()
-    );
+    return stackAllocator;
+}
+
+VkResult dst_sample_create_sphere_mesh(dst::gfx::GeometryArena& geometryArena, dst::gfx::UploadBatcher& uploadBatcher, float radius, uint32_t subdivisions, dst::gfx::GeometryArena::Mesh* pMesh)
+{
+    dst_profile_function();
+    // Generate an icosphere then reorder its triangles for vertex cache locality
+    //  and its vertices for fetch locality.
+    auto& scratchAllocator = dst_sample_get_scratch_allocator();
+    dst::StackAllocator::Scope scratchScope(scratchAllocator);
+    std::pmr::vector<glm::vec3> vertices(&scratchAllocator);
+    std::pmr::vector<dst::gfx::primitive::Triangle<uint32_t>> triangles(&scratchAllocator);
+    dst::gfx::primitive::create_icosphere(radius, subdivisions, &vertices, &triangles);
+    dst::gfx::optimize_vertex_cache<uint32_t>(triangles, vertices.size());
+    dst::gfx::optimize_overdraw<uint32_t>(triangles, vertices);
+    dst::gfx::optimize_vertex_fetch<uint32_t>(triangles, &vertices);
+    return geometryArena.write<glm::vec3, uint32_t>(uploadBatcher, vertices, { triangles[0].data(), triangles.size() * 3 }, pMesh);
+}
+
+VkResult dst_sample_create_mesh(dst::gfx::GeometryArena& geometryArena, dst::gfx::UploadBatcher& uploadBatcher, const dst::gfx::MeshAsset& meshAsset, size_t lod, dst::gfx::GeometryArena::Mesh* pMesh)
+{
+    // Upload one LOD of a MeshAsset into a dst::gfx::GeometryArena, the MeshAsset's
+    //  data is copied straight from the mapped AssetFile into the
+    //  dst::gfx::UploadBatcher's staging ring.
+    auto triangles = meshAsset.get_lod_triangles(lod);
+    return geometryArena.write<glm::vec3, uint32_t>(uploadBatcher, meshAsset.positions, { triangles[0].data(), triangles.size() * 3 }, pMesh);
 }
 
-VkResult dst_sample_create_box_mesh(const gvk::CommandBuffer& commandBuffer, const glm::vec3& dimensions, gvk::Mesh* pMesh)
+VkResult dst_sample_create_box_mesh(dst::gfx::GeometryArena& geometryArena, dst::gfx::UploadBatcher& uploadBatcher, const glm::vec3& dimensions, dst::gfx::GeometryArena::Mesh* pMesh)
 {
-    std::vector<glm::vec3> vertices(dst::gfx::primitive::Cube::Vertices.begin(), dst::gfx::primitive::Cube::Vertices.end());
+    auto& scratchAllocator = dst_sample_get_scratch_allocator();
+    dst::StackAllocator::Scope scratchScope(scratchAllocator);
+    std::pmr::vector<glm::vec3> vertices(dst::gfx::primitive::Cube::Vertices.begin(), dst::gfx::primitive::Cube::Vertices.end(), &scratchAllocator);
     for (auto& vertex : vertices) {
         vertex *= dimensions;
     }
-    return pMesh->write(
-        commandBuffer.get<gvk::Device>(),
-        commandBuffer.get<gvk::Device>().get<gvk::QueueFamilies>()[0].queues[0],
-        commandBuffer,
-        VK_NULL_HANDLE,
-        (uint32_t)vertices.size(),
-        vertices.data(),
-        (uint32_t)dst::gfx::primitive::Cube::Triangles.size() * 3,
-        dst::gfx::primitive::Cube::Triangles[0].data()
-    );
+    const auto& triangles = dst::gfx::primitive::Cube::Triangles;
+    return geometryArena.write<glm::vec3, uint32_t>(uploadBatcher, vertices, { triangles[0].data(), triangles.size() * 3 }, pMesh);
 }